@@ -37,6 +37,11 @@ UFlareResourceCatalog::UFlareResourceCatalog(const class FObjectInitializer& PCI
 	Resources.Sort(SortByResourceType);
 	ConsumerResources.Sort(SortByResourceType);
 	MaintenanceResources.Sort(SortByResourceType);
+
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	{
+		Resources[ResourceIndex]->Data.CatalogIndex = ResourceIndex;
+	}
 }
 
 
@@ -60,6 +65,30 @@ FFlareResourceDescription* UFlareResourceCatalog::Get(FName Identifier) const
 	return NULL;
 }
 
+int32 UFlareResourceCatalog::GetResourceIndex(const FFlareResourceDescription* Resource) const
+{
+	if (Resource == NULL)
+	{
+		return INDEX_NONE;
+	}
+
+	// Fast path
+	int32 CatalogIndex = Resource->CatalogIndex;
+	if (Resources.IsValidIndex(CatalogIndex) && &Resources[CatalogIndex]->Data == Resource)
+	{
+		return CatalogIndex;
+	}
+
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	{
+		if (Resource == &Resources[ResourceIndex]->Data)
+		{
+			return ResourceIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
 UFlareResourceCatalogEntry* UFlareResourceCatalog::GetEntry(FFlareResourceDescription* Resource) const
 {
 	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
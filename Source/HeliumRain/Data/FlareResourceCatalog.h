@@ -39,6 +39,9 @@ public:
 	/** Get a resource from identifier */
 	UFlareResourceCatalogEntry* GetEntry(FFlareResourceDescription*) const;
 
+	/** Get the index of a resource in the resource list, for dense per-resource tables */
+	int32 GetResourceIndex(const FFlareResourceDescription* Resource) const;
+
 	/** Get all resources */
 	TArray<UFlareResourceCatalogEntry*>& GetResourceList()
 	{
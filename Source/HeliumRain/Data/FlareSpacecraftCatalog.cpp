@@ -30,6 +30,13 @@ UFlareSpacecraftCatalog::UFlareSpacecraftCatalog(const class FObjectInitializer&
 			ShipCatalog.Add(Spacecraft);
 		}
 	}
+
+	for (int32 Index = 0; Index < GetSpacecraftCount(); Index++)
+	{
+		FFlareSpacecraftDescription* Spacecraft = GetSpacecraft(Index);
+		Spacecraft->CatalogIndex = Index;
+		SpacecraftIndexes.Add(Spacecraft->Identifier, Index);
+	}
 }
 
 
@@ -39,6 +46,17 @@ UFlareSpacecraftCatalog::UFlareSpacecraftCatalog(const class FObjectInitializer&
 
 FFlareSpacecraftDescription* UFlareSpacecraftCatalog::Get(FName Identifier) const
 {
+	// Fast path
+	const int32* Index = SpacecraftIndexes.Find(Identifier);
+	if (Index && *Index < GetSpacecraftCount())
+	{
+		FFlareSpacecraftDescription* Spacecraft = GetSpacecraft(*Index);
+		if (Spacecraft->Identifier == Identifier)
+		{
+			return Spacecraft;
+		}
+	}
+
 	auto FindByName = [=](const UFlareSpacecraftCatalogEntry* Candidate)
 	{
 		return Candidate->Data.Identifier == Identifier;
@@ -59,3 +77,43 @@ FFlareSpacecraftDescription* UFlareSpacecraftCatalog::Get(FName Identifier) cons
 	return NULL;
 }
 
+int32 UFlareSpacecraftCatalog::GetSpacecraftCount() const
+{
+	return ShipCatalog.Num() + StationCatalog.Num();
+}
+
+FFlareSpacecraftDescription* UFlareSpacecraftCatalog::GetSpacecraft(int32 Index) const
+{
+	if (Index < ShipCatalog.Num())
+	{
+		return &ShipCatalog[Index]->Data;
+	}
+	else
+	{
+		return &StationCatalog[Index - ShipCatalog.Num()]->Data;
+	}
+}
+
+int32 UFlareSpacecraftCatalog::GetSpacecraftIndex(const FFlareSpacecraftDescription* Spacecraft) const
+{
+	if (Spacecraft == NULL)
+	{
+		return INDEX_NONE;
+	}
+
+	// Fast path
+	int32 CatalogIndex = Spacecraft->CatalogIndex;
+	if (CatalogIndex >= 0 && CatalogIndex < GetSpacecraftCount() && GetSpacecraft(CatalogIndex) == Spacecraft)
+	{
+		return CatalogIndex;
+	}
+
+	for (int32 Index = 0; Index < GetSpacecraftCount(); Index++)
+	{
+		if (Spacecraft == GetSpacecraft(Index))
+		{
+			return Index;
+		}
+	}
+	return INDEX_NONE;
+}
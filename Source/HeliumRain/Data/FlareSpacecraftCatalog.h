@@ -33,5 +33,24 @@ public:
 	/** Get a ship from identifier */
 	FFlareSpacecraftDescription* Get(FName Identifier) const;
 
+	/** Get the number of ships and stations, for dense per-spacecraft tables */
+	int32 GetSpacecraftCount() const;
+
+	/** Get a ship or station from its index, ships first */
+	FFlareSpacecraftDescription* GetSpacecraft(int32 Index) const;
+
+	/** Get the index of a ship or station, for dense per-spacecraft tables */
+	int32 GetSpacecraftIndex(const FFlareSpacecraftDescription* Spacecraft) const;
+
+
+protected:
+
+	/*----------------------------------------------------
+		Protected data
+	----------------------------------------------------*/
+
+	/** Catalog index by identifier */
+	TMap<FName, int32> SpacecraftIndexes;
+
 
 };
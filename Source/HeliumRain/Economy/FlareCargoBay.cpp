@@ -1,6 +1,7 @@
 
 #include "../Flare.h"
 #include "../Game/FlareGame.h"
+#include "../Game/FlareCompany.h"
 #include "FlareCargoBay.h"
 
 
@@ -11,6 +12,7 @@
 UFlareCargoBay::UFlareCargoBay(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	RestrictedSlotCount = 0;
 }
 
 void UFlareCargoBay::Load(UFlareSimulatedSpacecraft* ParentSpacecraft, TArray<FFlareCargoSave>& Data)
@@ -53,6 +55,8 @@ void UFlareCargoBay::Load(UFlareSimulatedSpacecraft* ParentSpacecraft, TArray<FF
 
 		CargoBay.Add(Cargo);
 	}
+
+	RebuildSummaries();
 }
 
 
@@ -96,78 +100,76 @@ TArray<FFlareCargoSave>* UFlareCargoBay::Save()
 
 bool UFlareCargoBay::HasResources(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client)
 {
-	uint32 PresentQuantity = 0;
-
 	if (Quantity == 0)
 	{
 		return true;
 	}
 
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
-	{
-		FFlareCargo* Cargo = &CargoBay[CargoIndex];
+	return GetResourceQuantity(Resource, Client) >= Quantity;
+}
 
-		if(!CheckRestriction(Cargo, Client))
-		{
-			continue;
-		}
+uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client)
+{
+	uint32 TakenQuantity = TakeResourcesInternal(Resource, Quantity, Client);
 
-		if (Cargo->Resource == Resource)
-		{
-			PresentQuantity += Cargo->Quantity;
-			if (PresentQuantity >= Quantity)
-			{
-				return true;
-			}
-		}
+	if (TakenQuantity > 0)
+	{
+		OnCargoChanged();
 	}
-	return false;
+
+	return TakenQuantity;
 }
 
-uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client)
+uint32 UFlareCargoBay::TakeResourcesInternal(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client)
 {
 	uint32 QuantityToTake = Quantity;
+	const FFlareCargoResourceSummary* Summary = GetSummary(Resource);
 
-
-	if (QuantityToTake == 0)
+	if (QuantityToTake == 0 || !Resource || !Summary)
 	{
 		return 0;
 	}
 
+	EFlareCargoClient::Type ClientClass = GetClientClass(Client);
+
+	// Slots can leave the summary while we take from them
+	TArray<int32, TInlineAllocator<8>> SlotIndexes(Summary->SlotIndexes);
+
 	// First pass: take resource from the less full cargo
 	uint32 MinQuantity = 0;
-	FFlareCargo* MinQuantityCargo = NULL;
+	int32 MinQuantityIndex = INDEX_NONE;
 
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	for (int32 Index = 0; Index < SlotIndexes.Num(); Index++)
 	{
-		FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if (Cargo.Resource == Resource)
+		FFlareCargo& Cargo = CargoBay[SlotIndexes[Index]];
+
+		if(!CheckClientRestriction(&Cargo, ClientClass))
 		{
-			if(!CheckRestriction(&Cargo, Client))
-			{
-				continue;
-			}
+			continue;
+		}
 
-			if (MinQuantityCargo == NULL || MinQuantity > Cargo.Quantity)
-			{
-				MinQuantityCargo = &Cargo;
-				MinQuantity = Cargo.Quantity;
-			}
+		if (MinQuantityIndex == INDEX_NONE || MinQuantity > Cargo.Quantity)
+		{
+			MinQuantityIndex = SlotIndexes[Index];
+			MinQuantity = Cargo.Quantity;
 		}
 	}
 
-	if (MinQuantityCargo)
+	if (MinQuantityIndex != INDEX_NONE)
 	{
-		uint32 TakenQuantity = FMath::Min(MinQuantityCargo->Quantity, QuantityToTake);
+		FFlareCargo& MinQuantityCargo = CargoBay[MinQuantityIndex];
+		uint32 TakenQuantity = FMath::Min(MinQuantityCargo.Quantity, QuantityToTake);
 		if (TakenQuantity > 0)
 		{
-			MinQuantityCargo->Quantity -= TakenQuantity;
+			UpdateSlotSummary(MinQuantityIndex, false);
+			MinQuantityCargo.Quantity -= TakenQuantity;
 			QuantityToTake -= TakenQuantity;
 
-			if (MinQuantityCargo->Quantity == 0 && MinQuantityCargo->Lock == EFlareResourceLock::NoLock)
+			if (MinQuantityCargo.Quantity == 0 && MinQuantityCargo.Lock == EFlareResourceLock::NoLock)
 			{
-				MinQuantityCargo->Resource = NULL;
+				MinQuantityCargo.Resource = NULL;
 			}
+			UpdateSlotSummary(MinQuantityIndex, true);
 
 			if (QuantityToTake == 0)
 			{
@@ -176,13 +178,13 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 		}
 	}
 
-
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	for (int32 Index = 0; Index < SlotIndexes.Num(); Index++)
 	{
+		int32 CargoIndex = SlotIndexes[Index];
 		FFlareCargo& Cargo = CargoBay[CargoIndex];
 		if (Cargo.Resource == Resource)
 		{
-			if(!CheckRestriction(&Cargo, Client))
+			if(!CheckClientRestriction(&Cargo, ClientClass))
 			{
 				continue;
 			}
@@ -190,6 +192,7 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 			uint32 TakenQuantity = FMath::Min(Cargo.Quantity, QuantityToTake);
 			if (TakenQuantity > 0)
 			{
+				UpdateSlotSummary(CargoIndex, false);
 				Cargo.Quantity -= TakenQuantity;
 				QuantityToTake -= TakenQuantity;
 
@@ -197,6 +200,7 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 				{
 					Cargo.Resource = NULL;
 				}
+				UpdateSlotSummary(CargoIndex, true);
 
 				if (QuantityToTake == 0)
 				{
@@ -210,14 +214,33 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 
 void UFlareCargoBay::DumpCargo(FFlareCargo* Cargo)
 {
+	int32 CargoIndex = Cargo - CargoBay.GetData();
+	check(CargoBay.IsValidIndex(CargoIndex));
+
+	UpdateSlotSummary(CargoIndex, false);
 	Cargo->Quantity = 0;
 	if (Cargo->Lock == EFlareResourceLock::NoLock)
 	{
 		Cargo->Resource = NULL;
 	}
+	UpdateSlotSummary(CargoIndex, true);
+
+	OnCargoChanged();
 }
 
 uint32 UFlareCargoBay::GiveResources(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client)
+{
+	uint32 GivenQuantity = GiveResourcesInternal(Resource, Quantity, Client);
+
+	if (GivenQuantity > 0)
+	{
+		OnCargoChanged();
+	}
+
+	return GivenQuantity;
+}
+
+uint32 UFlareCargoBay::GiveResourcesInternal(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client)
 {
 	uint32 QuantityToGive = Quantity;
 
@@ -226,23 +249,30 @@ uint32 UFlareCargoBay::GiveResources(FFlareResourceDescription* Resource, uint32
 		return Quantity;
 	}
 
+	EFlareCargoClient::Type ClientClass = GetClientClass(Client);
+
 	// First pass, fill already existing slots
-	for (int CargoIndex = 0 ; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	const FFlareCargoResourceSummary* Summary = GetSummary(Resource);
+	if (Resource && Summary)
 	{
-		FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if (Resource == Cargo.Resource)
+		for (int32 Index = 0; Index < Summary->SlotIndexes.Num(); Index++)
 		{
-			if(!CheckRestriction(&Cargo, Client))
+			int32 CargoIndex = Summary->SlotIndexes[Index];
+			FFlareCargo& Cargo = CargoBay[CargoIndex];
+
+			if(!CheckClientRestriction(&Cargo, ClientClass))
 			{
 				continue;
 			}
 
-			// Same resource
+			// Same resource, the slot stays in the summary
 			uint32 AvailableCapacity = GetSlotCapacity() - Cargo.Quantity;
 			uint32 GivenQuantity = FMath::Min(AvailableCapacity, QuantityToGive);
 			if (GivenQuantity > 0)
 			{
+				UpdateSlotSummary(CargoIndex, false);
 				Cargo.Quantity += GivenQuantity;
+				UpdateSlotSummary(CargoIndex, true);
 				QuantityToGive -= GivenQuantity;
 
 				if (QuantityToGive == 0)
@@ -253,42 +283,136 @@ uint32 UFlareCargoBay::GiveResources(FFlareResourceDescription* Resource, uint32
 		}
 	}
 
-	// Fill free cargo slots
-	for (int CargoIndex = 0 ; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	// Fill free cargo slots, they leave the empty slot list as we fill them
+	TArray<int32, TInlineAllocator<8>> FreeSlotIndexes(EmptySlots.SlotIndexes);
+	for (int32 Index = 0; Index < FreeSlotIndexes.Num(); Index++)
 	{
+		int32 CargoIndex = FreeSlotIndexes[Index];
 		FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if (Cargo.Resource == NULL)
+
+		if(!CheckClientRestriction(&Cargo, ClientClass))
 		{
-			if(!CheckRestriction(&Cargo, Client))
-			{
-				continue;
-			}
+			continue;
+		}
 
-			// Empty Cargo
-			uint32 GivenQuantity = FMath::Min(GetSlotCapacity(), QuantityToGive);
-			if (GivenQuantity > 0)
-			{
-				Cargo.Quantity += GivenQuantity;
-				Cargo.Resource = Resource;
+		// Empty Cargo
+		uint32 GivenQuantity = FMath::Min(GetSlotCapacity(), QuantityToGive);
+		if (GivenQuantity > 0)
+		{
+			UpdateSlotSummary(CargoIndex, false);
+			Cargo.Quantity += GivenQuantity;
+			Cargo.Resource = Resource;
+			UpdateSlotSummary(CargoIndex, true);
 
-				QuantityToGive -= GivenQuantity;
+			QuantityToGive -= GivenQuantity;
 
-				if (QuantityToGive == 0)
-				{
-					return Quantity;
-				}
-			}
-			else
+			if (QuantityToGive == 0)
 			{
-				FLOGV("Zero sized cargo bay for %s", *Parent->GetImmatriculation().ToString())
+				return Quantity;
 			}
-
+		}
+		else
+		{
+			FLOGV("Zero sized cargo bay for %s", *Parent->GetImmatriculation().ToString())
 		}
 	}
 
 	return Quantity - QuantityToGive;
 }
 
+void UFlareCargoBay::RebuildSummaries()
+{
+	ResourceSummaries.Empty();
+	EmptySlots = FFlareCargoResourceSummary();
+	RestrictedSlotCount = 0;
+
+	for (int32 CargoIndex = 0; CargoIndex < CargoBay.Num(); CargoIndex++)
+	{
+		UpdateSlotSummary(CargoIndex, true);
+
+		if (CargoBay[CargoIndex].Restriction != EFlareResourceRestriction::Everybody)
+		{
+			RestrictedSlotCount++;
+		}
+	}
+}
+
+void UFlareCargoBay::UpdateSlotSummary(int32 SlotIndex, bool Add)
+{
+	const FFlareCargo& Cargo = CargoBay[SlotIndex];
+	FFlareCargoResourceSummary& Summary = Cargo.Resource ? ResourceSummaries.FindOrAdd(Cargo.Resource) : EmptySlots;
+	int32 Sign = Add ? 1 : -1;
+
+	bool CanSell = (Cargo.Lock == EFlareResourceLock::NoLock || Cargo.Lock == EFlareResourceLock::Output || Cargo.Lock == EFlareResourceLock::Trade);
+	bool CanBuy = (Cargo.Lock == EFlareResourceLock::NoLock || Cargo.Lock == EFlareResourceLock::Input || Cargo.Lock == EFlareResourceLock::Trade);
+
+	for (int32 ClientClass = 0; ClientClass < EFlareCargoClient::Count; ClientClass++)
+	{
+		if (!CheckClientRestriction(&Cargo, (EFlareCargoClient::Type) ClientClass))
+		{
+			continue;
+		}
+
+		Summary.Quantity[ClientClass] += Sign * Cargo.Quantity;
+		Summary.SlotCount[ClientClass] += Sign;
+		Summary.SellSlotCount[ClientClass] += CanSell ? Sign : 0;
+		Summary.BuySlotCount[ClientClass] += CanBuy ? Sign : 0;
+	}
+
+	if (Add)
+	{
+		int32 InsertIndex = 0;
+		while (InsertIndex < Summary.SlotIndexes.Num() && Summary.SlotIndexes[InsertIndex] < SlotIndex)
+		{
+			InsertIndex++;
+		}
+		Summary.SlotIndexes.Insert(SlotIndex, InsertIndex);
+	}
+	else
+	{
+		Summary.SlotIndexes.Remove(SlotIndex);
+	}
+}
+
+const FFlareCargoResourceSummary* UFlareCargoBay::GetSummary(FFlareResourceDescription* Resource) const
+{
+	if (Resource == NULL)
+	{
+		return &EmptySlots;
+	}
+
+	return ResourceSummaries.Find(Resource);
+}
+
+EFlareCargoClient::Type UFlareCargoBay::GetClientClass(UFlareCompany* Client) const
+{
+	if (Client == NULL)
+	{
+		return EFlareCargoClient::Any;
+	}
+	else if (Client == Parent->GetCompany())
+	{
+		return EFlareCargoClient::Owner;
+	}
+	else
+	{
+		return EFlareCargoClient::Other;
+	}
+}
+
+bool UFlareCargoBay::CheckClientRestriction(const FFlareCargo* Cargo, EFlareCargoClient::Type ClientClass)
+{
+	switch (ClientClass)
+	{
+		case EFlareCargoClient::Owner:
+			return Cargo->Restriction != EFlareResourceRestriction::Nobody;
+		case EFlareCargoClient::Other:
+			return Cargo->Restriction == EFlareResourceRestriction::Everybody;
+		default:
+			return true;
+	}
+}
+
 
 /*----------------------------------------------------
 	Getters
@@ -337,46 +461,19 @@ uint32 UFlareCargoBay::GetFreeCargoSpace() const
 
 uint32 UFlareCargoBay::GetResourceQuantity(FFlareResourceDescription* Resource, UFlareCompany* Client) const
 {
-	uint32 Quantity = 0;
-
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
-	{
-		const FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if (Cargo.Resource == Resource)
-		{
-			if(!CheckRestriction(&Cargo, Client))
-			{
-				continue;
-			}
-
-			Quantity += Cargo.Quantity;
-		}
-	}
-
-	return Quantity;
+	const FFlareCargoResourceSummary* Summary = GetSummary(Resource);
+	return Summary ? Summary->Quantity[GetClientClass(Client)] : 0;
 }
 
 uint32 UFlareCargoBay::GetFreeSpaceForResource(FFlareResourceDescription* Resource, UFlareCompany* Client) const
 {
-	uint32 Quantity = 0;
+	EFlareCargoClient::Type ClientClass = GetClientClass(Client);
+	uint32 Quantity = EmptySlots.SlotCount[ClientClass] * GetSlotCapacity();
 
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	const FFlareCargoResourceSummary* Summary = GetSummary(Resource);
+	if (Resource && Summary)
 	{
-		const FFlareCargo& Cargo = CargoBay[CargoIndex];
-
-		if(!CheckRestriction(&Cargo, Client))
-		{
-			continue;
-		}
-
-		if (Cargo.Resource == NULL)
-		{
-			Quantity += GetSlotCapacity();
-		}
-		else if (Cargo.Resource == Resource)
-		{
-			Quantity += GetSlotCapacity() - Cargo.Quantity;
-		}
+		Quantity += Summary->SlotCount[ClientClass] * GetSlotCapacity() - Summary->Quantity[ClientClass];
 	}
 
 	return Quantity;
@@ -384,15 +481,7 @@ uint32 UFlareCargoBay::GetFreeSpaceForResource(FFlareResourceDescription* Resour
 
 bool UFlareCargoBay::HasRestrictions() const
 {
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
-	{
-		const FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if(Cargo.Restriction != EFlareResourceRestriction::Everybody)
-		{
-			return true;
-		}
-	}
-	return false;
+	return RestrictedSlotCount > 0;
 }
 
 uint32 UFlareCargoBay::GetSlotCount() const
@@ -417,6 +506,7 @@ bool UFlareCargoBay::LockSlot(FFlareResourceDescription* Resource, EFlareResourc
 
 		if (Cargo.Lock == EFlareResourceLock::NoLock && (Cargo.Resource == NULL || Cargo.Resource == Resource))
 		{
+			UpdateSlotSummary(CargoIndex, false);
 			Cargo.Lock = LockType;
 			Cargo.ManualLock = ManualLock;
 
@@ -425,6 +515,9 @@ bool UFlareCargoBay::LockSlot(FFlareResourceDescription* Resource, EFlareResourc
 				Cargo.Resource = Resource;
 				Cargo.Quantity = 0;
 			}
+			UpdateSlotSummary(CargoIndex, true);
+
+			OnCargoChanged();
 			return true;
 		}
 	}
@@ -445,6 +538,7 @@ void UFlareCargoBay::UnlockAll(bool IgnoreManualLock)
 				continue;
 			}
 
+			UpdateSlotSummary(CargoIndex, false);
 			Cargo.Lock = EFlareResourceLock::NoLock;
 			Cargo.ManualLock = false;
 
@@ -452,8 +546,11 @@ void UFlareCargoBay::UnlockAll(bool IgnoreManualLock)
 			{
 				Cargo.Resource = NULL;
 			}
+			UpdateSlotSummary(CargoIndex, true);
 		}
 	}
+
+	OnCargoChanged();
 }
 
 void UFlareCargoBay::SetSlotRestriction(int32 SlotIndex, EFlareResourceRestriction::Type RestrictionType)
@@ -461,77 +558,46 @@ void UFlareCargoBay::SetSlotRestriction(int32 SlotIndex, EFlareResourceRestricti
 	if(SlotIndex >= CargoBay.Num())
 	{
 		FLOGV("Invalid index %d for set slot restriction (cargo bay size: %d)", SlotIndex, CargoBay.Num());
+		return;
 	}
-	CargoBay[SlotIndex].Restriction = RestrictionType;
+
+	FFlareCargo& Cargo = CargoBay[SlotIndex];
+	RestrictedSlotCount += (RestrictionType != EFlareResourceRestriction::Everybody) - (Cargo.Restriction != EFlareResourceRestriction::Everybody);
+
+	UpdateSlotSummary(SlotIndex, false);
+	Cargo.Restriction = RestrictionType;
+	UpdateSlotSummary(SlotIndex, true);
+
+	OnCargoChanged();
 }
 
-bool UFlareCargoBay::WantSell(FFlareResourceDescription* Resource, UFlareCompany* Client) const
+void UFlareCargoBay::OnCargoChanged()
 {
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	if (Parent->GetFactories().Num() > 0)
 	{
-		const FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if(Cargo.Resource != NULL && Cargo.Resource != Resource)
-		{
-			continue;
-		}
+		Game->GetGameWorld()->WakeFactories(Parent);
+	}
 
-		if(!CheckRestriction(&Cargo, Client))
-		{
-			continue;
-		}
+	Parent->GetCompany()->InvalidateSpacecraftValue(Parent);
+}
 
-		if(Cargo.Lock == EFlareResourceLock::NoLock ||
-				Cargo.Lock == EFlareResourceLock::Output ||
-				Cargo.Lock == EFlareResourceLock::Trade)
-		{
-			return true;
-		}
-	}
+bool UFlareCargoBay::WantSell(FFlareResourceDescription* Resource, UFlareCompany* Client) const
+{
+	EFlareCargoClient::Type ClientClass = GetClientClass(Client);
+	const FFlareCargoResourceSummary* Summary = GetSummary(Resource);
 
-	return false;
+	return EmptySlots.SellSlotCount[ClientClass] > 0 || (Resource && Summary && Summary->SellSlotCount[ClientClass] > 0);
 }
 
 bool UFlareCargoBay::WantBuy(FFlareResourceDescription* Resource, UFlareCompany* Client) const
 {
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
-	{
-		const FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if(Cargo.Resource != NULL && Cargo.Resource != Resource)
-		{
-			continue;
-		}
-
-		if(!CheckRestriction(&Cargo, Client))
-		{
-			continue;
-		}
+	EFlareCargoClient::Type ClientClass = GetClientClass(Client);
+	const FFlareCargoResourceSummary* Summary = GetSummary(Resource);
 
-		if(Cargo.Lock == EFlareResourceLock::NoLock ||
-				Cargo.Lock == EFlareResourceLock::Input||
-				Cargo.Lock == EFlareResourceLock::Trade)
-		{
-			return true;
-		}
-	}
-	return false;
+	return EmptySlots.BuySlotCount[ClientClass] > 0 || (Resource && Summary && Summary->BuySlotCount[ClientClass] > 0);
 }
 
 bool UFlareCargoBay::CheckRestriction(const FFlareCargo* Cargo, UFlareCompany* Client) const
 {
-	if(Client)
-	{
-		// Check restrictions
-		if(Cargo->Restriction == EFlareResourceRestriction::Nobody)
-		{
-			// Restricted slot
-			return false;
-		}
-
-		if(Cargo->Restriction == EFlareResourceRestriction::OwnerOnly && Client != Parent->GetCompany())
-		{
-			// Restricted slot
-			return false;
-		}
-	}
-	return true;
+	return CheckClientRestriction(Cargo, GetClientClass(Client));
 }
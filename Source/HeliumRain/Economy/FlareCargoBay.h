@@ -7,6 +7,46 @@ struct FFlareCargo;
 struct FFlareResourceDescription;
 
 
+/** Client classes seeing different slots because of restrictions */
+namespace EFlareCargoClient
+{
+	enum Type
+	{
+		Any, /** No client, restrictions are ignored */
+		Owner, /** Owner company */
+		Other, /** Any other company */
+		Count
+	};
+}
+
+/** Per-resource view of the cargo slots */
+struct FFlareCargoResourceSummary
+{
+	/** Stored quantity, per client class */
+	uint32 Quantity[EFlareCargoClient::Count];
+
+	/** Slots holding the resource, per client class */
+	uint32 SlotCount[EFlareCargoClient::Count];
+
+	/** Slots open to selling the resource, per client class */
+	uint32 SellSlotCount[EFlareCargoClient::Count];
+
+	/** Slots open to buying the resource, per client class */
+	uint32 BuySlotCount[EFlareCargoClient::Count];
+
+	/** Sorted indexes of the slots holding the resource */
+	TArray<int32> SlotIndexes;
+
+	FFlareCargoResourceSummary()
+	{
+		FMemory::Memzero(Quantity);
+		FMemory::Memzero(SlotCount);
+		FMemory::Memzero(SellSlotCount);
+		FMemory::Memzero(BuySlotCount);
+	}
+};
+
+
 UCLASS()
 class HELIUMRAIN_API UFlareCargoBay : public UObject
 {
@@ -48,6 +88,27 @@ public:
 
 protected:
 
+	/** Cargo content or rules changed : blocked factories may restart */
+	void OnCargoChanged();
+
+	uint32 TakeResourcesInternal(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client);
+
+	uint32 GiveResourcesInternal(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Client);
+
+	/** Rebuild the resource summaries from the slots */
+	void RebuildSummaries();
+
+	/** Add or remove a slot from the resource summaries, around each slot change */
+	void UpdateSlotSummary(int32 SlotIndex, bool Add);
+
+	/** Get the summary of a resource, empty slots for a null resource */
+	const FFlareCargoResourceSummary* GetSummary(FFlareResourceDescription* Resource) const;
+
+	EFlareCargoClient::Type GetClientClass(UFlareCompany* Client) const;
+
+	static bool CheckClientRestriction(const FFlareCargo* Cargo, EFlareCargoClient::Type ClientClass);
+
+
 	/*----------------------------------------------------
 	   Protected data
 	----------------------------------------------------*/
@@ -58,6 +119,11 @@ protected:
 
 	TArray<FFlareCargo>                        CargoBay;
 
+	// Slot index, the slots stay the reference
+	TMap<FFlareResourceDescription*, FFlareCargoResourceSummary> ResourceSummaries;
+	FFlareCargoResourceSummary                 EmptySlots;
+	int32                                      RestrictedSlotCount;
+
 	// Cache
 	uint32								       CargoBayCount;
 	uint32								       CargoBayBaseCapacity;
@@ -88,8 +154,10 @@ public:
 
 	bool HasRestrictions() const;
 
+	/** Slots are read only, use the gameplay methods to change them */
 	FFlareCargo* GetSlot(uint32 Index);
 
+	/** Slots are read only, use the gameplay methods to change them */
 	TArray<FFlareCargo>& GetSlots()
 	{
 		return CargoBay;
@@ -30,11 +30,18 @@ void UFlareFactory::Load(UFlareSimulatedSpacecraft* ParentSpacecraft, const FFla
 	FactoryDescription = Description;
 	Parent = ParentSpacecraft;
 	CycleCostCacheLevel = -1;
+
+	ScheduleState = EFlareFactorySchedule::Awake;
+	ScheduledWakeUpDate = 0;
+	ScheduledProductionTime = 0;
+	LastSimulationDate = 0;
+	ScheduleOrder = 0;
 }
 
 
 FFlareFactorySave* UFlareFactory::Save()
 {
+	SyncProduction();
 	return &FactoryData;
 }
 
@@ -117,7 +124,10 @@ void UFlareFactory::UpdateDynamicState()
 
 void UFlareFactory::Start()
 {
+	Wake();
+
 	FactoryData.Active = true;
+	RefreshSectorIndex();
 
 	// Stop other factories
 	// TODO Remove the code if it's sure
@@ -153,27 +163,39 @@ void UFlareFactory::Start()
 
 void UFlareFactory::Pause()
 {
+	Wake();
+
 	FactoryData.Active = false;
+	RefreshSectorIndex();
 }
 
 void UFlareFactory::Stop()
 {
+	Wake();
+
 	FactoryData.Active = false;
+	RefreshSectorIndex();
 	CancelProduction();
 }
 
 void UFlareFactory::SetInfiniteCycle(bool Mode)
 {
+	Wake();
+
 	FactoryData.InfiniteCycle = Mode;
 }
 
 void UFlareFactory::SetCycleCount(uint32 Count)
 {
+	Wake();
+
 	FactoryData.CycleCount = Count;
 }
 
 void UFlareFactory::SetOutputLimit(FFlareResourceDescription* Resource, uint32 MaxSlot)
 {
+	Wake();
+
 	bool ExistingResource = false;
 	for (int32 CargoLimitIndex = 0 ; CargoLimitIndex < FactoryData.OutputCargoLimit.Num() ; CargoLimitIndex++)
 	{
@@ -196,6 +218,8 @@ void UFlareFactory::SetOutputLimit(FFlareResourceDescription* Resource, uint32 M
 
 void UFlareFactory::ClearOutputLimit(FFlareResourceDescription* Resource)
 {
+	Wake();
+
 	for (int32 CargoLimitIndex = 0 ; CargoLimitIndex < FactoryData.OutputCargoLimit.Num() ; CargoLimitIndex++)
 	{
 		if (FactoryData.OutputCargoLimit[CargoLimitIndex].ResourceIdentifier == Resource->Identifier)
@@ -243,6 +267,8 @@ void UFlareFactory::OrderShip(UFlareCompany* OrderCompany, FName ShipIdentifier)
 		}
 	}
 
+	Wake();
+
 	FactoryData.OrderShipClass = ShipIdentifier;
 	FactoryData.OrderShipCompany = OrderCompany->GetIdentifier();
 	FactoryData.OrderShipAdvancePayment = ShipPrice;
@@ -250,6 +276,8 @@ void UFlareFactory::OrderShip(UFlareCompany* OrderCompany, FName ShipIdentifier)
 
 void UFlareFactory::CancelOrder()
 {
+	Wake();
+
 	if(FactoryData.OrderShipCompany != NAME_None)
 	{
 		UFlareCompany* Company = GetGame()->GetGameWorld()->FindCompany(FactoryData.OrderShipCompany);
@@ -436,6 +464,7 @@ void UFlareFactory::BeginProduction()
 	}
 
 	FactoryData.CostReserved = GetProductionCost();
+	Parent->GetCompany()->InvalidateSpacecraftValue(Parent);
 }
 
 void UFlareFactory::CancelProduction()
@@ -460,6 +489,8 @@ void UFlareFactory::CancelProduction()
 		}
 	}
 
+	Parent->GetCompany()->InvalidateSpacecraftValue(Parent);
+
 	FactoryData.ProductedDuration = 0;
 	FactoryData.TargetShipClass = NAME_None;
 	FactoryData.TargetShipCompany = NAME_None;
@@ -493,6 +524,7 @@ void UFlareFactory::DoProduction()
 			}
 		}
 	}
+	Parent->GetCompany()->InvalidateSpacecraftValue(Parent);
 
 	// Generate output resources
 	TArray<FFlareFactoryResource> OutputResources = GetLimitedOutputResources();
@@ -531,6 +563,8 @@ void UFlareFactory::DoProduction()
 
 FFlareWorldEvent *UFlareFactory::GenerateEvent()
 {
+	SyncProduction();
+
 	if (!FactoryData.Active || !IsNeedProduction())
 	{
 		return NULL;
@@ -551,6 +585,71 @@ FFlareWorldEvent *UFlareFactory::GenerateEvent()
 	return NULL;
 }
 
+void UFlareFactory::SyncProduction(int64 UpToDate)
+{
+	if (UpToDate <= LastSimulationDate)
+	{
+		return;
+	}
+
+	// Sleeping factories are either counting days, or not changing at all
+	if (ScheduleState == EFlareFactorySchedule::Producing)
+	{
+		FactoryData.ProductedDuration = FMath::Min(ScheduledProductionTime, FactoryData.ProductedDuration + (UpToDate - LastSimulationDate));
+	}
+
+	LastSimulationDate = UpToDate;
+}
+
+void UFlareFactory::SyncProduction()
+{
+	SyncProduction(Game->GetGameWorld()->GetFactorySimulationDate());
+}
+
+void UFlareFactory::Wake()
+{
+	Game->GetGameWorld()->WakeFactory(this);
+}
+
+void UFlareFactory::RefreshSectorIndex()
+{
+	if (Parent->GetCurrentSector())
+	{
+		Parent->GetCurrentSector()->RefreshStationIndex(Parent);
+	}
+}
+
+bool UFlareFactory::IsInProductionCycle()
+{
+	return FactoryData.Active
+		&& IsNeedProduction()
+		&& HasCostReserved()
+		&& FactoryData.ProductedDuration < GetProductionTime(GetCycleData());
+}
+
+void UFlareFactory::SetSchedule(EFlareFactorySchedule::Type State, int64 WakeUpDate)
+{
+	ScheduleState = State;
+	ScheduledWakeUpDate = WakeUpDate;
+
+	if (State == EFlareFactorySchedule::Producing)
+	{
+		ScheduledProductionTime = GetProductionTime(GetCycleData());
+	}
+}
+
+void UFlareFactory::InitSchedule(int32 Order, int64 Date)
+{
+	ScheduleOrder = Order;
+	LastSimulationDate = Date;
+	ScheduleState = EFlareFactorySchedule::Awake;
+}
+
+void UFlareFactory::MarkSimulated(int64 Date)
+{
+	LastSimulationDate = Date;
+}
+
 void UFlareFactory::PerformCreateShipAction(const FFlareFactoryAction* Action)
 {
 	FFlareSpacecraftDescription* ShipDescription = GetGame()->GetSpacecraftCatalog()->Get(FactoryData.TargetShipClass);
@@ -670,6 +769,7 @@ uint32 UFlareFactory::GetProductionCost(const FFlareProductionData* Data)
 
 int64 UFlareFactory::GetRemainingProductionDuration()
 {
+	SyncProduction();
 	return GetProductionTime(GetCycleData()) - FactoryData.ProductedDuration;
 }
 
@@ -8,6 +8,24 @@
 class UFlareSimulatedSpacecraft;
 
 
+/** Factory scheduling state */
+UENUM()
+namespace EFlareFactorySchedule
+{
+	enum Type
+	{
+		/** Simulated at the next factory phase */
+		Awake,
+		/** Counting production days, sleeps until the end of the cycle */
+		Producing,
+		/** Idle or blocked, sleeps until a cargo, money or state change */
+		Blocked,
+		/** Not in the world anymore */
+		Removed
+	};
+}
+
+
 
 UCLASS()
 class HELIUMRAIN_API UFlareFactory : public UObject
@@ -74,6 +92,50 @@ public:
 	void PerformCreateShipAction(const FFlareFactoryAction* Action);
 
 
+	/*----------------------------------------------------
+	   Scheduling
+	----------------------------------------------------*/
+
+	/** Account for the production days that elapsed while the factory was sleeping, up to UpToDate */
+	void SyncProduction(int64 UpToDate);
+
+	/** Account for the production days that elapsed while the factory was sleeping */
+	void SyncProduction();
+
+	/** Ask the world to simulate this factory at the next factory phase */
+	void Wake();
+
+	/** Update the parent sector resource roles after an activity change */
+	void RefreshSectorIndex();
+
+	/** Is the factory counting days of a production cycle */
+	bool IsInProductionCycle();
+
+	inline EFlareFactorySchedule::Type GetScheduleState() const
+	{
+		return ScheduleState;
+	}
+
+	inline int64 GetScheduledWakeUpDate() const
+	{
+		return ScheduledWakeUpDate;
+	}
+
+	inline int32 GetScheduleOrder() const
+	{
+		return ScheduleOrder;
+	}
+
+	/** Set the scheduling state, called by the world scheduler only */
+	void SetSchedule(EFlareFactorySchedule::Type State, int64 WakeUpDate = 0);
+
+	/** Set the simulation order and reference date, called by the world scheduler only */
+	void InitSchedule(int32 Order, int64 Date);
+
+	/** The factory has been simulated for this date, called by the world scheduler only */
+	void MarkSimulated(int64 Date);
+
+
 protected:
 
 	/*----------------------------------------------------
@@ -91,6 +153,13 @@ protected:
 	FFlareProductionData CycleCostCache;
 	int32 CycleCostCacheLevel;
 
+	// Scheduling data
+	EFlareFactorySchedule::Type              ScheduleState;
+	int64                                    ScheduledWakeUpDate;
+	int64                                    ScheduledProductionTime;
+	int64                                    LastSimulationDate;
+	int32                                    ScheduleOrder;
+
 public:
 
 	/*----------------------------------------------------
@@ -158,6 +227,7 @@ public:
 
 	inline int64 GetProductedDuration()
 	{
+		SyncProduction();
 		return FactoryData.ProductedDuration;
 	}
 
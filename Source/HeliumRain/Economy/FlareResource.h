@@ -53,6 +53,9 @@ struct FFlareResourceDescription
 	/** Display sorting index */
 	UPROPERTY(EditAnywhere, Category = Content)
 	float DisplayIndex;
+
+	/** Index in the resource catalog, set by the catalog */
+	int32 CatalogIndex;
 };
 
 /** Spacecraft cargo data */
@@ -5,6 +5,7 @@
 #include "../FlareCompany.h"
 #include "../FlareScenarioTools.h"
 #include "../../Spacecrafts/FlareSimulatedSpacecraft.h"
+#include "JsonObjectConverter.h"
 
 
 /*----------------------------------------------------
@@ -27,6 +28,8 @@ void UFlareAIBehavior::Load(UFlareCompany* ParentCompany)
 		check(ST);
 
 		GenerateAffilities();
+		LoadPersonalityOverrides();
+		ApplyPersonality();
 
 		// TODO save
 		PirateLowProfile = true;
@@ -125,6 +128,24 @@ void UFlareAIBehavior::UpdateDiplomacy()
 	}
 }
 
+void UFlareAIBehavior::SetPersonality(const FFlareAIPersonality& NewPersonality)
+{
+	Personality = NewPersonality;
+	ApplyPersonality();
+}
+
+FString UFlareAIBehavior::SavePersonality() const
+{
+	FString Result;
+	FJsonObjectConverter::UStructToJsonObjectString(FFlareAIPersonality::StaticStruct(), &Personality, Result, 0, 0);
+	return Result;
+}
+
+bool UFlareAIBehavior::LoadPersonality(const FString& Text, FFlareAIPersonality& Result)
+{
+	return FJsonObjectConverter::JsonObjectStringToUStruct(Text, &Result, 0, 0);
+}
+
 void UFlareAIBehavior::SimulatePirateBehavior()
 {
 	// Repair and refill ships and stations
@@ -152,8 +173,9 @@ void UFlareAIBehavior::SimulatePirateBehavior()
 
 void UFlareAIBehavior::GenerateAffilities()
 {
-	// Reset resource affilities
-	ResourceAffilities.Empty();
+	// Reset affilities
+	Personality.ResourceAffilities.Empty();
+	Personality.SectorAffilities.Empty();
 
 
 	// Default behavior
@@ -360,6 +382,99 @@ void UFlareAIBehavior::GenerateAffilities()
 		Peaceful = 10.0;
 	}
 
+	// Behavior values go to the personality with the affilities
+	Personality.StationCapture = StationCapture;
+	Personality.TradingBuy = TradingBuy;
+	Personality.TradingSell = TradingSell;
+	Personality.TradingBoth = TradingBoth;
+	Personality.ShipyardAffility = ShipyardAffility;
+	Personality.ConsumerAffility = ConsumerAffility;
+	Personality.MaintenanceAffility = MaintenanceAffility;
+	Personality.BudgetTechnology = BudgetTechnology;
+	Personality.BudgetMilitary = BudgetMilitary;
+	Personality.BudgetStation = BudgetStation;
+	Personality.BudgetTrade = BudgetTrade;
+	Personality.ArmySize = ArmySize;
+	Personality.Agressivity = Agressivity;
+	Personality.Bold = Bold;
+	Personality.Peaceful = Peaceful;
+}
+
+/** Read "Identifier:Value" config entries into an affility list */
+static void ReadAffilityOverrides(const TArray<FString>& Entries, TArray<FFlareAIAffility>& Affilities)
+{
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
+	{
+		FString Identifier;
+		FString Value;
+		if (Entries[EntryIndex].Split(TEXT(":"), &Identifier, &Value))
+		{
+			FFlareAIPersonality::SetAffility(Affilities, FName(*Identifier.Trim().TrimTrailing()), FCString::Atof(*Value));
+		}
+		else
+		{
+			FLOGV("UFlareAIBehavior : invalid affility override '%s'", *Entries[EntryIndex]);
+		}
+	}
+}
+
+void UFlareAIBehavior::LoadPersonalityOverrides()
+{
+	FString Section = FString::Printf(TEXT("FlareAI.%s"), *Company->GetShortName().ToString());
+
+	// Behavior values, by name
+	for (TFieldIterator<UFloatProperty> It(FFlareAIPersonality::StaticStruct()); It; ++It)
+	{
+		float Value;
+		if (GConfig->GetFloat(*Section, *It->GetName(), Value, GGameIni))
+		{
+			FLOGV("UFlareAIBehavior::LoadPersonalityOverrides : %s %s = %f", *Company->GetShortName().ToString(), *It->GetName(), Value);
+			It->SetPropertyValue_InContainer(&Personality, Value);
+		}
+	}
+
+	// Affilities
+	TArray<FString> Entries;
+	GConfig->GetArray(*Section, TEXT("ResourceAffility"), Entries, GGameIni);
+	ReadAffilityOverrides(Entries, Personality.ResourceAffilities);
+
+	GConfig->GetArray(*Section, TEXT("SectorAffility"), Entries, GGameIni);
+	ReadAffilityOverrides(Entries, Personality.SectorAffilities);
+}
+
+void UFlareAIBehavior::ApplyPersonality()
+{
+	StationCapture = Personality.StationCapture;
+	TradingBuy = Personality.TradingBuy;
+	TradingSell = Personality.TradingSell;
+	TradingBoth = Personality.TradingBoth;
+	ShipyardAffility = Personality.ShipyardAffility;
+	ConsumerAffility = Personality.ConsumerAffility;
+	MaintenanceAffility = Personality.MaintenanceAffility;
+	BudgetTechnology = Personality.BudgetTechnology;
+	BudgetMilitary = Personality.BudgetMilitary;
+	BudgetStation = Personality.BudgetStation;
+	BudgetTrade = Personality.BudgetTrade;
+	ArmySize = Personality.ArmySize;
+	Agressivity = Personality.Agressivity;
+	Bold = Personality.Bold;
+	Peaceful = Personality.Peaceful;
+
+	// Dense tables for the AI scoring loops
+	TArray<UFlareResourceCatalogEntry*>& Resources = Game->GetResourceCatalog()->Resources;
+	ResourceAffilityTable.SetNum(Resources.Num());
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	{
+		ResourceAffilityTable[ResourceIndex] = FFlareAIPersonality::GetAffility(Personality.ResourceAffilities, Resources[ResourceIndex]->Data.Identifier);
+	}
+
+	TArray<UFlareSimulatedSector*>& Sectors = Game->GetGameWorld()->GetSectors();
+	SectorAffilityTable.SetNum(Sectors.Num());
+	for (int32 SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		check(Sectors[SectorIndex]->GetWorldIndex() == SectorIndex);
+		SectorAffilityTable[SectorIndex] = FFlareAIPersonality::GetAffility(Personality.SectorAffilities, Sectors[SectorIndex]->GetIdentifier());
+	}
 }
 
 void UFlareAIBehavior::SetResourceAffilities(float Value)
@@ -373,13 +488,7 @@ void UFlareAIBehavior::SetResourceAffilities(float Value)
 
 void UFlareAIBehavior::SetResourceAffility(FFlareResourceDescription* Resource, float Value)
 {
-	if(ResourceAffilities.Contains(Resource)){
-		ResourceAffilities[Resource] = Value;
-	}
-	else
-	{
-		ResourceAffilities.Add(Resource, Value);
-	}
+	FFlareAIPersonality::SetAffility(Personality.ResourceAffilities, Resource->Identifier, Value);
 }
 
 
@@ -394,13 +503,7 @@ void UFlareAIBehavior::SetSectorAffilities(float Value)
 
 void UFlareAIBehavior::SetSectorAffility(UFlareSimulatedSector* Sector, float Value)
 {
-	if(SectorAffilities.Contains(Sector)){
-		SectorAffilities[Sector] = Value;
-	}
-	else
-	{
-		SectorAffilities.Add(Sector, Value);
-	}
+	FFlareAIPersonality::SetAffility(Personality.SectorAffilities, Sector->GetIdentifier(), Value);
 }
 
 void UFlareAIBehavior::SetSectorAffilitiesByMoon(FFlareCelestialBody *CelestialBody, float Value)
@@ -423,18 +526,89 @@ void UFlareAIBehavior::SetSectorAffilitiesByMoon(FFlareCelestialBody *CelestialB
 
 float UFlareAIBehavior::GetSectorAffility(UFlareSimulatedSector* Sector)
 {
-	if(SectorAffilities.Contains(Sector))
+	return SectorAffilityTable[Sector->GetWorldIndex()];
+}
+
+float UFlareAIBehavior::GetResourceAffility(FFlareResourceDescription* Resource)
+{
+	return ResourceAffilityTable[Resource->CatalogIndex];
+}
+
+
+/*----------------------------------------------------
+	Personality
+----------------------------------------------------*/
+
+void FFlareAIPersonality::SetAffility(TArray<FFlareAIAffility>& Affilities, FName Identifier, float Value)
+{
+	for (int32 Index = 0; Index < Affilities.Num(); Index++)
 	{
-		return SectorAffilities[Sector];
+		if (Affilities[Index].Identifier == Identifier)
+		{
+			Affilities[Index].Value = Value;
+			return;
+		}
 	}
-	return 1.f;
+
+	FFlareAIAffility Affility;
+	Affility.Identifier = Identifier;
+	Affility.Value = Value;
+	Affilities.Add(Affility);
 }
 
-float UFlareAIBehavior::GetResourceAffility(FFlareResourceDescription* Resource)
+float FFlareAIPersonality::GetAffility(const TArray<FFlareAIAffility>& Affilities, FName Identifier)
 {
-	if(ResourceAffilities.Contains(Resource))
+	for (int32 Index = 0; Index < Affilities.Num(); Index++)
 	{
-		return ResourceAffilities[Resource];
+		if (Affilities[Index].Identifier == Identifier)
+		{
+			return Affilities[Index].Value;
+		}
 	}
+
 	return 1.f;
 }
+
+/** Add a line for each affility that differs between two lists */
+static void DiffAffilities(const FString& Name, const TArray<FFlareAIAffility>& A, const TArray<FFlareAIAffility>& B, TArray<FString>& Result)
+{
+	TArray<FName> Identifiers;
+	for (int32 Index = 0; Index < A.Num(); Index++)
+	{
+		Identifiers.AddUnique(A[Index].Identifier);
+	}
+	for (int32 Index = 0; Index < B.Num(); Index++)
+	{
+		Identifiers.AddUnique(B[Index].Identifier);
+	}
+
+	for (int32 Index = 0; Index < Identifiers.Num(); Index++)
+	{
+		float ValueA = FFlareAIPersonality::GetAffility(A, Identifiers[Index]);
+		float ValueB = FFlareAIPersonality::GetAffility(B, Identifiers[Index]);
+		if (ValueA != ValueB)
+		{
+			Result.Add(FString::Printf(TEXT("%s %s : %f -> %f"), *Name, *Identifiers[Index].ToString(), ValueA, ValueB));
+		}
+	}
+}
+
+TArray<FString> FFlareAIPersonality::Diff(const FFlareAIPersonality& Other) const
+{
+	TArray<FString> Result;
+
+	for (TFieldIterator<UFloatProperty> It(FFlareAIPersonality::StaticStruct()); It; ++It)
+	{
+		float Value = It->GetPropertyValue_InContainer(this);
+		float OtherValue = It->GetPropertyValue_InContainer(&Other);
+		if (Value != OtherValue)
+		{
+			Result.Add(FString::Printf(TEXT("%s : %f -> %f"), *It->GetName(), Value, OtherValue));
+		}
+	}
+
+	DiffAffilities(TEXT("ResourceAffility"), ResourceAffilities, Other.ResourceAffilities, Result);
+	DiffAffilities(TEXT("SectorAffility"), SectorAffilities, Other.SectorAffilities, Result);
+
+	return Result;
+}
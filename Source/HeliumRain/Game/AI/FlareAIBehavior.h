@@ -9,6 +9,76 @@ class UFlareCompany;
 class UFlareScenarioTools;
 struct FFlareCelestialBody;
 
+
+/** Affility for a sector or resource identifier */
+USTRUCT()
+struct FFlareAIAffility
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Content)
+	FName Identifier;
+
+	UPROPERTY(EditAnywhere, Category = Content)
+	float Value;
+};
+
+/** Tunable company AI profile, generated by the behavior and overridable from the game config */
+USTRUCT()
+struct FFlareAIPersonality
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Behavior values, see UFlareAIBehavior */
+	UPROPERTY(EditAnywhere, Category = Content)
+	float StationCapture;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float TradingBuy;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float TradingSell;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float TradingBoth;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float ShipyardAffility;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float ConsumerAffility;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float MaintenanceAffility;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float BudgetTechnology;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float BudgetMilitary;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float BudgetStation;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float BudgetTrade;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float ArmySize;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float Agressivity;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float Bold;
+	UPROPERTY(EditAnywhere, Category = Content)
+	float Peaceful;
+
+	/** Resource affilities, 1 for missing resources */
+	UPROPERTY(EditAnywhere, Category = Content)
+	TArray<FFlareAIAffility> ResourceAffilities;
+
+	/** Sector affilities, 1 for missing sectors */
+	UPROPERTY(EditAnywhere, Category = Content)
+	TArray<FFlareAIAffility> SectorAffilities;
+
+	/** Set an affility, replacing the previous value */
+	static void SetAffility(TArray<FFlareAIAffility>& Affilities, FName Identifier, float Value);
+
+	/** Get an affility, 1 if not set */
+	static float GetAffility(const TArray<FFlareAIAffility>& Affilities, FName Identifier);
+
+	/** Describe the differences with another profile, one line each */
+	TArray<FString> Diff(const FFlareAIPersonality& Other) const;
+};
+
 UCLASS()
 class HELIUMRAIN_API UFlareAIBehavior : public UObject
 {
@@ -27,6 +97,15 @@ public:
 
 	void UpdateDiplomacy();
 
+	/** Set and apply a new personality */
+	void SetPersonality(const FFlareAIPersonality& NewPersonality);
+
+	/** Export the personality as JSON */
+	FString SavePersonality() const;
+
+	/** Import a personality saved as JSON, return false if it can't be read */
+	static bool LoadPersonality(const FString& Text, FFlareAIPersonality& Result);
+
 protected:
 
 	/*----------------------------------------------------
@@ -41,6 +120,12 @@ protected:
 
 	void GenerateAffilities();
 
+	/** Override the generated personality with the "FlareAI.<company short name>" section of the game config */
+	void LoadPersonalityOverrides();
+
+	/** Copy the personality into the behavior values and the dense affility tables */
+	void ApplyPersonality();
+
 	/*----------------------------------------------------
 		Helpers
 	----------------------------------------------------*/
@@ -68,8 +153,13 @@ protected:
 	UFlareScenarioTools*                    ST;
 
 
-	TMap<FFlareResourceDescription*, float> ResourceAffilities;
-	TMap<UFlareSimulatedSector*, float> SectorAffilities;
+	/** Profile the behavior values are built from */
+	FFlareAIPersonality                    Personality;
+
+	/** Affilities by resource catalog index and by sector world index */
+	TArray<float>                          ResourceAffilityTable;
+	TArray<float>                          SectorAffilityTable;
+
 public:
 
 	/*----------------------------------------------------
@@ -105,6 +195,11 @@ public:
 		return Game;
 	}
 
+	const FFlareAIPersonality& GetPersonality() const
+	{
+		return Personality;
+	}
+
 	float GetSectorAffility(UFlareSimulatedSector* Sector);
 	float GetResourceAffility(FFlareResourceDescription* Resource);
 
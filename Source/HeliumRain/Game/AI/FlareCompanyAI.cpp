@@ -42,6 +42,8 @@ void UFlareCompanyAI::Load(UFlareCompany* ParentCompany, const FFlareCompanyAISa
 	ConstructionProjectNeedCapacity = AIData.ConstructionProjectNeedCapacity;
 	ConstructionShips.Empty();
 	ConstructionStaticShips.Empty();
+	ConstructionPlans.Empty();
+	ConstructionWorldStats.Empty();
 
 	if(AIData.ConstructionProjectSectorIdentifier != NAME_None)
 	{
@@ -135,23 +137,27 @@ void UFlareCompanyAI::Simulate()
 		Behavior->Load(Company);
 
 		UpdateDiplomacy();
-	
-		ResourceFlow = ComputeWorldResourceFlow();
-		WorldStats = WorldHelper::ComputeWorldResourceStats(Game);
-		Shipyards = FindShipyards();
+		UpdateWorldCaches();
 
-		// Compute input and output ressource equation (ex: 100 + 10/ day)
-		WorldResourceVariation.Empty();
-		for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
-		{
-			UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
-			SectorVariation Variation = ComputeSectorResourceVariation(Sector);
+		Behavior->Simulate();
+	}
+}
 
-			WorldResourceVariation.Add(Sector, Variation);
-			//DumpSectorResourceVariation(Sector, &Variation);
-		}
+void UFlareCompanyAI::UpdateWorldCaches()
+{
+	ResourceFlow = ComputeWorldResourceFlow();
+	WorldStats = WorldHelper::ComputeWorldResourceStats(Game);
+	Shipyards = FindShipyards();
 
-		Behavior->Simulate();
+	// Compute input and output ressource equation (ex: 100 + 10/ day)
+	WorldResourceVariation.Empty();
+	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
+		SectorVariation Variation = ComputeSectorResourceVariation(Sector);
+
+		WorldResourceVariation.Add(Sector, Variation);
+		//DumpSectorResourceVariation(Sector, &Variation);
 	}
 }
 
@@ -202,59 +208,8 @@ int32 UFlareCompanyAI::UpdateTrading()
 		UFlareSimulatedSpacecraft* Ship = IdleCargos[ShipIndex];
 
 		//	FLOGV("UFlareCompanyAI::UpdateTrading : Search something to do for %s", *Ship->GetImmatriculation().ToString());
-		
-		SectorDeal BestDeal;
-		BestDeal.BuyQuantity = 0;
-		BestDeal.Score = 0;
-		BestDeal.Resource = NULL;
-		BestDeal.SectorA = NULL;
-		BestDeal.SectorB = NULL;
-		
-		// Stay here option
-		
-		for (int32 SectorAIndex = 0; SectorAIndex < Company->GetKnownSectors().Num(); SectorAIndex++)
-		{
-			UFlareSimulatedSector* SectorA = Company->GetKnownSectors()[SectorAIndex];
-
-			SectorDeal SectorBestDeal;
-			SectorBestDeal.Resource = NULL;
-			SectorBestDeal.BuyQuantity = 0;
-			SectorBestDeal.Score = 0;
-			SectorBestDeal.Resource = NULL;
-			SectorBestDeal.SectorA = NULL;
-			SectorBestDeal.SectorB = NULL;
-			
-			while (true)
-			{
-				SectorBestDeal = FindBestDealForShipFromSector(Ship, SectorA, &BestDeal);
-				if (!SectorBestDeal.Resource)
-				{
-					// No best deal found
-					break;
-				}
-
-				SectorVariation* SectorVariationA = &WorldResourceVariation[SectorA];
-				if (Ship->GetCurrentSector() != SectorA && SectorVariationA->IncomingCapacity > 0 && SectorBestDeal.BuyQuantity > 0)
-				{
-					//FLOGV("UFlareCompanyAI::UpdateTrading : IncomingCapacity to %s = %d", *SectorA->GetSectorName().ToString(), SectorVariationA->IncomingCapacity);
-					int32 UsedIncomingCapacity = FMath::Min(SectorBestDeal.BuyQuantity, SectorVariationA->IncomingCapacity);
-
-					SectorVariationA->IncomingCapacity -= UsedIncomingCapacity;
-					struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[SectorBestDeal.Resource];
-					VariationA->OwnedStock -= UsedIncomingCapacity;
-				}
-				else
-				{
-					break;
-				}
-			}
-
-			if (SectorBestDeal.Resource)
-			{
-				BestDeal = SectorBestDeal;
-			}
-		}
 
+		SectorDeal BestDeal = FindBestDealForShip(Ship);
 		if (BestDeal.Resource)
 		{
 			FLOGV("UFlareCompanyAI::UpdateTrading : Best balance for %s (%s) : %f score",
@@ -442,101 +397,25 @@ void UFlareCompanyAI::UpdateStationConstruction(int32& IdleCargoCapacity)
 	UFlareSimulatedSector* BestSector = NULL;
 	FFlareSpacecraftDescription* BestStationDescription = NULL;
 	UFlareSimulatedSpacecraft* BestStation = NULL;
-	TArray<UFlareSpacecraftCatalogEntry*>& StationCatalog = Game->GetSpacecraftCatalog()->StationCatalog;
 
 	FLOGV("UFlareCompanyAI::UpdateStationConstruction statics ships : %d construction ships : %d",
 		  ConstructionStaticShips.Num(), ConstructionShips.Num());
 
-	// Loop on sector list
-	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
-	{
-		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
+	FindBestConstruction(BestSector, BestStationDescription, BestStation, BestScore);
 
-		// Loop on catalog
-		for (int32 StationIndex = 0; StationIndex < StationCatalog.Num(); StationIndex++)
+	// Update current construction score
+	SectorConstructionPlan* CurrentPlan = ConstructionPlans.Find(ConstructionProjectSector);
+	if (CurrentPlan && Company->GetKnownSectors().Contains(ConstructionProjectSector))
+	{
+		for (int32 CandidateIndex = 0; CandidateIndex < CurrentPlan->Candidates.Num(); CandidateIndex++)
 		{
-			FFlareSpacecraftDescription* StationDescription = &StationCatalog[StationIndex]->Data;
-
-			// Check sector limitations
-			TArray<FText> Reasons;
-			if (!Sector->CanBuildStation(StationDescription, Company, Reasons, true))
+			const ConstructionCandidate& Candidate = CurrentPlan->Candidates[CandidateIndex];
+			if ((Candidate.Station && ConstructionProjectStation == Candidate.Station) ||
+				(!Candidate.Station && ConstructionProjectStationDescription == Candidate.StationDescription))
 			{
-				continue;
-			}
-
-			//FLOGV("> Analyse build %s in %s", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString());
-
-			// Count factories for the company, compute rentability in each sector for each station
-			for (int32 FactoryIndex = 0; FactoryIndex < StationDescription->Factories.Num(); FactoryIndex++)
-			{
-				FFlareFactoryDescription* FactoryDescription = &StationDescription->Factories[FactoryIndex]->Data;
-
-
-				// Add weight if the company already have another station in this type
-				float Score = ComputeConstructionScoreForStation(Sector, StationDescription, FactoryDescription, NULL);
-
-
-				// Update current construction score
-				if (ConstructionProjectSector == Sector && ConstructionProjectStationDescription == StationDescription)
-				{
-					CurrentConstructionScore = Score;
-					//FLOGV("Current : Score=%f", Score);
-				}
-
-				// Change best if we found better
-				if (Score > 0.f && (!BestStationDescription || Score > BestScore))
-				{
-					//FLOGV("New Best : Score=%f", Score);
-
-					BestScore = Score;
-					BestStationDescription = StationDescription;
-					BestStation = NULL;
-					BestSector = Sector;
-				}
+				CurrentConstructionScore = Candidate.Score;
 			}
 		}
-
-		for (int32 StationIndex = 0; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
-		{
-			UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
-			if(Station->GetCompany() != Company)
-			{
-				// Only AI company station
-				continue;
-			}
-
-			//FLOGV("> Analyse upgrade %s in %s", *Station->GetImmatriculation().ToString(), *Sector->GetSectorName().ToString());
-
-			// Count factories for the company, compute rentability in each sector for each station
-			for (int32 FactoryIndex = 0; FactoryIndex < Station->GetDescription()->Factories.Num(); FactoryIndex++)
-			{
-				FFlareFactoryDescription* FactoryDescription = &Station->GetDescription()->Factories[FactoryIndex]->Data;
-
-				// Add weight if the company already have another station in this type
-				float Score = ComputeConstructionScoreForStation(Sector, Station->GetDescription(), FactoryDescription, Station);
-
-				// Update current construction score
-				if (ConstructionProjectSector == Sector && ConstructionProjectStation == Station)
-				{
-					//FLOGV("Current update : Score=%f", Score);
-					CurrentConstructionScore = Score;
-				}
-
-				// Change best if we found better
-				if (Score > 0 && (!BestStationDescription || Score > BestScore))
-				{
-					//FLOGV("New Best update: Score=%f", Score);
-					BestScore = Score;
-					BestStationDescription = Station->GetDescription();
-					BestStation = Station;
-					BestSector = Sector;
-				}
-			}
-
-		}
-
-
-
 	}
 
 	if (BestSector && BestStationDescription)
@@ -603,7 +482,7 @@ void UFlareCompanyAI::UpdateStationConstruction(int32& IdleCargoCapacity)
 	{
 		TArray<FText> Reasons;
 		bool ShouldBeAbleToBuild = true;
-		if (!ConstructionProjectStation && !ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, Reasons, true))
+		if (!ConstructionProjectStation && !ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, true))
 		{
 			ShouldBeAbleToBuild = false;
 		}
@@ -622,7 +501,7 @@ void UFlareCompanyAI::UpdateStationConstruction(int32& IdleCargoCapacity)
 			}
 			else
 			{
-				BuildSuccess = ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, Reasons, false) &&
+				BuildSuccess = ConstructionProjectSector->CanBuildStation(ConstructionProjectStationDescription, Company, false) &&
 						(ConstructionProjectSector->BuildStation(ConstructionProjectStationDescription, Company) != NULL);
 			}
 
@@ -667,6 +546,310 @@ void UFlareCompanyAI::UpdateStationConstruction(int32& IdleCargoCapacity)
 	}
 }
 
+bool UFlareCompanyAI::FindBestConstruction(UFlareSimulatedSector*& BestSector, FFlareSpacecraftDescription*& BestStationDescription, UFlareSimulatedSpacecraft*& BestStation, float& BestScore)
+{
+	BestScore = 0;
+	BestSector = NULL;
+	BestStationDescription = NULL;
+	BestStation = NULL;
+
+	// Only the candidates whose inputs changed are scored again
+	UpdateConstructionPlanner();
+
+	// Loop on sector list
+	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
+		SectorConstructionPlan* Plan = ConstructionPlans.Find(Sector);
+		if (!Plan)
+		{
+			continue;
+		}
+
+		// New stations first, then upgrades, in catalog order
+		for (int32 CandidateIndex = 0; CandidateIndex < Plan->Candidates.Num(); CandidateIndex++)
+		{
+			const ConstructionCandidate& Candidate = Plan->Candidates[CandidateIndex];
+			float Score = Candidate.Score;
+
+			// Change best if we found better
+			if (Score > 0.f && (!BestStationDescription || Score > BestScore))
+			{
+				BestScore = Score;
+				BestStationDescription = Candidate.StationDescription;
+				BestStation = Candidate.Station;
+				BestSector = Sector;
+			}
+		}
+	}
+
+	return (BestSector != NULL);
+}
+
+void UFlareCompanyAI::UpdateConstructionPlanner()
+{
+	TArray<UFlareResourceCatalogEntry*>& Resources = Game->GetResourceCatalog()->Resources;
+
+	// World flows the scores depend on
+	TArray<bool> WorldDirtyResources;
+	WorldDirtyResources.Init(false, Resources.Num());
+	bool WorldStatsReset = (ConstructionWorldStats.Num() != Resources.Num());
+	if (WorldStatsReset)
+	{
+		ConstructionWorldStats.SetNumZeroed(Resources.Num());
+	}
+
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	{
+		WorldHelper::FlareResourceStats* Stats = WorldStats.Find(&Resources[ResourceIndex]->Data);
+		if (!Stats)
+		{
+			continue;
+		}
+
+		WorldHelper::FlareResourceStats& LastStats = ConstructionWorldStats[ResourceIndex];
+		if (WorldStatsReset || Stats->Production != LastStats.Production || Stats->Consumption != LastStats.Consumption || Stats->Balance != LastStats.Balance)
+		{
+			WorldDirtyResources[ResourceIndex] = true;
+			LastStats = *Stats;
+		}
+	}
+
+	// Sector prices and stations
+	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
+		SectorConstructionPlan& Plan = ConstructionPlans.FindOrAdd(Sector);
+
+		if (Plan.StationsDirty || Plan.DirtyPrices.Num() != Resources.Num())
+		{
+			ResetSectorConstructionPlan(Sector, Plan);
+		}
+
+		bool AllDirty = false;
+		float SectorAffility = Behavior->GetSectorAffility(Sector);
+		if (SectorAffility != Plan.SectorAffility)
+		{
+			Plan.SectorAffility = SectorAffility;
+			AllDirty = true;
+		}
+
+		// Score again what changed
+		for (int32 CandidateIndex = 0; CandidateIndex < Plan.Candidates.Num(); CandidateIndex++)
+		{
+			ConstructionCandidate& Candidate = Plan.Candidates[CandidateIndex];
+
+			if (Candidate.Station && Candidate.Station->GetLevel() != Candidate.StationLevel)
+			{
+				Candidate.StationLevel = Candidate.Station->GetLevel();
+				Candidate.Dirty = true;
+			}
+
+			for (int32 Index = 0; !Candidate.Dirty && Index < Candidate.Resources.Num(); Index++)
+			{
+				int32 ResourceIndex = Candidate.Resources[Index];
+				Candidate.Dirty = (Plan.DirtyPrices[ResourceIndex] || WorldDirtyResources[ResourceIndex]);
+			}
+
+			if (Candidate.Dirty || AllDirty)
+			{
+				Candidate.Score = ComputeConstructionScoreForStation(Sector, Candidate.StationDescription, Candidate.FactoryDescription, Candidate.Station);
+				Candidate.Dirty = false;
+			}
+		}
+
+		Plan.DirtyPrices.Init(false, Resources.Num());
+	}
+}
+
+void UFlareCompanyAI::InvalidateConstructionPlan(UFlareSimulatedSector* Sector, int32 ResourceIndex)
+{
+	SectorConstructionPlan* Plan = ConstructionPlans.Find(Sector);
+	if (!Plan)
+	{
+		return;
+	}
+
+	if (ResourceIndex == INDEX_NONE)
+	{
+		Plan->StationsDirty = true;
+	}
+	else if (ResourceIndex < Plan->DirtyPrices.Num())
+	{
+		Plan->DirtyPrices[ResourceIndex] = true;
+	}
+}
+
+void UFlareCompanyAI::ResetSectorConstructionPlan(UFlareSimulatedSector* Sector, SectorConstructionPlan& Plan)
+{
+	TArray<UFlareSpacecraftCatalogEntry*>& StationCatalog = Game->GetSpacecraftCatalog()->StationCatalog;
+	TArray<UFlareResourceCatalogEntry*>& Resources = Game->GetResourceCatalog()->Resources;
+
+	Plan.StationsDirty = false;
+	Plan.SectorAffility = Behavior->GetSectorAffility(Sector);
+	Plan.DirtyPrices.Init(false, Resources.Num());
+	Plan.Candidates.Empty();
+
+	// New stations
+	for (int32 StationIndex = 0; StationIndex < StationCatalog.Num(); StationIndex++)
+	{
+		FFlareSpacecraftDescription* StationDescription = &StationCatalog[StationIndex]->Data;
+
+		// Check sector limitations
+		if (!Sector->CanBuildStation(StationDescription, Company, true))
+		{
+			continue;
+		}
+
+		for (int32 FactoryIndex = 0; FactoryIndex < StationDescription->Factories.Num(); FactoryIndex++)
+		{
+			AddConstructionCandidate(Plan, StationDescription, &StationDescription->Factories[FactoryIndex]->Data, NULL);
+		}
+	}
+
+	// Upgrades
+	for (int32 StationIndex = 0; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
+	{
+		UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
+		if (Station->GetCompany() != Company)
+		{
+			continue;
+		}
+
+		for (int32 FactoryIndex = 0; FactoryIndex < Station->GetDescription()->Factories.Num(); FactoryIndex++)
+		{
+			AddConstructionCandidate(Plan, Station->GetDescription(), &Station->GetDescription()->Factories[FactoryIndex]->Data, Station);
+		}
+	}
+}
+
+void UFlareCompanyAI::AddConstructionCandidate(SectorConstructionPlan& Plan, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription, UFlareSimulatedSpacecraft* Station)
+{
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+
+	ConstructionCandidate Candidate;
+	Candidate.StationDescription = StationDescription;
+	Candidate.FactoryDescription = FactoryDescription;
+	Candidate.Station = Station;
+	Candidate.StationLevel = (Station ? Station->GetLevel() : 0);
+	Candidate.Score = 0;
+	Candidate.Dirty = true;
+
+	// Factory cycle, then station price
+	const FFlareProductionData* CycleCosts[] = { &FactoryDescription->CycleCost, &StationDescription->CycleCost };
+	for (int32 CostIndex = 0; CostIndex < ARRAY_COUNT(CycleCosts); CostIndex++)
+	{
+		for (int32 ResourceIndex = 0; ResourceIndex < CycleCosts[CostIndex]->InputResources.Num(); ResourceIndex++)
+		{
+			Candidate.Resources.AddUnique(ResourceCatalog->GetResourceIndex(&CycleCosts[CostIndex]->InputResources[ResourceIndex].Resource->Data));
+		}
+
+		for (int32 ResourceIndex = 0; ResourceIndex < CycleCosts[CostIndex]->OutputResources.Num(); ResourceIndex++)
+		{
+			Candidate.Resources.AddUnique(ResourceCatalog->GetResourceIndex(&CycleCosts[CostIndex]->OutputResources[ResourceIndex].Resource->Data));
+		}
+	}
+	Candidate.Resources.Remove(INDEX_NONE);
+
+	Plan.Candidates.Add(Candidate);
+}
+
+int32 UFlareCompanyAI::CheckConstructionCandidates(bool Verbose)
+{
+	Behavior->Load(Company);
+	WorldStats = WorldHelper::ComputeWorldResourceStats(Game);
+	UpdateConstructionPlanner();
+
+	struct RankedCandidate
+	{
+		UFlareSimulatedSector* Sector;
+		const ConstructionCandidate* Candidate;
+		float FullScore;
+	};
+
+	int32 MismatchCount = 0;
+	TArray<RankedCandidate> RankedCandidates;
+	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
+		SectorConstructionPlan* Plan = ConstructionPlans.Find(Sector);
+		if (!Plan)
+		{
+			continue;
+		}
+
+		// The candidate list must match a new one
+		SectorConstructionPlan FullPlan;
+		ResetSectorConstructionPlan(Sector, FullPlan);
+		bool SameCandidates = (FullPlan.Candidates.Num() == Plan->Candidates.Num());
+		for (int32 CandidateIndex = 0; SameCandidates && CandidateIndex < Plan->Candidates.Num(); CandidateIndex++)
+		{
+			const ConstructionCandidate& Candidate = Plan->Candidates[CandidateIndex];
+			const ConstructionCandidate& FullCandidate = FullPlan.Candidates[CandidateIndex];
+			SameCandidates = (Candidate.StationDescription == FullCandidate.StationDescription
+				&& Candidate.FactoryDescription == FullCandidate.FactoryDescription
+				&& Candidate.Station == FullCandidate.Station);
+		}
+
+		if (!SameCandidates)
+		{
+			FLOGV("UFlareCompanyAI::CheckConstructionCandidates : %s has %d candidates in %s, expected %d",
+				*Company->GetCompanyName().ToString(),
+				Plan->Candidates.Num(),
+				*Sector->GetSectorName().ToString(),
+				FullPlan.Candidates.Num());
+			MismatchCount++;
+		}
+
+		// The scores must match a full computation
+		for (int32 CandidateIndex = 0; CandidateIndex < Plan->Candidates.Num(); CandidateIndex++)
+		{
+			const ConstructionCandidate* Candidate = &Plan->Candidates[CandidateIndex];
+			float FullScore = ComputeConstructionScoreForStation(Sector, Candidate->StationDescription, Candidate->FactoryDescription, Candidate->Station);
+
+			if (Candidate->Score != FullScore)
+			{
+				FLOGV("UFlareCompanyAI::CheckConstructionCandidates : %s scores %s (%s) in %s %f, expected %f",
+					*Company->GetCompanyName().ToString(),
+					*Candidate->StationDescription->Name.ToString(),
+					*Candidate->FactoryDescription->Name.ToString(),
+					*Sector->GetSectorName().ToString(),
+					Candidate->Score,
+					FullScore);
+				MismatchCount++;
+			}
+
+			RankedCandidates.Add({Sector, Candidate, FullScore});
+		}
+	}
+
+	if (Verbose)
+	{
+		RankedCandidates.Sort([](const RankedCandidate& A, const RankedCandidate& B)
+		{
+			return A.Candidate->Score > B.Candidate->Score;
+		});
+
+		FLOGV("UFlareCompanyAI::CheckConstructionCandidates : %d candidates for %s", RankedCandidates.Num(), *Company->GetCompanyName().ToString());
+		for (int32 Rank = 0; Rank < RankedCandidates.Num(); Rank++)
+		{
+			const RankedCandidate& Entry = RankedCandidates[Rank];
+			const ConstructionCandidate* Candidate = Entry.Candidate;
+
+			FLOGV("  %d. %s (%s) in %s (upgrade: %d) planner=%f full=%f",
+				Rank + 1,
+				*Candidate->StationDescription->Name.ToString(),
+				*Candidate->FactoryDescription->Name.ToString(),
+				*Entry.Sector->GetSectorName().ToString(),
+				(Candidate->Station != NULL),
+				Candidate->Score,
+				Entry.FullScore);
+		}
+	}
+
+	return MismatchCount;
+}
+
 void UFlareCompanyAI::FindResourcesForStationConstruction()
 {
 
@@ -2141,6 +2324,63 @@ void UFlareCompanyAI::DumpSectorResourceVariation(UFlareSimulatedSector* Sector,
 	}
 }
 
+SectorDeal UFlareCompanyAI::FindBestDealForShip(UFlareSimulatedSpacecraft* Ship)
+{
+	SectorDeal BestDeal;
+	BestDeal.BuyQuantity = 0;
+	BestDeal.Score = 0;
+	BestDeal.Resource = NULL;
+	BestDeal.SectorA = NULL;
+	BestDeal.SectorB = NULL;
+	
+	// Stay here option
+	
+	for (int32 SectorAIndex = 0; SectorAIndex < Company->GetKnownSectors().Num(); SectorAIndex++)
+	{
+		UFlareSimulatedSector* SectorA = Company->GetKnownSectors()[SectorAIndex];
+
+		SectorDeal SectorBestDeal;
+		SectorBestDeal.Resource = NULL;
+		SectorBestDeal.BuyQuantity = 0;
+		SectorBestDeal.Score = 0;
+		SectorBestDeal.Resource = NULL;
+		SectorBestDeal.SectorA = NULL;
+		SectorBestDeal.SectorB = NULL;
+		
+		while (true)
+		{
+			SectorBestDeal = FindBestDealForShipFromSector(Ship, SectorA, &BestDeal);
+			if (!SectorBestDeal.Resource)
+			{
+				// No best deal found
+				break;
+			}
+
+			SectorVariation* SectorVariationA = &WorldResourceVariation[SectorA];
+			if (Ship->GetCurrentSector() != SectorA && SectorVariationA->IncomingCapacity > 0 && SectorBestDeal.BuyQuantity > 0)
+			{
+				//FLOGV("UFlareCompanyAI::UpdateTrading : IncomingCapacity to %s = %d", *SectorA->GetSectorName().ToString(), SectorVariationA->IncomingCapacity);
+				int32 UsedIncomingCapacity = FMath::Min(SectorBestDeal.BuyQuantity, SectorVariationA->IncomingCapacity);
+
+				SectorVariationA->IncomingCapacity -= UsedIncomingCapacity;
+				struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[SectorBestDeal.Resource];
+				VariationA->OwnedStock -= UsedIncomingCapacity;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		if (SectorBestDeal.Resource)
+		{
+			BestDeal = SectorBestDeal;
+		}
+	}
+
+	return BestDeal;
+}
+
 SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat)
 {
 	SectorDeal BestDeal;
@@ -44,6 +44,36 @@ struct SectorVariation
 	TMap<FFlareResourceDescription*, ResourceVariation> ResourceVariations;
 };
 
+/* Station construction or upgrade option */
+struct ConstructionCandidate
+{
+	FFlareSpacecraftDescription* StationDescription;
+	FFlareFactoryDescription* FactoryDescription;
+
+	/* Station to upgrade, NULL for a new station */
+	UFlareSimulatedSpacecraft* Station;
+	int32 StationLevel;
+
+	/* Catalog indexes of the resources the score depends on */
+	TArray<int32> Resources;
+
+	float Score;
+	bool Dirty;
+};
+
+/* Construction candidates of a sector, with what changed since their scores were computed */
+struct SectorConstructionPlan
+{
+	/* Set when a station of the sector is built or removed */
+	bool StationsDirty;
+	float SectorAffility;
+
+	/* Set per resource catalog index when the resource price moves */
+	TArray<bool> DirtyPrices;
+
+	TArray<ConstructionCandidate> Candidates;
+};
+
 
 UCLASS()
 class HELIUMRAIN_API UFlareCompanyAI : public UObject
@@ -97,6 +127,24 @@ public:
 	/** Buy war ships */
 	void UpdateWarShipAcquisition(bool limitToOne);
 
+	/** Score the construction candidates of a sector again for a resource whose price moved, or create them again if ResourceIndex is INDEX_NONE */
+	void InvalidateConstructionPlan(UFlareSimulatedSector* Sector, int32 ResourceIndex);
+
+	/** Refresh the construction planner, and count the candidates that differ from a full recomputation. Print them ranked if Verbose */
+	int32 CheckConstructionCandidates(bool Verbose);
+
+	/** Compute the world resource flows and sector variations the day's decisions are based on */
+	void UpdateWorldCaches();
+
+	/** Refresh the construction planner and find the best station to build or upgrade, false if none */
+	bool FindBestConstruction(UFlareSimulatedSector*& BestSector, FFlareSpacecraftDescription*& BestStationDescription, UFlareSimulatedSpacecraft*& BestStation, float& BestScore);
+
+	/** Find the best trade deal for a ship in the known sectors, reserving the incoming capacity of the sectors it considers */
+	SectorDeal FindBestDealForShip(UFlareSimulatedSpacecraft* Ship);
+
+	/** Get a list of idle cargos */
+	TArray<UFlareSimulatedSpacecraft*> FindIdleCargos() const;
+
 protected:
 
 	/*----------------------------------------------------
@@ -112,6 +160,15 @@ protected:
 	/** Buy cargos ships */
 	void UpdateCargoShipAcquisition();
 
+	/** Refresh the construction candidates whose inputs changed */
+	void UpdateConstructionPlanner();
+
+	/** Create the candidates of a sector after its station list changed */
+	void ResetSectorConstructionPlan(UFlareSimulatedSector* Sector, SectorConstructionPlan& Plan);
+
+	/** Add a candidate and the resources its score depends on */
+	void AddConstructionCandidate(SectorConstructionPlan& Plan, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription, UFlareSimulatedSpacecraft* Station);
+
 
 
 	/*----------------------------------------------------
@@ -130,9 +187,6 @@ protected:
 	/** Get a list of shipyard */
 	TArray<UFlareSimulatedSpacecraft*> FindShipyards();
 
-	/** Get a list of idle cargos */
-	TArray<UFlareSimulatedSpacecraft*> FindIdleCargos() const;
-
 	int32 GetDamagedCargosCapacity();
 
 	/** Get a list of idle military */
@@ -183,6 +237,10 @@ protected:
 	TMap<FFlareResourceDescription *, int32> MissingResourcesQuantity;
 	TMap<FFlareResourceDescription *, int32> MissingStaticResourcesQuantity;
 
+	// Construction planner
+	TMap<UFlareSimulatedSector*, SectorConstructionPlan> ConstructionPlans;
+	TArray<WorldHelper::FlareResourceStats>  ConstructionWorldStats;
+
 public:
 
 	/*----------------------------------------------------
@@ -194,5 +252,10 @@ public:
 		return Game;
 	}
 
+	UFlareAIBehavior* GetBehavior() const
+	{
+		return Behavior;
+	}
+
 };
 
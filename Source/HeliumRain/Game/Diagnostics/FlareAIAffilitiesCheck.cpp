@@ -0,0 +1,168 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../FlareCompany.h"
+#include "../AI/FlareAIBehavior.h"
+#include "../AI/FlareCompanyAI.h"
+#include "../../Player/FlarePlayerController.h"
+
+
+/** Zero the affility of the best construction sector, then double it, and count the construction decisions that don't follow */
+static int32 CheckConstructionAffilities(UFlareCompany* Company, int32& DecisionCount)
+{
+	UFlareCompanyAI* AI = Company->GetAI();
+	UFlareAIBehavior* Behavior = AI->GetBehavior();
+	FFlareAIPersonality Personality = Behavior->GetPersonality();
+
+	UFlareSimulatedSector* Sector;
+	FFlareSpacecraftDescription* StationDescription;
+	UFlareSimulatedSpacecraft* Station;
+	float Score;
+	if (!AI->FindBestConstruction(Sector, StationDescription, Station, Score))
+	{
+		return 0;
+	}
+
+	UFlareSimulatedSector* NewSector;
+	FFlareSpacecraftDescription* NewStationDescription;
+	UFlareSimulatedSpacecraft* NewStation;
+	float NewScore;
+	int32 ErrorCount = 0;
+	DecisionCount++;
+
+	// A sector the company doesn't want is never chosen
+	FFlareAIPersonality Modified = Personality;
+	float SectorAffility = FFlareAIPersonality::GetAffility(Personality.SectorAffilities, Sector->GetIdentifier());
+	FFlareAIPersonality::SetAffility(Modified.SectorAffilities, Sector->GetIdentifier(), 0);
+	Behavior->SetPersonality(Modified);
+	AI->FindBestConstruction(NewSector, NewStationDescription, NewStation, NewScore);
+	if (NewSector == Sector)
+	{
+		FLOGV("FlareDiagnostics::CheckAIAffilities : %s still builds %s in %s without affility",
+			*Company->GetShortName().ToString(), *NewStationDescription->Identifier.ToString(), *Sector->GetIdentifier().ToString());
+		ErrorCount++;
+	}
+
+	// Scores are proportional to the sector affility, doubling it keeps the choice
+	FFlareAIPersonality::SetAffility(Modified.SectorAffilities, Sector->GetIdentifier(), 2 * SectorAffility);
+	Behavior->SetPersonality(Modified);
+	AI->FindBestConstruction(NewSector, NewStationDescription, NewStation, NewScore);
+	if (NewSector != Sector || NewStationDescription != StationDescription || NewStation != Station || NewScore != 2 * Score)
+	{
+		FLOGV("FlareDiagnostics::CheckAIAffilities : %s builds %s in %s with score %f after doubling the affility of %s, expected %s with score %f",
+			*Company->GetShortName().ToString(),
+			NewStationDescription ? *NewStationDescription->Identifier.ToString() : TEXT("nothing"),
+			NewSector ? *NewSector->GetIdentifier().ToString() : TEXT("none"),
+			NewScore, *Sector->GetIdentifier().ToString(), *StationDescription->Identifier.ToString(), 2 * Score);
+		ErrorCount++;
+	}
+
+	Behavior->SetPersonality(Personality);
+	return ErrorCount;
+}
+
+/** Zero the affility of the best trade resource, then of its sectors, and count the trade decisions that don't follow */
+static int32 CheckTradeAffilities(UFlareCompany* Company, int32 ShipCount, int32& DecisionCount)
+{
+	UFlareCompanyAI* AI = Company->GetAI();
+	UFlareAIBehavior* Behavior = AI->GetBehavior();
+	FFlareAIPersonality Personality = Behavior->GetPersonality();
+	TArray<UFlareSimulatedSpacecraft*> IdleCargos = AI->FindIdleCargos();
+	int32 ErrorCount = 0;
+	int32 TestedShipCount = 0;
+
+	for (int32 ShipIndex = 0; ShipIndex < IdleCargos.Num() && TestedShipCount < ShipCount; ShipIndex++)
+	{
+		// Deal searches reserve sector capacity, start each one from the day's state
+		UFlareSimulatedSpacecraft* Ship = IdleCargos[ShipIndex];
+		AI->UpdateWorldCaches();
+		SectorDeal Deal = AI->FindBestDealForShip(Ship);
+		if (!Deal.Resource)
+		{
+			continue;
+		}
+
+		TestedShipCount++;
+		DecisionCount++;
+
+		// A resource the company doesn't want is never traded
+		FFlareAIPersonality Modified = Personality;
+		FFlareAIPersonality::SetAffility(Modified.ResourceAffilities, Deal.Resource->Identifier, 0);
+		Behavior->SetPersonality(Modified);
+		AI->UpdateWorldCaches();
+		SectorDeal NewDeal = AI->FindBestDealForShip(Ship);
+		if (NewDeal.Resource == Deal.Resource)
+		{
+			FLOGV("FlareDiagnostics::CheckAIAffilities : %s still trades %s without affility",
+				*Ship->GetImmatriculation().ToString(), *Deal.Resource->Identifier.ToString());
+			ErrorCount++;
+		}
+
+		// Nor between sectors it doesn't want
+		Modified = Personality;
+		FFlareAIPersonality::SetAffility(Modified.SectorAffilities, Deal.SectorA->GetIdentifier(), 0);
+		FFlareAIPersonality::SetAffility(Modified.SectorAffilities, Deal.SectorB->GetIdentifier(), 0);
+		Behavior->SetPersonality(Modified);
+		AI->UpdateWorldCaches();
+		NewDeal = AI->FindBestDealForShip(Ship);
+		if (NewDeal.Resource && NewDeal.SectorA == Deal.SectorA && NewDeal.SectorB == Deal.SectorB)
+		{
+			FLOGV("FlareDiagnostics::CheckAIAffilities : %s still trades from %s to %s without affility",
+				*Ship->GetImmatriculation().ToString(), *Deal.SectorA->GetIdentifier().ToString(), *Deal.SectorB->GetIdentifier().ToString());
+			ErrorCount++;
+		}
+
+		Behavior->SetPersonality(Personality);
+	}
+
+	return ErrorCount;
+}
+
+/** Change the affilities behind the construction and trade decisions of every AI company, check the decisions follow, and check the personality JSON round trip */
+static bool CheckAIAffilities(AFlareGame* Game, int32 ShipCount)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckAIAffilities failed: no loaded world");
+		return false;
+	}
+
+	int32 ConstructionDecisionCount = 0;
+	int32 TradeDecisionCount = 0;
+	int32 DecisionErrorCount = 0;
+	int32 RoundTripErrorCount = 0;
+
+	for (int32 CompanyIndex = 0; CompanyIndex < Game->GetGameWorld()->GetCompanies().Num(); CompanyIndex++)
+	{
+		UFlareCompany* Company = Game->GetGameWorld()->GetCompanies()[CompanyIndex];
+		UFlareAIBehavior* Behavior = Company->GetAI()->GetBehavior();
+
+		// Same state as a new day, without acting on it
+		Behavior->Load(Company);
+		if (Company != Game->GetPC()->GetCompany())
+		{
+			Company->GetAI()->UpdateWorldCaches();
+			DecisionErrorCount += CheckConstructionAffilities(Company, ConstructionDecisionCount);
+			DecisionErrorCount += CheckTradeAffilities(Company, ShipCount, TradeDecisionCount);
+		}
+
+		// Serialization round trip
+		FFlareAIPersonality Loaded;
+		if (!UFlareAIBehavior::LoadPersonality(Behavior->SavePersonality(), Loaded) || Behavior->GetPersonality().Diff(Loaded).Num() > 0)
+		{
+			FLOGV("FlareDiagnostics::CheckAIAffilities : %s personality round trip failed", *Company->GetShortName().ToString());
+			RoundTripErrorCount++;
+		}
+	}
+
+	// A check without decisions to test proves nothing
+	bool Success = (ConstructionDecisionCount > 0 && TradeDecisionCount > 0 && DecisionErrorCount == 0 && RoundTripErrorCount == 0);
+	FLOGV("FlareDiagnostics::CheckAIAffilities : %d companies, %d construction and %d trade decisions, %d decision errors, %d round trip errors : %s",
+		Game->GetGameWorld()->GetCompanies().Num(), ConstructionDecisionCount, TradeDecisionCount, DecisionErrorCount, RoundTripErrorCount,
+		Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(AIAffilities, CheckAIAffilities, 3, false)
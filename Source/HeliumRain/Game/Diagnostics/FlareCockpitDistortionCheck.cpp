@@ -0,0 +1,258 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Player/FlarePlayerController.h"
+
+
+/** Screen to cockpit conversion as the HUD did it before the tables, straight from the grid */
+static bool BaselineScreenToCockpit(const FFlareCockpitDistortionProfile& Profile, FVector2D ScreenSize, FVector2D CockpitSize, FVector2D Screen, FVector2D& Cockpit)
+{
+	float AspectRatio = CockpitSize.X / CockpitSize.Y;
+	float ExtraHeight = ScreenSize.Y - ScreenSize.X / AspectRatio;
+
+	float XRelativeLocation = (Screen.X / ScreenSize.X) * (Profile.Width - 1);
+	float YRelativeLocation = (Screen.Y - (ExtraHeight / 2)) / (ScreenSize.Y - ExtraHeight) * (Profile.Height - 1);
+	if (XRelativeLocation < 0.f || XRelativeLocation > (Profile.Width - 1) || YRelativeLocation < 0.f || YRelativeLocation > (Profile.Height - 1))
+	{
+		return false;
+	}
+
+	int32 LeftIndex = FMath::FloorToInt(XRelativeLocation);
+	int32 RightIndex = FMath::CeilToInt(XRelativeLocation);
+	int32 TopIndex = FMath::FloorToInt(YRelativeLocation);
+	int32 BottomIndex = FMath::CeilToInt(YRelativeLocation);
+	float LocalX = XRelativeLocation - LeftIndex;
+	float LocalY = YRelativeLocation - TopIndex;
+	int32 W = Profile.Width;
+
+	float TopMeanXDistorsion = LocalX * Profile.HorizontalGrid[RightIndex + TopIndex * W] + (1 - LocalX) * Profile.HorizontalGrid[LeftIndex + TopIndex * W];
+	float BottomMeanXDistorsion = LocalX * Profile.HorizontalGrid[RightIndex + BottomIndex * W] + (1 - LocalX) * Profile.HorizontalGrid[LeftIndex + BottomIndex * W];
+	float MeanXDistorsion = LocalY * BottomMeanXDistorsion + (1 - LocalY) * TopMeanXDistorsion;
+
+	float TopMeanYDistorsion = LocalX * Profile.VerticalGrid[RightIndex + TopIndex * W] + (1 - LocalX) * Profile.VerticalGrid[LeftIndex + TopIndex * W];
+	float BottomMeanYDistorsion = LocalX * Profile.VerticalGrid[RightIndex + BottomIndex * W] + (1 - LocalX) * Profile.VerticalGrid[LeftIndex + BottomIndex * W];
+	float MeanYDistorsion = LocalY * BottomMeanYDistorsion + (1 - LocalY) * TopMeanYDistorsion;
+
+	Cockpit = FVector2D(XRelativeLocation / (Profile.Width - 1) * MeanXDistorsion * CockpitSize.X,
+		YRelativeLocation / (Profile.Height - 1) * MeanYDistorsion * CockpitSize.Y);
+
+	return (Cockpit.X >= 0.f && Cockpit.X <= CockpitSize.X && Cockpit.Y >= 0.f && Cockpit.Y <= CockpitSize.Y);
+}
+
+/** Compare the baked cockpit distortion tables with the former grid interpolation, within analytic error bounds */
+static bool CheckCockpitDistortion(AFlareGame* Game, int32 Count)
+{
+	AFlareHUD* Hud = Cast<AFlareHUD>(Game->GetPC()->GetHUD());
+	if (!Hud)
+	{
+		FLOG("FlareDiagnostics::CheckCockpitDistortion failed: no HUD");
+		return false;
+	}
+
+	// Cockpit and screen with different aspect ratios
+	FVector2D ScreenSize(1920, 1080);
+	FVector2D CockpitSize(1024, 640);
+	float ExtraHeight = ScreenSize.Y - ScreenSize.X / (CockpitSize.X / CockpitSize.Y);
+	float FloatSlack = 0.01f;
+	int32 SampleCount = 256;
+	TArray<const FFlareCockpitDistortionProfile*> Profiles = Hud->GetCockpitDistortionProfiles();
+	bool Success = true;
+
+	for (int32 ProfileIndex = 0; ProfileIndex < Profiles.Num(); ProfileIndex++)
+	{
+		const FFlareCockpitDistortionProfile* Profile = Profiles[ProfileIndex];
+		FFlareCockpitDistortion Distortion;
+		Distortion.Bake(*Profile);
+		Distortion.SetResolution(ScreenSize, CockpitSize);
+		if (!Distortion.IsBaked())
+		{
+			FLOGV("FlareDiagnostics::CheckCockpitDistortion failed: '%s' not baked", *Profile->Identifier.ToString());
+			Success = false;
+			continue;
+		}
+
+		// Grid factors and slopes, per grid cell
+		int32 W = Profile->Width;
+		int32 H = Profile->Height;
+		float MaxH = 0, MaxV = 0;
+		float MaxHSlopeX = 0, MaxHSlopeY = 0, MaxVSlopeX = 0, MaxVSlopeY = 0;
+		for (int32 Y = 0; Y < H; Y++)
+		{
+			for (int32 X = 0; X < W; X++)
+			{
+				int32 Index = X + Y * W;
+				MaxH = FMath::Max(MaxH, FMath::Abs(Profile->HorizontalGrid[Index]));
+				MaxV = FMath::Max(MaxV, FMath::Abs(Profile->VerticalGrid[Index]));
+				if (X + 1 < W)
+				{
+					MaxHSlopeX = FMath::Max(MaxHSlopeX, FMath::Abs(Profile->HorizontalGrid[Index + 1] - Profile->HorizontalGrid[Index]) * (W - 1));
+					MaxVSlopeX = FMath::Max(MaxVSlopeX, FMath::Abs(Profile->VerticalGrid[Index + 1] - Profile->VerticalGrid[Index]) * (W - 1));
+				}
+				if (Y + 1 < H)
+				{
+					MaxHSlopeY = FMath::Max(MaxHSlopeY, FMath::Abs(Profile->HorizontalGrid[Index + W] - Profile->HorizontalGrid[Index]) * (H - 1));
+					MaxVSlopeY = FMath::Max(MaxVSlopeY, FMath::Abs(Profile->VerticalGrid[Index + W] - Profile->VerticalGrid[Index]) * (H - 1));
+				}
+			}
+		}
+
+		// Each cockpit axis is the screen axis times a bilinear factor, so it is quadratic along that axis and linear along the other :
+		// the bilinear table error is bounded by the second derivative, twice the factor slope, times the squared table step over 8
+		float StepX = 1.f / (Distortion.GetTableWidth() - 1);
+		float StepY = 1.f / (Distortion.GetTableHeight() - 1);
+		float ForwardTolerance = CockpitSize.X * MaxHSlopeX * StepX * StepX / 4 + CockpitSize.Y * MaxVSlopeY * StepY * StepY / 4 + FloatSlack;
+
+		int32 ValidCount = 0;
+		int32 BorderMismatchCount = 0;
+		int32 MismatchCount = 0;
+		int32 ForwardFailureCount = 0;
+		float MaxForwardError = 0;
+
+		for (int32 Y = 0; Y < SampleCount; Y++)
+		{
+			for (int32 X = 0; X < SampleCount; X++)
+			{
+				FVector2D Screen = FVector2D((X + 0.5f) / SampleCount, (Y + 0.5f) / SampleCount) * ScreenSize;
+				FVector2D Reference;
+				FVector2D Baked;
+				bool ReferenceValid = BaselineScreenToCockpit(*Profile, ScreenSize, CockpitSize, Screen, Reference);
+				bool BakedValid = Distortion.ScreenToCockpit(Screen, Baked);
+
+				// Acceptance can only differ within the error of the cockpit border
+				if (ReferenceValid != BakedValid)
+				{
+					float BorderDistance = FMath::Min(
+						FMath::Min(FMath::Abs(Reference.X), FMath::Abs(CockpitSize.X - Reference.X)),
+						FMath::Min(FMath::Abs(Reference.Y), FMath::Abs(CockpitSize.Y - Reference.Y)));
+					if (BorderDistance <= ForwardTolerance)
+					{
+						BorderMismatchCount++;
+					}
+					else
+					{
+						MismatchCount++;
+					}
+					continue;
+				}
+				else if (!ReferenceValid)
+				{
+					continue;
+				}
+
+				float Error = (Reference - Baked).Size();
+				MaxForwardError = FMath::Max(MaxForwardError, Error);
+				ForwardFailureCount += (Error > ForwardTolerance) ? 1 : 0;
+				ValidCount++;
+			}
+		}
+
+		// Bound of the baseline Jacobian, in cockpit pixels per screen pixel
+		float JacobianXX = CockpitSize.X / ScreenSize.X * (MaxH + MaxHSlopeX);
+		float JacobianXY = CockpitSize.X / (ScreenSize.Y - ExtraHeight) * MaxHSlopeY;
+		float JacobianYX = CockpitSize.Y / ScreenSize.X * MaxVSlopeX;
+		float JacobianYY = CockpitSize.Y / (ScreenSize.Y - ExtraHeight) * (MaxV + MaxVSlopeY);
+		float Lipschitz = FMath::Sqrt(JacobianXX * JacobianXX + JacobianXY * JacobianXY + JacobianYX * JacobianYX + JacobianYY * JacobianYY);
+
+		// Solver tolerance of the inverse nodes, normalized per axis
+		float NodeTolerance = FFlareCockpitDistortion::GetInverseTolerance() * CockpitSize.Size() + FloatSlack;
+
+		// Inverse nodes go back to their cockpit position through the baseline
+		int32 TableWidth = Distortion.GetTableWidth();
+		int32 TableHeight = Distortion.GetTableHeight();
+		int32 NodeCount = 0;
+		int32 NodeFailureCount = 0;
+		int32 RejectedCount = 0;
+		float MaxNodeError = 0;
+		TArray<FVector2D> NodeScreens;
+		TArray<bool> NodeValid;
+		NodeScreens.SetNumZeroed(TableWidth * TableHeight);
+		NodeValid.SetNumZeroed(TableWidth * TableHeight);
+
+		for (int32 Y = 0; Y < TableHeight; Y++)
+		{
+			for (int32 X = 0; X < TableWidth; X++)
+			{
+				int32 Index = X + Y * TableWidth;
+				FVector2D Cockpit = FVector2D(X / (float) (TableWidth - 1), Y / (float) (TableHeight - 1)) * CockpitSize;
+				FVector2D Reference;
+				if (!Distortion.CockpitToScreen(Cockpit, NodeScreens[Index]))
+				{
+					RejectedCount++;
+					continue;
+				}
+
+				NodeValid[Index] = true;
+				NodeCount++;
+				BaselineScreenToCockpit(*Profile, ScreenSize, CockpitSize, NodeScreens[Index], Reference);
+				float Error = (Reference - Cockpit).Size();
+				MaxNodeError = FMath::Max(MaxNodeError, Error);
+				NodeFailureCount += (Error > NodeTolerance) ? 1 : 0;
+			}
+		}
+
+		// Between the nodes, the screen position is a blend of the node images : the residual is bounded by the Jacobian over the span of these images
+		int32 InverseCount = 0;
+		int32 InverseFailureCount = 0;
+		int32 UnboundedCount = 0;
+		float MaxInverseError = 0;
+
+		for (int32 Y = 0; Y < SampleCount; Y++)
+		{
+			for (int32 X = 0; X < SampleCount; X++)
+			{
+				FVector2D Normalized((X + 0.5f) / SampleCount, (Y + 0.5f) / SampleCount);
+				FVector2D Cockpit = Normalized * CockpitSize;
+				FVector2D Screen;
+				FVector2D Reference;
+				if (!Distortion.CockpitToScreen(Cockpit, Screen))
+				{
+					RejectedCount++;
+					continue;
+				}
+
+				int32 LeftIndex = FMath::Min(FMath::FloorToInt(Normalized.X * (TableWidth - 1)), TableWidth - 2);
+				int32 TopIndex = FMath::Min(FMath::FloorToInt(Normalized.Y * (TableHeight - 1)), TableHeight - 2);
+				int32 Corners[4] = { LeftIndex + TopIndex * TableWidth, LeftIndex + 1 + TopIndex * TableWidth,
+					LeftIndex + (TopIndex + 1) * TableWidth, LeftIndex + 1 + (TopIndex + 1) * TableWidth };
+
+				// A node next to a folded row cannot be read back on its own
+				if (!NodeValid[Corners[0]] || !NodeValid[Corners[1]] || !NodeValid[Corners[2]] || !NodeValid[Corners[3]])
+				{
+					UnboundedCount++;
+					continue;
+				}
+
+				float Span = 0;
+				for (int32 First = 0; First < 4; First++)
+				{
+					for (int32 Second = First + 1; Second < 4; Second++)
+					{
+						Span = FMath::Max(Span, (NodeScreens[Corners[First]] - NodeScreens[Corners[Second]]).Size());
+					}
+				}
+
+				InverseCount++;
+				BaselineScreenToCockpit(*Profile, ScreenSize, CockpitSize, Screen, Reference);
+				float Error = (Reference - Cockpit).Size();
+				MaxInverseError = FMath::Max(MaxInverseError, Error);
+				InverseFailureCount += (Error > Lipschitz * Span + NodeTolerance) ? 1 : 0;
+			}
+		}
+
+		bool ProfileSuccess = (MismatchCount == 0 && ForwardFailureCount == 0 && NodeFailureCount == 0 && InverseFailureCount == 0);
+		Success &= ProfileSuccess;
+
+		FLOGV("FlareDiagnostics::CheckCockpitDistortion : '%s' %d samples, max error %f px for %f px, %d failures, %d border mismatches, %d other mismatches",
+			*Profile->Identifier.ToString(), ValidCount, MaxForwardError, ForwardTolerance, ForwardFailureCount, BorderMismatchCount, MismatchCount);
+		FLOGV("FlareDiagnostics::CheckCockpitDistortion : '%s' %d inverse nodes, max error %f px for %f px, %d failures",
+			*Profile->Identifier.ToString(), NodeCount, MaxNodeError, NodeTolerance, NodeFailureCount);
+		FLOGV("FlareDiagnostics::CheckCockpitDistortion : '%s' %d inverse samples, max error %f px, %d over the Jacobian bound %f, %d rejected and %d unbounded near folded rows : %s",
+			*Profile->Identifier.ToString(), InverseCount, MaxInverseError, Lipschitz, InverseFailureCount, RejectedCount, UnboundedCount, ProfileSuccess ? TEXT("passed") : TEXT("FAILED"));
+	}
+
+	FLOGV("FlareDiagnostics::CheckCockpitDistortion : %s", Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(CockpitDistortion, CheckCockpitDistortion, 0, true)
@@ -0,0 +1,96 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../FlareCompany.h"
+
+
+static int32 CheckCompanyValues(UFlareWorld* World, double& LedgerDuration, double& ComputeDuration)
+{
+	int32 MismatchCount = 0;
+
+	for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num(); CompanyIndex++)
+	{
+		UFlareCompany* Company = World->GetCompanies()[CompanyIndex];
+
+		double StartTime = FPlatformTime::Seconds();
+		struct CompanyValue LedgerValue = Company->GetCompanyValue();
+		double LedgerTime = FPlatformTime::Seconds();
+		struct CompanyValue ComputedValue = Company->ComputeCompanyValue();
+		double ComputeTime = FPlatformTime::Seconds();
+
+		LedgerDuration += LedgerTime - StartTime;
+		ComputeDuration += ComputeTime - LedgerTime;
+
+		if (LedgerValue.TotalValue != ComputedValue.TotalValue
+		 || LedgerValue.StockValue != ComputedValue.StockValue
+		 || LedgerValue.ShipsValue != ComputedValue.ShipsValue
+		 || LedgerValue.StationsValue != ComputedValue.StationsValue
+		 || LedgerValue.ArmyValue != ComputedValue.ArmyValue)
+		{
+			FLOGV("FlareDiagnostics::CheckCompanyValueLedger : %s ledger %lld (stock %lld, ships %lld, stations %lld, army %lld), computed %lld (stock %lld, ships %lld, stations %lld, army %lld)",
+				*Company->GetCompanyName().ToString(),
+				LedgerValue.TotalValue, LedgerValue.StockValue, LedgerValue.ShipsValue, LedgerValue.StationsValue, LedgerValue.ArmyValue,
+				ComputedValue.TotalValue, ComputedValue.StockValue, ComputedValue.ShipsValue, ComputedValue.StationsValue, ComputedValue.ArmyValue);
+			MismatchCount++;
+		}
+	}
+
+	return MismatchCount;
+}
+
+/** Simulate days on a copy of the game, and compare the company value ledgers and history with a full recompute after each of them */
+static bool CheckCompanyValueLedger(AFlareGame* Game, int32 DayCount)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckCompanyValueLedger failed: no loaded world");
+		return false;
+	}
+
+	bool SectorActive;
+	int32 PlayerSlot = FlareDiagnostics::LoadGameCopy(Game, TEXT("CheckCompanyValueLedger"), SectorActive);
+	if (PlayerSlot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	UFlareWorld* World = Game->GetGameWorld();
+	double LedgerDuration = 0;
+	double ComputeDuration = 0;
+	int32 MismatchCount = CheckCompanyValues(World, LedgerDuration, ComputeDuration);
+
+	// Each day changes prices, cargos, factories, sectors and owners
+	int32 HistoryMismatchCount = 0;
+	for (int32 Day = 0; Day < DayCount; Day++)
+	{
+		World->Simulate();
+		MismatchCount += CheckCompanyValues(World, LedgerDuration, ComputeDuration);
+
+		// Today's value is the last of the history, to the cent
+		for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num(); CompanyIndex++)
+		{
+			UFlareCompany* Company = World->GetCompanies()[CompanyIndex];
+			int64 HistoryValue = Company->GetCompanyValueHistory(0);
+			int64 Value = Company->ComputeCompanyValue().TotalValue;
+			if (HistoryValue != Value)
+			{
+				FLOGV("FlareDiagnostics::CheckCompanyValueLedger : %s recorded %lld, expected %lld",
+					*Company->GetCompanyName().ToString(), HistoryValue, Value);
+				HistoryMismatchCount++;
+			}
+		}
+	}
+
+	FLOGV("FlareDiagnostics::CheckCompanyValueLedger : %d days, %d companies, ledger %f ms, full recompute %f ms",
+		DayCount, World->GetCompanies().Num(), LedgerDuration * 1000, ComputeDuration * 1000);
+
+	bool Success = MismatchCount == 0 && HistoryMismatchCount == 0;
+	FLOGV("FlareDiagnostics::CheckCompanyValueLedger : %d value mismatches, %d history mismatches : %s",
+		MismatchCount, HistoryMismatchCount, Success ? TEXT("passed") : TEXT("FAILED"));
+
+	FlareDiagnostics::RestoreGameCopy(Game, PlayerSlot, SectorActive);
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(CompanyValueLedger, CheckCompanyValueLedger, 30, false)
@@ -0,0 +1,169 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Player/FlarePlayerController.h"
+#include "../../Spacecrafts/Subsystems/FlareSpacecraftDamageSystem.h"
+
+
+/** Check a sphere tree against all its spheres, and return the number of wrong queries */
+static int32 CheckSphereTreeQueries(const FFlareSphereTree& Tree, FRandomStream& Random, int32 QueryCount, float LayoutSize)
+{
+	int32 ErrorCount = 0;
+
+	for (int32 QueryIndex = 0; QueryIndex < QueryCount; QueryIndex++)
+	{
+		FVector Center = Random.GetUnitVector() * Random.FRandRange(0, LayoutSize);
+		float Radius = Random.FRandRange(0, LayoutSize / 4);
+
+		TArray<int32> Items;
+		Tree.Overlap(Center, Radius, Items);
+		Items.Sort();
+
+		TArray<int32> ReferenceItems;
+		for (int32 Item = 0; Item < Tree.Num(); Item++)
+		{
+			if (FFlareSphereTree::IntersectSpheres(Center, Radius, Tree.GetCenter(Item), Tree.GetRadius(Item)))
+			{
+				ReferenceItems.Add(Item);
+			}
+		}
+
+		if (Items != ReferenceItems)
+		{
+			ErrorCount++;
+		}
+	}
+
+	return ErrorCount;
+}
+
+/** Compare the component sphere tree with a brute force overlap on random layouts, and the damaged components of the active sector spacecrafts */
+static bool CheckComponentTree(AFlareGame* Game, int32 LayoutCount)
+{
+	FRandomStream Random(42);
+	int32 QueryCount = 0;
+	int32 ErrorCount = 0;
+
+	// Synthetic layouts, from small ships to large stations, with nested and identical spheres
+	for (int32 LayoutIndex = 0; LayoutIndex < LayoutCount; LayoutIndex++)
+	{
+		int32 SphereCount = Random.RandRange(1, 500);
+		float LayoutSize = Random.FRandRange(500, 50000);
+
+		TArray<FVector> Centers;
+		TArray<float> Radii;
+		for (int32 Item = 0; Item < SphereCount; Item++)
+		{
+			if (Item > 0 && Random.FRand() < 0.1f)
+			{
+				int32 Copy = Random.RandRange(0, Item - 1);
+				Centers.Add(Centers[Copy]);
+				Radii.Add(Radii[Copy] * Random.FRandRange(0, 1));
+			}
+			else
+			{
+				Centers.Add(Random.GetUnitVector() * Random.FRandRange(0, LayoutSize));
+				Radii.Add(Random.FRand() < 0.1f ? 0 : Random.FRandRange(0, LayoutSize / 10));
+			}
+		}
+
+		FFlareSphereTree Tree;
+		Tree.Build(Centers, Radii);
+		ErrorCount += CheckSphereTreeQueries(Tree, Random, 100, LayoutSize);
+
+		// Move some spheres, then refit
+		for (int32 Item = 0; Item < SphereCount; Item++)
+		{
+			if (Random.FRand() < 0.2f)
+			{
+				Tree.SetSphere(Item, Centers[Item] + Random.GetUnitVector() * Random.FRandRange(0, LayoutSize / 10), Random.FRandRange(0, LayoutSize / 5));
+			}
+		}
+		Tree.Refit();
+		ErrorCount += CheckSphereTreeQueries(Tree, Random, 100, LayoutSize);
+
+		QueryCount += 200;
+	}
+
+	// Active sector spacecrafts, against the same falloff on all components
+	int32 DamageCount = 0;
+	int32 DamageErrorCount = 0;
+	if (Game->GetActiveSector())
+	{
+		for (int32 SpacecraftIndex = 0; SpacecraftIndex < Game->GetActiveSector()->GetSpacecrafts().Num(); SpacecraftIndex++)
+		{
+			AFlareSpacecraft* Spacecraft = Game->GetActiveSector()->GetSpacecrafts()[SpacecraftIndex];
+			TArray<UActorComponent*> Components = Spacecraft->GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
+			float SpacecraftSize = Spacecraft->GetMeshScale();
+			UFlareSpacecraftComponent* StationCockpit = (Spacecraft->IsStation() ? Spacecraft->GetCockpit() : NULL);
+
+			for (int32 DamageIndex = 0; DamageIndex < 100; DamageIndex++)
+			{
+				FVector Location = Spacecraft->GetActorLocation() + Random.GetUnitVector() * Random.FRandRange(0, SpacecraftSize);
+				float Radius = Random.FRandRange(0.1f, SpacecraftSize / 200);
+
+				TArray<FFlareComponentHit> Hits;
+				Spacecraft->GetDamageSystem()->GetDamagedComponents(Radius, Location, Hits);
+
+				TArray<FFlareComponentHit> ReferenceHits;
+				for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+				{
+					UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
+
+					float ComponentSize;
+					FVector ComponentLocation;
+					Component->GetBoundingSphere(ComponentLocation, ComponentSize);
+					float IntersectDistance = Radius + ComponentSize / 100 - (ComponentLocation - Location).Size() / 100.0f;
+
+					if (IntersectDistance > 0 || Component == StationCockpit)
+					{
+						FFlareComponentHit Hit;
+						Hit.Component = Component;
+						Hit.Efficiency = (Component == StationCockpit) ? 1 : FMath::Clamp(IntersectDistance / Radius, 0.0f, 1.0f);
+						ReferenceHits.Add(Hit);
+					}
+				}
+
+				// Spacecraft space rounding can only flip components at the very edge of the sphere
+				bool Match = true;
+				for (int32 HitIndex = 0, ReferenceIndex = 0; Match && (HitIndex < Hits.Num() || ReferenceIndex < ReferenceHits.Num());)
+				{
+					if (HitIndex < Hits.Num() && ReferenceIndex < ReferenceHits.Num() && Hits[HitIndex].Component == ReferenceHits[ReferenceIndex].Component)
+					{
+						Match = FMath::IsNearlyEqual(Hits[HitIndex].Efficiency, ReferenceHits[ReferenceIndex].Efficiency, 1e-3f);
+						HitIndex++;
+						ReferenceIndex++;
+					}
+					else if (HitIndex < Hits.Num() && Hits[HitIndex].Efficiency < 1e-3f)
+					{
+						HitIndex++;
+					}
+					else if (ReferenceIndex < ReferenceHits.Num() && ReferenceHits[ReferenceIndex].Efficiency < 1e-3f)
+					{
+						ReferenceIndex++;
+					}
+					else
+					{
+						Match = false;
+					}
+				}
+
+				if (!Match)
+				{
+					FLOGV("FlareDiagnostics::CheckComponentTree : %s : %d hits, %d expected",
+						*Spacecraft->GetImmatriculation().ToString(), Hits.Num(), ReferenceHits.Num());
+					DamageErrorCount++;
+				}
+				DamageCount++;
+			}
+		}
+	}
+
+	FLOGV("FlareDiagnostics::CheckComponentTree : %d layouts, %d queries, %d errors, %d damages, %d damage errors : %s",
+		LayoutCount, QueryCount, ErrorCount, DamageCount, DamageErrorCount,
+		(ErrorCount == 0 && DamageErrorCount == 0) ? TEXT("passed") : TEXT("FAILED"));
+
+	return (ErrorCount == 0 && DamageErrorCount == 0);
+}
+
+FLARE_DIAGNOSTICS_CHECK(ComponentTree, CheckComponentTree, 100, false)
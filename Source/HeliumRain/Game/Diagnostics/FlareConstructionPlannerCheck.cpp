@@ -0,0 +1,59 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../FlareCompany.h"
+#include "../AI/FlareCompanyAI.h"
+
+
+/** Count the construction candidates of all company AIs that differ from a full recomputation */
+static int32 CheckConstructionCandidates(UFlareWorld* World)
+{
+	int32 MismatchCount = 0;
+
+	for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num(); CompanyIndex++)
+	{
+		UFlareCompanyAI* CompanyAI = World->GetCompanies()[CompanyIndex]->GetAI();
+		if (CompanyAI)
+		{
+			MismatchCount += CompanyAI->CheckConstructionCandidates(false);
+		}
+	}
+
+	return MismatchCount;
+}
+
+/** Simulate days on a copy of the game, and compare the AI construction candidates and their scores with a full recompute after each of them */
+static bool CheckConstructionPlanner(AFlareGame* Game, int32 DayCount)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckConstructionPlanner failed: no loaded world");
+		return false;
+	}
+
+	bool SectorActive;
+	int32 PlayerSlot = FlareDiagnostics::LoadGameCopy(Game, TEXT("CheckConstructionPlanner"), SectorActive);
+	if (PlayerSlot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Each day moves prices, builds and upgrades stations, and destroys some
+	UFlareWorld* World = Game->GetGameWorld();
+	int32 MismatchCount = CheckConstructionCandidates(World);
+	for (int32 Day = 0; Day < DayCount; Day++)
+	{
+		World->Simulate();
+		MismatchCount += CheckConstructionCandidates(World);
+	}
+
+	bool Success = (MismatchCount == 0);
+	FLOGV("FlareDiagnostics::CheckConstructionPlanner : %d days, %d companies, %d mismatches : %s",
+		DayCount, World->GetCompanies().Num(), MismatchCount, Success ? TEXT("passed") : TEXT("FAILED"));
+
+	FlareDiagnostics::RestoreGameCopy(Game, PlayerSlot, SectorActive);
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(ConstructionPlanner, CheckConstructionPlanner, 30, false)
@@ -0,0 +1,43 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareDebrisField.h"
+
+
+/** Activate the current sector twice and compare the debris placements */
+static bool CheckDebrisFieldDeterminism(AFlareGame* Game, int32 Count)
+{
+	if (!Game->GetActiveSector())
+	{
+		FLOG("FlareDiagnostics::CheckDebrisFieldDeterminism failed: no active sector");
+		return false;
+	}
+
+	// The current field may have moved, start from fresh activations
+	TArray<FFlareDebrisInstance> FirstDebris;
+	Game->DeactivateSector();
+	Game->ActivateCurrentSector(false);
+	FirstDebris = Game->GetDebrisField()->GetDebris();
+
+	Game->DeactivateSector();
+	Game->ActivateCurrentSector(false);
+	const TArray<FFlareDebrisInstance>& SecondDebris = Game->GetDebrisField()->GetDebris();
+
+	int32 MismatchCount = 0;
+	for (int32 Index = 0; Index < FMath::Min(FirstDebris.Num(), SecondDebris.Num()); Index++)
+	{
+		if (FirstDebris[Index].MeshIndex != SecondDebris[Index].MeshIndex
+		 || !FirstDebris[Index].Transform.Equals(SecondDebris[Index].Transform))
+		{
+			MismatchCount++;
+		}
+	}
+
+	bool Success = (FirstDebris.Num() == SecondDebris.Num() && MismatchCount == 0);
+	FLOGV("FlareDiagnostics::CheckDebrisFieldDeterminism : %d then %d debris, %d mismatches : %s",
+		FirstDebris.Num(), SecondDebris.Num(), MismatchCount, Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(DebrisFieldDeterminism, CheckDebrisFieldDeterminism, 0, true)
@@ -0,0 +1,114 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Player/FlarePlayerController.h"
+
+
+/*----------------------------------------------------
+	Registry
+----------------------------------------------------*/
+
+/** Checks by name, filled by the registrars of the check files */
+static TArray<FlareDiagnostics::CheckDescription>& GetRegistry()
+{
+	static TArray<FlareDiagnostics::CheckDescription> Checks;
+	return Checks;
+}
+
+FlareDiagnostics::Registrar::Registrar(const TCHAR* Name, CheckFunction Function, int32 DefaultCount, bool NeedsActiveSector)
+{
+	TArray<CheckDescription>& Checks = GetRegistry();
+	Checks.Add({ Name, Function, DefaultCount, NeedsActiveSector });
+
+	// Registrars run in link order, keep the run order stable
+	Checks.Sort([](const CheckDescription& A, const CheckDescription& B)
+	{
+		return FCString::Strcmp(A.Name, B.Name) < 0;
+	});
+}
+
+const TArray<FlareDiagnostics::CheckDescription>& FlareDiagnostics::GetChecks()
+{
+	return GetRegistry();
+}
+
+bool FlareDiagnostics::Run(AFlareGame* Game, const FString& CheckName, int32 Count, bool Headless)
+{
+	const TArray<CheckDescription>& Checks = GetChecks();
+	bool RunAll = (CheckName == TEXT("All"));
+	int32 RunCount = 0;
+	int32 FailureCount = 0;
+
+	for (int32 CheckIndex = 0; CheckIndex < Checks.Num(); CheckIndex++)
+	{
+		const CheckDescription& Check = Checks[CheckIndex];
+		if (!RunAll && CheckName != Check.Name)
+		{
+			continue;
+		}
+
+		if (Headless && Check.NeedsActiveSector)
+		{
+			FLOGV("FlareDiagnostics::Run : skipping %s, it needs an active sector", Check.Name);
+			FailureCount += RunAll ? 0 : 1;
+			continue;
+		}
+
+		FLOGV("FlareDiagnostics::Run : %s", Check.Name);
+		bool Success = Check.Function(Game, (Count > 0) ? Count : Check.DefaultCount);
+		FailureCount += Success ? 0 : 1;
+		RunCount++;
+	}
+
+	if (RunCount == 0 && FailureCount == 0)
+	{
+		FLOGV("FlareDiagnostics::Run failed: no check named '%s'", *CheckName);
+		return false;
+	}
+
+	FLOGV("FlareDiagnostics::Run : %d checks, %d failures : %s",
+		RunCount, FailureCount, FailureCount == 0 ? TEXT("passed") : TEXT("FAILED"));
+	return (FailureCount == 0);
+}
+
+
+/*----------------------------------------------------
+	Game copy
+----------------------------------------------------*/
+
+int32 FlareDiagnostics::LoadGameCopy(AFlareGame* Game, const TCHAR* CheckName, bool& SectorActive)
+{
+	AFlarePlayerController* PC = Game->GetPC();
+	int32 PlayerSlot = Game->GetCurrentSaveSlot();
+	SectorActive = (Game->GetActiveSector() != NULL);
+
+	Game->SetCurrentSlot(DIAGNOSTICS_COPY_SLOT);
+	if (!Game->SaveGame(PC, false))
+	{
+		FLOGV("FlareDiagnostics::%s failed: cannot save a copy of the game", CheckName);
+		Game->SetCurrentSlot(PlayerSlot);
+		return INDEX_NONE;
+	}
+
+	Game->UnloadGame();
+	Game->LoadGame(PC);
+	return PlayerSlot;
+}
+
+void FlareDiagnostics::RestoreGameCopy(AFlareGame* Game, int32 PlayerSlot, bool SectorActive)
+{
+	AFlarePlayerController* PC = Game->GetPC();
+
+	Game->SetCurrentSlot(DIAGNOSTICS_COPY_SLOT);
+	Game->UnloadGame();
+	Game->LoadGame(PC);
+
+	if (SectorActive && PC->GetPlayerShip())
+	{
+		Game->ActivateCurrentSector();
+		PC->FlyShip(PC->GetPlayerShip()->GetActive());
+	}
+
+	Game->DeleteSaveSlot(DIAGNOSTICS_COPY_SLOT);
+	Game->SetCurrentSlot(PlayerSlot);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../../Flare.h"
+
+
+class AFlareGame;
+
+
+/** Save slot of the game copies, beyond the slots the main menu shows */
+#define DIAGNOSTICS_COPY_SLOT 99
+
+/** Save slot of the games saved by the checks themselves */
+#define DIAGNOSTICS_SCRATCH_SLOT 98
+
+/** Add a check function to the registry, from the file that defines it */
+#define FLARE_DIAGNOSTICS_CHECK(Name, Function, DefaultCount, NeedsActiveSector) \
+	static FlareDiagnostics::Registrar FlareDiagnosticsRegistrar##Name(TEXT(#Name), &Function, DefaultCount, NeedsActiveSector);
+
+
+/** Automated checks of the game systems against their reference computations.
+ *  Each check lives in its own file of this folder and registers itself with FLARE_DIAGNOSTICS_CHECK.
+ *  Run them headless with the FlareDiagnostics commandlet, or on a running game with the RunDiagnostics console command.
+ */
+struct FlareDiagnostics
+{
+	/** Check entry point : Count is the size of the check when it has one, and it returns whether it passed */
+	typedef bool (*CheckFunction)(AFlareGame* Game, int32 Count);
+
+	/** Check of the registry */
+	struct CheckDescription
+	{
+		const TCHAR* Name;
+		CheckFunction Function;
+
+		/** Size used when none is given */
+		int32 DefaultCount;
+
+		/** The check needs a sector with its actors, so it can't run in the commandlet */
+		bool NeedsActiveSector;
+	};
+
+	/** Adds a check to the registry when the module is loaded */
+	struct Registrar
+	{
+		Registrar(const TCHAR* Name, CheckFunction Function, int32 DefaultCount, bool NeedsActiveSector);
+	};
+
+
+	/*----------------------------------------------------
+		Registry
+	----------------------------------------------------*/
+
+	/** Get all checks, by name */
+	static const TArray<CheckDescription>& GetChecks();
+
+	/** Run a check by name, or all of them with "All". Headless runs skip the checks that need an active sector */
+	static bool Run(AFlareGame* Game, const FString& CheckName, int32 Count, bool Headless);
+
+
+	/*----------------------------------------------------
+		Game copy
+	----------------------------------------------------*/
+
+	/** Save the current game to the copy slot and load the copy, without an active sector. Returns the player slot, or INDEX_NONE */
+	static int32 LoadGameCopy(AFlareGame* Game, const TCHAR* CheckName, bool& SectorActive);
+
+	/** Reload the game as it was before LoadGameCopy, fly the player ship again if a sector was active, and give the player slot back */
+	static void RestoreGameCopy(AFlareGame* Game, int32 PlayerSlot, bool SectorActive);
+
+};
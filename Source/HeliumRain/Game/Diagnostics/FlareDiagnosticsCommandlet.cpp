@@ -0,0 +1,71 @@
+
+#include "../../Flare.h"
+#include "FlareDiagnosticsCommandlet.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Player/FlarePlayerController.h"
+
+#define LOCTEXT_NAMESPACE "FlareDiagnosticsCommandlet"
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+UFlareDiagnosticsCommandlet::UFlareDiagnosticsCommandlet(const class FObjectInitializer& PCIP)
+	: Super(PCIP)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+
+/*----------------------------------------------------
+	Commandlet
+----------------------------------------------------*/
+
+int32 UFlareDiagnosticsCommandlet::Main(const FString& Params)
+{
+	FString CheckName = TEXT("All");
+	int32 Slot = 0;
+	int32 Count = 0;
+
+	FParse::Value(*Params, TEXT("Check="), CheckName);
+	FParse::Value(*Params, TEXT("Slot="), Slot);
+	FParse::Value(*Params, TEXT("Count="), Count);
+
+	// Game world with the game mode and a player controller, as the checks expect them
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	AFlareGame* Game = World->SpawnActor<AFlareGame>();
+	World->AuthorityGameMode = Game;
+	AFlarePlayerController* PC = World->SpawnActor<AFlarePlayerController>();
+
+	// A save slot, or a new game that is never saved
+	if (Slot > 0)
+	{
+		Game->SetCurrentSlot(Slot);
+		if (!Game->LoadGame(PC))
+		{
+			FLOGV("UFlareDiagnosticsCommandlet::Main failed: can't load slot %d", Slot);
+			return 1;
+		}
+	}
+	else
+	{
+		Game->CreateGame(PC, LOCTEXT("DiagnosticsCompanyName", "Diagnostics"), 0, false);
+	}
+
+	bool Success = FlareDiagnostics::Run(Game, CheckName, Count, true);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return Success ? 0 : 1;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlareDiagnosticsCommandlet.generated.h"
+
+
+/** Run the FlareDiagnostics checks without a render device, on a save slot or on a new game
+ *  Usage : HeliumRain -run=FlareDiagnostics [-Check=All] [-Slot=1] [-Count=0]
+ */
+UCLASS()
+class HELIUMRAIN_API UFlareDiagnosticsCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	virtual int32 Main(const FString& Params) override;
+
+};
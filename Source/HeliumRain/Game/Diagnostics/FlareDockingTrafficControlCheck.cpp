@@ -0,0 +1,367 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../../Player/FlarePlayerController.h"
+#include "../../Spacecrafts/Subsystems/FlareSpacecraftDockingSystem.h"
+
+
+/** Ship of the docking traffic check */
+struct FFlareDockingCheckShip
+{
+	FName                     Name;
+	EFlarePartSize::Type      Size;
+	int32                     Priority;
+	bool                      GivesUp;
+
+	/** 0 arriving, 1 waiting, 2 approaching, 3 docked, 4 gone */
+	int32                     State;
+	int32                     Slot;
+	float                     ArrivalTime;
+	float                     DockDuration;
+	float                     DockTime;
+	float                     LeaveTime;
+
+	/** Order of the first denied request, and step the ship got a dock */
+	int32                     QueueOrder;
+	float                     QueueTime;
+	float                     EstimatedWait;
+	int32                     ReservedStep;
+
+	FFlareDockingCheckShip()
+		: Size(EFlarePartSize::S)
+		, Priority(EFlareDockingPriority::Normal)
+		, GivesUp(false)
+		, State(0)
+		, Slot(-1)
+		, ArrivalTime(0)
+		, DockDuration(0)
+		, DockTime(0)
+		, LeaveTime(0)
+		, QueueOrder(-1)
+		, QueueTime(0)
+		, EstimatedWait(0)
+		, ReservedStep(-1)
+	{}
+};
+
+/** Store a docking queue in a station of the game copy, save the game to the scratch slot, and read the queue back from the reloaded station */
+static bool SaveDockingQueueToSlot(AFlareGame* Game, const TArray<FFlareDockingRequestSave>& Queue, TArray<FFlareDockingRequestSave>& LoadedQueue)
+{
+	UFlareSimulatedSpacecraft* Station = NULL;
+	for (int32 SectorIndex = 0; SectorIndex < Game->GetGameWorld()->GetSectors().Num() && !Station; SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Game->GetGameWorld()->GetSectors()[SectorIndex];
+		if (Sector->GetSectorStations().Num())
+		{
+			Station = Sector->GetSectorStations()[0];
+		}
+	}
+	if (!Station)
+	{
+		FLOG("FlareDiagnostics::CheckDockingTrafficControl : no station to save the queue in");
+		return false;
+	}
+
+	FName StationName = Station->GetImmatriculation();
+	Station->GetData().DockingQueue = Queue;
+
+	AFlarePlayerController* PC = Game->GetPC();
+	Game->SetCurrentSlot(DIAGNOSTICS_SCRATCH_SLOT);
+	if (!Game->SaveGame(PC, false))
+	{
+		FLOG("FlareDiagnostics::CheckDockingTrafficControl : cannot save the game copy");
+		return false;
+	}
+	Game->UnloadGame();
+	Game->LoadGame(PC);
+	Game->DeleteSaveSlot(DIAGNOSTICS_SCRATCH_SLOT);
+
+	Station = Game->GetGameWorld()->FindSpacecraft(StationName);
+	if (!Station)
+	{
+		FLOGV("FlareDiagnostics::CheckDockingTrafficControl : station %s lost in the save", *StationName.ToString());
+		return false;
+	}
+
+	LoadedQueue = Station->GetData().DockingQueue;
+	return true;
+}
+
+/** Simulate 100 ships contending for the docks of a station, and check the grants, the queue order and a queue saved to a slot */
+static bool CheckDockingTrafficControl(AFlareGame* Game, int32 Count)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckDockingTrafficControl failed: no loaded world");
+		return false;
+	}
+
+	bool SectorActive;
+	int32 PlayerSlot = FlareDiagnostics::LoadGameCopy(Game, TEXT("CheckDockingTrafficControl"), SectorActive);
+	if (PlayerSlot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Five small docks on three lanes, two large docks on one lane
+	const int32 SlotCount = 7;
+	EFlarePartSize::Type SlotSizes[SlotCount] = { EFlarePartSize::S, EFlarePartSize::S, EFlarePartSize::S, EFlarePartSize::S, EFlarePartSize::S, EFlarePartSize::L, EFlarePartSize::L };
+	int32 SlotLanes[SlotCount] = { 0, 0, 1, 1, 2, 3, 3 };
+
+	FFlareDockingTraffic Traffic;
+	for (int32 SlotIndex = 0; SlotIndex < SlotCount; SlotIndex++)
+	{
+		Traffic.AddSlot(SlotSizes[SlotIndex], SlotLanes[SlotIndex]);
+	}
+
+	// A ship every two seconds, a few with priority, and every tenth stops asking once queued
+	FRandomStream Random(43);
+	TArray<FFlareDockingCheckShip> Ships;
+	for (int32 Index = 0; Index < 100; Index++)
+	{
+		FFlareDockingCheckShip Ship;
+		Ship.Name = FName(*FString::Printf(TEXT("DOCK-CHECK-%03d"), Index));
+		Ship.Size = (Index % 5 == 4) ? EFlarePartSize::L : EFlarePartSize::S;
+		Ship.Priority = (Index % 25 == 3) ? EFlareDockingPriority::Company : EFlareDockingPriority::Normal;
+		Ship.GivesUp = (Index % 10 == 7);
+		Ship.ArrivalTime = Index * 2.f;
+		Ship.DockDuration = Random.FRandRange(30, 90);
+		Ships.Add(Ship);
+	}
+
+	const float StepDuration = 0.5f;
+	const float ApproachDuration = 5.f;
+	const float FinalApproachDuration = 10.f;
+	TArray<float> NoCosts;
+	TArray<TArray<float> > LaneApproachTimes;
+	LaneApproachTimes.SetNum(4);
+
+	int32 QueueCount = 0;
+	int32 DoubleGrantCount = 0;
+	int32 InconsistentCount = 0;
+	bool Restored = false;
+	bool RestoreSuccess = true;
+	bool Completed = false;
+	int32 Step = 0;
+
+	for (; Step < 40000 && !Completed; Step++)
+	{
+		Traffic.Tick(StepDuration);
+		float Time = Traffic.GetTime();
+
+		for (int32 Index = 0; Index < Ships.Num(); Index++)
+		{
+			FFlareDockingCheckShip& Ship = Ships[Index];
+
+			// Ask until granted, like the cargo pilots
+			if ((Ship.State == 0 && Time >= Ship.ArrivalTime) || (Ship.State == 1 && !Ship.GivesUp))
+			{
+				int32 Slot = Traffic.Request(Ship.Name, Ship.Size, Ship.Priority, ApproachDuration, NoCosts);
+				if (Slot >= 0)
+				{
+					float ApproachTime = Traffic.GetSlots()[Slot].ApproachTime;
+					LaneApproachTimes[SlotLanes[Slot]].Add(ApproachTime);
+
+					Ship.Slot = Slot;
+					Ship.DockTime = ApproachTime + FinalApproachDuration;
+					Ship.ReservedStep = (Ship.ReservedStep < 0) ? Step : Ship.ReservedStep;
+					Ship.State = 2;
+				}
+				else if (Ship.State == 0)
+				{
+					Ship.QueueOrder = QueueCount++;
+					Ship.QueueTime = Time;
+					Ship.EstimatedWait = Traffic.GetEstimatedWait(Ship.Name);
+					Ship.State = 1;
+				}
+			}
+			else if (Ship.State == 2 && Time >= Ship.DockTime)
+			{
+				Traffic.Dock(Ship.Name, Ship.Slot);
+				Ship.LeaveTime = Time + Ship.DockDuration;
+				Ship.State = 3;
+			}
+			else if (Ship.State == 3 && Time >= Ship.LeaveTime)
+			{
+				Traffic.Release(Ship.Name, Ship.Slot);
+				Ship.State = 4;
+			}
+		}
+
+		// Each dock held by a single ship, the one the traffic control knows
+		TMap<int32, FName> SlotHolders;
+		for (int32 Index = 0; Index < Ships.Num(); Index++)
+		{
+			FFlareDockingCheckShip& Ship = Ships[Index];
+			if (Ship.State == 1 && Ship.ReservedStep < 0 && Traffic.GetShipSlot(Ship.Name) >= 0)
+			{
+				Ship.ReservedStep = Step;
+			}
+			else if (Ship.State == 2 || Ship.State == 3)
+			{
+				if (SlotHolders.Contains(Ship.Slot) || Traffic.GetSlots()[Ship.Slot].Ship != Ship.Name)
+				{
+					FLOGV("FlareDiagnostics::CheckDockingTrafficControl : dock %d held by '%s' and '%s'",
+						Ship.Slot, *Ship.Name.ToString(), *Traffic.GetSlots()[Ship.Slot].Ship.ToString());
+					DoubleGrantCount++;
+				}
+				SlotHolders.Add(Ship.Slot, Ship.Name);
+			}
+		}
+		InconsistentCount += Traffic.IsConsistent() ? 0 : 1;
+
+		// Save the queue halfway through a save slot and restore it in a new station, as a sector reload does
+		if (!Restored && Time >= 300)
+		{
+			TArray<FFlareDockingRequestSave> SavedQueue = Traffic.SaveQueue();
+			TArray<FFlareDockingRequestSave> LoadedQueue;
+			RestoreSuccess &= SaveDockingQueueToSlot(Game, SavedQueue, LoadedQueue);
+			RestoreSuccess &= (LoadedQueue.Num() == SavedQueue.Num());
+			for (int32 Index = 0; Index < SavedQueue.Num() && Index < LoadedQueue.Num(); Index++)
+			{
+				const FFlareDockingRequestSave& Saved = SavedQueue[Index];
+				const FFlareDockingRequestSave& Loaded = LoadedQueue[Index];
+				if (Loaded.ShipImmatriculation != Saved.ShipImmatriculation || Loaded.Size != Saved.Size
+					|| Loaded.Priority != Saved.Priority || !FMath::IsNearlyEqual(Loaded.WaitTime, Saved.WaitTime, 0.01f))
+				{
+					FLOGV("FlareDiagnostics::CheckDockingTrafficControl : request of '%s' changed in the save", *Saved.ShipImmatriculation.ToString());
+					RestoreSuccess = false;
+				}
+			}
+
+			Traffic.Reset();
+			for (int32 SlotIndex = 0; SlotIndex < SlotCount; SlotIndex++)
+			{
+				Traffic.AddSlot(SlotSizes[SlotIndex], SlotLanes[SlotIndex]);
+			}
+			Traffic.Tick(Time);
+
+			// Docked ships come back first, then the approaching ships ask again, then the queue is loaded
+			for (int32 Index = 0; Index < Ships.Num(); Index++)
+			{
+				if (Ships[Index].State == 3)
+				{
+					Traffic.Dock(Ships[Index].Name, Ships[Index].Slot);
+				}
+			}
+			for (int32 Index = 0; Index < Ships.Num(); Index++)
+			{
+				if (Ships[Index].State == 2)
+				{
+					Ships[Index].Slot = Traffic.Request(Ships[Index].Name, Ships[Index].Size, Ships[Index].Priority, 0, NoCosts);
+					RestoreSuccess &= (Ships[Index].Slot >= 0);
+				}
+			}
+			Traffic.LoadQueue(LoadedQueue);
+
+			// Every saved ship is waiting again, the ones without a dock yet in the saved order
+			int32 QueueIndex = 0;
+			for (int32 Index = 0; Index < LoadedQueue.Num(); Index++)
+			{
+				FName Name = LoadedQueue[Index].ShipImmatriculation;
+				if (Traffic.IsQueued(Name))
+				{
+					RestoreSuccess &= (QueueIndex < Traffic.GetQueue().Num() && Traffic.GetQueue()[QueueIndex].Ship == Name);
+					QueueIndex++;
+				}
+				else
+				{
+					RestoreSuccess &= (Traffic.GetShipState(Name) == EFlareDockState::Reserved);
+				}
+			}
+			RestoreSuccess &= (QueueIndex == Traffic.GetQueue().Num());
+
+			FLOGV("FlareDiagnostics::CheckDockingTrafficControl : restored %d queued ships at %f s", LoadedQueue.Num(), Time);
+			for (int32 Lane = 0; Lane < LaneApproachTimes.Num(); Lane++)
+			{
+				LaneApproachTimes[Lane].Empty();
+			}
+			Restored = true;
+		}
+
+		// Everybody docked and left, and the ships that gave up were forgotten
+		Completed = true;
+		for (int32 Index = 0; Index < Ships.Num() && Completed; Index++)
+		{
+			if (Ships[Index].GivesUp && Ships[Index].State == 1)
+			{
+				Completed = (Traffic.GetShipSlot(Ships[Index].Name) < 0 && !Traffic.IsQueued(Ships[Index].Name));
+			}
+			else
+			{
+				Completed = (Ships[Index].State == 4);
+			}
+		}
+	}
+
+	// A ship queued before another one with no higher priority got its dock first
+	int32 FairnessViolationCount = 0;
+	for (int32 Index = 0; Index < Ships.Num(); Index++)
+	{
+		const FFlareDockingCheckShip& Ship = Ships[Index];
+		if (Ship.QueueOrder < 0 || Ship.GivesUp)
+		{
+			continue;
+		}
+
+		for (int32 OtherIndex = 0; OtherIndex < Ships.Num(); OtherIndex++)
+		{
+			const FFlareDockingCheckShip& Other = Ships[OtherIndex];
+			if (Other.QueueOrder > Ship.QueueOrder && !Other.GivesUp && Other.Size == Ship.Size && Other.Priority <= Ship.Priority
+				&& Other.ReservedStep < Ship.ReservedStep)
+			{
+				FLOGV("FlareDiagnostics::CheckDockingTrafficControl : '%s' served at step %d before '%s' at step %d",
+					*Other.Name.ToString(), Other.ReservedStep, *Ship.Name.ToString(), Ship.ReservedStep);
+				FairnessViolationCount++;
+			}
+		}
+	}
+
+	// Approaches on the same lane are separated
+	int32 LaneConflictCount = 0;
+	for (int32 Lane = 0; Lane < LaneApproachTimes.Num(); Lane++)
+	{
+		LaneApproachTimes[Lane].Sort();
+		for (int32 Index = 1; Index < LaneApproachTimes[Lane].Num(); Index++)
+		{
+			if (LaneApproachTimes[Lane][Index] - LaneApproachTimes[Lane][Index - 1] < DOCK_LANE_SEPARATION - 0.001f)
+			{
+				LaneConflictCount++;
+			}
+		}
+	}
+
+	// Wait statistics
+	int32 WaitCount = 0;
+	float TotalWait = 0;
+	float TotalEstimatedWait = 0;
+	float MaxWait = 0;
+	for (int32 Index = 0; Index < Ships.Num(); Index++)
+	{
+		const FFlareDockingCheckShip& Ship = Ships[Index];
+		if (Ship.QueueOrder >= 0 && !Ship.GivesUp && Ship.ReservedStep >= 0)
+		{
+			float Wait = (Ship.ReservedStep + 1) * StepDuration - Ship.QueueTime;
+			TotalWait += Wait;
+			TotalEstimatedWait += Ship.EstimatedWait;
+			MaxWait = FMath::Max(MaxWait, Wait);
+			WaitCount++;
+		}
+	}
+
+	FLOGV("FlareDiagnostics::CheckDockingTrafficControl : %d ships, %d queued, %f s simulated, mean wait %f s (estimated %f s), max wait %f s",
+		Ships.Num(), QueueCount, Step * StepDuration,
+		TotalWait / FMath::Max(WaitCount, 1), TotalEstimatedWait / FMath::Max(WaitCount, 1), MaxWait);
+
+	bool Success = Completed && Restored && RestoreSuccess && DoubleGrantCount == 0 && InconsistentCount == 0
+		&& FairnessViolationCount == 0 && LaneConflictCount == 0;
+	FLOGV("FlareDiagnostics::CheckDockingTrafficControl : %d double grants, %d inconsistent steps, %d fairness violations, %d lane conflicts, restore %d, completed %d : %s",
+		DoubleGrantCount, InconsistentCount, FairnessViolationCount, LaneConflictCount, RestoreSuccess, Completed,
+		Success ? TEXT("passed") : TEXT("FAILED"));
+
+	FlareDiagnostics::RestoreGameCopy(Game, PlayerSlot, SectorActive);
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(DockingTrafficControl, CheckDockingTrafficControl, 0, false)
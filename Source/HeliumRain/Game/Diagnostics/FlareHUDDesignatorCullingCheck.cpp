@@ -0,0 +1,97 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Player/FlarePlayerController.h"
+
+
+/** Feed synthetic spacecraft positions through the HUD designator culling and budget */
+static bool CheckHUDDesignatorCulling(AFlareGame* Game, int32 Count)
+{
+	FVector2D Viewport(1920, 1080);
+	float FOV = 90;
+	float Range = 1000000;
+	int32 CandidateCount = 2000;
+	int32 MaxFullDesignators = 40;
+	FRandomStream Random(42);
+
+	FFlareDesignatorView View = AFlareHUD::GetDesignatorView(FVector::ZeroVector, FRotator::ZeroRotator, FOV, Viewport);
+
+	TArray<FFlareDesignatorCandidate> Candidates;
+	for (int32 Index = 0; Index < CandidateCount; Index++)
+	{
+		FFlareDesignatorCandidate Candidate;
+		Candidate.Spacecraft = NULL;
+		Candidate.Location = FVector(Random.FRandRange(-2, 2), Random.FRandRange(-2, 2), Random.FRandRange(-2, 2)) * Range / 2;
+		Candidate.Radius = Random.FRandRange(100, 5000);
+		Candidate.Priority = Random.FRand();
+		Candidate.Alive = true;
+		Candidate.Highlighted = (Index == 0);
+		Candidate.ScreenPosition = FVector2D::ZeroVector;
+		Candidates.Add(Candidate);
+	}
+
+	AFlareHUD::CullDesignatorCandidates(View, Candidates);
+
+	// Every center projected inside the viewport must be kept
+	float HorizontalTan = FMath::Tan(FMath::DegreesToRadians(FOV / 2));
+	float VerticalTan = HorizontalTan * Viewport.Y / Viewport.X;
+	int32 VisibleCount = 0;
+	int32 InViewCount = 0;
+	int32 MissedCount = 0;
+	for (int32 Index = 0; Index < Candidates.Num(); Index++)
+	{
+		FFlareDesignatorCandidate& Candidate = Candidates[Index];
+		FVector Location = Candidate.Location;
+		bool Visible = Location.X > 0
+			&& FMath::Abs(Location.Y) <= HorizontalTan * Location.X
+			&& FMath::Abs(Location.Z) <= VerticalTan * Location.X;
+
+		VisibleCount += Visible ? 1 : 0;
+		InViewCount += Candidate.InView ? 1 : 0;
+		MissedCount += (Visible && !Candidate.InView) ? 1 : 0;
+
+		// The HUD projects what is left
+		Candidate.Projected = Candidate.InView;
+		if (Candidate.Highlighted)
+		{
+			Candidate.Priority = MAX_FLT;
+		}
+	}
+
+	AFlareHUD::BudgetDesignatorCandidates(Candidates, MaxFullDesignators);
+
+	// Full designators go to the highest priorities
+	int32 FullCount = 0;
+	float MinFullPriority = MAX_FLT;
+	float MaxMarkerPriority = -MAX_FLT;
+	bool HighlightedFull = false;
+	for (int32 Index = 0; Index < Candidates.Num(); Index++)
+	{
+		const FFlareDesignatorCandidate& Candidate = Candidates[Index];
+		if (Candidate.FullDesignator)
+		{
+			FullCount++;
+			MinFullPriority = FMath::Min(MinFullPriority, Candidate.Priority);
+			HighlightedFull |= Candidate.Highlighted;
+		}
+		else if (Candidate.Projected)
+		{
+			MaxMarkerPriority = FMath::Max(MaxMarkerPriority, Candidate.Priority);
+		}
+	}
+
+	bool Success = (MissedCount == 0)
+		&& (FullCount == FMath::Min(MaxFullDesignators, InViewCount))
+		&& (HighlightedFull || !Candidates[0].InView)
+		&& (MinFullPriority >= MaxMarkerPriority);
+
+	FLOGV("FlareDiagnostics::CheckHUDDesignatorCulling : %d candidates, %d visible, %d kept by the view cone, %d missed",
+		CandidateCount, VisibleCount, InViewCount, MissedCount);
+	FLOGV("FlareDiagnostics::CheckHUDDesignatorCulling : %d full designators (max %d), target kept %d",
+		FullCount, MaxFullDesignators, HighlightedFull);
+	FLOGV("FlareDiagnostics::CheckHUDDesignatorCulling : %s", Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(HUDDesignatorCulling, CheckHUDDesignatorCulling, 0, false)
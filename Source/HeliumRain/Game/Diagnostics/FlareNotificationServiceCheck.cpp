@@ -0,0 +1,95 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Player/FlareNotificationService.h"
+
+
+/** Push a burst of identical events to a notification service */
+static void PushNotificationBurst(FFlareNotificationService& Service, FName Tag, bool Pinned, int32 Count, double Time, TArray<FFlareNotificationEvent>& Output)
+{
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		FFlareNotificationEvent Event;
+		Event.Text = FText::FromString(Tag.ToString() + " event");
+		Event.Tag = Tag;
+		Event.Pinned = Pinned;
+		Event.TargetMenu = EFlareMenu::MENU_Ship;
+		Service.Push(Event, Index, Time, Output);
+	}
+}
+
+/** Send scripted notification bursts through a notification service and check the aggregated notifications */
+static bool CheckNotificationService(AFlareGame* Game, int32 Count)
+{
+	FFlareNotificationService Service;
+	Service.SetCategory("ship-killed", FText::FromString("{0} ships destroyed"), 1.0f);
+	Service.SetCategory("travel-end", FText::FromString("{0} fleets arrived"), 1.0f);
+	Service.SetCategory("new-date-ff", FText(), 0);
+	TArray<FFlareNotificationEvent> Output;
+	int32 ErrorCount = 0;
+
+	// A burst shows the first event, then one summary at the end of the interval
+	PushNotificationBurst(Service, "ship-killed", false, 10, 0.0, Output);
+	ErrorCount += (Output.Num() == 1 && Output[0].Count == 1 && Output[0].TargetMenu == EFlareMenu::MENU_Ship) ? 0 : 1;
+	Output.Empty();
+	Service.Update(0.5, Output);
+	ErrorCount += (Output.Num() == 0) ? 0 : 1;
+	Service.Update(1.0, Output);
+	ErrorCount += (Output.Num() == 1 && Output[0].Count == 9 && Output[0].Text.ToString() == TEXT("9 ships destroyed")
+		&& Output[0].TargetMenu == EFlareMenu::MENU_None) ? 0 : 1;
+	Output.Empty();
+
+	// Nothing left, and the next event waits for the interval
+	Service.Update(1.5, Output);
+	PushNotificationBurst(Service, "ship-killed", false, 1, 1.5, Output);
+	ErrorCount += (Output.Num() == 0) ? 0 : 1;
+	Service.Update(2.0, Output);
+	ErrorCount += (Output.Num() == 1 && Output[0].Count == 1 && Output[0].Text.ToString() == TEXT("ship-killed event")) ? 0 : 1;
+	Output.Empty();
+
+	// Untagged, unregistered, pinned and unlimited events are all shown
+	PushNotificationBurst(Service, NAME_None, false, 3, 10.0, Output);
+	PushNotificationBurst(Service, "quest-tutorial-message", false, 3, 10.0, Output);
+	PushNotificationBurst(Service, "ship-killed", true, 3, 10.0, Output);
+	PushNotificationBurst(Service, "new-date-ff", false, 3, 10.0, Output);
+	ErrorCount += (Output.Num() == 12 && Output[4].Text.ToString() == TEXT("quest-tutorial-message event")) ? 0 : 1;
+	Output.Empty();
+
+	// Tags are aggregated separately, with their own summary
+	PushNotificationBurst(Service, "travel-end", false, 4, 20.0, Output);
+	PushNotificationBurst(Service, "ship-killed", false, 3, 20.0, Output);
+	ErrorCount += (Output.Num() == 2) ? 0 : 1;
+	Output.Empty();
+	Service.Update(21.0, Output);
+	ErrorCount += (Output.Num() == 2) ? 0 : 1;
+	for (int32 Index = 0; Index < Output.Num(); Index++)
+	{
+		bool IsTravel = (Output[Index].Tag == "travel-end");
+		FString ExpectedText = IsTravel ? TEXT("3 fleets arrived") : TEXT("2 ships destroyed");
+		ErrorCount += (Output[Index].Text.ToString() == ExpectedText) ? 0 : 1;
+	}
+	Output.Empty();
+
+	// Every event is in the history, and can be found
+	TArray<const FFlareNotificationRecordSave*> Results;
+	Service.Search(TEXT("SHIP-KILLED"), Results);
+	int32 HistoryCount = Service.GetHistory().Num();
+	ErrorCount += (HistoryCount == 30 && Results.Num() == 17) ? 0 : 1;
+
+	// Pending events are dropped on flush, the history is kept on load
+	PushNotificationBurst(Service, "ship-killed", false, 5, 30.0, Output);
+	Output.Empty();
+	Service.Flush();
+	Service.Update(40.0, Output);
+	TArray<FFlareNotificationRecordSave> SavedHistory = Service.GetHistory();
+	Service.Load(SavedHistory);
+	ErrorCount += (Output.Num() == 0 && Service.GetHistory().Num() == HistoryCount + 5) ? 0 : 1;
+
+	FLOGV("FlareDiagnostics::CheckNotificationService : %d history entries, %d errors : %s",
+		Service.GetHistory().Num(), ErrorCount,
+		ErrorCount == 0 ? TEXT("passed") : TEXT("FAILED"));
+
+	return ErrorCount == 0;
+}
+
+FLARE_DIAGNOSTICS_CHECK(NotificationService, CheckNotificationService, 0, false)
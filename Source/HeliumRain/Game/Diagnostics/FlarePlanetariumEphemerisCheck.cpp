@@ -0,0 +1,148 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+
+
+/** Get the worst location and rotation errors between two snapshots of the same bodies */
+static void CompareCelestialBodies(const FFlareCelestialBody& Body, const FFlareCelestialBody& Reference, double& MaxRelativeError, double& MaxRotationError)
+{
+	if (Reference.OrbitDistance > 0)
+	{
+		double Error = (Body.RelativeLocation - Reference.RelativeLocation).Size() / Reference.OrbitDistance;
+		MaxRelativeError = FMath::Max(MaxRelativeError, Error);
+	}
+	MaxRotationError = FMath::Max(MaxRotationError, FMath::Abs(FPreciseMath::UnwindDegrees(Body.RotationAngle - Reference.RotationAngle)));
+
+	for (int32 SatteliteIndex = 0; SatteliteIndex < Reference.Sattelites.Num(); SatteliteIndex++)
+	{
+		CompareCelestialBodies(Body.Sattelites[SatteliteIndex], Reference.Sattelites[SatteliteIndex], MaxRelativeError, MaxRotationError);
+	}
+}
+
+/** Get the largest part of the sun disk hidden by a body of a snapshot or its sattelites, seen from a location, as the planetarium actor draws it */
+static double GetSnapShotSunOcclusion(const FFlareCelestialBody& Sun, const FFlareCelestialBody& Body, const FPreciseVector& Location)
+{
+	double Occlusion = 0;
+
+	if (&Body != &Sun)
+	{
+		FPreciseVector SunDelta = Sun.AbsoluteLocation - Location;
+		FPreciseVector BodyDelta = Body.AbsoluteLocation - Location;
+		double SunAngle = FPreciseMath::Asin(Sun.Radius / SunDelta.Size());
+		double BodyAngle = FPreciseMath::Asin(FMath::Min(Body.Radius / BodyDelta.Size(), 1.0));
+
+		// Angle between the disk centers, from their directions
+		double Cosine = (SunDelta.X * BodyDelta.X + SunDelta.Z * BodyDelta.Z)
+			/ (FPreciseMath::Sqrt(SunDelta.X * SunDelta.X + SunDelta.Z * SunDelta.Z) * FPreciseMath::Sqrt(BodyDelta.X * BodyDelta.X + BodyDelta.Z * BodyDelta.Z));
+		double CenterDistance = acos(FMath::Clamp(Cosine, -1.0, 1.0));
+
+		if (CenterDistance < SunAngle + BodyAngle)
+		{
+			double MinAngle = FMath::Min(SunAngle, BodyAngle);
+			double Ratio = (CenterDistance < FMath::Abs(SunAngle - BodyAngle)) ? 1.0 : (SunAngle + BodyAngle - CenterDistance) / (2 * MinAngle);
+			Occlusion = Ratio * (MinAngle * MinAngle) / (SunAngle * SunAngle);
+		}
+	}
+
+	for (int32 SatteliteIndex = 0; SatteliteIndex < Body.Sattelites.Num(); SatteliteIndex++)
+	{
+		Occlusion = FMath::Max(Occlusion, GetSnapShotSunOcclusion(Sun, Body.Sattelites[SatteliteIndex], Location));
+	}
+
+	return Occlusion;
+}
+
+/** Sample the sun occlusion of an orbit from full snapshots, and get the first lit sample */
+static double GetSampledTimeToDaylight(UFlareSimulatedPlanetarium* Planetarium, FName ParentIdentifier, double OrbitDistance, double InitialPhase, double Time, double StepTime, double MaxDelay)
+{
+	for (double Delay = 0; Delay < MaxDelay; Delay += StepTime)
+	{
+		int64 WholeTime = (int64) FMath::FloorToDouble(Time + Delay);
+		float SmoothTime = Time + Delay - WholeTime;
+		FFlareCelestialBody Sun = Planetarium->GetSnapShot(WholeTime, SmoothTime);
+		FFlareCelestialBody* Parent = Planetarium->FindCelestialBody(&Sun, ParentIdentifier);
+
+		int64 RevolutionTime = UFlareSimulatedPlanetarium::GetRevolutionTime(Parent, OrbitDistance, 0);
+		FPreciseVector Location = Parent->AbsoluteLocation + UFlareSimulatedPlanetarium::GetOrbitLocation(RevolutionTime, WholeTime, SmoothTime, OrbitDistance, InitialPhase);
+		if (GetSnapShotSunOcclusion(Sun, Sun, Location) < 1)
+		{
+			return Delay;
+		}
+	}
+
+	return MaxDelay;
+}
+
+/** Compare the planetarium ephemeris cache with the full computation, and the daylight query with the sun occlusion sampled over time */
+static bool CheckPlanetariumEphemeris(AFlareGame* Game, int32 Count)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckPlanetariumEphemeris failed: no loaded world");
+		return false;
+	}
+
+	UFlareSimulatedPlanetarium* Planetarium = Game->GetGameWorld()->GetPlanerarium();
+	bool Success = true;
+
+	// Cache against the full computation over two days, with fractional times
+	double MaxRelativeError = 0;
+	double MaxRotationError = 0;
+	for (double Time = 0; Time < 2 * SECONDS_IN_DAY; Time += 37.3)
+	{
+		int64 WholeTime = (int64) Time;
+		float SmoothTime = Time - WholeTime;
+
+		FFlareCelestialBody* Cached = Planetarium->GetCachedSnapShot(WholeTime, SmoothTime);
+		FFlareCelestialBody Reference = Planetarium->GetSnapShot(WholeTime, SmoothTime);
+		CompareCelestialBodies(*Cached, Reference, MaxRelativeError, MaxRotationError);
+	}
+
+	bool CacheSuccess = (MaxRelativeError < 1e-4 && MaxRotationError < 0.1);
+	Success &= CacheSuccess;
+	FLOGV("FlareDiagnostics::CheckPlanetariumEphemeris : cache max relative error %f, max rotation error %f degrees : %s",
+		MaxRelativeError, MaxRotationError, CacheSuccess ? TEXT("passed") : TEXT("FAILED"));
+
+	// Daylight query against the occlusion of all bodies sampled every 10s, for every sector orbit over two days
+	int32 QueryCount = 0;
+	int32 NightCount = 0;
+	int32 QueryFailures = 0;
+	double StepTime = 10;
+	for (int32 SectorIndex = 0; SectorIndex < Game->GetGameWorld()->GetSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Game->GetGameWorld()->GetSectors()[SectorIndex];
+		FFlareSectorOrbitParameters* Orbit = Sector->GetOrbitParameters();
+		FFlareCelestialBody* Parent = Planetarium->FindCelestialBody(Orbit->CelestialBodyIdentifier);
+		if (!Parent)
+		{
+			continue;
+		}
+		double OrbitDistance = Parent->Radius + Orbit->Altitude;
+
+		for (double Time = 0; Time < 2 * SECONDS_IN_DAY; Time += 1234.5)
+		{
+			double Delay = Planetarium->GetTimeToDaylight(Orbit->CelestialBodyIdentifier, OrbitDistance, Orbit->Phase, Time);
+			double SampledDelay = GetSampledTimeToDaylight(Planetarium, Orbit->CelestialBodyIdentifier, OrbitDistance, Orbit->Phase, Time, StepTime, SECONDS_IN_DAY);
+
+			// The query must end in daylight, within a sampling step of the first lit sample
+			double LitDelay = GetSampledTimeToDaylight(Planetarium, Orbit->CelestialBodyIdentifier, OrbitDistance, Orbit->Phase, Time + Delay, StepTime, StepTime);
+			QueryCount++;
+			NightCount += (SampledDelay > 0) ? 1 : 0;
+			if (LitDelay > 0 || FMath::Abs(Delay - SampledDelay) > StepTime)
+			{
+				QueryFailures++;
+				FLOGV("FlareDiagnostics::CheckPlanetariumEphemeris : '%s' at %f, daylight in %f seconds, sampled %f",
+					*Sector->GetIdentifier().ToString(), Time, Delay, SampledDelay);
+			}
+		}
+	}
+
+	Success &= (QueryFailures == 0);
+	FLOGV("FlareDiagnostics::CheckPlanetariumEphemeris : %d daylight queries, %d at night, %d failures", QueryCount, NightCount, QueryFailures);
+	FLOGV("FlareDiagnostics::CheckPlanetariumEphemeris : %s", Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(PlanetariumEphemeris, CheckPlanetariumEphemeris, 0, false)
@@ -0,0 +1,99 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../FlareCompany.h"
+#include "../../Player/FlarePlayerController.h"
+#include "../../Quests/FlareQuest.h"
+#include "FlareQuestReplay.h"
+
+
+/** Record the events the current game would send to the quests, twice */
+static void RecordQuestEvents(AFlareGame* Game, TArray<FFlareQuestEvent>& Events)
+{
+	UFlareCompany* PlayerCompany = Game->GetPC()->GetCompany();
+	for (int32 Iteration = 0; Iteration < 2; Iteration++)
+	{
+		if (Game->GetActiveSector())
+		{
+			Events.Add({ EFlareQuestCallback::SECTOR_ACTIVE, Game->GetActiveSector()->GetSimulatedSector()->GetIdentifier() });
+		}
+		Events.Add({ EFlareQuestCallback::FLY_SHIP, NAME_None });
+
+		for (int32 SectorIndex = 0; SectorIndex < PlayerCompany->GetVisitedSectors().Num(); SectorIndex++)
+		{
+			Events.Add({ EFlareQuestCallback::SECTOR_VISITED, PlayerCompany->GetVisitedSectors()[SectorIndex]->GetIdentifier() });
+		}
+
+		for (int32 TickIndex = 0; TickIndex < 10; TickIndex++)
+		{
+			Events.Add({ EFlareQuestCallback::TICK_FLYING, NAME_None });
+		}
+	}
+}
+
+/** Replay an event file over fresh quests with compiled conditions and with the former recursive evaluation, and compare the step transitions */
+static bool CheckQuestEventDispatch(AFlareGame* Game, int32 Count)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckQuestEventDispatch failed: no loaded world");
+		return false;
+	}
+
+	// Replay the event file, recorded from this game on the first run
+	FString Path = FPaths::GameSavedDir() / TEXT("Diagnostics/QuestEvents.txt");
+	if (!FPaths::FileExists(Path))
+	{
+		TArray<FFlareQuestEvent> RecordedEvents;
+		RecordQuestEvents(Game, RecordedEvents);
+		if (!UFlareQuestReplayManager::SaveEvents(Path, RecordedEvents))
+		{
+			FLOGV("FlareDiagnostics::CheckQuestEventDispatch failed: cannot write %s", *Path);
+			return false;
+		}
+		FLOGV("FlareDiagnostics::CheckQuestEventDispatch : recorded %d events to %s", RecordedEvents.Num(), *Path);
+	}
+
+	TArray<FFlareQuestEvent> Events;
+	if (!UFlareQuestReplayManager::LoadEvents(Path, Events))
+	{
+		FLOGV("FlareDiagnostics::CheckQuestEventDispatch failed: cannot read %s", *Path);
+		return false;
+	}
+
+	// Compiled conditions with indexed dispatch, against the recursive evaluation with dispatch by event type
+	UFlareQuestReplayManager* IndexedManager = NewObject<UFlareQuestReplayManager>(Game, UFlareQuestReplayManager::StaticClass());
+	IndexedManager->Setup(Game, false);
+	TArray<FString> IndexedTransitions = IndexedManager->Replay(Events);
+
+	UFlareQuestReplayManager* ReferenceManager = NewObject<UFlareQuestReplayManager>(Game, UFlareQuestReplayManager::StaticClass());
+	ReferenceManager->Setup(Game, true);
+	TArray<FString> ReferenceTransitions = ReferenceManager->Replay(Events);
+
+	int32 MismatchIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < FMath::Max(IndexedTransitions.Num(), ReferenceTransitions.Num()); Index++)
+	{
+		if (!IndexedTransitions.IsValidIndex(Index) || !ReferenceTransitions.IsValidIndex(Index) || IndexedTransitions[Index] != ReferenceTransitions[Index])
+		{
+			MismatchIndex = Index;
+			break;
+		}
+		FLOGV("FlareDiagnostics::CheckQuestEventDispatch : %s", *IndexedTransitions[Index]);
+	}
+
+	if (MismatchIndex != INDEX_NONE)
+	{
+		FLOGV("FlareDiagnostics::CheckQuestEventDispatch : first mismatch, indexed '%s', reference '%s'",
+			IndexedTransitions.IsValidIndex(MismatchIndex) ? *IndexedTransitions[MismatchIndex] : TEXT("none"),
+			ReferenceTransitions.IsValidIndex(MismatchIndex) ? *ReferenceTransitions[MismatchIndex] : TEXT("none"));
+	}
+
+	bool Success = (MismatchIndex == INDEX_NONE);
+	FLOGV("FlareDiagnostics::CheckQuestEventDispatch : %d events, %d indexed transitions, %d reference transitions : %s",
+		Events.Num(), IndexedTransitions.Num(), ReferenceTransitions.Num(), Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(QuestEventDispatch, CheckQuestEventDispatch, 0, true)
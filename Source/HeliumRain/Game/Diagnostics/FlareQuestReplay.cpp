@@ -0,0 +1,400 @@
+
+#include "../../Flare.h"
+#include "../FlareGame.h"
+#include "../../Data/FlareQuestCatalog.h"
+#include "../../Data/FlareQuestCatalogEntry.h"
+#include "FlareQuestReplay.h"
+
+
+// Event type names in the event files, in EFlareQuestCallback order
+static const TCHAR* QuestEventNames[] =
+{
+	TEXT("TICK_FLYING"),
+	TEXT("SECTOR_VISITED"),
+	TEXT("SECTOR_ACTIVE"),
+	TEXT("FLY_SHIP"),
+	TEXT("QUEST")
+};
+
+
+/*----------------------------------------------------
+	Replay quest
+----------------------------------------------------*/
+
+UFlareReplayQuest::UFlareReplayQuest(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Reference(false)
+{
+}
+
+void UFlareReplayQuest::SetReference(bool NewReference)
+{
+	Reference = NewReference;
+}
+
+void UFlareReplayQuest::UpdateState()
+{
+	if (!Reference)
+	{
+		Super::UpdateState();
+		return;
+	}
+
+	switch(QuestStatus)
+	{
+		case EFlareQuestStatus::AVAILABLE:
+		{
+			if (CheckConditions(QuestDescription->Triggers, true))
+			{
+				Activate();
+			}
+			break;
+		}
+		case EFlareQuestStatus::ACTIVE:
+		{
+			const FFlareQuestStepDescription* StepDescription = GetCurrentStepDescription();
+			if (StepDescription && CheckConditions(StepDescription->EnabledConditions, true))
+			{
+				if (CheckConditions(StepDescription->FailConditions, false))
+				{
+					Fail();
+				}
+				else if (!CheckConditions(StepDescription->BlockConditions, false) && CheckConditions(StepDescription->EndConditions, true))
+				{
+					EndStep();
+				}
+			}
+			break;
+		}
+	}
+}
+
+void UFlareReplayQuest::PerformActions(const TArray<FFlareQuestActionDescription>& Actions)
+{
+}
+
+void UFlareReplayQuest::SendQuestNotification(FText Message, FName Tag)
+{
+}
+
+void UFlareReplayQuest::StartObjectiveTracking()
+{
+}
+
+void UFlareReplayQuest::StopObjectiveTracking()
+{
+}
+
+void UFlareReplayQuest::UpdateObjectiveTracker()
+{
+}
+
+TArray<EFlareQuestCallback::Type> UFlareReplayQuest::GetReferenceCallbacks()
+{
+	TArray<EFlareQuestCallback::Type> Callbacks;
+
+	switch(QuestStatus)
+	{
+		case EFlareQuestStatus::AVAILABLE:
+			AddReferenceCallbacks(Callbacks, QuestDescription->Triggers);
+			break;
+
+		case EFlareQuestStatus::ACTIVE:
+		{
+			const FFlareQuestStepDescription* StepDescription = GetCurrentStepDescription();
+			if (StepDescription)
+			{
+				AddReferenceCallbacks(Callbacks, StepDescription->EnabledConditions);
+				AddReferenceCallbacks(Callbacks, StepDescription->EndConditions);
+				AddReferenceCallbacks(Callbacks, StepDescription->FailConditions);
+				AddReferenceCallbacks(Callbacks, StepDescription->BlockConditions);
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	return Callbacks;
+}
+
+void UFlareReplayQuest::AddReferenceCallbacks(TArray<EFlareQuestCallback::Type>& Callbacks, const TArray<FFlareQuestConditionDescription>& Conditions)
+{
+	for (int ConditionIndex = 0; ConditionIndex < Conditions.Num(); ConditionIndex++)
+	{
+		const FFlareQuestConditionDescription* Condition = &Conditions[ConditionIndex];
+
+		if (Condition->Type == EFlareQuestCondition::SHARED_CONDITION)
+		{
+			const FFlareSharedQuestCondition* SharedCondition = FindSharedCondition(Condition->Identifier1);
+			if (SharedCondition)
+			{
+				AddReferenceCallbacks(Callbacks, SharedCondition->Conditions);
+			}
+			continue;
+		}
+
+		switch (Condition->Type)
+		{
+			case EFlareQuestCondition::FLYING_SHIP:
+				Callbacks.AddUnique(EFlareQuestCallback::FLY_SHIP);
+				break;
+			case EFlareQuestCondition::SECTOR_VISITED:
+				Callbacks.AddUnique(EFlareQuestCallback::SECTOR_VISITED);
+				break;
+			case EFlareQuestCondition::SECTOR_ACTIVE:
+				Callbacks.AddUnique(EFlareQuestCallback::SECTOR_ACTIVE);
+				break;
+			case EFlareQuestCondition::SHIP_MIN_COLLINEAR_VELOCITY:
+			case EFlareQuestCondition::SHIP_MAX_COLLINEAR_VELOCITY:
+			case EFlareQuestCondition::SHIP_MIN_COLLINEARITY:
+			case EFlareQuestCondition::SHIP_MAX_COLLINEARITY:
+			case EFlareQuestCondition::SHIP_MIN_PITCH_VELOCITY:
+			case EFlareQuestCondition::SHIP_MAX_PITCH_VELOCITY:
+			case EFlareQuestCondition::SHIP_MIN_YAW_VELOCITY:
+			case EFlareQuestCondition::SHIP_MAX_YAW_VELOCITY:
+			case EFlareQuestCondition::SHIP_MIN_ROLL_VELOCITY:
+			case EFlareQuestCondition::SHIP_MAX_ROLL_VELOCITY:
+			case EFlareQuestCondition::SHIP_FOLLOW_RELATIVE_WAYPOINTS:
+			case EFlareQuestCondition::SHIP_ALIVE:
+				Callbacks.AddUnique(EFlareQuestCallback::TICK_FLYING);
+				break;
+			case EFlareQuestCondition::QUEST_SUCCESSFUL:
+			case EFlareQuestCondition::QUEST_FAILED:
+				Callbacks.AddUnique(EFlareQuestCallback::QUEST);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+
+/*----------------------------------------------------
+	Replay manager
+----------------------------------------------------*/
+
+UFlareQuestReplayManager::UFlareQuestReplayManager(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Reference(false)
+{
+}
+
+void UFlareQuestReplayManager::Setup(AFlareGame* NewGame, bool NewReference)
+{
+	Game = NewGame;
+	Reference = NewReference;
+	QuestData.PlayTutorial = true;
+
+	for (int QuestIndex = 0; QuestIndex < Game->GetQuestCatalog()->Quests.Num(); QuestIndex++)
+	{
+		UFlareReplayQuest* Quest = NewObject<UFlareReplayQuest>(this, UFlareReplayQuest::StaticClass());
+		Quest->SetReference(Reference);
+		Quest->Load(&(Game->GetQuestCatalog()->Quests[QuestIndex]->Data));
+		Quest->SetStatus(EFlareQuestStatus::AVAILABLE);
+
+		ReplayQuests.Add(Quest);
+		AvailableQuests.Add(Quest);
+		LastStatus.Add(EFlareQuestStatus::AVAILABLE);
+		LastStepCount.Add(0);
+		LastStep.Add(NAME_None);
+	}
+}
+
+TArray<FString> UFlareQuestReplayManager::Replay(const TArray<FFlareQuestEvent>& Events)
+{
+	TArray<FString> Transitions;
+
+	// Quests without trigger start on load
+	for (int QuestIndex = 0; QuestIndex < ReplayQuests.Num(); QuestIndex++)
+	{
+		LoadCallbacks(ReplayQuests[QuestIndex]);
+		ReplayQuests[QuestIndex]->UpdateState();
+	}
+	AddTransitions(INDEX_NONE, Transitions);
+
+	for (int EventIndex = 0; EventIndex < Events.Num(); EventIndex++)
+	{
+		ReplayEvent(Events[EventIndex].Type, Events[EventIndex].Identifier);
+		AddTransitions(EventIndex, Transitions);
+	}
+
+	return Transitions;
+}
+
+bool UFlareQuestReplayManager::LoadEvents(const FString& Path, TArray<FFlareQuestEvent>& Events)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadANSITextFileToStrings(*Path, NULL, Lines))
+	{
+		return false;
+	}
+
+	Events.Empty();
+	for (int LineIndex = 0; LineIndex < Lines.Num(); LineIndex++)
+	{
+		FString Line = Lines[LineIndex].Trim().TrimTrailing();
+		FString TypeName = Line;
+		FString Identifier;
+		if (Line.IsEmpty())
+		{
+			continue;
+		}
+		Line.Split(" ", &TypeName, &Identifier);
+
+		int32 TypeIndex = INDEX_NONE;
+		for (int32 NameIndex = 0; NameIndex < ARRAY_COUNT(QuestEventNames); NameIndex++)
+		{
+			if (TypeName == QuestEventNames[NameIndex])
+			{
+				TypeIndex = NameIndex;
+			}
+		}
+
+		if (TypeIndex == INDEX_NONE)
+		{
+			FLOGV("UFlareQuestReplayManager::LoadEvents : unknown event '%s' at line %d of %s", *TypeName, LineIndex + 1, *Path);
+			return false;
+		}
+
+		FFlareQuestEvent Event;
+		Event.Type = (EFlareQuestCallback::Type) TypeIndex;
+		Event.Identifier = Identifier.IsEmpty() ? NAME_None : FName(*Identifier);
+		Events.Add(Event);
+	}
+
+	return true;
+}
+
+bool UFlareQuestReplayManager::SaveEvents(const FString& Path, const TArray<FFlareQuestEvent>& Events)
+{
+	FString Text;
+	for (int EventIndex = 0; EventIndex < Events.Num(); EventIndex++)
+	{
+		Text += QuestEventNames[Events[EventIndex].Type];
+		if (Events[EventIndex].Identifier != NAME_None)
+		{
+			Text += " " + Events[EventIndex].Identifier.ToString();
+		}
+		Text += LINE_TERMINATOR;
+	}
+
+	return FFileHelper::SaveStringToFile(Text, *Path);
+}
+
+void UFlareQuestReplayManager::ReplayEvent(EFlareQuestCallback::Type Type, FName Identifier)
+{
+	if (!Reference)
+	{
+		DispatchEvent(Type, Identifier);
+		return;
+	}
+
+	// Every quest waiting for this event type, whatever the identifier
+	TArray<UFlareQuest*> Quests;
+	for (TMap<UFlareQuest*, TArray<EFlareQuestCallback::Type> >::TIterator Iterator(ReferenceCallbacks); Iterator; ++Iterator)
+	{
+		if (Iterator.Value().Contains(Type))
+		{
+			Quests.Add(Iterator.Key());
+		}
+	}
+
+	for (int i = 0; i < Quests.Num(); i++)
+	{
+		Quests[i]->UpdateState();
+	}
+}
+
+void UFlareQuestReplayManager::AddTransitions(int32 EventIndex, TArray<FString>& Transitions)
+{
+	TArray<FString> EventTransitions;
+
+	for (int QuestIndex = 0; QuestIndex < ReplayQuests.Num(); QuestIndex++)
+	{
+		UFlareReplayQuest* Quest = ReplayQuests[QuestIndex];
+		FString QuestName = Quest->GetIdentifier().ToString();
+		FName Step = Quest->GetCurrentStepDescription() ? Quest->GetCurrentStepDescription()->Identifier : NAME_None;
+
+		if (Quest->GetStatus() != LastStatus[QuestIndex])
+		{
+			EventTransitions.Add(FString::Printf(TEXT("%s status %d"), *QuestName, (int32) (Quest->GetStatus() + 0)));
+		}
+		for (int StepIndex = LastStepCount[QuestIndex]; StepIndex < Quest->GetSuccessfulStepCount(); StepIndex++)
+		{
+			EventTransitions.Add(QuestName + " end " + Quest->GetSuccessfulStep(StepIndex).ToString());
+		}
+		if (Step != LastStep[QuestIndex] && Step != NAME_None)
+		{
+			EventTransitions.Add(QuestName + " begin " + Step.ToString());
+		}
+
+		LastStatus[QuestIndex] = Quest->GetStatus();
+		LastStepCount[QuestIndex] = Quest->GetSuccessfulStepCount();
+		LastStep[QuestIndex] = Step;
+	}
+
+	// Quests waiting for the same event may update in any order
+	EventTransitions.Sort();
+	for (int TransitionIndex = 0; TransitionIndex < EventTransitions.Num(); TransitionIndex++)
+	{
+		Transitions.Add(FString::Printf(TEXT("%d : %s"), EventIndex, *EventTransitions[TransitionIndex]));
+	}
+}
+
+
+/*----------------------------------------------------
+	Callbacks
+----------------------------------------------------*/
+
+void UFlareQuestReplayManager::LoadCallbacks(UFlareQuest* Quest)
+{
+	if (Reference)
+	{
+		ReferenceCallbacks.Add(Quest, Cast<UFlareReplayQuest>(Quest)->GetReferenceCallbacks());
+	}
+	else
+	{
+		Super::LoadCallbacks(Quest);
+	}
+}
+
+void UFlareQuestReplayManager::ClearCallbacks(UFlareQuest* Quest)
+{
+	if (Reference)
+	{
+		ReferenceCallbacks.Remove(Quest);
+	}
+	else
+	{
+		Super::ClearCallbacks(Quest);
+	}
+}
+
+void UFlareQuestReplayManager::OnQuestStatusChanged(UFlareQuest* Quest)
+{
+	LoadCallbacks(Quest);
+	ReplayEvent(EFlareQuestCallback::QUEST, Quest->GetIdentifier());
+}
+
+void UFlareQuestReplayManager::OnQuestSuccess(UFlareQuest* Quest)
+{
+	ActiveQuests.Remove(Quest);
+	OldQuests.Add(Quest);
+	OnQuestStatusChanged(Quest);
+}
+
+void UFlareQuestReplayManager::OnQuestFail(UFlareQuest* Quest)
+{
+	ActiveQuests.Remove(Quest);
+	OldQuests.Add(Quest);
+	OnQuestStatusChanged(Quest);
+}
+
+void UFlareQuestReplayManager::OnQuestActivation(UFlareQuest* Quest)
+{
+	AvailableQuests.Remove(Quest);
+	ActiveQuests.Add(Quest);
+	OnQuestStatusChanged(Quest);
+}
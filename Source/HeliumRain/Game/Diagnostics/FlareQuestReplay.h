@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../../Quests/FlareQuest.h"
+#include "../../Quests/FlareQuestManager.h"
+#include "FlareQuestReplay.generated.h"
+
+
+/** Quest replayed by the diagnostics, without actions, notifications or objectives */
+UCLASS()
+class HELIUMRAIN_API UFlareReplayQuest : public UFlareQuest
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	/** Use the recursive condition evaluation the quests had before compiled conditions */
+	void SetReference(bool NewReference);
+
+	virtual void UpdateState() override;
+
+	virtual void PerformActions(const TArray<FFlareQuestActionDescription>& Actions) override;
+
+	virtual void SendQuestNotification(FText Message, FName Tag) override;
+
+	virtual void StartObjectiveTracking() override;
+
+	virtual void StopObjectiveTracking() override;
+
+	virtual void UpdateObjectiveTracker() override;
+
+	/** Get the event types the quest waited for in its current state, before compiled conditions */
+	TArray<EFlareQuestCallback::Type> GetReferenceCallbacks();
+
+
+protected:
+
+	/** Add the event types of conditions, through the shared conditions */
+	void AddReferenceCallbacks(TArray<EFlareQuestCallback::Type>& Callbacks, const TArray<FFlareQuestConditionDescription>& Conditions);
+
+	bool                                     Reference;
+
+public:
+
+	inline int32 GetSuccessfulStepCount() const
+	{
+		return QuestData.SuccessfullSteps.Num();
+	}
+
+	inline FName GetSuccessfulStep(int32 Index) const
+	{
+		return QuestData.SuccessfullSteps[Index];
+	}
+
+};
+
+
+/** Quest manager replaying recorded events over fresh quests, and listing the transitions each event caused */
+UCLASS()
+class HELIUMRAIN_API UFlareQuestReplayManager : public UFlareQuestManager
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	/*----------------------------------------------------
+		Replay
+	----------------------------------------------------*/
+
+	/** Create every catalog quest as available. Reference quests use the former evaluation and dispatch. */
+	void Setup(AFlareGame* NewGame, bool NewReference);
+
+	/** Replay events, and get the sorted transitions of each event, prefixed with the event index */
+	TArray<FString> Replay(const TArray<FFlareQuestEvent>& Events);
+
+	/** Read an event file, one "TYPE identifier" line per event */
+	static bool LoadEvents(const FString& Path, TArray<FFlareQuestEvent>& Events);
+
+	/** Write an event file */
+	static bool SaveEvents(const FString& Path, const TArray<FFlareQuestEvent>& Events);
+
+
+	/*----------------------------------------------------
+		Callbacks
+	----------------------------------------------------*/
+
+	virtual void LoadCallbacks(UFlareQuest* Quest) override;
+
+	virtual void ClearCallbacks(UFlareQuest* Quest) override;
+
+	virtual void OnQuestStatusChanged(UFlareQuest* Quest) override;
+
+	virtual void OnQuestSuccess(UFlareQuest* Quest) override;
+
+	virtual void OnQuestFail(UFlareQuest* Quest) override;
+
+	virtual void OnQuestActivation(UFlareQuest* Quest) override;
+
+
+protected:
+
+	/** Send an event to the quests, with the current or the former dispatch */
+	void ReplayEvent(EFlareQuestCallback::Type Type, FName Identifier);
+
+	/** Add the transitions since the last state of the quests */
+	void AddTransitions(int32 EventIndex, TArray<FString>& Transitions);
+
+
+	/*----------------------------------------------------
+		Data
+	----------------------------------------------------*/
+
+	UPROPERTY()
+	TArray<UFlareReplayQuest*>               ReplayQuests;
+
+	// State of each replay quest after the last event
+	TArray<EFlareQuestStatus::Type>          LastStatus;
+	TArray<int32>                            LastStepCount;
+	TArray<FName>                            LastStep;
+
+	// Former dispatch, by event type only
+	bool                                     Reference;
+	TMap<UFlareQuest*, TArray<EFlareQuestCallback::Type> > ReferenceCallbacks;
+
+};
@@ -0,0 +1,66 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Quests/FlareQuest.h"
+
+
+/** Save and restore quest step progress with colliding condition names */
+static bool CheckQuestStepProgress(AFlareGame* Game, int32 Count)
+{
+	// A type key, an explicit identifier saved under the same name, and a plain explicit identifier
+	FFlareQuestConditionDescription Waypoints;
+	Waypoints.Type = EFlareQuestCondition::SHIP_FOLLOW_RELATIVE_WAYPOINTS;
+	Waypoints.ConditionIdentifier = NAME_None;
+
+	FFlareQuestConditionDescription MinVelocity;
+	MinVelocity.Type = EFlareQuestCondition::SHIP_MIN_COLLINEAR_VELOCITY;
+	MinVelocity.ConditionIdentifier = FName(*FString::FromInt(EFlareQuestCondition::SHIP_FOLLOW_RELATIVE_WAYPOINTS));
+
+	FFlareQuestConditionDescription MaxVelocity;
+	MaxVelocity.Type = EFlareQuestCondition::SHIP_MAX_COLLINEAR_VELOCITY;
+	MaxVelocity.ConditionIdentifier = FName("max-velocity");
+
+	TArray<const FFlareQuestConditionDescription*> Conditions;
+	Conditions.Add(&Waypoints);
+	Conditions.Add(&MinVelocity);
+	Conditions.Add(&MaxVelocity);
+
+	FFlareQuestConditionKey WaypointsKey(&Waypoints);
+	FFlareQuestConditionKey MinVelocityKey(&MinVelocity);
+	FFlareQuestConditionKey MaxVelocityKey(&MaxVelocity);
+	FTransform Transform(FRotator(10, 20, 30), FVector(100, 200, 300));
+
+	// Colliding names are different keys
+	FFlareQuestStepProgress Progress;
+	Progress.SetCounter(WaypointsKey, 3);
+	Progress.SetInitialTransform(WaypointsKey, Transform);
+	Progress.SetInitialVelocity(MinVelocityKey, 12.5);
+	Progress.SetInitialVelocity(MaxVelocityKey, -4);
+	bool KeySuccess = (Progress.Num() == 3 && Progress.GetCounter(MinVelocityKey) == 0 && Progress.GetInitialVelocity(WaypointsKey) == 0);
+
+	// Round trip with both colliding conditions
+	TArray<FFlareQuestStepProgressSave> Data;
+	Progress.Save(Data);
+	FFlareQuestStepProgress Restored;
+	Restored.Restore(Data, Conditions);
+	bool RoundTripSuccess = (Restored.Num() == 3
+		&& Restored.GetCounter(WaypointsKey) == 3
+		&& Restored.GetInitialTransform(WaypointsKey).Equals(Transform)
+		&& Restored.GetInitialVelocity(MinVelocityKey) == 12.5
+		&& Restored.GetInitialVelocity(MaxVelocityKey) == -4);
+
+	// Round trip with only the explicit identifier
+	FFlareQuestStepProgress ExplicitProgress;
+	ExplicitProgress.SetInitialVelocity(MinVelocityKey, 7);
+	ExplicitProgress.Save(Data);
+	Restored.Restore(Data, Conditions);
+	bool ExplicitSuccess = (Restored.Num() == 1 && Restored.Contains(MinVelocityKey) && Restored.GetInitialVelocity(MinVelocityKey) == 7);
+
+	bool Success = KeySuccess && RoundTripSuccess && ExplicitSuccess;
+	FLOGV("FlareDiagnostics::CheckQuestStepProgress : keys %d, round trip %d, explicit round trip %d : %s",
+		KeySuccess, RoundTripSuccess, ExplicitSuccess, Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(QuestStepProgress, CheckQuestStepProgress, 0, false)
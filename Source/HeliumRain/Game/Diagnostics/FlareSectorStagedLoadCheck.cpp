@@ -0,0 +1,168 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../../Player/FlarePlayerController.h"
+
+
+/** Get the spawned spacecraft locations of the active sector by immatriculation */
+static TMap<FName, FVector> GetActiveSectorSpacecraftLocations(UFlareSector* Sector)
+{
+	TMap<FName, FVector> Locations;
+	for (int32 Index = 0; Index < Sector->GetSpacecrafts().Num(); Index++)
+	{
+		AFlareSpacecraft* Spacecraft = Sector->GetSpacecrafts()[Index];
+		Locations.Add(Spacecraft->GetImmatriculation(), Spacecraft->GetActorLocation());
+	}
+	return Locations;
+}
+
+/** Activate the current sector on a copy of the game with the player ship arriving by travel. It must spawn in the first step, after the bodies near it, and clear of all of them */
+static bool CheckSectorTravelArrival(AFlareGame* Game)
+{
+	bool SectorActive;
+	int32 PlayerSlot = FlareDiagnostics::LoadGameCopy(Game, TEXT("CheckSectorStagedLoad"), SectorActive);
+	if (PlayerSlot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	UFlareSimulatedSpacecraft* PlayerShip = Game->GetPC()->GetPlayerShip();
+	UFlareSimulatedSector* SimulatedSector = PlayerShip->GetCurrentSector();
+	PlayerShip->ForceUndock();
+	PlayerShip->SetSpawnMode(EFlareSpawnMode::Travel);
+
+	// First step
+	Game->ActivateCurrentSector(true);
+	UFlareSector* Sector = Game->GetActiveSector();
+	bool PlayerShipFirst = PlayerShip->IsActive();
+	int32 FirstStepCount = Sector->GetSpacecrafts().Num();
+	int32 MissingNearbyCount = 0;
+	FVector PlayerLocation = FVector::ZeroVector;
+
+	// The bodies around the arrived ship must be there already
+	if (PlayerShipFirst)
+	{
+		PlayerLocation = PlayerShip->GetActive()->GetActorLocation();
+		float NearbyDistance = SECTOR_LOAD_NEARBY_DISTANCE / 2;
+
+		for (int32 Index = 0; Index < SimulatedSector->GetSectorSpacecrafts().Num(); Index++)
+		{
+			UFlareSimulatedSpacecraft* Spacecraft = SimulatedSector->GetSectorSpacecrafts()[Index];
+			if (!Spacecraft->IsActive() && Spacecraft->GetData().SpawnMode == EFlareSpawnMode::Safe
+				&& FVector::Dist(Spacecraft->GetData().Location, PlayerLocation) < NearbyDistance)
+			{
+				FLOGV("FlareDiagnostics::CheckSectorStagedLoad : %s is near the arrival but not spawned", *Spacecraft->GetImmatriculation().ToString());
+				MissingNearbyCount++;
+			}
+		}
+
+		int32 NearbyAsteroidCount = 0;
+		const TArray<FFlareAsteroidSave>& AsteroidData = SimulatedSector->GetData()->AsteroidData;
+		for (int32 Index = 0; Index < AsteroidData.Num(); Index++)
+		{
+			NearbyAsteroidCount += (FVector::Dist(AsteroidData[Index].Location, PlayerLocation) < NearbyDistance) ? 1 : 0;
+		}
+		for (int32 Index = 0; Index < Sector->GetAsteroids().Num(); Index++)
+		{
+			NearbyAsteroidCount -= (FVector::Dist(Sector->GetAsteroids()[Index]->GetActorLocation(), PlayerLocation) < NearbyDistance) ? 1 : 0;
+		}
+		MissingNearbyCount += FMath::Max(NearbyAsteroidCount, 0);
+	}
+
+	// Once loaded, nothing overlaps the arrived ship
+	while (!Sector->LoadStep(0))
+	{
+	}
+	Game->OnSectorLoaded();
+
+	bool Clear = false;
+	if (PlayerShipFirst)
+	{
+		float NearestDistance;
+		AFlareSpacecraft* PlayerSpacecraft = PlayerShip->GetActive();
+		Clear = (Sector->GetNearestBody(PlayerLocation, &NearestDistance, true, PlayerSpacecraft) == NULL
+			|| NearestDistance - PlayerSpacecraft->GetMeshScale() > 0);
+	}
+
+	bool Success = PlayerShipFirst && MissingNearbyCount == 0 && Clear;
+	FLOGV("FlareDiagnostics::CheckSectorStagedLoad : travel arrival, %d/%d spacecrafts in the first step, %d nearby bodies missing, clear %d : %s",
+		FirstStepCount, Sector->GetSpacecrafts().Num(), MissingNearbyCount, Clear,
+		Success ? TEXT("passed") : TEXT("FAILED"));
+
+	FlareDiagnostics::RestoreGameCopy(Game, PlayerSlot, SectorActive);
+	return Success;
+}
+
+/** Activate the current sector synchronously then one actor per frame, and compare the spawned actors. Then check the staged load of a player ship arriving by travel on a copy of the game */
+static bool CheckSectorStagedLoad(AFlareGame* Game, int32 Count)
+{
+	if (!Game->GetActiveSector())
+	{
+		FLOG("FlareDiagnostics::CheckSectorStagedLoad failed: no active sector");
+		return false;
+	}
+
+	// Reference synchronous activation
+	Game->DeactivateSector();
+	Game->ActivateCurrentSector(false);
+	TMap<FName, FVector> FullLocations = GetActiveSectorSpacecraftLocations(Game->GetActiveSector());
+	int32 FullAsteroidCount = Game->GetActiveSector()->GetAsteroids().Num();
+	int32 FullBombCount = Game->GetActiveSector()->GetBombs().Num();
+
+	// Staged activation, one actor per step
+	Game->DeactivateSector();
+	Game->ActivateCurrentSector(true);
+	bool PlayerShipFirst = Game->GetPC()->GetPlayerShip()->IsActive();
+	int32 StepCount = 1;
+	if (Game->IsSectorLoading())
+	{
+		while (!Game->GetActiveSector()->LoadStep(SMALL_NUMBER))
+		{
+			StepCount++;
+		}
+		Game->OnSectorLoaded();
+	}
+	TMap<FName, FVector> StagedLocations = GetActiveSectorSpacecraftLocations(Game->GetActiveSector());
+
+	// Compare the spawned spacecrafts, placed ones may differ in location only
+	int32 MissingCount = 0;
+	int32 MovedCount = 0;
+	for (auto& Entry : FullLocations)
+	{
+		FVector* StagedLocation = StagedLocations.Find(Entry.Key);
+		if (!StagedLocation)
+		{
+			FLOGV("FlareDiagnostics::CheckSectorStagedLoad : %s is missing", *Entry.Key.ToString());
+			MissingCount++;
+		}
+		else
+		{
+			UFlareSimulatedSpacecraft* Spacecraft = Game->GetGameWorld()->FindSpacecraft(Entry.Key);
+			if (Spacecraft && (Spacecraft->IsStation() || Spacecraft->GetData().SpawnMode == EFlareSpawnMode::Safe)
+				&& !StagedLocation->Equals(Entry.Value, 1.f))
+			{
+				FLOGV("FlareDiagnostics::CheckSectorStagedLoad : %s moved", *Entry.Key.ToString());
+				MovedCount++;
+			}
+		}
+	}
+
+	bool Success = PlayerShipFirst
+		&& MissingCount == 0 && MovedCount == 0
+		&& FullLocations.Num() == StagedLocations.Num()
+		&& FullAsteroidCount == Game->GetActiveSector()->GetAsteroids().Num()
+		&& FullBombCount == Game->GetActiveSector()->GetBombs().Num();
+
+	FLOGV("FlareDiagnostics::CheckSectorStagedLoad : %d steps, %d/%d spacecrafts, %d/%d asteroids, %d/%d bombs, player ship first %d : %s",
+		StepCount,
+		StagedLocations.Num(), FullLocations.Num(),
+		Game->GetActiveSector()->GetAsteroids().Num(), FullAsteroidCount,
+		Game->GetActiveSector()->GetBombs().Num(), FullBombCount,
+		PlayerShipFirst,
+		Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return CheckSectorTravelArrival(Game) && Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(SectorStagedLoad, CheckSectorStagedLoad, 0, true)
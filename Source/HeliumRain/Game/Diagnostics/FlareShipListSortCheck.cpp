@@ -0,0 +1,243 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../FlareCompany.h"
+#include "../../Spacecrafts/Subsystems/FlareSpacecraftWeaponsSystem.h"
+#include "../../Spacecrafts/Subsystems/FlareSimulatedSpacecraftWeaponsSystem.h"
+#include "../../UI/Components/FlareShipList.h"
+
+
+/** Random ship list entry, with the order the keys must follow */
+struct ShipListSortEntry
+{
+	uint8 Group;
+	uint64 Value;
+	uint32 Serial;
+};
+
+/** Check that keys are sorted, that each entry order follows its group and value, and count the errors */
+static int32 CheckShipListOrder(const TArray<FFlareShipListKey>& Keys, const TArray<int32>& Entries, const TArray<ShipListSortEntry>& Data, bool Descending)
+{
+	int32 ErrorCount = 0;
+
+	for (int32 Index = 0; Index < Keys.Num(); Index++)
+	{
+		const ShipListSortEntry& Entry = Data[Entries[Index]];
+		if (Keys[Index].Key != FFlareShipListKey::Encode(Entry.Group, Entry.Value, Descending) || Keys[Index].Serial != Entry.Serial)
+		{
+			ErrorCount++;
+		}
+
+		if (Index > 0)
+		{
+			const ShipListSortEntry& Previous = Data[Entries[Index - 1]];
+			bool Ordered = (Previous.Group < Entry.Group)
+				|| (Previous.Group == Entry.Group && (Descending ? Previous.Value > Entry.Value : Previous.Value < Entry.Value))
+				|| (Previous.Group == Entry.Group && Previous.Value == Entry.Value && Previous.Serial < Entry.Serial);
+			if (!Ordered)
+			{
+				ErrorCount++;
+			}
+		}
+	}
+
+	return ErrorCount;
+}
+
+/** Size order of the ship lists before the sort keys, entries first in the list are larger */
+static bool IsShipListLargerReference(const FInterfaceContainer* PtrA, const FInterfaceContainer* PtrB)
+{
+	UFlareSimulatedSpacecraft* A = PtrA->ShipInterfacePtr;
+	UFlareSimulatedSpacecraft* B = PtrB->ShipInterfacePtr;
+
+	if (PtrA->FleetPtr)
+	{
+		if (PtrB->FleetPtr)
+		{
+			return (PtrA->FleetPtr->GetShips().Num() > PtrB->FleetPtr->GetShips().Num());
+		}
+		else
+		{
+			return true;
+		}
+	}
+	else if (PtrB->FleetPtr)
+	{
+		return false;
+	}
+
+	if (A->IsStation())
+	{
+		return true;
+	}
+	else if (B->IsStation())
+	{
+		return false;
+	}
+	else
+	{
+		if (A->GetSize() > B->GetSize())
+		{
+			return true;
+		}
+		else if (A->GetSize() < B->GetSize())
+		{
+			return false;
+		}
+		else if (A->IsMilitary())
+		{
+			if (!B->IsMilitary())
+			{
+				return true;
+			}
+			else
+			{
+				return A->GetWeaponsSystem()->GetWeaponGroupCount() > B->GetWeaponsSystem()->GetWeaponGroupCount();
+			}
+		}
+		else
+		{
+			return false;
+		}
+	}
+}
+
+/** Sort the fleets, stations and ships of the world by size keys, and count the neighbours the reference order disagrees with */
+static int32 CheckShipListSizeOrder(UFlareWorld* World, int32& EntryCount)
+{
+	TArray<TSharedPtr<FInterfaceContainer> > Items;
+	for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num(); CompanyIndex++)
+	{
+		UFlareCompany* Company = World->GetCompanies()[CompanyIndex];
+		for (int32 Index = 0; Index < Company->GetCompanyFleets().Num(); Index++)
+		{
+			Items.Add(FInterfaceContainer::New(Company->GetCompanyFleets()[Index]));
+		}
+		for (int32 Index = 0; Index < Company->GetCompanyStations().Num(); Index++)
+		{
+			Items.Add(FInterfaceContainer::New(Company->GetCompanyStations()[Index]));
+		}
+		for (int32 Index = 0; Index < Company->GetCompanyShips().Num(); Index++)
+		{
+			Items.Add(FInterfaceContainer::New(Company->GetCompanyShips()[Index]));
+		}
+	}
+
+	TMap<UFlareSimulatedSector*, int32> SectorRanks;
+	TArray<FFlareShipListKey> Keys;
+	for (int32 Index = 0; Index < Items.Num(); Index++)
+	{
+		Keys.Add({SFlareShipList::ComputeSortKey(Items[Index].Get(), EFlareShipListSort::Size, SectorRanks), (uint32) Index});
+	}
+	SFlareShipList::SortByKeys(Keys, Items);
+	EntryCount += Items.Num();
+
+	// The reference has no order between stations, and must agree with the keys everywhere else
+	int32 ErrorCount = 0;
+	for (int32 Index = 1; Index < Items.Num(); Index++)
+	{
+		const FInterfaceContainer* Previous = Items[Index - 1].Get();
+		const FInterfaceContainer* Current = Items[Index].Get();
+		if (Previous->ShipInterfacePtr && Previous->ShipInterfacePtr->IsStation() && Current->ShipInterfacePtr && Current->ShipInterfacePtr->IsStation())
+		{
+			continue;
+		}
+
+		bool SameKey = (Keys[Index - 1].Key == Keys[Index].Key);
+		bool ReferenceLarger = IsShipListLargerReference(Previous, Current);
+		bool ReferenceSmaller = IsShipListLargerReference(Current, Previous);
+		if (ReferenceSmaller || ReferenceLarger == SameKey)
+		{
+			ErrorCount++;
+		}
+	}
+
+	return ErrorCount;
+}
+
+/** Compare the ship list sort keys with the expected order on random entries, for full sorts and incremental updates, and with the former size comparator on the game entries */
+static bool CheckShipListSort(AFlareGame* Game, int32 EntryCount)
+{
+	FRandomStream Random(42);
+	int32 ErrorCount = 0;
+	double SortTime = 0;
+	double InsertTime = 0;
+
+	for (int32 OrderIndex = 0; OrderIndex < 2; OrderIndex++)
+	{
+		bool Descending = (OrderIndex == 0);
+
+		// Random entries, with many identical values
+		TArray<ShipListSortEntry> Data;
+		for (int32 Index = 0; Index < EntryCount; Index++)
+		{
+			ShipListSortEntry Entry;
+			Entry.Group = Random.RandRange(0, 3);
+			Entry.Value = (Random.RandRange(0, 1) == 0) ? Random.RandRange(0, 10) : ((uint64) Random.RandRange(0, MAX_int32) << 20);
+			Entry.Serial = Index;
+			Data.Add(Entry);
+		}
+
+		// Full sort
+		TArray<FFlareShipListKey> Keys;
+		TArray<int32> Entries;
+		for (int32 Index = 0; Index < Data.Num(); Index++)
+		{
+			Keys.Add({FFlareShipListKey::Encode(Data[Index].Group, Data[Index].Value, Descending), Data[Index].Serial});
+			Entries.Add(Index);
+		}
+
+		double StartTime = FPlatformTime::Seconds();
+		SFlareShipList::SortByKeys(Keys, Entries);
+		SortTime += FPlatformTime::Seconds() - StartTime;
+		ErrorCount += CheckShipListOrder(Keys, Entries, Data, Descending);
+
+		// Incremental inserts
+		TArray<FFlareShipListKey> InsertedKeys;
+		TArray<int32> InsertedEntries;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Data.Num(); Index++)
+		{
+			FFlareShipListKey Key = {FFlareShipListKey::Encode(Data[Index].Group, Data[Index].Value, Descending), Data[Index].Serial};
+			int32 InsertIndex = SFlareShipList::FindSortedIndex(InsertedKeys, Key);
+			InsertedKeys.Insert(Key, InsertIndex);
+			InsertedEntries.Insert(Index, InsertIndex);
+		}
+		InsertTime += FPlatformTime::Seconds() - StartTime;
+		ErrorCount += CheckShipListOrder(InsertedKeys, InsertedEntries, Data, Descending);
+
+		// Both must give the same list
+		if (InsertedEntries != Entries)
+		{
+			ErrorCount++;
+		}
+
+		// Removals keep the order
+		for (int32 Index = InsertedEntries.Num() - 1; Index >= 0; Index -= Random.RandRange(1, 4))
+		{
+			InsertedKeys.RemoveAt(Index);
+			InsertedEntries.RemoveAt(Index);
+		}
+		ErrorCount += CheckShipListOrder(InsertedKeys, InsertedEntries, Data, Descending);
+	}
+
+	// Size keys of the game entries against the former comparator
+	int32 GameEntryCount = 0;
+	int32 GameErrorCount = 0;
+	if (Game->GetGameWorld())
+	{
+		GameErrorCount = CheckShipListSizeOrder(Game->GetGameWorld(), GameEntryCount);
+		ErrorCount += GameErrorCount;
+	}
+
+	FLOGV("FlareDiagnostics::CheckShipListSort : %d game entries, %d disagree with the former size order",
+		GameEntryCount, GameErrorCount);
+	FLOGV("FlareDiagnostics::CheckShipListSort : %d entries, sort %.2fms, inserts %.2fms, %d errors : %s",
+		EntryCount, SortTime * 1000, InsertTime * 1000, ErrorCount,
+		ErrorCount == 0 ? TEXT("passed") : TEXT("FAILED"));
+
+	return ErrorCount == 0;
+}
+
+FLARE_DIAGNOSTICS_CHECK(ShipListSort, CheckShipListSort, 10000, false)
@@ -0,0 +1,112 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+
+
+/** Price of a spacecraft from the resource prices, as computed before the price book */
+static int64 ComputeReferenceSpacecraftPrice(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* Desc, bool WithMargin, bool ConstructionPrice)
+{
+	int64 Cost = Desc->CycleCost.ProductionCost;
+
+	if (Desc->IsStation() && ConstructionPrice)
+	{
+		Cost = Sector->GetStationConstructionFee(Cost);
+	}
+
+	for (int ResourceIndex = 0; ResourceIndex < Desc->CycleCost.InputResources.Num(); ResourceIndex++)
+	{
+		FFlareFactoryResource* Resource = &Desc->CycleCost.InputResources[ResourceIndex];
+		Cost += Resource->Quantity * Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::Default);
+	}
+
+	for (int ResourceIndex = 0; ResourceIndex < Desc->CycleCost.OutputResources.Num(); ResourceIndex++)
+	{
+		FFlareFactoryResource* Resource = &Desc->CycleCost.OutputResources[ResourceIndex];
+		Cost -= Resource->Quantity * Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::Default);
+	}
+
+	return FMath::Max((int64) 0, Cost) * (WithMargin ? 1.2f : 1.0f);
+}
+
+/** Compare the four price variants of every spacecraft in a sector with the reference, and return the number of mismatches */
+static int32 CheckSectorSpacecraftPrices(AFlareGame* Game, UFlareSimulatedSector* Sector)
+{
+	UFlareSpacecraftCatalog* SpacecraftCatalog = Game->GetSpacecraftCatalog();
+	int32 MismatchCount = 0;
+
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < SpacecraftCatalog->GetSpacecraftCount(); SpacecraftIndex++)
+	{
+		FFlareSpacecraftDescription* Desc = SpacecraftCatalog->GetSpacecraft(SpacecraftIndex);
+
+		for (int32 Variant = 0; Variant < 4; Variant++)
+		{
+			bool WithMargin = (Variant & 1) != 0;
+			bool ConstructionPrice = (Variant & 2) != 0;
+			int64 ExpectedPrice = ComputeReferenceSpacecraftPrice(Sector, Desc, WithMargin, ConstructionPrice);
+			int64 Price = Sector->GetSpacecraftPrice(Desc, WithMargin, ConstructionPrice);
+
+			if (Price != ExpectedPrice)
+			{
+				FLOGV("FlareDiagnostics::CheckSpacecraftPrices : %s in %s (margin %d, fee %d) costs %lld, expected %lld",
+					*Desc->Identifier.ToString(), *Sector->GetSectorName().ToString(), WithMargin, ConstructionPrice, Price, ExpectedPrice);
+				MismatchCount++;
+			}
+		}
+	}
+
+	return MismatchCount;
+}
+
+/** Simulate days and compare every price variant of the sector price books with a full recompute, with seeded price changes */
+static bool CheckSpacecraftPrices(AFlareGame* Game, int32 DayCount)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckSpacecraftPrices failed: no loaded world");
+		return false;
+	}
+
+	if (Game->GetActiveSector())
+	{
+		FLOG("FlareDiagnostics::CheckSpacecraftPrices failed: a sector is active");
+		return false;
+	}
+
+	UFlareWorld* World = Game->GetGameWorld();
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	FRandomStream Random(42);
+	int32 MismatchCount = 0;
+	int32 ChangeCount = 0;
+
+	for (int32 Day = 0; Day <= DayCount; Day++)
+	{
+		if (Day > 0)
+		{
+			World->Simulate();
+		}
+
+		for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+		{
+			UFlareSimulatedSector* Sector = World->GetSectors()[SectorIndex];
+			MismatchCount += CheckSectorSpacecraftPrices(Game, Sector);
+
+			// Change a single price mid-day, and check only its dependencies were invalidated correctly
+			FFlareResourceDescription* Resource = &ResourceCatalog->Resources[Random.RandRange(0, ResourceCatalog->Resources.Num() - 1)]->Data;
+			float OldPrice = Sector->GetPreciseResourcePrice(Resource);
+			Sector->SetPreciseResourcePrice(Resource, OldPrice * Random.FRandRange(0.5f, 1.5f));
+			MismatchCount += CheckSectorSpacecraftPrices(Game, Sector);
+			Sector->SetPreciseResourcePrice(Resource, OldPrice);
+			MismatchCount += CheckSectorSpacecraftPrices(Game, Sector);
+			ChangeCount++;
+		}
+	}
+
+	bool Success = MismatchCount == 0;
+	FLOGV("FlareDiagnostics::CheckSpacecraftPrices : %d days, %d sectors, %d price changes, %d mismatches : %s",
+		DayCount, World->GetSectors().Num(), ChangeCount, MismatchCount, Success ? TEXT("passed") : TEXT("FAILED"));
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(SpacecraftPrices, CheckSpacecraftPrices, 30, false)
@@ -0,0 +1,236 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareThermalSystem.h"
+
+
+/** Heat definition of a ship, as read by Tools/heatcalculator.py */
+struct FFlareHeatCalculatorShip
+{
+	FString Name;
+	float HeatCapacity;
+	float MinHeatsinkRatio;
+	float MaxHeatsink;
+	float MinHeatsink;
+	float PassivePower;
+	float ActivePower;
+	float BoostingPower;
+	float FiringPower;
+
+	FFlareHeatCalculatorShip()
+		: HeatCapacity(0)
+		, MinHeatsinkRatio(0)
+		, MaxHeatsink(0)
+		, MinHeatsink(0)
+		, PassivePower(0)
+		, ActivePower(0)
+		, BoostingPower(0)
+		, FiringPower(0)
+	{}
+};
+
+/** Add the values of a ship file section, multiplied by its component count */
+static void AddHeatCalculatorSection(FFlareHeatCalculatorShip& Ship, const TMap<FString, FString>& Values)
+{
+	float Count = Values.Contains("count") ? FCString::Atof(*Values["count"]) : 1.f;
+
+	for (auto& Entry : Values)
+	{
+		float Value = FCString::Atof(*Entry.Value);
+		if (Entry.Key == "shipname")
+		{
+			Ship.Name = Entry.Value;
+		}
+		else if (Entry.Key == "minheatsinkratio")
+		{
+			Ship.MinHeatsinkRatio = Value;
+		}
+		else if (Entry.Key == "heatcapacity")
+		{
+			Ship.HeatCapacity += Count * Value;
+		}
+		else if (Entry.Key == "maxheatsink")
+		{
+			Ship.MaxHeatsink += Count * Value;
+		}
+		else if (Entry.Key == "passivepower")
+		{
+			Ship.PassivePower += Count * Value;
+		}
+		else if (Entry.Key == "activepower")
+		{
+			Ship.ActivePower += Count * Value;
+		}
+		else if (Entry.Key == "boostingpower")
+		{
+			Ship.BoostingPower += Count * Value;
+		}
+		else if (Entry.Key == "firingpower")
+		{
+			Ship.FiringPower += Count * Value;
+		}
+	}
+}
+
+/** Read a ship file of Tools/heatcalculator.py */
+static bool LoadHeatCalculatorShip(const FString& Path, FFlareHeatCalculatorShip& Ship)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadANSITextFileToStrings(*Path, NULL, Lines))
+	{
+		return false;
+	}
+
+	TMap<FString, FString> Values;
+	for (int32 LineIndex = 0; LineIndex < Lines.Num(); LineIndex++)
+	{
+		FString Line = Lines[LineIndex].Trim().TrimTrailing();
+		FString Key;
+		FString Value;
+
+		if (Line.StartsWith("["))
+		{
+			AddHeatCalculatorSection(Ship, Values);
+			Values.Empty();
+		}
+		else if (Line.Split("=", &Key, &Value))
+		{
+			Values.Add(Key.Trim().TrimTrailing().ToLower(), Value.Trim().TrimTrailing());
+		}
+	}
+	AddHeatCalculatorSection(Ship, Values);
+
+	// The minimum heat sink only depends on the ratio
+	Ship.MinHeatsink = Ship.MaxHeatsink * Ship.MinHeatsinkRatio;
+	return (Ship.HeatCapacity > 0 && Ship.MaxHeatsink > 0);
+}
+
+/** Simulate the fixed steps until the temperature settles */
+static float SimulateEquilibriumTemperature(float HeatCapacity, float HeatProduction, float HeatSinkSurface)
+{
+	float Heat = 0;
+	float Temperature = 0;
+	for (int32 StepIndex = 0; StepIndex < 5000000; StepIndex++)
+	{
+		Heat = UFlareThermalSystem::AdvanceHeat(Heat, HeatCapacity, HeatProduction, HeatSinkSurface, THERMAL_STEP_DURATION);
+
+		float NewTemperature = Heat / HeatCapacity;
+		if (StepIndex > 10 && FMath::Abs(NewTemperature - Temperature) < 1e-3 * THERMAL_STEP_DURATION)
+		{
+			return NewTemperature;
+		}
+		Temperature = NewTemperature;
+	}
+	return Temperature;
+}
+
+/** Compare the thermal model equilibrium with the ship files of Tools/heatcalculator.py, and its steps at several frame rates */
+static bool CheckThermalModel(AFlareGame* Game, int32 Count)
+{
+	// Same usage as Tools/heatcalculator.py
+	const float ActiveMaxUsage = 0.26;
+	const double StefanBoltzmann = 5.670373e-8;
+
+	TArray<FString> ShipFiles;
+	FString ToolsDir = FPaths::GameDir() / TEXT("Tools");
+	IFileManager::Get().FindFiles(ShipFiles, *(ToolsDir / TEXT("*.ship")), true, false);
+	if (ShipFiles.Num() == 0)
+	{
+		FLOGV("FlareDiagnostics::CheckThermalModel failed: no ship file in '%s'", *ToolsDir);
+		return false;
+	}
+
+	// Equilibrium temperatures of the fixed-step model against the closed form of the tool
+	int32 CaseCount = 0;
+	int32 FailureCount = 0;
+	for (int32 FileIndex = 0; FileIndex < ShipFiles.Num(); FileIndex++)
+	{
+		FFlareHeatCalculatorShip Ship;
+		if (!LoadHeatCalculatorShip(ToolsDir / ShipFiles[FileIndex], Ship))
+		{
+			FLOGV("FlareDiagnostics::CheckThermalModel : can't read '%s'", *ShipFiles[FileIndex]);
+			FailureCount++;
+			continue;
+		}
+
+		for (int32 HeatsinkIndex = 0; HeatsinkIndex < 2; HeatsinkIndex++)
+		{
+			float Surface = (HeatsinkIndex == 0) ? Ship.MaxHeatsink : Ship.MinHeatsink;
+			float SolarPower = Surface * THERMAL_SOLAR_POWER * 0.5;
+			float Productions[] = {
+				Ship.PassivePower + SolarPower,
+				Ship.PassivePower + Ship.ActivePower * ActiveMaxUsage + SolarPower,
+				Ship.PassivePower + Ship.ActivePower * ActiveMaxUsage + Ship.BoostingPower + SolarPower,
+				Ship.PassivePower + Ship.FiringPower + SolarPower,
+				Ship.PassivePower + Ship.ActivePower * ActiveMaxUsage + Ship.BoostingPower + Ship.FiringPower + SolarPower
+			};
+			const TCHAR* ModeNames[] = { TEXT("passive"), TEXT("active"), TEXT("boosting"), TEXT("firing"), TEXT("all") };
+
+			for (int32 ModeIndex = 0; ModeIndex < 5; ModeIndex++)
+			{
+				double Expected = FMath::Pow(1000 * Productions[ModeIndex] / (Surface * StefanBoltzmann), 0.25);
+				float Equilibrium = UFlareThermalSystem::ComputeEquilibriumTemperature(Productions[ModeIndex], Surface);
+				float Simulated = SimulateEquilibriumTemperature(Ship.HeatCapacity, Productions[ModeIndex], Surface);
+
+				bool Success = FMath::Abs(Equilibrium - Expected) < 0.001 * Expected && FMath::Abs(Simulated - Expected) < 0.01 * Expected;
+				FLOGV("FlareDiagnostics::CheckThermalModel : %s %s heatsink %s : expected %f, equilibrium %f, simulated %f",
+					*Ship.Name, (HeatsinkIndex == 0) ? TEXT("max") : TEXT("min"), ModeNames[ModeIndex], Expected, Equilibrium, Simulated);
+
+				CaseCount++;
+				FailureCount += Success ? 0 : 1;
+			}
+		}
+	}
+
+	// Same heat after a minute at different frame rates, including frames longer than the step budget
+	float FrameRates[] = { 30.f, 60.f, 144.f, 17.f, 0.5f };
+	float ReferenceHeat = -1;
+	int32 ReferenceStepCount = -1;
+	bool Deterministic = true;
+	for (int32 RateIndex = 0; RateIndex < ARRAY_COUNT(FrameRates); RateIndex++)
+	{
+		double Accumulator = 0;
+		float Heat = 0;
+		int32 StepCount = 0;
+		int32 FrameCount = FMath::RoundToInt(60.025f * FrameRates[RateIndex]);
+		for (int32 FrameIndex = 0; FrameIndex < FrameCount; FrameIndex++)
+		{
+			int32 FrameSteps = UFlareThermalSystem::ConsumeSteps(Accumulator, 60.025f / FrameCount);
+			for (int32 StepIndex = 0; StepIndex < FrameSteps; StepIndex++)
+			{
+				Heat = UFlareThermalSystem::AdvanceHeat(Heat, 13, 1646, 16, THERMAL_STEP_DURATION);
+			}
+			StepCount += FrameSteps;
+		}
+
+		// Catch up with the late steps
+		for (int32 FrameSteps = UFlareThermalSystem::ConsumeSteps(Accumulator, 0); FrameSteps > 0; FrameSteps = UFlareThermalSystem::ConsumeSteps(Accumulator, 0))
+		{
+			for (int32 StepIndex = 0; StepIndex < FrameSteps; StepIndex++)
+			{
+				Heat = UFlareThermalSystem::AdvanceHeat(Heat, 13, 1646, 16, THERMAL_STEP_DURATION);
+			}
+			StepCount += FrameSteps;
+		}
+
+		if (RateIndex == 0)
+		{
+			ReferenceHeat = Heat;
+			ReferenceStepCount = StepCount;
+		}
+		else if (Heat != ReferenceHeat || StepCount != ReferenceStepCount)
+		{
+			FLOGV("FlareDiagnostics::CheckThermalModel : %f FPS gives %d steps and %f heat, expected %d and %f",
+				FrameRates[RateIndex], StepCount, Heat, ReferenceStepCount, ReferenceHeat);
+			Deterministic = false;
+		}
+	}
+
+	FLOGV("FlareDiagnostics::CheckThermalModel : %d ships, %d cases, %d failures, deterministic %d : %s",
+		ShipFiles.Num(), CaseCount, FailureCount, Deterministic,
+		(FailureCount == 0 && Deterministic) ? TEXT("passed") : TEXT("FAILED"));
+
+	return (FailureCount == 0 && Deterministic);
+}
+
+FLARE_DIAGNOSTICS_CHECK(ThermalModel, CheckThermalModel, 0, false)
@@ -0,0 +1,201 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../FlareCompany.h"
+#include "../../Player/FlarePlayerController.h"
+
+
+/** Create one trade route per company for idle cargo fleets, between stations no other route uses for the same resource */
+static void GenerateCheckTradeRoutes(AFlareGame* Game, int32 MaxRouteCount)
+{
+	UFlareWorld* World = Game->GetGameWorld();
+	TArray<UFlareResourceCatalogEntry*>& Resources = Game->GetResourceCatalog()->Resources;
+	TSet<FString> UsedStations;
+	int32 RouteCount = 0;
+
+	for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num() && RouteCount < MaxRouteCount; CompanyIndex++)
+	{
+		UFlareCompany* Company = World->GetCompanies()[CompanyIndex];
+		TArray<UFlareFleet*> Fleets = Company->GetCompanyFleets();
+		bool RouteCreated = false;
+
+		for (int32 FleetIndex = 0; FleetIndex < Fleets.Num() && !RouteCreated; FleetIndex++)
+		{
+			UFlareFleet* Fleet = Fleets[FleetIndex];
+			if (Fleet == Game->GetPC()->GetPlayerFleet() || Fleet->GetCurrentTradeRoute() || Fleet->IsTraveling() || Fleet->GetFleetCapacity() == 0)
+			{
+				continue;
+			}
+
+			UFlareSimulatedSector* LoadSector = Fleet->GetCurrentSector();
+			for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num() && !RouteCreated; ResourceIndex++)
+			{
+				FFlareResourceDescription* Resource = &Resources[ResourceIndex]->Data;
+				FString LoadStations = LoadSector->GetIdentifier().ToString() + TEXT("/") + Resource->Identifier.ToString();
+				if (UsedStations.Contains(LoadStations) || LoadSector->GetResourceStations(Resource).Producers.Num() == 0)
+				{
+					continue;
+				}
+
+				for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+				{
+					UFlareSimulatedSector* UnloadSector = World->GetSectors()[SectorIndex];
+					FString UnloadStations = UnloadSector->GetIdentifier().ToString() + TEXT("/") + Resource->Identifier.ToString();
+					if (UnloadSector == LoadSector || UsedStations.Contains(UnloadStations) || UnloadSector->GetResourceStations(Resource).Consumers.Num() == 0)
+					{
+						continue;
+					}
+
+					UFlareTradeRoute* TradeRoute = Company->CreateTradeRoute(FText::FromString(FString::Printf(TEXT("Check route %d"), RouteCount++)));
+					TradeRoute->AddSector(LoadSector);
+					TradeRoute->AddSector(UnloadSector);
+					TradeRoute->AddSectorOperation(0, EFlareTradeRouteOperation::LoadOrBuy, Resource);
+					TradeRoute->AddSectorOperation(1, EFlareTradeRouteOperation::UnloadOrSell, Resource);
+					TradeRoute->AssignFleet(Fleet);
+
+					UsedStations.Add(LoadStations);
+					UsedStations.Add(UnloadStations);
+					RouteCreated = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+/** Trade statistics of a route */
+struct FFlareCheckTradeRouteStats
+{
+	int64 Quantity;
+	int64 Revenue;
+	float QuantityPerDay;
+	float RevenuePerDay;
+	int32 ProjectionDays;
+};
+
+/** Get the trade statistics of all routes by identifier */
+static TMap<FName, FFlareCheckTradeRouteStats> GetCheckTradeRouteStats(UFlareWorld* World)
+{
+	TMap<FName, FFlareCheckTradeRouteStats> Stats;
+	for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num(); CompanyIndex++)
+	{
+		TArray<UFlareTradeRoute*>& TradeRoutes = World->GetCompanies()[CompanyIndex]->GetCompanyTradeRoutes();
+		for (int32 RouteIndex = 0; RouteIndex < TradeRoutes.Num(); RouteIndex++)
+		{
+			UFlareTradeRoute* TradeRoute = TradeRoutes[RouteIndex];
+			FFlareCheckTradeRouteStats RouteStats;
+			RouteStats.Quantity = TradeRoute->GetTotalTradedQuantity();
+			RouteStats.Revenue = TradeRoute->GetTotalRevenue();
+			RouteStats.QuantityPerDay = TradeRoute->GetProjectedQuantityPerDay();
+			RouteStats.RevenuePerDay = TradeRoute->GetProjectedRevenuePerDay();
+			RouteStats.ProjectionDays = TradeRoute->GetProjectionDays();
+			Stats.Add(TradeRoute->GetIdentifier(), RouteStats);
+		}
+	}
+	return Stats;
+}
+
+/** Simulate days of generated trade routes with the batched and per-route paths on a copy of the game, compare the cargo moved by each route, and save the statistics */
+static bool CheckTradeRouteBatch(AFlareGame* Game, int32 DayCount)
+{
+	if (!Game->GetGameWorld())
+	{
+		FLOG("FlareDiagnostics::CheckTradeRouteBatch failed: no loaded world");
+		return false;
+	}
+
+	// Both runs start from a copy of the current game
+	AFlarePlayerController* PC = Game->GetPC();
+	bool SectorActive;
+	int32 PlayerSlot = FlareDiagnostics::LoadGameCopy(Game, TEXT("CheckTradeRouteBatch"), SectorActive);
+	if (PlayerSlot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	TMap<FName, FFlareCheckTradeRouteStats> RouteStats[2];
+	for (int32 Run = 0; Run < 2; Run++)
+	{
+		bool Batch = (Run == 1);
+		if (Run > 0)
+		{
+			Game->UnloadGame();
+			Game->LoadGame(PC);
+		}
+
+		// Routes share no station and no company money, so the rest of the world only sees the same trades with the same seed
+		FMath::RandInit(42);
+		FMath::SRandInit(42);
+		GenerateCheckTradeRoutes(Game, 32);
+		Game->GetGameWorld()->SetBatchTradeRoutes(Batch);
+
+		double StartTs = FPlatformTime::Seconds();
+		for (int32 Day = 0; Day < DayCount; Day++)
+		{
+			Game->GetGameWorld()->Simulate();
+		}
+		double EndTs = FPlatformTime::Seconds();
+
+		int64 TotalQuantity = 0;
+		int64 TotalRevenue = 0;
+		RouteStats[Run] = GetCheckTradeRouteStats(Game->GetGameWorld());
+		for (auto& Route : RouteStats[Run])
+		{
+			TotalQuantity += Route.Value.Quantity;
+			TotalRevenue += Route.Value.Revenue;
+		}
+
+		FLOGV("FlareDiagnostics::CheckTradeRouteBatch : %s run, %d routes, %lld units, %lld credits in %.2fs",
+			Batch ? TEXT("batched") : TEXT("per-route"), RouteStats[Run].Num(), TotalQuantity, UFlareGameTools::DisplayMoney(TotalRevenue), EndTs - StartTs);
+	}
+
+	// Both paths trade the same cargo on each route
+	int32 MismatchCount = (RouteStats[0].Num() == RouteStats[1].Num()) ? 0 : 1;
+	for (auto& Route : RouteStats[0])
+	{
+		FFlareCheckTradeRouteStats* BatchStats = RouteStats[1].Find(Route.Key);
+		if (!BatchStats || BatchStats->Quantity != Route.Value.Quantity || BatchStats->Revenue != Route.Value.Revenue)
+		{
+			FLOGV("FlareDiagnostics::CheckTradeRouteBatch : route %s moved %lld units for %lld credits, %lld units for %lld credits batched",
+				*Route.Key.ToString(), Route.Value.Quantity, Route.Value.Revenue, BatchStats ? BatchStats->Quantity : -1, BatchStats ? BatchStats->Revenue : -1);
+			MismatchCount++;
+		}
+	}
+
+	// The daily statistics survive a save
+	int32 StatsMismatchCount = 0;
+	Game->SetCurrentSlot(DIAGNOSTICS_SCRATCH_SLOT);
+	if (Game->SaveGame(PC, false))
+	{
+		Game->UnloadGame();
+		Game->LoadGame(PC);
+
+		TMap<FName, FFlareCheckTradeRouteStats> LoadedStats = GetCheckTradeRouteStats(Game->GetGameWorld());
+		for (auto& Route : RouteStats[1])
+		{
+			FFlareCheckTradeRouteStats* Loaded = LoadedStats.Find(Route.Key);
+			if (!Loaded || Loaded->ProjectionDays != Route.Value.ProjectionDays
+				|| Loaded->QuantityPerDay != Route.Value.QuantityPerDay || Loaded->RevenuePerDay != Route.Value.RevenuePerDay)
+			{
+				FLOGV("FlareDiagnostics::CheckTradeRouteBatch : route %s statistics changed after a save", *Route.Key.ToString());
+				StatsMismatchCount++;
+			}
+		}
+		Game->DeleteSaveSlot(DIAGNOSTICS_SCRATCH_SLOT);
+	}
+	else
+	{
+		FLOG("FlareDiagnostics::CheckTradeRouteBatch : cannot save the simulated game");
+		StatsMismatchCount++;
+	}
+
+	bool Success = (MismatchCount == 0 && StatsMismatchCount == 0);
+	FLOGV("FlareDiagnostics::CheckTradeRouteBatch : %d days, %d routes, %d mismatches, %d statistics mismatches : %s",
+		DayCount, RouteStats[0].Num(), MismatchCount, StatsMismatchCount, Success ? TEXT("passed") : TEXT("FAILED"));
+
+	FlareDiagnostics::RestoreGameCopy(Game, PlayerSlot, SectorActive);
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(TradeRouteBatch, CheckTradeRouteBatch, 365, false)
@@ -0,0 +1,93 @@
+#include "../../Flare.h"
+#include "FlareDiagnostics.h"
+#include "../FlareGame.h"
+#include "../../Spacecrafts/FlareTurret.h"
+#include "../../Spacecrafts/Subsystems/FlareSpacecraftWeaponsSystem.h"
+#include "../../Spacecrafts/Subsystems/FlareSimulatedSpacecraftWeaponsSystem.h"
+
+
+/** Share of the gun samples a firing map may wrongly find safe */
+#define DIAGNOSTICS_TURRET_UNSAFE_RATIO 0.01f
+
+/** Distance allowed between the computed and the live muzzles, in cm */
+#define DIAGNOSTICS_TURRET_POSE_TOLERANCE 1.f
+
+/** Rebake the turret firing maps of the current sector, activating it if needed, and compare them with the full trace at random angles */
+static bool CheckTurretFiringMaps(AFlareGame* Game, int32 SampleCount)
+{
+	// Headless runs have no active sector yet
+	bool SectorActive = (Game->GetActiveSector() != NULL);
+	if (!SectorActive)
+	{
+		Game->ActivateCurrentSector(false);
+	}
+	if (!Game->GetActiveSector())
+	{
+		FLOG("FlareDiagnostics::CheckTurretFiringMaps failed: no active sector");
+		return false;
+	}
+
+	// Rebake each ship class once, then compare every turret with the full trace
+	FRandomStream Random(42);
+	TArray<FName> BakedClasses;
+	int32 TurretCount = 0;
+	int32 GunSampleCount = 0;
+	int32 TotalUnsafeCount = 0;
+	int32 TotalOvercautiousCount = 0;
+	float MaxPoseError = 0;
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Game->GetActiveSector()->GetSpacecrafts().Num(); SpacecraftIndex++)
+	{
+		AFlareSpacecraft* Spacecraft = Game->GetActiveSector()->GetSpacecrafts()[SpacecraftIndex];
+		FName ClassIdentifier = Spacecraft->GetDescription()->Identifier;
+		bool Bake = !BakedClasses.Contains(ClassIdentifier);
+		BakedClasses.AddUnique(ClassIdentifier);
+
+		TArray<UFlareWeapon*>& Weapons = Spacecraft->GetWeaponsSystem()->GetWeaponList();
+		for (int32 WeaponIndex = 0; WeaponIndex < Weapons.Num(); WeaponIndex++)
+		{
+			UFlareTurret* Turret = Cast<UFlareTurret>(Weapons[WeaponIndex]);
+			if (!Turret)
+			{
+				continue;
+			}
+
+			if (Bake)
+			{
+				Turret->BakeFiringMap();
+			}
+
+			int32 UnsafeCount;
+			int32 OvercautiousCount;
+			float PoseError;
+			Turret->ValidateFiringMap(Random, SampleCount, UnsafeCount, OvercautiousCount, PoseError);
+			if (UnsafeCount || PoseError > DIAGNOSTICS_TURRET_POSE_TOLERANCE)
+			{
+				FLOGV("FlareDiagnostics::CheckTurretFiringMaps : %s %s : %d unsafe, %d overcautious, pose error %f",
+					*Spacecraft->GetImmatriculation().ToString(), *Turret->GetReadableName(), UnsafeCount, OvercautiousCount, PoseError);
+			}
+
+			TurretCount++;
+			GunSampleCount += SampleCount * Weapons[WeaponIndex]->GetDescription()->WeaponCharacteristics.GunCharacteristics.GunCount;
+			TotalUnsafeCount += UnsafeCount;
+			TotalOvercautiousCount += OvercautiousCount;
+			MaxPoseError = FMath::Max(MaxPoseError, PoseError);
+		}
+	}
+
+	// The baked hull ignores the other turrets, which the full trace hits : a few unsafe samples are expected
+	bool Success = (TotalUnsafeCount <= GunSampleCount * DIAGNOSTICS_TURRET_UNSAFE_RATIO)
+		&& (MaxPoseError <= DIAGNOSTICS_TURRET_POSE_TOLERANCE);
+
+	FLOGV("FlareDiagnostics::CheckTurretFiringMaps : %d classes, %d turrets, %d gun samples, %d unsafe, %d overcautious, pose error %f : %s",
+		BakedClasses.Num(), TurretCount, GunSampleCount, TotalUnsafeCount, TotalOvercautiousCount, MaxPoseError,
+		Success ? TEXT("passed") : TEXT("FAILED"));
+
+	if (!SectorActive)
+	{
+		Game->DeactivateSector();
+	}
+
+	return Success;
+}
+
+FLARE_DIAGNOSTICS_CHECK(TurretFiringMaps, CheckTurretFiringMaps, 1000, false)
@@ -53,6 +53,23 @@ void UFlareCompany::Load(const FFlareCompanySave& Data)
 	FCHECK(TacticManager);
 	TacticManager->Load(this);
 
+	// Reset the value ledger
+	SpacecraftValues.Empty();
+	SectorValueGroups.Empty();
+	DirtySpacecraftValues.Empty();
+	LedgerValue.MoneyValue = 0;
+	LedgerValue.StockValue = 0;
+	LedgerValue.ShipsValue = 0;
+	LedgerValue.ArmyValue = 0;
+	LedgerValue.StationsValue = 0;
+	LedgerValue.SpacecraftsValue = 0;
+	LedgerValue.TotalValue = 0;
+
+	if (CompanyData.CompanyValueHistory.MaxSize != COMPANY_VALUE_HISTORY)
+	{
+		CompanyData.CompanyValueHistory.Resize(COMPANY_VALUE_HISTORY);
+	}
+
 	// Load ships
 	for (int i = 0 ; i < CompanyData.ShipData.Num(); i++)
 	{
@@ -421,6 +438,7 @@ UFlareSimulatedSpacecraft* UFlareCompany::LoadSpacecraft(const FFlareSpacecraftS
 		}
 
 		CompanySpacecrafts.AddUnique((Spacecraft));
+		AddSpacecraftValue(Spacecraft);
 	}
 	else
 	{
@@ -437,6 +455,7 @@ void UFlareCompany::DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 	CompanySpacecrafts.Remove(Spacecraft);
 	CompanyStations.Remove(Spacecraft);
 	CompanyShips.Remove(Spacecraft);
+	RemoveSpacecraftValue(Spacecraft);
 	if (Spacecraft->GetCurrentFleet())
 	{
 		Spacecraft->GetCurrentFleet()->RemoveShip(Spacecraft, true);
@@ -497,6 +516,11 @@ void UFlareCompany::GiveMoney(int64 Amount)
 	{
 		FLOGV("$ %s + %lld -> %llu", *GetCompanyName().ToString(), Amount, CompanyData.Money);
 	}*/
+
+	if (Amount > 0 && Game->GetGameWorld())
+	{
+		Game->GetGameWorld()->WakeMoneyBlockedFactories(this);
+	}
 }
 
 #define REPUTATION_RANGE 200.f
@@ -624,6 +648,264 @@ void UFlareCompany::ForceReputation(UFlareCompany* Company, float Amount)
 	CompanyReputation->Reputation = Amount;
 }
 
+
+/*----------------------------------------------------
+	Company value
+----------------------------------------------------*/
+
+void UFlareCompany::InvalidateSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	DirtySpacecraftValues.Add(Spacecraft);
+}
+
+void UFlareCompany::UpdateCompanyValueHistory()
+{
+	CompanyData.CompanyValueHistory.Append(GetCompanyValue().TotalValue);
+}
+
+struct CompanyValue UFlareCompany::ComputeCompanyValue() const
+{
+	// Company value is the sum of :
+	// - money
+	// - value of its spacecraft
+	// - value of the stock in these spacecraft
+	// - value of the resources used in factory
+
+	struct CompanyValue Value;
+	Value.MoneyValue = GetMoney();
+	Value.StockValue = 0;
+	Value.ShipsValue = 0;
+	Value.ArmyValue = 0;
+	Value.StationsValue = 0;
+
+	for (int SpacecraftIndex = 0; SpacecraftIndex < CompanySpacecrafts.Num(); SpacecraftIndex++)
+	{
+		SpacecraftValue Spacecraft = ComputeSpacecraftValue(CompanySpacecrafts[SpacecraftIndex]);
+
+		Value.StockValue += Spacecraft.StockValue;
+		Value.StationsValue += (Spacecraft.IsStation ? Spacecraft.SpacecraftPrice : 0);
+		Value.ShipsValue += (Spacecraft.IsStation ? 0 : Spacecraft.SpacecraftPrice);
+		Value.ArmyValue += (Spacecraft.IsMilitary ? Spacecraft.SpacecraftPrice : 0);
+	}
+
+	Value.SpacecraftsValue = Value.ShipsValue + Value.StationsValue;
+	Value.TotalValue = Value.MoneyValue + Value.StockValue + Value.SpacecraftsValue;
+
+	return Value;
+}
+
+
+/*----------------------------------------------------
+	Company value ledger
+----------------------------------------------------*/
+
+void UFlareCompany::AddSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	SpacecraftValue Value;
+	Value.ReferenceSector = NULL;
+	Value.SpacecraftPrice = 0;
+	Value.StockValue = 0;
+	Value.IsStation = false;
+	Value.IsMilitary = false;
+
+	SpacecraftValues.Add(Spacecraft, Value);
+	DirtySpacecraftValues.Add(Spacecraft);
+}
+
+void UFlareCompany::RemoveSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	SpacecraftValue* Value = SpacecraftValues.Find(Spacecraft);
+	if (Value)
+	{
+		ApplySpacecraftValue(*Value, -1);
+
+		SectorValueGroup* Group = SectorValueGroups.Find(Value->ReferenceSector);
+		if (Group)
+		{
+			Group->Spacecrafts.RemoveSwap(Spacecraft);
+			if (Group->Spacecrafts.Num() == 0)
+			{
+				SectorValueGroups.Remove(Value->ReferenceSector);
+			}
+		}
+
+		SpacecraftValues.Remove(Spacecraft);
+	}
+
+	DirtySpacecraftValues.Remove(Spacecraft);
+}
+
+void UFlareCompany::UpdateCompanyValueLedger()
+{
+	// Leave the sectors the spacecrafts moved out of, as travel sectors don't outlive their travel
+	RevalueDirtySpacecrafts();
+
+	// Revalue whole sectors after a price change
+	for (TMap<UFlareSimulatedSector*, SectorValueGroup>::TIterator Iterator = SectorValueGroups.CreateIterator(); Iterator; ++Iterator)
+	{
+		SectorValueGroup& Group = Iterator.Value();
+		uint32 PriceVersion = Iterator.Key()->GetPriceVersion();
+
+		if (Group.PriceVersion != PriceVersion)
+		{
+			Group.PriceVersion = PriceVersion;
+			DirtySpacecraftValues.Append(Group.Spacecrafts);
+		}
+	}
+
+	RevalueDirtySpacecrafts();
+}
+
+void UFlareCompany::RevalueDirtySpacecrafts()
+{
+	if (DirtySpacecraftValues.Num() == 0)
+	{
+		return;
+	}
+
+	TSet<UFlareSimulatedSpacecraft*> LostSpacecrafts;
+
+	for (TSet<UFlareSimulatedSpacecraft*>::TConstIterator Iterator(DirtySpacecraftValues); Iterator; ++Iterator)
+	{
+		UFlareSimulatedSpacecraft* Spacecraft = *Iterator;
+
+		// Destroyed, or not loaded yet
+		SpacecraftValue* Value = SpacecraftValues.Find(Spacecraft);
+		if (!Value)
+		{
+			continue;
+		}
+
+		// Remove the old value
+		ApplySpacecraftValue(*Value, -1);
+		UFlareSimulatedSector* OldSector = Value->ReferenceSector;
+
+		// Add the new one
+		*Value = ComputeSpacecraftValue(Spacecraft);
+		ApplySpacecraftValue(*Value, 1);
+		UFlareSimulatedSector* NewSector = Value->ReferenceSector;
+
+		// Move to the new sector group
+		if (OldSector != NewSector)
+		{
+			SectorValueGroup* OldGroup = SectorValueGroups.Find(OldSector);
+			if (OldGroup)
+			{
+				OldGroup->Spacecrafts.RemoveSwap(Spacecraft);
+				if (OldGroup->Spacecrafts.Num() == 0)
+				{
+					SectorValueGroups.Remove(OldSector);
+				}
+			}
+
+			if (NewSector)
+			{
+				SectorValueGroup* NewGroup = SectorValueGroups.Find(NewSector);
+				if (!NewGroup)
+				{
+					NewGroup = &SectorValueGroups.Add(NewSector);
+					NewGroup->PriceVersion = NewSector->GetPriceVersion();
+				}
+				NewGroup->Spacecrafts.Add(Spacecraft);
+			}
+		}
+
+		// Retry until the spacecraft reaches a sector
+		if (!NewSector)
+		{
+			LostSpacecrafts.Add(Spacecraft);
+		}
+	}
+
+	DirtySpacecraftValues = LostSpacecrafts;
+}
+
+void UFlareCompany::ApplySpacecraftValue(const SpacecraftValue& Value, int64 Sign)
+{
+	LedgerValue.StockValue += Sign * Value.StockValue;
+	if (Value.IsStation)
+	{
+		LedgerValue.StationsValue += Sign * Value.SpacecraftPrice;
+	}
+	else
+	{
+		LedgerValue.ShipsValue += Sign * Value.SpacecraftPrice;
+	}
+
+	if (Value.IsMilitary)
+	{
+		// TODO Upgrade cost
+		LedgerValue.ArmyValue += Sign * Value.SpacecraftPrice;
+	}
+}
+
+SpacecraftValue UFlareCompany::ComputeSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft) const
+{
+	SpacecraftValue Value;
+	Value.ReferenceSector = Spacecraft->GetCurrentSector();
+	Value.SpacecraftPrice = 0;
+	Value.StockValue = 0;
+	Value.IsStation = Spacecraft->IsStation();
+	Value.IsMilitary = Spacecraft->IsMilitary();
+
+	if (!Value.ReferenceSector)
+	{
+		if (Spacecraft->GetCurrentFleet() && Spacecraft->GetCurrentFleet()->GetCurrentTravel())
+		{
+			Value.ReferenceSector = Spacecraft->GetCurrentFleet()->GetCurrentTravel()->GetDestinationSector();
+		}
+		else
+		{
+			FLOGV("Spacecraft %s is lost : no current sector, no travel", *Spacecraft->GetImmatriculation().ToString());
+			return Value;
+		}
+	}
+
+	UFlareSimulatedSector* ReferenceSector = Value.ReferenceSector;
+
+	// Value of the spacecraft
+	Value.SpacecraftPrice = UFlareGameTools::ComputeSpacecraftPrice(Spacecraft->GetDescription()->Identifier, ReferenceSector, true);
+
+	// Value of the stock
+	TArray<FFlareCargo>& CargoBaySlots = Spacecraft->GetCargoBay()->GetSlots();
+	for (int CargoIndex = 0; CargoIndex < CargoBaySlots.Num(); CargoIndex++)
+	{
+		FFlareCargo& Cargo = CargoBaySlots[CargoIndex];
+
+		if (!Cargo.Resource)
+		{
+			continue;
+		}
+
+		Value.StockValue += ReferenceSector->GetResourcePrice(Cargo.Resource, EFlareResourcePriceContext::Default) * Cargo.Quantity;
+	}
+
+	// Value of factory stock
+	for (int32 FactoryIndex = 0; FactoryIndex < Spacecraft->GetFactories().Num(); FactoryIndex++)
+	{
+		UFlareFactory* Factory = Spacecraft->GetFactories()[FactoryIndex];
+
+		for (int32 ReservedResourceIndex = 0 ; ReservedResourceIndex < Factory->GetReservedResources().Num(); ReservedResourceIndex++)
+		{
+			FName ResourceIdentifier = Factory->GetReservedResources()[ReservedResourceIndex].ResourceIdentifier;
+			uint32 Quantity = Factory->GetReservedResources()[ReservedResourceIndex].Quantity;
+
+			FFlareResourceDescription* Resource = Game->GetResourceCatalog()->Get(ResourceIdentifier);
+			if (Resource)
+			{
+				Value.StockValue += ReferenceSector->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * Quantity;
+			}
+			else
+			{
+				FLOGV("WARNING: Invalid reserved resource %s (%d reserved) for %s)", *ResourceIdentifier.ToString(), Quantity, *Spacecraft->GetImmatriculation().ToString())
+			}
+		}
+	}
+
+	return Value;
+}
+
+
 /*----------------------------------------------------
 	Customization
 ----------------------------------------------------*/
@@ -680,6 +962,12 @@ FLinearColor UFlareCompany::NormalizeColor(FLinearColor Col) const
 
 void UFlareCompany::SetupEmblem()
 {
+	// No style set without a render device
+	if (IsRunningCommandlet())
+	{
+		return;
+	}
+
 	// Create the parameter
 	FVector2D EmblemSize = 128 * FVector2D::UnitVector;
 	UMaterial* BaseEmblemMaterial = Cast<UMaterial>(FFlareStyleSet::GetIcon("CompanyEmblem")->GetResourceObject());
@@ -708,104 +996,28 @@ const FSlateBrush* UFlareCompany::GetEmblem() const
 	Getters
 ----------------------------------------------------*/
 
-struct CompanyValue UFlareCompany::GetCompanyValue() const
+struct CompanyValue UFlareCompany::GetCompanyValue()
 {
-	// Company value is the sum of :
-	// - money
-	// - value of its spacecraft
-	// - value of the stock in these spacecraft
-	// - value of the resources used in factory
+	UpdateCompanyValueLedger();
 
-	struct CompanyValue Value;
+	struct CompanyValue Value = LedgerValue;
 	Value.MoneyValue = GetMoney();
-	Value.StockValue = 0;
-	Value.ShipsValue = 0;
-	Value.ArmyValue = 0;
-	Value.StationsValue = 0;
-
-	for (int SpacecraftIndex = 0; SpacecraftIndex < CompanySpacecrafts.Num(); SpacecraftIndex++)
-	{
-		UFlareSimulatedSpacecraft* Spacecraft = CompanySpacecrafts[SpacecraftIndex];
-
-		UFlareSimulatedSector *ReferenceSector =  Spacecraft->GetCurrentSector();
-
-		if (!ReferenceSector)
-		{
-			if (Spacecraft->GetCurrentFleet() && Spacecraft->GetCurrentFleet()->GetCurrentTravel())
-			{
-				ReferenceSector = Spacecraft->GetCurrentFleet()->GetCurrentTravel()->GetDestinationSector();
-			}
-			else
-			{
-				FLOGV("Spacecraft %s is lost : no current sector, no travel", *Spacecraft->GetImmatriculation().ToString());
-				continue;
-			}
-
-		}
-
-		// Value of the spacecraft
-		int64 SpacecraftPrice = UFlareGameTools::ComputeSpacecraftPrice(Spacecraft->GetDescription()->Identifier, ReferenceSector, true);
-
-		if(Spacecraft->IsStation())
-		{
-			Value.StationsValue += SpacecraftPrice;
-		}
-		else
-		{
-			Value.ShipsValue += SpacecraftPrice;
-		}
-
-		if(Spacecraft->IsMilitary())
-		{
-			// TODO Upgrade cost
-			Value.ArmyValue += SpacecraftPrice;
-		}
-
-		// Value of the stock
-		TArray<FFlareCargo>& CargoBaySlots = Spacecraft->GetCargoBay()->GetSlots();
-		for (int CargoIndex = 0; CargoIndex < CargoBaySlots.Num(); CargoIndex++)
-		{
-			FFlareCargo& Cargo = CargoBaySlots[CargoIndex];
-
-			if (!Cargo.Resource)
-			{
-				continue;
-			}
-
-			Value.StockValue += ReferenceSector->GetResourcePrice(Cargo.Resource, EFlareResourcePriceContext::Default) * Cargo.Quantity;
-		}
-
-		// Value of factory stock
-		for (int32 FactoryIndex = 0; FactoryIndex < Spacecraft->GetFactories().Num(); FactoryIndex++)
-		{
-			UFlareFactory* Factory = Spacecraft->GetFactories()[FactoryIndex];
-
-
-
-			for (int32 ReservedResourceIndex = 0 ; ReservedResourceIndex < Factory->GetReservedResources().Num(); ReservedResourceIndex++)
-			{
-				FName ResourceIdentifier = Factory->GetReservedResources()[ReservedResourceIndex].ResourceIdentifier;
-				uint32 Quantity = Factory->GetReservedResources()[ReservedResourceIndex].Quantity;
-
-				FFlareResourceDescription* Resource = Game->GetResourceCatalog()->Get(ResourceIdentifier);
-				if (Resource)
-				{
-					Value.StockValue += ReferenceSector->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * Quantity;
-				}
-				else
-				{
-					FLOGV("WARNING: Invalid reserved resource %s (%d reserved) for %s)", *ResourceIdentifier.ToString(), Quantity, *Spacecraft->GetImmatriculation().ToString())
-				}
-			}
-		}
-	}
-
 	Value.SpacecraftsValue = Value.ShipsValue + Value.StationsValue;
 	Value.TotalValue = Value.MoneyValue + Value.StockValue + Value.SpacecraftsValue;
 
 	return Value;
 }
 
+int64 UFlareCompany::GetCompanyValueHistory(int32 Age)
+{
+	if (CompanyData.CompanyValueHistory.Values.Num() == 0)
+	{
+		return GetCompanyValue().TotalValue;
+	}
+
+	return CompanyData.CompanyValueHistory.GetValue(Age);
+}
+
 UFlareSimulatedSpacecraft* UFlareCompany::FindSpacecraft(FName ShipImmatriculation)
 {
 	for (int i = 0; i < CompanySpacecrafts.Num(); i++)
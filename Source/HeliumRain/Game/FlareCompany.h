@@ -29,6 +29,28 @@ struct CompanyValue
 	int64 TotalValue;
 };
 
+/** Cached value of a spacecraft in the company value ledger */
+struct SpacecraftValue
+{
+	/** Sector whose prices were used, NULL if not valued yet */
+	UFlareSimulatedSector* ReferenceSector;
+
+	int64 SpacecraftPrice;
+	int64 StockValue;
+	bool IsStation;
+	bool IsMilitary;
+};
+
+/** Spacecrafts valued with the prices of a sector */
+struct SectorValueGroup
+{
+	uint32 PriceVersion;
+	TArray<UFlareSimulatedSpacecraft*> Spacecrafts;
+};
+
+/** Number of days in the company value history */
+#define COMPANY_VALUE_HISTORY 365
+
 
 
 /** Catalog data */
@@ -169,6 +191,21 @@ public:
 
 	virtual void ForceReputation(UFlareCompany* Company, float Amount);
 
+
+	/*----------------------------------------------------
+		Company value
+	----------------------------------------------------*/
+
+	/** Revalue a spacecraft at the next value query, after its cargo, factories or sector changed */
+	void InvalidateSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Record today's company value in the history */
+	void UpdateCompanyValueHistory();
+
+	/** Compute the company value from scratch, without the ledger */
+	struct CompanyValue ComputeCompanyValue() const;
+
+
 	/*----------------------------------------------------
 		Customization
 	----------------------------------------------------*/
@@ -194,6 +231,29 @@ public:
 
 protected:
 
+	/*----------------------------------------------------
+		Company value ledger
+	----------------------------------------------------*/
+
+	/** Start following the value of a new spacecraft */
+	void AddSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Stop following the value of a removed spacecraft */
+	void RemoveSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Revalue the invalidated spacecrafts and the ones in sectors whose prices changed */
+	void UpdateCompanyValueLedger();
+
+	/** Revalue the invalidated spacecrafts */
+	void RevalueDirtySpacecrafts();
+
+	/** Add (Sign = 1) or remove (Sign = -1) a spacecraft value from the ledger totals */
+	void ApplySpacecraftValue(const SpacecraftValue& Value, int64 Sign);
+
+	/** Compute the value of a spacecraft and of its stock */
+	SpacecraftValue ComputeSpacecraftValue(UFlareSimulatedSpacecraft* Spacecraft) const;
+
+
 	/*----------------------------------------------------
 		Protected data
 	----------------------------------------------------*/
@@ -233,6 +293,12 @@ protected:
 	TArray<UFlareSimulatedSector*>          KnownSectors;
 	TArray<UFlareSimulatedSector*>          VisitedSectors;
 
+	// Company value ledger, money excluded
+	TMap<UFlareSimulatedSpacecraft*, SpacecraftValue>   SpacecraftValues;
+	TMap<UFlareSimulatedSector*, SectorValueGroup>      SectorValueGroups;
+	TSet<UFlareSimulatedSpacecraft*>                    DirtySpacecraftValues;
+	struct CompanyValue                                 LedgerValue;
+
 
 public:
 
@@ -305,7 +371,17 @@ public:
 		return CompanyData.Money;
 	}
 
-	struct CompanyValue GetCompanyValue() const;
+	/** Get the company value, updated from the ledger */
+	struct CompanyValue GetCompanyValue();
+
+	/** Get the company value some days ago, or the oldest known value */
+	int64 GetCompanyValueHistory(int32 Age);
+
+	/** Number of days in the company value history */
+	inline int32 GetCompanyValueHistoryLength() const
+	{
+		return CompanyData.CompanyValueHistory.Values.Num();
+	}
 
 	inline TArray<UFlareSimulatedSpacecraft*>& GetCompanyStations()
 	{
@@ -3,12 +3,20 @@
 #include "FlareGame.h"
 #include "FlareDebrisField.h"
 #include "FlareSimulatedSector.h"
+#include "../Player/FlarePlayerController.h"
 
 #include "StaticMeshResources.h"
+#include "Components/InstancedStaticMeshComponent.h"
 
 
 #define LOCTEXT_NAMESPACE "FlareDebrisField"
 
+// Distance under which debris are simulated, in cm
+#define DEBRIS_WAKE_DISTANCE 50000
+
+// Distance over which simulated debris go back to sleep, in cm
+#define DEBRIS_SLEEP_DISTANCE 75000
+
 
 /*----------------------------------------------------
 	Constructor
@@ -16,8 +24,9 @@
 
 UFlareDebrisField::UFlareDebrisField(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, DebrisFieldActor(NULL)
+	, IsPaused(false)
 {
-	CurrentGenerationIndex = 0;
 }
 
 void UFlareDebrisField::Setup(AFlareGame* GameMode, UFlareSimulatedSector* Sector)
@@ -29,64 +38,140 @@ void UFlareDebrisField::Setup(AFlareGame* GameMode, UFlareSimulatedSector* Secto
 	Game = GameMode;
 	const FFlareDebrisFieldInfo* DebrisFieldInfo = &Sector->GetDescription()->DebrisFieldInfo;
 	UFlareAsteroidCatalog* DebrisFieldMeshes = DebrisFieldInfo->DebrisCatalog;
-	TArray<AStaticMeshActor*> NewDebris;
+	DebrisField.Empty();
+	IsPaused = false;
 
 	// Add debris
 	if (DebrisFieldInfo && DebrisFieldMeshes)
 	{
-		float SectorScale = 5000 * 100;
-		int32 DebrisCount = 100 * DebrisFieldInfo->DebrisFieldDensity;
 		FLOGV("UFlareDebrisField::Setup : debris catalog is %s", *DebrisFieldMeshes->GetName());
-		FLOGV("UFlareDebrisField::Setup : spawning debris field : gen %d, size = %d, icy = %d", CurrentGenerationIndex, DebrisCount, Sector->GetDescription()->IsIcy);
+		GenerateDebris(DebrisFieldInfo, Sector->GetIdentifier(), DebrisField);
+		FLOGV("UFlareDebrisField::Setup : spawning debris field : size = %d, icy = %d", DebrisField.Num(), Sector->GetDescription()->IsIcy);
 
-		for (int32 Index = 0; Index < DebrisCount; Index++)
+		// All debris live in a single actor
+		FActorSpawnParameters Params;
+		Params.Owner = Game;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		DebrisFieldActor = Game->GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, Params);
+		if (DebrisFieldActor)
 		{
-			int32 DebrisIndex = FMath::RandRange(0, DebrisFieldMeshes->Asteroids.Num() - 1);
+			USceneComponent* Root = NewObject<USceneComponent>(DebrisFieldActor);
+			Root->SetMobility(EComponentMobility::Movable);
+			DebrisFieldActor->SetRootComponent(Root);
+			Root->RegisterComponent();
 
-			float MinSize = DebrisFieldInfo->MinDebrisSize;
-			float MaxSize = DebrisFieldInfo->MaxDebrisSize;
-			float Size = FMath::FRandRange(MinSize, MaxSize);
-
-			FName Name = FName(*(FString::Printf(TEXT("DebrisGen%dIndex%d"), CurrentGenerationIndex, Index)));
+			for (int32 MeshIndex = 0; MeshIndex < DebrisFieldMeshes->Asteroids.Num(); MeshIndex++)
+			{
+				DebrisComponents.Add(AddDebrisComponent(Sector, DebrisFieldMeshes->Asteroids[MeshIndex]));
+			}
 
-			NewDebris.Add(AddDebris(Sector, DebrisFieldMeshes->Asteroids[DebrisIndex], Size, SectorScale, Name));
+			for (int32 Index = 0; Index < DebrisField.Num(); Index++)
+			{
+				FFlareDebrisInstance& Debris = DebrisField[Index];
+				Debris.InstanceIndex = DebrisComponents[Debris.MeshIndex]->AddInstance(Debris.Transform);
+			}
+		}
+		else
+		{
+			FLOG("UFlareDebrisField::Setup : failed to spawn debris field");
+			DebrisField.Empty();
 		}
 	}
 	else
 	{
 		FLOG("UFlareDebrisField::Setup : debris catalog not available, skipping");
 	}
+}
 
-	// Remember new debris
+void UFlareDebrisField::Reset()
+{
+	FLOGV("UFlareDebrisField::Reset : clearing debris field, size = %d, %d awake", DebrisField.Num(), AwakeDebris.Num());
+	for (int i = 0; i < AwakeDebris.Num(); i++)
+	{
+		Game->GetWorld()->DestroyActor(AwakeDebris[i]);
+	}
+	if (DebrisFieldActor)
+	{
+		Game->GetWorld()->DestroyActor(DebrisFieldActor);
+	}
+
+	DebrisFieldActor = NULL;
+	DebrisComponents.Empty();
+	AwakeDebris.Empty();
 	DebrisField.Empty();
-	for (int DebrisIndex = 0; DebrisIndex < NewDebris.Num(); DebrisIndex++)
+}
+
+void UFlareDebrisField::SetWorldPause(bool Pause)
+{
+	IsPaused = Pause;
+
+	if (DebrisFieldActor)
 	{
-		if (NewDebris[DebrisIndex])
-		{
-			DebrisField.Add(NewDebris[DebrisIndex]);
-		}
+		DebrisFieldActor->SetActorHiddenInGame(Pause);
+		DebrisFieldActor->SetActorEnableCollision(!Pause);
 	}
 
-	CurrentGenerationIndex++;
+	for (int i = 0; i < AwakeDebris.Num(); i++)
+	{
+		AwakeDebris[i]->SetActorHiddenInGame(Pause);
+		AwakeDebris[i]->CustomTimeDilation = (Pause ? 0.f : 1.0);
+		Cast<UPrimitiveComponent>(AwakeDebris[i]->GetRootComponent())->SetSimulatePhysics(!Pause);
+	}
 }
 
-void UFlareDebrisField::Reset()
+void UFlareDebrisField::Tick(float DeltaSeconds)
 {
-	FLOGV("UFlareDebrisField::Reset : clearing debris field, size = %d", DebrisField.Num());
-	for (int i = 0; i < DebrisField.Num(); i++)
+	if (IsPaused || !DebrisFieldActor || !Game->GetPC()->GetShipPawn())
 	{
-		Game->GetWorld()->DestroyActor(DebrisField[i]);
+		return;
+	}
+
+	FVector PlayerLocation = Game->GetPC()->GetShipPawn()->GetActorLocation();
+	float WakeDistanceSquared = FMath::Square(DEBRIS_WAKE_DISTANCE);
+	float SleepDistanceSquared = FMath::Square(DEBRIS_SLEEP_DISTANCE);
+
+	for (int32 Index = 0; Index < DebrisField.Num(); Index++)
+	{
+		FFlareDebrisInstance& Debris = DebrisField[Index];
+
+		if (Debris.Actor)
+		{
+			if (FVector::DistSquared(Debris.Actor->GetActorLocation(), PlayerLocation) > SleepDistanceSquared)
+			{
+				SleepDebris(Debris);
+			}
+		}
+		else if (FVector::DistSquared(Debris.Transform.GetLocation(), PlayerLocation) < WakeDistanceSquared)
+		{
+			WakeDebris(Debris);
+		}
 	}
-	DebrisField.Empty();
 }
 
-void UFlareDebrisField::SetWorldPause(bool Pause)
+void UFlareDebrisField::GenerateDebris(const FFlareDebrisFieldInfo* DebrisFieldInfo, FName SectorIdentifier, TArray<FFlareDebrisInstance>& Debris)
 {
-	for (int i = 0; i < DebrisField.Num(); i++)
+	FCHECK(DebrisFieldInfo->DebrisCatalog);
+
+	float SectorScale = 5000 * 100;
+	int32 DebrisCount = 100 * DebrisFieldInfo->DebrisFieldDensity;
+	int32 MeshCount = DebrisFieldInfo->DebrisCatalog->Asteroids.Num();
+	FRandomStream Stream(FCrc::StrCrc32(*SectorIdentifier.ToString()));
+
+	Debris.Empty(DebrisCount);
+	for (int32 Index = 0; Index < DebrisCount && MeshCount > 0; Index++)
 	{
-		DebrisField[i]->SetActorHiddenInGame(Pause);
-		DebrisField[i]->CustomTimeDilation = (Pause ? 0.f : 1.0);
-		Cast<UPrimitiveComponent>(DebrisField[i]->GetRootComponent())->SetSimulatePhysics(!Pause);
+		FFlareDebrisInstance NewDebris;
+		NewDebris.MeshIndex = Stream.RandRange(0, MeshCount - 1);
+		NewDebris.InstanceIndex = INDEX_NONE;
+		NewDebris.Actor = NULL;
+
+		// Compute size, location and rotation
+		float Size = Stream.FRandRange(DebrisFieldInfo->MinDebrisSize, DebrisFieldInfo->MaxDebrisSize);
+		FVector Location = Stream.VRand() * SectorScale * Stream.FRandRange(0.2, 1.0);
+		FRotator Rotation = FRotator(Stream.FRandRange(0, 360), Stream.FRandRange(0, 360), Stream.FRandRange(0, 360));
+		NewDebris.Transform = FTransform(Rotation, Location, Size * FVector(1, 1, 1));
+
+		Debris.Add(NewDebris);
 	}
 }
 
@@ -95,53 +180,95 @@ void UFlareDebrisField::SetWorldPause(bool Pause)
 	Internals
 ----------------------------------------------------*/
 
-AStaticMeshActor* UFlareDebrisField::AddDebris(UFlareSimulatedSector* Sector, UStaticMesh* Mesh, float Size, float SectorScale, FName Name)
+UInstancedStaticMeshComponent* UFlareDebrisField::AddDebrisComponent(UFlareSimulatedSector* Sector, UStaticMesh* Mesh)
 {
+	UInstancedStaticMeshComponent* DebrisComponent = NewObject<UInstancedStaticMeshComponent>(DebrisFieldActor);
+	DebrisComponent->SetMobility(EComponentMobility::Movable);
+	DebrisComponent->SetupAttachment(DebrisFieldActor->GetRootComponent());
+	DebrisComponent->SetStaticMesh(Mesh);
+	DebrisComponent->SetCollisionProfileName("BlockAllDynamic");
+	DebrisComponent->RegisterComponent();
+
+	// Set material, shared with the awake debris
+	UMaterialInstanceDynamic* DebrisMaterial = UMaterialInstanceDynamic::Create(DebrisComponent->GetMaterial(0), DebrisComponent->GetWorld());
+	if (DebrisMaterial)
+	{
+		DebrisComponent->SetMaterial(0, DebrisMaterial);
+		DebrisMaterial->SetScalarParameterValue("IceMask", Sector->GetDescription()->IsIcy);
+	}
+	else
+	{
+		FLOG("UFlareDebrisField::AddDebrisComponent : failed to set material (no material or mesh)")
+	}
+
+	return DebrisComponent;
+}
+
+void UFlareDebrisField::WakeDebris(FFlareDebrisInstance& Debris)
+{
+	UInstancedStaticMeshComponent* DebrisComponent = DebrisComponents[Debris.MeshIndex];
+
+	// Remove the instance first, so that it doesn't collide with the actor
+	RemoveDebrisInstance(Debris);
+
 	FActorSpawnParameters Params;
-	Params.Name = Name;
 	Params.Owner = Game;
-	Params.bNoFail = false;
-	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::DontSpawnIfColliding;
-
-	// Compute size, location and rotation
-	FVector Location = FMath::VRand() * SectorScale * FMath::FRandRange(0.2, 1.0);
-	FRotator Rotation = FRotator(FMath::FRandRange(0, 360), FMath::FRandRange(0, 360), FMath::FRandRange(0, 360));
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
 
 	// Spawn
-	AStaticMeshActor* DebrisMesh = Game->GetWorld()->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Location, Rotation, Params);
+	AStaticMeshActor* DebrisMesh = Game->GetWorld()->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Debris.Transform.GetLocation(), Debris.Transform.Rotator(), Params);
 	if (DebrisMesh)
 	{
 		DebrisMesh->SetMobility(EComponentMobility::Movable);
-		DebrisMesh->SetActorScale3D(Size * FVector(1, 1, 1));
+		DebrisMesh->SetActorScale3D(Debris.Transform.GetScale3D());
 		DebrisMesh->SetActorEnableCollision(true);
 
 		// Setup
-		UStaticMeshComponent* DebrisComponent = DebrisMesh->GetStaticMeshComponent();
-		if (DebrisComponent)
+		UStaticMeshComponent* ActorComponent = DebrisMesh->GetStaticMeshComponent();
+		if (ActorComponent)
 		{
-			DebrisComponent->SetStaticMesh(Mesh);
-			DebrisComponent->SetSimulatePhysics(true);
-			DebrisComponent->SetCollisionProfileName("BlockAllDynamic");
-
-			// Set material
-			UMaterialInstanceDynamic* DebrisMaterial = UMaterialInstanceDynamic::Create(DebrisComponent->GetMaterial(0), DebrisComponent->GetWorld());
-			if (DebrisMaterial)
-			{
-				DebrisComponent->SetMaterial(0, DebrisMaterial);
-				DebrisMaterial->SetScalarParameterValue("IceMask", Sector->GetDescription()->IsIcy);
-			}
-			else
-			{
-				FLOG("UFlareDebrisField::AddDebris : failed to set material (no material or mesh)")
-			}
+			ActorComponent->SetStaticMesh(DebrisComponent->StaticMesh);
+			ActorComponent->SetMaterial(0, DebrisComponent->GetMaterial(0));
+			ActorComponent->SetSimulatePhysics(true);
+			ActorComponent->SetCollisionProfileName("BlockAllDynamic");
 		}
+
+		Debris.Actor = DebrisMesh;
+		AwakeDebris.Add(DebrisMesh);
 	}
 	else
 	{
-		FLOG("UFlareDebrisField::AddDebris : failed to spawn debris")
+		FLOG("UFlareDebrisField::WakeDebris : failed to spawn debris")
+		Debris.InstanceIndex = DebrisComponent->AddInstance(Debris.Transform);
 	}
+}
+
+void UFlareDebrisField::SleepDebris(FFlareDebrisInstance& Debris)
+{
+	// Keep the debris where the simulation left it
+	Debris.Transform = Debris.Actor->GetActorTransform();
+	Debris.InstanceIndex = DebrisComponents[Debris.MeshIndex]->AddInstance(Debris.Transform);
+
+	AwakeDebris.RemoveSwap(Debris.Actor);
+	Game->GetWorld()->DestroyActor(Debris.Actor);
+	Debris.Actor = NULL;
+}
+
+void UFlareDebrisField::RemoveDebrisInstance(FFlareDebrisInstance& Debris)
+{
+	int32 RemovedIndex = Debris.InstanceIndex;
+	DebrisComponents[Debris.MeshIndex]->RemoveInstance(RemovedIndex);
+	Debris.InstanceIndex = INDEX_NONE;
 
-	return DebrisMesh;
+	// The following instances of the component moved down
+	for (int32 Index = 0; Index < DebrisField.Num(); Index++)
+	{
+		FFlareDebrisInstance& Other = DebrisField[Index];
+		if (Other.MeshIndex == Debris.MeshIndex && Other.InstanceIndex > RemovedIndex)
+		{
+			Other.InstanceIndex--;
+		}
+	}
 }
 
 
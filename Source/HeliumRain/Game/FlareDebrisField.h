@@ -6,6 +6,22 @@
 
 class AFlareGame;
 class UFlareSimulatedSector;
+struct FFlareDebrisFieldInfo;
+
+
+/** Debris placement, generated from the sector seed */
+struct FFlareDebrisInstance
+{
+	/** Catalog mesh index, and instance index in the mesh component or INDEX_NONE while awake */
+	int32 MeshIndex;
+	int32 InstanceIndex;
+
+	/** Initial transform, or last transform before going back to sleep */
+	FTransform Transform;
+
+	/** Physics actor replacing the instance near the player, or NULL */
+	AStaticMeshActor* Actor;
+};
 
 
 UCLASS()
@@ -28,6 +44,12 @@ public:
 	/** Toggle the game pause */
 	void SetWorldPause(bool Pause);
 
+	/** Wake up the debris near the player, put back to sleep the others */
+	void Tick(float DeltaSeconds);
+
+	/** Generate the debris placement of a sector, always the same for a sector */
+	static void GenerateDebris(const FFlareDebrisFieldInfo* DebrisFieldInfo, FName SectorIdentifier, TArray<FFlareDebrisInstance>& Debris);
+
 
 private:
 
@@ -35,8 +57,17 @@ private:
 		Internals
 	----------------------------------------------------*/
 
-	/** Add debris */
-	AStaticMeshActor* AddDebris(UFlareSimulatedSector* Sector, UStaticMesh* Mesh, float Debris, float SectorScale, FName Name);
+	/** Create the instanced mesh component for a catalog mesh */
+	UInstancedStaticMeshComponent* AddDebrisComponent(UFlareSimulatedSector* Sector, UStaticMesh* Mesh);
+
+	/** Replace an instance by a physics actor */
+	void WakeDebris(FFlareDebrisInstance& Debris);
+
+	/** Replace a physics actor by an instance */
+	void SleepDebris(FFlareDebrisInstance& Debris);
+
+	/** Remove the instance of a debris from its mesh component */
+	void RemoveDebrisInstance(FFlareDebrisInstance& Debris);
 	
 
 protected:
@@ -45,15 +76,35 @@ protected:
         Protected data
     ----------------------------------------------------*/
 
-	/** Debris field */
+	/** Actor holding the instanced meshes */
 	UPROPERTY()
-	TArray<AStaticMeshActor*>                  DebrisField;
+	AActor*                                    DebrisFieldActor;
+
+	/** Instanced mesh per catalog mesh */
+	UPROPERTY()
+	TArray<UInstancedStaticMeshComponent*>     DebrisComponents;
+
+	/** Debris currently simulated */
+	UPROPERTY()
+	TArray<AStaticMeshActor*>                  AwakeDebris;
 	
 	/** Game reference */
 	UPROPERTY()
 	AFlareGame*                                Game;
 
 	// Data
-	int32                                      CurrentGenerationIndex;
+	TArray<FFlareDebrisInstance>               DebrisField;
+	bool                                       IsPaused;
+
+public:
+
+	/*----------------------------------------------------
+		Getters
+	----------------------------------------------------*/
+
+	inline const TArray<FFlareDebrisInstance>& GetDebris() const
+	{
+		return DebrisField;
+	}
 
 };
@@ -0,0 +1,530 @@
+
+#include "../Flare.h"
+#include "FlareEconomyAnalyzer.h"
+#include "FlareGame.h"
+#include "FlareWorld.h"
+#include "FlareWorldHelper.h"
+#include "FlareCompany.h"
+#include "FlareSimulatedSector.h"
+#include "FlareScenarioTools.h"
+#include "../Economy/FlareFactory.h"
+#include "../Economy/FlarePeople.h"
+#include "../Spacecrafts/FlareSimulatedSpacecraft.h"
+
+/** Supply ratio under which a resource is starving */
+#define ECONOMY_STARVING_RATIO 0.99f
+
+/** Monthly price variation considered as a drift */
+#define ECONOMY_PRICE_DRIFT_RATIO 0.1f
+
+/** Lowest utilization of a factory or consumer, so that a starved loop can restart once its inputs are produced */
+#define ECONOMY_MIN_UTILIZATION 0.001f
+
+/** Full rate flow of a factory, per day */
+struct EconomyFlow
+{
+	int32 ResourceIndex;
+	float Quantity;
+};
+
+
+/*----------------------------------------------------
+	Analysis
+----------------------------------------------------*/
+
+EconomyAnalyzer::Report EconomyAnalyzer::Analyze(AFlareGame* Game)
+{
+	Report EconomyReport;
+	UFlareWorld* World = Game->GetGameWorld();
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	EconomyReport.Date = World->GetDate();
+
+	// Station classes, at the price bounds
+	TArray<UFlareSpacecraftCatalogEntry*>& StationCatalog = Game->GetSpacecraftCatalog()->StationCatalog;
+	for (int32 StationIndex = 0; StationIndex < StationCatalog.Num(); StationIndex++)
+	{
+		FFlareSpacecraftDescription* StationDescription = &StationCatalog[StationIndex]->Data;
+		for (int32 FactoryIndex = 0; FactoryIndex < StationDescription->Factories.Num(); FactoryIndex++)
+		{
+			FFlareFactoryDescription* FactoryDescription = &StationDescription->Factories[FactoryIndex]->Data;
+			if (FactoryDescription->IsShipyard())
+			{
+				continue;
+			}
+
+			FactoryCycleStats Cycle;
+			Cycle.StationDescription = StationDescription;
+			Cycle.FactoryIndex = FactoryIndex;
+			Cycle.ProductionTime = FactoryDescription->CycleCost.ProductionTime;
+			Cycle.MinMargin = ComputeCycleMargin(FactoryDescription->CycleCost, NULL, EFlareCyclePrices::Min);
+			Cycle.MaxMargin = ComputeCycleMargin(FactoryDescription->CycleCost, NULL, EFlareCyclePrices::Max);
+			EconomyReport.Cycles.Add(Cycle);
+		}
+	}
+
+	// Stations in the world, at their level and sector prices
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = World->GetSectors()[SectorIndex];
+		for (int32 StationIndex = 0; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
+		{
+			UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
+			for (int32 FactoryIndex = 0; FactoryIndex < Station->GetFactories().Num(); FactoryIndex++)
+			{
+				UFlareFactory* Factory = Station->GetFactories()[FactoryIndex];
+				if (Factory->IsShipyard())
+				{
+					continue;
+				}
+
+				const FFlareProductionData& CycleData = Factory->GetCycleData();
+
+				StationFactoryStats Stats;
+				Stats.Station = Station;
+				Stats.Factory = Factory;
+				Stats.FactoryIndex = FactoryIndex;
+				Stats.ProductionTime = Factory->GetProductionDuration();
+				Stats.Running = Factory->IsActive() && Factory->IsNeedProduction() && Stats.ProductionTime > 0;
+				Stats.MinMargin = ComputeCycleMargin(CycleData, Sector, EFlareCyclePrices::Min);
+				Stats.MaxMargin = ComputeCycleMargin(CycleData, Sector, EFlareCyclePrices::Max);
+				Stats.CurrentMargin = ComputeCycleMargin(CycleData, Sector, EFlareCyclePrices::Current);
+				Stats.Utilization = 0;
+				EconomyReport.Factories.Add(Stats);
+			}
+		}
+	}
+
+	// Resources, by catalog index for the solver
+	TMap<FFlareResourceDescription*, WorldHelper::FlareResourceStats> WorldStats = WorldHelper::ComputeWorldResourceStats(Game);
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->Resources.Num(); ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = &ResourceCatalog->Resources[ResourceIndex]->Data;
+
+		ResourceStats Stats;
+		FMemory::Memzero(Stats);
+		Stats.Resource = Resource;
+		Stats.Stock = WorldStats[Resource].Stock;
+
+		// Mean sector price, and its variation over a month
+		float PreviousPrice = 0;
+		for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+		{
+			UFlareSimulatedSector* Sector = World->GetSectors()[SectorIndex];
+			Stats.MeanPrice += Sector->GetPreciseResourcePrice(Resource);
+			PreviousPrice += Sector->GetPreciseResourcePrice(Resource, ECONOMY_PRICE_DRIFT_AGE);
+		}
+
+		if (World->GetSectors().Num() > 0)
+		{
+			Stats.MeanPrice /= World->GetSectors().Num();
+			PreviousPrice /= World->GetSectors().Num();
+		}
+
+		Stats.MeanPriceDrift = (PreviousPrice > 0) ? (Stats.MeanPrice - PreviousPrice) / PreviousPrice : 0;
+		if (Resource->MaxPrice > Resource->MinPrice)
+		{
+			Stats.PricePosition = (Stats.MeanPrice - Resource->MinPrice) / (float) (Resource->MaxPrice - Resource->MinPrice);
+		}
+
+		EconomyReport.Resources.Add(Stats);
+	}
+
+	EconomyReport.EquilibriumConverged = SolveEquilibrium(Game, EconomyReport.Factories, EconomyReport.Resources, EconomyReport.EquilibriumIterations);
+
+	// Stable order between builds and saves
+	EconomyReport.Resources.Sort([](const ResourceStats& A, const ResourceStats& B)
+	{
+		return A.Resource->Identifier.ToString() < B.Resource->Identifier.ToString();
+	});
+
+	EconomyReport.Cycles.Sort([](const FactoryCycleStats& A, const FactoryCycleStats& B)
+	{
+		if (A.StationDescription != B.StationDescription)
+		{
+			return A.StationDescription->Identifier.ToString() < B.StationDescription->Identifier.ToString();
+		}
+		return A.FactoryIndex < B.FactoryIndex;
+	});
+
+	EconomyReport.Factories.Sort([](const StationFactoryStats& A, const StationFactoryStats& B)
+	{
+		if (A.Station != B.Station)
+		{
+			return A.Station->GetImmatriculation().ToString() < B.Station->GetImmatriculation().ToString();
+		}
+		return A.FactoryIndex < B.FactoryIndex;
+	});
+
+	return EconomyReport;
+}
+
+EconomyAnalyzer::CycleMargin EconomyAnalyzer::ComputeCycleMargin(const FFlareProductionData& Cycle, UFlareSimulatedSector* Sector, EFlareCyclePrices::Type Prices)
+{
+	CycleMargin Result;
+	Result.Revenue = 0;
+	Result.Cost = Cycle.ProductionCost;
+
+	// Inputs are bought with the transport fee
+	for (int32 ResourceIndex = 0; ResourceIndex < Cycle.InputResources.Num(); ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &Cycle.InputResources[ResourceIndex];
+		FFlareResourceDescription* Description = &Resource->Resource->Data;
+
+		int64 Price;
+		switch (Prices)
+		{
+			case EFlareCyclePrices::Min:     Price = Description->MaxPrice + Description->TransportFee; break;
+			case EFlareCyclePrices::Max:     Price = Description->MinPrice + Description->TransportFee; break;
+			case EFlareCyclePrices::Current:
+			default:                         Price = Sector->GetResourcePrice(Description, EFlareResourcePriceContext::FactoryInput); break;
+		}
+
+		Result.Cost += Price * Resource->Quantity;
+	}
+
+	// Outputs are sold without it
+	for (int32 ResourceIndex = 0; ResourceIndex < Cycle.OutputResources.Num(); ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &Cycle.OutputResources[ResourceIndex];
+		FFlareResourceDescription* Description = &Resource->Resource->Data;
+
+		int64 Price;
+		switch (Prices)
+		{
+			case EFlareCyclePrices::Min:     Price = Description->MinPrice - Description->TransportFee; break;
+			case EFlareCyclePrices::Max:     Price = Description->MaxPrice - Description->TransportFee; break;
+			case EFlareCyclePrices::Current:
+			default:                         Price = Sector->GetResourcePrice(Description, EFlareResourcePriceContext::FactoryOutput); break;
+		}
+
+		Result.Revenue += Price * Resource->Quantity;
+	}
+
+	Result.Benefit = Result.Revenue - Result.Cost;
+	Result.Margin = (Result.Revenue != 0) ? (float) Result.Benefit / (float) Result.Revenue : 0;
+	return Result;
+}
+
+bool EconomyAnalyzer::SolveEquilibrium(AFlareGame* Game, TArray<StationFactoryStats>& Factories, TArray<ResourceStats>& Resources, int32& Iterations)
+{
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	UFlareWorld* World = Game->GetGameWorld();
+	int32 ResourceCount = Resources.Num();
+
+	// Full rate flows of each factory
+	TArray<TArray<EconomyFlow> > Inputs;
+	TArray<TArray<EconomyFlow> > Outputs;
+	Inputs.SetNum(Factories.Num());
+	Outputs.SetNum(Factories.Num());
+	for (int32 FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+	{
+		StationFactoryStats& Stats = Factories[FactoryIndex];
+		Stats.Utilization = Stats.Running ? 1 : 0;
+		if (!Stats.Running)
+		{
+			continue;
+		}
+
+		const FFlareProductionData& CycleData = Stats.Factory->GetCycleData();
+		for (int32 ResourceIndex = 0; ResourceIndex < CycleData.InputResources.Num(); ResourceIndex++)
+		{
+			const FFlareFactoryResource* Resource = &CycleData.InputResources[ResourceIndex];
+			EconomyFlow Flow;
+			Flow.ResourceIndex = ResourceCatalog->GetResourceIndex(&Resource->Resource->Data);
+			Flow.Quantity = (float) Resource->Quantity / (float) Stats.ProductionTime;
+			Inputs[FactoryIndex].Add(Flow);
+		}
+		for (int32 ResourceIndex = 0; ResourceIndex < CycleData.OutputResources.Num(); ResourceIndex++)
+		{
+			const FFlareFactoryResource* Resource = &CycleData.OutputResources[ResourceIndex];
+			EconomyFlow Flow;
+			Flow.ResourceIndex = ResourceCatalog->GetResourceIndex(&Resource->Resource->Data);
+			Flow.Quantity = (float) Resource->Quantity / (float) Stats.ProductionTime;
+			Outputs[FactoryIndex].Add(Flow);
+			Resources[Flow.ResourceIndex].CapacityProduction += Flow.Quantity;
+		}
+	}
+
+	// Population and fleet supply demand
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = World->GetSectors()[SectorIndex];
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->ConsumerResources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &ResourceCatalog->ConsumerResources[ResourceIndex]->Data;
+			Resources[ResourceCatalog->GetResourceIndex(Resource)].ConsumerDemand += Sector->GetPeople()->GetRessourceConsumption(Resource);
+		}
+	}
+
+	FFlareResourceDescription* FleetSupply = Game->GetScenarioTools()->FleetSupply;
+	if (FleetSupply)
+	{
+		FFlareFloatBuffer* Stats = &World->GetData()->FleetSupplyConsumptionStats;
+		Resources[ResourceCatalog->GetResourceIndex(FleetSupply)].ConsumerDemand += Stats->GetMean(0, Stats->MaxSize - 1);
+	}
+
+	// Consumers share the resources in proportion to what they use : each step moves them
+	// towards the rate their scarcest input allows, until production matches consumption
+	TArray<float> ConsumerRatios;
+	TArray<float> Production;
+	TArray<float> Consumption;
+	ConsumerRatios.Init(1, ResourceCount);
+	Production.SetNum(ResourceCount);
+	Consumption.SetNum(ResourceCount);
+
+	bool Converged = false;
+	for (Iterations = 1; Iterations <= ECONOMY_EQUILIBRIUM_MAX_ITERATIONS; Iterations++)
+	{
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			Production[ResourceIndex] = 0;
+			Consumption[ResourceIndex] = ConsumerRatios[ResourceIndex] * Resources[ResourceIndex].ConsumerDemand;
+		}
+
+		for (int32 FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+		{
+			float Utilization = Factories[FactoryIndex].Utilization;
+			for (int32 FlowIndex = 0; FlowIndex < Inputs[FactoryIndex].Num(); FlowIndex++)
+			{
+				Consumption[Inputs[FactoryIndex][FlowIndex].ResourceIndex] += Utilization * Inputs[FactoryIndex][FlowIndex].Quantity;
+			}
+			for (int32 FlowIndex = 0; FlowIndex < Outputs[FactoryIndex].Num(); FlowIndex++)
+			{
+				Production[Outputs[FactoryIndex][FlowIndex].ResourceIndex] += Utilization * Outputs[FactoryIndex][FlowIndex].Quantity;
+			}
+		}
+
+		// Square root of the supply ratio, to damp the oscillations of production loops
+		TArray<float> Steps;
+		Steps.SetNum(ResourceCount);
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			Steps[ResourceIndex] = (Consumption[ResourceIndex] > 0) ? FMath::Sqrt(Production[ResourceIndex] / Consumption[ResourceIndex]) : 1;
+		}
+
+		float MaxChange = 0;
+		for (int32 FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+		{
+			StationFactoryStats& Stats = Factories[FactoryIndex];
+			if (!Stats.Running)
+			{
+				continue;
+			}
+
+			float Step = MAX_FLT;
+			for (int32 FlowIndex = 0; FlowIndex < Inputs[FactoryIndex].Num(); FlowIndex++)
+			{
+				Step = FMath::Min(Step, Steps[Inputs[FactoryIndex][FlowIndex].ResourceIndex]);
+			}
+
+			// Raw producers always run at full rate
+			float Utilization = (Inputs[FactoryIndex].Num() > 0) ? FMath::Clamp(Stats.Utilization * Step, ECONOMY_MIN_UTILIZATION, 1.f) : 1.f;
+			MaxChange = FMath::Max(MaxChange, FMath::Abs(Utilization - Stats.Utilization));
+			Stats.Utilization = Utilization;
+		}
+
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			float Ratio = FMath::Clamp(ConsumerRatios[ResourceIndex] * Steps[ResourceIndex], ECONOMY_MIN_UTILIZATION, 1.f);
+			MaxChange = FMath::Max(MaxChange, FMath::Abs(Ratio - ConsumerRatios[ResourceIndex]));
+			ConsumerRatios[ResourceIndex] = Ratio;
+		}
+
+		if (MaxChange < KINDA_SMALL_NUMBER)
+		{
+			Converged = true;
+			break;
+		}
+	}
+	Iterations = FMath::Min(Iterations, ECONOMY_EQUILIBRIUM_MAX_ITERATIONS);
+
+	// Final flows
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+	{
+		ResourceStats& Stats = Resources[ResourceIndex];
+		Stats.Production = 0;
+		Stats.FactoryConsumption = 0;
+		Stats.ConsumerSupply = ConsumerRatios[ResourceIndex] * Stats.ConsumerDemand;
+	}
+
+	TArray<float> FactoryDemand;
+	FactoryDemand.Init(0, ResourceCount);
+	for (int32 FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+	{
+		float Utilization = Factories[FactoryIndex].Utilization;
+		for (int32 FlowIndex = 0; FlowIndex < Inputs[FactoryIndex].Num(); FlowIndex++)
+		{
+			Resources[Inputs[FactoryIndex][FlowIndex].ResourceIndex].FactoryConsumption += Utilization * Inputs[FactoryIndex][FlowIndex].Quantity;
+			FactoryDemand[Inputs[FactoryIndex][FlowIndex].ResourceIndex] += Inputs[FactoryIndex][FlowIndex].Quantity;
+		}
+		for (int32 FlowIndex = 0; FlowIndex < Outputs[FactoryIndex].Num(); FlowIndex++)
+		{
+			Resources[Outputs[FactoryIndex][FlowIndex].ResourceIndex].Production += Utilization * Outputs[FactoryIndex][FlowIndex].Quantity;
+		}
+	}
+
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+	{
+		ResourceStats& Stats = Resources[ResourceIndex];
+		float Demand = FactoryDemand[ResourceIndex] + Stats.ConsumerDemand;
+		Stats.SupplyRatio = (Demand > 0) ? (Stats.FactoryConsumption + Stats.ConsumerSupply) / Demand : 1;
+	}
+
+	return Converged;
+}
+
+
+/*----------------------------------------------------
+	Output
+----------------------------------------------------*/
+
+bool EconomyAnalyzer::WriteReport(const Report& EconomyReport, const FString& BasePath)
+{
+	bool Success = FFileHelper::SaveStringToFile(FormatJson(EconomyReport), *(BasePath + TEXT(".json")));
+	Success &= FFileHelper::SaveStringToFile(FormatResourcesCsv(EconomyReport), *(BasePath + TEXT("-resources.csv")));
+	Success &= FFileHelper::SaveStringToFile(FormatFactoriesCsv(EconomyReport), *(BasePath + TEXT("-factories.csv")));
+
+	if (Success)
+	{
+		FLOGV("EconomyAnalyzer::WriteReport : wrote %s", *BasePath);
+	}
+	else
+	{
+		FLOGV("EconomyAnalyzer::WriteReport failed: can't write %s", *BasePath);
+	}
+
+	return Success;
+}
+
+void EconomyAnalyzer::LogWarnings(const Report& EconomyReport)
+{
+	for (int32 ResourceIndex = 0; ResourceIndex < EconomyReport.Resources.Num(); ResourceIndex++)
+	{
+		const ResourceStats& Stats = EconomyReport.Resources[ResourceIndex];
+		if (Stats.SupplyRatio < ECONOMY_STARVING_RATIO)
+		{
+			FLOGV("EconomyAnalyzer : %s is starving, %.1f %% supplied", *Stats.Resource->Identifier.ToString(), Stats.SupplyRatio * 100);
+		}
+		if (FMath::Abs(Stats.MeanPriceDrift) > ECONOMY_PRICE_DRIFT_RATIO)
+		{
+			FLOGV("EconomyAnalyzer : %s price drifted %.1f %% in %d days", *Stats.Resource->Identifier.ToString(), Stats.MeanPriceDrift * 100, ECONOMY_PRICE_DRIFT_AGE);
+		}
+	}
+
+	for (int32 FactoryIndex = 0; FactoryIndex < EconomyReport.Factories.Num(); FactoryIndex++)
+	{
+		const StationFactoryStats& Stats = EconomyReport.Factories[FactoryIndex];
+		if (Stats.Running && Stats.CurrentMargin.Benefit < 0)
+		{
+			FLOGV("EconomyAnalyzer : %s factory %d is unprofitable, %.1f %% margin", *Stats.Station->GetImmatriculation().ToString(), Stats.FactoryIndex, Stats.CurrentMargin.Margin * 100);
+		}
+	}
+
+	FLOGV("EconomyAnalyzer : equilibrium %s after %d iterations", EconomyReport.EquilibriumConverged ? TEXT("found") : TEXT("not found"), EconomyReport.EquilibriumIterations);
+}
+
+/** Fixed precision, so that reports only differ when values do */
+static FString FormatReportFloat(float Value)
+{
+	if (!FMath::IsFinite(Value))
+	{
+		Value = 0;
+	}
+	return FString::Printf(TEXT("%.4f"), Value);
+}
+
+static FString FormatJsonMargin(const FString& Name, const EconomyAnalyzer::CycleMargin& Margin)
+{
+	return FString::Printf(TEXT("\"%s\": {\"revenue\": %lld, \"cost\": %lld, \"benefit\": %lld, \"margin\": %s}"),
+		*Name, Margin.Revenue, Margin.Cost, Margin.Benefit, *FormatReportFloat(Margin.Margin));
+}
+
+FString EconomyAnalyzer::FormatJson(const Report& EconomyReport)
+{
+	FString Json = TEXT("{\n");
+	Json += FString::Printf(TEXT("\t\"date\": %lld,\n"), EconomyReport.Date);
+	Json += FString::Printf(TEXT("\t\"equilibrium\": {\"converged\": %s, \"iterations\": %d},\n"),
+		EconomyReport.EquilibriumConverged ? TEXT("true") : TEXT("false"), EconomyReport.EquilibriumIterations);
+
+	// Resources
+	Json += TEXT("\t\"resources\": [\n");
+	for (int32 ResourceIndex = 0; ResourceIndex < EconomyReport.Resources.Num(); ResourceIndex++)
+	{
+		const ResourceStats& Stats = EconomyReport.Resources[ResourceIndex];
+		Json += FString::Printf(TEXT("\t\t{\"identifier\": \"%s\", \"minPrice\": %lld, \"maxPrice\": %lld, \"transportFee\": %lld, \"meanPrice\": %s, \"priceDrift\": %s, \"pricePosition\": %s, "),
+			*Stats.Resource->Identifier.ToString(), (int64) Stats.Resource->MinPrice, (int64) Stats.Resource->MaxPrice, (int64) Stats.Resource->TransportFee,
+			*FormatReportFloat(Stats.MeanPrice), *FormatReportFloat(Stats.MeanPriceDrift), *FormatReportFloat(Stats.PricePosition));
+		Json += FString::Printf(TEXT("\"stock\": %d, \"capacityProduction\": %s, \"production\": %s, \"factoryConsumption\": %s, \"consumerDemand\": %s, \"consumerSupply\": %s, \"supplyRatio\": %s, \"starving\": %s}%s\n"),
+			Stats.Stock, *FormatReportFloat(Stats.CapacityProduction), *FormatReportFloat(Stats.Production), *FormatReportFloat(Stats.FactoryConsumption),
+			*FormatReportFloat(Stats.ConsumerDemand), *FormatReportFloat(Stats.ConsumerSupply), *FormatReportFloat(Stats.SupplyRatio),
+			(Stats.SupplyRatio < ECONOMY_STARVING_RATIO) ? TEXT("true") : TEXT("false"),
+			(ResourceIndex < EconomyReport.Resources.Num() - 1) ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t],\n");
+
+	// Station classes
+	Json += TEXT("\t\"cycles\": [\n");
+	for (int32 CycleIndex = 0; CycleIndex < EconomyReport.Cycles.Num(); CycleIndex++)
+	{
+		const FactoryCycleStats& Stats = EconomyReport.Cycles[CycleIndex];
+		Json += FString::Printf(TEXT("\t\t{\"station\": \"%s\", \"factory\": %d, \"productionTime\": %lld, %s, %s}%s\n"),
+			*Stats.StationDescription->Identifier.ToString(), Stats.FactoryIndex, Stats.ProductionTime,
+			*FormatJsonMargin(TEXT("min"), Stats.MinMargin), *FormatJsonMargin(TEXT("max"), Stats.MaxMargin),
+			(CycleIndex < EconomyReport.Cycles.Num() - 1) ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t],\n");
+
+	// Stations
+	Json += TEXT("\t\"factories\": [\n");
+	for (int32 FactoryIndex = 0; FactoryIndex < EconomyReport.Factories.Num(); FactoryIndex++)
+	{
+		const StationFactoryStats& Stats = EconomyReport.Factories[FactoryIndex];
+		Json += FString::Printf(TEXT("\t\t{\"station\": \"%s\", \"class\": \"%s\", \"level\": %d, \"company\": \"%s\", \"sector\": \"%s\", \"factory\": %d, \"running\": %s, \"productionTime\": %lld, "),
+			*Stats.Station->GetImmatriculation().ToString(), *Stats.Station->GetDescription()->Identifier.ToString(), Stats.Station->GetLevel(),
+			*Stats.Station->GetCompany()->GetIdentifier().ToString(), *Stats.Station->GetCurrentSector()->GetIdentifier().ToString(),
+			Stats.FactoryIndex, Stats.Running ? TEXT("true") : TEXT("false"), Stats.ProductionTime);
+		Json += FString::Printf(TEXT("%s, %s, %s, \"utilization\": %s, \"unprofitable\": %s}%s\n"),
+			*FormatJsonMargin(TEXT("min"), Stats.MinMargin), *FormatJsonMargin(TEXT("max"), Stats.MaxMargin), *FormatJsonMargin(TEXT("current"), Stats.CurrentMargin),
+			*FormatReportFloat(Stats.Utilization), (Stats.Running && Stats.CurrentMargin.Benefit < 0) ? TEXT("true") : TEXT("false"),
+			(FactoryIndex < EconomyReport.Factories.Num() - 1) ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t]\n");
+
+	Json += TEXT("}\n");
+	return Json;
+}
+
+FString EconomyAnalyzer::FormatResourcesCsv(const Report& EconomyReport)
+{
+	FString Csv = TEXT("Date,Resource,MeanPrice,PriceDrift,PricePosition,Stock,CapacityProduction,Production,FactoryConsumption,ConsumerDemand,ConsumerSupply,SupplyRatio\n");
+
+	for (int32 ResourceIndex = 0; ResourceIndex < EconomyReport.Resources.Num(); ResourceIndex++)
+	{
+		const ResourceStats& Stats = EconomyReport.Resources[ResourceIndex];
+		Csv += FString::Printf(TEXT("%lld,%s,%s,%s,%s,%d,%s,%s,%s,%s,%s,%s\n"),
+			EconomyReport.Date, *Stats.Resource->Identifier.ToString(),
+			*FormatReportFloat(Stats.MeanPrice), *FormatReportFloat(Stats.MeanPriceDrift), *FormatReportFloat(Stats.PricePosition), Stats.Stock,
+			*FormatReportFloat(Stats.CapacityProduction), *FormatReportFloat(Stats.Production), *FormatReportFloat(Stats.FactoryConsumption),
+			*FormatReportFloat(Stats.ConsumerDemand), *FormatReportFloat(Stats.ConsumerSupply), *FormatReportFloat(Stats.SupplyRatio));
+	}
+
+	return Csv;
+}
+
+FString EconomyAnalyzer::FormatFactoriesCsv(const Report& EconomyReport)
+{
+	FString Csv = TEXT("Date,Station,Class,Level,Company,Sector,Factory,Running,ProductionTime,MinMargin,MaxMargin,CurrentBenefit,CurrentMargin,Utilization\n");
+
+	for (int32 FactoryIndex = 0; FactoryIndex < EconomyReport.Factories.Num(); FactoryIndex++)
+	{
+		const StationFactoryStats& Stats = EconomyReport.Factories[FactoryIndex];
+		Csv += FString::Printf(TEXT("%lld,%s,%s,%d,%s,%s,%d,%d,%lld,%s,%s,%lld,%s,%s\n"),
+			EconomyReport.Date, *Stats.Station->GetImmatriculation().ToString(), *Stats.Station->GetDescription()->Identifier.ToString(), Stats.Station->GetLevel(),
+			*Stats.Station->GetCompany()->GetIdentifier().ToString(), *Stats.Station->GetCurrentSector()->GetIdentifier().ToString(),
+			Stats.FactoryIndex, Stats.Running ? 1 : 0, Stats.ProductionTime,
+			*FormatReportFloat(Stats.MinMargin.Margin), *FormatReportFloat(Stats.MaxMargin.Margin),
+			Stats.CurrentMargin.Benefit, *FormatReportFloat(Stats.CurrentMargin.Margin), *FormatReportFloat(Stats.Utilization));
+	}
+
+	return Csv;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "../Economy/FlareResource.h"
+#include "FlareWorld.h"
+
+
+class UFlareFactory;
+struct FFlareProductionData;
+struct FFlareFactoryDescription;
+
+/** Maximum number of equilibrium solver iterations */
+#define ECONOMY_EQUILIBRIUM_MAX_ITERATIONS 1000
+
+/** Age of the price used to measure price drifts, in days */
+#define ECONOMY_PRICE_DRIFT_AGE 30
+
+
+/** Prices used to evaluate a factory cycle */
+namespace EFlareCyclePrices
+{
+	enum Type
+	{
+		Min, /** Inputs at their max price, outputs at their min price */
+		Max, /** Inputs at their min price, outputs at their max price */
+		Current, /** Sector prices */
+	};
+}
+
+/** Economy balance analysis, for reports that can be compared between builds and saves */
+struct EconomyAnalyzer
+{
+	/** Balance of one factory cycle, in credits */
+	struct CycleMargin
+	{
+		int64 Revenue;
+		int64 Cost;
+		int64 Benefit;
+		float Margin;
+	};
+
+	/** Factory cycle of a station class */
+	struct FactoryCycleStats
+	{
+		FFlareSpacecraftDescription* StationDescription;
+		int32 FactoryIndex;
+		int64 ProductionTime;
+		CycleMargin MinMargin;
+		CycleMargin MaxMargin;
+	};
+
+	/** Factory of a station in the world */
+	struct StationFactoryStats
+	{
+		UFlareSimulatedSpacecraft* Station;
+		UFlareFactory* Factory;
+		int32 FactoryIndex;
+		bool Running;
+		int64 ProductionTime;
+		CycleMargin MinMargin;
+		CycleMargin MaxMargin;
+		CycleMargin CurrentMargin;
+
+		/** Fraction of the full production rate at equilibrium */
+		float Utilization;
+	};
+
+	/** World flows of a resource at equilibrium, per day */
+	struct ResourceStats
+	{
+		FFlareResourceDescription* Resource;
+		int32 Stock;
+		float CapacityProduction;
+		float Production;
+		float FactoryConsumption;
+		float ConsumerDemand;
+		float ConsumerSupply;
+
+		/** Fraction of the demand that is supplied */
+		float SupplyRatio;
+
+		float MeanPrice;
+		float MeanPriceDrift;
+
+		/** Mean price position between the min and max prices */
+		float PricePosition;
+	};
+
+	/** Whole world analysis */
+	struct Report
+	{
+		int64 Date;
+		TArray<ResourceStats> Resources;
+		TArray<FactoryCycleStats> Cycles;
+		TArray<StationFactoryStats> Factories;
+		int32 EquilibriumIterations;
+		bool EquilibriumConverged;
+	};
+
+	/** Analyze the loaded world */
+	static Report Analyze(AFlareGame* Game);
+
+	/** Get the balance of a cycle. Sector is only used for current prices */
+	static CycleMargin ComputeCycleMargin(const FFlareProductionData& Cycle, UFlareSimulatedSector* Sector, EFlareCyclePrices::Type Prices);
+
+	/** Find the factory utilizations where no resource is consumed faster than it is produced, and return if the solver converged */
+	static bool SolveEquilibrium(AFlareGame* Game, TArray<StationFactoryStats>& Factories, TArray<ResourceStats>& Resources, int32& Iterations);
+
+	/** Write BasePath.json, BasePath-resources.csv and BasePath-factories.csv */
+	static bool WriteReport(const Report& EconomyReport, const FString& BasePath);
+
+	/** Log the starving resources, the drifting prices and the unprofitable stations */
+	static void LogWarnings(const Report& EconomyReport);
+
+
+private:
+
+	static FString FormatJson(const Report& EconomyReport);
+
+	static FString FormatResourcesCsv(const Report& EconomyReport);
+
+	static FString FormatFactoriesCsv(const Report& EconomyReport);
+
+};
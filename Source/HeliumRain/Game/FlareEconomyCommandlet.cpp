@@ -0,0 +1,86 @@
+
+#include "../Flare.h"
+#include "FlareEconomyCommandlet.h"
+#include "FlareEconomyAnalyzer.h"
+#include "FlareGame.h"
+#include "FlareWorld.h"
+#include "../Player/FlarePlayerController.h"
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+UFlareEconomyCommandlet::UFlareEconomyCommandlet(const class FObjectInitializer& PCIP)
+	: Super(PCIP)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+
+/*----------------------------------------------------
+	Commandlet
+----------------------------------------------------*/
+
+int32 UFlareEconomyCommandlet::Main(const FString& Params)
+{
+	int32 Slot = 1;
+	int32 DayCount = 0;
+	int32 Interval = 30;
+	FString OutputDirectory = FPaths::GameSavedDir() / TEXT("Economy");
+
+	FParse::Value(*Params, TEXT("Slot="), Slot);
+	FParse::Value(*Params, TEXT("Days="), DayCount);
+	FParse::Value(*Params, TEXT("Interval="), Interval);
+	FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+	Interval = FMath::Max(Interval, 1);
+
+	// Game world with the game mode and a player controller, as the simulation expects them
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	AFlareGame* Game = World->SpawnActor<AFlareGame>();
+	World->AuthorityGameMode = Game;
+	AFlarePlayerController* PC = World->SpawnActor<AFlarePlayerController>();
+
+	Game->SetCurrentSlot(Slot);
+	if (!Game->LoadGame(PC))
+	{
+		FLOGV("UFlareEconomyCommandlet::Main failed: can't load slot %d", Slot);
+		return 1;
+	}
+
+	// Report the loaded world, then every interval
+	int32 ReportCount = 0;
+	for (int32 Day = 0; Day <= DayCount; Day++)
+	{
+		if (Day > 0)
+		{
+			Game->GetGameWorld()->Simulate();
+		}
+
+		if (Day % Interval == 0 || Day == DayCount)
+		{
+			EconomyAnalyzer::Report EconomyReport = EconomyAnalyzer::Analyze(Game);
+			EconomyAnalyzer::LogWarnings(EconomyReport);
+
+			FString BasePath = OutputDirectory / FString::Printf(TEXT("EconomyReport-%lld"), EconomyReport.Date);
+			if (!EconomyAnalyzer::WriteReport(EconomyReport, BasePath))
+			{
+				return 1;
+			}
+			ReportCount++;
+		}
+	}
+
+	FLOGV("UFlareEconomyCommandlet::Main : %d days simulated, %d reports in %s", DayCount, ReportCount, *OutputDirectory);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return 0;
+}
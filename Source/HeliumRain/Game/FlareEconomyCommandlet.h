@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlareEconomyCommandlet.generated.h"
+
+
+/** Load a save without a render device, optionally simulate days, and write economy reports
+ *  Usage : HeliumRain -run=FlareEconomy -Slot=1 [-Days=365] [-Interval=30] [-Output=Directory]
+ */
+UCLASS()
+class HELIUMRAIN_API UFlareEconomyCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	virtual int32 Main(const FString& Params) override;
+
+};
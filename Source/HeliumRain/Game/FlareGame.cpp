@@ -4,6 +4,7 @@
 #include "FlareSaveGame.h"
 #include "FlareAsteroid.h"
 #include "FlareDebrisField.h"
+#include "FlareThermalSystem.h"
 #include "FlareGameTools.h"
 #include "FlareScenarioTools.h"
 
@@ -19,9 +20,13 @@
 #include "Save/FlareSaveGameSystem.h"
 #include "AssetRegistryModule.h"
 #include "Log/FlareLogWriter.h"
+#include "../HeliumRainLoadingScreen/FlareLoadingScreen.h"
 
 #define LOCTEXT_NAMESPACE "FlareGame"
 
+/** Time spent spawning sector actors per frame during a staged activation, in seconds */
+#define SECTOR_LOAD_FRAME_BUDGET 0.004
+
 
 /*----------------------------------------------------
 	Constructor
@@ -157,6 +162,9 @@ void AFlareGame::StartPlay()
 
 	// Spawn debris field system
 	DebrisFieldSystem = NewObject<UFlareDebrisField>(this, UFlareDebrisField::StaticClass());
+
+	// Spawn thermal system
+	ThermalSystem = NewObject<UFlareThermalSystem>(this, UFlareThermalSystem::StaticClass());
 }
 
 void AFlareGame::PostLogin(APlayerController* Player)
@@ -180,7 +188,7 @@ void AFlareGame::Logout(AController* Player)
 	Super::Logout(Player);
 }
 
-void AFlareGame::ActivateSector(UFlareSimulatedSector* Sector)
+void AFlareGame::ActivateSector(UFlareSimulatedSector* Sector, bool Staged)
 {
 	if (!Sector)
 	{
@@ -235,20 +243,42 @@ void AFlareGame::ActivateSector(UFlareSimulatedSector* Sector)
 			SectorData->LocalTime = GetGameWorld()->GetDate() * UFlareGameTools::SECONDS_IN_DAY;
 		}
 
-		// Load and setup the sector
+		// Load the player ship now, the rest of the sector over the next frames
 		Planetarium->ResetTime();
 		Planetarium->SkipNight(UFlareGameTools::SECONDS_IN_DAY);
-		ActiveSector->Load(Sector);
-		DebrisFieldSystem->Setup(this, Sector);
+		ActiveSector->BeginLoad(Sector);
+		ActiveSector->LoadStep(Staged ? SECTOR_LOAD_FRAME_BUDGET : 0);
 
 		GetPC()->OnSectorActivated(ActiveSector);
+
+		if (ActiveSector->IsLoaded())
+		{
+			OnSectorLoaded();
+		}
+	}
+	else
+	{
+		GetQuestManager()->OnSectorActivation(Sector);
 	}
+}
+
+void AFlareGame::ActivateCurrentSector(bool Staged)
+{
+	ActivateSector(GetPC()->GetPlayerShip()->GetCurrentSector(), Staged);
+}
+
+void AFlareGame::OnSectorLoaded()
+{
+	UFlareSimulatedSector* Sector = ActiveSector->GetSimulatedSector();
+	FLOGV("AFlareGame::OnSectorLoaded : %s", *Sector->GetSectorName().ToString());
+
+	DebrisFieldSystem->Setup(this, Sector);
 	GetQuestManager()->OnSectorActivation(Sector);
 }
 
-void AFlareGame::ActivateCurrentSector()
+bool AFlareGame::IsSectorLoading() const
 {
-	ActivateSector(GetPC()->GetPlayerShip()->GetCurrentSector());
+	return ActiveSector && !ActiveSector->IsLoaded();
 }
 
 UFlareSimulatedSector* AFlareGame::DeactivateSector()
@@ -271,6 +301,7 @@ UFlareSimulatedSector* AFlareGame::DeactivateSector()
 
 	// Destroy the active sector
 	DebrisFieldSystem->Reset();
+	ThermalSystem->Reset();
 	UnloadStreamingLevel(ActiveSector->GetSimulatedSector()->GetDescription()->LevelName);
 	ActiveSector->DestroySector();
 
@@ -322,6 +353,7 @@ void AFlareGame::Recovery()
 void AFlareGame::SetWorldPause(bool Pause)
 {
 	DebrisFieldSystem->SetWorldPause(Pause);
+	ThermalSystem->SetWorldPause(Pause);
 }
 
 void AFlareGame::Scrap(FName ShipImmatriculation, FName TargetStationImmatriculation)
@@ -399,8 +431,31 @@ void AFlareGame::Tick(float DeltaSeconds)
 		QuestManager->OnTick(DeltaSeconds);
 	}
 
+	// Write aggregated log records
+	FFlareLogWriter::FlushWriter();
+
+	// Continue the staged sector activation
+	if (IsSectorLoading())
+	{
+		bool Loaded = ActiveSector->LoadStep(SECTOR_LOAD_FRAME_BUDGET);
+
+		IFlareLoadingScreenModule* LoadingScreenModule = FModuleManager::GetModulePtr<IFlareLoadingScreenModule>("HeliumRainLoadingScreen");
+		if (LoadingScreenModule)
+		{
+			LoadingScreenModule->SetLoadingProgress(ActiveSector->GetLoadProgress());
+		}
+
+		if (Loaded)
+		{
+			OnSectorLoaded();
+		}
+	}
+
 	if(GetActiveSector() != NULL)
 	{
+		DebrisFieldSystem->Tick(DeltaSeconds);
+		ThermalSystem->Tick(this, DeltaSeconds);
+
 		for (int CompanyIndex = 0; CompanyIndex < GetGameWorld()->GetCompanies().Num(); CompanyIndex++)
 		{
 			GetGameWorld()->GetCompanies()[CompanyIndex]->TickAI();
@@ -557,7 +612,7 @@ bool AFlareGame::DeleteSaveSlot(int32 Index)
 	Save
 ----------------------------------------------------*/
 
-void AFlareGame::CreateGame(AFlarePlayerController* PC, FText CompanyName, int32 ScenarioIndex, bool PlayTutorial)
+void AFlareGame::CreateGame(AFlarePlayerController* PC, FText CompanyName, int32 ScenarioIndex, bool PlayTutorial, const FFlareStressScenarioConfig* StressConfig)
 {
 	FLOGV("AFlareGame::CreateGame ScenarioIndex %d", ScenarioIndex);
 	FLOGV("AFlareGame::CreateGame CompanyName %s", *CompanyName.ToString());
@@ -618,6 +673,9 @@ void AFlareGame::CreateGame(AFlarePlayerController* PC, FText CompanyName, int32
 		case 2: // Debug
 			ScenarioTools->GenerateDebugScenario();
 		break;
+		case 3: // Stress
+			ScenarioTools->GenerateStressScenario(StressConfig ? *StressConfig : FFlareStressScenarioConfig());
+		break;
 	}
 
 	// Load
@@ -654,6 +712,7 @@ UFlareCompany* AFlareGame::CreateCompany(int32 CatalogIdentifier)
 	CompanyData.Money = 0;
 	CompanyData.FleetImmatriculationIndex = 0;
 	CompanyData.TradeRouteImmatriculationIndex = 0;
+	CompanyData.CompanyValueHistory.Init(COMPANY_VALUE_HISTORY);
 	CompanyData.AI.ConstructionProjectNeedCapacity = 0;
 	CompanyData.AI.ConstructionProjectSectorIdentifier = NAME_None;
 	CompanyData.AI.ConstructionProjectStationDescriptionIdentifier = NAME_None;
@@ -811,6 +870,7 @@ void AFlareGame::UnloadGame()
 		ActiveSector = NULL;
 	}
 	DebrisFieldSystem->Reset();
+	ThermalSystem->Reset();
 
 	// Cleanup stuff
 	Clean();
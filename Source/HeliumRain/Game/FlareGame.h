@@ -29,9 +29,11 @@ class UFlareSaveGameSystem;
 class UFlareQuestManager;
 class UFlareQuestCatalog;
 class UFlareDebrisField;
+class UFlareThermalSystem;
 class UFlareSectorCatalogEntry;
 class UFlareScenarioTools;
 struct FFlarePlayerSave;
+struct FFlareStressScenarioConfig;
 
 
 USTRUCT()
@@ -67,9 +69,13 @@ public:
 
 	virtual void Logout(AController* Player) override;
 
-	virtual void ActivateSector(UFlareSimulatedSector* Sector);
+	/** Activate a sector, spawning the player ship now and the rest over the next frames if Staged */
+	virtual void ActivateSector(UFlareSimulatedSector* Sector, bool Staged = true);
 
-	virtual void ActivateCurrentSector();
+	virtual void ActivateCurrentSector(bool Staged = true);
+
+	/** Called once every actor of the active sector is spawned */
+	virtual void OnSectorLoaded();
 
 	virtual UFlareSimulatedSector* DeactivateSector();
 
@@ -114,8 +120,8 @@ public:
 		Save
 	----------------------------------------------------*/
 
-	/** Create a new game from scratch */
-	virtual void CreateGame(AFlarePlayerController* PC, FText CompanyName, int32 ScenarioIndex, bool PlayTutorial);
+	/** Create a new game from scratch. The stress scenario (3) is generated from StressConfig */
+	virtual void CreateGame(AFlarePlayerController* PC, FText CompanyName, int32 ScenarioIndex, bool PlayTutorial, const FFlareStressScenarioConfig* StressConfig = NULL);
 
 	/** Create a company */
 	UFlareCompany* CreateCompany(int32 CatalogIdentifier);
@@ -203,6 +209,10 @@ protected:
 	UPROPERTY()
 	UFlareDebrisField*                         DebrisFieldSystem;
 
+	/** Active sector heat simulation */
+	UPROPERTY()
+	UFlareThermalSystem*                       ThermalSystem;
+
 	/** Player controller */
 	UPROPERTY()
 	AFlarePlayerController*			           PlayerController;
@@ -267,6 +277,9 @@ protected:
 	/** Default asteroid */
 	UPROPERTY()
 	UStaticMesh*                               DefaultAsteroid;
+
+	/** Turret self-occlusion maps, by spacecraft description */
+	TMap<FName, TArray<FFlareTurretFiringMap> > TurretFiringMaps;
 	
 
 	/*----------------------------------------------------
@@ -321,11 +334,36 @@ public:
 		return ActiveSector;
 	}
 
+	/** Check if the active sector is still being spawned */
+	bool IsSectorLoading() const;
+
 	inline AFlarePlanetarium* GetPlanetarium() const
 	{
 		return Planetarium;
 	}
 
+	inline UFlareDebrisField* GetDebrisField() const
+	{
+		return DebrisFieldSystem;
+	}
+
+	inline UFlareThermalSystem* GetThermalSystem() const
+	{
+		return ThermalSystem;
+	}
+
+	/** Get the turret self-occlusion maps of a spacecraft description */
+	inline TArray<FFlareTurretFiringMap>& GetTurretFiringMaps(FName SpacecraftIdentifier)
+	{
+		return TurretFiringMaps.FindOrAdd(SpacecraftIdentifier);
+	}
+
+	/** Find the turret self-occlusion maps of a spacecraft description, NULL if none was baked */
+	inline const TArray<FFlareTurretFiringMap>* FindTurretFiringMaps(FName SpacecraftIdentifier) const
+	{
+		return TurretFiringMaps.Find(SpacecraftIdentifier);
+	}
+
 	inline UFlareQuestManager* GetQuestManager() const
 	{
 		return QuestManager;
@@ -6,6 +6,14 @@
 #include "../Player/FlarePlayerController.h"
 #include "FlareCompany.h"
 #include "FlareSectorHelper.h"
+#include "FlareEconomyAnalyzer.h"
+#include "Diagnostics/FlareDiagnostics.h"
+#include "AI/FlareAIBehavior.h"
+#include "FlareThermalSystem.h"
+#include "../Spacecrafts/FlareTurret.h"
+#include "FlareGameUserSettings.h"
+#include "Log/FlareLogWriter.h"
+#include "Save/FlareSaveWriter.h"
 
 #define LOCTEXT_NAMESPACE "FlareGameTools"
 
@@ -347,6 +355,69 @@ void UFlareGameTools::PrintEconomyStatus()
 	FLOGV("- People dept: %lld $ (%f %%)", PeopleDept/100, 100.f * (float)PeopleDept / (float) PeopleMoney);
 }
 
+void UFlareGameTools::ExportEconomyReport()
+{
+	if (!GetGameWorld())
+	{
+		FLOG("UFlareGameTools::ExportEconomyReport failed: no loaded world");
+		return;
+	}
+
+	EconomyAnalyzer::Report EconomyReport = EconomyAnalyzer::Analyze(GetGame());
+	EconomyAnalyzer::LogWarnings(EconomyReport);
+	EconomyAnalyzer::WriteReport(EconomyReport, FPaths::GameSavedDir() / FString::Printf(TEXT("Economy/EconomyReport-%lld"), EconomyReport.Date));
+}
+
+void UFlareGameTools::SetLogEventLevel(FName EventName, int32 Level, int32 MaxPerSecond)
+{
+	const UEnum* EventEnum = FindObject<UEnum>(ANY_PACKAGE, TEXT("EFlareLogEvent"), true);
+	int32 EventIndex = (EventEnum ? EventEnum->FindEnumIndex(EventName) : INDEX_NONE);
+
+	if (EventIndex == INDEX_NONE || EventIndex >= EFlareLogEvent::EVENT_COUNT)
+	{
+		FLOGV("UFlareGameTools::SetLogEventLevel failed: no log event '%s'", *EventName.ToString());
+		return;
+	}
+
+	if (Level < EFlareLogLevel::Disabled || Level > EFlareLogLevel::Full)
+	{
+		FLOGV("UFlareGameTools::SetLogEventLevel failed: invalid level %d", Level);
+		return;
+	}
+
+	UFlareGameUserSettings* MyGameSettings = Cast<UFlareGameUserSettings>(GEngine->GetGameUserSettings());
+	MyGameSettings->SetLogEventSettings((EFlareLogEvent::Type) EventIndex, (EFlareLogLevel::Type) Level, MaxPerSecond);
+	MyGameSettings->SaveSettings();
+}
+
+void UFlareGameTools::SetLogRateLimit(int32 MaxPerSecond)
+{
+	UFlareGameUserSettings* MyGameSettings = Cast<UFlareGameUserSettings>(GEngine->GetGameUserSettings());
+	MyGameSettings->SetLogMaxPerSecond(MaxPerSecond);
+	MyGameSettings->SaveSettings();
+}
+
+void UFlareGameTools::PrintLogSettings()
+{
+	const FFlareLogFilter& Filter = FFlareLogWriter::GetFilter();
+
+	FLOGV("Log settings : %d messages per second max", Filter.GetGlobalMaxPerSecond());
+
+	for (int32 EventIndex = 0; EventIndex < EFlareLogEvent::EVENT_COUNT; EventIndex++)
+	{
+		const FlareLogEventRule& Rule = Filter.GetRule((EFlareLogEvent::Type) EventIndex);
+		FLOGV("- %s : %s, %d per second max",
+			*UFlareSaveWriter::FormatEnum<EFlareLogEvent::Type>("EFlareLogEvent", (EFlareLogEvent::Type) EventIndex),
+			*UFlareSaveWriter::FormatEnum<EFlareLogLevel::Type>("EFlareLogLevel", Rule.Level),
+			Rule.MaxPerSecond);
+	}
+}
+
+void UFlareGameTools::RunDiagnostics(FString CheckName, int32 Count)
+{
+	FlareDiagnostics::Run(GetGame(), CheckName, Count, false);
+}
+
 
 /*----------------------------------------------------
 	World tools
@@ -405,6 +476,88 @@ void UFlareGameTools::SetPlanatariumTimeMultiplier(float Multiplier)
 	GetGame()->GetPlanetarium()->SetTimeMultiplier(Multiplier);
 }
 
+void UFlareGameTools::SetTurretFiringMapValidation(bool Validation)
+{
+	UFlareTurret::FiringMapValidation = Validation;
+}
+
+void UFlareGameTools::PrintHeatCurve(FName ShipImmatriculation, float Duration)
+{
+	if (!GetActiveSector())
+	{
+		FLOG("UFlareGameTools::PrintHeatCurve failed: no active sector");
+		return;
+	}
+
+	AFlareSpacecraft* Spacecraft = GetActiveSector()->FindSpacecraft(ShipImmatriculation);
+	if (!Spacecraft)
+	{
+		FLOGV("UFlareGameTools::PrintHeatCurve failed: no spacecraft '%s' in the active sector", *ShipImmatriculation.ToString());
+		return;
+	}
+
+	UFlareThermalSystem* ThermalSystem = GetGame()->GetThermalSystem();
+	TArray<float> Temperatures;
+	ThermalSystem->GetHeatCurve(Spacecraft, Duration, 10, Temperatures);
+
+	FLOGV("UFlareGameTools::PrintHeatCurve : %s : production %f KW, heat sink %f m2, temperature %f, equilibrium %f, overheat in %f s",
+		*ShipImmatriculation.ToString(),
+		ThermalSystem->GetHeatProduction(Spacecraft),
+		ThermalSystem->GetHeatSinkSurface(Spacecraft),
+		Spacecraft->GetParent()->GetDamageSystem()->GetTemperature(),
+		ThermalSystem->GetEquilibriumTemperature(Spacecraft),
+		ThermalSystem->GetTimeToOverheat(Spacecraft, Duration));
+
+	for (int32 Index = 0; Index < Temperatures.Num(); Index++)
+	{
+		FLOGV("UFlareGameTools::PrintHeatCurve :   %f s : %f K", Duration * (Index + 1) / Temperatures.Num(), Temperatures[Index]);
+	}
+}
+
+void UFlareGameTools::ExportSpacecraftPrices()
+{
+	if (!GetGameWorld())
+	{
+		FLOG("UFlareGameTools::ExportSpacecraftPrices failed: no loaded world");
+		return;
+	}
+
+	UFlareSpacecraftCatalog* SpacecraftCatalog = GetGame()->GetSpacecraftCatalog();
+	const TArray<UFlareSimulatedSector*>& Sectors = GetGameWorld()->GetSectors();
+
+	// Prices in credits
+	FString Csv = TEXT("Sector,Spacecraft,Station,Price,PriceWithMargin,ConstructionPrice,ConstructionPriceWithMargin\n");
+	for (int32 SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Sectors[SectorIndex];
+
+		for (int32 SpacecraftIndex = 0; SpacecraftIndex < SpacecraftCatalog->GetSpacecraftCount(); SpacecraftIndex++)
+		{
+			FFlareSpacecraftDescription* Desc = SpacecraftCatalog->GetSpacecraft(SpacecraftIndex);
+
+			Csv += FString::Printf(TEXT("%s,%s,%d,%.2f,%.2f,%.2f,%.2f\n"),
+				*Sector->GetIdentifier().ToString(),
+				*Desc->Identifier.ToString(),
+				Desc->IsStation() ? 1 : 0,
+				Sector->GetSpacecraftPrice(Desc, false, false) / 100.,
+				Sector->GetSpacecraftPrice(Desc, true, false) / 100.,
+				Sector->GetSpacecraftPrice(Desc, false, true) / 100.,
+				Sector->GetSpacecraftPrice(Desc, true, true) / 100.);
+		}
+	}
+
+	FString FileName = FString::Printf(TEXT("%s/SpacecraftPrices.csv"), *FPaths::GameSavedDir());
+	if (FFileHelper::SaveStringToFile(Csv, *FileName))
+	{
+		FLOGV("UFlareGameTools::ExportSpacecraftPrices : %d sectors, %d spacecrafts written to %s",
+			Sectors.Num(), SpacecraftCatalog->GetSpacecraftCount(), *FileName);
+	}
+	else
+	{
+		FLOGV("UFlareGameTools::ExportSpacecraftPrices failed: can't write %s", *FileName);
+	}
+}
+
 void UFlareGameTools::RevealMap()
 {
 	if (!GetGameWorld())
@@ -513,6 +666,7 @@ void UFlareGameTools::PrintCompany(FName CompanyShortName)
 	FLOGV("      - Ships %f $", Value.ShipsValue/ 100.);
 	FLOGV("      - Stations %f $", Value.StationsValue/ 100.);
 	FLOGV("    - Army %f $", Value.ArmyValue/ 100.);
+	FLOGV("    - %d days ago %f $", Company->GetCompanyValueHistoryLength(), Company->GetCompanyValueHistory(COMPANY_VALUE_HISTORY) / 100.);
 	TArray<UFlareFleet*> CompanyFleets = Company->GetCompanyFleets();
 	FLOGV("  > %d fleets", CompanyFleets.Num());
 	for (int i = 0; i < CompanyFleets.Num(); i++)
@@ -624,6 +778,66 @@ void UFlareGameTools::TakeCompanyControl(FName CompanyShortName)
 	GetGame()->GetPC()->Load(SavePlayerData);
 }
 
+void UFlareGameTools::DumpConstructionCandidates(FName CompanyShortName)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("UFlareGameTools::DumpConstructionCandidates failed: no loaded world");
+		return;
+	}
+
+	UFlareCompany* Company = GetGameWorld()->FindCompanyByShortName(CompanyShortName);
+	if (!Company)
+	{
+		FLOGV("UFlareGameTools::DumpConstructionCandidates failed: no company with short name '%s'", * CompanyShortName.ToString());
+		return;
+	}
+
+	Company->GetAI()->CheckConstructionCandidates(true);
+}
+
+void UFlareGameTools::PrintAIPersonality(FName CompanyShortName)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("UFlareGameTools::PrintAIPersonality failed: no loaded world");
+		return;
+	}
+
+	UFlareCompany* Company = GetGameWorld()->FindCompanyByShortName(CompanyShortName);
+	if (!Company)
+	{
+		FLOGV("UFlareGameTools::PrintAIPersonality failed: no company with short name '%s'", * CompanyShortName.ToString());
+		return;
+	}
+
+	FLOGV("UFlareGameTools::PrintAIPersonality : %s", *Company->GetAI()->GetBehavior()->SavePersonality());
+}
+
+void UFlareGameTools::DiffAIPersonality(FName Company1ShortName, FName Company2ShortName)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("UFlareGameTools::DiffAIPersonality failed: no loaded world");
+		return;
+	}
+
+	UFlareCompany* Company1 = GetGameWorld()->FindCompanyByShortName(Company1ShortName);
+	UFlareCompany* Company2 = GetGameWorld()->FindCompanyByShortName(Company2ShortName);
+	if (!Company1 || !Company2)
+	{
+		FLOGV("UFlareGameTools::DiffAIPersonality failed: no company with short name '%s'", * (Company1 ? Company2ShortName : Company1ShortName).ToString());
+		return;
+	}
+
+	TArray<FString> Differences = Company1->GetAI()->GetBehavior()->GetPersonality().Diff(Company2->GetAI()->GetBehavior()->GetPersonality());
+	for (int32 Index = 0; Index < Differences.Num(); Index++)
+	{
+		FLOGV("UFlareGameTools::DiffAIPersonality : %s", *Differences[Index]);
+	}
+	FLOGV("UFlareGameTools::DiffAIPersonality : %d differences", Differences.Num());
+}
+
 
 /*----------------------------------------------------
 	Fleet tools
@@ -1709,33 +1923,9 @@ int64 UFlareGameTools::ComputeSpacecraftPrice(FName ShipClass, UFlareSimulatedSe
 		return 0;
 	}
 
-	// Base cost
-	int64 Cost = 0;
-	Cost += Desc->CycleCost.ProductionCost;
-
-	// For stations, use the sectore penalty
-	if (Desc->IsStation() && ConstructionPrice)
-	{
-		Cost = Sector->GetStationConstructionFee(Cost);
-	}
-
-	// Add input resource cost
-	for (int ResourceIndex = 0; ResourceIndex < Desc->CycleCost.InputResources.Num() ; ResourceIndex++)
-	{
-		FFlareFactoryResource* Resource = &Desc->CycleCost.InputResources[ResourceIndex];
-		Cost += Resource->Quantity * Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::Default);
-	}
-
-	// Substract output resource
-	for (int ResourceIndex = 0; ResourceIndex < Desc->CycleCost.OutputResources.Num() ; ResourceIndex++)
-	{
-		FFlareFactoryResource* Resource = &Desc->CycleCost.OutputResources[ResourceIndex];
-		Cost -= Resource->Quantity * Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::Default);
-	}
-
 	// Upgrade value
 
-	return FMath::Max((int64) 0, Cost) * (WithMargin ? 1.2f : 1.0f);
+	return Sector->GetSpacecraftPrice(Desc, WithMargin, ConstructionPrice);
 }
 
 
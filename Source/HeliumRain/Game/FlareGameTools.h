@@ -48,6 +48,25 @@ public:
 	UFUNCTION(exec)
 	void PrintEconomyStatus();
 
+	/** Write the margins and equilibrium flows of the loaded world to Saved/Economy, as the FlareEconomy commandlet does */
+	UFUNCTION(exec)
+	void ExportEconomyReport();
+
+	/** Set the log level (0 disabled, 1 aggregated, 2 full) and per-second cap (0 for none) of a log event type */
+	UFUNCTION(exec)
+	void SetLogEventLevel(FName EventName, int32 Level, int32 MaxPerSecond);
+
+	/** Set the maximum number of log messages written per second (0 for none) */
+	UFUNCTION(exec)
+	void SetLogRateLimit(int32 MaxPerSecond);
+
+	UFUNCTION(exec)
+	void PrintLogSettings();
+
+	/** Run a check of FlareDiagnostics on the current game, or all of them with "All". Count sets the size of the checks that have one, 0 for the default */
+	UFUNCTION(exec)
+	void RunDiagnostics(FString CheckName, int32 Count);
+
 	/*----------------------------------------------------
 		World tools
 	----------------------------------------------------*/
@@ -68,6 +87,18 @@ public:
 	UFUNCTION(exec)
 	void SetPlanatariumTimeMultiplier(float Multiplier);
 
+	/** Use live traces for turret firing checks and log the firing map disagreements */
+	UFUNCTION(exec)
+	void SetTurretFiringMapValidation(bool Validation);
+
+	/** Print the predicted temperatures of a spacecraft of the active sector */
+	UFUNCTION(exec)
+	void PrintHeatCurve(FName ShipImmatriculation, float Duration);
+
+	/** Write the spacecraft prices of every sector to Saved/SpacecraftPrices.csv */
+	UFUNCTION(exec)
+	void ExportSpacecraftPrices();
+
 	/** Set all sectors as visted */
 	UFUNCTION(exec)
 	void RevealMap();
@@ -103,6 +134,18 @@ public:
 	UFUNCTION(exec)
 	void TakeCompanyControl(FName CompanyShortName);
 
+	/** Print the ranked station construction candidates of an AI company, and the full scores they are compared with */
+	UFUNCTION(exec)
+	void DumpConstructionCandidates(FName CompanyShortName);
+
+	/** Print the AI personality of a company as JSON */
+	UFUNCTION(exec)
+	void PrintAIPersonality(FName CompanyShortName);
+
+	/** Print the differences between the AI personalities of two companies */
+	UFUNCTION(exec)
+	void DiffAIPersonality(FName Company1ShortName, FName Company2ShortName);
+
 	/*----------------------------------------------------
 		Fleet tools
 	----------------------------------------------------*/
@@ -161,4 +161,73 @@ float FFlareFloatBuffer::GetMean(int32 StartAge, int32 EndAge)
 }
 
 
+/*----------------------------------------------------
+	Int64 buffer
+----------------------------------------------------*/
+
+void FFlareInt64Buffer::Init(int32 Size)
+{
+	MaxSize = Size;
+	Values.Empty(MaxSize);
+	WriteIndex = 0;
+}
+
+void FFlareInt64Buffer::Resize(int32 Size)
+{
+	if(Size <= Values.Num())
+	{
+		TArray<int64> NewValues;
+		for (int Age = Size-1; Age >= 0; Age--)
+		{
+			NewValues.Add(GetValue(Age));
+		}
+		// Override
+		Values = NewValues;
+		WriteIndex = 0;
+	}
+
+	MaxSize = Size;
+}
+
+void FFlareInt64Buffer::Append(int64 NewValue)
+{
+	if(Values.Num() <= WriteIndex)
+	{
+		Values.Add(NewValue);
+		WriteIndex = Values.Num();
+	}
+	else
+	{
+		Values[WriteIndex] = NewValue;
+		WriteIndex++;
+	}
+
+	if(WriteIndex >= MaxSize)
+	{
+		WriteIndex = 0;
+	}
+}
+
+int64 FFlareInt64Buffer::GetValue(int32 Age)
+{
+	if(Values.Num() == 0)
+	{
+		return 0;
+	}
+
+	if(Age >= Values.Num())
+	{
+		Age = Values.Num() - 1;
+	}
+
+	int32 ReadIndex = WriteIndex - 1 - Age;
+	if (ReadIndex < 0)
+	{
+		ReadIndex += Values.Num();
+	}
+
+	return Values[ReadIndex];
+}
+
+
 #undef LOCTEXT_NAMESPACE
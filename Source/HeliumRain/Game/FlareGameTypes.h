@@ -194,6 +194,58 @@ struct FFlareCompanyAISave
 };
 
 
+/** Game save data */
+USTRUCT()
+struct FFlareFloatBuffer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	int32 MaxSize;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	int32 WriteIndex;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	TArray<float> Values;
+
+
+	void Init(int32 Size);
+
+	void Resize(int32 Size);
+
+	void Append(float NewValue);
+
+	float GetValue(int32 Age);
+
+	float GetMean(int32 StartAge, int32 EndAge);
+};
+
+/** Game save data */
+USTRUCT()
+struct FFlareInt64Buffer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	int32 MaxSize;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	int32 WriteIndex;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	TArray<int64> Values;
+
+
+	void Init(int32 Size);
+
+	void Resize(int32 Size);
+
+	void Append(int64 NewValue);
+
+	int64 GetValue(int32 Age);
+};
+
 /** Game save data */
 USTRUCT()
 struct FFlareCompanySave
@@ -251,33 +303,10 @@ struct FFlareCompanySave
 	/** Value of all company assets */
 	UPROPERTY(EditAnywhere, Category = Save)
 	int64 CompanyValue;
-};
-
-/** Game save data */
-USTRUCT()
-struct FFlareFloatBuffer
-{
-	GENERATED_USTRUCT_BODY()
 
+	/** Daily history of the company value */
 	UPROPERTY(EditAnywhere, Category = Save)
-	int32 MaxSize;
-
-	UPROPERTY(EditAnywhere, Category = Save)
-	int32 WriteIndex;
-
-	UPROPERTY(EditAnywhere, Category = Save)
-	TArray<float> Values;
-
-
-	void Init(int32 Size);
-
-	void Resize(int32 Size);
-
-	void Append(float NewValue);
-
-	float GetValue(int32 Age);
-
-	float GetMean(int32 StartAge, int32 EndAge);
+	FFlareInt64Buffer CompanyValueHistory;
 };
 
 /** Incoming event description */
@@ -32,6 +32,14 @@ void UFlareGameUserSettings::SetToDefaults()
 
 	MusicVolume = 8;
 	MasterVolume = 10;
+
+	// Per-hit combat events are summarized once per second by default
+	LogEventSettings.Empty();
+	SetLogEventSettings(EFlareLogEvent::SPACECRAFT_DAMAGED, EFlareLogLevel::Aggregated, 200);
+	SetLogEventSettings(EFlareLogEvent::SPACECRAFT_COMPONENT_DAMAGED, EFlareLogLevel::Aggregated, 500);
+	SetLogEventSettings(EFlareLogEvent::BOMB_DROPPED, EFlareLogLevel::Full, 100);
+	SetLogEventSettings(EFlareLogEvent::BOMB_DESTROYED, EFlareLogLevel::Full, 100);
+	SetLogMaxPerSecond(1000);
 }
 
 void UFlareGameUserSettings::ApplySettings(bool bCheckForCommandLineOverrides)
@@ -41,6 +49,7 @@ void UFlareGameUserSettings::ApplySettings(bool bCheckForCommandLineOverrides)
 	Super::ApplySettings(bCheckForCommandLineOverrides);
 
 	SetScreenPercentage(ScreenPercentage);
+	ApplyLogSettings();
 }
 
 void UFlareGameUserSettings::SetScreenPercentage(int32 NewScreenPercentage)
@@ -51,3 +60,45 @@ void UFlareGameUserSettings::SetScreenPercentage(int32 NewScreenPercentage)
 	auto ScreenPercentageCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ScreenPercentage"));
 	ScreenPercentageCVar->Set(ScreenPercentage, ECVF_SetByGameSetting);
 }
+
+void UFlareGameUserSettings::SetLogEventSettings(EFlareLogEvent::Type Event, EFlareLogLevel::Type Level, int32 MaxPerSecond)
+{
+	FFlareLogEventSettings* Settings = NULL;
+	for (int32 SettingsIndex = 0; SettingsIndex < LogEventSettings.Num(); SettingsIndex++)
+	{
+		if (LogEventSettings[SettingsIndex].Event == Event)
+		{
+			Settings = &LogEventSettings[SettingsIndex];
+			break;
+		}
+	}
+
+	if (!Settings)
+	{
+		FFlareLogEventSettings NewSettings;
+		NewSettings.Event = Event;
+		Settings = &LogEventSettings[LogEventSettings.Add(NewSettings)];
+	}
+
+	Settings->Level = Level;
+	Settings->MaxPerSecond = MaxPerSecond;
+
+	FFlareLogWriter::SetEventRule(Event, Level, MaxPerSecond);
+}
+
+void UFlareGameUserSettings::SetLogMaxPerSecond(int32 MaxPerSecond)
+{
+	LogMaxPerSecond = MaxPerSecond;
+	FFlareLogWriter::SetGlobalMaxPerSecond(MaxPerSecond);
+}
+
+void UFlareGameUserSettings::ApplyLogSettings()
+{
+	for (int32 SettingsIndex = 0; SettingsIndex < LogEventSettings.Num(); SettingsIndex++)
+	{
+		const FFlareLogEventSettings& Settings = LogEventSettings[SettingsIndex];
+		FFlareLogWriter::SetEventRule(Settings.Event, Settings.Level, Settings.MaxPerSecond);
+	}
+
+	FFlareLogWriter::SetGlobalMaxPerSecond(LogMaxPerSecond);
+}
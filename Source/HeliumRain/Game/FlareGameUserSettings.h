@@ -1,8 +1,28 @@
 #pragma once
 
+#include "Log/FlareLogWriter.h"
 #include "FlareGameUserSettings.generated.h"
 
 
+/** Log filtering settings for one event type */
+USTRUCT()
+struct FFlareLogEventSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(Config)
+	TEnumAsByte<EFlareLogEvent::Type>        Event;
+
+	UPROPERTY(Config)
+	TEnumAsByte<EFlareLogLevel::Type>        Level;
+
+	/** Maximum written messages per second, 0 for no limit */
+	UPROPERTY(Config)
+	int32                                    MaxPerSecond;
+};
+
+
+
 UCLASS()
 class HELIUMRAIN_API UFlareGameUserSettings : public UGameUserSettings
 {
@@ -23,6 +43,15 @@ public:
 
 	void SetScreenPercentage(int32 NewScreenPercentage);
 
+	/** Set the log level and rate cap of an event type, and apply it */
+	void SetLogEventSettings(EFlareLogEvent::Type Event, EFlareLogLevel::Type Level, int32 MaxPerSecond);
+
+	/** Set the global log rate cap, and apply it */
+	void SetLogMaxPerSecond(int32 MaxPerSecond);
+
+	/** Push the log settings to the log writer */
+	void ApplyLogSettings();
+
 
 	/*----------------------------------------------------
 		Public data
@@ -56,4 +85,12 @@ public:
 	UPROPERTY(Config)
 	int32                                    MasterVolume;
 
+	/** Log settings for event types that are not written in full */
+	UPROPERTY(Config)
+	TArray<FFlareLogEventSettings>           LogEventSettings;
+
+	/** Maximum written log messages per second, all events together, 0 for no limit */
+	UPROPERTY(Config)
+	int32                                    LogMaxPerSecond;
+
 };
@@ -18,6 +18,11 @@ AFlarePlanetarium::AFlarePlanetarium(const class FObjectInitializer& PCIP)
 	PrimaryActorTick.bCanEverTick = true;
 	TimeMultiplier = 1.0;
 	SkipNightTimeRange = 0;
+	Sky = NULL;
+	Light = NULL;
+	Sun = NULL;
+	DistanceToParentCenter = 0;
+	PlayerRevolutionTime = 0;
 	Ready = false;
 }
 
@@ -26,12 +31,16 @@ void AFlarePlanetarium::BeginPlay()
 	Super::BeginPlay();
 	FLOG("AFlarePlanetarium::BeginPlay");
 
+	BodyComponents.Empty();
 	TArray<UActorComponent*> Components = GetComponentsByClass(UStaticMeshComponent::StaticClass());
 	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
 	{
 		UStaticMeshComponent* PlanetCandidate = Cast<UStaticMeshComponent>(Components[ComponentIndex]);
 		if (PlanetCandidate)
 		{
+			// Celestial body components are named after the body
+			BodyComponents.Add(FName(*PlanetCandidate->GetName()), PlanetCandidate);
+
 			// Apply a new dynamic material to planets so that we can control shading parameters
 			UMaterialInstanceConstant* BasePlanetMaterial = Cast<UMaterialInstanceConstant>(PlanetCandidate->GetMaterial(0));
 			if (BasePlanetMaterial)
@@ -63,6 +72,7 @@ void AFlarePlanetarium::Tick(float DeltaSeconds)
 		{
 			// No active sector, do nothing
 			Ready = false;
+			CurrentSector = NAME_None;
 			return;
 		}
 
@@ -70,125 +80,132 @@ void AFlarePlanetarium::Tick(float DeltaSeconds)
 
 		if (World)
 		{
-			float LocalTime = GetGame()->GetActiveSector()->GetLocalTime();
-			CurrentSector = GetGame()->GetActiveSector()->GetSimulatedSector()->GetIdentifier();
+			UFlareSimulatedPlanetarium* Planetarium = World->GetPlanerarium();
+			UFlareSimulatedSector* Sector = GetGame()->GetActiveSector()->GetSimulatedSector();
+			int64 LocalTime = GetGame()->GetActiveSector()->GetLocalTime();
 
-			if (Sky == NULL)
+			if (CurrentSector != Sector->GetIdentifier())
 			{
-				for (TActorIterator<AActor> ActorItr(GetWorld()); ActorItr; ++ActorItr)
-				{
-					if ((*ActorItr)->GetName().StartsWith("Skybox"))
-					{
-						FLOG("AFlarePlanetarium::Tick : found the sky");
-						Sky = *ActorItr;
-						break;
-					}
-				}
+				CurrentSector = Sector->GetIdentifier();
+				OnSectorActivated();
 			}
 
-			if (Light == NULL)
+			FFlareSectorOrbitParameters* PlayerOrbit = Sector->GetOrbitParameters();
+
+			// Jump to the end of the night, if it ends in the allowed range
+			if (SkipNightTimeRange > 0)
 			{
-				TArray<UActorComponent*> Components = GetComponentsByClass(UDirectionalLightComponent::StaticClass());
-				for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+				double Delay = Planetarium->GetTimeToDaylight(PlayerOrbit->CelestialBodyIdentifier, DistanceToParentCenter, PlayerOrbit->Phase, (double) LocalTime + SmoothTime);
+				if (Delay > 0 && SmoothTime + Delay < SkipNightTimeRange)
 				{
-					UDirectionalLightComponent* LightCandidate = Cast<UDirectionalLightComponent>(Components[ComponentIndex]);
-					if (LightCandidate)
-					{
-						Light = LightCandidate;
-						break;
-					}
+					SmoothTime += Delay;
+					FLOGV("AFlarePlanetarium::Tick : night, skipped %f seconds to find light", Delay);
 				}
+				SkipNightTimeRange = 0;
 			}
 
 			Ready = true;
 
-			do
+			Sun = Planetarium->GetCachedSnapShot(LocalTime, SmoothTime);
+
+			// Draw Player
+			FFlareCelestialBody* CurrentParent = Planetarium->FindCelestialBody(Sun, PlayerOrbit->CelestialBodyIdentifier);
+			if (CurrentParent)
 			{
+				FPreciseVector ParentLocation = CurrentParent->AbsoluteLocation;
+				FPreciseVector PlayerLocation =  ParentLocation + Planetarium->GetOrbitLocation(PlayerRevolutionTime, LocalTime, SmoothTime, DistanceToParentCenter, PlayerOrbit->Phase);
+				/*FLOGV("Parent location = %s", *CurrentParent->AbsoluteLocation.ToString());
+				FLOGV("PlayerLocation = %s", *PlayerLocation.ToString());*/
+#ifdef PLANETARIUM_DEBUG
+				DrawDebugLine(GetWorld(), FVector(1000, 0 ,0), FVector(- 1000, 0 ,0), FColor::Red, false);
+				DrawDebugLine(GetWorld(), FVector(0, 1000 ,0), FVector(0,- 1000 ,0), FColor::Green, false);
+				DrawDebugLine(GetWorld(), FVector(0, 0, 900), FVector(0, 0, -1000), FColor::Blue, false);
+				DrawDebugLine(GetWorld(), FVector(0, 0, 900), FVector(0, 0, 1000), FColor::Cyan, false);
+#endif
+				FPreciseVector DeltaLocation = ParentLocation - PlayerLocation;
+				FPreciseVector SunDeltaLocation = Sun->AbsoluteLocation - PlayerLocation;
 
-				Sun = World->GetPlanerarium()->GetSnapShot(LocalTime, SmoothTime);
+				float AngleOffset =  90 + FMath::RadiansToDegrees(FMath::Atan2(DeltaLocation.Z,DeltaLocation.X));
+				/*FLOGV("DeltaLocation = %s", *DeltaLocation.ToString());
+				FLOGV("FMath::Atan2(DeltaLocation.Y,DeltaLocation.X)  = %f", FMath::Atan2(DeltaLocation.Z,DeltaLocation.X));
+				FLOGV("AngleOffset  = %f", AngleOffset);*/
 
-				// Draw Player
-				FFlareSectorOrbitParameters* PlayerOrbit = GetGame()->GetActiveSector()->GetSimulatedSector()->GetOrbitParameters();
+				SunDirection = -(SunDeltaLocation.RotateAngleAxis(AngleOffset, FPreciseVector(0,1,0))).GetUnsafeNormal();
+				// Reset sun occlusion;
+				SunOcclusion = 0;
+				MinDistance = DistanceToParentCenter;
 
+				BodyPositions.Reset();
+				PrepareCelestialBody(Sun, -PlayerLocation, AngleOffset);
+				SetupCelestialBodies();
 
-				FFlareCelestialBody* CurrentParent = World->GetPlanerarium()->FindCelestialBody(PlayerOrbit->CelestialBodyIdentifier);
-				if (CurrentParent)
+				if (Sky)
 				{
-					FPreciseVector ParentLocation = CurrentParent->AbsoluteLocation;
-
-					double DistanceToParentCenter = CurrentParent->Radius + PlayerOrbit->Altitude;
-					FPreciseVector PlayerLocation =  ParentLocation + World->GetPlanerarium()->GetRelativeLocation(CurrentParent, LocalTime, SmoothTime, DistanceToParentCenter, 0, PlayerOrbit->Phase);
-					/*FLOGV("Parent location = %s", *CurrentParent->AbsoluteLocation.ToString());
-					FLOGV("PlayerLocation = %s", *PlayerLocation.ToString());*/
-#ifdef PLANETARIUM_DEBUG
-					DrawDebugLine(GetWorld(), FVector(1000, 0 ,0), FVector(- 1000, 0 ,0), FColor::Red, false);
-					DrawDebugLine(GetWorld(), FVector(0, 1000 ,0), FVector(0,- 1000 ,0), FColor::Green, false);
-					DrawDebugLine(GetWorld(), FVector(0, 0, 900), FVector(0, 0, -1000), FColor::Blue, false);
-					DrawDebugLine(GetWorld(), FVector(0, 0, 900), FVector(0, 0, 1000), FColor::Cyan, false);
-#endif
-					FPreciseVector DeltaLocation = ParentLocation - PlayerLocation;
-					FPreciseVector SunDeltaLocation = Sun.AbsoluteLocation - PlayerLocation;
-
-					float AngleOffset =  90 + FMath::RadiansToDegrees(FMath::Atan2(DeltaLocation.Z,DeltaLocation.X));
-					/*FLOGV("DeltaLocation = %s", *DeltaLocation.ToString());
-					FLOGV("FMath::Atan2(DeltaLocation.Y,DeltaLocation.X)  = %f", FMath::Atan2(DeltaLocation.Z,DeltaLocation.X));
-					FLOGV("AngleOffset  = %f", AngleOffset);*/
-
-					SunDirection = -(SunDeltaLocation.RotateAngleAxis(AngleOffset, FPreciseVector(0,1,0))).GetUnsafeNormal();
-					// Reset sun occlusion;
-					SunOcclusion = 0;
-					MinDistance = DistanceToParentCenter;
-
-					BodyPositions.Empty();
-					PrepareCelestialBody(&Sun, -PlayerLocation, AngleOffset);
-					SetupCelestialBodies();
-
-					if(SkipNightTimeRange > 0 && SunOcclusion >= 1)
-					{
-						//Try to find night
-						SmoothTime = FMath::FRand() * SkipNightTimeRange;
-						FLOGV("AFlarePlanetarium::Tick : night, try to find light at %f (max %f)",SmoothTime, SkipNightTimeRange);
-					}
-					else
-					{
-						SkipNightTimeRange = 0;
-					}
-
-
-					if (Sky)
-					{
-						Sky->SetActorRotation(FRotator(-AngleOffset, 0 , 0));
-						//FLOGV("Sky %s rotation= %s",*Sky->GetName(),  *Sky->GetActorRotation().ToString());
-					}
-					else
-					{
-						FLOG("AFlarePlanetarium::Tick : no sky found");
-					}
-
-					//FLOGV("SunOcclusion %f", SunOcclusion);
-					if (Light)
-					{
-						float Intensity = 10 * FMath::Pow((1.0 - SunOcclusion), 2);
-						//FLOGV("Light Intensity %f", Intensity);
-						Light->SetIntensity(Intensity);
-					}
-					else
-					{
-
-						FLOG("AFlarePlanetarium::Tick : no sunlight found");
-					}
-
-
+					Sky->SetActorRotation(FRotator(-AngleOffset, 0 , 0));
+					//FLOGV("Sky %s rotation= %s",*Sky->GetName(),  *Sky->GetActorRotation().ToString());
 				}
-				else
+
+				//FLOGV("SunOcclusion %f", SunOcclusion);
+				if (Light)
 				{
-					FLOGV("AFlarePlanetarium::Tick : failed to find the current sector: '%s' in planetarium", *(PlayerOrbit->CelestialBodyIdentifier.ToString()));
+					float Intensity = 10 * FMath::Pow((1.0 - SunOcclusion), 2);
+					//FLOGV("Light Intensity %f", Intensity);
+					Light->SetIntensity(Intensity);
 				}
+			}
+			else
+			{
+				FLOGV("AFlarePlanetarium::Tick : failed to find the current sector: '%s' in planetarium", *(PlayerOrbit->CelestialBodyIdentifier.ToString()));
+			}
+		}
+	}
+}
 
+void AFlarePlanetarium::OnSectorActivated()
+{
+	UFlareSimulatedPlanetarium* Planetarium = GetGame()->GetGameWorld()->GetPlanerarium();
+	FFlareSectorOrbitParameters* PlayerOrbit = GetGame()->GetActiveSector()->GetSimulatedSector()->GetOrbitParameters();
 
-			} while(SkipNightTimeRange != 0);
+	// The player orbit is fixed for the sector
+	FFlareCelestialBody* CurrentParent = Planetarium->FindCelestialBody(PlayerOrbit->CelestialBodyIdentifier);
+	if (CurrentParent)
+	{
+		DistanceToParentCenter = CurrentParent->Radius + PlayerOrbit->Altitude;
+		PlayerRevolutionTime = UFlareSimulatedPlanetarium::GetRevolutionTime(CurrentParent, DistanceToParentCenter, 0);
+	}
+
+	// Find the sky
+	Sky = NULL;
+	for (TActorIterator<AActor> ActorItr(GetWorld()); ActorItr; ++ActorItr)
+	{
+		if ((*ActorItr)->GetName().StartsWith("Skybox"))
+		{
+			FLOG("AFlarePlanetarium::OnSectorActivated : found the sky");
+			Sky = *ActorItr;
+			break;
+		}
+	}
+	if (!Sky)
+	{
+		FLOG("AFlarePlanetarium::OnSectorActivated : no sky found");
+	}
+
+	// Find the sun light
+	Light = NULL;
+	TArray<UActorComponent*> Components = GetComponentsByClass(UDirectionalLightComponent::StaticClass());
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	{
+		UDirectionalLightComponent* LightCandidate = Cast<UDirectionalLightComponent>(Components[ComponentIndex]);
+		if (LightCandidate)
+		{
+			Light = LightCandidate;
+			break;
 		}
 	}
+	if (!Light)
+	{
+		FLOG("AFlarePlanetarium::OnSectorActivated : no sunlight found");
+	}
 }
 
 inline static bool BodyDistanceComparator (const CelestialBodyPosition& ip1, const CelestialBodyPosition& ip2)
@@ -297,13 +314,13 @@ void AFlarePlanetarium::SetupCelestialBody(CelestialBodyPosition* BodyPosition,
 	}
 
 	// Sun also rotates to track direction
-	if (BodyPosition->Body == &Sun)
+	if (BodyPosition->Body == Sun)
 	{
 		BodyPosition->BodyComponent->SetRelativeRotation(SunDirection.ToVector().Rotation());
 	}
 
 	// Compute sun occlusion
-	if (BodyPosition->Body != &Sun)
+	if (BodyPosition->Body != Sun)
 	{
 		double OcclusionAngle = FPreciseMath::Asin(BodyPosition->Radius / BodyPosition->Distance);
 
@@ -379,21 +396,11 @@ void AFlarePlanetarium::PrepareCelestialBody(FFlareCelestialBody* Body, FPrecise
 	BodyPosition.TotalRotation = Body->RotationAngle + AngleOffset;
 
 	// Find the celestial body component
-	UStaticMeshComponent* BodyComponent = NULL;
-	TArray<UActorComponent*> Components = GetComponentsByClass(UStaticMeshComponent::StaticClass());
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
-	{
-		UStaticMeshComponent* ComponentCandidate = Cast<UStaticMeshComponent>(Components[ComponentIndex]);
-		if (ComponentCandidate && ComponentCandidate->GetName() == Body->Identifier.ToString()	)
-		{
-			BodyComponent = ComponentCandidate;
-			break;
-		}
-	}
+	UStaticMeshComponent** BodyComponent = BodyComponents.Find(Body->Identifier);
 
 	if (BodyComponent)
 	{
-		BodyPosition.BodyComponent = BodyComponent;
+		BodyPosition.BodyComponent = *BodyComponent;
 		BodyPositions.Add(BodyPosition);
 	}
 	else
@@ -402,7 +409,7 @@ void AFlarePlanetarium::PrepareCelestialBody(FFlareCelestialBody* Body, FPrecise
 	}
 
 
-	if (Body == &Sun)
+	if (Body == Sun)
 	{
 		SunOcclusionAngle = FPreciseMath::Asin(BodyPosition.Radius / BodyPosition.Distance);
 		SunPhase = FMath::UnwindRadians(FMath::Atan2(BodyPosition.AlignedLocation.Z, BodyPosition.AlignedLocation.X));
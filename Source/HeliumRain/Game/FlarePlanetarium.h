@@ -48,6 +48,9 @@ public:
 
 	void SkipNight(float TimeRange);
 
+	/** Resolve the scene and the player orbit for a new active sector */
+	void OnSectorActivated();
+
 
 	/*----------------------------------------------------
 		Public Blueprint events
@@ -80,8 +83,11 @@ protected:
 	UDirectionalLightComponent* Light;
 
 	FName CurrentSector;
+	double DistanceToParentCenter;
+	int64 PlayerRevolutionTime;
 
-	FFlareCelestialBody Sun;
+	FFlareCelestialBody* Sun;
+	TMap<FName, UStaticMeshComponent*> BodyComponents;
 
 	double SunOcclusion;
 	double MinDistance;
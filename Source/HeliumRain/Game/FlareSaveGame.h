@@ -3,6 +3,7 @@
 #include "FlareCompany.h"
 #include "FlareWorld.h"
 #include "../Quests/FlareQuestManager.h"
+#include "../Player/FlareNotificationService.h"
 
 #include "FlareSaveGame.generated.h"
 
@@ -89,6 +90,10 @@ struct FFlarePlayerSave
 	/** Identifier of the last flown ship */
 	UPROPERTY(EditAnywhere, Category = Save)
 	FName LastFlownShipIdentifier;
+
+	/** Every notification sent to the player */
+	UPROPERTY(EditAnywhere, Category = Save)
+	TArray<FFlareNotificationRecordSave> NotificationHistory;
 };
 
 
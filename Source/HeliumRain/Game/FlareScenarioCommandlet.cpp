@@ -0,0 +1,75 @@
+
+#include "../Flare.h"
+#include "FlareScenarioCommandlet.h"
+#include "FlareScenarioTools.h"
+#include "FlareGame.h"
+#include "FlareWorld.h"
+#include "../Player/FlarePlayerController.h"
+
+#define LOCTEXT_NAMESPACE "FlareScenarioCommandlet"
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+UFlareScenarioCommandlet::UFlareScenarioCommandlet(const class FObjectInitializer& PCIP)
+	: Super(PCIP)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+
+/*----------------------------------------------------
+	Commandlet
+----------------------------------------------------*/
+
+int32 UFlareScenarioCommandlet::Main(const FString& Params)
+{
+	int32 Slot = 1;
+	FString ConfigPath;
+	FFlareStressScenarioConfig Config;
+
+	FParse::Value(*Params, TEXT("Slot="), Slot);
+	if (FParse::Value(*Params, TEXT("Config="), ConfigPath) && !Config.Load(ConfigPath))
+	{
+		return 1;
+	}
+	FParse::Value(*Params, TEXT("Seed="), Config.Seed);
+
+	// Game world with the game mode and a player controller, as the world creation expects them
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	AFlareGame* Game = World->SpawnActor<AFlareGame>();
+	World->AuthorityGameMode = Game;
+	AFlarePlayerController* PC = World->SpawnActor<AFlarePlayerController>();
+
+	if (!Config.Validate(Game->GetSpacecraftCatalog()))
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		return 1;
+	}
+
+	Game->SetCurrentSlot(Slot);
+	Game->CreateGame(PC, LOCTEXT("StressCompanyName", "Stress Test"), 3, false, &Config);
+	if (!Game->SaveGame(PC, false))
+	{
+		FLOGV("UFlareScenarioCommandlet::Main failed: can't save slot %d", Slot);
+		return 1;
+	}
+
+	FLOGV("UFlareScenarioCommandlet::Main : scenario with seed %d saved to slot %d", Config.Seed, Slot);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return 0;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlareScenarioCommandlet.generated.h"
+
+
+/** Generate the stress scenario without a render device, and write it to a save slot
+ *  Usage : HeliumRain -run=FlareScenario -Slot=1 [-Config=Scenario.json] [-Seed=0]
+ */
+UCLASS()
+class HELIUMRAIN_API UFlareScenarioCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	virtual int32 Main(const FString& Params) override;
+
+};
@@ -3,6 +3,8 @@
 #include "../Game/FlareWorld.h"
 #include "../Game/FlareGame.h"
 #include "../Game/FlareSimulatedSector.h"
+#include "../Game/FlareFleet.h"
+#include "../Game/FlareTradeRoute.h"
 #include "../Economy/FlareCargoBay.h"
 #include "../Player/FlarePlayerController.h"
 #include "../Spacecrafts/FlareSimulatedSpacecraft.h"
@@ -161,6 +163,192 @@ void UFlareScenarioTools::GenerateDebugScenario()
 	CreateStations(StationIceMine, PlayerCompany, MinersHome, 1);
 }
 
+void UFlareScenarioTools::GenerateStressScenario(const FFlareStressScenarioConfig& Config)
+{
+	FLOGV("UFlareScenarioTools::GenerateStressScenario : seed %d", Config.Seed);
+
+	if (!Config.Validate(Game->GetSpacecraftCatalog()))
+	{
+		FLOG("UFlareScenarioTools::GenerateStressScenario failed: unknown spacecraft class");
+		return;
+	}
+
+	FRandomStream Random(Config.Seed);
+
+	SetupWorld();
+	CreatePlayerShip(FirstLight, "ship-solen");
+
+	// Companies, in catalog order
+	TArray<UFlareCompany*> Companies;
+	for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num() && Companies.Num() < Config.CompanyCount; CompanyIndex++)
+	{
+		UFlareCompany* Company = World->GetCompanies()[CompanyIndex];
+		if (Company != PlayerCompany)
+		{
+			Companies.Add(Company);
+		}
+	}
+
+	if (Companies.Num() < Config.CompanyCount)
+	{
+		FLOGV("UFlareScenarioTools::GenerateStressScenario : only %d companies available, %d requested", Companies.Num(), Config.CompanyCount);
+	}
+
+	TArray<UFlareSimulatedSector*> Sectors = GetSectorsPerBody(Config.SectorsPerMoon);
+	if (Companies.Num() == 0 || Sectors.Num() == 0 || Config.StationClasses.Num() == 0)
+	{
+		FLOG("UFlareScenarioTools::GenerateStressScenario failed: no company, sector or station class");
+		return;
+	}
+
+	// Everyone knows the populated sectors
+	for (int32 SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		PlayerCompany->DiscoverSector(Sectors[SectorIndex]);
+		for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+		{
+			Companies[CompanyIndex]->DiscoverSector(Sectors[SectorIndex]);
+		}
+	}
+
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		Companies[CompanyIndex]->GiveMoney(Config.CompanyMoney);
+	}
+
+	// Stations
+	for (int32 SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		for (int32 StationIndex = 0; StationIndex < Config.StationsPerSector; StationIndex++)
+		{
+			FName StationClass = Config.StationClasses[Random.RandRange(0, Config.StationClasses.Num() - 1)];
+			UFlareCompany* Company = Companies[Random.RandRange(0, Companies.Num() - 1)];
+			CreateStations(StationClass, Company, Sectors[SectorIndex], 1, Config.StationLevel);
+		}
+	}
+
+	// Fleets
+	int32 FleetCount = 0;
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		for (int32 FleetIndex = 0; FleetIndex < Config.FleetsPerCompany; FleetIndex++)
+		{
+			bool Military = (Random.FRand() < Config.MilitaryRatio);
+			UFlareSimulatedSector* Sector = Sectors[Random.RandRange(0, Sectors.Num() - 1)];
+			if (CreateFleet(Military ? Config.MilitaryShipClasses : Config.CargoShipClasses, Companies[CompanyIndex], Sector, Config.FleetSize, Random))
+			{
+				FleetCount++;
+			}
+		}
+	}
+
+	// Sectors producing and consuming each resource, in a stable order
+	TArray<FFlareResourceDescription*> Resources;
+	TArray<TArray<UFlareSimulatedSector*> > Producers;
+	TArray<TArray<UFlareSimulatedSector*> > Consumers;
+	for (int32 SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		TArray<UFlareSimulatedSpacecraft*>& Stations = Sectors[SectorIndex]->GetSectorStations();
+		for (int32 StationIndex = 0; StationIndex < Stations.Num(); StationIndex++)
+		{
+			for (int32 FactoryIndex = 0; FactoryIndex < Stations[StationIndex]->GetFactories().Num(); FactoryIndex++)
+			{
+				const FFlareProductionData& Cycle = Stations[StationIndex]->GetFactories()[FactoryIndex]->GetDescription()->CycleCost;
+
+				for (int32 ResourceIndex = 0; ResourceIndex < Cycle.InputResources.Num() + Cycle.OutputResources.Num(); ResourceIndex++)
+				{
+					bool IsInput = (ResourceIndex < Cycle.InputResources.Num());
+					FFlareResourceDescription* Resource = IsInput ?
+						&Cycle.InputResources[ResourceIndex].Resource->Data :
+						&Cycle.OutputResources[ResourceIndex - Cycle.InputResources.Num()].Resource->Data;
+
+					int32 Index = Resources.Find(Resource);
+					if (Index == INDEX_NONE)
+					{
+						Index = Resources.Add(Resource);
+						Producers.AddDefaulted();
+						Consumers.AddDefaulted();
+					}
+					(IsInput ? Consumers : Producers)[Index].AddUnique(Sectors[SectorIndex]);
+				}
+			}
+		}
+	}
+
+	TArray<int32> TradedResources;
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	{
+		if (Producers[ResourceIndex].Num() > 0 && Consumers[ResourceIndex].Num() > 0
+		 && (Producers[ResourceIndex].Num() > 1 || Consumers[ResourceIndex].Num() > 1 || Producers[ResourceIndex][0] != Consumers[ResourceIndex][0]))
+		{
+			TradedResources.Add(ResourceIndex);
+		}
+	}
+
+	// Trade routes, from a producing sector to a consuming one
+	int32 TradeRouteCount = 0;
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num() && TradedResources.Num() > 0; CompanyIndex++)
+	{
+		UFlareCompany* Company = Companies[CompanyIndex];
+
+		for (int32 RouteIndex = 0; RouteIndex < Config.TradeRoutesPerCompany; RouteIndex++)
+		{
+			int32 ResourceIndex = TradedResources[Random.RandRange(0, TradedResources.Num() - 1)];
+			TArray<UFlareSimulatedSector*>& ResourceProducers = Producers[ResourceIndex];
+			TArray<UFlareSimulatedSector*>& ResourceConsumers = Consumers[ResourceIndex];
+
+			UFlareSimulatedSector* LoadSector = ResourceProducers[Random.RandRange(0, ResourceProducers.Num() - 1)];
+			UFlareSimulatedSector* UnloadSector = ResourceConsumers[Random.RandRange(0, ResourceConsumers.Num() - 1)];
+			for (int32 Attempt = 0; LoadSector == UnloadSector && Attempt < 10; Attempt++)
+			{
+				LoadSector = ResourceProducers[Random.RandRange(0, ResourceProducers.Num() - 1)];
+				UnloadSector = ResourceConsumers[Random.RandRange(0, ResourceConsumers.Num() - 1)];
+			}
+			if (LoadSector == UnloadSector)
+			{
+				continue;
+			}
+
+			UFlareFleet* Fleet = CreateFleet(Config.CargoShipClasses, Company, LoadSector, Config.FleetSize, Random);
+			if (!Fleet)
+			{
+				continue;
+			}
+
+			UFlareTradeRoute* TradeRoute = Company->CreateTradeRoute(FText::Format(LOCTEXT("StressTradeRouteFormat", "{0} route {1}"),
+				Resources[ResourceIndex]->Name, FText::AsNumber(RouteIndex + 1)));
+			TradeRoute->AddSector(LoadSector);
+			TradeRoute->AddSector(UnloadSector);
+			TradeRoute->AddSectorOperation(0, EFlareTradeRouteOperation::LoadOrBuy, Resources[ResourceIndex]);
+			TradeRoute->AddSectorOperation(1, EFlareTradeRouteOperation::UnloadOrSell, Resources[ResourceIndex]);
+			TradeRoute->AssignFleet(Fleet);
+			TradeRouteCount++;
+			FleetCount++;
+		}
+	}
+
+	// Wars, between random company pairs
+	TArray<TPair<UFlareCompany*, UFlareCompany*> > CompanyPairs;
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		for (int32 OtherCompanyIndex = CompanyIndex + 1; OtherCompanyIndex < Companies.Num(); OtherCompanyIndex++)
+		{
+			CompanyPairs.Add(TPair<UFlareCompany*, UFlareCompany*>(Companies[CompanyIndex], Companies[OtherCompanyIndex]));
+		}
+	}
+
+	int32 WarCount = FMath::Min(Config.WarCount, CompanyPairs.Num());
+	for (int32 WarIndex = 0; WarIndex < WarCount; WarIndex++)
+	{
+		CompanyPairs.Swap(WarIndex, Random.RandRange(WarIndex, CompanyPairs.Num() - 1));
+		CompanyPairs[WarIndex].Key->SetHostilityTo(CompanyPairs[WarIndex].Value, true);
+		CompanyPairs[WarIndex].Value->SetHostilityTo(CompanyPairs[WarIndex].Key, true);
+	}
+
+	FLOGV("UFlareScenarioTools::GenerateStressScenario : %d companies, %d sectors, %d fleets, %d trade routes, %d wars",
+		Companies.Num(), Sectors.Num(), FleetCount, TradeRouteCount, WarCount);
+}
+
 UFlareSimulatedSpacecraft* UFlareScenarioTools::CreateRecoveryPlayerShip()
 {
 	return CreatePlayerShip(FirstLight, "ship-solen");
@@ -501,5 +689,201 @@ void UFlareScenarioTools::CreateStations(FName StationClass, UFlareCompany* Comp
 
 	}
 }
+UFlareFleet* UFlareScenarioTools::CreateFleet(const TArray<FName>& ShipClasses, UFlareCompany* Company, UFlareSimulatedSector* Sector, int32 Count, FRandomStream& Random)
+{
+	UFlareFleet* Fleet = NULL;
+
+	for (int32 Index = 0; Index < Count && ShipClasses.Num() > 0; Index++)
+	{
+		if (Fleet && Fleet->GetShipCount() >= Fleet->GetMaxShipCount())
+		{
+			break;
+		}
+
+		// Each ship comes in its own fleet, merged in the first one
+		FName ShipClass = ShipClasses[Random.RandRange(0, ShipClasses.Num() - 1)];
+		UFlareSimulatedSpacecraft* Ship = Sector->CreateSpacecraft(ShipClass, Company, FVector::ZeroVector);
+		if (!Ship)
+		{
+			continue;
+		}
+		else if (Fleet)
+		{
+			Fleet->Merge(Ship->GetCurrentFleet());
+		}
+		else
+		{
+			Fleet = Ship->GetCurrentFleet();
+		}
+	}
+
+	return Fleet;
+}
+
+TArray<UFlareSimulatedSector*> UFlareScenarioTools::GetSectorsPerBody(int32 Count)
+{
+	TArray<UFlareSimulatedSector*> SortedSectors = World->GetSectors();
+	SortedSectors.Sort([](UFlareSimulatedSector& A, UFlareSimulatedSector& B)
+	{
+		return A.GetIdentifier().ToString() < B.GetIdentifier().ToString();
+	});
+
+	TArray<UFlareSimulatedSector*> Sectors;
+	TMap<FName, int32> BodySectorCounts;
+	for (int32 SectorIndex = 0; SectorIndex < SortedSectors.Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = SortedSectors[SectorIndex];
+		int32& BodySectorCount = BodySectorCounts.FindOrAdd(Sector->GetOrbitParameters()->CelestialBodyIdentifier);
+
+		if (!Sector->IsTravelSector() && BodySectorCount < Count)
+		{
+			Sectors.Add(Sector);
+			BodySectorCount++;
+		}
+	}
+
+	return Sectors;
+}
+
+
+/*----------------------------------------------------
+	Stress scenario config
+----------------------------------------------------*/
+
+FFlareStressScenarioConfig::FFlareStressScenarioConfig()
+	: Seed(0)
+	, CompanyCount(8)
+	, SectorsPerMoon(4)
+	, StationsPerSector(6)
+	, StationLevel(1)
+	, FleetsPerCompany(10)
+	, FleetSize(5)
+	, MilitaryRatio(0.3f)
+	, TradeRoutesPerCompany(4)
+	, WarCount(4)
+	, CompanyMoney(100000000)
+{
+	StationClasses.Add("station-farm");
+	StationClasses.Add("station-solar-plant");
+	StationClasses.Add("station-habitation");
+	StationClasses.Add("station-ice-mine");
+	StationClasses.Add("station-iron-mine");
+	StationClasses.Add("station-steelworks");
+	StationClasses.Add("station-tool-factory");
+	StationClasses.Add("station-h2-pump");
+	StationClasses.Add("station-ch4-pump");
+	StationClasses.Add("station-he3-pump");
+	StationClasses.Add("station-carbon-refinery");
+	StationClasses.Add("station-plastics-refinery");
+	StationClasses.Add("station-arsenal");
+	StationClasses.Add("station-shipyard");
+	StationClasses.Add("station-hub");
+	StationClasses.Add("station-outpost");
+
+	CargoShipClasses.Add("ship-solen");
+	CargoShipClasses.Add("ship-omen");
+
+	MilitaryShipClasses.Add("ship-ghoul");
+}
+
+/** Read an integer field of a stress scenario config */
+static void ReadConfigInt(const TSharedPtr<FJsonObject>& Object, const TCHAR* Name, int32& Value)
+{
+	double Number;
+	if (Object->TryGetNumberField(Name, Number))
+	{
+		Value = FMath::RoundToInt(Number);
+	}
+}
+
+/** Read a name list field of a stress scenario config */
+static void ReadConfigNames(const TSharedPtr<FJsonObject>& Object, const TCHAR* Name, TArray<FName>& Names)
+{
+	const TArray<TSharedPtr<FJsonValue> >* Values;
+	if (Object->TryGetArrayField(Name, Values))
+	{
+		Names.Empty();
+		for (int32 Index = 0; Index < Values->Num(); Index++)
+		{
+			Names.Add(FName(*(*Values)[Index]->AsString()));
+		}
+	}
+}
+
+bool FFlareStressScenarioConfig::Load(const FString& Path)
+{
+	FString ConfigString;
+	if (!FFileHelper::LoadFileToString(ConfigString, *Path))
+	{
+		FLOGV("FFlareStressScenarioConfig::Load failed: can't read '%s'", *Path);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Object;
+	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(ConfigString);
+	if (!FJsonSerializer::Deserialize(Reader, Object) || !Object.IsValid())
+	{
+		FLOGV("FFlareStressScenarioConfig::Load failed: can't parse '%s'", *Path);
+		return false;
+	}
+
+	ReadConfigInt(Object, TEXT("Seed"), Seed);
+	ReadConfigInt(Object, TEXT("CompanyCount"), CompanyCount);
+	ReadConfigInt(Object, TEXT("SectorsPerMoon"), SectorsPerMoon);
+	ReadConfigInt(Object, TEXT("StationsPerSector"), StationsPerSector);
+	ReadConfigInt(Object, TEXT("StationLevel"), StationLevel);
+	ReadConfigInt(Object, TEXT("FleetsPerCompany"), FleetsPerCompany);
+	ReadConfigInt(Object, TEXT("FleetSize"), FleetSize);
+	ReadConfigInt(Object, TEXT("TradeRoutesPerCompany"), TradeRoutesPerCompany);
+	ReadConfigInt(Object, TEXT("WarCount"), WarCount);
+
+	double Value;
+	if (Object->TryGetNumberField(TEXT("MilitaryRatio"), Value))
+	{
+		MilitaryRatio = (float) Value;
+	}
+	if (Object->TryGetNumberField(TEXT("CompanyMoney"), Value))
+	{
+		CompanyMoney = (int64) Value;
+	}
+
+	ReadConfigNames(Object, TEXT("StationClasses"), StationClasses);
+	ReadConfigNames(Object, TEXT("CargoShipClasses"), CargoShipClasses);
+	ReadConfigNames(Object, TEXT("MilitaryShipClasses"), MilitaryShipClasses);
+
+	return true;
+}
+
+/** Check that every class of a stress scenario config list is a station, or a ship */
+static bool ValidateConfigClasses(UFlareSpacecraftCatalog* Catalog, const TArray<FName>& Classes, bool Stations, const TCHAR* Name)
+{
+	bool Valid = true;
+
+	for (int32 Index = 0; Index < Classes.Num(); Index++)
+	{
+		FFlareSpacecraftDescription* Description = Catalog->Get(Classes[Index]);
+		if (!Description)
+		{
+			FLOGV("FFlareStressScenarioConfig::Validate failed: %s '%s' is not in the spacecraft catalog", Name, *Classes[Index].ToString());
+			Valid = false;
+		}
+		else if (Description->IsStation() != Stations)
+		{
+			FLOGV("FFlareStressScenarioConfig::Validate failed: %s '%s' is not a %s", Name, *Classes[Index].ToString(), Stations ? TEXT("station") : TEXT("ship"));
+			Valid = false;
+		}
+	}
+
+	return Valid;
+}
+
+bool FFlareStressScenarioConfig::Validate(UFlareSpacecraftCatalog* Catalog) const
+{
+	bool Valid = ValidateConfigClasses(Catalog, StationClasses, true, TEXT("StationClasses"));
+	Valid &= ValidateConfigClasses(Catalog, CargoShipClasses, false, TEXT("CargoShipClasses"));
+	Valid &= ValidateConfigClasses(Catalog, MilitaryShipClasses, false, TEXT("MilitaryShipClasses"));
+	return Valid;
+}
+
 
 #undef LOCTEXT_NAMESPACE
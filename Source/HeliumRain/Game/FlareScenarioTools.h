@@ -3,8 +3,53 @@
 #include "FlareScenarioTools.generated.h"
 
 class UFlareCompany;
+class UFlareFleet;
+class UFlareSpacecraftCatalog;
 struct FFlarePlayerSave;
 
+
+/** Parameters of a generated large world, read from a JSON file */
+struct FFlareStressScenarioConfig
+{
+	FFlareStressScenarioConfig();
+
+	/** Read a config file, keeping the defaults for missing fields */
+	bool Load(const FString& Path);
+
+	/** Check that every station and ship class is in the catalog, logging the missing ones */
+	bool Validate(UFlareSpacecraftCatalog* Catalog) const;
+
+	/** Seed of every random choice */
+	int32                                      Seed;
+
+	/** Number of AI companies receiving assets, limited by the company catalog */
+	int32                                      CompanyCount;
+
+	/** Number of populated sectors around each celestial body, limited by the sector catalog */
+	int32                                      SectorsPerMoon;
+
+	int32                                      StationsPerSector;
+	int32                                      StationLevel;
+	int32                                      FleetsPerCompany;
+	int32                                      FleetSize;
+
+	/** Fraction of the fleets made of military ships */
+	float                                      MilitaryRatio;
+
+	/** Trade routes per company, each with its own cargo fleet */
+	int32                                      TradeRoutesPerCompany;
+
+	/** Number of hostile company pairs */
+	int32                                      WarCount;
+
+	int64                                      CompanyMoney;
+
+	TArray<FName>                              StationClasses;
+	TArray<FName>                              CargoShipClasses;
+	TArray<FName>                              MilitaryShipClasses;
+};
+
+
 UCLASS()
 class HELIUMRAIN_API UFlareScenarioTools : public UObject
 {
@@ -24,6 +69,9 @@ public:
 	void GenerateFighterScenario();
 	void GenerateFreighterScenario();
 	void GenerateDebugScenario();
+
+	/** Generate a large world for performance tests, the same for a given config */
+	void GenerateStressScenario(const FFlareStressScenarioConfig& Config);
 	
 	/** Add a new player ship */
 	UFlareSimulatedSpacecraft* CreateRecoveryPlayerShip();
@@ -64,6 +112,12 @@ protected:
 	/** Create a station and fill its input */
 	void CreateStations(FName StationClass, UFlareCompany* Company, UFlareSimulatedSector* Sector, uint32 Count, int32 Level = 1, FFlareStationSpawnParameters SpawnParameters = FFlareStationSpawnParameters());
 
+	/** Create ships of random classes in a single fleet, up to the fleet limit */
+	UFlareFleet* CreateFleet(const TArray<FName>& ShipClasses, UFlareCompany* Company, UFlareSimulatedSector* Sector, int32 Count, FRandomStream& Random);
+
+	/** Get the first sectors of each celestial body, by identifier */
+	TArray<UFlareSimulatedSector*> GetSectorsPerBody(int32 Count);
+
 
 	/*----------------------------------------------------
 		Protected data
@@ -3,6 +3,7 @@
 #include "FlareSimulatedSector.h"
 #include "FlareSector.h"
 #include "../Spacecrafts/FlareSpacecraft.h"
+#include "../Player/FlarePlayerController.h"
 
 
 /*----------------------------------------------------
@@ -14,6 +15,7 @@ UFlareSector::UFlareSector(const FObjectInitializer& ObjectInitializer)
 {
 	SectorRepartitionCache = false;
 	IsDestroyingSector = false;
+	IsLoadingSector = false;
 }
 
 /*----------------------------------------------------
@@ -21,54 +23,174 @@ UFlareSector::UFlareSector(const FObjectInitializer& ObjectInitializer)
 ----------------------------------------------------*/
 
 void UFlareSector::Load(UFlareSimulatedSector* Parent)
+{
+	BeginLoad(Parent);
+	LoadStep(0);
+}
+
+/** Spawn rank of a spacecraft in a staged load, lower first. PlayerLocation is where the player ship spawns, or arrives if it is placed */
+static int32 GetSpacecraftLoadRank(UFlareSimulatedSpacecraft* Spacecraft, UFlareSimulatedSpacecraft* PlayerShip, FVector PlayerLocation, bool IsPlayerPlaced)
+{
+	bool IsPlaced = (Spacecraft->GetData().SpawnMode != EFlareSpawnMode::Safe);
+	bool IsNearby = (PlayerShip && !IsPlaced && FVector::Dist(Spacecraft->GetData().Location, PlayerLocation) < SECTOR_LOAD_NEARBY_DISTANCE);
+
+	if (Spacecraft == PlayerShip && !IsPlaced)
+	{
+		return 0;
+	}
+	else if (IsNearby && IsPlayerPlaced)
+	{
+		// Bodies the arriving player ship must avoid
+		return 0;
+	}
+	else if (Spacecraft == PlayerShip)
+	{
+		return 1;
+	}
+	else if (IsNearby && !Spacecraft->IsStation()
+		&& Spacecraft->GetCompany()->GetPlayerWarState() == EFlareHostility::Hostile)
+	{
+		return 1;
+	}
+	else if (Spacecraft->IsStation())
+	{
+		return 2;
+	}
+	else if (!IsPlaced)
+	{
+		return 3;
+	}
+
+	// Placed ships come after the bodies they must avoid
+	return 4;
+}
+
+void UFlareSector::BeginLoad(UFlareSimulatedSector* Parent)
 {
 	DestroySector();
 	ParentSector = Parent;
 	LocalTime = Parent->GetData()->LocalTime;
+	SectorRepartitionCache = false;
 
-	// Load asteroids
-	for (int i = 0 ; i < ParentSector->GetData()->AsteroidData.Num(); i++)
+	// An arriving player ship only needs the bodies near its arrival point
+	UFlareSimulatedSpacecraft* PlayerShip = GetGame()->GetPC()->GetPlayerShip();
+	bool IsPlayerPlaced = false;
+	FVector PlayerLocation = FVector::ZeroVector;
+	if (PlayerShip)
 	{
-		LoadAsteroid(ParentSector->GetData()->AsteroidData[i]);
+		IsPlayerPlaced = (PlayerShip->GetCurrentSector() == Parent && PlayerShip->GetData().SpawnMode != EFlareSpawnMode::Safe);
+		PlayerLocation = IsPlayerPlaced ? GetArrivalLocation(PlayerShip) : PlayerShip->GetData().Location;
 	}
 
-	// Load safe location spacecrafts
+	// Sort spacecrafts by rank, keeping the sector order in each rank
+	TArray<UFlareSimulatedSpacecraft*> RankedSpacecrafts[5];
 	for (int i = 0 ; i < ParentSector->GetSectorSpacecrafts().Num(); i++)
 	{
 		UFlareSimulatedSpacecraft* Spacecraft = ParentSector->GetSectorSpacecrafts()[i];
-		if (Spacecraft->GetData().SpawnMode == EFlareSpawnMode::Safe)
+		RankedSpacecrafts[GetSpacecraftLoadRank(Spacecraft, PlayerShip, PlayerLocation, IsPlayerPlaced)].Add(Spacecraft);
+	}
+
+	SpacecraftLoadQueue.Empty(ParentSector->GetSectorSpacecrafts().Num());
+	for (int32 Rank = 0; Rank < 5; Rank++)
+	{
+		if (Rank == 4)
 		{
-			LoadSpacecraft(Spacecraft);
+			AsteroidQueuePosition = SpacecraftLoadQueue.Num();
 		}
+		SpacecraftLoadQueue.Append(RankedSpacecrafts[Rank]);
 	}
 
-	SectorRepartitionCache = false;
-
-	// Load unsafe location spacecrafts
-	for (int i = 0 ; i < ParentSector->GetSectorSpacecrafts().Num(); i++)
+	// Asteroids near the arrival point are loaded first, the others before the placed ships
+	const TArray<FFlareAsteroidSave>& AsteroidData = ParentSector->GetData()->AsteroidData;
+	TArray<int32> FarAsteroids;
+	AsteroidLoadQueue.Empty(AsteroidData.Num());
+	for (int32 AsteroidIndex = 0; AsteroidIndex < AsteroidData.Num(); AsteroidIndex++)
 	{
-		UFlareSimulatedSpacecraft* Spacecraft = ParentSector->GetSectorSpacecrafts()[i];
-		if (Spacecraft->GetData().SpawnMode != EFlareSpawnMode::Safe)
+		if (IsPlayerPlaced && FVector::Dist(AsteroidData[AsteroidIndex].Location, PlayerLocation) < SECTOR_LOAD_NEARBY_DISTANCE)
+		{
+			AsteroidLoadQueue.Add(AsteroidIndex);
+		}
+		else
 		{
-			LoadSpacecraft(Spacecraft);
+			FarAsteroids.Add(AsteroidIndex);
 		}
 	}
+	AsteroidFirstStepCount = AsteroidLoadQueue.Num();
+	AsteroidLoadQueue.Append(FarAsteroids);
 
-	// Check docking once all spacecraft are loaded
-	for (int i = 0 ; i < SectorSpacecrafts.Num(); i++)
+	// The first step spawns the player ship, and its dock station so that it is docked right away
+	SpacecraftFirstStepCount = 0;
+	if (PlayerShip)
 	{
-		SectorSpacecrafts[i]->Redock();
+		SpacecraftFirstStepCount = SpacecraftLoadQueue.Find(PlayerShip) + 1;
+
+		UFlareSimulatedSpacecraft* DockStation = GetGame()->GetGameWorld()->FindSpacecraft(PlayerShip->GetData().DockedTo);
+		if (DockStation)
+		{
+			SpacecraftFirstStepCount = FMath::Max(SpacecraftFirstStepCount, SpacecraftLoadQueue.Find(DockStation) + 1);
+		}
 	}
 
-	// Load bombs
-	for (int i = 0 ; i < ParentSector->GetData()->BombData.Num(); i++)
+	SpacecraftLoadIndex = 0;
+	AsteroidLoadIndex = 0;
+	IsLoadingSector = true;
+}
+
+bool UFlareSector::LoadStep(double TimeBudget)
+{
+	double StartTime = FPlatformTime::Seconds();
+	const TArray<FFlareAsteroidSave>& AsteroidData = ParentSector->GetData()->AsteroidData;
+
+	while (IsLoadingSector)
 	{
-		LoadBomb(ParentSector->GetData()->BombData[i]);
+		// Asteroids, the ones near an arriving player ship first
+		int32 AsteroidLoadCount = (SpacecraftLoadIndex >= AsteroidQueuePosition) ? AsteroidLoadQueue.Num() : AsteroidFirstStepCount;
+		if (AsteroidLoadIndex < AsteroidLoadCount)
+		{
+			LoadAsteroid(AsteroidData[AsteroidLoadQueue[AsteroidLoadIndex++]]);
+		}
+
+		// Spacecrafts
+		else if (SpacecraftLoadIndex < SpacecraftLoadQueue.Num())
+		{
+			AFlareSpacecraft* Spacecraft = LoadSpacecraft(SpacecraftLoadQueue[SpacecraftLoadIndex++]);
+			if (Spacecraft)
+			{
+				RedockSpawnedPairs(Spacecraft);
+			}
+		}
+
+		// Bombs, once all spacecrafts are loaded
+		else
+		{
+			for (int i = 0 ; i < ParentSector->GetData()->BombData.Num(); i++)
+			{
+				LoadBomb(ParentSector->GetData()->BombData[i]);
+			}
+
+			SpacecraftLoadQueue.Empty();
+			AsteroidLoadQueue.Empty();
+			IsLoadingSector = false;
+			FLOGV("UFlareSector::LoadStep : '%s' loaded", *ParentSector->GetSectorName().ToString());
+		}
+
+		if (TimeBudget > 0 && SpacecraftLoadIndex >= SpacecraftFirstStepCount && FPlatformTime::Seconds() - StartTime >= TimeBudget)
+		{
+			break;
+		}
 	}
+
+	return !IsLoadingSector;
 }
 
 void UFlareSector::Save()
 {
+	// Asteroids and bombs are saved from their actors
+	if (IsLoadingSector)
+	{
+		LoadStep(0);
+	}
+
 	FFlareSectorSave* SectorData  = GetSimulatedSector()->GetData();
 
 	SectorData->BombData.Empty();
@@ -93,6 +215,9 @@ void UFlareSector::DestroySector()
 	FLOG("UFlareSector::DestroySector");
 
 	IsDestroyingSector = true;
+	IsLoadingSector = false;
+	SpacecraftLoadQueue.Empty();
+	AsteroidLoadQueue.Empty();
 
 	// Remove spacecrafts from world
 	for (int SpacecraftIndex = 0 ; SpacecraftIndex < SectorSpacecrafts.Num(); SpacecraftIndex++)
@@ -218,61 +343,7 @@ AFlareSpacecraft* UFlareSector::LoadSpacecraft(UFlareSimulatedSpacecraft* Parent
 					*ParentSpacecraft->GetImmatriculation().ToString(),
 					ParentSpacecraft->GetData().Location.X, ParentSpacecraft->GetData().Location.Y, ParentSpacecraft->GetData().Location.Z);
 
-				FVector SpawnDirection;
-				TArray<AFlareSpacecraft*> FriendlySpacecrafts = GetCompanySpacecrafts(Spacecraft->GetCompany());
-				FVector FriendlyShipLocationSum = FVector::ZeroVector;
-				int FriendlyShipCount = 0;
-
-				for (int SpacecraftIndex = 0 ; SpacecraftIndex < FriendlySpacecrafts.Num(); SpacecraftIndex++)
-				{
-					AFlareSpacecraft *SpacecraftCandidate = FriendlySpacecrafts[SpacecraftIndex];
-					if (!SpacecraftCandidate->IsStation() && SpacecraftCandidate != Spacecraft)
-					{
-						FriendlyShipLocationSum += SpacecraftCandidate->GetActorLocation();
-						FriendlyShipCount++;
-					}
-				}
-
-				if (FriendlyShipCount == 0)
-				{
-					FVector NotFriendlyShipLocationSum = FVector::ZeroVector;
-					int NotFriendlyShipCount = 0;
-					for (int SpacecraftIndex = 0 ; SpacecraftIndex < SectorShips.Num(); SpacecraftIndex++)
-					{
-						AFlareSpacecraft *SpacecraftCandidate = SectorShips[SpacecraftIndex];
-						if (SpacecraftCandidate != Spacecraft && SpacecraftCandidate->GetCompany() != Spacecraft->GetCompany())
-						{
-							NotFriendlyShipLocationSum += SpacecraftCandidate->GetActorLocation();
-							NotFriendlyShipCount++;
-						}
-					}
-
-					if (NotFriendlyShipCount == 0)
-					{
-						SpawnDirection = FMath::VRand();
-					}
-					else
-					{
-						FVector	NotFriendlyShipLocationMean = NotFriendlyShipLocationSum / NotFriendlyShipCount;
-						SpawnDirection = (GetSectorCenter() - NotFriendlyShipLocationMean).GetUnsafeNormal();
-					}
-				}
-				else
-				{
-					FVector	FriendlyShipLocationMean = FriendlyShipLocationSum / FriendlyShipCount;
-					SpawnDirection = (FriendlyShipLocationMean - GetSectorCenter()).GetUnsafeNormal() ;
-				}
-
-				float SpawnDistance = GetSectorRadius() + 1;
-
-				if (GetSimulatedSector()->GetSectorBattleState(Spacecraft->GetCompany()) != EFlareSectorBattleState::NoBattle)
-				{
-					SpawnDistance += 500000; // 5 km
-				}
-
-				SpawnDistance = FMath::Min(SpawnDistance, GetSectorLimits());
-
-				FVector Location = GetSectorCenter() + SpawnDirection * SpawnDistance;
+				FVector Location = GetArrivalLocation(ParentSpacecraft);
 
 				FVector CenterDirection = (GetSectorCenter() - Location).GetUnsafeNormal();
 				Spacecraft->SetActorRotation(CenterDirection.Rotation());
@@ -292,10 +363,8 @@ AFlareSpacecraft* UFlareSector::LoadSpacecraft(UFlareSimulatedSpacecraft* Parent
 			break;
 			case EFlareSpawnMode::Exit:
 			{
-				float SpawnDistance = GetSectorLimits() * 0.9;
 				float SpawnVelocity = ParentSpacecraft->GetData().LinearVelocity.Size() * 0.6;
-				FVector SpawnDirection = ParentSpacecraft->GetData().Location.GetUnsafeNormal();
-				FVector Location = SpawnDirection * SpawnDistance;
+				FVector Location = GetArrivalLocation(ParentSpacecraft);
 				FVector CenterDirection = (GetSectorCenter() - Location).GetUnsafeNormal();
 
 				FLOGV("UFlareSector::LoadSpacecraft : Exit '%s' at (%f, %f, %f)",
@@ -505,6 +574,92 @@ AActor* UFlareSector::GetNearestBody(FVector Location, float* NearestDistance, b
 	return NearestCandidateActor;
 }
 
+FVector UFlareSector::GetArrivalLocation(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	switch (Spacecraft->GetData().SpawnMode)
+	{
+		// Incoming in sector, near the friendly ships or away from the others
+		case EFlareSpawnMode::Travel:
+		{
+			FVector SpawnDirection;
+			FVector FriendlyShipLocationSum = FVector::ZeroVector;
+			FVector NotFriendlyShipLocationSum = FVector::ZeroVector;
+			int FriendlyShipCount = 0;
+			int NotFriendlyShipCount = 0;
+
+			// Use the spawned ships, and the saved locations of the ships yet to spawn there, so that the result doesn't depend on the spawn order
+			for (int ShipIndex = 0 ; ShipIndex < ParentSector->GetSectorShips().Num(); ShipIndex++)
+			{
+				UFlareSimulatedSpacecraft* ShipCandidate = ParentSector->GetSectorShips()[ShipIndex];
+				FVector ShipLocation;
+
+				if (ShipCandidate == Spacecraft)
+				{
+					continue;
+				}
+				else if (ShipCandidate->IsActive())
+				{
+					ShipLocation = ShipCandidate->GetActive()->GetActorLocation();
+				}
+				else if (ShipCandidate->GetData().SpawnMode == EFlareSpawnMode::Safe)
+				{
+					ShipLocation = ShipCandidate->GetData().Location;
+				}
+				else
+				{
+					continue;
+				}
+
+				if (ShipCandidate->GetCompany() == Spacecraft->GetCompany())
+				{
+					FriendlyShipLocationSum += ShipLocation;
+					FriendlyShipCount++;
+				}
+				else
+				{
+					NotFriendlyShipLocationSum += ShipLocation;
+					NotFriendlyShipCount++;
+				}
+			}
+
+			if (FriendlyShipCount > 0)
+			{
+				FVector	FriendlyShipLocationMean = FriendlyShipLocationSum / FriendlyShipCount;
+				SpawnDirection = (FriendlyShipLocationMean - GetSectorCenter()).GetUnsafeNormal();
+			}
+			else if (NotFriendlyShipCount > 0)
+			{
+				FVector	NotFriendlyShipLocationMean = NotFriendlyShipLocationSum / NotFriendlyShipCount;
+				SpawnDirection = (GetSectorCenter() - NotFriendlyShipLocationMean).GetUnsafeNormal();
+			}
+			else
+			{
+				// Random, but the same during a load
+				FRandomStream DirectionStream(GetTypeHash(Spacecraft->GetImmatriculation()) ^ (int32) LocalTime);
+				SpawnDirection = DirectionStream.VRand();
+			}
+
+			float SpawnDistance = GetSectorRadius() + 1;
+
+			if (GetSimulatedSector()->GetSectorBattleState(Spacecraft->GetCompany()) != EFlareSectorBattleState::NoBattle)
+			{
+				SpawnDistance += 500000; // 5 km
+			}
+
+			SpawnDistance = FMath::Min(SpawnDistance, GetSectorLimits());
+
+			return GetSectorCenter() + SpawnDirection * SpawnDistance;
+		}
+
+		// Leaving the sector, near its limits
+		case EFlareSpawnMode::Exit:
+			return Spacecraft->GetData().Location.GetUnsafeNormal() * GetSectorLimits() * 0.9;
+
+		default:
+			return Spacecraft->GetData().Location;
+	}
+}
+
 void UFlareSector::PlaceSpacecraft(AFlareSpacecraft* Spacecraft, FVector Location)
 {
 	float RandomLocationRadiusIncrement = 80000; // 800m
@@ -592,15 +747,15 @@ void UFlareSector::GenerateSectorRepartitionCache()
 		FVector SectorMin = FVector(INFINITY, INFINITY, INFINITY);
 		FVector SectorMax = FVector(-INFINITY, -INFINITY, -INFINITY);
 
-		for (int SpacecraftIndex = 0 ; SpacecraftIndex < SectorSpacecrafts.Num(); SpacecraftIndex++)
+		// Use the saved station locations so that the result doesn't depend on the spawn order
+		for (int StationIndex = 0 ; StationIndex < ParentSector->GetSectorStations().Num(); StationIndex++)
 		{
-			AFlareSpacecraft *Spacecraft = SectorSpacecrafts[SpacecraftIndex];
-			if (Spacecraft->IsStation())
-			{
-				SectorMin = SectorMin.ComponentMin(Spacecraft->GetActorLocation());
-				SectorMax = SectorMax.ComponentMax(Spacecraft->GetActorLocation());
-				SignificantObjectCount++;
-			}
+			UFlareSimulatedSpacecraft *Station = ParentSector->GetSectorStations()[StationIndex];
+			FVector Location = Station->IsActive() ? Station->GetActive()->GetActorLocation() : Station->GetData().Location;
+
+			SectorMin = SectorMin.ComponentMin(Location);
+			SectorMax = SectorMax.ComponentMax(Location);
+			SignificantObjectCount++;
 		}
 
 		if (SignificantObjectCount > 0)
@@ -613,6 +768,34 @@ void UFlareSector::GenerateSectorRepartitionCache()
 	}
 }
 
+void UFlareSector::RedockSpawnedPairs(AFlareSpacecraft* Spacecraft)
+{
+	// Check docking once both the ship and its station are loaded
+	for (int i = 0 ; i < SectorSpacecrafts.Num(); i++)
+	{
+		AFlareSpacecraft* Other = SectorSpacecrafts[i];
+		if (Other != Spacecraft && Other->GetData().DockedTo == Spacecraft->GetImmatriculation())
+		{
+			Other->Redock();
+		}
+		else if (Other != Spacecraft && Spacecraft->GetData().DockedTo == Other->GetImmatriculation())
+		{
+			Spacecraft->Redock();
+		}
+	}
+}
+
+float UFlareSector::GetLoadProgress() const
+{
+	if (!IsLoadingSector)
+	{
+		return 1.f;
+	}
+
+	int32 Total = SpacecraftLoadQueue.Num() + ParentSector->GetData()->AsteroidData.Num() + 1;
+	return (float) (SpacecraftLoadIndex + AsteroidLoadIndex) / Total;
+}
+
 FVector UFlareSector::GetSectorCenter()
 {
 	GenerateSectorRepartitionCache();
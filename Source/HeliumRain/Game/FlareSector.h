@@ -11,6 +11,9 @@ class UFlareSimulatedSector;
 class AFlareGame;
 class AFlareAsteroid;
 
+/** Distance under which hostile ships are spawned right after the player ship */
+#define SECTOR_LOAD_NEARBY_DISTANCE 1000000 // 10 km
+
 UCLASS()
 class HELIUMRAIN_API UFlareSector : public UObject
 {
@@ -25,6 +28,12 @@ public:
 	/** Load the sector from a save file */
 	virtual void Load(UFlareSimulatedSector* Parent);
 
+	/** Prepare a staged load : the player ship, nearby hostiles, stations, then everything else. An arriving player ship comes right after the bodies near its arrival point */
+	virtual void BeginLoad(UFlareSimulatedSector* Parent);
+
+	/** Spawn queued actors for up to TimeBudget seconds, with no limit if TimeBudget is 0. Return true once the sector is loaded */
+	bool LoadStep(double TimeBudget);
+
 	/** Save the sector to a save file */
 	virtual void Save();
 
@@ -42,6 +51,9 @@ public:
 
 	AFlareBomb* LoadBomb(const FFlareBombSave& BombData);
 
+	/** Dock a newly loaded spacecraft to its station, or its ships to it */
+	void RedockSpawnedPairs(AFlareSpacecraft* Spacecraft);
+
 	void RegisterBomb(AFlareBomb* Bomb);
 
 	void UnregisterBomb(AFlareBomb* Bomb);
@@ -59,6 +71,9 @@ public:
 
 	void PlaceSpacecraft(AFlareSpacecraft* Spacecraft, FVector Location);
 
+	/** Get where a placed spacecraft arrives, before it is moved away from the bodies it overlaps */
+	FVector GetArrivalLocation(UFlareSimulatedSpacecraft* Spacecraft);
+
 protected:
 
 	/*----------------------------------------------------
@@ -89,6 +104,16 @@ protected:
 	FVector                        SectorCenter;
 	float                          SectorRadius;
 
+	// Staged load
+	bool                           IsLoadingSector;
+	TArray<UFlareSimulatedSpacecraft*> SpacecraftLoadQueue;
+	int32                          SpacecraftLoadIndex;
+	int32                          SpacecraftFirstStepCount;
+	int32                          AsteroidQueuePosition;
+	TArray<int32>                  AsteroidLoadQueue;
+	int32                          AsteroidFirstStepCount;
+	int32                          AsteroidLoadIndex;
+
 
 public:
 
@@ -152,6 +177,15 @@ public:
 		return LocalTime;
 	}
 
+	/** Check if all actors of the sector are spawned */
+	inline bool IsLoaded() const
+	{
+		return !IsLoadingSector;
+	}
+
+	/** Get the ratio of actors spawned during a staged load */
+	float GetLoadProgress() const;
+
 	void GenerateSectorRepartitionCache();
 
 	FVector GetSectorCenter();
@@ -23,6 +23,7 @@ UFlareSimulatedSpacecraft*  SectorHelper::FindTradeStation(FlareTradeRequest Req
 
 	UFlareSimulatedSector* Sector = Request.Client->GetCurrentSector();
 	TArray<UFlareSimulatedSpacecraft*>& SectorStations = Sector->GetSectorStations();
+	const FFlareResourceStations& ResourceStations = Sector->GetResourceStations(Request.Resource);
 
 	float UnloadQuantityScoreMultiplier = 0;
 	float LoadQuantityScoreMultiplier = 0;
@@ -74,91 +75,102 @@ UFlareSimulatedSpacecraft*  SectorHelper::FindTradeStation(FlareTradeRequest Req
 	uint32 AvailableQuantity = Request.Client->GetCargoBay()->GetResourceQuantity(Request.Resource, Request.Client->GetCompany());
 	uint32 FreeSpace = Request.Client->GetCargoBay()->GetFreeSpaceForResource(Request.Resource, Request.Client->GetCompany());
 
-	for (int32 StationIndex = 0; StationIndex < SectorStations.Num(); StationIndex++)
+	// Only visit stations producing or using the resource
+	TArray<const TArray<UFlareSimulatedSpacecraft*>*> CandidateLists;
+	if (NeedOutput)
 	{
-		UFlareSimulatedSpacecraft* Station = SectorStations[StationIndex];
+		CandidateLists.Add(&ResourceStations.Producers);
+	}
+	if (NeedInput)
+	{
+		CandidateLists.Add(&ResourceStations.Consumers);
+		CandidateLists.Add(&ResourceStations.Maintenance);
+	}
 
-		if(!Request.Client->CanTradeWith(Station))
-		{
-			continue;
-		}
-		EFlareResourcePriceContext::Type StationResourceUsage = Station->GetResourceUseType(Request.Resource);
+	for (int32 ListIndex = 0; ListIndex < CandidateLists.Num(); ListIndex++)
+	{
+		const TArray<UFlareSimulatedSpacecraft*>& CandidateStations = *CandidateLists[ListIndex];
 
-		if(NeedOutput && StationResourceUsage != EFlareResourcePriceContext::FactoryOutput)
+		for (int32 StationIndex = 0; StationIndex < CandidateStations.Num(); StationIndex++)
 		{
-			continue;
-		}
+			UFlareSimulatedSpacecraft* Station = CandidateStations[StationIndex];
 
-		if(NeedInput && (StationResourceUsage != EFlareResourcePriceContext::FactoryInput &&
-						 StationResourceUsage != EFlareResourcePriceContext::ConsumerConsumption &&
-						 StationResourceUsage != EFlareResourcePriceContext::MaintenanceConsumption))
-		{
-			continue;
-		}
+			if(!Request.Client->CanTradeWith(Station))
+			{
+				continue;
+			}
 
-		uint32 StationFreeSpace = Station->GetCargoBay()->GetFreeSpaceForResource(Request.Resource, Request.Client->GetCompany());
-		uint32 StationResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Request.Resource, Request.Client->GetCompany());
+			uint32 StationFreeSpace = Station->GetCargoBay()->GetFreeSpaceForResource(Request.Resource, Request.Client->GetCompany());
+			uint32 StationResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Request.Resource, Request.Client->GetCompany());
 
-		if (StationFreeSpace == 0 && StationResourceQuantity == 0)
-		{
-			continue;
-		}
+			if (StationFreeSpace == 0 && StationResourceQuantity == 0)
+			{
+				continue;
+			}
 
-		float Score = 0;
-		float FullRatio =  (float) StationResourceQuantity / (float) (StationResourceQuantity + StationFreeSpace);
-		float EmptyRatio = 1 - FullRatio;
-		uint32 UnloadMaxQuantity  = 0;
-		uint32 LoadMaxQuantity  = 0;
+			float Score = 0;
+			float FullRatio =  (float) StationResourceQuantity / (float) (StationResourceQuantity + StationFreeSpace);
+			float EmptyRatio = 1 - FullRatio;
+			uint32 UnloadMaxQuantity  = 0;
+			uint32 LoadMaxQuantity  = 0;
 
 
-		// Check cargo limit
-		if(NeedOutput && Request.CargoLimit != -1 && FullRatio < Request.CargoLimit)
-		{
-			continue;
-		}
+			// Check cargo limit
+			if(NeedOutput && Request.CargoLimit != -1 && FullRatio < Request.CargoLimit)
+			{
+				continue;
+			}
 
-		if(NeedInput && Request.CargoLimit != -1 && FullRatio > Request.CargoLimit)
-		{
-			continue;
-		}
+			if(NeedInput && Request.CargoLimit != -1 && FullRatio > Request.CargoLimit)
+			{
+				continue;
+			}
 
-		if(Station->GetCargoBay()->WantBuy(Request.Resource, Request.Client->GetCompany()))
-		{
-			UnloadMaxQuantity = StationFreeSpace;
-			UnloadMaxQuantity  = FMath::Min(UnloadMaxQuantity , AvailableQuantity);
-		}
+			if(Station->GetCargoBay()->WantBuy(Request.Resource, Request.Client->GetCompany()))
+			{
+				UnloadMaxQuantity = StationFreeSpace;
+				UnloadMaxQuantity  = FMath::Min(UnloadMaxQuantity , AvailableQuantity);
+			}
 
-		if(Station->GetCargoBay()->WantSell(Request.Resource, Request.Client->GetCompany()))
-		{
-			LoadMaxQuantity = StationResourceQuantity;
-			LoadMaxQuantity = FMath::Min(LoadMaxQuantity , FreeSpace);
-		}
+			if(Station->GetCargoBay()->WantSell(Request.Resource, Request.Client->GetCompany()))
+			{
+				LoadMaxQuantity = StationResourceQuantity;
+				LoadMaxQuantity = FMath::Min(LoadMaxQuantity , FreeSpace);
+			}
 
-		if(Station->GetCompany() == Request.Client->GetCompany())
-		{
-			Score += UnloadMaxQuantity * UnloadQuantityScoreMultiplier;
-			Score += LoadMaxQuantity * LoadQuantityScoreMultiplier;
-		}
-		else
-		{
-			EFlareResourcePriceContext::Type ResourceUsage = Station->GetResourceUseType(Request.Resource);
+			if(Station->GetCompany() == Request.Client->GetCompany())
+			{
+				Score += UnloadMaxQuantity * UnloadQuantityScoreMultiplier;
+				Score += LoadMaxQuantity * LoadQuantityScoreMultiplier;
+			}
+			else
+			{
+				EFlareResourcePriceContext::Type ResourceUsage = Station->GetResourceUseType(Request.Resource);
 
-			uint32 MaxBuyableQuantity = Request.Client->GetCompany()->GetMoney() / Sector->GetResourcePrice(Request.Resource, ResourceUsage);
-			LoadMaxQuantity = FMath::Min(LoadMaxQuantity , MaxBuyableQuantity);
+				uint32 MaxBuyableQuantity = Request.Client->GetCompany()->GetMoney() / Sector->GetResourcePrice(Request.Resource, ResourceUsage);
+				LoadMaxQuantity = FMath::Min(LoadMaxQuantity , MaxBuyableQuantity);
 
-			uint32 MaxSellableQuantity = Station->GetCompany()->GetMoney() / Sector->GetResourcePrice(Request.Resource, ResourceUsage);
-			UnloadMaxQuantity = FMath::Min(UnloadMaxQuantity , MaxSellableQuantity);
+				uint32 MaxSellableQuantity = Station->GetCompany()->GetMoney() / Sector->GetResourcePrice(Request.Resource, ResourceUsage);
+				UnloadMaxQuantity = FMath::Min(UnloadMaxQuantity , MaxSellableQuantity);
 
-			Score += UnloadMaxQuantity * SellQuantityScoreMultiplier;
-			Score += LoadMaxQuantity * BuyQuantityScoreMultiplier;
-		}
+				Score += UnloadMaxQuantity * SellQuantityScoreMultiplier;
+				Score += LoadMaxQuantity * BuyQuantityScoreMultiplier;
+			}
 
-		Score *= 1 + (FullRatio * FullRatioBonus) + (EmptyRatio * EmptyRatioBonus);
+			Score *= 1 + (FullRatio * FullRatioBonus) + (EmptyRatio * EmptyRatioBonus);
 
-		if(Score > 0 && Score > BestScore)
-		{
-			BestScore = Score;
-			BestStation = Station;
+			// On a tie, keep the station that comes first in the sector, as when all stations were visited in order
+			bool IsBetter = (Score > BestScore);
+			if (Score == BestScore && BestStation)
+			{
+				IsBetter = (SectorStations.Find(Station) < SectorStations.Find(BestStation));
+			}
+
+			if(Score > 0 && IsBetter)
+			{
+				BestScore = Score;
+				BestStation = Station;
+			}
 		}
 	}
 
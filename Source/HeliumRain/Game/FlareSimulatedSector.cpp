@@ -4,7 +4,9 @@
 #include "FlareGame.h"
 #include "FlareWorld.h"
 #include "FlareFleet.h"
+#include "AI/FlareCompanyAI.h"
 #include "../Economy/FlareCargoBay.h"
+#include "../Economy/FlareFactory.h"
 #include "../Spacecrafts/FlareSimulatedSpacecraft.h"
 #include "../Player/FlarePlayerController.h"
 
@@ -14,6 +16,8 @@ DECLARE_CYCLE_STAT(TEXT("FlareSector GetSectorBattleState"), STAT_FlareSector_Ge
 
 #define LOCTEXT_NAMESPACE "FlareSimulatedSector"
 
+#define PRICE_HISTORY_LENGTH 50
+
 
 /*----------------------------------------------------
 	Constructor
@@ -23,6 +27,11 @@ UFlareSimulatedSector::UFlareSimulatedSector(const FObjectInitializer& ObjectIni
 	: Super(ObjectInitializer)
 {
 	PersistentStationIndex = 0;
+	PriceHistoryWriteIndex = 0;
+	PriceHistoryCount = 0;
+	PriceResourceCount = 0;
+	PriceVersion = 0;
+	WorldIndex = INDEX_NONE;
 }
 
 void UFlareSimulatedSector::Load(const FFlareSectorDescription* Description, const FFlareSectorSave& Data, const FFlareSectorOrbitParameters& OrbitParameters)
@@ -45,6 +54,7 @@ void UFlareSimulatedSector::Load(const FFlareSectorDescription* Description, con
 	SectorStations.Empty();
 	SectorSpacecrafts.Empty();
 	SectorFleets.Empty();
+	ResourceStations.Empty();
 
 	FFlareCelestialBody* Body = Game->GetGameWorld()->GetPlanerarium()->FindCelestialBody(SectorOrbitParameters.CelestialBodyIdentifier);
 	if (Body)
@@ -78,6 +88,11 @@ void UFlareSimulatedSector::Load(const FFlareSectorDescription* Description, con
 		}
 		SectorSpacecrafts.Add(Spacecraft);
 		Spacecraft->SetCurrentSector(this);
+
+		if (Spacecraft->IsStation())
+		{
+			IndexStation(Spacecraft);
+		}
 	}
 
 
@@ -356,6 +371,12 @@ UFlareSimulatedSpacecraft* UFlareSimulatedSector::CreateSpacecraft(FFlareSpacecr
 
 	Spacecraft->SetCurrentSector(this);
 
+	if (Spacecraft->IsStation())
+	{
+		IndexStation(Spacecraft);
+		InvalidateConstructionPlans(INDEX_NONE);
+	}
+
 	FLOGV("UFlareSimulatedSector::CreateShip : Created ship '%s' at %s", *Spacecraft->GetImmatriculation().ToString(), *TargetPosition.ToString());
 
 	if (!Spacecraft->IsStation())
@@ -442,7 +463,12 @@ void UFlareSimulatedSector::RetireFleet(UFlareFleet* Fleet)
 
 int UFlareSimulatedSector::RemoveSpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 {
-	SectorStations.Remove(Spacecraft);
+	if (SectorStations.Remove(Spacecraft) > 0)
+	{
+		UnindexStation(Spacecraft);
+		InvalidateConstructionPlans(INDEX_NONE);
+	}
+
 	SectorShips.Remove(Spacecraft);
 	return SectorSpacecrafts.Remove(Spacecraft);
 }
@@ -452,54 +478,96 @@ int UFlareSimulatedSector::RemoveSpacecraft(UFlareSimulatedSpacecraft* Spacecraf
 ----------------------------------------------------*/
 
 
+const FFlareResourceStations& UFlareSimulatedSector::GetResourceStations(FFlareResourceDescription* Resource) const
+{
+	static const FFlareResourceStations EmptyStations;
+
+	const FFlareResourceStations* Stations = ResourceStations.Find(Resource);
+	return Stations ? *Stations : EmptyStations;
+}
+
 FText UFlareSimulatedSector::GetSectorDescription() const
 {
 	return SectorDescription->Description;
 }
 
 bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>& OutReasons, bool IgnoreCost)
+{
+	return CheckBuildStation(StationDescription, Company, &OutReasons, IgnoreCost);
+}
+
+bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, bool IgnoreCost)
+{
+	return CheckBuildStation(StationDescription, Company, NULL, IgnoreCost);
+}
+
+bool UFlareSimulatedSector::CheckBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>* OutReasons, bool IgnoreCost)
 {
 	bool Result = true;
 
 	// Too many stations
 	if (SectorStations.Num() >= GetMaxStationsInSector())
 	{
-		OutReasons.Add(LOCTEXT("BuildTooManyStations", "There are too many stations in the sector"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildTooManyStations", "There are too many stations in the sector"));
 		Result = false;
 	}
 
 	// Does it needs sun
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::SunExposure) && SectorDescription->IsSolarPoor)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresSun", "This station can't be built near debris or dust"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresSun", "This station can't be built near debris or dust"));
 		Result = false;
 	}
 
 	// Does it needs not icy sector
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::HideOnIce) &&SectorDescription->IsIcy)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresNoIcy", "This station can only be built in non-icy sectors"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresNoIcy", "This station can only be built in non-icy sectors"));
 		Result = false;
 	}
 
 	// Does it needs icy sector
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::HideOnNoIce) && !SectorDescription->IsIcy)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresIcy", "This station can only be built in icy sectors"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresIcy", "This station can only be built in icy sectors"));
 		Result = false;
 	}
 
 	// Does it needs an geostationary orbit ?
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::GeostationaryOrbit) && !SectorDescription->IsGeostationary)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresGeo", "This station can only be built in geostationary sectors"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresGeo", "This station can only be built in geostationary sectors"));
 		Result = false;
 	}
 
 	// Does it needs an asteroid ?
 	if (StationDescription->BuildConstraint.Contains(EFlareBuildConstraint::FreeAsteroid) && SectorData.AsteroidData.Num() == 0)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresAsteroid", "This station can only be built on an asteroid"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresAsteroid", "This station can only be built on an asteroid"));
 		Result = false;
 	}
 
@@ -511,7 +579,11 @@ bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* Station
 	// Check money cost
 	if (Company->GetMoney() < GetStationConstructionFee(StationDescription->CycleCost.ProductionCost))
 	{
-		OutReasons.Add(FText::Format(LOCTEXT("BuildRequiresMoney", "Not enough credits ({0} / {1})"),
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(FText::Format(LOCTEXT("BuildRequiresMoney", "Not enough credits ({0} / {1})"),
 			FText::AsNumber(UFlareGameTools::DisplayMoney(Company->GetMoney())),
 			FText::AsNumber(UFlareGameTools::DisplayMoney(GetStationConstructionFee(StationDescription->CycleCost.ProductionCost)))));
 		Result = false;
@@ -539,7 +611,11 @@ bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* Station
 	}
 	if (!HasFreeCargo)
 	{
-		OutReasons.Add(LOCTEXT("BuildRequiresCargo", "No cargo with free space"));
+		if (!OutReasons)
+		{
+			return false;
+		}
+		OutReasons->Add(LOCTEXT("BuildRequiresCargo", "No cargo with free space"));
 		Result = false;
 	}
 	
@@ -610,7 +686,11 @@ bool UFlareSimulatedSector::CanBuildStation(FFlareSpacecraftDescription* Station
 		}
 		if (!ResourceFound)
 		{
-			OutReasons.Add(FText::Format(LOCTEXT("BuildRequiresResources", "Not enough {0} ({1} / {2})"),
+			if (!OutReasons)
+			{
+				return false;
+			}
+			OutReasons->Add(FText::Format(LOCTEXT("BuildRequiresResources", "Not enough {0} ({1} / {2})"),
 					FactoryResource->Resource->Data.Name,
 					FText::AsNumber(AvailableQuantity),
 					FText::AsNumber(FactoryResource->Quantity)));
@@ -822,6 +902,7 @@ bool UFlareSimulatedSector::UpgradeStation(UFlareSimulatedSpacecraft* Station)
 	}
 
 	Station->Upgrade();
+	RefreshStationIndex(Station);
 
 	return true;
 }
@@ -894,9 +975,10 @@ void UFlareSimulatedSector::SimulatePriceVariation(FFlareResourceDescription* Re
 
 
 	// Prices never go below min production cost
-	for (int32 CountIndex = 0 ; CountIndex < SectorStations.Num(); CountIndex++)
+	const TArray<UFlareSimulatedSpacecraft*>& PriceStations = GetResourceStations(Resource).PriceStations;
+	for (int32 CountIndex = 0 ; CountIndex < PriceStations.Num(); CountIndex++)
 	{
-		UFlareSimulatedSpacecraft* Station = SectorStations[CountIndex];
+		UFlareSimulatedSpacecraft* Station = PriceStations[CountIndex];
 
 		if(Station->GetCargoBay()->HasRestrictions())
 		{
@@ -1017,6 +1099,113 @@ void UFlareSimulatedSector::SimulatePriceVariation(FFlareResourceDescription* Re
 	}
 }
 
+void UFlareSimulatedSector::RefreshStationIndex(UFlareSimulatedSpacecraft* Station)
+{
+	if (!SectorStations.Contains(Station))
+	{
+		return;
+	}
+
+	UnindexStation(Station);
+	IndexStation(Station);
+}
+
+void UFlareSimulatedSector::InvalidateConstructionPlans(int32 ResourceIndex)
+{
+	if (!Game->GetGameWorld())
+	{
+		return;
+	}
+
+	const TArray<UFlareCompany*>& Companies = Game->GetGameWorld()->GetCompanies();
+	for (int32 CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		if (Companies[CompanyIndex]->GetAI())
+		{
+			Companies[CompanyIndex]->GetAI()->InvalidateConstructionPlan(this, ResourceIndex);
+		}
+	}
+}
+
+void UFlareSimulatedSector::IndexStation(UFlareSimulatedSpacecraft* Station)
+{
+	for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+		FFlareResourceStations& Stations = ResourceStations.FindOrAdd(Resource);
+
+		switch (Station->GetResourceUseType(Resource))
+		{
+			case EFlareResourcePriceContext::FactoryOutput:
+				Stations.Producers.Add(Station);
+				break;
+			case EFlareResourcePriceContext::FactoryInput:
+			case EFlareResourcePriceContext::ConsumerConsumption:
+				Stations.Consumers.Add(Station);
+				break;
+			case EFlareResourcePriceContext::MaintenanceConsumption:
+				Stations.Maintenance.Add(Station);
+				break;
+			default:
+				break;
+		}
+
+		if (Station->HasCapability(EFlareSpacecraftCapability::Storage))
+		{
+			Stations.Storage.Add(Station);
+		}
+
+		if (IsPriceStation(Station, Resource))
+		{
+			Stations.PriceStations.Add(Station);
+		}
+	}
+}
+
+void UFlareSimulatedSector::UnindexStation(UFlareSimulatedSpacecraft* Station)
+{
+	for (TPair<FFlareResourceDescription*, FFlareResourceStations>& Entry : ResourceStations)
+	{
+		FFlareResourceStations& Stations = Entry.Value;
+		Stations.Producers.Remove(Station);
+		Stations.Consumers.Remove(Station);
+		Stations.Maintenance.Remove(Station);
+		Stations.Storage.Remove(Station);
+		Stations.PriceStations.Remove(Station);
+	}
+}
+
+bool UFlareSimulatedSector::IsPriceStation(UFlareSimulatedSpacecraft* Station, FFlareResourceDescription* Resource) const
+{
+	for (int32 FactoryIndex = 0; FactoryIndex < Station->GetFactories().Num(); FactoryIndex++)
+	{
+		UFlareFactory* Factory = Station->GetFactories()[FactoryIndex];
+
+		if (!Factory->IsActive())
+		{
+			continue;
+		}
+
+		// Shipyard cycles depend on the ordered ship, keep them for every resource
+		if (Factory->IsShipyard() || Factory->HasInputResource(Resource) || Factory->HasOutputResource(Resource))
+		{
+			return true;
+		}
+	}
+
+	if (Station->HasCapability(EFlareSpacecraftCapability::Consumer) && Resource->IsConsumerResource)
+	{
+		return true;
+	}
+
+	if (Station->HasCapability(EFlareSpacecraftCapability::Maintenance) && Resource->IsMaintenanceResource)
+	{
+		return true;
+	}
+
+	return false;
+}
+
 void UFlareSimulatedSector::ClearBombs()
 {
 	for (int i = 0 ; i < SectorData.BombData.Num(); i++)
@@ -1061,38 +1250,77 @@ uint32 UFlareSimulatedSector::GetResourceCount(UFlareCompany* Company, FFlareRes
 
 void UFlareSimulatedSector::LoadResourcePrices()
 {
-	ResourcePrices.Empty();
-	LastResourcePrices.Empty();
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	PriceResourceCount = ResourceCatalog->Resources.Num();
+
+	// Default prices
+	ResourcePrices.SetNumUninitialized(PriceResourceCount);
+	for (int32 ResourceIndex = 0; ResourceIndex < PriceResourceCount; ResourceIndex++)
+	{
+		ResourcePrices[ResourceIndex] = GetDefaultResourcePrice(&ResourceCatalog->Resources[ResourceIndex]->Data);
+	}
+
+	// Saved prices
+	TArray<FFlareFloatBuffer*> SavedHistories;
+	SavedHistories.SetNumZeroed(PriceResourceCount);
+	PriceHistoryCount = 0;
+
 	for (int PriceIndex = 0; PriceIndex < SectorData.ResourcePrices.Num(); PriceIndex++)
 	{
 		FFFlareResourcePrice* ResourcePrice = &SectorData.ResourcePrices[PriceIndex];
-		FFlareResourceDescription* Resource = Game->GetResourceCatalog()->Get(ResourcePrice->ResourceIdentifier);
-		float Price = ResourcePrice->Price;
-		ResourcePrices.Add(Resource, Price);
+		int32 ResourceIndex = ResourceCatalog->GetResourceIndex(ResourceCatalog->Get(ResourcePrice->ResourceIdentifier));
+		if (ResourceIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		ResourcePrices[ResourceIndex] = ResourcePrice->Price;
+
 		FFlareFloatBuffer* Prices = &ResourcePrice->Prices;
-		Prices->Resize(50);
-		LastResourcePrices.Add(Resource, *Prices);
+		Prices->Resize(PRICE_HISTORY_LENGTH);
+		if (Prices->Values.Num() > 0)
+		{
+			SavedHistories[ResourceIndex] = Prices;
+			PriceHistoryCount = FMath::Max(PriceHistoryCount, FMath::Min(Prices->Values.Num(), PRICE_HISTORY_LENGTH));
+		}
+	}
+
+	// Rebuild the history rows, oldest first
+	PriceHistory.SetNumZeroed(PRICE_HISTORY_LENGTH * PriceResourceCount);
+	for (int32 Row = 0; Row < PriceHistoryCount; Row++)
+	{
+		int32 Age = PriceHistoryCount - 1 - Row;
+		for (int32 ResourceIndex = 0; ResourceIndex < PriceResourceCount; ResourceIndex++)
+		{
+			FFlareFloatBuffer* Prices = SavedHistories[ResourceIndex];
+			PriceHistory[Row * PriceResourceCount + ResourceIndex] = (Prices ? Prices->GetValue(Age) : ResourcePrices[ResourceIndex]);
+		}
 	}
+	PriceHistoryWriteIndex = PriceHistoryCount % PRICE_HISTORY_LENGTH;
+	PriceVersion++;
+
+	// Rebuild the price book on first use
+	SpacecraftResourceCosts.Empty();
+	SpacecraftResourceCostDirty.Empty();
 }
 
 void UFlareSimulatedSector::SaveResourcePrices()
 {
 	SectorData.ResourcePrices.Empty();
 
-	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+	for(int32 ResourceIndex = 0; ResourceIndex < PriceResourceCount; ResourceIndex++)
 	{
 		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-		if (ResourcePrices.Contains(Resource))
+
+		FFFlareResourcePrice Price;
+		Price.ResourceIdentifier = Resource->Identifier;
+		Price.Price = ResourcePrices[ResourceIndex];
+		Price.Prices.Init(PRICE_HISTORY_LENGTH);
+		for (int32 Age = PriceHistoryCount - 1; Age >= 0; Age--)
 		{
-			FFFlareResourcePrice Price;
-			Price.ResourceIdentifier = Resource->Identifier;
-			Price.Price = ResourcePrices[Resource];
-			if (LastResourcePrices.Contains(Resource))
-			{
-				Price.Prices = LastResourcePrices[Resource];
-				SectorData.ResourcePrices.Add(Price);
-			}
+			Price.Prices.Append(GetPriceHistoryValue(ResourceIndex, Age));
 		}
+		SectorData.ResourcePrices.Add(Price);
 	}
 }
 
@@ -1354,51 +1582,138 @@ FLinearColor UFlareSimulatedSector::GetSectorFriendlynessColor(UFlareCompany* Co
 
 float UFlareSimulatedSector::GetPreciseResourcePrice(FFlareResourceDescription* Resource, int32 Age)
 {
-	if(Age == 0)
+	int32 ResourceIndex = Game->GetResourceCatalog()->GetResourceIndex(Resource);
+	if (ResourceIndex == INDEX_NONE || ResourceIndex >= PriceResourceCount)
 	{
+		return GetDefaultResourcePrice(Resource);
+	}
 
-		if (!ResourcePrices.Contains(Resource))
-		{
-			ResourcePrices.Add(Resource, GetDefaultResourcePrice(Resource));
-		}
+	if (Age == 0 || PriceHistoryCount == 0)
+	{
+		return ResourcePrices[ResourceIndex];
+	}
 
-		return ResourcePrices[Resource];
+	return GetPriceHistoryValue(ResourceIndex, FMath::Min(Age, PriceHistoryCount - 1));
+}
+
+float UFlareSimulatedSector::GetPriceHistoryValue(int32 ResourceIndex, int32 HistoryAge) const
+{
+	int32 Row = PriceHistoryWriteIndex - 1 - HistoryAge;
+	if (Row < 0)
+	{
+		Row += PRICE_HISTORY_LENGTH;
 	}
-	else
+
+	return PriceHistory[Row * PriceResourceCount + ResourceIndex];
+}
+
+void UFlareSimulatedSector::SwapPrices()
+{
+	if (PriceResourceCount == 0)
 	{
-		if (!LastResourcePrices.Contains(Resource))
+		return;
+	}
+
+	FMemory::Memcpy(&PriceHistory[PriceHistoryWriteIndex * PriceResourceCount], ResourcePrices.GetData(), PriceResourceCount * sizeof(float));
+
+	PriceHistoryWriteIndex = (PriceHistoryWriteIndex + 1) % PRICE_HISTORY_LENGTH;
+	PriceHistoryCount = FMath::Min(PriceHistoryCount + 1, PRICE_HISTORY_LENGTH);
+}
+
+void UFlareSimulatedSector::SetPreciseResourcePrice(FFlareResourceDescription* Resource, float NewPrice)
+{
+	int32 ResourceIndex = Game->GetResourceCatalog()->GetResourceIndex(Resource);
+	if (ResourceIndex != INDEX_NONE && ResourceIndex < PriceResourceCount)
+	{
+		float ClampedPrice = FMath::Clamp(NewPrice, (float) Resource->MinPrice, (float) Resource->MaxPrice);
+		if (ClampedPrice != ResourcePrices[ResourceIndex])
 		{
-			FFlareFloatBuffer Prices;
-			Prices.Init(50);
-			Prices.Append(GetPreciseResourcePrice(Resource, 0));
-			LastResourcePrices.Add(Resource, Prices);
+			InvalidateConstructionPlans(ResourceIndex);
 		}
 
-		return LastResourcePrices[Resource].GetValue(Age);
-	}
+		ResourcePrices[ResourceIndex] = ClampedPrice;
+		PriceVersion++;
 
+		// Only the spacecrafts built from or producing this resource change price
+		if (SpacecraftResourceCosts.Num() > 0)
+		{
+			const TArray<int32>& Dependencies = Game->GetGameWorld()->GetSpacecraftPriceDependencies(ResourceIndex);
+			for (int32 DependencyIndex = 0; DependencyIndex < Dependencies.Num(); DependencyIndex++)
+			{
+				SpacecraftResourceCostDirty[Dependencies[DependencyIndex]] = true;
+			}
+		}
+	}
 }
 
-void UFlareSimulatedSector::SwapPrices()
+int64 UFlareSimulatedSector::GetSpacecraftPrice(FFlareSpacecraftDescription* Description, bool WithMargin, bool ConstructionPrice)
 {
-	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+	UFlareSpacecraftCatalog* SpacecraftCatalog = Game->GetSpacecraftCatalog();
+	if (SpacecraftResourceCosts.Num() != SpacecraftCatalog->GetSpacecraftCount())
 	{
-		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+		RebuildSpacecraftPrices();
+	}
 
-		if (!LastResourcePrices.Contains(Resource))
+	// Base cost
+	int64 Cost = Description->CycleCost.ProductionCost;
+
+	// For stations, use the sectore penalty
+	if (Description->IsStation() && ConstructionPrice)
+	{
+		Cost = GetStationConstructionFee(Cost);
+	}
+
+	// Add input resource cost, substract output resource
+	int32 SpacecraftIndex = SpacecraftCatalog->GetSpacecraftIndex(Description);
+	if (SpacecraftIndex == INDEX_NONE)
+	{
+		Cost += ComputeSpacecraftResourceCost(Description);
+	}
+	else
+	{
+		if (SpacecraftResourceCostDirty[SpacecraftIndex])
 		{
-			FFlareFloatBuffer Prices;
-			Prices.Init(50);
-			LastResourcePrices.Add(Resource, Prices);
+			SpacecraftResourceCosts[SpacecraftIndex] = ComputeSpacecraftResourceCost(Description);
+			SpacecraftResourceCostDirty[SpacecraftIndex] = false;
 		}
+		Cost += SpacecraftResourceCosts[SpacecraftIndex];
+	}
 
-		LastResourcePrices[Resource].Append(GetPreciseResourcePrice(Resource, 0));
+	return FMath::Max((int64) 0, Cost) * (WithMargin ? 1.2f : 1.0f);
+}
+
+void UFlareSimulatedSector::RebuildSpacecraftPrices()
+{
+	UFlareSpacecraftCatalog* SpacecraftCatalog = Game->GetSpacecraftCatalog();
+	int32 SpacecraftCount = SpacecraftCatalog->GetSpacecraftCount();
+
+	SpacecraftResourceCosts.SetNumUninitialized(SpacecraftCount);
+	SpacecraftResourceCostDirty.SetNumZeroed(SpacecraftCount);
+
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < SpacecraftCount; SpacecraftIndex++)
+	{
+		SpacecraftResourceCosts[SpacecraftIndex] = ComputeSpacecraftResourceCost(SpacecraftCatalog->GetSpacecraft(SpacecraftIndex));
+		SpacecraftResourceCostDirty[SpacecraftIndex] = false;
 	}
 }
 
-void UFlareSimulatedSector::SetPreciseResourcePrice(FFlareResourceDescription* Resource, float NewPrice)
+int64 UFlareSimulatedSector::ComputeSpacecraftResourceCost(FFlareSpacecraftDescription* Description)
 {
-	ResourcePrices[Resource] = FMath::Clamp(NewPrice, (float) Resource->MinPrice, (float) Resource->MaxPrice);
+	int64 Cost = 0;
+
+	for (int ResourceIndex = 0; ResourceIndex < Description->CycleCost.InputResources.Num() ; ResourceIndex++)
+	{
+		FFlareFactoryResource* Resource = &Description->CycleCost.InputResources[ResourceIndex];
+		Cost += Resource->Quantity * GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::Default);
+	}
+
+	for (int ResourceIndex = 0; ResourceIndex < Description->CycleCost.OutputResources.Num() ; ResourceIndex++)
+	{
+		FFlareFactoryResource* Resource = &Description->CycleCost.OutputResources[ResourceIndex];
+		Cost -= Resource->Quantity * GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::Default);
+	}
+
+	return Cost;
 }
 
 int64 UFlareSimulatedSector::GetResourcePrice(FFlareResourceDescription* Resource, EFlareResourcePriceContext::Type PriceContext, int32 Age)
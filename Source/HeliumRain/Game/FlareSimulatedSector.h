@@ -264,6 +264,25 @@ struct FFlareStationSpawnParameters
 	}
 };
 
+/** Stations of a sector indexed by their role for a resource */
+struct FFlareResourceStations
+{
+	/** Stations producing the resource */
+	TArray<UFlareSimulatedSpacecraft*>      Producers;
+
+	/** Stations using the resource as factory input or people consumption */
+	TArray<UFlareSimulatedSpacecraft*>      Consumers;
+
+	/** Stations using the resource for maintenance */
+	TArray<UFlareSimulatedSpacecraft*>      Maintenance;
+
+	/** Stations with storage capability */
+	TArray<UFlareSimulatedSpacecraft*>      Storage;
+
+	/** Stations that may weigh on the resource price */
+	TArray<UFlareSimulatedSpacecraft*>      PriceStations;
+};
+
 
 UCLASS()
 class HELIUMRAIN_API UFlareSimulatedSector : public UObject
@@ -320,6 +339,9 @@ public:
 	/** Check whether we can build a station, understand why if not */
 	bool CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>& OutReason, bool IgnoreCost = false);
 
+	/** Check whether we can build a station, without formatting reasons */
+	bool CanBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, bool IgnoreCost = false);
+
 	UFlareSimulatedSpacecraft* BuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company);
 
 	bool CanUpgrade(UFlareCompany* Company);
@@ -339,8 +361,29 @@ public:
 
 	void ClearBombs();
 
+	/** Update the resource roles of a station after a factory or upgrade change */
+	void RefreshStationIndex(UFlareSimulatedSpacecraft* Station);
+
 protected:
 
+	/** Build feasibility, reasons are only formatted if OutReasons is set */
+	bool CheckBuildStation(FFlareSpacecraftDescription* StationDescription, UFlareCompany* Company, TArray<FText>* OutReasons, bool IgnoreCost);
+
+	/** Add a station to the resource role lists */
+	void IndexStation(UFlareSimulatedSpacecraft* Station);
+
+	/** Remove a station from the resource role lists */
+	void UnindexStation(UFlareSimulatedSpacecraft* Station);
+
+	/** Tell the company AIs that a resource price moved, or that the stations changed if ResourceIndex is INDEX_NONE */
+	void InvalidateConstructionPlans(int32 ResourceIndex);
+
+	/** Read a price row, 0 being the last swapped one */
+	float GetPriceHistoryValue(int32 ResourceIndex, int32 HistoryAge) const;
+
+	/** Check whether a station may weigh on the price of a resource */
+	bool IsPriceStation(UFlareSimulatedSpacecraft* Station, FFlareResourceDescription* Resource) const;
+
     /*----------------------------------------------------
         Protected data
     ----------------------------------------------------*/
@@ -359,13 +402,29 @@ protected:
 	int32                                   PersistentStationIndex;
 	float									LightRatio;
 
+	/** Index in the world sector list, stable for the whole game */
+	int32                                   WorldIndex;
+
 	AFlareGame*                             Game;
 
 	UPROPERTY()
 	FFlareSectorOrbitParameters             SectorOrbitParameters;
 	const FFlareSectorDescription*          SectorDescription;
-	TMap<FFlareResourceDescription*, float> ResourcePrices;
-	TMap<FFlareResourceDescription*, FFlareFloatBuffer> LastResourcePrices;
+
+	/** Current prices, by resource catalog index */
+	TArray<float>                           ResourcePrices;
+
+	/** Daily rows of resource prices, as a circular buffer */
+	TArray<float>                           PriceHistory;
+	int32                                   PriceHistoryWriteIndex;
+	int32                                   PriceHistoryCount;
+	int32                                   PriceResourceCount;
+	uint32                                  PriceVersion;
+
+	/** Resource part of the spacecraft prices, by spacecraft catalog index */
+	TArray<int64>                           SpacecraftResourceCosts;
+	TArray<uint8>                           SpacecraftResourceCostDirty;
+	TMap<FFlareResourceDescription*, FFlareResourceStations> ResourceStations;
 
 public:
 
@@ -398,6 +457,16 @@ public:
         return SectorData.Identifier;
     }
 
+	inline int32 GetWorldIndex() const
+	{
+		return WorldIndex;
+	}
+
+	inline void SetWorldIndex(int32 Index)
+	{
+		WorldIndex = Index;
+	}
+
 	/** Get the description of this sector */
 	FText GetSectorDescription() const;
 
@@ -416,6 +485,9 @@ public:
 		return SectorSpacecrafts;
 	}
 
+	/** Get the stations indexed by role for this resource */
+	const FFlareResourceStations& GetResourceStations(FFlareResourceDescription* Resource) const;
+
 	inline TArray<UFlareFleet*>& GetSectorFleets()
 	{
 		return SectorFleets;
@@ -454,6 +526,27 @@ public:
 
 	void SetPreciseResourcePrice(FFlareResourceDescription* Resource, float NewPrice);
 
+	/** Get the price of a spacecraft class from the sector price book */
+	int64 GetSpacecraftPrice(FFlareSpacecraftDescription* Description, bool WithMargin, bool ConstructionPrice = false);
+
+	/** Recompute the price book from the current resource prices */
+	void RebuildSpacecraftPrices();
+
+	/** Compute the input resource cost minus the output resource value of a spacecraft class, without the price book */
+	int64 ComputeSpacecraftResourceCost(FFlareSpacecraftDescription* Description);
+
+	/** Number of days of price history, the oldest age is one less */
+	inline int32 GetPriceHistoryLength() const
+	{
+		return PriceHistoryCount;
+	}
+
+	/** Counter incremented on every price change, to detect stale cached values */
+	inline uint32 GetPriceVersion() const
+	{
+		return PriceVersion;
+	}
+
 
 	static float GetDefaultResourcePrice(FFlareResourceDescription* Resource);
 
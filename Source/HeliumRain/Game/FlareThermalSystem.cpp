@@ -0,0 +1,323 @@
+
+#include "../Flare.h"
+#include "FlareThermalSystem.h"
+#include "FlareGame.h"
+#include "FlareSector.h"
+#include "../Spacecrafts/FlareSpacecraft.h"
+#include "../Spacecrafts/FlareEngine.h"
+#include "../Spacecrafts/FlareWeapon.h"
+
+DECLARE_CYCLE_STAT(TEXT("FlareThermalSystem Tick"), STAT_FlareThermalSystem_Tick, STATGROUP_Flare);
+
+
+/*----------------------------------------------------
+	Constructor
+----------------------------------------------------*/
+
+UFlareThermalSystem::UFlareThermalSystem(const class FObjectInitializer& PCIP)
+	: Super(PCIP)
+	, StepAccumulator(0)
+	, SunHeat(0)
+	, IsPaused(false)
+{
+}
+
+
+/*----------------------------------------------------
+	Public interface
+----------------------------------------------------*/
+
+void UFlareThermalSystem::Reset()
+{
+	Spacecrafts.Empty();
+	SpacecraftIndexes.Empty();
+	SpacecraftData.Empty();
+	HeatCapacities.Empty();
+	HeatSinkSurfaces.Empty();
+	PassiveHeatProductions.Empty();
+	HeatProductions.Empty();
+	HeatSinkDirty.Empty();
+	ActiveComponentStarts.Empty();
+	ActiveComponents.Empty();
+	StepAccumulator = 0;
+}
+
+void UFlareThermalSystem::SetWorldPause(bool Pause)
+{
+	IsPaused = Pause;
+}
+
+void UFlareThermalSystem::Tick(AFlareGame* Game, float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareThermalSystem_Tick);
+
+	UFlareSector* Sector = Game->GetActiveSector();
+	if (IsPaused || !Sector)
+	{
+		return;
+	}
+
+	// Follow spawned and destroyed spacecrafts
+	if (Spacecrafts != Sector->GetSpacecrafts())
+	{
+		Rebuild(Sector->GetSpacecrafts());
+	}
+
+	int32 StepCount = ConsumeSteps(StepAccumulator, DeltaSeconds);
+	for (int32 StepIndex = 0; StepIndex < StepCount; StepIndex++)
+	{
+		// One sun sample for the whole sector
+		SunHeat = ComputeSunHeat(Game->GetPlanetarium()->GetSunOcclusion());
+		Step(SunHeat);
+	}
+}
+
+void UFlareThermalSystem::InvalidateHeatSink(AFlareSpacecraft* Spacecraft)
+{
+	const int32* Index = SpacecraftIndexes.Find(Spacecraft);
+	if (Index)
+	{
+		HeatSinkDirty[*Index] = true;
+	}
+}
+
+
+/*----------------------------------------------------
+	Prediction
+----------------------------------------------------*/
+
+float UFlareThermalSystem::GetEquilibriumTemperature(AFlareSpacecraft* Spacecraft) const
+{
+	const int32* Index = SpacecraftIndexes.Find(Spacecraft);
+	if (!Index)
+	{
+		return 0;
+	}
+
+	return ComputeEquilibriumTemperature(HeatProductions[*Index], HeatSinkSurfaces[*Index]);
+}
+
+void UFlareThermalSystem::GetHeatCurve(AFlareSpacecraft* Spacecraft, float Duration, int32 SampleCount, TArray<float>& Temperatures) const
+{
+	Temperatures.Empty(SampleCount);
+
+	const int32* Index = SpacecraftIndexes.Find(Spacecraft);
+	if (!Index || SampleCount <= 0 || HeatCapacities[*Index] <= 0)
+	{
+		return;
+	}
+
+	// Use the same steps as the simulation
+	float Heat = SpacecraftData[*Index]->Heat;
+	int32 TotalStepCount = FMath::CeilToInt(Duration / THERMAL_STEP_DURATION);
+	int32 StepIndex = 0;
+	for (int32 SampleIndex = 1; SampleIndex <= SampleCount; SampleIndex++)
+	{
+		int32 SampleStep = (TotalStepCount * SampleIndex) / SampleCount;
+		for (; StepIndex < SampleStep; StepIndex++)
+		{
+			Heat = AdvanceHeat(Heat, HeatCapacities[*Index], HeatProductions[*Index], HeatSinkSurfaces[*Index], THERMAL_STEP_DURATION);
+		}
+		Temperatures.Add(Heat / HeatCapacities[*Index]);
+	}
+}
+
+float UFlareThermalSystem::GetTimeToTemperature(AFlareSpacecraft* Spacecraft, float Temperature, float MaxDuration) const
+{
+	const int32* Index = SpacecraftIndexes.Find(Spacecraft);
+	if (!Index || HeatCapacities[*Index] <= 0)
+	{
+		return -1;
+	}
+
+	float Heat = SpacecraftData[*Index]->Heat;
+	float TargetHeat = Temperature * HeatCapacities[*Index];
+	if (Heat >= TargetHeat)
+	{
+		return 0;
+	}
+
+	// Never reached
+	if (ComputeEquilibriumTemperature(HeatProductions[*Index], HeatSinkSurfaces[*Index]) < Temperature)
+	{
+		return -1;
+	}
+
+	int32 MaxStepCount = FMath::CeilToInt(MaxDuration / THERMAL_STEP_DURATION);
+	for (int32 StepIndex = 1; StepIndex <= MaxStepCount; StepIndex++)
+	{
+		Heat = AdvanceHeat(Heat, HeatCapacities[*Index], HeatProductions[*Index], HeatSinkSurfaces[*Index], THERMAL_STEP_DURATION);
+		if (Heat >= TargetHeat)
+		{
+			return StepIndex * THERMAL_STEP_DURATION;
+		}
+	}
+
+	return -1;
+}
+
+float UFlareThermalSystem::GetTimeToOverheat(AFlareSpacecraft* Spacecraft, float MaxDuration) const
+{
+	return GetTimeToTemperature(Spacecraft, Spacecraft->GetParent()->GetDamageSystem()->GetOverheatTemperature(), MaxDuration);
+}
+
+
+/*----------------------------------------------------
+	Thermal model
+----------------------------------------------------*/
+
+float UFlareThermalSystem::AdvanceHeat(float Heat, float HeatCapacity, float HeatProduction, float HeatSinkSurface, float StepDuration)
+{
+	// Heat up
+	Heat += HeatProduction * StepDuration;
+
+	// Radiate in KJ
+	float Temperature = Heat / HeatCapacity;
+	float HeatRadiation = 0.f;
+	if (Temperature > 0)
+	{
+		float SquaredTemperature = Temperature * Temperature;
+		HeatRadiation = HeatSinkSurface * THERMAL_STEFAN_BOLTZMANN * SquaredTemperature * SquaredTemperature / 1000;
+	}
+
+	// Don't radiate too much energy : negative temperature is not possible
+	return Heat - FMath::Min(HeatRadiation * StepDuration, Heat);
+}
+
+float UFlareThermalSystem::ComputeEquilibriumTemperature(float HeatProduction, float HeatSinkSurface)
+{
+	if (HeatSinkSurface <= 0)
+	{
+		return 0;
+	}
+
+	return FMath::Pow(1000 * HeatProduction / (HeatSinkSurface * THERMAL_STEFAN_BOLTZMANN), 0.25f);
+}
+
+float UFlareThermalSystem::ComputeSunHeat(float SunOcclusion)
+{
+	// Keep only 10 % of the sun flow, and modulate 90% by sun occlusion
+	return THERMAL_SOLAR_POWER * 0.1f * (1 - 0.9f * SunOcclusion);
+}
+
+int32 UFlareThermalSystem::ConsumeSteps(double& Accumulator, float DeltaSeconds)
+{
+	Accumulator += DeltaSeconds;
+
+	int32 StepCount = FMath::FloorToInt(Accumulator / THERMAL_STEP_DURATION);
+	Accumulator -= StepCount * (double) THERMAL_STEP_DURATION;
+
+	// After a long frame, leave the steps we can't simulate now to the next frames
+	if (StepCount > THERMAL_MAX_STEPS_PER_FRAME)
+	{
+		Accumulator += (StepCount - THERMAL_MAX_STEPS_PER_FRAME) * (double) THERMAL_STEP_DURATION;
+		StepCount = THERMAL_MAX_STEPS_PER_FRAME;
+	}
+
+	return StepCount;
+}
+
+
+/*----------------------------------------------------
+	Internals
+----------------------------------------------------*/
+
+void UFlareThermalSystem::Rebuild(const TArray<AFlareSpacecraft*>& SectorSpacecrafts)
+{
+	// Keep the step phase so that spawns don't change the step times
+	double Accumulator = StepAccumulator;
+	Reset();
+	StepAccumulator = Accumulator;
+
+	int32 Count = SectorSpacecrafts.Num();
+	Spacecrafts = SectorSpacecrafts;
+	SpacecraftData.Reserve(Count);
+	HeatCapacities.Reserve(Count);
+	HeatSinkSurfaces.SetNumZeroed(Count);
+	PassiveHeatProductions.SetNumZeroed(Count);
+	HeatProductions.SetNumZeroed(Count);
+	HeatSinkDirty.Init(1, Count);
+	ActiveComponentStarts.Reserve(Count + 1);
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		AFlareSpacecraft* Spacecraft = Spacecrafts[Index];
+		SpacecraftIndexes.Add(Spacecraft, Index);
+		SpacecraftData.Add(&Spacecraft->GetParent()->GetData());
+		HeatCapacities.Add(Spacecraft->GetDescription()->HeatCapacity);
+
+		// Engines and weapons heat up when used
+		ActiveComponentStarts.Add(ActiveComponents.Num());
+		TArray<UActorComponent*> Components = Spacecraft->GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
+		for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+		{
+			UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
+			if (Component->IsA(UFlareEngine::StaticClass()) || Component->IsA(UFlareWeapon::StaticClass()))
+			{
+				ActiveComponents.Add(Component);
+			}
+		}
+	}
+	ActiveComponentStarts.Add(ActiveComponents.Num());
+}
+
+void UFlareThermalSystem::UpdateHeatSink(int32 Index)
+{
+	float HeatSinkSurface = 0.f;
+	float PassiveHeatProduction = 0.f;
+
+	TArray<UActorComponent*> Components = Spacecrafts[Index]->GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	{
+		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
+		HeatSinkSurface += Component->GetHeatSinkSurface();
+		if (!Component->IsA(UFlareEngine::StaticClass()) && !Component->IsA(UFlareWeapon::StaticClass()))
+		{
+			PassiveHeatProduction += Component->GetHeatProduction();
+		}
+	}
+
+	HeatSinkSurfaces[Index] = HeatSinkSurface;
+	PassiveHeatProductions[Index] = PassiveHeatProduction;
+	HeatSinkDirty[Index] = false;
+}
+
+void UFlareThermalSystem::Step(float StepSunHeat)
+{
+	for (int32 Index = 0; Index < Spacecrafts.Num(); Index++)
+	{
+		if (HeatSinkDirty[Index])
+		{
+			UpdateHeatSink(Index);
+		}
+
+		float HeatProduction = PassiveHeatProductions[Index] + HeatSinkSurfaces[Index] * StepSunHeat;
+		for (int32 ComponentIndex = ActiveComponentStarts[Index]; ComponentIndex < ActiveComponentStarts[Index + 1]; ComponentIndex++)
+		{
+			HeatProduction += ActiveComponents[ComponentIndex]->GetHeatProduction();
+		}
+		HeatProductions[Index] = HeatProduction;
+	}
+
+	for (int32 Index = 0; Index < Spacecrafts.Num(); Index++)
+	{
+		SpacecraftData[Index]->Heat = AdvanceHeat(SpacecraftData[Index]->Heat, HeatCapacities[Index], HeatProductions[Index], HeatSinkSurfaces[Index], THERMAL_STEP_DURATION);
+	}
+}
+
+
+/*----------------------------------------------------
+	Getters
+----------------------------------------------------*/
+
+float UFlareThermalSystem::GetHeatProduction(AFlareSpacecraft* Spacecraft) const
+{
+	const int32* Index = SpacecraftIndexes.Find(Spacecraft);
+	return Index ? HeatProductions[*Index] : 0.f;
+}
+
+float UFlareThermalSystem::GetHeatSinkSurface(AFlareSpacecraft* Spacecraft) const
+{
+	const int32* Index = SpacecraftIndexes.Find(Spacecraft);
+	return Index ? HeatSinkSurfaces[*Index] : 0.f;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Object.h"
+#include "FlareThermalSystem.generated.h"
+
+
+class AFlareGame;
+class AFlareSpacecraft;
+class UFlareSpacecraftComponent;
+struct FFlareSpacecraftSave;
+
+/** Duration of a thermal simulation step, in seconds */
+#define THERMAL_STEP_DURATION 0.05f
+
+/** Maximum number of steps simulated in a frame, the others wait for the next frames */
+#define THERMAL_MAX_STEPS_PER_FRAME 20
+
+/** Stefan-Boltzmann constant */
+#define THERMAL_STEFAN_BOLTZMANN 5.670373e-8f
+
+/** Sun flow in KW/m^2 */
+#define THERMAL_SOLAR_POWER 3.094f
+
+
+UCLASS()
+class HELIUMRAIN_API UFlareThermalSystem : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	/*----------------------------------------------------
+		Public interface
+	----------------------------------------------------*/
+
+	/** Forget the active sector spacecrafts */
+	void Reset();
+
+	/** Toggle the game pause */
+	void SetWorldPause(bool Pause);
+
+	/** Simulate the fixed steps covered by this frame */
+	void Tick(AFlareGame* Game, float DeltaSeconds);
+
+	/** Recompute the heat sink surface and passive heat production of a spacecraft at the next step */
+	void InvalidateHeatSink(AFlareSpacecraft* Spacecraft);
+
+
+	/*----------------------------------------------------
+		Prediction
+	----------------------------------------------------*/
+
+	/** Get the temperature the spacecraft will converge to with its current heat production */
+	float GetEquilibriumTemperature(AFlareSpacecraft* Spacecraft) const;
+
+	/** Get the temperatures of the spacecraft over the next seconds with its current heat production */
+	void GetHeatCurve(AFlareSpacecraft* Spacecraft, float Duration, int32 SampleCount, TArray<float>& Temperatures) const;
+
+	/** Get the time before the spacecraft reaches a temperature with its current heat production, or -1 if it never will in MaxDuration */
+	float GetTimeToTemperature(AFlareSpacecraft* Spacecraft, float Temperature, float MaxDuration) const;
+
+	/** Get the time before the spacecraft overheats, or -1 */
+	float GetTimeToOverheat(AFlareSpacecraft* Spacecraft, float MaxDuration) const;
+
+
+	/*----------------------------------------------------
+		Thermal model
+	----------------------------------------------------*/
+
+	/** Simulate one step : add the produced heat, then radiate */
+	static float AdvanceHeat(float Heat, float HeatCapacity, float HeatProduction, float HeatSinkSurface, float StepDuration);
+
+	/** Get the temperature where radiation equals production */
+	static float ComputeEquilibriumTemperature(float HeatProduction, float HeatSinkSurface);
+
+	/** Sun heat received per heat sink square meter */
+	static float ComputeSunHeat(float SunOcclusion);
+
+	/** Add a frame to the step accumulator and return the number of steps to simulate, late steps are kept for the next frames */
+	static int32 ConsumeSteps(double& Accumulator, float DeltaSeconds);
+
+
+protected:
+
+	/*----------------------------------------------------
+		Internals
+	----------------------------------------------------*/
+
+	/** Build the arrays from the active sector spacecrafts */
+	void Rebuild(const TArray<AFlareSpacecraft*>& Spacecrafts);
+
+	/** Update the cached heat sink surface and passive heat production */
+	void UpdateHeatSink(int32 Index);
+
+	/** Simulate one step for all spacecrafts */
+	void Step(float SunHeat);
+
+
+	/*----------------------------------------------------
+		Protected data
+	----------------------------------------------------*/
+
+	// Spacecrafts
+	UPROPERTY()
+	TArray<AFlareSpacecraft*>                  Spacecrafts;
+	TMap<AFlareSpacecraft*, int32>             SpacecraftIndexes;
+	TArray<FFlareSpacecraftSave*>              SpacecraftData;
+
+	// Thermal state, by spacecraft index
+	TArray<float>                              HeatCapacities;
+	TArray<float>                              HeatSinkSurfaces;
+	TArray<float>                              PassiveHeatProductions;
+	TArray<float>                              HeatProductions;
+	TArray<uint8>                              HeatSinkDirty;
+
+	// Engines and weapons, whose heat production changes every step
+	TArray<int32>                              ActiveComponentStarts;
+	TArray<UFlareSpacecraftComponent*>         ActiveComponents;
+
+	// Steps
+	double                                     StepAccumulator;
+	float                                      SunHeat;
+	bool                                       IsPaused;
+
+public:
+
+	/*----------------------------------------------------
+		Getters
+	----------------------------------------------------*/
+
+	/** Get the heat production of the last step, including the sun */
+	float GetHeatProduction(AFlareSpacecraft* Spacecraft) const;
+
+	/** Get the cached heat sink surface */
+	float GetHeatSinkSurface(AFlareSpacecraft* Spacecraft) const;
+
+};
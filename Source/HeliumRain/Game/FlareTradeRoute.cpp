@@ -24,6 +24,15 @@ void UFlareTradeRoute::Load(const FFlareTradeRouteSave& Data)
 	TradeRouteData = Data;
 	IsFleetListLoaded = false;
 
+	if (TradeRouteData.DailyTradedQuantity.Num() != TradeRouteData.DailyRevenue.Num())
+	{
+		TradeRouteData.DailyTradedQuantity.Empty();
+		TradeRouteData.DailyRevenue.Empty();
+	}
+	TotalTradedQuantity = 0;
+	TotalRevenue = 0;
+
+	UpdateSectorIndexes();
 	UpdateTargetSector();
 
     InitFleetList();
@@ -106,6 +115,137 @@ void UFlareTradeRoute::Simulate()
 	}
 }
 
+bool UFlareTradeRoute::PlanDay(FFlareTradeRoutePlan& Plan)
+{
+	Plan.Route = this;
+	Plan.Sector = NULL;
+	Plan.SectorOrder = NULL;
+	Plan.Operation = NULL;
+	Plan.Resource = NULL;
+	Plan.IsLoad = false;
+
+	if (TradeRouteData.IsPaused || TradeRouteData.Sectors.Num() == 0 || TradeRouteFleet == NULL || TradeRouteFleet->IsTraveling())
+	{
+		return false;
+	}
+
+	UFlareSimulatedSector* TargetSector = UpdateTargetSector();
+	UFlareSimulatedSector* CurrentSector = TradeRouteFleet->GetCurrentSector();
+
+	if (TargetSector && TargetSector == CurrentSector)
+	{
+		Plan.Sector = CurrentSector;
+		Plan.SectorOrder = GetSectorOrders(CurrentSector);
+		SelectOperation(Plan);
+	}
+
+	return true;
+}
+
+void UFlareTradeRoute::SelectOperation(FFlareTradeRoutePlan& Plan)
+{
+	Plan.Operation = NULL;
+
+	while (TradeRouteData.CurrentOperationIndex < Plan.SectorOrder->Operations.Num())
+	{
+		FFlareTradeRouteSectorOperationSave* Operation = &Plan.SectorOrder->Operations[TradeRouteData.CurrentOperationIndex];
+		FFlareResourceDescription* Resource = Game->GetResourceCatalog()->Get(Operation->ResourceIdentifier);
+		bool IsLoad = IsLoadOperation(Operation->Type);
+
+		if (Operation->MaxWait == 0)
+		{
+			// Minimum wait is 1
+			Operation->MaxWait = 1;
+		}
+
+		// Same exit conditions as ProcessCurrentOperation, before any trade
+		bool WaitLimitReached = (Operation->MaxWait != -1 && TradeRouteData.CurrentOperationDuration >= Operation->MaxWait);
+		if (!WaitLimitReached && Resource && GetFleetTradableQuantity(Resource, IsLoad) > 0)
+		{
+			Plan.Operation = Operation;
+			Plan.Resource = Resource;
+			Plan.IsLoad = IsLoad;
+			return;
+		}
+
+		TradeRouteData.CurrentOperationDuration = 0;
+		TradeRouteData.CurrentOperationProgress = 0;
+		TradeRouteData.CurrentOperationIndex++;
+	}
+}
+
+void UFlareTradeRoute::FinishOperation(FFlareTradeRoutePlan& Plan)
+{
+	if (IsOperationQuantityLimitReach(Plan.Operation))
+	{
+		TradeRouteData.CurrentOperationDuration = 0;
+		TradeRouteData.CurrentOperationProgress = 0;
+		TradeRouteData.CurrentOperationIndex++;
+		SelectOperation(Plan);
+	}
+	else
+	{
+		TradeRouteData.CurrentOperationDuration++;
+		Plan.Operation = NULL;
+	}
+}
+
+void UFlareTradeRoute::EndDay(FFlareTradeRoutePlan& Plan)
+{
+	UFlareSimulatedSector* TargetSector = GetTargetSector();
+
+	if (Plan.SectorOrder && TradeRouteData.CurrentOperationIndex >= Plan.SectorOrder->Operations.Num())
+	{
+		// Sector operations finished
+		TargetSector = GetNextTradeSector(Plan.Sector);
+		SetTargetSector(TargetSector);
+	}
+
+	if (TargetSector && TargetSector != TradeRouteFleet->GetCurrentSector())
+	{
+		FLOGV("  -> start travel to %s", *TargetSector->GetSectorName().ToString());
+		Game->GetGameWorld()->StartTravel(TradeRouteFleet, TargetSector);
+	}
+}
+
+int32 UFlareTradeRoute::TradeOperationCargo(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSpacecraft* Station, FFlareResourceDescription* Resource, int32 Quantity, bool IsLoad)
+{
+	UFlareSimulatedSpacecraft* Source = IsLoad ? Station : Ship;
+	UFlareSimulatedSpacecraft* Destination = IsLoad ? Ship : Station;
+	int64 ResourcePrice = Ship->GetCurrentSector()->GetTransfertResourcePrice(Source, Destination, Resource);
+
+	int32 TradedQuantity = SectorHelper::Trade(Source, Destination, Resource, Quantity);
+	TradeRouteData.CurrentOperationProgress += TradedQuantity;
+
+	// Statistics
+	int64 Revenue = 0;
+	if (Ship->GetCompany() != Station->GetCompany())
+	{
+		Revenue = (IsLoad ? -ResourcePrice : ResourcePrice) * TradedQuantity;
+	}
+	TotalTradedQuantity += TradedQuantity;
+	TotalRevenue += Revenue;
+	if (TradeRouteData.DailyTradedQuantity.Num() > 0)
+	{
+		TradeRouteData.DailyTradedQuantity.Last() += TradedQuantity;
+		TradeRouteData.DailyRevenue.Last() += Revenue;
+	}
+
+	return TradedQuantity;
+}
+
+void UFlareTradeRoute::BeginStatsDay()
+{
+	if (TradeRouteData.DailyTradedQuantity.Num() >= TRADE_ROUTE_STATS_DAYS)
+	{
+		TradeRouteData.DailyTradedQuantity.RemoveAt(0);
+		TradeRouteData.DailyRevenue.RemoveAt(0);
+	}
+
+	TradeRouteData.DailyTradedQuantity.Add(0);
+	TradeRouteData.DailyRevenue.Add(0);
+}
+
 UFlareSimulatedSector* UFlareTradeRoute::UpdateTargetSector()
 {
 	UFlareSimulatedSector* TargetSector = Game->GetGameWorld()->FindSector(TradeRouteData.TargetSectorIdentifier);
@@ -199,7 +339,7 @@ bool UFlareTradeRoute::ProcessLoadOperation(FFlareTradeRouteSectorOperationSave*
 
 	for (int ShipIndex = 0; ShipIndex < UsefullShips.Num(); ShipIndex++)
 	{
-		UFlareSimulatedSpacecraft* Ship = RouteShips[ShipIndex];
+		UFlareSimulatedSpacecraft* Ship = UsefullShips[ShipIndex];
 
 		if (Ship->IsTrading())
 		{
@@ -219,7 +359,7 @@ bool UFlareTradeRoute::ProcessLoadOperation(FFlareTradeRouteSectorOperationSave*
 
 		if (StationCandidate)
 		{
-			TradeRouteData.CurrentOperationProgress += SectorHelper::Trade(StationCandidate, Ship, Resource, Request.MaxQuantity);
+			TradeOperationCargo(Ship, StationCandidate, Resource, Request.MaxQuantity, true);
 		}
 
 		if (IsOperationQuantityLimitReach(Operation))
@@ -271,7 +411,7 @@ bool UFlareTradeRoute::ProcessUnloadOperation(FFlareTradeRouteSectorOperationSav
 
 	for (int ShipIndex = 0; ShipIndex < UsefullShips.Num(); ShipIndex++)
 	{
-		UFlareSimulatedSpacecraft* Ship = RouteShips[ShipIndex];
+		UFlareSimulatedSpacecraft* Ship = UsefullShips[ShipIndex];
 
 		if (Ship->IsTrading())
 		{
@@ -290,7 +430,7 @@ bool UFlareTradeRoute::ProcessUnloadOperation(FFlareTradeRouteSectorOperationSav
 
 		if (StationCandidate)
 		{
-			TradeRouteData.CurrentOperationProgress += SectorHelper::Trade(Ship, StationCandidate, Resource, Request.MaxQuantity);
+			TradeOperationCargo(Ship, StationCandidate, Resource, Request.MaxQuantity, false);
 		}
 
 		if (IsOperationQuantityLimitReach(Operation))
@@ -306,7 +446,7 @@ bool UFlareTradeRoute::ProcessUnloadOperation(FFlareTradeRouteSectorOperationSav
 
 int32 UFlareTradeRoute::GetOperationRemainingQuantity(FFlareTradeRouteSectorOperationSave* Operation)
 {
-	if (Operation->MaxQuantity != -1)
+	if (Operation->MaxQuantity == -1)
 	{
 		return MAX_int32;
 	}
@@ -371,6 +511,8 @@ void UFlareTradeRoute::AddSector(UFlareSimulatedSector* Sector)
 	TradeRouteSector.SectorIdentifier = Sector->GetIdentifier();
 
 	TradeRouteData.Sectors.Add(TradeRouteSector);
+	UpdateSectorIndexes();
+
 	if(TradeRouteData.Sectors.Num() == 1)
 	{
 		SetTargetSector(Sector);
@@ -384,6 +526,7 @@ void UFlareTradeRoute::RemoveSector(UFlareSimulatedSector* Sector)
 		if (TradeRouteData.Sectors[SectorIndex].SectorIdentifier == Sector->GetIdentifier())
 		{
 			TradeRouteData.Sectors.RemoveAt(SectorIndex);
+			UpdateSectorIndexes();
 			return;
 		}
 	}
@@ -561,6 +704,45 @@ void UFlareTradeRoute::InitFleetList()
 	}
 }
 
+bool UFlareTradeRoute::IsLoadOperation(EFlareTradeRouteOperation::Type Type)
+{
+	return (Type == EFlareTradeRouteOperation::Load
+		 || Type == EFlareTradeRouteOperation::Buy
+		 || Type == EFlareTradeRouteOperation::LoadOrBuy);
+}
+
+void UFlareTradeRoute::UpdateSectorIndexes()
+{
+	SectorIndexes.Empty(TradeRouteData.Sectors.Num());
+
+	for (int32 SectorIndex = 0; SectorIndex < TradeRouteData.Sectors.Num(); SectorIndex++)
+	{
+		SectorIndexes.Add(TradeRouteData.Sectors[SectorIndex].SectorIdentifier, SectorIndex);
+	}
+}
+
+int32 UFlareTradeRoute::GetFleetTradableQuantity(FFlareResourceDescription* Resource, bool IsLoad)
+{
+	int32 Quantity = 0;
+	TArray<UFlareSimulatedSpacecraft*>& RouteShips = TradeRouteFleet->GetShips();
+
+	for (int ShipIndex = 0; ShipIndex < RouteShips.Num(); ShipIndex++)
+	{
+		UFlareSimulatedSpacecraft* Ship = RouteShips[ShipIndex];
+
+		if (IsLoad)
+		{
+			Quantity += Ship->GetCargoBay()->GetFreeSpaceForResource(Resource, Ship->GetCompany());
+		}
+		else
+		{
+			Quantity += Ship->GetCargoBay()->GetResourceQuantity(Resource, Ship->GetCompany());
+		}
+	}
+
+	return Quantity;
+}
+
 
 /*----------------------------------------------------
 	Getters
@@ -575,15 +757,8 @@ UFlareFleet* UFlareTradeRoute::GetFleet()
 
 FFlareTradeRouteSectorSave* UFlareTradeRoute::GetSectorOrders(UFlareSimulatedSector* Sector)
 {
-	for (int32 SectorIndex = 0; SectorIndex < TradeRouteData.Sectors.Num(); SectorIndex++)
-	{
-		if (TradeRouteData.Sectors[SectorIndex].SectorIdentifier == Sector->GetIdentifier())
-		{
-			return &TradeRouteData.Sectors[SectorIndex];
-		}
-	}
-
-	return NULL;
+	int32 SectorIndex = GetSectorIndex(Sector);
+	return (SectorIndex >= 0 ? &TradeRouteData.Sectors[SectorIndex] : NULL);
 }
 
 UFlareSimulatedSector* UFlareTradeRoute::GetNextTradeSector(UFlareSimulatedSector* Sector)
@@ -593,22 +768,10 @@ UFlareSimulatedSector* UFlareTradeRoute::GetNextTradeSector(UFlareSimulatedSecto
 		return NULL;
 	}
 
-	int32 NextSectorId = -1;
+	int32 NextSectorId = 0;
 	if(Sector)
 	{
-		for (int32 SectorIndex = 0; SectorIndex < TradeRouteData.Sectors.Num(); SectorIndex++)
-		{
-			if(TradeRouteData.Sectors[SectorIndex].SectorIdentifier == Sector->GetIdentifier())
-			{
-				NextSectorId = SectorIndex + 1;
-				break;
-			}
-		}
-	}
-
-	if (NextSectorId < 0)
-	{
-        NextSectorId = 0;
+		NextSectorId = GetSectorIndex(Sector) + 1;
 	}
 
 
@@ -622,26 +785,13 @@ UFlareSimulatedSector* UFlareTradeRoute::GetNextTradeSector(UFlareSimulatedSecto
 
 bool UFlareTradeRoute::IsVisiting(UFlareSimulatedSector *Sector)
 {
-    for (int32 SectorIndex = 0; SectorIndex < TradeRouteData.Sectors.Num(); SectorIndex++)
-    {
-        if (TradeRouteData.Sectors[SectorIndex].SectorIdentifier == Sector->GetIdentifier())
-        {
-            return true;
-        }
-    }
-    return false;
+	return SectorIndexes.Contains(Sector->GetIdentifier());
 }
 
 int32 UFlareTradeRoute::GetSectorIndex(UFlareSimulatedSector *Sector)
 {
-    for (int32 SectorIndex = 0; SectorIndex < TradeRouteData.Sectors.Num(); SectorIndex++)
-    {
-        if (TradeRouteData.Sectors[SectorIndex].SectorIdentifier == Sector->GetIdentifier())
-        {
-            return SectorIndex;
-        }
-    }
-    return -1;
+	const int32* SectorIndex = SectorIndexes.Find(Sector->GetIdentifier());
+	return (SectorIndex ? *SectorIndex : -1);
 }
 
 UFlareSimulatedSector* UFlareTradeRoute::GetTargetSector() const
@@ -693,3 +843,33 @@ void UFlareTradeRoute::SkipCurrentOperation()
 		SetTargetSector(TargetSector);
 	}
 }
+
+float UFlareTradeRoute::GetProjectedQuantityPerDay() const
+{
+	if (TradeRouteData.DailyTradedQuantity.Num() == 0)
+	{
+		return 0;
+	}
+
+	int64 Quantity = 0;
+	for (int32 DayIndex = 0; DayIndex < TradeRouteData.DailyTradedQuantity.Num(); DayIndex++)
+	{
+		Quantity += TradeRouteData.DailyTradedQuantity[DayIndex];
+	}
+	return (float) Quantity / TradeRouteData.DailyTradedQuantity.Num();
+}
+
+float UFlareTradeRoute::GetProjectedRevenuePerDay() const
+{
+	if (TradeRouteData.DailyRevenue.Num() == 0)
+	{
+		return 0;
+	}
+
+	int64 Revenue = 0;
+	for (int32 DayIndex = 0; DayIndex < TradeRouteData.DailyRevenue.Num(); DayIndex++)
+	{
+		Revenue += TradeRouteData.DailyRevenue[DayIndex];
+	}
+	return (float) Revenue / TradeRouteData.DailyRevenue.Num();
+}
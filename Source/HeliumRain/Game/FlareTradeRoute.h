@@ -8,8 +8,13 @@ class AFlareGame;
 class UFlareFleet;
 class UFlareCompany;
 class UFlareSimulatedSector;
+class UFlareSimulatedSpacecraft;
+class UFlareTradeRoute;
 struct FFlareResourceDescription;
 
+/** Number of days of trade statistics kept by a trade route */
+#define TRADE_ROUTE_STATS_DAYS 30
+
 /** Hostility status */
 UENUM()
 namespace EFlareTradeRouteOperation
@@ -109,6 +114,29 @@ struct FFlareTradeRouteSave
 	/** Trade route current pause status*/
 	UPROPERTY(EditAnywhere, Category = Save)
 	bool IsPaused;
+
+	/** Cargo moved per day, newest day last */
+	UPROPERTY(EditAnywhere, Category = Save)
+	TArray<int32> DailyTradedQuantity;
+
+	/** Money earned per day, newest day last */
+	UPROPERTY(EditAnywhere, Category = Save)
+	TArray<int64> DailyRevenue;
+};
+
+/** Trade route state planned once per day by the batched simulation */
+struct FFlareTradeRoutePlan
+{
+	UFlareTradeRoute*                      Route;
+
+	/** Sector the fleet is working in, NULL if it has to travel */
+	UFlareSimulatedSector*                 Sector;
+	FFlareTradeRouteSectorSave*            SectorOrder;
+
+	/** Operation to process, NULL when the route is done for the day */
+	FFlareTradeRouteSectorOperationSave*   Operation;
+	FFlareResourceDescription*             Resource;
+	bool                                   IsLoad;
 };
 
 UCLASS()
@@ -135,6 +163,24 @@ public:
 
 	void Simulate();
 
+	/** Resolve the sector and operation of the day, return false if the route is idle */
+	bool PlanDay(FFlareTradeRoutePlan& Plan);
+
+	/** Set the first unfinished operation of the planned sector as the active one */
+	void SelectOperation(FFlareTradeRoutePlan& Plan);
+
+	/** Close the planned operation after its trades, and select the next one if it is finished */
+	void FinishOperation(FFlareTradeRoutePlan& Plan);
+
+	/** Move to the next sector once the planned sector is done */
+	void EndDay(FFlareTradeRoutePlan& Plan);
+
+	/** Trade with a station for the active operation, return the quantity traded */
+	int32 TradeOperationCargo(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSpacecraft* Station, FFlareResourceDescription* Resource, int32 Quantity, bool IsLoad);
+
+	/** Start a new day of trade statistics */
+	void BeginStatsDay();
+
 	UFlareSimulatedSector* UpdateTargetSector();
 
 	bool ProcessCurrentOperation(FFlareTradeRouteSectorOperationSave* Operation);
@@ -174,6 +220,9 @@ public:
 
 	void SkipCurrentOperation();
 
+	/** Check if an operation takes cargo from stations */
+	static bool IsLoadOperation(EFlareTradeRouteOperation::Type Type);
+
     virtual void SetTradeRouteName(FText NewName)
     {
         TradeRouteData.Name = NewName;
@@ -186,6 +235,12 @@ public:
 
 protected:
 
+	/** Rebuild the sector index lookup after the sector list changed */
+	void UpdateSectorIndexes();
+
+	/** Get the cargo the fleet can load, or unload, for a resource */
+	int32 GetFleetTradableQuantity(FFlareResourceDescription* Resource, bool IsLoad);
+
 	UFlareFleet*                  TradeRouteFleet;
 
 	UFlareCompany*			               TradeRouteCompany;
@@ -193,6 +248,13 @@ protected:
 	AFlareGame*                            Game;
 	bool                                   IsFleetListLoaded;
 
+	/** Index in the sector list by sector identifier */
+	TMap<FName, int32>                     SectorIndexes;
+
+	// Trade statistics since the route was loaded
+	int64                                  TotalTradedQuantity;
+	int64                                  TotalRevenue;
+
 public:
 
 	/*----------------------------------------------------
@@ -247,4 +309,26 @@ public:
 	{
 		return TradeRouteData.IsPaused;
 	}
+
+	/** Get the cargo moved per day, projected from the recent days */
+	float GetProjectedQuantityPerDay() const;
+
+	/** Get the money earned per day, projected from the recent days */
+	float GetProjectedRevenuePerDay() const;
+
+	/** Get the number of days the projection is based on */
+	int32 GetProjectionDays() const
+	{
+		return TradeRouteData.DailyTradedQuantity.Num();
+	}
+
+	int64 GetTotalTradedQuantity() const
+	{
+		return TotalTradedQuantity;
+	}
+
+	int64 GetTotalRevenue() const
+	{
+		return TotalRevenue;
+	}
 };
@@ -7,6 +7,7 @@
 #include "FlareTravel.h"
 #include "FlareFleet.h"
 #include "FlareBattle.h"
+#include "FlareSectorHelper.h"
 
 #include "../Data/FlareSectorCatalogEntry.h"
 #include "../Player/FlarePlayerController.h"
@@ -29,6 +30,17 @@ void UFlareWorld::Load(const FFlareWorldSave& Data)
 	FLOG("UFlareWorld::Load");
 	Game = Cast<AFlareGame>(GetOuter());
     WorldData = Data;
+	BuildSpacecraftPriceDependencies();
+
+	// Factories are simulated from the next day on
+	Factories.Empty();
+	AwakeFactories.Empty();
+	FactoryWakeUpQueue.Empty();
+	MoneyBlockedFactories.Empty();
+	FactorySimulationDate = WorldData.Date;
+	FactoryWorkIndex = INDEX_NONE;
+	NextFactoryScheduleOrder = 0;
+	BatchTradeRoutes = true;
 
 	// Init planetarium
 	Planetarium = NewObject<UFlareSimulatedPlanetarium>(this, UFlareSimulatedPlanetarium::StaticClass());
@@ -141,6 +153,7 @@ UFlareSimulatedSector* UFlareWorld::LoadSector(const FFlareSectorDescription* De
 	// Create the new sector
 	Sector = NewObject<UFlareSimulatedSector>(this, UFlareSimulatedSector::StaticClass(), SectorData.Identifier);
 	Sector->Load(Description, SectorData, OrbitParameters);
+	Sector->SetWorldIndex(Sectors.Num());
 	Sectors.AddUnique(Sector);
 
 	FLOGV("UFlareWorld::LoadSector : loaded '%s'", *Sector->GetSectorName().ToString());
@@ -518,10 +531,7 @@ void UFlareWorld::Simulate()
 
 	// Factories
 	FLOG("* Simulate > Factories");
-	for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
-	{
-		Factories[FactoryIndex]->Simulate();
-	}
+	SimulateFactories();
 
 	// Peoples
 	FLOG("* Simulate > Peoples");
@@ -534,13 +544,21 @@ void UFlareWorld::Simulate()
 	FLOG("* Simulate > Trade routes");
 
 	// Trade routes
-	for (int CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	if (BatchTradeRoutes)
 	{
-		TArray<UFlareTradeRoute*>& TradeRoutes = Companies[CompanyIndex]->GetCompanyTradeRoutes();
-
-		for (int RouteIndex = 0; RouteIndex < TradeRoutes.Num(); RouteIndex++)
+		SimulateTradeRoutes();
+	}
+	else
+	{
+		for (int CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
 		{
-			TradeRoutes[RouteIndex]->Simulate();
+			TArray<UFlareTradeRoute*>& TradeRoutes = Companies[CompanyIndex]->GetCompanyTradeRoutes();
+
+			for (int RouteIndex = 0; RouteIndex < TradeRoutes.Num(); RouteIndex++)
+			{
+				TradeRoutes[RouteIndex]->BeginStatsDay();
+				TradeRoutes[RouteIndex]->Simulate();
+			}
 		}
 	}
 	FLOG("* Simulate > Travels");
@@ -591,6 +609,18 @@ void UFlareWorld::Simulate()
 		Sectors[SectorIndex]->SwapPrices();
 	}
 
+	// Spacecraft prices follow the new day prices
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		Sectors[SectorIndex]->RebuildSpacecraftPrices();
+	}
+
+	// Company value history
+	for (int CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		Companies[CompanyIndex]->UpdateCompanyValueHistory();
+	}
+
 	double EndTs = FPlatformTime::Seconds();
 	FLOGV("** Simulate day %d done in %.6fs", WorldData.Date-1, EndTs- StartTs);
 
@@ -912,19 +942,420 @@ TArray<FFlareWorldEvent> UFlareWorld::GenerateEvents(UFlareCompany* PointOfView)
 
 void UFlareWorld::ClearFactories(UFlareSimulatedSpacecraft *ParentSpacecraft)
 {
+	bool Removed = false;
+
 	for (int FactoryIndex = Factories.Num() -1 ; FactoryIndex >= 0; FactoryIndex--)
 	{
 		UFlareFactory* Factory = Factories[FactoryIndex];
 		if (Factory->GetParent() == ParentSpacecraft)
 		{
+			Factory->SetSchedule(EFlareFactorySchedule::Removed);
 			Factories.RemoveAt(FactoryIndex);
+			AwakeFactories.Remove(Factory);
+			MoneyBlockedFactories.Remove(Factory);
+			Removed = true;
 		}
 	}
+
+	// Don't keep references to removed factories
+	if (Removed)
+	{
+		FactoryWakeUpQueue.RemoveAll([](const FFlareFactoryWakeUp& WakeUp)
+		{
+			return WakeUp.Factory->GetScheduleState() == EFlareFactorySchedule::Removed;
+		});
+		FactoryWakeUpQueue.Heapify();
+	}
 }
 
 void UFlareWorld::AddFactory(UFlareFactory* Factory)
 {
 	Factories.Add(Factory);
+
+	// New factories are simulated at the next factory phase, after existing ones
+	Factory->InitSchedule(NextFactoryScheduleOrder++, FactorySimulationDate);
+	AwakeFactories.Add(Factory);
+}
+
+void UFlareWorld::WakeFactory(UFlareFactory* Factory)
+{
+	EFlareFactorySchedule::Type State = Factory->GetScheduleState();
+
+	if (State == EFlareFactorySchedule::Awake || State == EFlareFactorySchedule::Removed)
+	{
+		return;
+	}
+
+	if (FactoryWorkIndex != INDEX_NONE)
+	{
+		// During the factory phase, a factory later in the order is simulated today, like the daily scan did
+		UFlareFactory* CurrentFactory = FactoryWorkList[FactoryWorkIndex];
+		if (Factory->GetScheduleOrder() > CurrentFactory->GetScheduleOrder())
+		{
+			Factory->SyncProduction(FactorySimulationDate);
+			Factory->SetSchedule(EFlareFactorySchedule::Awake);
+
+			int32 InsertIndex = FactoryWorkIndex + 1;
+			while (InsertIndex < FactoryWorkList.Num() && FactoryWorkList[InsertIndex]->GetScheduleOrder() < Factory->GetScheduleOrder())
+			{
+				InsertIndex++;
+			}
+			FactoryWorkList.Insert(Factory, InsertIndex);
+			return;
+		}
+
+		// Earlier in the order : today has already been accounted for
+		Factory->SyncProduction(FactorySimulationDate + 1);
+	}
+	else
+	{
+		Factory->SyncProduction(FactorySimulationDate);
+	}
+
+	Factory->SetSchedule(EFlareFactorySchedule::Awake);
+	AwakeFactories.Add(Factory);
+}
+
+void UFlareWorld::WakeFactories(UFlareSimulatedSpacecraft* Station)
+{
+	TArray<UFlareFactory*>& StationFactories = Station->GetFactories();
+
+	for (int FactoryIndex = 0; FactoryIndex < StationFactories.Num(); FactoryIndex++)
+	{
+		WakeFactory(StationFactories[FactoryIndex]);
+	}
+}
+
+void UFlareWorld::WakeMoneyBlockedFactories(UFlareCompany* Company)
+{
+	for (int FactoryIndex = MoneyBlockedFactories.Num() - 1; FactoryIndex >= 0; FactoryIndex--)
+	{
+		UFlareFactory* Factory = MoneyBlockedFactories[FactoryIndex];
+
+		if (Factory->GetParent()->GetCompany() == Company)
+		{
+			MoneyBlockedFactories.RemoveAt(FactoryIndex);
+			WakeFactory(Factory);
+		}
+	}
+}
+
+void UFlareWorld::SimulateFactories()
+{
+	int64 Date = WorldData.Date;
+
+	// Wake factories whose production cycle ends today
+	while (FactoryWakeUpQueue.Num() > 0 && FactoryWakeUpQueue.HeapTop().Date <= Date)
+	{
+		FFlareFactoryWakeUp WakeUp;
+		FactoryWakeUpQueue.HeapPop(WakeUp);
+
+		// Skip outdated entries of factories woken up since
+		if (WakeUp.Factory->GetScheduleState() == EFlareFactorySchedule::Producing
+		 && WakeUp.Factory->GetScheduledWakeUpDate() == WakeUp.Date)
+		{
+			WakeUp.Factory->SyncProduction(FactorySimulationDate);
+			WakeUp.Factory->SetSchedule(EFlareFactorySchedule::Awake);
+			AwakeFactories.Add(WakeUp.Factory);
+		}
+	}
+
+	// Keep the world order so that factories sharing a cargo bay compete as before
+	FactoryWorkList = AwakeFactories;
+	AwakeFactories.Empty();
+	FactoryWorkList.Sort([](const UFlareFactory& A, const UFlareFactory& B)
+	{
+		return A.GetScheduleOrder() < B.GetScheduleOrder();
+	});
+
+	for (FactoryWorkIndex = 0; FactoryWorkIndex < FactoryWorkList.Num(); FactoryWorkIndex++)
+	{
+		UFlareFactory* Factory = FactoryWorkList[FactoryWorkIndex];
+
+		if (Factory->GetScheduleState() == EFlareFactorySchedule::Removed)
+		{
+			continue;
+		}
+
+		Factory->Simulate();
+		Factory->MarkSimulated(Date);
+		ScheduleFactory(Factory);
+	}
+
+	FactoryWorkIndex = INDEX_NONE;
+	FactoryWorkList.Empty();
+	FactorySimulationDate = Date;
+}
+
+void UFlareWorld::ScheduleFactory(UFlareFactory* Factory)
+{
+	// Visible states are refreshed daily
+	if (Factory->GetDescription()->VisibleStates)
+	{
+		Factory->SetSchedule(EFlareFactorySchedule::Awake);
+		AwakeFactories.Add(Factory);
+	}
+
+	// Sleep until the end of the production cycle
+	else if (Factory->IsInProductionCycle())
+	{
+		FFlareFactoryWakeUp WakeUp;
+		WakeUp.Date = WorldData.Date + Factory->GetProductionTime(Factory->GetCycleData()) - Factory->GetProductedDuration();
+		WakeUp.Factory = Factory;
+
+		Factory->SetSchedule(EFlareFactorySchedule::Producing, WakeUp.Date);
+		FactoryWakeUpQueue.HeapPush(WakeUp);
+	}
+
+	// Sleep until a cargo, money or state change
+	else
+	{
+		Factory->SetSchedule(EFlareFactorySchedule::Blocked);
+
+		if (Factory->IsShipyard() && Factory->IsActive() && Factory->IsNeedProduction() && !Factory->HasCostReserved())
+		{
+			MoneyBlockedFactories.AddUnique(Factory);
+		}
+	}
+}
+
+
+/*----------------------------------------------------
+	Trade routes
+----------------------------------------------------*/
+
+/** Ship cargo request for a trade route operation */
+struct FFlareTradeRouteCargoRequest
+{
+	int32 PlanIndex;
+	UFlareSimulatedSpacecraft* Ship;
+	UFlareSimulatedSpacecraft* Station;
+	int32 Quantity;
+};
+
+/** Number of times ships can look for another station when their first choice ran out */
+#define TRADE_ROUTE_MAX_STATION_ROUNDS 4
+
+void UFlareWorld::SimulateTradeRoutes()
+{
+	// Resolve target sectors and active operations once
+	TradeRoutePlans.Reset();
+	for (int CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	{
+		TArray<UFlareTradeRoute*>& TradeRoutes = Companies[CompanyIndex]->GetCompanyTradeRoutes();
+
+		for (int RouteIndex = 0; RouteIndex < TradeRoutes.Num(); RouteIndex++)
+		{
+			FFlareTradeRoutePlan Plan;
+			TradeRoutes[RouteIndex]->BeginStatsDay();
+
+			if (TradeRoutes[RouteIndex]->PlanDay(Plan))
+			{
+				TradeRoutePlans.Add(Plan);
+			}
+		}
+	}
+
+	// Process operations until all routes are waiting or done with their sector
+	TArray<FFlareTradeRoutePlan>& Plans = TradeRoutePlans;
+	while (true)
+	{
+		TradeRouteWorkList.Reset();
+		for (int32 PlanIndex = 0; PlanIndex < Plans.Num(); PlanIndex++)
+		{
+			if (Plans[PlanIndex].Operation)
+			{
+				TradeRouteWorkList.Add(PlanIndex);
+			}
+		}
+
+		if (TradeRouteWorkList.Num() == 0)
+		{
+			break;
+		}
+
+		// Group routes competing for the same stations, in an order independent of the company list
+		TradeRouteWorkList.Sort([&Plans](const int32& A, const int32& B)
+		{
+			const FFlareTradeRoutePlan& PlanA = Plans[A];
+			const FFlareTradeRoutePlan& PlanB = Plans[B];
+
+			int32 Order = PlanA.Sector->GetIdentifier().Compare(PlanB.Sector->GetIdentifier());
+			if (Order == 0)
+			{
+				Order = PlanA.Resource->Identifier.Compare(PlanB.Resource->Identifier);
+			}
+			if (Order == 0 && PlanA.IsLoad != PlanB.IsLoad)
+			{
+				Order = (PlanA.IsLoad ? -1 : 1);
+			}
+			if (Order == 0)
+			{
+				Order = PlanA.Route->GetIdentifier().Compare(PlanB.Route->GetIdentifier());
+			}
+			return Order < 0;
+		});
+
+		int32 FirstIndex = 0;
+		for (int32 WorkIndex = 1; WorkIndex <= TradeRouteWorkList.Num(); WorkIndex++)
+		{
+			if (WorkIndex < TradeRouteWorkList.Num())
+			{
+				const FFlareTradeRoutePlan& First = Plans[TradeRouteWorkList[FirstIndex]];
+				const FFlareTradeRoutePlan& Current = Plans[TradeRouteWorkList[WorkIndex]];
+
+				if (First.Sector == Current.Sector && First.Resource == Current.Resource && First.IsLoad == Current.IsLoad)
+				{
+					continue;
+				}
+			}
+
+			SimulateTradeRouteOperations(FirstIndex, WorkIndex);
+			FirstIndex = WorkIndex;
+		}
+
+		// Close operations, finished ones select the next operation for the next pass
+		for (int32 WorkIndex = 0; WorkIndex < TradeRouteWorkList.Num(); WorkIndex++)
+		{
+			FFlareTradeRoutePlan& Plan = Plans[TradeRouteWorkList[WorkIndex]];
+			Plan.Route->FinishOperation(Plan);
+		}
+	}
+
+	// Leave finished sectors
+	for (int32 PlanIndex = 0; PlanIndex < Plans.Num(); PlanIndex++)
+	{
+		Plans[PlanIndex].Route->EndDay(Plans[PlanIndex]);
+	}
+}
+
+void UFlareWorld::SimulateTradeRouteOperations(int32 FirstIndex, int32 LastIndex)
+{
+	TArray<FFlareTradeRouteCargoRequest> Requests;
+
+	for (int32 Round = 0; Round < TRADE_ROUTE_MAX_STATION_ROUNDS; Round++)
+	{
+		// Each idle ship asks its best station for cargo
+		Requests.Reset();
+		for (int32 WorkIndex = FirstIndex; WorkIndex < LastIndex; WorkIndex++)
+		{
+			FFlareTradeRoutePlan& Plan = TradeRoutePlans[TradeRouteWorkList[WorkIndex]];
+			TArray<UFlareSimulatedSpacecraft*>& RouteShips = Plan.Route->GetFleet()->GetShips();
+			int32 RemainingQuantity = Plan.Route->GetOperationRemainingQuantity(Plan.Operation);
+
+			SectorHelper::FlareTradeRequest Request;
+			Request.Resource = Plan.Resource;
+			Request.Operation = Plan.Operation->Type;
+			Request.CargoLimit = -1;
+
+			for (int ShipIndex = 0; ShipIndex < RouteShips.Num() && RemainingQuantity > 0; ShipIndex++)
+			{
+				UFlareSimulatedSpacecraft* Ship = RouteShips[ShipIndex];
+				if (Ship->IsTrading())
+				{
+					continue;
+				}
+
+				if (Plan.IsLoad)
+				{
+					Request.MaxQuantity = Ship->GetCargoBay()->GetFreeSpaceForResource(Plan.Resource, Ship->GetCompany());
+				}
+				else
+				{
+					Request.MaxQuantity = Ship->GetCargoBay()->GetResourceQuantity(Plan.Resource, Ship->GetCompany());
+				}
+				Request.MaxQuantity = FMath::Min(Request.MaxQuantity, RemainingQuantity);
+				if (Request.MaxQuantity <= 0)
+				{
+					continue;
+				}
+
+				Request.Client = Ship;
+				UFlareSimulatedSpacecraft* Station = SectorHelper::FindTradeStation(Request);
+				if (Station)
+				{
+					FFlareTradeRouteCargoRequest CargoRequest;
+					CargoRequest.PlanIndex = TradeRouteWorkList[WorkIndex];
+					CargoRequest.Ship = Ship;
+					CargoRequest.Station = Station;
+					CargoRequest.Quantity = Request.MaxQuantity;
+					Requests.Add(CargoRequest);
+
+					RemainingQuantity -= Request.MaxQuantity;
+				}
+			}
+		}
+
+		if (Requests.Num() == 0)
+		{
+			break;
+		}
+
+		// Share the stock, or free space, of each station between the ships that chose it
+		int32 TradedQuantity = 0;
+		for (int32 RequestIndex = 0; RequestIndex < Requests.Num(); RequestIndex++)
+		{
+			UFlareSimulatedSpacecraft* Station = Requests[RequestIndex].Station;
+			if (Station == NULL)
+			{
+				continue;
+			}
+
+			TArray<FFlareTradeRouteCargoRequest> StationRequests;
+			int64 RequestedQuantity = 0;
+			for (int32 OtherIndex = RequestIndex; OtherIndex < Requests.Num(); OtherIndex++)
+			{
+				if (Requests[OtherIndex].Station == Station)
+				{
+					StationRequests.Add(Requests[OtherIndex]);
+					RequestedQuantity += Requests[OtherIndex].Quantity;
+					Requests[OtherIndex].Station = NULL;
+				}
+			}
+
+			const FFlareTradeRoutePlan& FirstPlan = TradeRoutePlans[StationRequests[0].PlanIndex];
+			UFlareCompany* Client = StationRequests[0].Ship->GetCompany();
+			int64 AvailableQuantity = FirstPlan.IsLoad ?
+				Station->GetCargoBay()->GetResourceQuantity(FirstPlan.Resource, Client) :
+				Station->GetCargoBay()->GetFreeSpaceForResource(FirstPlan.Resource, Client);
+
+			// Proportional shares, the rounding leftover goes to the first routes
+			TArray<int32> Shares;
+			int64 SharedQuantity = 0;
+			for (int32 ShareIndex = 0; ShareIndex < StationRequests.Num(); ShareIndex++)
+			{
+				int32 Share = StationRequests[ShareIndex].Quantity;
+				if (RequestedQuantity > AvailableQuantity)
+				{
+					Share = (int32) ((AvailableQuantity * StationRequests[ShareIndex].Quantity) / RequestedQuantity);
+				}
+				Shares.Add(Share);
+				SharedQuantity += Share;
+			}
+			for (int32 ShareIndex = 0; ShareIndex < StationRequests.Num() && SharedQuantity < AvailableQuantity; ShareIndex++)
+			{
+				int32 Extra = (int32) FMath::Min<int64>(AvailableQuantity - SharedQuantity, StationRequests[ShareIndex].Quantity - Shares[ShareIndex]);
+				Shares[ShareIndex] += Extra;
+				SharedQuantity += Extra;
+			}
+
+			for (int32 ShareIndex = 0; ShareIndex < StationRequests.Num(); ShareIndex++)
+			{
+				const FFlareTradeRouteCargoRequest& CargoRequest = StationRequests[ShareIndex];
+				FFlareTradeRoutePlan& Plan = TradeRoutePlans[CargoRequest.PlanIndex];
+
+				if (Shares[ShareIndex] > 0)
+				{
+					TradedQuantity += Plan.Route->TradeOperationCargo(CargoRequest.Ship, Station, Plan.Resource, Shares[ShareIndex], Plan.IsLoad);
+				}
+			}
+		}
+
+		if (TradedQuantity == 0)
+		{
+			break;
+		}
+	}
 }
 
 void UFlareWorld::OnFleetSupplyConsumed(int32 Quantity)
@@ -976,6 +1407,43 @@ void UFlareWorld::DeleteTravel(UFlareTravel* Travel)
 	Travels.Remove(Travel);
 }
 
+
+/*----------------------------------------------------
+	Spacecraft prices
+----------------------------------------------------*/
+
+void UFlareWorld::BuildSpacecraftPriceDependencies()
+{
+	UFlareSpacecraftCatalog* SpacecraftCatalog = Game->GetSpacecraftCatalog();
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+
+	SpacecraftPriceDependencies.Empty();
+	SpacecraftPriceDependencies.SetNum(ResourceCatalog->Resources.Num());
+
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < SpacecraftCatalog->GetSpacecraftCount(); SpacecraftIndex++)
+	{
+		const FFlareProductionData& CycleCost = SpacecraftCatalog->GetSpacecraft(SpacecraftIndex)->CycleCost;
+
+		for (int32 ResourceIndex = 0; ResourceIndex < CycleCost.InputResources.Num(); ResourceIndex++)
+		{
+			int32 CatalogIndex = ResourceCatalog->GetResourceIndex(&CycleCost.InputResources[ResourceIndex].Resource->Data);
+			if (CatalogIndex != INDEX_NONE)
+			{
+				SpacecraftPriceDependencies[CatalogIndex].AddUnique(SpacecraftIndex);
+			}
+		}
+
+		for (int32 ResourceIndex = 0; ResourceIndex < CycleCost.OutputResources.Num(); ResourceIndex++)
+		{
+			int32 CatalogIndex = ResourceCatalog->GetResourceIndex(&CycleCost.OutputResources[ResourceIndex].Resource->Data);
+			if (CatalogIndex != INDEX_NONE)
+			{
+				SpacecraftPriceDependencies[CatalogIndex].AddUnique(SpacecraftIndex);
+			}
+		}
+	}
+}
+
 /*----------------------------------------------------
 	Getters
 ----------------------------------------------------*/
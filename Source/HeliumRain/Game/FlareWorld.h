@@ -4,6 +4,7 @@
 #include "Object.h"
 #include "FlareGameTypes.h"
 #include "FlareTravel.h"
+#include "FlareTradeRoute.h"
 #include "Planetarium/FlareSimulatedPlanetarium.h"
 #include "FlareWorld.generated.h"
 
@@ -69,6 +70,18 @@ struct FFlareWorldEvent
 	TEnumAsByte<EFlareEventVisibility::Type>  Visibility;
 };
 
+/** Scheduled end of a factory production cycle */
+struct FFlareFactoryWakeUp
+{
+	int64                    Date;
+	UFlareFactory*           Factory;
+
+	bool operator<(const FFlareFactoryWakeUp& Other) const
+	{
+		return Date < Other.Date;
+	}
+};
+
 UCLASS()
 class HELIUMRAIN_API UFlareWorld: public UObject
 {
@@ -133,10 +146,35 @@ public:
 	/** Add a factory to world */
 	void AddFactory(UFlareFactory* Factory);
 
+	/** Simulate the factory at the next factory phase */
+	void WakeFactory(UFlareFactory* Factory);
+
+	/** Simulate the factories of this station at the next factory phase */
+	void WakeFactories(UFlareSimulatedSpacecraft* Station);
+
+	/** Wake the shipyards of this company that are waiting for money */
+	void WakeMoneyBlockedFactories(UFlareCompany* Company);
+
 	void OnFleetSupplyConsumed(int32 Quantity);
 
 protected:
 
+	/** Simulate awake factories and those whose production cycle ends today */
+	void SimulateFactories();
+
+	/** Put a factory to sleep until its cycle ends or something wakes it */
+	void ScheduleFactory(UFlareFactory* Factory);
+
+	/** Plan all trade routes for the day, then trade their operations grouped by sector and resource */
+	void SimulateTradeRoutes();
+
+	/** Trade the planned operations of TradeRouteWorkList[FirstIndex, LastIndex), sharing the stations between routes */
+	void SimulateTradeRouteOperations(int32 FirstIndex, int32 LastIndex);
+
+	/** List the spacecrafts whose price depends on each resource */
+	void BuildSpacecraftPriceDependencies();
+
+
 	/*----------------------------------------------------
 		Protected data
 	----------------------------------------------------*/
@@ -156,6 +194,38 @@ protected:
 	UPROPERTY()
 	TArray<UFlareFactory*>                Factories;
 
+	/** Factories to simulate at the next factory phase */
+	TArray<UFlareFactory*>                AwakeFactories;
+
+	/** Factories simulated in the current factory phase, sorted by schedule order */
+	TArray<UFlareFactory*>                FactoryWorkList;
+
+	/** Producing factories, heap sorted by end of cycle */
+	TArray<FFlareFactoryWakeUp>           FactoryWakeUpQueue;
+
+	/** Blocked shipyards that may restart when their company earns money */
+	TArray<UFlareFactory*>                MoneyBlockedFactories;
+
+	/** Last date whose factory phase is complete */
+	int64                                 FactorySimulationDate;
+
+	/** Index in FactoryWorkList during the factory phase, INDEX_NONE otherwise */
+	int32                                 FactoryWorkIndex;
+
+	int32                                 NextFactoryScheduleOrder;
+
+	/** Simulate trade routes in a batch instead of one after the other */
+	bool                                  BatchTradeRoutes;
+
+	/** Trade routes planned for the day */
+	TArray<FFlareTradeRoutePlan>          TradeRoutePlans;
+
+	/** Plans with an operation to trade, sorted by sector, resource, direction and route */
+	TArray<int32>                         TradeRouteWorkList;
+
+	/** Spacecraft catalog indexes whose price uses a resource, by resource catalog index */
+	TArray<TArray<int32> >                SpacecraftPriceDependencies;
+
 	UPROPERTY()
 	TArray<UFlareTravel*>                Travels;
 
@@ -181,6 +251,12 @@ public:
 		return Game;
 	}
 
+	/** Get the spacecraft catalog indexes whose price uses a resource */
+	inline const TArray<int32>& GetSpacecraftPriceDependencies(int32 ResourceIndex) const
+	{
+		return SpacecraftPriceDependencies[ResourceIndex];
+	}
+
 	FFlareWorldSave* GetData()
 	{
 		return &WorldData;
@@ -206,6 +282,16 @@ public:
 		return WorldData.Date;
 	}
 
+	inline int64 GetFactorySimulationDate() const
+	{
+		return FactorySimulationDate;
+	}
+
+	inline void SetBatchTradeRoutes(bool Batch)
+	{
+		BatchTradeRoutes = Batch;
+	}
+
 	UFlareCompany* FindCompany(FName Identifier) const;
 
 	UFlareCompany* FindCompanyByShortName(FName CompanyShortName) const;
@@ -150,6 +150,11 @@ void CombatLog::AutomaticBattleEnded(UFlareSimulatedSector* Sector)
 
 void CombatLog::BombDropped(AFlareBomb *Bomb)
 {
+	if (!FFlareLogWriter::IsEventEnabled(EFlareLogEvent::BOMB_DROPPED))
+	{
+		return;
+	}
+
 	FlareLogMessage Message;
 	Message.Target = EFlareLogTarget::Combat;
 	Message.Event = EFlareLogEvent::BOMB_DROPPED;
@@ -187,6 +192,11 @@ void CombatLog::BombDropped(AFlareBomb *Bomb)
 
 void CombatLog::BombDestroyed(FName BombIdentifier)
 {
+	if (!FFlareLogWriter::IsEventEnabled(EFlareLogEvent::BOMB_DESTROYED))
+	{
+		return;
+	}
+
 	FlareLogMessage Message;
 	Message.Target = EFlareLogTarget::Combat;
 	Message.Event = EFlareLogEvent::BOMB_DESTROYED;
@@ -201,8 +211,13 @@ void CombatLog::BombDestroyed(FName BombIdentifier)
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
-void CombatLog::SpacecraftDamaged(UFlareSimulatedSpacecraft* Spacecraft, float Energy, float Radius, FVector RelativeLocation, EFlareDamage::Type DamageType, UFlareCompany* DamageSource)
+void CombatLog::SpacecraftDamaged(UFlareSimulatedSpacecraft* Spacecraft, float Energy, float Radius, FVector RelativeLocation, EFlareDamage::Type DamageType, UFlareCompany* DamageSource, int32 ComponentCount)
 {
+	if (!FFlareLogWriter::IsEventEnabled(EFlareLogEvent::SPACECRAFT_DAMAGED))
+	{
+		return;
+	}
+
 	FlareLogMessage Message;
 	Message.Target = EFlareLogTarget::Combat;
 	Message.Event = EFlareLogEvent::SPACECRAFT_DAMAGED;
@@ -231,6 +246,7 @@ void CombatLog::SpacecraftDamaged(UFlareSimulatedSpacecraft* Spacecraft, float E
 	{
 		FlareLogMessageParam Param;
 		Param.Type = EFlareLogParam::Float;
+		Param.Aggregation = EFlareLogAggregation::Last;
 		Param.FloatValue = Radius;
 		Message.Params.Add(Param);
 	}
@@ -249,11 +265,23 @@ void CombatLog::SpacecraftDamaged(UFlareSimulatedSpacecraft* Spacecraft, float E
 		Message.Params.Add(Param);
 	}
 
+	{
+		FlareLogMessageParam Param;
+		Param.Type = EFlareLogParam::Integer;
+		Param.IntValue = ComponentCount;
+		Message.Params.Add(Param);
+	}
+
 	FFlareLogWriter::PushWriterMessage(Message);
 }
 
 void CombatLog::SpacecraftComponentDamaged(UFlareSimulatedSpacecraft* Spacecraft, FFlareSpacecraftComponentSave* ComponentData, FFlareSpacecraftComponentDescription* ComponentDescription, float Energy, float EffectiveEnergy, EFlareDamage::Type DamageType, float InitialDamageRatio, float TerminalDamageRatio)
 {
+	if (!FFlareLogWriter::IsEventEnabled(EFlareLogEvent::SPACECRAFT_COMPONENT_DAMAGED))
+	{
+		return;
+	}
+
 	FlareLogMessage Message;
 	Message.Target = EFlareLogTarget::Combat;
 	Message.Event = EFlareLogEvent::SPACECRAFT_COMPONENT_DAMAGED;
@@ -303,6 +331,7 @@ void CombatLog::SpacecraftComponentDamaged(UFlareSimulatedSpacecraft* Spacecraft
 	{
 		FlareLogMessageParam Param;
 		Param.Type = EFlareLogParam::Float;
+		Param.Aggregation = EFlareLogAggregation::First;
 		Param.FloatValue = InitialDamageRatio;
 		Message.Params.Add(Param);
 	}
@@ -310,6 +339,7 @@ void CombatLog::SpacecraftComponentDamaged(UFlareSimulatedSpacecraft* Spacecraft
 	{
 		FlareLogMessageParam Param;
 		Param.Type = EFlareLogParam::Float;
+		Param.Aggregation = EFlareLogAggregation::Last;
 		Param.FloatValue = TerminalDamageRatio;
 		Message.Params.Add(Param);
 	}
@@ -319,6 +349,11 @@ void CombatLog::SpacecraftComponentDamaged(UFlareSimulatedSpacecraft* Spacecraft
 
 void CombatLog::SpacecraftHarpooned(UFlareSimulatedSpacecraft* Spacecraft, UFlareCompany* HarpoonOwner)
 {
+	if (!FFlareLogWriter::IsEventEnabled(EFlareLogEvent::SPACECRAFT_HARPOONED))
+	{
+		return;
+	}
+
 	FlareLogMessage Message;
 	Message.Target = EFlareLogTarget::Combat;
 	Message.Event = EFlareLogEvent::SPACECRAFT_HARPOONED;
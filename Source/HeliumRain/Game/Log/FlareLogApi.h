@@ -124,8 +124,12 @@ public:
 	 *  - float : radius
 	 *  - vector3 : relative location
 	 *  - string : damageSourceCompany
+	 *  - int : componentCount, components touched by the damage sphere
+	 *
+	 * Aggregated as SPACECRAFT_DAMAGED_SUMMARY per spacecraft, damage type and source :
+	 * hit count first, energy and component count summed, last radius and location
 	 */
-	static void SpacecraftDamaged(UFlareSimulatedSpacecraft* Spacecraft, float Energy, float Radius, FVector RelativeLocation, EFlareDamage::Type DamageType, UFlareCompany* DamageSource);
+	static void SpacecraftDamaged(UFlareSimulatedSpacecraft* Spacecraft, float Energy, float Radius, FVector RelativeLocation, EFlareDamage::Type DamageType, UFlareCompany* DamageSource, int32 ComponentCount);
 
 
 	/**
@@ -141,6 +145,9 @@ public:
 	 *  - string : damageType
 	 *  - float : InitialDamageRatio
 	 *  - float : TerminalDamageRatio
+	 *
+	 * Aggregated as SPACECRAFT_COMPONENT_DAMAGED_SUMMARY per component and damage type :
+	 * hit count first, energies summed, first InitialDamageRatio and last TerminalDamageRatio
 	 */
 	static void SpacecraftComponentDamaged(UFlareSimulatedSpacecraft* Spacecraft, FFlareSpacecraftComponentSave* ComponentData, FFlareSpacecraftComponentDescription* ComponentDescription, float Energy, float EffectiveEnergy, EFlareDamage::Type DamageType, float InitialDamageRatio, float TerminalDamageRatio);
 
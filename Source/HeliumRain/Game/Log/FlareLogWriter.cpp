@@ -9,6 +9,11 @@
 FFlareLogWriter* FFlareLogWriter::Runnable = NULL;
 //***********************************************************
 
+FFlareLogFilter FFlareLogWriter::Filter;
+
+/** Duration of a rate limit and aggregation period, in seconds */
+static const double LOG_FILTER_PERIOD = 1.0;
+
 static int ThreadIndex = 0;
 
 FFlareLogWriter::FFlareLogWriter(FName UUID)
@@ -105,7 +110,12 @@ void FFlareLogWriter::Shutdown()
 {
 	if (Runnable)
 	{
+		// Pending aggregates and drop reports come before the unload record
+		FlushWriter(true);
 		GameLog::GameUnloaded();
+
+		// Only written if a rule aggregates the unload record itself
+		FlushWriter(true);
 		Runnable->EnsureCompletion();
 		delete Runnable;
 		Runnable = NULL;
@@ -193,6 +203,12 @@ FString FFlareLogWriter::FormatMessage(FlareLogMessage& Message)
 				*Message.Date.ToString(TEXT("%Y-%m-%dT%H:%M:%S.%s")),
 				*UFlareSaveWriter::FormatEnum<EFlareLogEvent::Type>("EFlareLogEvent", Message.Event));
 
+	// Aggregated records are written as EVENT_SUMMARY with the event count first
+	if (Message.AggregatedCount > 0)
+	{
+		MessageString += FString::Printf(TEXT("_SUMMARY,%d"), Message.AggregatedCount);
+	}
+
 	for(int32 ParamIndex = 0; ParamIndex < Message.Params.Num(); ParamIndex++)
 	{
 		MessageString += "," + FormatParam(&Message.Params[ParamIndex]);
@@ -226,15 +242,264 @@ FString FFlareLogWriter::FormatParam(FlareLogMessageParam* Param)
 
 void FFlareLogWriter::PushMessage(FlareLogMessage& Message)
 {
-	Message.Date = FDateTime::UtcNow();
+	if (Message.AggregatedCount == 0)
+	{
+		Message.Date = FDateTime::UtcNow();
+	}
 	MessageQueue.Enqueue(Message);
 	NewMessageEvent->Trigger();
 }
 
 void FFlareLogWriter::PushWriterMessage(FlareLogMessage& Message)
+{
+	if (Runnable)
+	{
+		FlushWriter();
+
+		if (Filter.Filter(Message))
+		{
+			Runnable->PushMessage(Message);
+		}
+	}
+}
+
+void FFlareLogWriter::EnqueueWriterMessage(FlareLogMessage& Message)
 {
 	if (Runnable)
 	{
 		Runnable->PushMessage(Message);
 	}
 }
+
+bool FFlareLogWriter::IsEventEnabled(EFlareLogEvent::Type Event)
+{
+	return Runnable && Filter.IsEnabled(Event);
+}
+
+void FFlareLogWriter::FlushWriter(bool Force)
+{
+	TArray<FlareLogMessage> Messages;
+	Filter.Flush(FPlatformTime::Seconds(), Force, Messages);
+
+	for (int32 MessageIndex = 0; MessageIndex < Messages.Num(); MessageIndex++)
+	{
+		EnqueueWriterMessage(Messages[MessageIndex]);
+	}
+}
+
+void FFlareLogWriter::SetEventRule(EFlareLogEvent::Type Event, EFlareLogLevel::Type Level, int32 MaxPerSecond)
+{
+	// Write what was aggregated with the previous rule
+	FlushWriter(true);
+	Filter.SetRule(Event, Level, MaxPerSecond);
+}
+
+void FFlareLogWriter::SetGlobalMaxPerSecond(int32 MaxPerSecond)
+{
+	Filter.SetGlobalMaxPerSecond(MaxPerSecond);
+}
+
+
+/*----------------------------------------------------
+	Log filter
+----------------------------------------------------*/
+
+FFlareLogFilter::FFlareLogFilter()
+	: GlobalSentThisPeriod(0)
+	, GlobalMaxPerSecond(0)
+	, PeriodStart(0)
+{
+	for (int32 EventIndex = 0; EventIndex < EFlareLogEvent::EVENT_COUNT; EventIndex++)
+	{
+		SentThisPeriod[EventIndex] = 0;
+		DroppedThisPeriod[EventIndex] = 0;
+	}
+}
+
+bool FFlareLogFilter::Filter(FlareLogMessage& Message)
+{
+	const FlareLogEventRule& Rule = Rules[Message.Event];
+
+	switch (Rule.Level)
+	{
+		case EFlareLogLevel::Disabled:
+			return false;
+
+		case EFlareLogLevel::Aggregated:
+			// Rate is checked when the aggregate is written
+			Aggregate(Message);
+			return false;
+
+		case EFlareLogLevel::Full:
+		default:
+			return ConsumeRate(Message.Event);
+	}
+}
+
+bool FFlareLogFilter::Flush(double Now, bool Force, TArray<FlareLogMessage>& OutMessages)
+{
+	if (!Force && Now - PeriodStart < LOG_FILTER_PERIOD)
+	{
+		return false;
+	}
+
+	// Write aggregates, they use the budget of the period they summarize
+	for (int32 EventIndex = 0; EventIndex < EFlareLogEvent::EVENT_COUNT; EventIndex++)
+	{
+		for (auto& Entry : Aggregates[EventIndex])
+		{
+			if (ConsumeRate((EFlareLogEvent::Type) EventIndex))
+			{
+				OutMessages.Add(Entry.Value);
+			}
+		}
+		Aggregates[EventIndex].Empty();
+	}
+
+	// Report dropped messages, never rate limited so that losses are always visible
+	for (int32 EventIndex = 0; EventIndex < EFlareLogEvent::EVENT_COUNT; EventIndex++)
+	{
+		if (DroppedThisPeriod[EventIndex] > 0)
+		{
+			FlareLogMessage Message;
+			Message.Target = (EventIndex >= EFlareLogEvent::SECTOR_ACTIVATED ? EFlareLogTarget::Combat : EFlareLogTarget::Game);
+			Message.Event = EFlareLogEvent::LOG_EVENTS_DROPPED;
+
+			{
+				FlareLogMessageParam Param;
+				Param.Type = EFlareLogParam::String;
+				Param.StringValue = UFlareSaveWriter::FormatEnum<EFlareLogEvent::Type>("EFlareLogEvent", (EFlareLogEvent::Type) EventIndex);
+				Message.Params.Add(Param);
+			}
+			{
+				FlareLogMessageParam Param;
+				Param.Type = EFlareLogParam::Integer;
+				Param.IntValue = DroppedThisPeriod[EventIndex];
+				Message.Params.Add(Param);
+			}
+
+			Message.Date = FDateTime::UtcNow();
+			OutMessages.Add(Message);
+		}
+
+		SentThisPeriod[EventIndex] = 0;
+		DroppedThisPeriod[EventIndex] = 0;
+	}
+
+	GlobalSentThisPeriod = 0;
+	PeriodStart = Now;
+	return true;
+}
+
+void FFlareLogFilter::SetRule(EFlareLogEvent::Type Event, EFlareLogLevel::Type Level, int32 MaxPerSecond)
+{
+	if (Event < 0 || Event >= EFlareLogEvent::EVENT_COUNT)
+	{
+		FLOGV("FFlareLogFilter::SetRule : invalid event %d", (Event + 0));
+		return;
+	}
+
+	Rules[Event].Level = Level;
+	Rules[Event].MaxPerSecond = FMath::Max(MaxPerSecond, 0);
+}
+
+bool FFlareLogFilter::ConsumeRate(EFlareLogEvent::Type Event)
+{
+	const FlareLogEventRule& Rule = Rules[Event];
+
+	if ((Rule.MaxPerSecond > 0 && SentThisPeriod[Event] >= Rule.MaxPerSecond)
+	 || (GlobalMaxPerSecond > 0 && GlobalSentThisPeriod >= GlobalMaxPerSecond))
+	{
+		DroppedThisPeriod[Event]++;
+		return false;
+	}
+
+	SentThisPeriod[Event]++;
+	GlobalSentThisPeriod++;
+	return true;
+}
+
+void FFlareLogFilter::Aggregate(FlareLogMessage& Message)
+{
+	FString Key = GetAggregationKey(Message);
+	FlareLogMessage* Existing = Aggregates[Message.Event].Find(Key);
+
+	if (!Existing)
+	{
+		Message.AggregatedCount = 1;
+		Message.Date = FDateTime::UtcNow();
+		Aggregates[Message.Event].Add(Key, Message);
+		return;
+	}
+
+	FCHECK(Existing->Params.Num() == Message.Params.Num());
+	Existing->AggregatedCount++;
+
+	for (int32 ParamIndex = 0; ParamIndex < Message.Params.Num(); ParamIndex++)
+	{
+		FlareLogMessageParam& Current = Existing->Params[ParamIndex];
+		FlareLogMessageParam& New = Message.Params[ParamIndex];
+
+		switch (GetParamAggregation(New))
+		{
+			case EFlareLogAggregation::Sum:
+				Current.IntValue += New.IntValue;
+				Current.FloatValue += New.FloatValue;
+				break;
+
+			case EFlareLogAggregation::Last:
+				Current = New;
+				break;
+
+			case EFlareLogAggregation::Key:
+			case EFlareLogAggregation::First:
+			default:
+				break;
+		}
+	}
+}
+
+FString FFlareLogFilter::GetAggregationKey(const FlareLogMessage& Message)
+{
+	FString Key;
+
+	for (int32 ParamIndex = 0; ParamIndex < Message.Params.Num(); ParamIndex++)
+	{
+		const FlareLogMessageParam& Param = Message.Params[ParamIndex];
+
+		if (GetParamAggregation(Param) == EFlareLogAggregation::Key)
+		{
+			if (Param.Type == EFlareLogParam::String)
+			{
+				Key += Param.StringValue;
+			}
+			else if (Param.Type == EFlareLogParam::Integer)
+			{
+				Key += UFlareSaveWriter::FormatInt64(Param.IntValue);
+			}
+			Key += ",";
+		}
+	}
+
+	return Key;
+}
+
+EFlareLogAggregation::Type FFlareLogFilter::GetParamAggregation(const FlareLogMessageParam& Param)
+{
+	if (Param.Aggregation != EFlareLogAggregation::Default)
+	{
+		return Param.Aggregation;
+	}
+
+	switch (Param.Type)
+	{
+		case EFlareLogParam::String:
+			return EFlareLogAggregation::Key;
+		case EFlareLogParam::Integer:
+		case EFlareLogParam::Float:
+			return EFlareLogAggregation::Sum;
+		case EFlareLogParam::Vector3:
+		default:
+			return EFlareLogAggregation::Last;
+	}
+}
@@ -32,7 +32,27 @@ namespace EFlareLogEvent
 		BOMB_DESTROYED,
 		SPACECRAFT_DAMAGED,
 		SPACECRAFT_COMPONENT_DAMAGED,
-		SPACECRAFT_HARPOONED
+		SPACECRAFT_HARPOONED,
+
+		// Log event
+		LOG_EVENTS_DROPPED,
+
+		// Keep last
+		EVENT_COUNT
+	};
+}
+
+UENUM()
+namespace EFlareLogLevel
+{
+	enum Type
+	{
+		/** The event is never written */
+		Disabled,
+		/** Events are merged per subject and written once per aggregation period */
+		Aggregated,
+		/** Every event is written */
+		Full,
 	};
 }
 
@@ -49,9 +69,33 @@ namespace EFlareLogParam
 	};
 }
 
+/** How a param is merged when its event is aggregated */
+UENUM()
+namespace EFlareLogAggregation
+{
+	enum Type
+	{
+		/** Strings identify the record, numbers are summed, vectors keep the last value */
+		Default,
+		/** The param identifies the aggregated record */
+		Key,
+		/** Values are summed */
+		Sum,
+		/** The first value is kept */
+		First,
+		/** The last value is kept */
+		Last,
+	};
+}
+
 struct FlareLogMessageParam
 {
+	FlareLogMessageParam()
+		: Aggregation(EFlareLogAggregation::Default)
+	{}
+
 	EFlareLogParam::Type Type;
+	EFlareLogAggregation::Type Aggregation;
 	FString StringValue;
 	int64 IntValue;
 	double FloatValue;
@@ -60,10 +104,91 @@ struct FlareLogMessageParam
 
 struct FlareLogMessage
 {
+	FlareLogMessage()
+		: AggregatedCount(0)
+	{}
+
 	FDateTime Date;
 	EFlareLogTarget::Type Target;
 	EFlareLogEvent::Type Event;
 	TArray<FlareLogMessageParam> Params;
+
+	/** Number of events merged in this message, 0 for a plain event */
+	int32 AggregatedCount;
+};
+
+/** Filtering rule for one event type */
+struct FlareLogEventRule
+{
+	FlareLogEventRule()
+		: Level(EFlareLogLevel::Full)
+		, MaxPerSecond(0)
+	{}
+
+	EFlareLogLevel::Type Level;
+
+	/** Maximum number of written messages per second, 0 for no limit */
+	int32 MaxPerSecond;
+};
+
+
+/** Game thread side filter : levels, aggregation and rate limits */
+class FFlareLogFilter
+{
+public:
+
+	FFlareLogFilter();
+
+	/** Check if an event would be written at all. Use it to skip building messages. */
+	inline bool IsEnabled(EFlareLogEvent::Type Event) const
+	{
+		return Rules[Event].Level != EFlareLogLevel::Disabled;
+	}
+
+	/** Filter a message. Return true if the message must be written now. */
+	bool Filter(FlareLogMessage& Message);
+
+	/** Collect messages ready to be written : aggregates and drop reports. Return true if the period has elapsed. */
+	bool Flush(double Now, bool Force, TArray<FlareLogMessage>& OutMessages);
+
+	void SetRule(EFlareLogEvent::Type Event, EFlareLogLevel::Type Level, int32 MaxPerSecond);
+
+	const FlareLogEventRule& GetRule(EFlareLogEvent::Type Event) const
+	{
+		return Rules[Event];
+	}
+
+	void SetGlobalMaxPerSecond(int32 MaxPerSecond)
+	{
+		GlobalMaxPerSecond = MaxPerSecond;
+	}
+
+	int32 GetGlobalMaxPerSecond() const
+	{
+		return GlobalMaxPerSecond;
+	}
+
+protected:
+
+	/** Reserve a slot in the current period for this event */
+	bool ConsumeRate(EFlareLogEvent::Type Event);
+
+	/** Merge a message into its aggregate */
+	void Aggregate(FlareLogMessage& Message);
+
+	static FString GetAggregationKey(const FlareLogMessage& Message);
+
+	static EFlareLogAggregation::Type GetParamAggregation(const FlareLogMessageParam& Param);
+
+	FlareLogEventRule                          Rules[EFlareLogEvent::EVENT_COUNT];
+	int32                                      SentThisPeriod[EFlareLogEvent::EVENT_COUNT];
+	int32                                      DroppedThisPeriod[EFlareLogEvent::EVENT_COUNT];
+	int32                                      GlobalSentThisPeriod;
+	int32                                      GlobalMaxPerSecond;
+	double                                     PeriodStart;
+
+	/** Pending aggregated records, by event then by subject */
+	TMap<FString, FlareLogMessage>             Aggregates[EFlareLogEvent::EVENT_COUNT];
 };
 
 
@@ -136,7 +261,32 @@ public:
 	static FFlareLogWriter* InitWriter(FName UUID);
 	static void PushWriterMessage(FlareLogMessage& Message);
 
+	/** Check if an event type will be written, to avoid building filtered messages */
+	static bool IsEventEnabled(EFlareLogEvent::Type Event);
+
+	/** Write pending aggregated records when their period has elapsed */
+	static void FlushWriter(bool Force = false);
+
+	/** Configure the verbosity and rate cap of an event type */
+	static void SetEventRule(EFlareLogEvent::Type Event, EFlareLogLevel::Type Level, int32 MaxPerSecond);
+
+	/** Configure the maximum number of messages written per second, all events together */
+	static void SetGlobalMaxPerSecond(int32 MaxPerSecond);
+
+	static const FFlareLogFilter& GetFilter()
+	{
+		return Filter;
+	}
+
 	/** Shuts down the thread. Static so it can easily be called from outside the thread context */
 	static void Shutdown();
 
+protected:
+
+	/** Enqueue a message that already passed the filter */
+	static void EnqueueWriterMessage(FlareLogMessage& Message);
+
+	/** Game thread filter, lives across writer instances */
+	static FFlareLogFilter Filter;
+
 };
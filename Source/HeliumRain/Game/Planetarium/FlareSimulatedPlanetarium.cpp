@@ -7,6 +7,15 @@ const FPreciseVector FPreciseVector::ZeroVector = FPreciseVector();
 
 #define LOCTEXT_NAMESPACE "UFlareSimulatedPlanetarium"
 
+// Duration of an ephemeris cache bucket, in seconds
+#define PLANETARIUM_EPHEMERIS_BUCKET 60
+
+// Time added to leave the shadow for sure, in seconds
+#define PLANETARIUM_DAYLIGHT_MARGIN 1
+
+// Step used to leave the shadows of the other bodies, in seconds
+#define PLANETARIUM_DAYLIGHT_STEP 60
+
 
 /*----------------------------------------------------
 	Constructor
@@ -14,6 +23,7 @@ const FPreciseVector FPreciseVector::ZeroVector = FPreciseVector();
 
 UFlareSimulatedPlanetarium::UFlareSimulatedPlanetarium(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, EphemerisBucket(INDEX_NONE)
 {
 }
 
@@ -81,6 +91,17 @@ void UFlareSimulatedPlanetarium::Load()
 		Nema.Sattelites.Add(Adena);
 	}
 	Sun.Sattelites.Add(Nema);
+
+	// Orbits don't change
+	ComputeOrbitConstants(NULL, &Sun);
+	Bodies.Empty();
+	ListCelestialBodies(&Sun, Bodies);
+
+	// Ephemeris cache
+	CachedSun = Sun;
+	CachedBodies.Empty();
+	ListCelestialBodies(&CachedSun, CachedBodies);
+	EphemerisBucket = INDEX_NONE;
 }
 
 
@@ -164,6 +185,11 @@ FFlareCelestialBody UFlareSimulatedPlanetarium::GetSnapShot(int64 Time, float Sm
 }
 
 FPreciseVector UFlareSimulatedPlanetarium::GetRelativeLocation(FFlareCelestialBody* ParentBody, int64 Time, float SmoothTime, double OrbitDistance, double Mass, double InitialPhase)
+{
+	return GetOrbitLocation(GetRevolutionTime(ParentBody, OrbitDistance, Mass), Time, SmoothTime, OrbitDistance, InitialPhase);
+}
+
+int64 UFlareSimulatedPlanetarium::GetRevolutionTime(FFlareCelestialBody* ParentBody, double OrbitDistance, double Mass)
 {
 	// TODO extract the constant
 	double G = 6.674e-11; // Gravitational constant
@@ -172,8 +198,11 @@ FPreciseVector UFlareSimulatedPlanetarium::GetRelativeLocation(FFlareCelestialBo
 	double OrbitalVelocity = FPreciseMath::Sqrt(G * ((MassSum) / (1000 * OrbitDistance)));
 
 	double OrbitalCircumference = 2 * PI * 1000 * OrbitDistance;
-	int64 RevolutionTime = (int64) (OrbitalCircumference / OrbitalVelocity);
+	return (int64) (OrbitalCircumference / OrbitalVelocity);
+}
 
+FPreciseVector UFlareSimulatedPlanetarium::GetOrbitLocation(int64 RevolutionTime, int64 Time, float SmoothTime, double OrbitDistance, double InitialPhase)
+{
 	double CurrentRevolutionTime = fmod(((double) (Time % RevolutionTime) + SmoothTime), (double) RevolutionTime);
 
 	double Phase = (360 * CurrentRevolutionTime / (double) RevolutionTime) + InitialPhase;
@@ -192,13 +221,19 @@ void UFlareSimulatedPlanetarium::ComputeCelestialBodyLocation(FFlareCelestialBod
 {
 	if (ParentBody)
 	{
-		Body->RelativeLocation = GetRelativeLocation(ParentBody, Time, SmoothTime, Body->OrbitDistance, Body->Mass, 0);
+		Body->RelativeLocation = GetOrbitLocation(Body->RevolutionTime, Time, SmoothTime, Body->OrbitDistance, 0);
 		Body->AbsoluteLocation = ParentBody->AbsoluteLocation + Body->RelativeLocation;
 	}
 
-	int64 RotationPeriod = 360/Body->RotationVelocity;
+	if (Body->RotationPeriod)
+	{
+		Body->RotationAngle = FPreciseMath::UnwindDegrees(Body->RotationVelocity * (Time % Body->RotationPeriod)) + Body->RotationVelocity * SmoothTime;
+	}
+	else
+	{
+		Body->RotationAngle = 0;
+	}
 
-	Body->RotationAngle = FPreciseMath::UnwindDegrees(Body->RotationVelocity * (Time % RotationPeriod)) + Body->RotationVelocity * SmoothTime;
 	for (int SatteliteIndex = 0; SatteliteIndex < Body->Sattelites.Num(); SatteliteIndex++)
 	{
 		FFlareCelestialBody* CelestialBody = &Body->Sattelites[SatteliteIndex];
@@ -206,6 +241,218 @@ void UFlareSimulatedPlanetarium::ComputeCelestialBodyLocation(FFlareCelestialBod
 	}
 }
 
+void UFlareSimulatedPlanetarium::ComputeOrbitConstants(FFlareCelestialBody* ParentBody, FFlareCelestialBody* Body)
+{
+	Body->RevolutionTime = (ParentBody ? GetRevolutionTime(ParentBody, Body->OrbitDistance, Body->Mass) : 0);
+	Body->RotationPeriod = (Body->RotationVelocity != 0 ? (int64) (360 / Body->RotationVelocity) : 0);
+
+	for (int SatteliteIndex = 0; SatteliteIndex < Body->Sattelites.Num(); SatteliteIndex++)
+	{
+		ComputeOrbitConstants(Body, &Body->Sattelites[SatteliteIndex]);
+	}
+}
+
+void UFlareSimulatedPlanetarium::ListCelestialBodies(FFlareCelestialBody* Body, TArray<FFlareCelestialBody*>& BodyList)
+{
+	BodyList.Add(Body);
+
+	for (int SatteliteIndex = 0; SatteliteIndex < Body->Sattelites.Num(); SatteliteIndex++)
+	{
+		ListCelestialBodies(&Body->Sattelites[SatteliteIndex], BodyList);
+	}
+}
+
+
+/*----------------------------------------------------
+	Ephemeris
+----------------------------------------------------*/
+
+void UFlareSimulatedPlanetarium::ComputeEphemerisSample(int64 Bucket, TArray<FFlareEphemerisSample>& Sample)
+{
+	ComputeCelestialBodyLocation(NULL, &Sun, Bucket * PLANETARIUM_EPHEMERIS_BUCKET, 0);
+
+	Sample.SetNum(Bodies.Num());
+	for (int32 BodyIndex = 0; BodyIndex < Bodies.Num(); BodyIndex++)
+	{
+		Sample[BodyIndex].RelativeLocation = Bodies[BodyIndex]->RelativeLocation;
+		Sample[BodyIndex].AbsoluteLocation = Bodies[BodyIndex]->AbsoluteLocation;
+		Sample[BodyIndex].RotationAngle = Bodies[BodyIndex]->RotationAngle;
+	}
+}
+
+FFlareCelestialBody* UFlareSimulatedPlanetarium::GetCachedSnapShot(int64 Time, float SmoothTime)
+{
+	double AbsoluteTime = (double) Time + SmoothTime;
+	int64 Bucket = (int64) FMath::FloorToDouble(AbsoluteTime / PLANETARIUM_EPHEMERIS_BUCKET);
+
+	// Move to the next bucket, or start again
+	if (Bucket != EphemerisBucket)
+	{
+		if (Bucket == EphemerisBucket + 1)
+		{
+			Swap(EphemerisStart, EphemerisEnd);
+		}
+		else
+		{
+			ComputeEphemerisSample(Bucket, EphemerisStart);
+		}
+		ComputeEphemerisSample(Bucket + 1, EphemerisEnd);
+		EphemerisBucket = Bucket;
+	}
+
+	// Circular orbits : the error of a linear interpolation is below a km per minute bucket
+	double Alpha = (AbsoluteTime - (double) Bucket * PLANETARIUM_EPHEMERIS_BUCKET) / PLANETARIUM_EPHEMERIS_BUCKET;
+	for (int32 BodyIndex = 0; BodyIndex < CachedBodies.Num(); BodyIndex++)
+	{
+		const FFlareEphemerisSample& Start = EphemerisStart[BodyIndex];
+		const FFlareEphemerisSample& End = EphemerisEnd[BodyIndex];
+		FFlareCelestialBody* Body = CachedBodies[BodyIndex];
+
+		Body->RelativeLocation = Start.RelativeLocation + Alpha * (End.RelativeLocation - Start.RelativeLocation);
+		Body->AbsoluteLocation = Start.AbsoluteLocation + Alpha * (End.AbsoluteLocation - Start.AbsoluteLocation);
+		Body->RotationAngle = Start.RotationAngle + Alpha * FPreciseMath::UnwindDegrees(End.RotationAngle - Start.RotationAngle);
+	}
+
+	return &CachedSun;
+}
+
+bool UFlareSimulatedPlanetarium::GetShadowAngles(FName ParentIdentifier, double OrbitDistance, double InitialPhase, double Time, double& ShadowAngle, double& ShadowHalfAngle)
+{
+	FFlareCelestialBody* Parent = FindCelestialBody(&Sun, ParentIdentifier);
+	if (!Parent || Parent == &Sun)
+	{
+		return false;
+	}
+
+	int64 WholeTime = (int64) FMath::FloorToDouble(Time);
+	float SmoothTime = Time - WholeTime;
+	ComputeCelestialBodyLocation(NULL, &Sun, WholeTime, SmoothTime);
+
+	// The shadow axis goes from the sun through the parent
+	FPreciseVector Location = GetOrbitLocation(GetRevolutionTime(Parent, OrbitDistance, 0), WholeTime, SmoothTime, OrbitDistance, InitialPhase);
+	double BodyPhase = FMath::RadiansToDegrees(FMath::Atan2(Location.Z, Location.X));
+	double ShadowPhase = FMath::RadiansToDegrees(FMath::Atan2(Parent->AbsoluteLocation.Z, Parent->AbsoluteLocation.X));
+	ShadowAngle = FPreciseMath::UnwindDegrees(BodyPhase - ShadowPhase);
+
+	// In the shadow while the parent hides the whole sun disk
+	double SunAngle = FPreciseMath::Asin(Sun.Radius / Parent->AbsoluteLocation.Size());
+	double ParentAngle = FPreciseMath::Asin(FMath::Min(Parent->Radius / OrbitDistance, 1.0));
+	ShadowHalfAngle = FMath::RadiansToDegrees(ParentAngle - SunAngle);
+
+	return true;
+}
+
+double UFlareSimulatedPlanetarium::GetTimeToDaylight(FName ParentIdentifier, double OrbitDistance, double InitialPhase, double Time)
+{
+	FFlareCelestialBody* Parent = FindCelestialBody(&Sun, ParentIdentifier);
+	if (!Parent || Parent == &Sun)
+	{
+		return 0;
+	}
+
+	// The shadow axis turns with the planet orbiting the sun
+	FFlareCelestialBody* Planet = Parent;
+	while (FindParent(Planet) != &Sun)
+	{
+		Planet = FindParent(Planet);
+	}
+	double BodyVelocity = 360. / GetRevolutionTime(Parent, OrbitDistance, 0);
+	double ShadowVelocity = 360. / Planet->RevolutionTime;
+	double RelativeVelocity = BodyVelocity - ShadowVelocity;
+
+	// The shadow axis of moons doesn't turn at a constant rate, refine a few times
+	double Delay = 0;
+	for (int32 Iteration = 0; Iteration < 4; Iteration++)
+	{
+		double ShadowAngle;
+		double ShadowHalfAngle;
+		GetShadowAngles(ParentIdentifier, OrbitDistance, InitialPhase, Time + Delay, ShadowAngle, ShadowHalfAngle);
+
+		if (FMath::Abs(ShadowAngle) >= ShadowHalfAngle || RelativeVelocity == 0)
+		{
+			break;
+		}
+
+		double ExitAngle = (RelativeVelocity > 0 ? ShadowHalfAngle : -ShadowHalfAngle);
+		Delay += (ExitAngle - ShadowAngle) / RelativeVelocity + PLANETARIUM_DAYLIGHT_MARGIN;
+	}
+
+	// Out of the parent shadow, other bodies may still hide the sun : step until none does, within an orbit
+	double MaxDelay = Delay + GetRevolutionTime(Parent, OrbitDistance, 0);
+	double LitDelay = Delay;
+	while (LitDelay < MaxDelay && GetSunOcclusion(ParentIdentifier, OrbitDistance, InitialPhase, Time + LitDelay) >= 1)
+	{
+		LitDelay += PLANETARIUM_DAYLIGHT_STEP;
+	}
+
+	if (LitDelay == Delay || LitDelay >= MaxDelay)
+	{
+		return LitDelay;
+	}
+
+	// Then find the end of that shadow within the last step
+	double ShadowDelay = LitDelay - PLANETARIUM_DAYLIGHT_STEP;
+	while (LitDelay - ShadowDelay > PLANETARIUM_DAYLIGHT_MARGIN)
+	{
+		double MiddleDelay = (ShadowDelay + LitDelay) / 2;
+		if (GetSunOcclusion(ParentIdentifier, OrbitDistance, InitialPhase, Time + MiddleDelay) >= 1)
+		{
+			ShadowDelay = MiddleDelay;
+		}
+		else
+		{
+			LitDelay = MiddleDelay;
+		}
+	}
+
+	return LitDelay + PLANETARIUM_DAYLIGHT_MARGIN;
+}
+
+double UFlareSimulatedPlanetarium::GetSunOcclusion(FName ParentIdentifier, double OrbitDistance, double InitialPhase, double Time)
+{
+	FFlareCelestialBody* Parent = FindCelestialBody(&Sun, ParentIdentifier);
+	if (!Parent || Parent == &Sun)
+	{
+		return 0;
+	}
+
+	int64 WholeTime = (int64) FMath::FloorToDouble(Time);
+	float SmoothTime = Time - WholeTime;
+	ComputeCelestialBodyLocation(NULL, &Sun, WholeTime, SmoothTime);
+
+	FPreciseVector Location = Parent->AbsoluteLocation + GetOrbitLocation(GetRevolutionTime(Parent, OrbitDistance, 0), WholeTime, SmoothTime, OrbitDistance, InitialPhase);
+	FPreciseVector SunLocation = Sun.AbsoluteLocation - Location;
+	double SunAngle = FMath::RadiansToDegrees(FPreciseMath::Asin(Sun.Radius / SunLocation.Size()));
+	double SunPhase = FMath::RadiansToDegrees(FMath::Atan2(SunLocation.Z, SunLocation.X));
+
+	// Same occlusion as the planetarium actor : the body hiding the largest part of the sun disk
+	double Occlusion = 0;
+	for (int32 BodyIndex = 0; BodyIndex < Bodies.Num(); BodyIndex++)
+	{
+		FFlareCelestialBody* Body = Bodies[BodyIndex];
+		if (Body == &Sun)
+		{
+			continue;
+		}
+
+		FPreciseVector BodyLocation = Body->AbsoluteLocation - Location;
+		double BodyAngle = FMath::RadiansToDegrees(FPreciseMath::Asin(FMath::Min(Body->Radius / BodyLocation.Size(), 1.0)));
+		double BodyPhase = FMath::RadiansToDegrees(FMath::Atan2(BodyLocation.Z, BodyLocation.X));
+		double CenterDistance = FMath::Abs(FPreciseMath::UnwindDegrees(SunPhase - BodyPhase));
+		double AngleSum = SunAngle + BodyAngle;
+		double AngleDiff = FMath::Abs(SunAngle - BodyAngle);
+
+		if (CenterDistance < AngleSum)
+		{
+			double MinAngle = FMath::Min(SunAngle, BodyAngle);
+			double OcclusionRatio = (CenterDistance < AngleDiff) ? 1.0 : (AngleSum - CenterDistance) / (2 * MinAngle);
+			Occlusion = FMath::Max(Occlusion, OcclusionRatio * FMath::Square(MinAngle / SunAngle));
+		}
+	}
+
+	return Occlusion;
+}
+
 AFlareGame* UFlareSimulatedPlanetarium::GetGame() const
 {
 	return Game;
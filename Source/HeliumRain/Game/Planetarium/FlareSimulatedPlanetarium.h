@@ -201,6 +201,12 @@ struct FFlareCelestialBody
 	/** Sattelites list */
 	TArray<FFlareCelestialBody> Sattelites;
 
+	/** Revolution period around the parent, in seconds */
+	int64 RevolutionTime;
+
+	/** Self rotation period, in seconds, 0 if not rotating */
+	int64 RotationPeriod;
+
 	/*----------------------------------------------------
 		Dynamic parameters
 	----------------------------------------------------*/
@@ -216,6 +222,14 @@ struct FFlareCelestialBody
 
 };
 
+/** Celestial body state at the start of an ephemeris time bucket */
+struct FFlareEphemerisSample
+{
+	FPreciseVector RelativeLocation;
+	FPreciseVector AbsoluteLocation;
+	double RotationAngle;
+};
+
 
 UCLASS()
 class HELIUMRAIN_API UFlareSimulatedPlanetarium : public UObject
@@ -234,6 +248,24 @@ public:
 	/** Get relative location of a body orbiting around its parent */
 	virtual FPreciseVector GetRelativeLocation(FFlareCelestialBody* ParentBody, int64 Time, float SmoothTime, double OrbitDistance, double Mass, double InitialPhase);
 
+	/** Get relative location of a body on a circular orbit of known period */
+	static FPreciseVector GetOrbitLocation(int64 RevolutionTime, int64 Time, float SmoothTime, double OrbitDistance, double InitialPhase);
+
+	/** Get the revolution period of a body orbiting around its parent, in seconds */
+	static int64 GetRevolutionTime(FFlareCelestialBody* ParentBody, double OrbitDistance, double Mass);
+
+	/** Get a snapshot interpolated from the ephemeris cache, valid until the next call */
+	FFlareCelestialBody* GetCachedSnapShot(int64 Time, float SmoothTime);
+
+	/** Get the seconds until a body orbiting around a parent leaves the shadows of all bodies, 0 if already lit */
+	double GetTimeToDaylight(FName ParentIdentifier, double OrbitDistance, double InitialPhase, double Time);
+
+	/** Get the part of the sun disk hidden by the other bodies for a body orbiting around a parent, 1 at night */
+	double GetSunOcclusion(FName ParentIdentifier, double OrbitDistance, double InitialPhase, double Time);
+
+	/** Get the angle between a body orbiting around a parent and the parent shadow axis, and the shadow half angle, in degrees */
+	bool GetShadowAngles(FName ParentIdentifier, double OrbitDistance, double InitialPhase, double Time, double& ShadowAngle, double& ShadowHalfAngle);
+
 	/** Return the celestial body with the given identifier */
 	FFlareCelestialBody* FindCelestialBody(FName BodyIdentifier);
 
@@ -255,6 +287,15 @@ protected:
 
 	void ComputeCelestialBodyLocation(FFlareCelestialBody* ParentBody, FFlareCelestialBody* Body, int64 time, float SmoothTime);
 
+	/** Compute the periods of a body and its sattelites */
+	void ComputeOrbitConstants(FFlareCelestialBody* ParentBody, FFlareCelestialBody* Body);
+
+	/** List a body and its sattelites, parents first */
+	static void ListCelestialBodies(FFlareCelestialBody* Body, TArray<FFlareCelestialBody*>& Bodies);
+
+	/** Compute the state of all bodies at the start of a time bucket */
+	void ComputeEphemerisSample(int64 Bucket, TArray<FFlareEphemerisSample>& Sample);
+
 	/*----------------------------------------------------
 		Protected data
 	----------------------------------------------------*/
@@ -262,6 +303,14 @@ protected:
 	AFlareGame*                   Game;
 
 	FFlareCelestialBody           Sun;
+	TArray<FFlareCelestialBody*>  Bodies;
+
+	// Ephemeris cache, samples at the start and end of the current bucket
+	FFlareCelestialBody           CachedSun;
+	TArray<FFlareCelestialBody*>  CachedBodies;
+	TArray<FFlareEphemerisSample> EphemerisStart;
+	TArray<FFlareEphemerisSample> EphemerisEnd;
+	int64                         EphemerisBucket;
 
 public:
 
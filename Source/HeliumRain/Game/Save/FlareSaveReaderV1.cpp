@@ -85,6 +85,26 @@ void UFlareSaveReaderV1::LoadPlayer(const TSharedPtr<FJsonObject> Object, FFlare
 	{
 		LoadQuest(*Quest, &Data->QuestData);
 	}
+
+	const TArray<TSharedPtr<FJsonValue>>* NotificationHistory;
+	if(Object->TryGetArrayField("NotificationHistory", NotificationHistory))
+	{
+		for (TSharedPtr<FJsonValue> Item : *NotificationHistory)
+		{
+			FFlareNotificationRecordSave ChildData;
+			LoadNotificationRecord(Item->AsObject(), &ChildData);
+			Data->NotificationHistory.Add(ChildData);
+		}
+	}
+}
+
+void UFlareSaveReaderV1::LoadNotificationRecord(const TSharedPtr<FJsonObject> Object, FFlareNotificationRecordSave* Data)
+{
+	LoadInt64(Object, "Date", &Data->Date);
+	LoadFName(Object, "Tag", &Data->Tag);
+	Data->Type = LoadEnum<EFlareNotification::Type>(Object, "Type", "EFlareNotification");
+	LoadFText(Object, "Text", &Data->Text);
+	LoadFText(Object, "Info", &Data->Info);
 }
 
 
@@ -203,6 +223,7 @@ void UFlareSaveReaderV1::LoadCompany(const TSharedPtr<FJsonObject> Object, FFlar
 	LoadInt32(Object, "CatalogIdentifier", &Data->CatalogIdentifier);
 	LoadInt64(Object, "Money", &Data->Money);
 	LoadInt64(Object, "CompanyValue", &Data->CompanyValue);
+	LoadInt64Buffer(Object, "CompanyValueHistory", &Data->CompanyValueHistory);
 	LoadInt32(Object, "FleetImmatriculationIndex", &Data->FleetImmatriculationIndex);
 	LoadInt32(Object, "TradeRouteImmatriculationIndex", &Data->TradeRouteImmatriculationIndex);
 
@@ -387,6 +408,17 @@ void UFlareSaveReaderV1::LoadSpacecraft(const TSharedPtr<FJsonObject> Object, FF
 		}
 	}
 
+	const TArray<TSharedPtr<FJsonValue>>* DockingQueue;
+	if(Object->TryGetArrayField("DockingQueue", DockingQueue))
+	{
+		for (TSharedPtr<FJsonValue> Item : *DockingQueue)
+		{
+			FFlareDockingRequestSave ChildData;
+			LoadDockingRequest(Item->AsObject(), &ChildData);
+			Data->DockingQueue.Add(ChildData);
+		}
+	}
+
 }
 
 
@@ -410,6 +442,15 @@ void UFlareSaveReaderV1::LoadAsteroid(const TSharedPtr<FJsonObject> Object, FFla
 }
 
 
+void UFlareSaveReaderV1::LoadDockingRequest(const TSharedPtr<FJsonObject> Object, FFlareDockingRequestSave* Data)
+{
+	LoadFName(Object, "ShipImmatriculation", &Data->ShipImmatriculation);
+	Data->Size = LoadEnum<EFlarePartSize::Type>(Object, "Size", "EFlarePartSize");
+	LoadInt32(Object, "Priority", &Data->Priority);
+	LoadFloat(Object, "WaitTime", &Data->WaitTime);
+}
+
+
 void UFlareSaveReaderV1::LoadSpacecraftComponent(const TSharedPtr<FJsonObject> Object, FFlareSpacecraftComponentSave* Data)
 {
 	LoadFName(Object, "ComponentIdentifier", &Data->ComponentIdentifier);
@@ -556,6 +597,9 @@ void UFlareSaveReaderV1::LoadTradeRoute(const TSharedPtr<FJsonObject> Object, FF
 			Data->Sectors.Add(ChildData);
 		}
 	}
+
+	LoadInt32Array(Object, "DailyTradedQuantity", &Data->DailyTradedQuantity);
+	LoadInt64Array(Object, "DailyRevenue", &Data->DailyRevenue);
 }
 
 
@@ -875,6 +919,30 @@ void UFlareSaveReaderV1::LoadFloatArray(TSharedPtr< FJsonObject > Object, FStrin
 	}
 }
 
+void UFlareSaveReaderV1::LoadInt32Array(TSharedPtr< FJsonObject > Object, FString Key, TArray<int32>* Data)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Array;
+	if(Object->TryGetArrayField(Key, Array))
+	{
+		for (TSharedPtr<FJsonValue> Item : *Array)
+		{
+			Data->Add(FCString::Atoi(*Item->AsString()));
+		}
+	}
+}
+
+void UFlareSaveReaderV1::LoadInt64Array(TSharedPtr< FJsonObject > Object, FString Key, TArray<int64>* Data)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Array;
+	if(Object->TryGetArrayField(Key, Array))
+	{
+		for (TSharedPtr<FJsonValue> Item : *Array)
+		{
+			Data->Add(FCString::Atoi64(*Item->AsString()));
+		}
+	}
+}
+
 
 void UFlareSaveReaderV1::LoadTransform(TSharedPtr< FJsonObject > Object, FString Key, FTransform* Data)
 {
@@ -975,3 +1043,27 @@ void UFlareSaveReaderV1::LoadFloatBuffer(TSharedPtr< FJsonObject > Object, FStri
 		Data->Init(1);
 	}
 }
+
+void UFlareSaveReaderV1::LoadInt64Buffer(TSharedPtr< FJsonObject > Object, FString Key, FFlareInt64Buffer* Data)
+{
+	const TSharedPtr< FJsonObject >* Int64Buffer;
+	if(Object->TryGetObjectField(Key, Int64Buffer))
+	{
+		LoadInt32(*Int64Buffer, "MaxSize", &Data->MaxSize);
+		LoadInt32(*Int64Buffer, "WriteIndex", &Data->WriteIndex);
+
+		const TArray<TSharedPtr<FJsonValue>>* Array;
+		if((*Int64Buffer)->TryGetArrayField("Values", Array))
+		{
+			for (TSharedPtr<FJsonValue> Item : *Array)
+			{
+				Data->Values.Add(FCString::Atoi64(*Item->AsString()));
+			}
+		}
+	}
+	else
+	{
+		FLOGV("WARNING: Fail to load int64 buffer key '%s'. Save corrupted", *Key);
+		Data->Init(1);
+	}
+}
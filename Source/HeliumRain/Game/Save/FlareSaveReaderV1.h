@@ -7,6 +7,7 @@
 class UFlareSaveGame;
 struct FFlareTradeRouteSectorOperationSave;
 struct FFlareFloatBuffer;
+struct FFlareInt64Buffer;
 
 UCLASS()
 class HELIUMRAIN_API UFlareSaveReaderV1: public UObject
@@ -25,6 +26,7 @@ protected:
 	void LoadQuest(const TSharedPtr<FJsonObject> Object, FFlareQuestSave* Data);
 	void LoadQuestProgress(const TSharedPtr<FJsonObject> Object, FFlareQuestProgressSave* Data);
 	void LoadQuestStepProgress(const TSharedPtr<FJsonObject> Object, FFlareQuestStepProgressSave* Data);
+	void LoadNotificationRecord(const TSharedPtr<FJsonObject> Object, FFlareNotificationRecordSave* Data);
 
 	void LoadCompanyDescription(const TSharedPtr<FJsonObject> Object, FFlareCompanyDescription* Data);
 	void LoadWorld(const TSharedPtr<FJsonObject> Object, FFlareWorldSave* Data);
@@ -35,6 +37,7 @@ protected:
 	void LoadSpacecraft(const TSharedPtr<FJsonObject> Object, FFlareSpacecraftSave* Data);
 	void LoadPilot(const TSharedPtr<FJsonObject> Object, FFlareShipPilotSave* Data);
 	void LoadAsteroid(const TSharedPtr<FJsonObject> Object, FFlareAsteroidSave* Data);
+	void LoadDockingRequest(const TSharedPtr<FJsonObject> Object, FFlareDockingRequestSave* Data);
 	void LoadSpacecraftComponent(const TSharedPtr<FJsonObject> Object, FFlareSpacecraftComponentSave* Data);
 	void LoadSpacecraftComponentTurret(const TSharedPtr<FJsonObject> Object, FFlareSpacecraftComponentTurretSave* Data);
 	void LoadSpacecraftComponentWeapon(const TSharedPtr<FJsonObject> Object, FFlareSpacecraftComponentWeaponSave* Data);
@@ -77,10 +80,13 @@ public:
 	void LoadFText(TSharedPtr< FJsonObject > Object, FString Key, FText* Data);
 	void LoadFNameArray(TSharedPtr< FJsonObject > Object, FString Key, TArray<FName>* Data);
 	void LoadFloatArray(TSharedPtr< FJsonObject > Object, FString Key, TArray<float>* Data);
+	void LoadInt32Array(TSharedPtr< FJsonObject > Object, FString Key, TArray<int32>* Data);
+	void LoadInt64Array(TSharedPtr< FJsonObject > Object, FString Key, TArray<int64>* Data);
 	void LoadTransform(TSharedPtr< FJsonObject > Object, FString Key, FTransform* Data);
 	void LoadVector(TSharedPtr< FJsonObject > Object, FString Key, FVector* Data);
 	void LoadRotator(TSharedPtr< FJsonObject > Object, FString Key, FRotator* Data);
 	void LoadFloatBuffer(TSharedPtr< FJsonObject > Object, FString Key, FFlareFloatBuffer* Data);
+	void LoadInt64Buffer(TSharedPtr< FJsonObject > Object, FString Key, FFlareInt64Buffer* Data);
 
 
 
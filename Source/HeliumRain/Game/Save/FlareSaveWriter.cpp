@@ -46,6 +46,26 @@ TSharedRef<FJsonObject> UFlareSaveWriter::SavePlayer(FFlarePlayerSave* Data)
 	JsonObject->SetStringField("LastFlownShipIdentifier", Data->LastFlownShipIdentifier.ToString());
 	JsonObject->SetObjectField("Quest", SaveQuest(&Data->QuestData));
 
+	TArray< TSharedPtr<FJsonValue> > NotificationHistory;
+	for(int i = 0; i < Data->NotificationHistory.Num(); i++)
+	{
+		NotificationHistory.Add(MakeShareable(new FJsonValueObject(SaveNotificationRecord(&Data->NotificationHistory[i]))));
+	}
+	JsonObject->SetArrayField("NotificationHistory", NotificationHistory);
+
+	return JsonObject;
+}
+
+TSharedRef<FJsonObject> UFlareSaveWriter::SaveNotificationRecord(FFlareNotificationRecordSave* Data)
+{
+	TSharedRef<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
+
+	JsonObject->SetStringField("Date", FormatInt64(Data->Date));
+	JsonObject->SetStringField("Tag", Data->Tag.ToString());
+	JsonObject->SetStringField("Type", FormatEnum<EFlareNotification::Type>("EFlareNotification", Data->Type));
+	JsonObject->SetStringField("Text", Data->Text.ToString());
+	JsonObject->SetStringField("Info", Data->Info.ToString());
+
 	return JsonObject;
 }
 
@@ -181,6 +201,7 @@ TSharedRef<FJsonObject> UFlareSaveWriter::SaveCompany(FFlareCompanySave* Data)
 	JsonObject->SetStringField("CatalogIdentifier", FormatInt32(Data->CatalogIdentifier));
 	JsonObject->SetStringField("Money", FormatInt64(Data->Money));
 	JsonObject->SetStringField("CompanyValue", FormatInt64(Data->CompanyValue));
+	JsonObject->SetObjectField("CompanyValueHistory", SaveInt64Buffer(&Data->CompanyValueHistory));
 	JsonObject->SetStringField("FleetImmatriculationIndex", FormatInt32(Data->FleetImmatriculationIndex));
 	JsonObject->SetStringField("TradeRouteImmatriculationIndex", FormatInt32(Data->TradeRouteImmatriculationIndex));
 	JsonObject->SetObjectField("AI", SaveCompanyAI(&Data->AI));
@@ -314,6 +335,13 @@ TSharedRef<FJsonObject> UFlareSaveWriter::SaveSpacecraft(FFlareSpacecraftSave* D
 	}
 	JsonObject->SetArrayField("CapturePoints", CapturePoints);
 
+	TArray< TSharedPtr<FJsonValue> > DockingQueue;
+	for(int i = 0; i < Data->DockingQueue.Num(); i++)
+	{
+		DockingQueue.Add(MakeShareable(new FJsonValueObject(SaveDockingRequest(&Data->DockingQueue[i]))));
+	}
+	JsonObject->SetArrayField("DockingQueue", DockingQueue);
+
 	return JsonObject;
 }
 
@@ -342,6 +370,18 @@ TSharedRef<FJsonObject> UFlareSaveWriter::SaveAsteroid(FFlareAsteroidSave* Data)
 	return JsonObject;
 }
 
+TSharedRef<FJsonObject> UFlareSaveWriter::SaveDockingRequest(FFlareDockingRequestSave* Data)
+{
+	TSharedRef<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
+
+	JsonObject->SetStringField("ShipImmatriculation", Data->ShipImmatriculation.ToString());
+	JsonObject->SetStringField("Size", FormatEnum<EFlarePartSize::Type>("EFlarePartSize", Data->Size));
+	JsonObject->SetStringField("Priority", FormatInt32(Data->Priority));
+	SaveFloat(JsonObject,"WaitTime", Data->WaitTime);
+
+	return JsonObject;
+}
+
 TSharedRef<FJsonObject> UFlareSaveWriter::SaveSpacecraftComponent(FFlareSpacecraftComponentSave* Data)
 {
 	TSharedRef<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
@@ -483,6 +523,20 @@ TSharedRef<FJsonObject> UFlareSaveWriter::SaveTradeRoute(FFlareTradeRouteSave* D
 	}
 	JsonObject->SetArrayField("Sectors", Sectors);
 
+	TArray< TSharedPtr<FJsonValue> > DailyTradedQuantity;
+	for(int i = 0; i < Data->DailyTradedQuantity.Num(); i++)
+	{
+		DailyTradedQuantity.Add(MakeShareable(new FJsonValueString(FormatInt32(Data->DailyTradedQuantity[i]))));
+	}
+	JsonObject->SetArrayField("DailyTradedQuantity", DailyTradedQuantity);
+
+	TArray< TSharedPtr<FJsonValue> > DailyRevenue;
+	for(int i = 0; i < Data->DailyRevenue.Num(); i++)
+	{
+		DailyRevenue.Add(MakeShareable(new FJsonValueString(FormatInt64(Data->DailyRevenue[i]))));
+	}
+	JsonObject->SetArrayField("DailyRevenue", DailyRevenue);
+
 	return JsonObject;
 }
 
@@ -685,6 +739,23 @@ TSharedRef<FJsonObject> UFlareSaveWriter::SaveFloatBuffer(FFlareFloatBuffer* Dat
 	return JsonObject;
 }
 
+TSharedRef<FJsonObject> UFlareSaveWriter::SaveInt64Buffer(FFlareInt64Buffer* Data)
+{
+	TSharedRef<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
+
+	JsonObject->SetStringField("MaxSize", FormatInt32(Data->MaxSize));
+	JsonObject->SetStringField("WriteIndex", FormatInt32(Data->WriteIndex));
+
+	TArray< TSharedPtr<FJsonValue> > Values;
+	for(int i = 0; i < Data->Values.Num(); i++)
+	{
+		Values.Add(MakeShareable(new FJsonValueString(FormatInt64(Data->Values[i]))));
+	}
+	JsonObject->SetArrayField("Values", Values);
+
+	return JsonObject;
+}
+
 
 TSharedRef<FJsonObject> UFlareSaveWriter::SaveTravel(FFlareTravelSave* Data)
 {
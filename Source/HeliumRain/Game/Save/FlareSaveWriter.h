@@ -40,6 +40,7 @@ struct FFlareBombSave;
 struct FFFlareResourcePrice;
 struct FFlareTravelSave;
 struct FFlareFloatBuffer;
+struct FFlareInt64Buffer;
 
 
 UCLASS()
@@ -60,6 +61,7 @@ protected:
 	TSharedRef<FJsonObject> SaveQuest(FFlareQuestSave* Data);
 	TSharedRef<FJsonObject> SaveQuestProgress(FFlareQuestProgressSave* Data);
 	TSharedRef<FJsonObject> SaveQuestStepProgress(FFlareQuestStepProgressSave* Data);
+	TSharedRef<FJsonObject> SaveNotificationRecord(FFlareNotificationRecordSave* Data);
 
 	TSharedRef<FJsonObject> SaveCompanyDescription(FFlareCompanyDescription* Data);
 	TSharedRef<FJsonObject> SaveWorld(FFlareWorldSave* Data);
@@ -70,6 +72,7 @@ protected:
 	TSharedRef<FJsonObject> SaveSpacecraft(FFlareSpacecraftSave* Data);
 	TSharedRef<FJsonObject> SavePilot(FFlareShipPilotSave* Data);
 	TSharedRef<FJsonObject> SaveAsteroid(FFlareAsteroidSave* Data);
+	TSharedRef<FJsonObject> SaveDockingRequest(FFlareDockingRequestSave* Data);
 	TSharedRef<FJsonObject> SaveSpacecraftComponent(FFlareSpacecraftComponentSave* Data);
 	TSharedRef<FJsonObject> SaveSpacecraftComponentTurret(FFlareSpacecraftComponentTurretSave* Data);
 	TSharedRef<FJsonObject> SaveSpacecraftComponentWeapon(FFlareSpacecraftComponentWeaponSave* Data);
@@ -92,6 +95,7 @@ protected:
 	TSharedRef<FJsonObject> SaveBomb(FFlareBombSave* Data);
 	TSharedRef<FJsonObject> SaveResourcePrice(FFFlareResourcePrice* Data);
 	TSharedRef<FJsonObject> SaveFloatBuffer(FFlareFloatBuffer* Data);
+	TSharedRef<FJsonObject> SaveInt64Buffer(FFlareInt64Buffer* Data);
 	TSharedRef<FJsonObject> SaveTravel(FFlareTravelSave* Data);
 
 	void SaveFloat(TSharedPtr< FJsonObject > Object, FString Key, float Data);
@@ -0,0 +1,252 @@
+
+#include "../Flare.h"
+#include "FlareCockpitDistortion.h"
+
+
+// Table samples per grid cell
+#define DISTORTION_TABLE_SUBDIVISIONS   16
+
+// Inverse table solver
+#define DISTORTION_INVERSE_ITERATIONS   20
+#define DISTORTION_INVERSE_TOLERANCE    0.00001f
+
+// Marks a table sample without an antecedent
+static const FVector2D InvalidSample(-1, -1);
+
+
+/*----------------------------------------------------
+	Baking
+----------------------------------------------------*/
+
+FFlareCockpitDistortion::FFlareCockpitDistortion()
+	: CurrentTables(INDEX_NONE)
+	, ScreenSize(FVector2D::ZeroVector)
+	, CockpitSize(FVector2D::ZeroVector)
+	, ExtraHeight(0)
+{
+}
+
+void FFlareCockpitDistortion::Bake(const FFlareCockpitDistortionProfile& Profile)
+{
+	// Cached
+	for (int32 TablesIndex = 0; TablesIndex < BakedTables.Num(); TablesIndex++)
+	{
+		if (BakedTables[TablesIndex].Profile == &Profile)
+		{
+			CurrentTables = TablesIndex;
+			return;
+		}
+	}
+
+	CurrentTables = INDEX_NONE;
+	if (!Profile.IsValid())
+	{
+		FLOGV("FFlareCockpitDistortion::Bake : invalid profile '%s'", *Profile.Identifier.ToString());
+		return;
+	}
+
+	// Table nodes fall on the grid nodes so the bilinear grid is reproduced
+	CurrentTables = BakedTables.AddDefaulted();
+	FFlareCockpitDistortionTables& Tables = BakedTables[CurrentTables];
+	Tables.Profile = &Profile;
+	Tables.Width = (Profile.Width - 1) * DISTORTION_TABLE_SUBDIVISIONS + 1;
+	Tables.Height = (Profile.Height - 1) * DISTORTION_TABLE_SUBDIVISIONS + 1;
+	Tables.Forward.SetNumUninitialized(Tables.Width * Tables.Height);
+
+	for (int32 Y = 0; Y < Tables.Height; Y++)
+	{
+		for (int32 X = 0; X < Tables.Width; X++)
+		{
+			FVector2D Normalized(X / (float) (Tables.Width - 1), Y / (float) (Tables.Height - 1));
+			Tables.Forward[X + Y * Tables.Width] = EvaluateGrid(Profile, Normalized);
+		}
+	}
+
+	FLOGV("FFlareCockpitDistortion::Bake : baked '%s' in %dx%d samples", *Profile.Identifier.ToString(), Tables.Width, Tables.Height);
+}
+
+void FFlareCockpitDistortion::Invalidate(const FFlareCockpitDistortionProfile& Profile)
+{
+	for (int32 TablesIndex = 0; TablesIndex < BakedTables.Num(); TablesIndex++)
+	{
+		if (BakedTables[TablesIndex].Profile == &Profile)
+		{
+			BakedTables.RemoveAt(TablesIndex);
+			CurrentTables = INDEX_NONE;
+			return;
+		}
+	}
+}
+
+void FFlareCockpitDistortion::Reset()
+{
+	BakedTables.Empty();
+	CurrentTables = INDEX_NONE;
+}
+
+void FFlareCockpitDistortion::SolveInverse(FFlareCockpitDistortionTables& Tables)
+{
+	const FFlareCockpitDistortionProfile& Profile = *Tables.Profile;
+	Tables.Inverse.SetNumUninitialized(Tables.Width * Tables.Height);
+
+	// Newton iterations, starting from the undistorted position
+	float Step = 0.5f / (Tables.Width * DISTORTION_TABLE_SUBDIVISIONS);
+	int32 UnsolvedCount = 0;
+	for (int32 Y = 0; Y < Tables.Height; Y++)
+	{
+		for (int32 X = 0; X < Tables.Width; X++)
+		{
+			FVector2D Target(X / (float) (Tables.Width - 1), Y / (float) (Tables.Height - 1));
+			FVector2D Guess = Target;
+			bool Solved = false;
+
+			for (int32 Iteration = 0; Iteration < DISTORTION_INVERSE_ITERATIONS; Iteration++)
+			{
+				FVector2D Error = EvaluateGrid(Profile, Guess) - Target;
+				if (Error.GetAbsMax() < DISTORTION_INVERSE_TOLERANCE)
+				{
+					Solved = true;
+					break;
+				}
+
+				FVector2D DerivativeX = (EvaluateGrid(Profile, Guess + FVector2D(Step, 0)) - EvaluateGrid(Profile, Guess - FVector2D(Step, 0))) / (2 * Step);
+				FVector2D DerivativeY = (EvaluateGrid(Profile, Guess + FVector2D(0, Step)) - EvaluateGrid(Profile, Guess - FVector2D(0, Step))) / (2 * Step);
+				float Determinant = DerivativeX.X * DerivativeY.Y - DerivativeY.X * DerivativeX.Y;
+				if (FMath::Abs(Determinant) < SMALL_NUMBER)
+				{
+					break;
+				}
+
+				Guess.X -= (DerivativeY.Y * Error.X - DerivativeY.X * Error.Y) / Determinant;
+				Guess.Y -= (DerivativeX.X * Error.Y - DerivativeX.Y * Error.X) / Determinant;
+				Guess = FVector2D(FMath::Clamp(Guess.X, 0.f, 1.f), FMath::Clamp(Guess.Y, 0.f, 1.f));
+			}
+
+			Tables.Inverse[X + Y * Tables.Width] = (Solved ? Guess : InvalidSample);
+			UnsolvedCount += (Solved ? 0 : 1);
+		}
+	}
+
+	FLOGV("FFlareCockpitDistortion::SolveInverse : solved '%s', %d samples without inverse", *Profile.Identifier.ToString(), UnsolvedCount);
+}
+
+void FFlareCockpitDistortion::SetResolution(FVector2D NewScreenSize, FVector2D NewCockpitSize)
+{
+	ScreenSize = NewScreenSize;
+	CockpitSize = NewCockpitSize;
+
+	// The cockpit keeps its aspect ratio, the screen is cropped vertically
+	float AspectRatio = CockpitSize.X / CockpitSize.Y;
+	ExtraHeight = ScreenSize.Y - ScreenSize.X / AspectRatio;
+}
+
+float FFlareCockpitDistortion::GetInverseTolerance()
+{
+	return DISTORTION_INVERSE_TOLERANCE;
+}
+
+
+/*----------------------------------------------------
+	Conversion
+----------------------------------------------------*/
+
+bool FFlareCockpitDistortion::ScreenToCockpit(FVector2D Screen, FVector2D& Cockpit) const
+{
+	FVector2D Normalized(Screen.X / ScreenSize.X, (Screen.Y - (ExtraHeight / 2)) / (ScreenSize.Y - ExtraHeight));
+	FVector2D Distorted;
+
+	if (!IsBaked() || !SampleTable(BakedTables[CurrentTables], BakedTables[CurrentTables].Forward, Normalized, Distorted))
+	{
+		return false;
+	}
+
+	Cockpit = Distorted * CockpitSize;
+	return (Cockpit.X >= 0.f && Cockpit.X <= CockpitSize.X && Cockpit.Y >= 0.f && Cockpit.Y <= CockpitSize.Y);
+}
+
+bool FFlareCockpitDistortion::CockpitToScreen(FVector2D Cockpit, FVector2D& Screen)
+{
+	if (!IsBaked())
+	{
+		return false;
+	}
+
+	FFlareCockpitDistortionTables& Tables = BakedTables[CurrentTables];
+	if (Tables.Inverse.Num() == 0)
+	{
+		SolveInverse(Tables);
+	}
+
+	FVector2D Normalized;
+	if (!SampleTable(Tables, Tables.Inverse, Cockpit / CockpitSize, Normalized))
+	{
+		return false;
+	}
+
+	Screen = FVector2D(Normalized.X * ScreenSize.X, Normalized.Y * (ScreenSize.Y - ExtraHeight) + ExtraHeight / 2);
+	return true;
+}
+
+
+/*----------------------------------------------------
+	Internals
+----------------------------------------------------*/
+
+FVector2D FFlareCockpitDistortion::EvaluateGrid(const FFlareCockpitDistortionProfile& Profile, FVector2D Normalized)
+{
+	float XRelativeLocation = FMath::Clamp(Normalized.X, 0.f, 1.f) * (Profile.Width - 1);
+	float YRelativeLocation = FMath::Clamp(Normalized.Y, 0.f, 1.f) * (Profile.Height - 1);
+
+	int32 LeftIndex = FMath::FloorToInt(XRelativeLocation);
+	int32 RightIndex = FMath::CeilToInt(XRelativeLocation);
+	int32 TopIndex = FMath::FloorToInt(YRelativeLocation);
+	int32 BottomIndex = FMath::CeilToInt(YRelativeLocation);
+
+	float LocalX = XRelativeLocation - LeftIndex;
+	float LocalY = YRelativeLocation - TopIndex;
+
+	const float* H = Profile.HorizontalGrid.GetData();
+	const float* V = Profile.VerticalGrid.GetData();
+	int32 W = Profile.Width;
+
+	float TopMeanXDistorsion = LocalX * H[RightIndex + TopIndex * W] + (1 - LocalX) * H[LeftIndex + TopIndex * W];
+	float BottomMeanXDistorsion = LocalX * H[RightIndex + BottomIndex * W] + (1 - LocalX) * H[LeftIndex + BottomIndex * W];
+	float MeanXDistorsion = LocalY * BottomMeanXDistorsion + (1 - LocalY) * TopMeanXDistorsion;
+
+	float TopMeanYDistorsion = LocalX * V[RightIndex + TopIndex * W] + (1 - LocalX) * V[LeftIndex + TopIndex * W];
+	float BottomMeanYDistorsion = LocalX * V[RightIndex + BottomIndex * W] + (1 - LocalX) * V[LeftIndex + BottomIndex * W];
+	float MeanYDistorsion = LocalY * BottomMeanYDistorsion + (1 - LocalY) * TopMeanYDistorsion;
+
+	return FVector2D(Normalized.X * MeanXDistorsion, Normalized.Y * MeanYDistorsion);
+}
+
+bool FFlareCockpitDistortion::SampleTable(const FFlareCockpitDistortionTables& Tables, const TArray<FVector2D>& Table, FVector2D Normalized, FVector2D& Result)
+{
+	if (Table.Num() == 0 || Normalized.X < 0.f || Normalized.X > 1.f || Normalized.Y < 0.f || Normalized.Y > 1.f)
+	{
+		return false;
+	}
+
+	int32 TableWidth = Tables.Width;
+	float XRelativeLocation = Normalized.X * (Tables.Width - 1);
+	float YRelativeLocation = Normalized.Y * (Tables.Height - 1);
+	int32 LeftIndex = FMath::Min(FMath::FloorToInt(XRelativeLocation), Tables.Width - 2);
+	int32 TopIndex = FMath::Min(FMath::FloorToInt(YRelativeLocation), Tables.Height - 2);
+	float LocalX = XRelativeLocation - LeftIndex;
+	float LocalY = YRelativeLocation - TopIndex;
+
+	const FVector2D& TopLeft = Table[LeftIndex + TopIndex * TableWidth];
+	const FVector2D& TopRight = Table[LeftIndex + 1 + TopIndex * TableWidth];
+	const FVector2D& BottomLeft = Table[LeftIndex + (TopIndex + 1) * TableWidth];
+	const FVector2D& BottomRight = Table[LeftIndex + 1 + (TopIndex + 1) * TableWidth];
+
+	if (TopLeft == InvalidSample || TopRight == InvalidSample || BottomLeft == InvalidSample || BottomRight == InvalidSample)
+	{
+		return false;
+	}
+
+	FVector2D Top = LocalX * TopRight + (1 - LocalX) * TopLeft;
+	FVector2D Bottom = LocalX * BottomRight + (1 - LocalX) * BottomLeft;
+	Result = LocalY * Bottom + (1 - LocalY) * Top;
+	return true;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Engine.h"
+#include "FlareCockpitDistortion.generated.h"
+
+
+/** Cockpit distortion grid, factors applied to screen positions to get cockpit positions */
+USTRUCT()
+struct FFlareCockpitDistortionProfile
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Spacecraft description identifier this profile is used for */
+	UPROPERTY(EditAnywhere, Category = Content)
+	FName Identifier;
+
+	/** Grid columns */
+	UPROPERTY(EditAnywhere, Category = Content)
+	int32 Width;
+
+	/** Grid rows */
+	UPROPERTY(EditAnywhere, Category = Content)
+	int32 Height;
+
+	/** Horizontal factors, row by row */
+	UPROPERTY(EditAnywhere, Category = Content)
+	TArray<float> HorizontalGrid;
+
+	/** Vertical factors, row by row */
+	UPROPERTY(EditAnywhere, Category = Content)
+	TArray<float> VerticalGrid;
+
+	FFlareCockpitDistortionProfile()
+		: Width(0)
+		, Height(0)
+	{}
+
+	bool IsValid() const
+	{
+		return Width >= 2 && Height >= 2 && HorizontalGrid.Num() == Width * Height && VerticalGrid.Num() == Width * Height;
+	}
+};
+
+
+/** Dense tables baked from a profile, in normalized coordinates */
+struct FFlareCockpitDistortionTables
+{
+	const FFlareCockpitDistortionProfile*   Profile;
+	int32                                   Width;
+	int32                                   Height;
+	TArray<FVector2D>                       Forward;
+
+	/** Solved on first use */
+	TArray<FVector2D>                       Inverse;
+};
+
+
+/** Distortion profiles baked into dense tables, cached per profile */
+class HELIUMRAIN_API FFlareCockpitDistortion
+{
+public:
+
+	FFlareCockpitDistortion();
+
+	/** Use a profile, baking its forward table unless it is cached */
+	void Bake(const FFlareCockpitDistortionProfile& Profile);
+
+	/** Drop the tables of a profile after it was edited */
+	void Invalidate(const FFlareCockpitDistortionProfile& Profile);
+
+	/** Drop all tables */
+	void Reset();
+
+	/** Set the screen and cockpit sizes the tables are used with */
+	void SetResolution(FVector2D NewScreenSize, FVector2D NewCockpitSize);
+
+	/** Convert a screen position to the cockpit, false if outside */
+	bool ScreenToCockpit(FVector2D Screen, FVector2D& Cockpit) const;
+
+	/** Convert a cockpit position to the screen, false if outside. The inverse table is solved on the first call for a profile */
+	bool CockpitToScreen(FVector2D Cockpit, FVector2D& Screen);
+
+	bool IsBaked() const
+	{
+		return CurrentTables != INDEX_NONE;
+	}
+
+	const FFlareCockpitDistortionProfile* GetBakedProfile() const
+	{
+		return IsBaked() ? BakedTables[CurrentTables].Profile : NULL;
+	}
+
+	/** Table samples per row, 0 if not baked */
+	int32 GetTableWidth() const
+	{
+		return IsBaked() ? BakedTables[CurrentTables].Width : 0;
+	}
+
+	/** Table rows, 0 if not baked */
+	int32 GetTableHeight() const
+	{
+		return IsBaked() ? BakedTables[CurrentTables].Height : 0;
+	}
+
+	FVector2D GetScreenSize() const
+	{
+		return ScreenSize;
+	}
+
+	FVector2D GetCockpitSize() const
+	{
+		return CockpitSize;
+	}
+
+	/** Normalized error allowed on each axis of the inverse table nodes */
+	static float GetInverseTolerance();
+
+protected:
+
+	/** Solve the inverse table with Newton iterations */
+	static void SolveInverse(FFlareCockpitDistortionTables& Tables);
+
+	/** Normalized cockpit position of a normalized screen position, from the grid */
+	static FVector2D EvaluateGrid(const FFlareCockpitDistortionProfile& Profile, FVector2D Normalized);
+
+	/** Bilinear sample of a table, false if a sample is invalid */
+	static bool SampleTable(const FFlareCockpitDistortionTables& Tables, const TArray<FVector2D>& Table, FVector2D Normalized, FVector2D& Result);
+
+
+	/*----------------------------------------------------
+		Data
+	----------------------------------------------------*/
+
+	// Tables
+	TArray<FFlareCockpitDistortionTables>   BakedTables;
+	int32                                   CurrentTables;
+
+	// Resolution
+	FVector2D                               ScreenSize;
+	FVector2D                               CockpitSize;
+	float                                   ExtraHeight;
+
+};
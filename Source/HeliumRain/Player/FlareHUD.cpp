@@ -11,6 +11,9 @@
 
 #define LOCTEXT_NAMESPACE "FlareNavigationHUD"
 
+// Full designators drawn per frame, other spacecrafts get a marker
+#define HUD_MAX_FULL_DESIGNATORS      40
+
 
 /*----------------------------------------------------
 	Setup
@@ -21,6 +24,7 @@ AFlareHUD::AFlareHUD(const class FObjectInitializer& PCIP)
 	, CombatMouseRadius(100)
 	, HUDVisible(true)
 	, IsDrawingCockpit(false)
+	, IsBatchingIcons(false)
 {
 	// Load content (general icons)
 	static ConstructorHelpers::FObjectFinder<UTexture2D> HUDReticleIconObj         (TEXT("/Game/Gameplay/HUD/TX_Reticle.TX_Reticle"));
@@ -130,6 +134,9 @@ void AFlareHUD::BeginPlay()
 	HudColorObjective.A = Theme.DefaultAlpha;
 
 	Super::BeginPlay();
+
+	// Cockpit distortion
+	SetupCockpitDistortionProfiles();
 }
 
 void AFlareHUD::Setup(AFlareMenuManager* NewMenuManager)
@@ -322,6 +329,7 @@ void AFlareHUD::DrawCockpitHUD(UCanvas* TargetCanvas, int32 Width, int32 Height)
 		CurrentCanvas = TargetCanvas;
 		IsDrawingCockpit = true;
 		IsDrawingHUD = true;
+		UpdateCockpitDistortion();
 
 		if (HUDVisible && ShouldDrawHUD())
 		{
@@ -858,26 +866,51 @@ void AFlareHUD::DrawHUDInternal()
 		DrawHUDIconRotated(CurrentViewportSize / 2 + MousePosDelta, IconSize, HUDCombatMouseIcon, PointerColor, MousePosDelta3D.Rotation().Yaw);
 	}
 
-	// Iterate on all 'other' ships to show designators, markings, etc
+	// Cull all 'other' ships before drawing designators, markings, etc, but target them all
 	ScreenTargets.Empty();
 	ScreenTargetsOwner = PlayerShip->GetParent()->GetImmatriculation();
-	for (int SpacecraftIndex = 0; SpacecraftIndex < ActiveSector->GetSpacecrafts().Num(); SpacecraftIndex ++)
+	GatherDesignatorCandidates(PlayerShip);
+
+	for (int32 CandidateIndex = 0; CandidateIndex < DesignatorCandidates.Num(); CandidateIndex++)
 	{
-		AFlareSpacecraft* Spacecraft = ActiveSector->GetSpacecrafts()[SpacecraftIndex];
-		if (Spacecraft != PlayerShip)
+		const FFlareDesignatorCandidate& Candidate = DesignatorCandidates[CandidateIndex];
+		AFlareSpacecraft* Spacecraft = Candidate.Spacecraft;
+		bool ShouldDrawSearchMarker = Candidate.Alive;
+
+		if (Candidate.Projected)
 		{
-			// Draw designators
-			bool ShouldDrawSearchMarker = DrawHUDDesignator(Spacecraft);
-			DrawDockingHelper(Spacecraft);
+			// Add to targets, culled or not, so that target cycling sees every ship
+			FFlareScreenTarget TargetData;
+			TargetData.Spacecraft = Spacecraft;
+			TargetData.DistanceFromScreenCenter = (Candidate.ScreenPosition - CurrentViewportSize / 2).Size();
+			ScreenTargets.Add(TargetData);
 
-			// Draw search markers
-			if (!IsExternalCamera && ShouldDrawSearchMarker)
+			// Draw designators
+			if (Candidate.Alive)
 			{
-				bool Highlighted = (PlayerShip && Spacecraft == PlayerShip->GetCurrentTarget());
-				DrawSearchArrow(Spacecraft->GetActorLocation(), GetHostilityColor(PC, Spacecraft), Highlighted, FocusDistance);
+				if (Candidate.FullDesignator)
+				{
+					DrawHUDDesignator(Candidate);
+				}
+				else if (Candidate.InView)
+				{
+					DrawHUDDesignatorMarker(Candidate);
+				}
+
+				// Tell the HUD to draw the search marker only if we are outside this
+				ShouldDrawSearchMarker = !IsInScreen(Candidate.ScreenPosition);
 			}
 		}
+
+		DrawDockingHelper(Spacecraft);
+
+		// Draw search markers
+		if (!IsExternalCamera && ShouldDrawSearchMarker)
+		{
+			DrawSearchArrow(Candidate.Location, GetHostilityColor(PC, Spacecraft), Candidate.Highlighted, FocusDistance);
+		}
 	}
+	FlushIconBatches();
 
 	// Draw inertial vectors
 	FVector ShipSmoothedVelocity = PlayerShip->GetSmoothedLinearVelocity() * 100;
@@ -970,6 +1003,7 @@ void AFlareHUD::DrawHUDInternal()
 
 void AFlareHUD::DrawDebugGrid(FLinearColor Color)
 {
+	AFlarePlayerController* PC = Cast<AFlarePlayerController>(GetOwner());
 	float HPrecision = DistortionGrid;
 	float VPrecision = DistortionGrid;
 	
@@ -980,14 +1014,29 @@ void AFlareHUD::DrawDebugGrid(FLinearColor Color)
 
 			FVector2D Screen = FVector2D(0.5 * ViewportSize.X * ((VPrecision + VIndex) / VPrecision),
 										 0.5 * ViewportSize.Y * ((HPrecision + HIndex) / HPrecision));
-			FVector2D Cockpit = Screen;
-			if (!IsDrawingCockpit || ScreenToCockpit(Screen, Cockpit))
+			FVector2D Location = Screen;
+			bool Visible = true;
+
+			// Screen grid in the cockpit
+			if (IsDrawingCockpit)
+			{
+				Visible = ScreenToCockpit(Screen, Location);
+			}
+
+			// Cockpit grid on the screen, to tune the profile against the cockpit grid
+			else if (PC && PC->UseCockpit && CockpitDistortion.IsBaked())
+			{
+				FVector2D Cockpit = (Screen / ViewportSize) * CockpitDistortion.GetCockpitSize();
+				Visible = CockpitToScreen(Cockpit, Location);
+			}
+
+			if (Visible)
 			{
-				DrawHUDIcon(Cockpit, IconSize, HUDNoseIcon, Color, true);
+				DrawHUDIcon(Location, IconSize, HUDNoseIcon, Color, true);
 				FlareDrawText(FText::Format(LOCTEXT("GridLocation", "{0},{1}"),
 					FText::AsNumber(VIndex + VPrecision),
 					FText::AsNumber(HIndex + HPrecision)).ToString(),
-					Cockpit, Color, false, false);
+					Location, Color, false, false);
 			}
 		}
 	}
@@ -1071,117 +1120,244 @@ void AFlareHUD::DrawSearchArrow(FVector TargetLocation, FLinearColor Color, bool
 	}
 }
 
-bool AFlareHUD::DrawHUDDesignator(AFlareSpacecraft* Spacecraft)
+FFlareDesignatorView AFlareHUD::GetDesignatorView(FVector Origin, FRotator Rotation, float HorizontalFOV, FVector2D Viewport)
+{
+	// The cone goes through the corners of the viewport
+	float HorizontalTan = FMath::Tan(FMath::DegreesToRadians(HorizontalFOV / 2));
+	float VerticalTan = HorizontalTan * Viewport.Y / FMath::Max(Viewport.X, 1.f);
+	float HalfAngle = FMath::Min(FMath::Atan(FMath::Sqrt(HorizontalTan * HorizontalTan + VerticalTan * VerticalTan)), FMath::DegreesToRadians(89.f));
+
+	FFlareDesignatorView View;
+	View.Origin = Origin;
+	View.Direction = Rotation.Vector();
+	FMath::SinCos(&View.HalfAngleSin, &View.HalfAngleCos, HalfAngle);
+	return View;
+}
+
+void AFlareHUD::CullDesignatorCandidates(const FFlareDesignatorView& View, TArray<FFlareDesignatorCandidate>& Candidates)
+{
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
+	{
+		FFlareDesignatorCandidate& Candidate = Candidates[CandidateIndex];
+		FVector Offset = Candidate.Location - View.Origin;
+		Candidate.Distance = Offset.Size();
+		Candidate.Projected = false;
+		Candidate.FullDesignator = false;
+
+		// Inside the spacecraft
+		if (Candidate.Distance <= Candidate.Radius)
+		{
+			Candidate.InView = true;
+			continue;
+		}
+
+		// Widen the view cone by the apparent radius : cos(HalfAngle + asin(Radius / Distance))
+		float RadiusSin = Candidate.Radius / Candidate.Distance;
+		float RadiusCos = FMath::Sqrt(1 - RadiusSin * RadiusSin);
+		float ConeCos = View.HalfAngleCos * RadiusCos - View.HalfAngleSin * RadiusSin;
+
+		Candidate.InView = (FVector::DotProduct(Offset, View.Direction) >= ConeCos * Candidate.Distance);
+	}
+}
+
+void AFlareHUD::BudgetDesignatorCandidates(TArray<FFlareDesignatorCandidate>& Candidates, int32 MaxFullDesignators)
+{
+	TArray<FFlareDesignatorCandidate*> Ranking;
+	Ranking.Reserve(Candidates.Num());
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
+	{
+		FFlareDesignatorCandidate& Candidate = Candidates[CandidateIndex];
+		Candidate.FullDesignator = false;
+		if (Candidate.InView && Candidate.Projected && Candidate.Alive)
+		{
+			Ranking.Add(&Candidate);
+		}
+	}
+
+	// Everything fits
+	if (Ranking.Num() <= MaxFullDesignators)
+	{
+		for (int32 RankIndex = 0; RankIndex < Ranking.Num(); RankIndex++)
+		{
+			Ranking[RankIndex]->FullDesignator = true;
+		}
+		return;
+	}
+
+	Ranking.Sort([](const FFlareDesignatorCandidate& A, const FFlareDesignatorCandidate& B)
+	{
+		return A.Priority > B.Priority;
+	});
+
+	for (int32 RankIndex = 0; RankIndex < MaxFullDesignators; RankIndex++)
+	{
+		Ranking[RankIndex]->FullDesignator = true;
+	}
+}
+
+void AFlareHUD::GatherDesignatorCandidates(AFlareSpacecraft* PlayerShip)
 {
-	// Calculation data
-	FVector2D ScreenPosition;
 	AFlarePlayerController* PC = Cast<AFlarePlayerController>(GetOwner());
-	FVector PlayerLocation = PC->GetShipPawn()->GetActorLocation();
-	FVector TargetLocation = Spacecraft->GetActorLocation();
+	UFlareSector* ActiveSector = PC->GetGame()->GetActiveSector();
+	AFlareSpacecraft* PlayerTarget = PlayerShip->GetCurrentTarget();
 
-	if (ProjectWorldLocationToCockpit(TargetLocation, ScreenPosition) && Spacecraft != ContextMenuSpacecraft)
+	// Cheap data only
+	DesignatorCandidates.Reset();
+	for (int32 SpacecraftIndex = 0; SpacecraftIndex < ActiveSector->GetSpacecrafts().Num(); SpacecraftIndex++)
 	{
-		// Compute apparent size in screenspace
-		float ShipSize = 2 * Spacecraft->GetMeshScale();
-		float Distance = (TargetLocation - PlayerLocation).Size();
-		float ApparentAngle = FMath::RadiansToDegrees(FMath::Atan(ShipSize / Distance));
-		float Size = (ApparentAngle / PC->PlayerCameraManager->GetFOVAngle()) * CurrentViewportSize.X;
-		FVector2D ObjectSize = FMath::Min(0.66f * Size, 300.0f) * FVector2D(1, 1);
+		AFlareSpacecraft* Spacecraft = ActiveSector->GetSpacecrafts()[SpacecraftIndex];
+		if (Spacecraft == PlayerShip)
+		{
+			continue;
+		}
 
-		// Add to targets
-		FFlareScreenTarget TargetData;
-		TargetData.Spacecraft = Spacecraft;
-		TargetData.DistanceFromScreenCenter = (ScreenPosition - CurrentViewportSize / 2).Size();
-		ScreenTargets.Add(TargetData);
-		
-		// Draw the HUD designator
-		if (Spacecraft->GetParent()->GetDamageSystem()->IsAlive())
+		FFlareDesignatorCandidate Candidate;
+		Candidate.Spacecraft = Spacecraft;
+		Candidate.Location = Spacecraft->GetActorLocation();
+		Candidate.Radius = Spacecraft->GetMeshScale();
+		Candidate.Alive = Spacecraft->GetParent()->GetDamageSystem()->IsAlive();
+		Candidate.Highlighted = (Spacecraft == PlayerTarget);
+		Candidate.ScreenPosition = FVector2D::ZeroVector;
+		Candidate.Priority = 0;
+		DesignatorCandidates.Add(Candidate);
+	}
+
+	// Reject what can't be seen
+	FFlareDesignatorView View = GetDesignatorView(
+		PC->PlayerCameraManager->GetCameraLocation(),
+		PC->PlayerCameraManager->GetCameraRotation(),
+		PC->PlayerCameraManager->GetFOVAngle(),
+		CurrentViewportSize);
+	CullDesignatorCandidates(View, DesignatorCandidates);
+
+	// Project all of them for the screen targets, rank only the ones that will be drawn
+	for (int32 CandidateIndex = 0; CandidateIndex < DesignatorCandidates.Num(); CandidateIndex++)
+	{
+		FFlareDesignatorCandidate& Candidate = DesignatorCandidates[CandidateIndex];
+		if (Candidate.Spacecraft != ContextMenuSpacecraft)
+		{
+			Candidate.Projected = ProjectWorldLocationToCockpit(Candidate.Location, Candidate.ScreenPosition);
+		}
+
+		if (Candidate.InView && Candidate.Projected)
 		{
-			float CornerSize = 8;
-			AFlareSpacecraft* PlayerShip = PC->GetShipPawn();
-			FVector2D CenterPos = ScreenPosition - ObjectSize / 2;
-			FLinearColor Color = GetHostilityColor(PC, Spacecraft);
-
-			// Draw designator corners
-			bool Highlighted = (PlayerShip && Spacecraft == PlayerShip->GetCurrentTarget());
-			bool Dangerous = PilotHelper::IsShipDangerous(Spacecraft);
-			DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(-1, -1), 0,     Color, Dangerous, Highlighted);
-			DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(-1, +1), -90,   Color, Dangerous, Highlighted);
-			DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(+1, +1), -180,  Color, Dangerous, Highlighted);
-			DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(+1, -1), -270,  Color, Dangerous, Highlighted);
-
-			// Draw the target's distance if selected
-			if (Spacecraft == PlayerShip->GetCurrentTarget())
+			// Target first, then threats, then closest
+			Candidate.Priority = -Candidate.Distance;
+			if (Candidate.Highlighted)
 			{
-				FString DistanceText = FormatDistance(Distance / 100);
-				FVector2D DistanceTextPosition = ScreenPosition - (CurrentViewportSize / 2) + FVector2D(-ObjectSize.X / 2, ObjectSize.Y / 2) + 2 * CornerSize * FVector2D::UnitVector;
-				FlareDrawText(DistanceText, DistanceTextPosition, Color);
+				Candidate.Priority = MAX_FLT;
 			}
-
-			// Draw the status for close targets or highlighted
-			if (!Spacecraft->GetParent()->IsStation() && (ObjectSize.X > 0.15 * IconSize || Highlighted))
+			else if (Candidate.Spacecraft->GetParent()->GetPlayerWarState() == EFlareHostility::Hostile && PilotHelper::IsShipDangerous(Candidate.Spacecraft))
 			{
-				int32 NumberOfIcons = Spacecraft->GetParent()->IsMilitary() ? 3 : 2;
-				FVector2D StatusPos = CenterPos;
-				StatusPos.X += 0.5 * (ObjectSize.X - NumberOfIcons * IconSize);
-				StatusPos.Y -= (IconSize + 0.5 * CornerSize);
-				DrawHUDDesignatorStatus(StatusPos, IconSize, Spacecraft);
+				Candidate.Priority /= 4;
 			}
-			
-			// Combat helper
-			if (Spacecraft == PlayerShip->GetCurrentTarget()
-			 && Spacecraft->GetParent()->GetPlayerWarState() == EFlareHostility::Hostile
-			 && PlayerShip && PlayerShip->GetWeaponsSystem()->GetActiveWeaponType() != EFlareWeaponGroupType::WG_NONE)
+		}
+	}
+
+	BudgetDesignatorCandidates(DesignatorCandidates, HUD_MAX_FULL_DESIGNATORS);
+}
+
+void AFlareHUD::DrawHUDDesignator(const FFlareDesignatorCandidate& Candidate)
+{
+	// Calculation data
+	AFlareSpacecraft* Spacecraft = Candidate.Spacecraft;
+	FVector2D ScreenPosition = Candidate.ScreenPosition;
+	AFlarePlayerController* PC = Cast<AFlarePlayerController>(GetOwner());
+	FVector PlayerLocation = PC->GetShipPawn()->GetActorLocation();
+	FVector TargetLocation = Candidate.Location;
+
+	// Compute apparent size in screenspace
+	float ShipSize = 2 * Candidate.Radius;
+	float Distance = (TargetLocation - PlayerLocation).Size();
+	float ApparentAngle = FMath::RadiansToDegrees(FMath::Atan(ShipSize / Distance));
+	float Size = (ApparentAngle / PC->PlayerCameraManager->GetFOVAngle()) * CurrentViewportSize.X;
+	FVector2D ObjectSize = FMath::Min(0.66f * Size, 300.0f) * FVector2D(1, 1);
+
+	// Draw the HUD designator
+	float CornerSize = 8;
+	AFlareSpacecraft* PlayerShip = PC->GetShipPawn();
+	FVector2D CenterPos = ScreenPosition - ObjectSize / 2;
+	FLinearColor Color = GetHostilityColor(PC, Spacecraft);
+
+	// Draw designator corners
+	bool Highlighted = Candidate.Highlighted;
+	bool Dangerous = PilotHelper::IsShipDangerous(Spacecraft);
+	IsBatchingIcons = true;
+	DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(-1, -1), 0,     Color, Dangerous, Highlighted);
+	DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(-1, +1), -90,   Color, Dangerous, Highlighted);
+	DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(+1, +1), -180,  Color, Dangerous, Highlighted);
+	DrawHUDDesignatorCorner(ScreenPosition, ObjectSize, CornerSize, FVector2D(+1, -1), -270,  Color, Dangerous, Highlighted);
+	IsBatchingIcons = false;
+
+	// Draw the target's distance if selected
+	if (Spacecraft == PlayerShip->GetCurrentTarget())
+	{
+		FString DistanceText = FormatDistance(Distance / 100);
+		FVector2D DistanceTextPosition = ScreenPosition - (CurrentViewportSize / 2) + FVector2D(-ObjectSize.X / 2, ObjectSize.Y / 2) + 2 * CornerSize * FVector2D::UnitVector;
+		FlareDrawText(DistanceText, DistanceTextPosition, Color);
+	}
+
+	// Draw the status for close targets or highlighted
+	if (!Spacecraft->GetParent()->IsStation() && (ObjectSize.X > 0.15 * IconSize || Highlighted))
+	{
+		int32 NumberOfIcons = Spacecraft->GetParent()->IsMilitary() ? 3 : 2;
+		FVector2D StatusPos = CenterPos;
+		StatusPos.X += 0.5 * (ObjectSize.X - NumberOfIcons * IconSize);
+		StatusPos.Y -= (IconSize + 0.5 * CornerSize);
+		DrawHUDDesignatorStatus(StatusPos, IconSize, Spacecraft);
+	}
+	
+	// Combat helper
+	if (Spacecraft == PlayerShip->GetCurrentTarget()
+	 && Spacecraft->GetParent()->GetPlayerWarState() == EFlareHostility::Hostile
+	 && PlayerShip && PlayerShip->GetWeaponsSystem()->GetActiveWeaponType() != EFlareWeaponGroupType::WG_NONE)
+	{
+		FFlareWeaponGroup* WeaponGroup = PlayerShip->GetWeaponsSystem()->GetActiveWeaponGroup();
+		if (WeaponGroup)
+		{
+			float AmmoVelocity = WeaponGroup->Weapons[0]->GetAmmoVelocity();
+			FVector AmmoIntersectionLocation;
+			float InterceptTime = Spacecraft->GetAimPosition(PlayerShip, AmmoVelocity, 0.0, &AmmoIntersectionLocation);
+
+			if (InterceptTime > 0 && ProjectWorldLocationToCockpit(AmmoIntersectionLocation, ScreenPosition))
 			{
-				FFlareWeaponGroup* WeaponGroup = PlayerShip->GetWeaponsSystem()->GetActiveWeaponGroup();
-				if (WeaponGroup)
+				// Get some more data
+				FLinearColor HUDAimHelperColor = GetHostilityColor(PC, Spacecraft);
+				EFlareWeaponGroupType::Type WeaponType = PlayerShip->GetWeaponsSystem()->GetActiveWeaponType();
+				EFlareShellDamageType::Type DamageType = PlayerShip->GetWeaponsSystem()->GetActiveWeaponGroup()->Description->WeaponCharacteristics.DamageType;
+				bool FighterTargettingLarge = WeaponType == EFlareWeaponGroupType::WG_GUN && Spacecraft->GetParent()->GetSize() == EFlarePartSize::L;
+				bool BomberTargettingSmall = WeaponType == EFlareWeaponGroupType::WG_BOMB && Spacecraft->GetParent()->GetSize() == EFlarePartSize::S;
+				bool BomberTargettingLarge = WeaponType == EFlareWeaponGroupType::WG_BOMB && Spacecraft->GetParent()->GetSize() == EFlarePartSize::L;
+				bool Salvage = (DamageType == EFlareShellDamageType::LightSalvage || DamageType == EFlareShellDamageType::HeavySalvage);
+				bool AntiLarge = (DamageType == EFlareShellDamageType::HEAT);
+
+				// Draw helper if it makes sense
+				if (!(FighterTargettingLarge && !AntiLarge) && !(BomberTargettingSmall && ! Salvage))
 				{
-					float AmmoVelocity = WeaponGroup->Weapons[0]->GetAmmoVelocity();
-					FVector AmmoIntersectionLocation;
-					float InterceptTime = Spacecraft->GetAimPosition(PlayerShip, AmmoVelocity, 0.0, &AmmoIntersectionLocation);
-
-					if (InterceptTime > 0 && ProjectWorldLocationToCockpit(AmmoIntersectionLocation, ScreenPosition))
-					{
-						// Get some more data
-						FLinearColor HUDAimHelperColor = GetHostilityColor(PC, Spacecraft);
-						EFlareWeaponGroupType::Type WeaponType = PlayerShip->GetWeaponsSystem()->GetActiveWeaponType();
-						EFlareShellDamageType::Type DamageType = PlayerShip->GetWeaponsSystem()->GetActiveWeaponGroup()->Description->WeaponCharacteristics.DamageType;
-						bool FighterTargettingLarge = WeaponType == EFlareWeaponGroupType::WG_GUN && Spacecraft->GetParent()->GetSize() == EFlarePartSize::L;
-						bool BomberTargettingSmall = WeaponType == EFlareWeaponGroupType::WG_BOMB && Spacecraft->GetParent()->GetSize() == EFlarePartSize::S;
-						bool BomberTargettingLarge = WeaponType == EFlareWeaponGroupType::WG_BOMB && Spacecraft->GetParent()->GetSize() == EFlarePartSize::L;
-						bool Salvage = (DamageType == EFlareShellDamageType::LightSalvage || DamageType == EFlareShellDamageType::HeavySalvage);
-						bool AntiLarge = (DamageType == EFlareShellDamageType::HEAT);
-
-						// Draw helper if it makes sense
-						if (!(FighterTargettingLarge && !AntiLarge) && !(BomberTargettingSmall && ! Salvage))
-						{
-							DrawHUDIcon(ScreenPosition, IconSize, HUDAimHelperIcon, HUDAimHelperColor, true);
-						}
+					DrawHUDIcon(ScreenPosition, IconSize, HUDAimHelperIcon, HUDAimHelperColor, true);
+				}
 
-						// Bomber UI
-						if (BomberTargettingLarge || (BomberTargettingSmall && Salvage))
-						{
-							// Time display
-							FString TimeText = FString::FromInt(InterceptTime) + FString(".") + FString::FromInt( (InterceptTime - (int) InterceptTime ) *10) + FString(" s");
-							FVector2D TimePosition = ScreenPosition - CurrentViewportSize / 2 - FVector2D(42,0);
-							FlareDrawText(TimeText, TimePosition, HUDAimHelperColor);
-						}
-					}
+				// Bomber UI
+				if (BomberTargettingLarge || (BomberTargettingSmall && Salvage))
+				{
+					// Time display
+					FString TimeText = FString::FromInt(InterceptTime) + FString(".") + FString::FromInt( (InterceptTime - (int) InterceptTime ) *10) + FString(" s");
+					FVector2D TimePosition = ScreenPosition - CurrentViewportSize / 2 - FVector2D(42,0);
+					FlareDrawText(TimeText, TimePosition, HUDAimHelperColor);
 				}
 			}
-
-			// Tell the HUD to draw the search marker only if we are outside this
-			return !IsInScreen(ScreenPosition);
 		}
 	}
+}
 
-	// Dead ship
-	if (!Spacecraft->GetParent()->GetDamageSystem()->IsAlive())
-	{
-		return false;
-	}
+void AFlareHUD::DrawHUDDesignatorMarker(const FFlareDesignatorCandidate& Candidate)
+{
+	AFlarePlayerController* PC = Cast<AFlarePlayerController>(GetOwner());
+	float CornerSize = 8;
 
-	return true;
+	IsBatchingIcons = true;
+	DrawHUDIcon(Candidate.ScreenPosition, CornerSize, HUDDesignatorCornerTexture, GetHostilityColor(PC, Candidate.Spacecraft), true);
+	IsBatchingIcons = false;
 }
 
 void AFlareHUD::DrawHUDDesignatorCorner(FVector2D Position, FVector2D ObjectSize, float DesignatorIconSize, FVector2D MainOffset, float Rotation, FLinearColor HudColor, bool Dangerous, bool Highlighted)
@@ -1370,6 +1546,9 @@ void AFlareHUD::FlareDrawText(FString Text, FVector2D Position, FLinearColor Col
 {
 	if (CurrentCanvas)
 	{
+		// Text goes over the icons batched before it
+		FlushIconBatches();
+
 		float X, Y;
 		UFont* Font = NULL;
 		
@@ -1431,8 +1610,20 @@ void AFlareHUD::FlareDrawText(FString Text, FVector2D Position, FLinearColor Col
 
 void AFlareHUD::FlareDrawTexture(UTexture* Texture, float ScreenX, float ScreenY, float ScreenW, float ScreenH, float TextureU, float TextureV, float TextureUWidth, float TextureVHeight, FLinearColor Color, EBlendMode BlendMode, float Scale, bool bScalePosition, float Rotation, FVector2D RotPivot)
 {
-	if (CurrentCanvas && Texture)
+	if (CurrentCanvas && Texture && IsBatchingIcons)
+	{
+		if (bScalePosition)
+		{
+			ScreenX *= Scale;
+			ScreenY *= Scale;
+		}
+		AddBatchedIcon(Texture, ScreenX, ScreenY, ScreenW * Scale, ScreenH * Scale, TextureU, TextureV, TextureUWidth, TextureVHeight, Color, BlendMode, Rotation, RotPivot);
+	}
+	else if (CurrentCanvas && Texture)
 	{
+		// Keep the draw order with the icons batched before this one
+		FlushIconBatches();
+
 		// Setup texture (in dark)
 		FCanvasTileItem TileItem(FVector2D(ScreenX, ScreenY),
 			Texture->Resource,
@@ -1456,6 +1647,77 @@ void AFlareHUD::FlareDrawTexture(UTexture* Texture, float ScreenX, float ScreenY
 	}
 }
 
+void AFlareHUD::AddBatchedIcon(UTexture* Texture, float ScreenX, float ScreenY, float ScreenW, float ScreenH, float TextureU, float TextureV, float TextureUWidth, float TextureVHeight, FLinearColor Color, EBlendMode BlendMode, float Rotation, FVector2D RotPivot)
+{
+	// Find the batch
+	FFlareHUDIconBatch* Batch = NULL;
+	for (int32 BatchIndex = 0; BatchIndex < IconBatches.Num(); BatchIndex++)
+	{
+		if (IconBatches[BatchIndex].Texture == Texture && IconBatches[BatchIndex].BlendMode == BlendMode)
+		{
+			Batch = &IconBatches[BatchIndex];
+			break;
+		}
+	}
+	if (!Batch)
+	{
+		Batch = &IconBatches[IconBatches.AddDefaulted()];
+		Batch->Texture = Texture;
+		Batch->BlendMode = BlendMode;
+	}
+
+	// Rotate the corners like a canvas tile does, around the pivot
+	FVector2D Position(ScreenX, ScreenY);
+	FVector2D Size(ScreenW, ScreenH);
+	FVector2D Pivot = Position + Size * RotPivot;
+	float RotationSin, RotationCos;
+	FMath::SinCos(&RotationSin, &RotationCos, FMath::DegreesToRadians(Rotation));
+
+	FVector2D Corners[4] = { FVector2D(0, 0), FVector2D(1, 0), FVector2D(1, 1), FVector2D(0, 1) };
+	FVector2D Positions[4];
+	FVector2D UVs[4];
+	for (int32 CornerIndex = 0; CornerIndex < 4; CornerIndex++)
+	{
+		FVector2D Offset = Position + Size * Corners[CornerIndex] - Pivot;
+		Positions[CornerIndex] = Pivot + FVector2D(Offset.X * RotationCos - Offset.Y * RotationSin, Offset.X * RotationSin + Offset.Y * RotationCos);
+		UVs[CornerIndex] = FVector2D(TextureU, TextureV) + FVector2D(TextureUWidth, TextureVHeight) * Corners[CornerIndex];
+	}
+
+	// Two triangles
+	const int32 TriangleCorners[2][3] = { { 0, 1, 2 }, { 0, 2, 3 } };
+	for (int32 TriangleIndex = 0; TriangleIndex < 2; TriangleIndex++)
+	{
+		FCanvasUVTri Triangle;
+		Triangle.V0_Pos = Positions[TriangleCorners[TriangleIndex][0]];
+		Triangle.V1_Pos = Positions[TriangleCorners[TriangleIndex][1]];
+		Triangle.V2_Pos = Positions[TriangleCorners[TriangleIndex][2]];
+		Triangle.V0_UV = UVs[TriangleCorners[TriangleIndex][0]];
+		Triangle.V1_UV = UVs[TriangleCorners[TriangleIndex][1]];
+		Triangle.V2_UV = UVs[TriangleCorners[TriangleIndex][2]];
+		Triangle.V0_Color = Color;
+		Triangle.V1_Color = Color;
+		Triangle.V2_Color = Color;
+		Batch->Triangles.Add(Triangle);
+	}
+}
+
+void AFlareHUD::FlushIconBatches()
+{
+	for (int32 BatchIndex = 0; BatchIndex < IconBatches.Num(); BatchIndex++)
+	{
+		FFlareHUDIconBatch& Batch = IconBatches[BatchIndex];
+		if (CurrentCanvas && Batch.Texture && Batch.Texture->Resource && Batch.Triangles.Num())
+		{
+			FCanvasTriangleItem TriangleItem(Batch.Triangles, Batch.Texture->Resource);
+			TriangleItem.BlendMode = FCanvas::BlendToSimpleElementBlend(Batch.BlendMode);
+			CurrentCanvas->DrawItem(TriangleItem);
+		}
+
+		// Keep the memory for the next frame
+		Batch.Triangles.Reset();
+	}
+}
+
 bool AFlareHUD::IsInScreen(FVector2D ScreenPosition) const
 {
 	int32 ScreenBorderDistance = 100;
@@ -1588,88 +1850,115 @@ bool AFlareHUD::IsFlyingMilitaryShip() const
 	return false;
 }
 
-float* AFlareHUD::GetCurrentHorizontalGrid() const
+void AFlareHUD::SetupCockpitDistortionProfiles()
 {
-	return IsFlyingMilitaryShip() ? FighterHorizontalDistortionMap : FreighterHorizontalDistortionMap;
-}
+	FighterDistortionProfile.Identifier = FName("Fighter");
+	FighterDistortionProfile.Width = GRID_H_SIZE;
+	FighterDistortionProfile.Height = GRID_V_SIZE;
+	FighterDistortionProfile.HorizontalGrid.Empty();
+	FighterDistortionProfile.HorizontalGrid.Append(FighterHorizontalDistortionMap, ARRAY_COUNT(FighterHorizontalDistortionMap));
+	FighterDistortionProfile.VerticalGrid.Empty();
+	FighterDistortionProfile.VerticalGrid.Append(FighterVerticalDistortionMap, ARRAY_COUNT(FighterVerticalDistortionMap));
+
+	FreighterDistortionProfile.Identifier = FName("Freighter");
+	FreighterDistortionProfile.Width = GRID_H_SIZE;
+	FreighterDistortionProfile.Height = GRID_V_SIZE;
+	FreighterDistortionProfile.HorizontalGrid.Empty();
+	FreighterDistortionProfile.HorizontalGrid.Append(FreighterHorizontalDistortionMap, ARRAY_COUNT(FreighterHorizontalDistortionMap));
+	FreighterDistortionProfile.VerticalGrid.Empty();
+	FreighterDistortionProfile.VerticalGrid.Append(FreighterVerticalDistortionMap, ARRAY_COUNT(FreighterVerticalDistortionMap));
+
+	for (int32 ProfileIndex = 0; ProfileIndex < CockpitDistortionProfiles.Num(); ProfileIndex++)
+	{
+		if (!CockpitDistortionProfiles[ProfileIndex].IsValid())
+		{
+			FLOGV("AFlareHUD::SetupCockpitDistortionProfiles : ignoring invalid profile '%s'", *CockpitDistortionProfiles[ProfileIndex].Identifier.ToString());
+		}
+	}
 
-float* AFlareHUD::GetCurrentVerticalGrid() const
-{
-	return IsFlyingMilitaryShip() ? FighterVerticalDistortionMap : FreighterVerticalDistortionMap;
+	CockpitDistortion.Reset();
 }
 
-void AFlareHUD::SetDistortion(uint32 Axis, uint32 X, uint32 Y, float Value)
+TArray<const FFlareCockpitDistortionProfile*> AFlareHUD::GetCockpitDistortionProfiles() const
 {
-	if (X < GRID_H_SIZE && Y < GRID_V_SIZE)
+	TArray<const FFlareCockpitDistortionProfile*> Profiles;
+	Profiles.Add(&FighterDistortionProfile);
+	Profiles.Add(&FreighterDistortionProfile);
+
+	for (int32 ProfileIndex = 0; ProfileIndex < CockpitDistortionProfiles.Num(); ProfileIndex++)
 	{
-		if (Axis == 0)
-		{
-			GetCurrentHorizontalGrid()[X  + Y * GRID_H_SIZE] = Value;
-		}
-		else
+		if (CockpitDistortionProfiles[ProfileIndex].IsValid())
 		{
-			GetCurrentVerticalGrid()[X + Y * GRID_V_SIZE] = Value;
+			Profiles.Add(&CockpitDistortionProfiles[ProfileIndex]);
 		}
 	}
+
+	return Profiles;
 }
 
-bool AFlareHUD::ScreenToCockpit(FVector2D Screen, FVector2D& Cockpit)
+FFlareCockpitDistortionProfile* AFlareHUD::GetCurrentDistortionProfile()
 {
-	float AspectRatio = CurrentViewportSize.X/CurrentViewportSize.Y;
-	float ExtraHeight = ViewportSize.Y - ViewportSize.X / AspectRatio;
-
-	// Find for near point of the map
-	float XRelativeLocation = (Screen.X / ViewportSize.X)  * (GRID_H_SIZE - 1);
-	float YRelativeLocation = (Screen.Y - (ExtraHeight / 2)) / (ViewportSize.Y - ExtraHeight) * (GRID_V_SIZE - 1);
-	
-	//FLOGV("Screen=%s XRelativeLocation=%f YRelativeLocation=%f AspectRatio=%f ExtraHeight=%f", *Screen.ToString(), XRelativeLocation, YRelativeLocation, AspectRatio, ExtraHeight);
+	AFlarePlayerController* PC = MenuManager->GetPC();
 
-	if(XRelativeLocation < 0.f || XRelativeLocation > (GRID_H_SIZE - 1) || YRelativeLocation < 0.f || YRelativeLocation > (GRID_V_SIZE - 1))
+	// Profile for this ship class
+	if (PC && PC->GetPlayerShip())
 	{
-		return false;
+		FName ShipClass = PC->GetPlayerShip()->GetDescription()->Identifier;
+		for (int32 ProfileIndex = 0; ProfileIndex < CockpitDistortionProfiles.Num(); ProfileIndex++)
+		{
+			if (CockpitDistortionProfiles[ProfileIndex].Identifier == ShipClass && CockpitDistortionProfiles[ProfileIndex].IsValid())
+			{
+				return &CockpitDistortionProfiles[ProfileIndex];
+			}
+		}
 	}
 
-	int32 LeftIndex = FMath::FloorToInt(XRelativeLocation);
-	int32 RightIndex = FMath::CeilToInt(XRelativeLocation);
-	int32 TopIndex = FMath::FloorToInt(YRelativeLocation);
-	int32 BottomIndex = FMath::CeilToInt(YRelativeLocation);
+	return IsFlyingMilitaryShip() ? &FighterDistortionProfile : &FreighterDistortionProfile;
+}
 
-	float LocalX = XRelativeLocation - LeftIndex;
-	float LocalY = YRelativeLocation - TopIndex;
-	
-	float TopLeftXDistorsion = GetCurrentHorizontalGrid()[LeftIndex + TopIndex * GRID_H_SIZE];
-	float TopRightXDistorsion = GetCurrentHorizontalGrid()[RightIndex + TopIndex * GRID_H_SIZE];
-	float BottomLeftXDistorsion = GetCurrentHorizontalGrid()[LeftIndex + BottomIndex * GRID_H_SIZE];
-	float BottomRightXDistorsion = GetCurrentHorizontalGrid()[RightIndex + BottomIndex * GRID_H_SIZE];
-	
-	float TopMeanXDistorsion = LocalX * TopRightXDistorsion +  (1 - LocalX) * TopLeftXDistorsion;
-	float BottomMeanXDistorsion = LocalX * BottomRightXDistorsion +  (1 - LocalX) * BottomLeftXDistorsion;
-	float MeanXDistorsion = LocalY * BottomMeanXDistorsion +  (1 - LocalY) * TopMeanXDistorsion;
-
-	float TopLeftYDistorsion = GetCurrentVerticalGrid()[LeftIndex + TopIndex * GRID_V_SIZE];
-	float TopRightYDistorsion = GetCurrentVerticalGrid()[RightIndex + TopIndex * GRID_V_SIZE];
-	float BottomLeftYDistorsion = GetCurrentVerticalGrid()[LeftIndex + BottomIndex * GRID_V_SIZE];
-	float BottomRightYDistorsion = GetCurrentVerticalGrid()[RightIndex + BottomIndex * GRID_V_SIZE];
-	
-	float TopMeanYDistorsion = LocalX * TopRightYDistorsion +  (1 - LocalX) * TopLeftYDistorsion;
-	float BottomMeanYDistorsion = LocalX * BottomRightYDistorsion +  (1 - LocalX) * BottomLeftYDistorsion;
-	float MeanYDistorsion = LocalY * BottomMeanYDistorsion +  (1 - LocalY) * TopMeanYDistorsion;
-	
-	Cockpit = FVector2D(XRelativeLocation / (GRID_H_SIZE - 1) * MeanXDistorsion * CurrentViewportSize.X,
-						YRelativeLocation / (GRID_H_SIZE - 1) * MeanYDistorsion * CurrentViewportSize.Y);
+void AFlareHUD::UpdateCockpitDistortion()
+{
+	FFlareCockpitDistortionProfile* Profile = GetCurrentDistortionProfile();
 
-	//FLOGV("Cockpit=%s MeanXDistorsion=%f MeanYDistorsion=%f", *Cockpit.ToString(), MeanXDistorsion, MeanYDistorsion);
-	
-	if (Cockpit.X < 0.f || Cockpit.X > CurrentViewportSize.X || Cockpit.Y < 0.f || Cockpit.Y > CurrentViewportSize.Y)
+	if (!CockpitDistortion.IsBaked() || CockpitDistortion.GetBakedProfile() != Profile)
 	{
-		return false;
+		CockpitDistortion.Bake(*Profile);
 	}
-	else
+
+	if (CockpitDistortion.GetScreenSize() != ViewportSize || CockpitDistortion.GetCockpitSize() != CurrentViewportSize)
 	{
-		return true;
+		CockpitDistortion.SetResolution(ViewportSize, CurrentViewportSize);
+	}
+}
+
+void AFlareHUD::SetDistortion(uint32 Axis, uint32 X, uint32 Y, float Value)
+{
+	FFlareCockpitDistortionProfile* Profile = GetCurrentDistortionProfile();
+
+	if (X < (uint32) Profile->Width && Y < (uint32) Profile->Height)
+	{
+		if (Axis == 0)
+		{
+			Profile->HorizontalGrid[X + Y * Profile->Width] = Value;
+		}
+		else
+		{
+			Profile->VerticalGrid[X + Y * Profile->Width] = Value;
+		}
+
+		CockpitDistortion.Invalidate(*Profile);
 	}
 }
 
+bool AFlareHUD::ScreenToCockpit(FVector2D Screen, FVector2D& Cockpit)
+{
+	return CockpitDistortion.ScreenToCockpit(Screen, Cockpit);
+}
+
+bool AFlareHUD::CockpitToScreen(FVector2D Cockpit, FVector2D& Screen)
+{
+	return CockpitDistortion.CockpitToScreen(Cockpit, Screen);
+}
 
 
 #undef LOCTEXT_NAMESPACE
@@ -4,6 +4,7 @@
 #include "FlareMenuManager.h"
 #include "../UI/HUD/FlareHUDMenu.h"
 #include "../UI/HUD/FlareContextMenu.h"
+#include "FlareCockpitDistortion.h"
 #include "FlareHUD.generated.h"
 
 
@@ -24,9 +25,49 @@ struct FFlareScreenTarget
 
 };
 
+/** Spacecraft considered for a designator, gathered before any canvas work */
+struct FFlareDesignatorCandidate
+{
+	AFlareSpacecraft*      Spacecraft;
+
+	FVector                Location;
+	float                  Radius;
+	float                  Distance;
+	float                  Priority;
+	bool                   Alive;
+	bool                   Highlighted;
+
+	/** Inside the view cone, worth drawing */
+	bool                   InView;
+
+	/** Projected to the cockpit or screen, a screen target even when culled */
+	bool                   Projected;
+	FVector2D              ScreenPosition;
+
+	/** Within the budget of full designators, a marker is drawn otherwise */
+	bool                   FullDesignator;
+};
+
+/** View cone used to reject designator candidates without projecting them */
+struct FFlareDesignatorView
+{
+	FVector                Origin;
+	FVector                Direction;
+	float                  HalfAngleCos;
+	float                  HalfAngleSin;
+};
+
+/** Icons sharing a texture, submitted as a single canvas item */
+struct FFlareHUDIconBatch
+{
+	UTexture*              Texture;
+	EBlendMode             BlendMode;
+	TArray<FCanvasUVTri>   Triangles;
+};
+
 
 /** Navigation HUD */
-UCLASS()
+UCLASS(Config = Game)
 class HELIUMRAIN_API AFlareHUD : public AHUD
 {
 public:
@@ -131,9 +172,21 @@ public:
 	/** Change a distortion value */
 	void SetDistortion(uint32 Axis, uint32 X, uint32 Y, float Value);
 
+	/** Get the built-in and configured distortion profiles */
+	TArray<const FFlareCockpitDistortionProfile*> GetCockpitDistortionProfiles() const;
+
 	/** Format a distance in meter */
 	static FString FormatDistance(float Distance);
 
+	/** Get the cone bounding a camera view */
+	static FFlareDesignatorView GetDesignatorView(FVector Origin, FRotator Rotation, float HorizontalFOV, FVector2D Viewport);
+
+	/** Flag the candidates inside the view, computing their distance */
+	static void CullDesignatorCandidates(const FFlareDesignatorView& View, TArray<FFlareDesignatorCandidate>& Candidates);
+
+	/** Give full designators to the projected candidates with the highest priority */
+	static void BudgetDesignatorCandidates(TArray<FFlareDesignatorCandidate>& Candidates, int32 MaxFullDesignators);
+
 
 	/*----------------------------------------------------
 		Internals
@@ -156,8 +209,14 @@ protected:
 	/** Draw a search arrow */
 	void DrawSearchArrow(FVector TargetLocation, FLinearColor Color, bool Highlighted, float MaxDistance = 10000000);
 
+	/** Collect the spacecrafts of the sector and cull them */
+	void GatherDesignatorCandidates(AFlareSpacecraft* PlayerShip);
+
 	/** Draw a designator block around a spacecraft */
-	bool DrawHUDDesignator(AFlareSpacecraft* Spacecraft);
+	void DrawHUDDesignator(const FFlareDesignatorCandidate& Candidate);
+
+	/** Draw a cheap marker on a spacecraft over the designator budget */
+	void DrawHUDDesignatorMarker(const FFlareDesignatorCandidate& Candidate);
 
 	/** Draw a designator corner */
 	void DrawHUDDesignatorCorner(FVector2D Position, FVector2D ObjectSize, float IconSize, FVector2D MainOffset, float Rotation, FLinearColor HudColor, bool Dangerous, bool Highlighted);
@@ -183,6 +242,12 @@ protected:
 	/** Draw a texture */
 	void FlareDrawTexture(UTexture* Texture, float ScreenX, float ScreenY, float ScreenW, float ScreenH, float TextureU, float TextureV, float TextureUWidth, float TextureVHeight, FLinearColor TintColor = FLinearColor::White, EBlendMode BlendMode = BLEND_Translucent, float Scale = 1.f, bool bScalePosition = false, float Rotation = 0.f, FVector2D RotPivot = FVector2D::ZeroVector);
 
+	/** Queue a texture quad to the icon batches */
+	void AddBatchedIcon(UTexture* Texture, float ScreenX, float ScreenY, float ScreenW, float ScreenH, float TextureU, float TextureV, float TextureUWidth, float TextureVHeight, FLinearColor Color, EBlendMode BlendMode, float Rotation, FVector2D RotPivot);
+
+	/** Submit the queued icons */
+	void FlushIconBatches();
+
 	/** Is this position inside the viewport + border */
 	bool IsInScreen(FVector2D ScreenPosition) const;
 
@@ -192,11 +257,14 @@ protected:
 	/** Is the player flying a military ship */
 	bool IsFlyingMilitaryShip() const;
 	
-	/** Get the distortion grid */
-	float* GetCurrentHorizontalGrid() const;
+	/** Fill the built-in distortion profiles */
+	void SetupCockpitDistortionProfiles();
+
+	/** Get the distortion profile of the current ship */
+	FFlareCockpitDistortionProfile* GetCurrentDistortionProfile();
 
-	/** Get the distortion grid */
-	float* GetCurrentVerticalGrid() const;
+	/** Bake the distortion when the ship or resolution changed */
+	void UpdateCockpitDistortion();
 	
 	/** Convert a world location to cockpit-space */
 	bool ProjectWorldLocationToCockpit(FVector World, FVector2D& Cockpit);
@@ -204,6 +272,9 @@ protected:
 	/** Convert a screen location to cockpit-space */
 	bool ScreenToCockpit(FVector2D Screen, FVector2D& Cockpit);
 
+	/** Convert a cockpit-space location to the screen */
+	bool CockpitToScreen(FVector2D Cockpit, FVector2D& Screen);
+
 
 protected:
 
@@ -230,6 +301,11 @@ protected:
 	TArray<FFlareScreenTarget>              ScreenTargets;
 	FName									ScreenTargetsOwner;
 
+	// Designator pipeline, kept between frames to reuse memory
+	TArray<FFlareDesignatorCandidate>       DesignatorCandidates;
+	TArray<FFlareHUDIconBatch>              IconBatches;
+	bool                                    IsBatchingIcons;
+
 	// General data
 	bool                                    HUDVisible;
 	bool                                    IsInteractive;
@@ -298,6 +374,13 @@ protected:
 	TSharedPtr<SFlareContextMenu>           ContextMenu;
 	FVector2D                               ContextMenuPosition;
 
+	// Cockpit distortion, profiles can be added in the game config
+	UPROPERTY(Config)
+	TArray<FFlareCockpitDistortionProfile>  CockpitDistortionProfiles;
+	FFlareCockpitDistortionProfile          FighterDistortionProfile;
+	FFlareCockpitDistortionProfile          FreighterDistortionProfile;
+	FFlareCockpitDistortion                 CockpitDistortion;
+
 	// Debug
 	uint32                                  DistortionGrid;
 
@@ -0,0 +1,141 @@
+
+#include "../Flare.h"
+#include "FlareNotificationService.h"
+
+
+/*----------------------------------------------------
+	Setup
+----------------------------------------------------*/
+
+FFlareNotificationService::FFlareNotificationService()
+{
+}
+
+void FFlareNotificationService::SetCategory(FName Tag, FText SummaryFormat, float Interval)
+{
+	FFlareNotificationCategory Category;
+	Category.SummaryFormat = SummaryFormat;
+	Category.Interval = Interval;
+	Categories.Add(Tag, Category);
+}
+
+void FFlareNotificationService::Load(const TArray<FFlareNotificationRecordSave>& SavedHistory)
+{
+	Reset();
+	History = SavedHistory;
+}
+
+void FFlareNotificationService::Reset()
+{
+	History.Empty();
+	PendingTags.Empty();
+}
+
+
+/*----------------------------------------------------
+	Events
+----------------------------------------------------*/
+
+void FFlareNotificationService::Push(const FFlareNotificationEvent& Event, int64 Date, double Time, TArray<FFlareNotificationEvent>& Output)
+{
+	FFlareNotificationRecordSave Record;
+	Record.Date = Date;
+	Record.Tag = Event.Tag;
+	Record.Type = Event.Type;
+	Record.Text = Event.Text;
+	Record.Info = Event.Info;
+	History.Add(Record);
+
+	// Only registered tags are aggregated, others and pinned notifications are always shown
+	const FFlareNotificationCategory* Category = Categories.Find(Event.Tag);
+	if (!Category || Event.Pinned || Category->Interval <= 0)
+	{
+		Output.Add(Event);
+		return;
+	}
+
+	// Show the first event of a tag, then wait for the interval to end
+	PendingNotifications* Pending = PendingTags.Find(Event.Tag);
+	if (!Pending)
+	{
+		PendingNotifications NewPending;
+		NewPending.LastShownTime = Time;
+		NewPending.Count = 0;
+		PendingTags.Add(Event.Tag, NewPending);
+		Output.Add(Event);
+	}
+	else if (Pending->Count == 0 && Time - Pending->LastShownTime >= Category->Interval)
+	{
+		Pending->LastShownTime = Time;
+		Output.Add(Event);
+	}
+	else
+	{
+		Pending->LastEvent = Event;
+		Pending->Count++;
+	}
+}
+
+void FFlareNotificationService::Update(double Time, TArray<FFlareNotificationEvent>& Output)
+{
+	for (auto& Entry : PendingTags)
+	{
+		PendingNotifications& Pending = Entry.Value;
+		if (Pending.Count == 0)
+		{
+			continue;
+		}
+
+		const FFlareNotificationCategory* Category = Categories.Find(Entry.Key);
+		if (Time - Pending.LastShownTime >= Category->Interval)
+		{
+			Output.Add(Summarize(Pending));
+			Pending.LastShownTime = Time;
+			Pending.Count = 0;
+		}
+	}
+}
+
+void FFlareNotificationService::Flush()
+{
+	PendingTags.Empty();
+}
+
+FFlareNotificationEvent FFlareNotificationService::Summarize(const PendingNotifications& Pending) const
+{
+	FFlareNotificationEvent Summary = Pending.LastEvent;
+	if (Pending.Count == 1)
+	{
+		return Summary;
+	}
+
+	const FFlareNotificationCategory* Category = Categories.Find(Summary.Tag);
+
+	// A summary targets no single object
+	Summary.Text = FText::Format(Category->SummaryFormat, FText::AsNumber(Pending.Count), Pending.LastEvent.Text);
+	Summary.TargetMenu = EFlareMenu::MENU_None;
+	Summary.TargetInfo = FFlareMenuParameterData();
+	Summary.Count = Pending.Count;
+
+	return Summary;
+}
+
+
+/*----------------------------------------------------
+	History
+----------------------------------------------------*/
+
+void FFlareNotificationService::Search(const FString& Query, TArray<const FFlareNotificationRecordSave*>& Results) const
+{
+	for (int32 Index = 0; Index < History.Num(); Index++)
+	{
+		const FFlareNotificationRecordSave& Record = History[Index];
+		if (Record.Text.ToString().Contains(Query)
+		 || Record.Info.ToString().Contains(Query)
+		 || Record.Tag.ToString().Contains(Query))
+		{
+			Results.Add(&Record);
+		}
+	}
+}
+
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "../Flare.h"
+#include "../UI/Components/FlareNotification.h"
+#include "FlareNotificationService.generated.h"
+
+
+/** Default time between two notifications of the same tag, in seconds */
+#define NOTIFICATION_DEFAULT_INTERVAL 1.0f
+
+
+/** Notification history entry */
+USTRUCT()
+struct FFlareNotificationRecordSave
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Game date */
+	UPROPERTY(EditAnywhere, Category = Save)
+	int64 Date;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	FName Tag;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	TEnumAsByte<EFlareNotification::Type> Type;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	FText Text;
+
+	UPROPERTY(EditAnywhere, Category = Save)
+	FText Info;
+};
+
+/** Notification sent by the game, or summary of several of them */
+struct FFlareNotificationEvent
+{
+	FFlareNotificationEvent()
+		: Type(EFlareNotification::NT_Info)
+		, Pinned(false)
+		, TargetMenu(EFlareMenu::MENU_None)
+		, Count(1)
+	{}
+
+	FText                                      Text;
+	FText                                      Info;
+	FName                                      Tag;
+	EFlareNotification::Type                   Type;
+	bool                                       Pinned;
+	EFlareMenu::Type                           TargetMenu;
+	FFlareMenuParameterData                    TargetInfo;
+
+	/** Number of events in this notification */
+	int32                                      Count;
+};
+
+/** Aggregation settings of a notification tag */
+struct FFlareNotificationCategory
+{
+	/** Summary text, {0} is the event count and {1} the last event text */
+	FText                                      SummaryFormat;
+
+	/** Minimum time between two notifications, 0 to show all */
+	float                                      Interval;
+};
+
+
+/** Notification service between the game and the notifier.
+ *  Coalesces events of a registered tag into summaries, rate-limits each registered tag, and logs every event.
+ *  Times are in game seconds, so that summaries wait while the game is paused.
+ */
+class FFlareNotificationService
+{
+public:
+
+	/*----------------------------------------------------
+		Setup
+	----------------------------------------------------*/
+
+	FFlareNotificationService();
+
+	/** Set how the events of a tag are aggregated, events of other tags are shown as they come */
+	void SetCategory(FName Tag, FText SummaryFormat, float Interval = NOTIFICATION_DEFAULT_INTERVAL);
+
+	/** Load the history */
+	void Load(const TArray<FFlareNotificationRecordSave>& SavedHistory);
+
+	/** Forget the history and the pending events */
+	void Reset();
+
+
+	/*----------------------------------------------------
+		Events
+	----------------------------------------------------*/
+
+	/** Log an event, and add the notifications to show now to Output */
+	void Push(const FFlareNotificationEvent& Event, int64 Date, double Time, TArray<FFlareNotificationEvent>& Output);
+
+	/** Add the summaries that are due to Output */
+	void Update(double Time, TArray<FFlareNotificationEvent>& Output);
+
+	/** Drop the pending events */
+	void Flush();
+
+
+	/*----------------------------------------------------
+		History
+	----------------------------------------------------*/
+
+	/** Find the history entries whose text, info or tag contain Query */
+	void Search(const FString& Query, TArray<const FFlareNotificationRecordSave*>& Results) const;
+
+	inline const TArray<FFlareNotificationRecordSave>& GetHistory() const
+	{
+		return History;
+	}
+
+
+protected:
+
+	/** Events of a tag waiting for the end of its interval */
+	struct PendingNotifications
+	{
+		double                                 LastShownTime;
+		FFlareNotificationEvent                LastEvent;
+		int32                                  Count;
+	};
+
+	/** Get the notification for the pending events of a tag */
+	FFlareNotificationEvent Summarize(const PendingNotifications& Pending) const;
+
+	/*----------------------------------------------------
+		Data
+	----------------------------------------------------*/
+
+	TMap<FName, FFlareNotificationCategory>    Categories;
+	TMap<FName, PendingNotifications>          PendingTags;
+	TArray<FFlareNotificationRecordSave>       History;
+
+};
@@ -44,6 +44,15 @@ AFlarePlayerController::AFlarePlayerController(const class FObjectInitializer& P
 	LastBattleState = EFlareSectorBattleState::NoBattle;
 	RecoveryActive = false;
 
+	// Notification summaries
+	NotificationService.SetCategory("ship-killed", LOCTEXT("ShipKilledSummary", "{0} ships destroyed"));
+	NotificationService.SetCategory("station-killed", LOCTEXT("StationKilledSummary", "{0} stations destroyed"));
+	NotificationService.SetCategory("ship-uncontrollable", LOCTEXT("ShipUncontrollableSummary", "{0} ships uncontrollable"));
+	NotificationService.SetCategory("ship-captured", LOCTEXT("ShipCapturedSummary", "{0} ships captured"));
+	NotificationService.SetCategory("station-captured", LOCTEXT("StationCapturedSummary", "{0} stations captured"));
+	NotificationService.SetCategory("ship-production-complete", LOCTEXT("ShipProductionSummary", "{0} ships built"));
+	NotificationService.SetCategory("travel-end", LOCTEXT("TravelEndSummary", "{0} fleets arrived"));
+
 	// Setup
 	ShipPawn = NULL;
 	PlayerShip = NULL;
@@ -93,6 +102,11 @@ void AFlarePlayerController::PlayerTick(float DeltaSeconds)
 	AFlareHUD* HUD = GetNavHUD();
 	TimeSinceWeaponSwitch += DeltaSeconds;
 
+	// Show the notification summaries that are due
+	TArray<FFlareNotificationEvent> Notifications;
+	NotificationService.Update(GetWorld()->GetTimeSeconds(), Notifications);
+	ShowNotifications(Notifications);
+
 	// Check recovery
 	if(RecoveryActive)
 	{
@@ -321,6 +335,8 @@ void AFlarePlayerController::SetCompanyDescription(const FFlareCompanyDescriptio
 void AFlarePlayerController::Load(const FFlarePlayerSave& SavePlayerData)
 {
 	PlayerData = SavePlayerData;
+	NotificationService.Load(PlayerData.NotificationHistory);
+	PlayerData.NotificationHistory.Empty();
 	Company = GetGame()->GetGameWorld()->FindCompany(PlayerData.CompanyIdentifier);
 	PlayerFleet = GetGame()->GetGameWorld()->FindFleet(PlayerData.PlayerFleetIdentifier);
 }
@@ -417,6 +433,7 @@ void AFlarePlayerController::OnBattleStateChanged(EFlareSectorBattleState::Type
 void AFlarePlayerController::Save(FFlarePlayerSave& SavePlayerData, FFlareCompanyDescription& SaveCompanyData)
 {
 	SavePlayerData = PlayerData;
+	SavePlayerData.NotificationHistory = NotificationService.GetHistory();
 	SaveCompanyData = CompanyData;
 }
 
@@ -455,8 +472,13 @@ void AFlarePlayerController::Clean()
 
 	LastBattleState = EFlareSectorBattleState::NoBattle;
 	RecoveryActive = false;
+	NotificationService.Reset();
 
-	MenuManager->FlushNotifications();
+	// No menus when running as a commandlet
+	if (MenuManager)
+	{
+		MenuManager->FlushNotifications();
+	}
 }
 
 
@@ -467,7 +489,34 @@ void AFlarePlayerController::Clean()
 void AFlarePlayerController::Notify(FText Title, FText Info, FName Tag, EFlareNotification::Type Type, bool Pinned, EFlareMenu::Type TargetMenu, FFlareMenuParameterData TargetInfo)
 {
 	FLOGV("AFlarePlayerController::Notify : '%s'", *Title.ToString());
-	MenuManager->Notify(Title, Info, Tag, Type, Pinned, TargetMenu, TargetInfo);
+
+	FFlareNotificationEvent Event;
+	Event.Text = Title;
+	Event.Info = Info;
+	Event.Tag = Tag;
+	Event.Type = Type;
+	Event.Pinned = Pinned;
+	Event.TargetMenu = TargetMenu;
+	Event.TargetInfo = TargetInfo;
+
+	TArray<FFlareNotificationEvent> Notifications;
+	int64 Date = (GetGame() && GetGame()->GetGameWorld()) ? GetGame()->GetGameWorld()->GetDate() : 0;
+	NotificationService.Push(Event, Date, GetWorld()->GetTimeSeconds(), Notifications);
+	ShowNotifications(Notifications);
+}
+
+void AFlarePlayerController::ShowNotifications(const TArray<FFlareNotificationEvent>& Notifications)
+{
+	// No menus when running as a commandlet
+	if (MenuManager)
+	{
+		for (int32 Index = 0; Index < Notifications.Num(); Index++)
+		{
+			const FFlareNotificationEvent& Notification = Notifications[Index];
+			MenuManager->Notify(Notification.Text, Notification.Info, Notification.Tag, Notification.Type,
+				Notification.Pinned, Notification.TargetMenu, Notification.TargetInfo);
+		}
+	}
 }
 
 void AFlarePlayerController::SetupCockpit()
@@ -743,6 +792,18 @@ void AFlarePlayerController::NotifyDockingResult(bool Success, UFlareSimulatedSp
 			EFlareNotification::NT_Info,
 			false);
 	}
+	else if (Target->IsActive() && ShipPawn && Target->GetActive()->GetDockingSystem()->IsQueuedShip(ShipPawn))
+	{
+		int32 QueuePosition = Target->GetActive()->GetDockingSystem()->GetQueuePosition(ShipPawn);
+		Notify(
+			LOCTEXT("DockingQueued", "Docking queued"),
+			FText::Format(LOCTEXT("DockingQueuedInfoFormat", "{0} has no free dock, your ship is number {1} in the queue and will dock automatically when one is free. Using manual controls will leave the queue."),
+				FText::FromName(Target->GetImmatriculation()),
+				FText::AsNumber(FMath::Max(QueuePosition, 0) + 1)),
+			"docking-queued",
+			EFlareNotification::NT_Info,
+			false);
+	}
 	else
 	{
 		Notify(
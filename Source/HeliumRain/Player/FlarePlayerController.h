@@ -100,9 +100,12 @@ public:
 		Menus
 	----------------------------------------------------*/
 
-	/** Show a notification to the user */
+	/** Show a notification to the user, once aggregated by the notification service */
 	void Notify(FText Text, FText Info, FName Tag, EFlareNotification::Type Type = EFlareNotification::NT_Info, bool Pinned = false, EFlareMenu::Type TargetMenu = EFlareMenu::MENU_None, FFlareMenuParameterData TargetInfo = FFlareMenuParameterData());
 
+	/** Send notifications to the notifier */
+	void ShowNotifications(const TArray<FFlareNotificationEvent>& Notifications);
+
 	/** Setup the cockpit */
 	void SetupCockpit();
 
@@ -356,6 +359,9 @@ protected:
 	UPROPERTY()
 	FFlarePlayerObjective                    CurrentObjective;
 
+	/** Notification aggregation and history */
+	FFlareNotificationService                NotificationService;
+
 	// Various gameplay data
 	int32                                    QuickSwitchNextOffset;
 	float                                    WeaponSwitchTime;
@@ -456,5 +462,10 @@ public:
 	{
 		return &PlayerData;
 	}
+
+	FFlareNotificationService& GetNotificationService()
+	{
+		return NotificationService;
+	}
 };
 
@@ -6,6 +6,9 @@
 
 #define LOCTEXT_NAMESPACE "FlareQuest"
 
+// Maximum nesting of shared conditions
+#define QUEST_MAX_SHARED_CONDITION_DEPTH 8
+
 
 /*----------------------------------------------------
 	Constructor
@@ -13,6 +16,7 @@
 
 UFlareQuest::UFlareQuest(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer),
+	  CurrentStepDescription(NULL),
 	  TrackObjectives(false)
 {
 }
@@ -29,6 +33,44 @@ void UFlareQuest::Load(const FFlareQuestDescription* Description)
 	QuestDescription = Description;
 	QuestData.QuestIdentifier = QuestDescription->Identifier;
 	QuestStatus = EFlareQuestStatus::AVAILABLE;
+
+	// Compile conditions
+	TriggerEvents.Empty();
+	CompileConditions(QuestDescription->Triggers, true, TriggerProgram, TriggerEvents);
+	if (TriggerEvents.ContainsByPredicate([](const FFlareQuestEvent& Event) { return Event.Type == EFlareQuestCallback::TICK_FLYING; }))
+	{
+		FLOGV("WARNING: The quest %s need a TICK_FLYING callback as trigger", *GetIdentifier().ToString());
+	}
+
+	StepPrograms.SetNum(QuestDescription->Steps.Num());
+	for (int StepIndex = 0; StepIndex < QuestDescription->Steps.Num(); StepIndex++)
+	{
+		const FFlareQuestStepDescription& Step = QuestDescription->Steps[StepIndex];
+		FFlareQuestStepProgram& Program = StepPrograms[StepIndex];
+
+		Program.Events.Empty();
+		CompileConditions(Step.EnabledConditions, true, Program.EnabledConditions, Program.Events);
+		CompileConditions(Step.EndConditions, true, Program.EndConditions, Program.Events);
+		CompileConditions(Step.FailConditions, false, Program.FailConditions, Program.Events);
+		CompileConditions(Step.BlockConditions, false, Program.BlockConditions, Program.Events);
+
+		// Saves only keep a name per progress, a type number and an identifier could be mixed up
+		TArray<const FFlareQuestConditionDescription*> StepConditions;
+		GetStepConditions(&Program, StepConditions);
+		for (int ConditionIndex = 0; ConditionIndex < StepConditions.Num(); ConditionIndex++)
+		{
+			FFlareQuestConditionKey Key(StepConditions[ConditionIndex]);
+			for (int OtherIndex = 0; OtherIndex < StepConditions.Num() && Key.Identifier != NAME_None; OtherIndex++)
+			{
+				FFlareQuestConditionKey OtherKey(StepConditions[OtherIndex]);
+				if (OtherKey.Identifier == NAME_None && OtherKey.GetSaveIdentifier() == Key.Identifier)
+				{
+					FLOGV("WARNING: The quest %s step %s has a condition identifier %s used as a type in saves",
+						*GetIdentifier().ToString(), *Step.Identifier.ToString(), *Key.Identifier.ToString());
+				}
+			}
+		}
+	}
 }
 
 void UFlareQuest::Restore(const FFlareQuestProgressSave& Data)
@@ -45,11 +87,19 @@ void UFlareQuest::Restore(const FFlareQuestProgressSave& Data)
 			break;
 		}
 	}
+
+	// Restore the step progress
+	TArray<const FFlareQuestConditionDescription*> StepConditions;
+	if (CurrentStepDescription)
+	{
+		GetStepConditions(GetCurrentStepProgram(), StepConditions);
+	}
+	StepProgress.Restore(QuestData.CurrentStepProgress, StepConditions);
 }
 
 FFlareQuestProgressSave* UFlareQuest::Save()
 {
-	// TODO Save
+	StepProgress.Save(QuestData.CurrentStepProgress);
 	return &QuestData;
 }
 
@@ -69,7 +119,7 @@ void UFlareQuest::UpdateState()
 	{
 		case EFlareQuestStatus::AVAILABLE:
 		{
-			bool ConditionsStatus = CheckConditions(QuestDescription->Triggers, true);
+			bool ConditionsStatus = CheckProgram(TriggerProgram);
 			if (ConditionsStatus)
 			{
 				Activate();
@@ -78,23 +128,23 @@ void UFlareQuest::UpdateState()
 		}
 		case EFlareQuestStatus::ACTIVE:
 		{
-			const FFlareQuestStepDescription* StepDescription = GetCurrentStepDescription();
-			if (StepDescription)
+			const FFlareQuestStepProgram* StepProgram = GetCurrentStepProgram();
+			if (StepProgram)
 			{
-				bool StepEnabled = CheckConditions(StepDescription->EnabledConditions, true);
+				bool StepEnabled = CheckProgram(StepProgram->EnabledConditions);
 				if (StepEnabled)
 				{
-					bool StepFailed = CheckConditions(StepDescription->FailConditions, false);
+					bool StepFailed = CheckProgram(StepProgram->FailConditions);
 					if (StepFailed)
 					{
 						Fail();
 					}
 					else
 					{
-						bool StepBlocked = CheckConditions(StepDescription->BlockConditions, false);
+						bool StepBlocked = CheckProgram(StepProgram->BlockConditions);
 						if (!StepBlocked)
 						{
-							bool StepEnded = CheckConditions(StepDescription->EndConditions, true);
+							bool StepEnded = CheckProgram(StepProgram->EndConditions);
 							if (StepEnded){
 								// This step ended go to next step
 								EndStep();
@@ -136,6 +186,7 @@ void UFlareQuest::NextStep()
 	// Clear step progress
 	CurrentStepDescription = NULL;
 	QuestData.CurrentStepProgress.Empty();
+	StepProgress.Reset();
 
 	if (QuestDescription->Steps.Num() == 0)
 	{
@@ -209,6 +260,26 @@ bool UFlareQuest::CheckConditions(const TArray<FFlareQuestConditionDescription>&
 	return true;
 }
 
+bool UFlareQuest::CheckProgram(const FFlareQuestConditionProgram& Program)
+{
+	if (Program.IsConstant)
+	{
+		return Program.ConstantResult;
+	}
+
+	for (int ConditionIndex = 0; ConditionIndex < Program.Conditions.Num(); ConditionIndex++)
+	{
+		// Shared conditions are inlined, the empty result is never used
+		const FFlareQuestConditionDescription* Condition = Program.Conditions[ConditionIndex];
+		if (!Condition || !CheckCondition(Condition, false))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool UFlareQuest::CheckCondition(const FFlareQuestConditionDescription* Condition, bool EmptyResult)
 {
 	bool Status = false;
@@ -257,12 +328,10 @@ bool UFlareQuest::CheckCondition(const FFlareQuestConditionDescription* Conditio
 				AFlareSpacecraft* Spacecraft = QuestManager->GetGame()->GetPC()->GetShipPawn();
 				float CollinearVelocity = FVector::DotProduct(Spacecraft->GetLinearVelocity(), Spacecraft->GetFrontVector());
 
-				FFlareQuestStepProgressSave* ProgressSave = GetCurrentStepProgressSave(Condition);
-				if (!ProgressSave)
+				FFlareQuestConditionKey Key(Condition);
+				if (!StepProgress.Contains(Key))
 				{
-					ProgressSave = CreateStepProgressSave(Condition);
-					ProgressSave->CurrentProgression = 0;
-					ProgressSave->InitialVelocity = CollinearVelocity;
+					StepProgress.SetInitialVelocity(Key, CollinearVelocity);
 				}
 
 				Status = CollinearVelocity > Condition->FloatParam1;
@@ -274,12 +343,10 @@ bool UFlareQuest::CheckCondition(const FFlareQuestConditionDescription* Conditio
 				AFlareSpacecraft* Spacecraft = QuestManager->GetGame()->GetPC()->GetShipPawn();
 				float CollinearVelocity = FVector::DotProduct(Spacecraft->GetLinearVelocity(), Spacecraft->GetFrontVector());
 
-				FFlareQuestStepProgressSave* ProgressSave = GetCurrentStepProgressSave(Condition);
-				if (!ProgressSave)
+				FFlareQuestConditionKey Key(Condition);
+				if (!StepProgress.Contains(Key))
 				{
-					ProgressSave = CreateStepProgressSave(Condition);
-					ProgressSave->CurrentProgression = 0;
-					ProgressSave->InitialVelocity = CollinearVelocity;
+					StepProgress.SetInitialVelocity(Key, CollinearVelocity);
 				}
 
 				Status = CollinearVelocity < Condition->FloatParam1;
@@ -372,34 +439,35 @@ bool UFlareQuest::CheckCondition(const FFlareQuestConditionDescription* Conditio
 			{
 				AFlareSpacecraft* Spacecraft = QuestManager->GetGame()->GetPC()->GetShipPawn();
 
-				FFlareQuestStepProgressSave* ProgressSave = GetCurrentStepProgressSave(Condition);
+				FFlareQuestConditionKey Key(Condition);
 
-				if (!ProgressSave)
+				if (!StepProgress.Contains(Key))
 				{
-					ProgressSave = CreateStepProgressSave(Condition);
-					ProgressSave->CurrentProgression = 0;
-					ProgressSave->InitialTransform = Spacecraft->Airframe->GetComponentTransform();
+					StepProgress.SetInitialTransform(Key, Spacecraft->Airframe->GetComponentTransform());
 				}
 
-				FVector InitialLocation = ProgressSave->InitialTransform.GetTranslation();
-				FVector RelativeTargetLocation = Condition->VectorListParam[ProgressSave->CurrentProgression] * 100;
-				FVector WorldTargetLocation = InitialLocation + ProgressSave->InitialTransform.GetRotation().RotateVector(RelativeTargetLocation);
+				const FTransform& InitialTransform = StepProgress.GetInitialTransform(Key);
+				int32 CurrentProgression = StepProgress.GetCounter(Key);
+				FVector InitialLocation = InitialTransform.GetTranslation();
+				FVector RelativeTargetLocation = Condition->VectorListParam[CurrentProgression] * 100;
+				FVector WorldTargetLocation = InitialLocation + InitialTransform.GetRotation().RotateVector(RelativeTargetLocation);
 
 
-				float MaxDistance = Condition->FloatListParam[ProgressSave->CurrentProgression] * 100;
+				float MaxDistance = Condition->FloatListParam[CurrentProgression] * 100;
 
 
 				if (FVector::Dist(Spacecraft->GetActorLocation(), WorldTargetLocation) < MaxDistance)
 				{
 					// Nearing the target
-					if (ProgressSave->CurrentProgression + 2 <= Condition->VectorListParam.Num())
+					if (CurrentProgression + 2 <= Condition->VectorListParam.Num())
 					{
 						// Progress.
-						ProgressSave->CurrentProgression++;
+						CurrentProgression++;
+						StepProgress.SetCounter(Key, CurrentProgression);
 
 						FText WaypointText = LOCTEXT("WaypointProgress", "Waypoint reached, {0} left");
 
-						SendQuestNotification(FText::Format(WaypointText, FText::AsNumber(Condition->VectorListParam.Num() - ProgressSave->CurrentProgression)),
+						SendQuestNotification(FText::Format(WaypointText, FText::AsNumber(Condition->VectorListParam.Num() - CurrentProgression)),
 											  FName(*(FString("quest-")+GetIdentifier().ToString()+"-step-progress")));
 					}
 					else
@@ -709,10 +777,10 @@ void UFlareQuest::AddConditionObjectives(FFlarePlayerObjectiveData* ObjectiveDat
 			ObjectiveCondition.Counter = 0;
 			ObjectiveCondition.MaxCounter = 0;
 
-			FFlareQuestStepProgressSave* ProgressSave = GetCurrentStepProgressSave(Condition);
-			if (ProgressSave) // TODO #402 : investigate why this can be NULL
+			FFlareQuestConditionKey Key(Condition);
+			if (StepProgress.Contains(Key)) // TODO #402 : investigate why this can be missing
 			{
-				ObjectiveCondition.MaxProgress = FMath::Abs(ProgressSave->InitialVelocity - Condition->FloatParam1);
+				ObjectiveCondition.MaxProgress = FMath::Abs(StepProgress.GetInitialVelocity(Key) - Condition->FloatParam1);
 				ObjectiveCondition.Progress = ObjectiveCondition.MaxProgress - FMath::Abs(Velocity - Condition->FloatParam1);
 			}
 			else
@@ -743,10 +811,10 @@ void UFlareQuest::AddConditionObjectives(FFlarePlayerObjectiveData* ObjectiveDat
 			ObjectiveCondition.Counter = 0;
 			ObjectiveCondition.MaxCounter = 0;
 
-			FFlareQuestStepProgressSave* ProgressSave = GetCurrentStepProgressSave(Condition);
-			if (ProgressSave) // TODO #402 : investigate why this can be NULL
+			FFlareQuestConditionKey Key(Condition);
+			if (StepProgress.Contains(Key)) // TODO #402 : investigate why this can be missing
 			{
-				ObjectiveCondition.MaxProgress = FMath::Abs(ProgressSave->InitialVelocity - Condition->FloatParam1);
+				ObjectiveCondition.MaxProgress = FMath::Abs(StepProgress.GetInitialVelocity(Key) - Condition->FloatParam1);
 				ObjectiveCondition.Progress = ObjectiveCondition.MaxProgress - FMath::Abs(Velocity - Condition->FloatParam1);
 			}
 			else
@@ -834,27 +902,30 @@ void UFlareQuest::AddConditionObjectives(FFlarePlayerObjectiveData* ObjectiveDat
 			ObjectiveCondition.MaxProgress = Condition->VectorListParam.Num();
 
 			// It need navigation point. Get current point coordinate.
-			FFlareQuestStepProgressSave* ProgressSave = GetCurrentStepProgressSave(Condition);
+			FFlareQuestConditionKey Key(Condition);
 
-			if (ProgressSave)
+			if (StepProgress.Contains(Key))
 			{
-				ObjectiveCondition.Counter = ProgressSave->CurrentProgression;
-				ObjectiveCondition.Progress = ProgressSave->CurrentProgression;
+				int32 CurrentProgression = StepProgress.GetCounter(Key);
+				const FTransform& InitialTransform = StepProgress.GetInitialTransform(Key);
+
+				ObjectiveCondition.Counter = CurrentProgression;
+				ObjectiveCondition.Progress = CurrentProgression;
 				for (int TargetIndex = 0; TargetIndex < Condition->VectorListParam.Num(); TargetIndex++)
 				{
-					if (TargetIndex < ProgressSave->CurrentProgression)
+					if (TargetIndex < CurrentProgression)
 					{
 						// Don't show old target
 						continue;
 					}
 					FFlarePlayerObjectiveTarget ObjectiveTarget;
 					ObjectiveTarget.Actor = NULL;
-					ObjectiveTarget.Active = (ProgressSave->CurrentProgression == TargetIndex);
+					ObjectiveTarget.Active = (CurrentProgression == TargetIndex);
 					ObjectiveTarget.Radius = Condition->FloatListParam[TargetIndex];
 
-					FVector InitialLocation = ProgressSave->InitialTransform.GetTranslation();
+					FVector InitialLocation = InitialTransform.GetTranslation();
 					FVector RelativeTargetLocation = Condition->VectorListParam[TargetIndex] * 100; // In cm
-					FVector WorldTargetLocation = InitialLocation + ProgressSave->InitialTransform.GetRotation().RotateVector(RelativeTargetLocation);
+					FVector WorldTargetLocation = InitialLocation + InitialTransform.GetRotation().RotateVector(RelativeTargetLocation);
 
 					ObjectiveTarget.Location = WorldTargetLocation;
 					ObjectiveData->TargetList.Add(ObjectiveTarget);
@@ -962,32 +1033,21 @@ void UFlareQuest::GenerateConditionCollinearityObjective(FFlarePlayerObjectiveDa
 ----------------------------------------------------*/
 
 
-TArray<EFlareQuestCallback::Type> UFlareQuest::GetCurrentCallbacks()
+const TArray<FFlareQuestEvent>& UFlareQuest::GetCurrentEvents() const
 {
-	TArray<EFlareQuestCallback::Type> Callbacks;
-
-	// TODO Cache and return reference
 	switch(QuestStatus)
 	{
 		case EFlareQuestStatus::AVAILABLE:
 			// Use trigger conditions
-			AddConditionCallbacks(Callbacks, QuestDescription->Triggers);
+			return TriggerEvents;
 
-			if (Callbacks.Contains(EFlareQuestCallback::TICK_FLYING))
-			{
-				FLOGV("WARNING: The quest %s need a TICK_FLYING callback as trigger", *GetIdentifier().ToString());
-			}
-			break;
 		case EFlareQuestStatus::ACTIVE:
-		 {
+		{
 			// Use current step conditions
-			const FFlareQuestStepDescription* StepDescription = GetCurrentStepDescription();
-			if (StepDescription)
+			const FFlareQuestStepProgram* StepProgram = GetCurrentStepProgram();
+			if (StepProgram)
 			{
-				AddConditionCallbacks(Callbacks, StepDescription->EnabledConditions);
-				AddConditionCallbacks(Callbacks, StepDescription->EndConditions);
-				AddConditionCallbacks(Callbacks, StepDescription->FailConditions);
-				AddConditionCallbacks(Callbacks, StepDescription->BlockConditions);
+				return StepProgram->Events;
 			}
 			else
 			{
@@ -1000,44 +1060,74 @@ TArray<EFlareQuestCallback::Type> UFlareQuest::GetCurrentCallbacks()
 			break;
 	}
 
-	return Callbacks;
+	return NoEvents;
 }
 
-void UFlareQuest::AddConditionCallbacks(TArray<EFlareQuestCallback::Type>& Callbacks, const TArray<FFlareQuestConditionDescription>& Conditions)
+void UFlareQuest::CompileConditions(const TArray<FFlareQuestConditionDescription>& Conditions, bool EmptyResult, FFlareQuestConditionProgram& Program, TArray<FFlareQuestEvent>& Events)
+{
+	Program.Conditions.Empty();
+	Program.IsConstant = (Conditions.Num() == 0);
+	Program.ConstantResult = EmptyResult;
+
+	AddCompiledConditions(Conditions, EmptyResult, Program, Events, 0);
+}
+
+void UFlareQuest::AddCompiledConditions(const TArray<FFlareQuestConditionDescription>& Conditions, bool EmptyResult, FFlareQuestConditionProgram& Program, TArray<FFlareQuestEvent>& Events, int32 Depth)
 {
 	for (int ConditionIndex = 0; ConditionIndex < Conditions.Num(); ConditionIndex++)
 	{
-		TArray<EFlareQuestCallback::Type> ConditionCallbacks = GetConditionCallbacks(&Conditions[ConditionIndex]);
-		for (int CallbackIndex = 0; CallbackIndex < ConditionCallbacks.Num(); CallbackIndex++)
+		const FFlareQuestConditionDescription* Condition = &Conditions[ConditionIndex];
+
+		if (Condition->Type == EFlareQuestCondition::SHARED_CONDITION)
 		{
-			Callbacks.AddUnique(ConditionCallbacks[CallbackIndex]);
+			const FFlareSharedQuestCondition* SharedCondition = FindSharedCondition(Condition->Identifier1);
+			if (!SharedCondition || Depth >= QUEST_MAX_SHARED_CONDITION_DEPTH)
+			{
+				if (SharedCondition)
+				{
+					FLOGV("ERROR: The quest %s shared condition %s is too deep", *GetIdentifier().ToString(), *Condition->Identifier1.ToString());
+				}
+				Program.Conditions.Add(NULL);
+			}
+			else if (SharedCondition->Conditions.Num() == 0)
+			{
+				// An empty shared condition gives the result of an empty list
+				if (!EmptyResult)
+				{
+					Program.Conditions.Add(NULL);
+				}
+			}
+			else
+			{
+				AddCompiledConditions(SharedCondition->Conditions, EmptyResult, Program, Events, Depth + 1);
+			}
+		}
+		else
+		{
+			Program.Conditions.Add(Condition);
+			Events.AddUnique(GetConditionEvent(Condition));
 		}
 	}
 }
 
-TArray<EFlareQuestCallback::Type> UFlareQuest::GetConditionCallbacks(const FFlareQuestConditionDescription* Condition)
+FFlareQuestEvent UFlareQuest::GetConditionEvent(const FFlareQuestConditionDescription* Condition)
 {
+	FFlareQuestEvent Event;
+	Event.Type = EFlareQuestCallback::TICK_FLYING;
+	Event.Identifier = NAME_None;
 
-	TArray<EFlareQuestCallback::Type> Callbacks;
 	switch(Condition->Type)
 	{
-		case EFlareQuestCondition::SHARED_CONDITION:
-		{
-			const FFlareSharedQuestCondition* SharedCondition = FindSharedCondition(Condition->Identifier1);
-			if (SharedCondition)
-			{
-				AddConditionCallbacks(Callbacks, SharedCondition->Conditions);
-			}
-			break;
-		}
 		case EFlareQuestCondition::FLYING_SHIP:
-			Callbacks.AddUnique(EFlareQuestCallback::FLY_SHIP);
+			Event.Type = EFlareQuestCallback::FLY_SHIP;
 			break;
 		case EFlareQuestCondition::SECTOR_VISITED:
-			Callbacks.AddUnique(EFlareQuestCallback::SECTOR_VISITED);
+			Event.Type = EFlareQuestCallback::SECTOR_VISITED;
+			Event.Identifier = Condition->Identifier1;
 			break;
 		case EFlareQuestCondition::SECTOR_ACTIVE:
-			Callbacks.AddUnique(EFlareQuestCallback::SECTOR_ACTIVE);
+			Event.Type = EFlareQuestCallback::SECTOR_ACTIVE;
+			Event.Identifier = Condition->Identifier1;
 			break;
 		case EFlareQuestCondition::SHIP_MIN_COLLINEAR_VELOCITY:
 		case EFlareQuestCondition::SHIP_MAX_COLLINEAR_VELOCITY:
@@ -1051,44 +1141,19 @@ TArray<EFlareQuestCallback::Type> UFlareQuest::GetConditionCallbacks(const FFlar
 		case EFlareQuestCondition::SHIP_MAX_ROLL_VELOCITY:
 		case EFlareQuestCondition::SHIP_FOLLOW_RELATIVE_WAYPOINTS:
 		case EFlareQuestCondition::SHIP_ALIVE:
-			Callbacks.AddUnique(EFlareQuestCallback::TICK_FLYING);
+			Event.Type = EFlareQuestCallback::TICK_FLYING;
 			break;
 		case EFlareQuestCondition::QUEST_SUCCESSFUL:
 		case EFlareQuestCondition::QUEST_FAILED:
-			Callbacks.AddUnique(EFlareQuestCallback::QUEST);
+			Event.Type = EFlareQuestCallback::QUEST;
+			Event.Identifier = Condition->Identifier1;
 			break;
 		default:
-			FLOGV("ERROR: GetConditionCallbacks not implemented for condition type %d", (int)(Condition->Type +0));
+			FLOGV("ERROR: GetConditionEvent not implemented for condition type %d", (int)(Condition->Type +0));
 			break;
 	}
 
-	return Callbacks;
-}
-
-void UFlareQuest::OnTick(float DeltaSeconds)
-{
-	UpdateState();
-}
-
-void UFlareQuest::OnFlyShip(AFlareSpacecraft* Ship)
-{
-	UpdateState();
-}
-
-
-void UFlareQuest::OnQuestStatusChanged(UFlareQuest* Quest)
-{
-	UpdateState();
-}
-
-void UFlareQuest::OnSectorActivation(UFlareSimulatedSector* Sector)
-{
-	UpdateState();
-}
-
-void UFlareQuest::OnSectorVisited(UFlareSimulatedSector* Sector)
-{
-	UpdateState();
+	return Event;
 }
 
 
@@ -1125,44 +1190,19 @@ const FFlareSharedQuestCondition* UFlareQuest::FindSharedCondition(FName SharedC
 	return NULL;
 }
 
-FFlareQuestStepProgressSave* UFlareQuest::GetCurrentStepProgressSave(const FFlareQuestConditionDescription* Condition)
+void UFlareQuest::GetStepConditions(const FFlareQuestStepProgram* StepProgram, TArray<const FFlareQuestConditionDescription*>& Conditions) const
 {
-	// TODO check double condition
-	if (Condition)
+	const FFlareQuestConditionProgram* Programs[] = { &StepProgram->EnabledConditions, &StepProgram->FailConditions, &StepProgram->BlockConditions, &StepProgram->EndConditions };
+	for (int ProgramIndex = 0; ProgramIndex < ARRAY_COUNT(Programs); ProgramIndex++)
 	{
-		FName SaveId = FName(*FString::FromInt(Condition->Type + 0));
-		if (Condition->ConditionIdentifier != NAME_None)
+		for (int ConditionIndex = 0; ConditionIndex < Programs[ProgramIndex]->Conditions.Num(); ConditionIndex++)
 		{
-			SaveId = Condition->ConditionIdentifier;
-		}
-		for (int ProgressIndex = 0; ProgressIndex < QuestData.CurrentStepProgress.Num(); ProgressIndex++)
-		{
-			if (QuestData.CurrentStepProgress[ProgressIndex].ConditionIdentifier == SaveId)
+			if (Programs[ProgramIndex]->Conditions[ConditionIndex])
 			{
-				return &QuestData.CurrentStepProgress[ProgressIndex];
+				Conditions.AddUnique(Programs[ProgramIndex]->Conditions[ConditionIndex]);
 			}
 		}
-
 	}
-
-
-	return NULL;
-}
-
-FFlareQuestStepProgressSave* UFlareQuest::CreateStepProgressSave(const FFlareQuestConditionDescription* Condition)
-{
-	FName SaveId = FName(*FString::FromInt(Condition->Type + 0));
-	if (Condition->ConditionIdentifier != NAME_None)
-	{
-		SaveId = Condition->ConditionIdentifier;
-	}
-
-	FFlareQuestStepProgressSave NewSave;
-	NewSave.ConditionIdentifier = SaveId;
-	NewSave.CurrentProgression = 0;
-	NewSave.InitialTransform = FTransform::Identity;
-	QuestData.CurrentStepProgress.Add(NewSave);
-	return &QuestData.CurrentStepProgress.Last();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FlareQuestManager.h"
+#include "FlareQuestStepProgress.h"
 #include "FlareQuest.generated.h"
 
 
@@ -234,6 +235,29 @@ struct FFlareQuestDescription
 	TArray<FFlareQuestActionDescription> SuccessActions;
 };
 
+/** Condition list with its shared conditions inlined, evaluated in order */
+struct FFlareQuestConditionProgram
+{
+	/** Empty list, the result doesn't need evaluation */
+	bool IsConstant;
+	bool ConstantResult;
+
+	/** All must be true. NULL entries are always false, like a missing shared condition. */
+	TArray<const FFlareQuestConditionDescription*> Conditions;
+};
+
+/** Compiled conditions of a quest step */
+struct FFlareQuestStepProgram
+{
+	FFlareQuestConditionProgram EnabledConditions;
+	FFlareQuestConditionProgram FailConditions;
+	FFlareQuestConditionProgram BlockConditions;
+	FFlareQuestConditionProgram EndConditions;
+
+	/** Events that can change the conditions */
+	TArray<FFlareQuestEvent> Events;
+};
+
 struct FFlarePlayerObjectiveData;
 
 /** Quest */
@@ -280,6 +304,9 @@ public:
 
 	virtual bool CheckCondition(const FFlareQuestConditionDescription* Condition, bool EmptyResult);
 
+	/** Evaluate compiled conditions */
+	bool CheckProgram(const FFlareQuestConditionProgram& Program);
+
 	virtual void PerformActions(const TArray<FFlareQuestActionDescription>& Actions);
 
 	virtual void PerformAction(const FFlareQuestActionDescription* Action);
@@ -288,7 +315,8 @@ public:
 
 	virtual void SendQuestNotification(FText Message, FName Tag);
 
-	virtual FFlareQuestStepProgressSave* CreateStepProgressSave(const FFlareQuestConditionDescription* Condition);
+	/** Get the conditions of a step, with the shared conditions */
+	void GetStepConditions(const FFlareQuestStepProgram* StepProgram, TArray<const FFlareQuestConditionDescription*>& Conditions) const;
 
 	/*----------------------------------------------------
 		Objective tracking
@@ -308,21 +336,17 @@ public:
 		Callback
 	----------------------------------------------------*/
 
-	virtual TArray<EFlareQuestCallback::Type> GetCurrentCallbacks();
-
-	virtual TArray<EFlareQuestCallback::Type> GetConditionCallbacks(const FFlareQuestConditionDescription* Condition);
+	/** Get the events the quest waits for in its current state */
+	const TArray<FFlareQuestEvent>& GetCurrentEvents() const;
 
-	virtual void AddConditionCallbacks(TArray<EFlareQuestCallback::Type>& Callbacks, const TArray<FFlareQuestConditionDescription>& Conditions);
+	/** Get the event that can change a condition */
+	static FFlareQuestEvent GetConditionEvent(const FFlareQuestConditionDescription* Condition);
 
-	virtual void OnFlyShip(AFlareSpacecraft* Ship);
+	/** Compile a condition list, with the events it depends on */
+	void CompileConditions(const TArray<FFlareQuestConditionDescription>& Conditions, bool EmptyResult, FFlareQuestConditionProgram& Program, TArray<FFlareQuestEvent>& Events);
 
-	virtual void OnSectorActivation(UFlareSimulatedSector* Sector);
-
-	virtual void OnSectorVisited(UFlareSimulatedSector* Sector);
-
-	virtual void OnTick(float DeltaSeconds);
-
-	virtual void OnQuestStatusChanged(UFlareQuest* Quest);
+	/** Add conditions to a program, inlining the shared conditions */
+	void AddCompiledConditions(const TArray<FFlareQuestConditionDescription>& Conditions, bool EmptyResult, FFlareQuestConditionProgram& Program, TArray<FFlareQuestEvent>& Events, int32 Depth);
 
 
 protected:
@@ -332,6 +356,7 @@ protected:
    ----------------------------------------------------*/
 
 	FFlareQuestProgressSave					QuestData;
+	FFlareQuestStepProgress					StepProgress;
 	EFlareQuestStatus::Type					QuestStatus;
 
 	const FFlareQuestDescription*			QuestDescription;
@@ -340,6 +365,12 @@ protected:
 
 	bool									TrackObjectives;
 
+	// Compiled conditions
+	FFlareQuestConditionProgram				TriggerProgram;
+	TArray<FFlareQuestEvent>				TriggerEvents;
+	TArray<FFlareQuestStepProgram>			StepPrograms;
+	TArray<FFlareQuestEvent>				NoEvents;
+
 
 public:
 
@@ -376,6 +407,14 @@ public:
 		return CurrentStepDescription;
 	}
 
-	FFlareQuestStepProgressSave* GetCurrentStepProgressSave(const FFlareQuestConditionDescription* Condition);
+	inline const FFlareQuestStepProgram* GetCurrentStepProgram() const
+	{
+		return (CurrentStepDescription ? &StepPrograms[CurrentStepDescription - QuestDescription->Steps.GetData()] : NULL);
+	}
+
+	inline const FFlareQuestStepProgress& GetStepProgress() const
+	{
+		return StepProgress;
+	}
 
 };
@@ -15,6 +15,7 @@
 
 UFlareQuestManager::UFlareQuestManager(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, SelectedQuest(NULL)
 {
 }
 
@@ -185,37 +186,50 @@ void UFlareQuestManager::LoadCallbacks(UFlareQuest* Quest)
 {
 	ClearCallbacks(Quest);
 
-	TArray<EFlareQuestCallback::Type> Callbacks = Quest->GetCurrentCallbacks();
+	const TArray<FFlareQuestEvent>& Events = Quest->GetCurrentEvents();
+	for (int i = 0; i < Events.Num(); i++)
+	{
+		GetCallbacks(Events[i].Type).FindOrAdd(Events[i].Identifier).Add(Quest);
+	}
+	QuestEvents.Add(Quest, Events);
+}
 
-	for (int i = 0; i < Callbacks.Num(); i++)
+void UFlareQuestManager::ClearCallbacks(UFlareQuest* Quest)
+{
+	TArray<FFlareQuestEvent>* Events = QuestEvents.Find(Quest);
+	if (Events)
 	{
-		switch (Callbacks[i])
+		for (int i = 0; i < Events->Num(); i++)
 		{
-		case EFlareQuestCallback::FLY_SHIP:
-			FlyShipCallback.Add(Quest);
-			break;
-		case EFlareQuestCallback::TICK_FLYING:
-			TickFlyingCallback.Add(Quest);
-			break;
-		case EFlareQuestCallback::SECTOR_VISITED:
-			SectorVisitedCallback.Add(Quest);
-			break;
-		case EFlareQuestCallback::SECTOR_ACTIVE:
-			SectorActiveCallback.Add(Quest);
-			break;
-		case EFlareQuestCallback::QUEST:
-			QuestCallback.Add(Quest);
-			break;
-		default:
-			FLOGV("Bad callback type %d for quest %s", (int)(Callbacks[i] + 0), *Quest->GetIdentifier().ToString());
+			TMap<FName, TArray<UFlareQuest*> >& Callbacks = GetCallbacks((*Events)[i].Type);
+			TArray<UFlareQuest*>* Quests = Callbacks.Find((*Events)[i].Identifier);
+			if (Quests)
+			{
+				Quests->Remove(Quest);
+				if (Quests->Num() == 0)
+				{
+					Callbacks.Remove((*Events)[i].Identifier);
+				}
+			}
 		}
+		QuestEvents.Remove(Quest);
 	}
 }
 
-void UFlareQuestManager::ClearCallbacks(UFlareQuest* Quest)
+void UFlareQuestManager::DispatchEvent(EFlareQuestCallback::Type Type, FName Identifier)
 {
-	TickFlyingCallback.Remove(Quest);
-	FlyShipCallback.Remove(Quest);
+	// Quests may register or unregister while updating, work on a copy
+	TArray<UFlareQuest*> Quests;
+	TArray<UFlareQuest*>* Callbacks = GetCallbacks(Type).Find(Identifier);
+	if (Callbacks)
+	{
+		Quests = *Callbacks;
+	}
+
+	for (int i = 0; i < Quests.Num(); i++)
+	{
+		Quests[i]->UpdateState();
+	}
 }
 
 void UFlareQuestManager::OnTick(float DeltaSeconds)
@@ -223,45 +237,29 @@ void UFlareQuestManager::OnTick(float DeltaSeconds)
 	if (GetGame()->GetActiveSector())
 	{
 		// Tick TickFlying callback only if there is an active sector
-		for (int i = 0; i < TickFlyingCallback.Num(); i++)
-		{
-			TickFlyingCallback[i]->OnTick(DeltaSeconds);
-		}
+		DispatchEvent(EFlareQuestCallback::TICK_FLYING, NAME_None);
 	}
 }
 
 void UFlareQuestManager::OnFlyShip(AFlareSpacecraft* Ship)
 {
-	for (int i = 0; i < FlyShipCallback.Num(); i++)
-	{
-		FlyShipCallback[i]->OnFlyShip(Ship);
-	}
+	DispatchEvent(EFlareQuestCallback::FLY_SHIP, NAME_None);
 }
 
 void UFlareQuestManager::OnSectorActivation(UFlareSimulatedSector* Sector)
 {
-	for (int i = 0; i < SectorActiveCallback.Num(); i++)
-	{
-		SectorActiveCallback[i]->OnSectorActivation(Sector);
-	}
+	DispatchEvent(EFlareQuestCallback::SECTOR_ACTIVE, Sector->GetIdentifier());
 }
 
 void UFlareQuestManager::OnSectorVisited(UFlareSimulatedSector* Sector)
 {
-	for (int i = 0; i < SectorVisitedCallback.Num(); i++)
-	{
-		SectorVisitedCallback[i]->OnSectorVisited(Sector);
-	}
+	DispatchEvent(EFlareQuestCallback::SECTOR_VISITED, Sector->GetIdentifier());
 }
 
 void UFlareQuestManager::OnQuestStatusChanged(UFlareQuest* Quest)
 {
 	LoadCallbacks(Quest);
-
-	for (int i = 0; i < QuestCallback.Num(); i++)
-	{
-		QuestCallback[i]->OnQuestStatusChanged(Quest);
-	}
+	DispatchEvent(EFlareQuestCallback::QUEST, Quest->GetIdentifier());
 }
 
 void UFlareQuestManager::OnQuestSuccess(UFlareQuest* Quest)
@@ -334,6 +332,19 @@ void UFlareQuestManager::OnQuestActivation(UFlareQuest* Quest)
 	Getters
 ----------------------------------------------------*/
 
+TMap<FName, TArray<UFlareQuest*> >& UFlareQuestManager::GetCallbacks(EFlareQuestCallback::Type Type)
+{
+	switch (Type)
+	{
+		case EFlareQuestCallback::FLY_SHIP:       return FlyShipCallback;
+		case EFlareQuestCallback::SECTOR_VISITED: return SectorVisitedCallback;
+		case EFlareQuestCallback::SECTOR_ACTIVE:  return SectorActiveCallback;
+		case EFlareQuestCallback::QUEST:          return QuestCallback;
+		case EFlareQuestCallback::TICK_FLYING:
+		default:                                  return TickFlyingCallback;
+	}
+}
+
 bool UFlareQuestManager::IsQuestActive(FName QuestIdentifier)
 {
 	for (int QuestIndex = 0; QuestIndex < ActiveQuests.Num(); QuestIndex++)
@@ -22,6 +22,20 @@ namespace EFlareQuestCallback
 	};
 }
 
+/** Event a quest waits for, with the sector or quest identifier it is about */
+struct FFlareQuestEvent
+{
+	EFlareQuestCallback::Type Type;
+
+	/** Sector for sector events, quest for quest events, none otherwise */
+	FName Identifier;
+
+	bool operator==(const FFlareQuestEvent& Other) const
+	{
+		return Type == Other.Type && Identifier == Other.Identifier;
+	}
+};
+
 /** Quest current step status save data */
 USTRUCT()
 struct FFlareQuestStepProgressSave
@@ -116,6 +130,9 @@ public:
 
 	virtual void ClearCallbacks(UFlareQuest* Quest);
 
+	/** Update the quests waiting for an event */
+	void DispatchEvent(EFlareQuestCallback::Type Type, FName Identifier);
+
 	virtual void OnFlyShip(AFlareSpacecraft* Ship);
 
 	virtual void OnSectorActivation(UFlareSimulatedSector* Sector);
@@ -149,12 +166,14 @@ protected:
 	TArray<UFlareQuest*>	                 OldQuests;
 	
 	UFlareQuest*			                 SelectedQuest;
-	// TODO Use map structure
-	TArray<UFlareQuest*>	                 FlyShipCallback;
-	TArray<UFlareQuest*>	                 SectorVisitedCallback;
-	TArray<UFlareQuest*>	                 SectorActiveCallback;
-	TArray<UFlareQuest*>	                 TickFlyingCallback;
-	TArray<UFlareQuest*>	                 QuestCallback;
+
+	// Quests waiting for each event, and events each quest waits for
+	TMap<FName, TArray<UFlareQuest*> >        FlyShipCallback;
+	TMap<FName, TArray<UFlareQuest*> >        SectorVisitedCallback;
+	TMap<FName, TArray<UFlareQuest*> >        SectorActiveCallback;
+	TMap<FName, TArray<UFlareQuest*> >        TickFlyingCallback;
+	TMap<FName, TArray<UFlareQuest*> >        QuestCallback;
+	TMap<UFlareQuest*, TArray<FFlareQuestEvent> > QuestEvents;
 
 	FFlareQuestSave			                 QuestData;
 
@@ -186,6 +205,9 @@ public:
 		return OldQuests;
 	}
 
+	/** Get the quests waiting for an event type */
+	TMap<FName, TArray<UFlareQuest*> >& GetCallbacks(EFlareQuestCallback::Type Type);
+
 	bool IsQuestActive(FName QuestIdentifier);
 
 	bool IsQuestSuccesfull(FName QuestIdentifier);
@@ -0,0 +1,131 @@
+
+#include "Flare.h"
+#include "FlareQuest.h"
+#include "FlareQuestStepProgress.h"
+
+
+/*----------------------------------------------------
+	Condition key
+----------------------------------------------------*/
+
+FFlareQuestConditionKey::FFlareQuestConditionKey(const FFlareQuestConditionDescription* Condition)
+	: Identifier(Condition->ConditionIdentifier)
+	, Type(Condition->ConditionIdentifier == NAME_None ? Condition->Type + 0 : -1)
+{
+}
+
+FName FFlareQuestConditionKey::GetSaveIdentifier() const
+{
+	return (Identifier != NAME_None ? Identifier : FName(*FString::FromInt(Type)));
+}
+
+
+/*----------------------------------------------------
+	Save
+----------------------------------------------------*/
+
+void FFlareQuestStepProgress::Restore(const TArray<FFlareQuestStepProgressSave>& Data, const TArray<const FFlareQuestConditionDescription*>& Conditions)
+{
+	Progress.Empty();
+
+	for (int32 DataIndex = 0; DataIndex < Data.Num(); DataIndex++)
+	{
+		const FFlareQuestStepProgressSave& ConditionData = Data[DataIndex];
+
+		// Both a type and an explicit identifier can give the same name : explicit identifiers first
+		FFlareQuestConditionKey Key;
+		bool Found = false;
+		for (int32 Pass = 0; Pass < 2 && !Found; Pass++)
+		{
+			for (int32 ConditionIndex = 0; ConditionIndex < Conditions.Num(); ConditionIndex++)
+			{
+				FFlareQuestConditionKey Candidate(Conditions[ConditionIndex]);
+				bool Explicit = (Candidate.Identifier != NAME_None);
+
+				if (Explicit == (Pass == 0) && !Progress.Contains(Candidate) && Candidate.GetSaveIdentifier() == ConditionData.ConditionIdentifier)
+				{
+					Key = Candidate;
+					Found = true;
+					break;
+				}
+			}
+		}
+
+		// Unknown condition, keep it as it was
+		if (!Found)
+		{
+			FLOGV("FFlareQuestStepProgress::Restore : no condition for progress '%s'", *ConditionData.ConditionIdentifier.ToString());
+			Key.Identifier = ConditionData.ConditionIdentifier;
+		}
+
+		FFlareQuestConditionProgress& ConditionProgress = Progress.Add(Key);
+		ConditionProgress.Counter = ConditionData.CurrentProgression;
+		ConditionProgress.InitialTransform = ConditionData.InitialTransform;
+		ConditionProgress.InitialVelocity = ConditionData.InitialVelocity;
+	}
+}
+
+void FFlareQuestStepProgress::Save(TArray<FFlareQuestStepProgressSave>& Data) const
+{
+	Data.Empty(Progress.Num());
+
+	for (int32 Pass = 0; Pass < 2; Pass++)
+	{
+		for (auto& Entry : Progress)
+		{
+			bool Explicit = (Entry.Key.Identifier != NAME_None);
+			if (Explicit == (Pass == 0))
+			{
+				FFlareQuestStepProgressSave ConditionData;
+				ConditionData.ConditionIdentifier = Entry.Key.GetSaveIdentifier();
+				ConditionData.CurrentProgression = Entry.Value.Counter;
+				ConditionData.InitialTransform = Entry.Value.InitialTransform;
+				ConditionData.InitialVelocity = Entry.Value.InitialVelocity;
+				Data.Add(ConditionData);
+			}
+		}
+	}
+}
+
+void FFlareQuestStepProgress::Reset()
+{
+	Progress.Empty();
+}
+
+
+/*----------------------------------------------------
+	Accessors
+----------------------------------------------------*/
+
+int32 FFlareQuestStepProgress::GetCounter(const FFlareQuestConditionKey& Key) const
+{
+	const FFlareQuestConditionProgress* ConditionProgress = Progress.Find(Key);
+	return (ConditionProgress ? ConditionProgress->Counter : 0);
+}
+
+void FFlareQuestStepProgress::SetCounter(const FFlareQuestConditionKey& Key, int32 Counter)
+{
+	Progress.FindOrAdd(Key).Counter = Counter;
+}
+
+const FTransform& FFlareQuestStepProgress::GetInitialTransform(const FFlareQuestConditionKey& Key) const
+{
+	const FFlareQuestConditionProgress* ConditionProgress = Progress.Find(Key);
+	return (ConditionProgress ? ConditionProgress->InitialTransform : FTransform::Identity);
+}
+
+void FFlareQuestStepProgress::SetInitialTransform(const FFlareQuestConditionKey& Key, const FTransform& InitialTransform)
+{
+	Progress.FindOrAdd(Key).InitialTransform = InitialTransform;
+}
+
+float FFlareQuestStepProgress::GetInitialVelocity(const FFlareQuestConditionKey& Key) const
+{
+	const FFlareQuestConditionProgress* ConditionProgress = Progress.Find(Key);
+	return (ConditionProgress ? ConditionProgress->InitialVelocity : 0);
+}
+
+void FFlareQuestStepProgress::SetInitialVelocity(const FFlareQuestConditionKey& Key, float InitialVelocity)
+{
+	Progress.FindOrAdd(Key).InitialVelocity = InitialVelocity;
+}
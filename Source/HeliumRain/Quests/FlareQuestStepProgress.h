@@ -0,0 +1,111 @@
+#pragma once
+
+#include "FlareQuestManager.h"
+
+struct FFlareQuestConditionDescription;
+
+
+/** Key of a stateful condition in the step progress */
+struct FFlareQuestConditionKey
+{
+	/** Explicit condition identifier, or none */
+	FName Identifier;
+
+	/** Condition type when there is no explicit identifier, -1 otherwise */
+	int32 Type;
+
+	FFlareQuestConditionKey()
+		: Identifier(NAME_None)
+		, Type(-1)
+	{}
+
+	explicit FFlareQuestConditionKey(const FFlareQuestConditionDescription* Condition);
+
+	/** Get the identifier used in saves, where type keys are the type number */
+	FName GetSaveIdentifier() const;
+
+	bool operator==(const FFlareQuestConditionKey& Other) const
+	{
+		return Type == Other.Type && Identifier == Other.Identifier;
+	}
+
+	friend uint32 GetTypeHash(const FFlareQuestConditionKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Identifier), GetTypeHash(Key.Type));
+	}
+};
+
+/** Progress of a stateful condition */
+struct FFlareQuestConditionProgress
+{
+	int32      Counter;
+	FTransform InitialTransform;
+	float      InitialVelocity;
+
+	FFlareQuestConditionProgress()
+		: Counter(0)
+		, InitialTransform(FTransform::Identity)
+		, InitialVelocity(0)
+	{}
+};
+
+
+/** Progress of the stateful conditions of the current quest step */
+class HELIUMRAIN_API FFlareQuestStepProgress
+{
+public:
+
+	/*----------------------------------------------------
+		Save
+	----------------------------------------------------*/
+
+	/** Restore the progress, matching the saved identifiers with the step conditions */
+	void Restore(const TArray<FFlareQuestStepProgressSave>& Data, const TArray<const FFlareQuestConditionDescription*>& Conditions);
+
+	/** Save the progress, explicit identifiers first so that restoring resolves collisions the same way */
+	void Save(TArray<FFlareQuestStepProgressSave>& Data) const;
+
+	/** Clear the progress for a new step */
+	void Reset();
+
+
+	/*----------------------------------------------------
+		Accessors
+	----------------------------------------------------*/
+
+	/** Check if the condition has started */
+	bool Contains(const FFlareQuestConditionKey& Key) const
+	{
+		return Progress.Contains(Key);
+	}
+
+	/** Get the counter of a condition, 0 if not started */
+	int32 GetCounter(const FFlareQuestConditionKey& Key) const;
+
+	void SetCounter(const FFlareQuestConditionKey& Key, int32 Counter);
+
+	/** Get the transform of the ship when the condition started, identity if not started */
+	const FTransform& GetInitialTransform(const FFlareQuestConditionKey& Key) const;
+
+	void SetInitialTransform(const FFlareQuestConditionKey& Key, const FTransform& InitialTransform);
+
+	/** Get the velocity of the ship when the condition started, 0 if not started */
+	float GetInitialVelocity(const FFlareQuestConditionKey& Key) const;
+
+	void SetInitialVelocity(const FFlareQuestConditionKey& Key, float InitialVelocity);
+
+	int32 Num() const
+	{
+		return Progress.Num();
+	}
+
+
+protected:
+
+	/*----------------------------------------------------
+		Protected data
+	----------------------------------------------------*/
+
+	TMap<FFlareQuestConditionKey, FFlareQuestConditionProgress> Progress;
+
+};
@@ -240,7 +240,8 @@ void UFlareShipPilot::CargoPilot(float DeltaSeconds)
 
 	if(PilotTargetShip)
 	{
-		// Already done
+		// Already done, and no more waiting for a dock
+		Ship->GetNavigationSystem()->CancelDockRequest();
 	}
 	else if (Ship->GetNavigationSystem()->IsDocked())
 	{
@@ -289,7 +290,12 @@ void UFlareShipPilot::CargoPilot(float DeltaSeconds)
 
 			if (Distance < 1000)
 			{
-				if (!Ship->GetNavigationSystem()->DockAt(PilotTargetStation))
+				// Queued ships hold position, the navigation system docks them once a dock is reserved
+				if (Ship->GetNavigationSystem()->GetDockingQueueStation() == PilotTargetStation)
+				{
+					LinearTargetVelocity = FVector::ZeroVector;
+				}
+				else if (!Ship->GetNavigationSystem()->DockAt(PilotTargetStation))
 				{
 					LinearTargetVelocity = -DeltaLocation.GetUnsafeNormal() * Ship->GetNavigationSystem()->GetLinearMaxVelocity();
 				}
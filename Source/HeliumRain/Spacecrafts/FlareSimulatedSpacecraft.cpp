@@ -85,6 +85,13 @@ void UFlareSimulatedSpacecraft::Load(const FFlareSpacecraftSave& Data)
 	// Lock resources
 	LockResources();
 
+	// Factories were recreated
+	if (IsStation() && CurrentSector)
+	{
+		CurrentSector->RefreshStationIndex(this);
+	}
+	GetCompany()->InvalidateSpacecraftValue(this);
+
 	if(ActiveSpacecraft)
 	{
 		ActiveSpacecraft->Load(this);
@@ -200,6 +207,7 @@ bool UFlareSimulatedSpacecraft::CanBeFlown(FText& OutInfo) const
 void UFlareSimulatedSpacecraft::SetCurrentSector(UFlareSimulatedSector* Sector)
 {
 	CurrentSector = Sector;
+	GetCompany()->InvalidateSpacecraftValue(this);
 
 	// Mark the sector as visited
 	if (!Sector->IsTravelSector())
@@ -5,6 +5,7 @@
 #include "FlareOrbitalEngine.h"
 #include "FlareRCS.h"
 #include "FlareWeapon.h"
+#include "FlareTurret.h"
 #include "FlareShipPilot.h"
 #include "FlareInternalComponent.h"
 
@@ -13,6 +14,7 @@
 #include "../Player/FlarePlayerController.h"
 #include "../Game/FlareGame.h"
 #include "../Game/FlareAsteroid.h"
+#include "../Game/FlareThermalSystem.h"
 #include "../Game/AI/FlareCompanyAI.h"
 
 #include "../UI/Menus/FlareShipMenu.h"
@@ -420,6 +422,12 @@ void AFlareSpacecraft::Destroyed()
 		{
 			Parent->SetActiveSpacecraft(NULL);
 		}
+
+		// Leave the docking queue
+		if (NavigationSystem)
+		{
+			NavigationSystem->CancelDockRequest();
+		}
 	}
 
 	// Stop lights
@@ -738,6 +746,20 @@ void AFlareSpacecraft::Load(UFlareSimulatedSpacecraft* ParentSpacecraft)
 	WeaponsSystem->Start();
 	SmoothedVelocity = GetLinearVelocity();
 
+	// Turret firing maps are baked once per ship class, at load
+	if (!IsPresentationMode() && Airframe->IsCollisionEnabled())
+	{
+		TArray<UFlareWeapon*>& Weapons = WeaponsSystem->GetWeaponList();
+		for (int32 WeaponIndex = 0; WeaponIndex < Weapons.Num(); WeaponIndex++)
+		{
+			UFlareTurret* Turret = Cast<UFlareTurret>(Weapons[WeaponIndex]);
+			if (Turret)
+			{
+				Turret->LoadFiringMap();
+			}
+		}
+	}
+
 	if (IsPaused())
 	{
 		Airframe->SetSimulatePhysics(false);
@@ -765,6 +787,9 @@ void AFlareSpacecraft::Save()
 		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
 		Component->Save();
 	}
+
+	// Save the ships waiting to dock
+	DockingSystem->Save();
 }
 
 void AFlareSpacecraft::SetOwnerCompany(UFlareCompany* NewCompany)
@@ -1140,6 +1165,8 @@ void AFlareSpacecraft::OnRepaired()
 		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
 		Component->OnRepaired();
 	}
+
+	GetGame()->GetThermalSystem()->InvalidateHeatSink(this);
 }
 
 void AFlareSpacecraft::OnRefilled()
@@ -1592,6 +1619,8 @@ void AFlareSpacecraft::ForceManual()
 	// TODO do better
 	if (!StateManager->IsPilotMode() && NavigationSystem->GetStatus() != EFlareShipStatus::SS_Docked)
 	{
+		// Flying by hand leaves the docking queue, so that a later grant doesn't take the controls
+		NavigationSystem->CancelDockRequest();
 		NavigationSystem->AbortAllCommands();
 	}
 }
@@ -310,6 +310,29 @@ struct FFlareFactorySave
 	int32 OrderShipAdvancePayment;
 };
 
+/** Pending docking request at a station */
+USTRUCT()
+struct FFlareDockingRequestSave
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Requesting ship */
+	UPROPERTY(EditAnywhere, Category = Save)
+	FName ShipImmatriculation;
+
+	/** Requested dock size */
+	UPROPERTY(EditAnywhere, Category = Save)
+	TEnumAsByte<EFlarePartSize::Type> Size;
+
+	/** Request priority, higher is served first */
+	UPROPERTY(EditAnywhere, Category = Save)
+	int32 Priority;
+
+	/** Time spent in the queue, in seconds */
+	UPROPERTY(EditAnywhere, Category = Save)
+	float WaitTime;
+};
+
 /** Spacecraft save data */
 USTRUCT()
 struct FFlareSpacecraftSave
@@ -427,6 +450,10 @@ struct FFlareSpacecraftSave
 	/** Actor to attach to */
 	UPROPERTY(EditAnywhere, Category = Save)
 	FName AttachActorName;
+
+	/** Ships waiting for a dock, in service order */
+	UPROPERTY(EditAnywhere, Category = Save)
+	TArray<FFlareDockingRequestSave> DockingQueue;
 	
 };
 
@@ -440,6 +467,32 @@ struct FFlareSpacecraftSlotGroupDescription
 	UPROPERTY(EditAnywhere, Category = Content) FText GroupName;
 };
 
+/** Self-occlusion map of a turret type on a ship slot, by gun, turret yaw and barrel pitch */
+USTRUCT()
+struct FFlareTurretFiringMap
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Ship slot the map was baked for */
+	UPROPERTY() FName SlotIdentifier;
+
+	/** Turret component the map was baked for */
+	UPROPERTY() FName TurretIdentifier;
+
+	UPROPERTY() int32 GunCount;
+
+	UPROPERTY() float YawMin;
+	UPROPERTY() float YawStep;
+	UPROPERTY() int32 YawCount;
+
+	UPROPERTY() float PitchMin;
+	UPROPERTY() float PitchStep;
+	UPROPERTY() int32 PitchCount;
+
+	/** 1 where the gun can fire without hitting its own ship */
+	UPROPERTY() TArray<uint8> SafeCells;
+};
+
 /** Catalog binding between FFlareSpacecraftDescription and FFlareSpacecraftComponentDescription structure */
 USTRUCT()
 struct FFlareSpacecraftSlotDescription
@@ -731,6 +784,9 @@ struct FFlareSpacecraftDescription
 	UPROPERTY(EditAnywhere, Category = Content)
 	bool IsSubstation;
 
+	/** Index in the spacecraft catalog, set by the catalog */
+	int32 CatalogIndex;
+
 
 	int32 GetCapacity();
 
@@ -4,6 +4,7 @@
 #include "FlareSpacecraft.h"
 #include "FlareShell.h"
 #include "FlareSpacecraftSubComponent.h"
+#include "../Game/FlareGame.h"
 
 DECLARE_CYCLE_STAT(TEXT("FlareTurret Tick"), STAT_FlareTurret_Tick, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareTurret Update"), STAT_FlareTurret_Update, STATGROUP_Flare);
@@ -11,6 +12,9 @@ DECLARE_CYCLE_STAT(TEXT("FlareTurret IsSafeToFire"), STAT_FlareTurret_IsSafeToFi
 DECLARE_CYCLE_STAT(TEXT("FlareTurret Trace"), STAT_FlareTurret_Trace, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareTurret IsReacheableAxis"), STAT_FlareTurret_IsReacheableAxis, STATGROUP_Flare);
 DECLARE_CYCLE_STAT(TEXT("FlareTurret GetMinLimitAtAngle"), STAT_FlareTurret_GetMinLimitAtAngle, STATGROUP_Flare);
+DECLARE_CYCLE_STAT(TEXT("FlareTurret BakeFiringMap"), STAT_FlareTurret_BakeFiringMap, STATGROUP_Flare);
+
+bool UFlareTurret::FiringMapValidation = false;
 
 
 /*----------------------------------------------------
@@ -310,8 +314,34 @@ bool UFlareTurret::IsSafeToFire(int GunIndex) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_FlareTurret_IsSafeToFire);
 
-	FVector FiringLocation = GetMuzzleLocation(GunIndex);
-	FVector FiringDirection = GetFireAxis();
+	const FFlareTurretFiringMap* Map = GetFiringMap();
+	if (!Map)
+	{
+		return IsSafeToFireTrace(GunIndex);
+	}
+
+	bool MapSafe = IsSafeInFiringMap(Map, GunIndex, ShipComponentData->Turret.TurretAngle, ShipComponentData->Turret.BarrelsAngle);
+	if (FiringMapValidation)
+	{
+		bool TraceSafe = IsSafeToFireTrace(GunIndex);
+		if (TraceSafe != MapSafe)
+		{
+			FLOGV("UFlareTurret::IsSafeToFire : %s gun %d at %f/%f : map %d, trace %d",
+				*GetReadableName(), GunIndex, ShipComponentData->Turret.TurretAngle, ShipComponentData->Turret.BarrelsAngle, MapSafe, TraceSafe);
+		}
+		return TraceSafe;
+	}
+
+	return MapSafe;
+}
+
+bool UFlareTurret::IsSafeToFireTrace(int GunIndex) const
+{
+	return IsSafeToFireTrace(GetMuzzleLocation(GunIndex), GetFireAxis());
+}
+
+bool UFlareTurret::IsSafeToFireTrace(const FVector& FiringLocation, const FVector& FiringDirection) const
+{
 	FVector TargetLocation = FiringLocation + FiringDirection * 100000;
 
 	FHitResult HitResult(ForceInit);
@@ -398,6 +428,245 @@ bool UFlareTurret::IsReacheableAxis(FVector TargetAxis) const
 	return true;
 }
 
+
+/*----------------------------------------------------
+	Firing map
+----------------------------------------------------*/
+
+void UFlareTurret::LoadFiringMap()
+{
+	if (!GetFiringMap())
+	{
+		BakeFiringMap();
+	}
+}
+
+const FFlareTurretFiringMap* UFlareTurret::GetFiringMap() const
+{
+	if (!Spacecraft || !ComponentDescription || !ShipComponentData)
+	{
+		return NULL;
+	}
+
+	const TArray<FFlareTurretFiringMap>* Maps = Spacecraft->GetGame()->FindTurretFiringMaps(Spacecraft->GetParent()->GetDescription()->Identifier);
+	if (Maps)
+	{
+		for (int32 i = 0; i < Maps->Num(); i++)
+		{
+			if ((*Maps)[i].SlotIdentifier == ShipComponentData->ShipSlotIdentifier && (*Maps)[i].TurretIdentifier == ComponentDescription->Identifier)
+			{
+				return &(*Maps)[i];
+			}
+		}
+	}
+	return NULL;
+}
+
+void UFlareTurret::BakeFiringMap()
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareTurret_BakeFiringMap);
+
+	if (!Spacecraft || !ComponentDescription || !ShipComponentData)
+	{
+		return;
+	}
+
+	// Setup the grid, the last sample is on the limit
+	const FFlareSpacecraftComponentTurretCharacteristics& Characteristics = ComponentDescription->WeaponCharacteristics.TurretCharacteristics;
+	FFlareTurretFiringMap Map;
+	Map.SlotIdentifier = ShipComponentData->ShipSlotIdentifier;
+	Map.TurretIdentifier = ComponentDescription->Identifier;
+	Map.GunCount = ComponentDescription->WeaponCharacteristics.GunCharacteristics.GunCount;
+	Map.YawMin = Characteristics.TurretMinAngle;
+	Map.YawStep = TURRET_FIRING_MAP_YAW_STEP;
+	Map.YawCount = TurretComponent ? FMath::CeilToInt((Characteristics.TurretMaxAngle - Characteristics.TurretMinAngle) / Map.YawStep) + 1 : 1;
+	Map.PitchMin = Characteristics.BarrelsMinAngle;
+	Map.PitchStep = TURRET_FIRING_MAP_PITCH_STEP;
+	Map.PitchCount = BarrelComponent ? FMath::CeilToInt((Characteristics.BarrelsMaxAngle - Characteristics.BarrelsMinAngle) / Map.PitchStep) + 1 : 1;
+	Map.YawCount = FMath::Max(Map.YawCount, 1);
+	Map.PitchCount = FMath::Max(Map.PitchCount, 1);
+	Map.SafeCells.SetNumZeroed(Map.GunCount * Map.YawCount * Map.PitchCount);
+
+	// Get the ship collision
+	TArray<UPrimitiveComponent*> Hull;
+	TArray<UActorComponent*> Components = Spacecraft->GetComponentsByClass(UPrimitiveComponent::StaticClass());
+	for (int32 i = 0; i < Components.Num(); i++)
+	{
+		UPrimitiveComponent* Component = Cast<UPrimitiveComponent>(Components[i]);
+		if (Component && Component->IsCollisionEnabled() && !Component->IsA(UFlareSpacecraftSubComponent::StaticClass()))
+		{
+			Hull.Add(Component);
+		}
+	}
+
+	// Sample every angle from the computed pose, the live turret doesn't move
+	int32 UnsafeCount = 0;
+	TArray<FVector> MuzzleLocations;
+	FVector FiringDirection;
+	for (int32 YawIndex = 0; YawIndex < Map.YawCount; YawIndex++)
+	{
+		float TurretAngle = FMath::Min(Map.YawMin + YawIndex * Map.YawStep, Characteristics.TurretMaxAngle);
+
+		for (int32 PitchIndex = 0; PitchIndex < Map.PitchCount; PitchIndex++)
+		{
+			float BarrelsAngle = FMath::Min(Map.PitchMin + PitchIndex * Map.PitchStep, Characteristics.BarrelsMaxAngle);
+			GetFiringPose(TurretAngle, BarrelsAngle, MuzzleLocations, FiringDirection);
+
+			for (int32 GunIndex = 0; GunIndex < Map.GunCount; GunIndex++)
+			{
+				FVector FiringLocation = MuzzleLocations[GunIndex];
+				bool Safe = !TraceOwnShip(FiringLocation, FiringLocation + FiringDirection * 100000, Hull);
+
+				Map.SafeCells[(GunIndex * Map.YawCount + YawIndex) * Map.PitchCount + PitchIndex] = Safe;
+				UnsafeCount += Safe ? 0 : 1;
+			}
+		}
+	}
+
+	// Replace the previous map of this turret type on this slot
+	TArray<FFlareTurretFiringMap>& Maps = Spacecraft->GetGame()->GetTurretFiringMaps(Spacecraft->GetParent()->GetDescription()->Identifier);
+	bool Replaced = false;
+	for (int32 i = 0; i < Maps.Num(); i++)
+	{
+		if (Maps[i].SlotIdentifier == Map.SlotIdentifier && Maps[i].TurretIdentifier == Map.TurretIdentifier)
+		{
+			Maps[i] = Map;
+			Replaced = true;
+		}
+	}
+	if (!Replaced)
+	{
+		Maps.Add(Map);
+	}
+
+	FLOGV("UFlareTurret::BakeFiringMap : %s on %s, %dx%d angles, %d unsafe cells",
+		*Map.TurretIdentifier.ToString(), *Map.SlotIdentifier.ToString(), Map.YawCount, Map.PitchCount, UnsafeCount);
+}
+
+void UFlareTurret::ValidateFiringMap(FRandomStream& Random, int32 SampleCount, int32& UnsafeCount, int32& OvercautiousCount, float& PoseError)
+{
+	UnsafeCount = 0;
+	OvercautiousCount = 0;
+	PoseError = 0;
+
+	LoadFiringMap();
+	const FFlareTurretFiringMap* Map = GetFiringMap();
+	if (!Map)
+	{
+		return;
+	}
+
+	// The computed muzzles, and points 1m along the fire axis, must match the live turret
+	TArray<FVector> MuzzleLocations;
+	FVector FiringDirection;
+	GetFiringPose(ShipComponentData->Turret.TurretAngle, ShipComponentData->Turret.BarrelsAngle, MuzzleLocations, FiringDirection);
+	for (int32 GunIndex = 0; GunIndex < Map->GunCount; GunIndex++)
+	{
+		PoseError = FMath::Max(PoseError, (MuzzleLocations[GunIndex] - GetMuzzleLocation(GunIndex)).Size());
+		PoseError = FMath::Max(PoseError, (MuzzleLocations[GunIndex] + FiringDirection * 100 - GetMuzzleLocation(GunIndex) - GetFireAxis() * 100).Size());
+	}
+
+	// Compare the map with the full trace at random angles
+	const FFlareSpacecraftComponentTurretCharacteristics& Characteristics = ComponentDescription->WeaponCharacteristics.TurretCharacteristics;
+	for (int32 Sample = 0; Sample < SampleCount; Sample++)
+	{
+		float TurretAngle = Random.FRandRange(Characteristics.TurretMinAngle, Characteristics.TurretMaxAngle);
+		float BarrelsAngle = Random.FRandRange(GetMinLimitAtAngle(TurretAngle), Characteristics.BarrelsMaxAngle);
+		GetFiringPose(TurretAngle, BarrelsAngle, MuzzleLocations, FiringDirection);
+
+		for (int32 GunIndex = 0; GunIndex < Map->GunCount; GunIndex++)
+		{
+			bool MapSafe = IsSafeInFiringMap(Map, GunIndex, TurretAngle, BarrelsAngle);
+			bool TraceSafe = IsSafeToFireTrace(MuzzleLocations[GunIndex], FiringDirection);
+			if (MapSafe && !TraceSafe)
+			{
+				UnsafeCount++;
+			}
+			else if (!MapSafe && TraceSafe)
+			{
+				OvercautiousCount++;
+			}
+		}
+	}
+}
+
+void UFlareTurret::GetFiringPose(float TurretAngle, float BarrelsAngle, TArray<FVector>& MuzzleLocations, FVector& FireAxis) const
+{
+	// Same attachment chain as the live components
+	FTransform GunTransform = GetComponentToWorld();
+	const UStaticMeshComponent* GunComponent = this;
+	if (TurretComponent)
+	{
+		FTransform TurretTransform = TurretComponent->GetRelativeTransform();
+		TurretTransform.SetRotation(FRotator(0, TurretAngle, 0).Quaternion());
+		GunTransform = TurretTransform * GunTransform;
+		GunComponent = TurretComponent;
+	}
+	if (BarrelComponent)
+	{
+		FTransform ParentTransform = GunTransform;
+		if (TurretComponent)
+		{
+			ParentTransform = TurretComponent->GetSocketTransform(FName("Axis"), RTS_Component) * GunTransform;
+		}
+
+		FTransform BarrelTransform = BarrelComponent->GetRelativeTransform();
+		BarrelTransform.SetRotation(FRotator(BarrelsAngle, 0, 0).Quaternion());
+		GunTransform = BarrelTransform * ParentTransform;
+		GunComponent = BarrelComponent;
+	}
+
+	FireAxis = (TurretComponent || BarrelComponent) ? GunTransform.GetRotation().RotateVector(FVector(1, 0, 0)) : Super::GetFireAxis();
+
+	// Muzzles
+	int32 GunCount = ComponentDescription->WeaponCharacteristics.GunCharacteristics.GunCount;
+	MuzzleLocations.SetNum(FMath::Max(GunCount, 1));
+	for (int32 GunIndex = 0; GunIndex < MuzzleLocations.Num(); GunIndex++)
+	{
+		FName SocketName = (GunCount <= 1) ? FName("Muzzle") : FName(*(FString("Muzzle") + FString::FromInt(GunIndex)));
+		MuzzleLocations[GunIndex] = (GunComponent->GetSocketTransform(SocketName, RTS_Component) * GunTransform).GetLocation();
+	}
+}
+
+bool UFlareTurret::IsSafeInFiringMap(const FFlareTurretFiringMap* Map, int GunIndex, float TurretAngle, float BarrelsAngle) const
+{
+	if (GunIndex < 0 || GunIndex >= Map->GunCount)
+	{
+		return IsSafeToFireTrace(GunIndex);
+	}
+
+	// Conservative lookup : unsafe if any of the surrounding samples is
+	float YawLocation = FMath::Clamp((TurretAngle - Map->YawMin) / Map->YawStep, 0.f, (float) (Map->YawCount - 1));
+	float PitchLocation = FMath::Clamp((BarrelsAngle - Map->PitchMin) / Map->PitchStep, 0.f, (float) (Map->PitchCount - 1));
+	int32 YawIndex = FMath::FloorToInt(YawLocation);
+	int32 PitchIndex = FMath::FloorToInt(PitchLocation);
+	int32 NextYawIndex = FMath::Min(YawIndex + 1, Map->YawCount - 1);
+	int32 NextPitchIndex = FMath::Min(PitchIndex + 1, Map->PitchCount - 1);
+
+	const uint8* Cells = &Map->SafeCells[GunIndex * Map->YawCount * Map->PitchCount];
+	return Cells[YawIndex * Map->PitchCount + PitchIndex] != 0
+		&& Cells[YawIndex * Map->PitchCount + NextPitchIndex] != 0
+		&& Cells[NextYawIndex * Map->PitchCount + PitchIndex] != 0
+		&& Cells[NextYawIndex * Map->PitchCount + NextPitchIndex] != 0;
+}
+
+bool UFlareTurret::TraceOwnShip(const FVector& Start, const FVector& End, const TArray<UPrimitiveComponent*>& Hull) const
+{
+	FCollisionQueryParams TraceParams(FName(TEXT("Turret Firing Map")), true, NULL);
+	TraceParams.bReturnPhysicalMaterial = false;
+
+	for (int32 i = 0; i < Hull.Num(); i++)
+	{
+		FHitResult HitResult(ForceInit);
+		if (FMath::LineBoxIntersection(Hull[i]->Bounds.GetBox(), Start, End, End - Start)
+		 && Hull[i]->LineTraceComponent(HitResult, Start, End, TraceParams))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 static inline int PositiveModulo(int i, int n)
 {
 	return (i % n + n) % n;
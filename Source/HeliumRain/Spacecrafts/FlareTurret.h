@@ -7,6 +7,12 @@
 
 class UFlareSpacecraftSubComponent;
 
+/** Turret yaw angle between two firing map samples */
+#define TURRET_FIRING_MAP_YAW_STEP 5.f
+
+/** Barrel pitch angle between two firing map samples */
+#define TURRET_FIRING_MAP_PITCH_STEP 2.5f
+
 UCLASS(Blueprintable, ClassGroup = (Flare, Ship), meta = (BlueprintSpawnableComponent))
 class UFlareTurret : public UFlareWeapon
 {
@@ -38,6 +44,21 @@ public:
 
 	virtual bool IsSafeToFire(int GunIndex) const;
 
+	/** Trace from a muzzle to check that the gun would not hit its own ship */
+	bool IsSafeToFireTrace(int GunIndex) const;
+
+	/** Bake the self-occlusion map of this turret type on its ship slot, unless its ship class already has it */
+	void LoadFiringMap();
+
+	/** Bake the self-occlusion map of this turret type on its ship slot, without moving the turret */
+	void BakeFiringMap();
+
+	/** Compare the firing map with the full trace at random angles, and count the unsafe and overcautious samples. PoseError is the distance between the computed and the live muzzles. */
+	void ValidateFiringMap(FRandomStream& Random, int32 SampleCount, int32& UnsafeCount, int32& OvercautiousCount, float& PoseError);
+
+	/** Get the muzzle locations and fire axis the turret would have at these angles */
+	void GetFiringPose(float TurretAngle, float BarrelsAngle, TArray<FVector>& MuzzleLocations, FVector& FireAxis) const;
+
 	virtual bool IsReacheableAxis(FVector TargetAxis) const;
 
 	virtual float GetMinLimitAtAngle(float Angle) const;
@@ -49,6 +70,28 @@ public:
 	// TODO Put in help with FlareShell::Trace
 	bool Trace(const FVector& Start, const FVector& End, FHitResult& HitOut) const;
 
+	/** Use live traces for firing checks, and log where the firing maps disagree */
+	static bool FiringMapValidation;
+
+
+protected:
+
+	/*----------------------------------------------------
+		Firing map
+	----------------------------------------------------*/
+
+	/** Get the firing map of this turret, NULL if not baked */
+	const FFlareTurretFiringMap* GetFiringMap() const;
+
+	/** Check a gun in the firing map, unsafe if any of the surrounding samples is */
+	bool IsSafeInFiringMap(const FFlareTurretFiringMap* Map, int GunIndex, float TurretAngle, float BarrelsAngle) const;
+
+	/** Trace from a location to check that a shot would not hit the ship */
+	bool IsSafeToFireTrace(const FVector& FiringLocation, const FVector& FiringDirection) const;
+
+	/** Trace against the collision of the ship, ignoring moving turret parts */
+	bool TraceOwnShip(const FVector& Start, const FVector& End, const TArray<UPrimitiveComponent*>& Hull) const;
+
 
 protected:
 
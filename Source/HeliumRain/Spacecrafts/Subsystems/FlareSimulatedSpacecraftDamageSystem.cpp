@@ -582,6 +582,12 @@ void UFlareSimulatedSpacecraftDamageSystem::SetDamageDirty(FFlareSpacecraftCompo
 	{
 		SetPowerDirty();
 	}
+
+	// Station efficiency changes the production time
+	if (Spacecraft->GetFactories().Num() > 0)
+	{
+		Spacecraft->GetGame()->GetGameWorld()->WakeFactories(Spacecraft);
+	}
 }
 
 void UFlareSimulatedSpacecraftDamageSystem::SetAmmoDirty()
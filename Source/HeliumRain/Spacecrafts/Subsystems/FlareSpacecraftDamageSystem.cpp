@@ -3,7 +3,9 @@
 
 #include "FlareSpacecraftDamageSystem.h"
 #include "../FlareSpacecraft.h"
+#include "../FlareSpacecraftSubComponent.h"
 #include "../../Game/FlareGame.h"
+#include "../../Game/FlareThermalSystem.h"
 #include "../../Player/FlarePlayerController.h"
 #include "../FlareEngine.h"
 #include "../FlareOrbitalEngine.h"
@@ -22,6 +24,7 @@ UFlareSpacecraftDamageSystem::UFlareSpacecraftDamageSystem(const class FObjectIn
 	: Super(PCIP)
 	, Spacecraft(NULL)
 	, LastDamageCauser(NULL)
+	, StationCockpitIndex(INDEX_NONE)
 {
 }
 
@@ -36,34 +39,7 @@ void UFlareSpacecraftDamageSystem::TickSystem(float DeltaSeconds)
 
 	Parent->TickSystem();
 
-	// Apply heat variation : add producted heat then substract radiated heat.
-
-	// Get the to heat production and heat sink surface
-	float HeatProduction = 0.f;
-	float HeatSinkSurface = 0.f;
-
-	for (int32 i = 0; i < Components.Num(); i++)
-	{
-		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[i]);
-		HeatProduction += Component->GetHeatProduction();
-		HeatSinkSurface += Component->GetHeatSinkSurface();
-	}
-
-	// Add a part of sun radiation to ship heat production
-	// Sun flow is 3.094KW/m^2 and keep only 10 % and modulate 90% by sun occlusion
-	HeatProduction += HeatSinkSurface * 3.094 * 0.1 * (1 - 0.9 * Spacecraft->GetGame()->GetPlanetarium()->GetSunOcclusion());
-
-	// Heat up
-	Data->Heat += HeatProduction * DeltaSeconds;
-	// Radiate: Stefan-Boltzmann constant=5.670373e-8
-	float Temperature = Data->Heat / Description->HeatCapacity;
-	float HeatRadiation = 0.f;
-	if (Temperature > 0)
-	{
-		HeatRadiation = HeatSinkSurface * 5.670373e-8 * FMath::Pow(Temperature, 4) / 1000;
-	}
-	// Don't radiate too much energy : negative temperature is not possible
-	Data->Heat -= FMath::Min(HeatRadiation * DeltaSeconds, Data->Heat);
+	// Heat variation is simulated for the whole sector by UFlareThermalSystem
 
 	// Power outage
 	if (Data->PowerOutageDelay > 0)
@@ -170,6 +146,7 @@ void UFlareSpacecraftDamageSystem::Start()
 {
 	// Reload components
 	Components = Spacecraft->GetComponentsByClass(UFlareSpacecraftComponent::StaticClass());
+	UpdateComponentTree();
 
 	Parent->TickSystem();
 
@@ -191,6 +168,9 @@ void UFlareSpacecraftDamageSystem::UpdatePower()
 		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
 		Component->UpdateLight();
 	}
+
+	// Damage and power change the heat sinks
+	Spacecraft->GetGame()->GetThermalSystem()->InvalidateHeatSink(Spacecraft);
 }
 
 void UFlareSpacecraftDamageSystem::OnSpacecraftDestroyed()
@@ -310,6 +290,7 @@ void UFlareSpacecraftDamageSystem::OnControlLost()
 	}
 
 	Spacecraft->GetNavigationSystem()->Undock();
+	Spacecraft->GetNavigationSystem()->CancelDockRequest();
 	Spacecraft->GetNavigationSystem()->AbortAllCommands();
 }
 
@@ -520,34 +501,15 @@ void UFlareSpacecraftDamageSystem::ApplyDamage(float Energy, float Radius, FVect
 
 	UFlareCompany* CompanyDamageSource = (DamageSource ? DamageSource->GetCompany() : NULL);
 
+	TArray<FFlareComponentHit> Hits;
+	GetDamagedComponents(Radius, Location, Hits);
+
 	FVector LocalLocation = Spacecraft->GetRootComponent()->GetComponentTransform().InverseTransformPosition(Location) / 100.f;
-	CombatLog::SpacecraftDamaged(Spacecraft->GetParent(), Energy, Radius, LocalLocation, DamageType, CompanyDamageSource);
+	CombatLog::SpacecraftDamaged(Spacecraft->GetParent(), Energy, Radius, LocalLocation, DamageType, CompanyDamageSource, Hits.Num());
 
-	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	for (int32 HitIndex = 0; HitIndex < Hits.Num(); HitIndex++)
 	{
-		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
-		bool IsStationCockpit = Spacecraft->IsStation() && Spacecraft->GetCockpit() == Component;
-
-		float ComponentSize;
-		FVector ComponentLocation;
-		Component->GetBoundingSphere(ComponentLocation, ComponentSize);
-
-		float Distance = (ComponentLocation - Location).Size() / 100.0f;
-		float IntersectDistance =  Radius + ComponentSize/100 - Distance;
-
-		//DrawDebugSphere(Spacecraft->GetWorld(), ComponentLocation, ComponentSize, 12, FColor::Green, true);
-
-		// Hit this component
-		if (IntersectDistance > 0 || IsStationCockpit)
-		{
-			//FLOGV("Component %s. ComponentSize=%f, Distance=%f, IntersectDistance=%f", *(Component->GetReadableName()), ComponentSize, Distance, IntersectDistance);
-			float Efficiency = FMath::Clamp(IntersectDistance / Radius , 0.0f, 1.0f);
-			if(IsStationCockpit)
-			{
-				Efficiency = 1;
-			}
-			float InflictedDamageRatio = Component->ApplyDamage(Energy * Efficiency, DamageType, CompanyDamageSource);
-		}
+		Hits[HitIndex].Component->ApplyDamage(Energy * Hits[HitIndex].Efficiency, DamageType, CompanyDamageSource);
 	}
 
 	// Update power
@@ -572,6 +534,133 @@ void UFlareSpacecraftDamageSystem::ApplyDamage(float Energy, float Radius, FVect
 	}
 }
 
+void UFlareSpacecraftDamageSystem::GetDamagedComponents(float Radius, FVector Location, TArray<FFlareComponentHit>& Hits) const
+{
+	FTransform RootTransform = Spacecraft->GetRootComponent()->GetComponentTransform();
+	float Scale = RootTransform.GetMaximumAxisScale();
+	bool UseTree = (ComponentTreeItems.Num() == Components.Num());
+
+	// Find the fixed components near the sphere, with one more centimeter against the rounding in spacecraft space
+	TArray<int32> Candidates;
+	if (UseTree)
+	{
+		TArray<int32> Items;
+		ComponentTree.Overlap(RootTransform.InverseTransformPosition(Location), (Radius * 100 + 1) / Scale, Items);
+		for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ItemIndex++)
+		{
+			Candidates.Add(ComponentTreeIndexes[Items[ItemIndex]]);
+		}
+
+		// Moving components are all tested, and the station cockpit is always hit
+		Candidates.Append(MovingComponentIndexes);
+		if (StationCockpitIndex != INDEX_NONE)
+		{
+			Candidates.AddUnique(StationCockpitIndex);
+		}
+
+		// Damage the components in their usual order
+		Candidates.Sort();
+	}
+	else
+	{
+		for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+		{
+			Candidates.Add(ComponentIndex);
+		}
+	}
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
+	{
+		int32 ComponentIndex = Candidates[CandidateIndex];
+		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
+		bool IsStationCockpit = (UseTree ? ComponentIndex == StationCockpitIndex : Spacecraft->IsStation() && Component == Spacecraft->GetCockpit());
+
+		float ComponentSize;
+		FVector ComponentLocation;
+		int32 Item = (UseTree ? ComponentTreeItems[ComponentIndex] : INDEX_NONE);
+		if (Item != INDEX_NONE)
+		{
+			ComponentLocation = RootTransform.TransformPosition(ComponentTree.GetCenter(Item));
+			ComponentSize = ComponentTree.GetRadius(Item) * Scale;
+		}
+		else
+		{
+			Component->GetBoundingSphere(ComponentLocation, ComponentSize);
+		}
+
+		float Distance = (ComponentLocation - Location).Size() / 100.0f;
+		float IntersectDistance =  Radius + ComponentSize/100 - Distance;
+
+		// Hit this component
+		if (IntersectDistance > 0 || IsStationCockpit)
+		{
+			FFlareComponentHit Hit;
+			Hit.Component = Component;
+			Hit.Efficiency = FMath::Clamp(IntersectDistance / Radius , 0.0f, 1.0f);
+			if(IsStationCockpit)
+			{
+				Hit.Efficiency = 1;
+			}
+			Hits.Add(Hit);
+		}
+	}
+}
+
+void UFlareSpacecraftDamageSystem::UpdateComponentTree()
+{
+	FTransform RootTransform = Spacecraft->GetRootComponent()->GetComponentTransform();
+	float Scale = RootTransform.GetMaximumAxisScale();
+	UFlareSpacecraftComponent* StationCockpit = (Spacecraft->IsStation() ? Spacecraft->GetCockpit() : NULL);
+
+	TArray<FVector> Centers;
+	TArray<float> Radii;
+	ComponentTreeItems.Reset();
+	ComponentTreeIndexes.Reset();
+	MovingComponentIndexes.Reset();
+	StationCockpitIndex = INDEX_NONE;
+
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	{
+		UFlareSpacecraftComponent* Component = Cast<UFlareSpacecraftComponent>(Components[ComponentIndex]);
+		if (Component == StationCockpit)
+		{
+			StationCockpitIndex = ComponentIndex;
+		}
+
+		// Turret and barrel spheres follow the aim
+		if (Component->IsA(UFlareSpacecraftSubComponent::StaticClass()))
+		{
+			ComponentTreeItems.Add(INDEX_NONE);
+			MovingComponentIndexes.Add(ComponentIndex);
+			continue;
+		}
+
+		float ComponentSize;
+		FVector ComponentLocation;
+		Component->GetBoundingSphere(ComponentLocation, ComponentSize);
+
+		ComponentTreeItems.Add(Centers.Num());
+		ComponentTreeIndexes.Add(ComponentIndex);
+		Centers.Add(RootTransform.InverseTransformPosition(ComponentLocation));
+		Radii.Add(ComponentSize / Scale);
+	}
+
+	// Same components, only their meshes may have changed
+	if (ComponentTreeComponents == Components && ComponentTree.Num() == Centers.Num())
+	{
+		for (int32 Item = 0; Item < Centers.Num(); Item++)
+		{
+			ComponentTree.SetSphere(Item, Centers[Item], Radii[Item]);
+		}
+		ComponentTree.Refit();
+	}
+	else
+	{
+		ComponentTree.Build(Centers, Radii);
+		ComponentTreeComponents = Components;
+	}
+}
+
 void UFlareSpacecraftDamageSystem::OnElectricDamage(float DamageRatio)
 {
 	float MaxPower = 0.f;
@@ -636,4 +725,150 @@ float UFlareSpacecraftDamageSystem::GetOverheatRatio(float HalfRatio) const
 	}
 }
 
+
+/*----------------------------------------------------
+	Sphere tree
+----------------------------------------------------*/
+
+void FFlareSphereTree::Build(const TArray<FVector>& NewCenters, const TArray<float>& NewRadii)
+{
+	Centers = NewCenters;
+	Radii = NewRadii;
+	Nodes.Empty(FMath::Max(2 * Centers.Num() - 1, 0));
+	ItemNodes.SetNumUninitialized(Centers.Num());
+
+	TArray<int32> Items;
+	for (int32 Item = 0; Item < Centers.Num(); Item++)
+	{
+		Items.Add(Item);
+	}
+
+	if (Items.Num() > 0)
+	{
+		BuildNode(Items, 0, Items.Num());
+	}
+}
+
+int32 FFlareSphereTree::BuildNode(TArray<int32>& Items, int32 First, int32 Count)
+{
+	int32 NodeIndex = Nodes.AddUninitialized(1);
+
+	// Leaf
+	if (Count == 1)
+	{
+		int32 Item = Items[First];
+		FNode& Node = Nodes[NodeIndex];
+		Node.Center = Centers[Item];
+		Node.Radius = Radii[Item];
+		Node.Left = INDEX_NONE;
+		Node.Right = INDEX_NONE;
+		Node.Item = Item;
+		ItemNodes[Item] = NodeIndex;
+		return NodeIndex;
+	}
+
+	// Split at the median of the longest axis
+	FBox Bounds(0);
+	for (int32 Index = First; Index < First + Count; Index++)
+	{
+		Bounds += Centers[Items[Index]];
+	}
+	FVector Extent = Bounds.GetExtent();
+	int32 Axis = (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+
+	const TArray<FVector>& ItemCenters = Centers;
+	Sort(Items.GetData() + First, Count, [&ItemCenters, Axis](const int32& A, const int32& B)
+	{
+		return ItemCenters[A][Axis] < ItemCenters[B][Axis];
+	});
+
+	int32 LeftCount = Count / 2;
+	int32 Left = BuildNode(Items, First, LeftCount);
+	int32 Right = BuildNode(Items, First + LeftCount, Count - LeftCount);
+
+	// Nodes may have moved while building the children
+	FNode& Node = Nodes[NodeIndex];
+	Node.Left = Left;
+	Node.Right = Right;
+	Node.Item = INDEX_NONE;
+	MergeSpheres(Nodes[Left].Center, Nodes[Left].Radius, Nodes[Right].Center, Nodes[Right].Radius, Node.Center, Node.Radius);
+
+	return NodeIndex;
+}
+
+void FFlareSphereTree::SetSphere(int32 Item, FVector Center, float Radius)
+{
+	Centers[Item] = Center;
+	Radii[Item] = Radius;
+
+	FNode& Node = Nodes[ItemNodes[Item]];
+	Node.Center = Center;
+	Node.Radius = Radius;
+}
+
+void FFlareSphereTree::Refit()
+{
+	// Children are stored after their parent
+	for (int32 NodeIndex = Nodes.Num() - 1; NodeIndex >= 0; NodeIndex--)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		if (Node.Item == INDEX_NONE)
+		{
+			MergeSpheres(Nodes[Node.Left].Center, Nodes[Node.Left].Radius, Nodes[Node.Right].Center, Nodes[Node.Right].Radius, Node.Center, Node.Radius);
+		}
+	}
+}
+
+void FFlareSphereTree::Overlap(FVector Center, float Radius, TArray<int32>& Items) const
+{
+	if (Nodes.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<64> > Stack;
+	Stack.Add(0);
+
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = Nodes[Stack.Pop(false)];
+
+		// Leaves use the exact test, nodes have a margin against rounding in the merged bounds
+		if (Node.Item != INDEX_NONE)
+		{
+			if (IntersectSpheres(Center, Radius, Node.Center, Node.Radius))
+			{
+				Items.Add(Node.Item);
+			}
+		}
+		else if ((Node.Center - Center).Size() < Node.Radius + Radius + KINDA_SMALL_NUMBER * (1 + Node.Radius + Radius))
+		{
+			Stack.Add(Node.Left);
+			Stack.Add(Node.Right);
+		}
+	}
+}
+
+void FFlareSphereTree::MergeSpheres(FVector CenterA, float RadiusA, FVector CenterB, float RadiusB, FVector& Center, float& Radius)
+{
+	float Distance = (CenterB - CenterA).Size();
+
+	// One sphere contains the other
+	if (Distance + RadiusB <= RadiusA)
+	{
+		Center = CenterA;
+		Radius = RadiusA;
+	}
+	else if (Distance + RadiusA <= RadiusB)
+	{
+		Center = CenterB;
+		Radius = RadiusB;
+	}
+	else
+	{
+		Radius = (Distance + RadiusA + RadiusB) / 2;
+		Center = CenterA + (CenterB - CenterA) * ((Radius - RadiusA) / Distance);
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -2,11 +2,87 @@
 #include "FlareSpacecraftDamageSystem.generated.h"
 
 class AFlareSpacecraft;
+class UFlareSpacecraftComponent;
 class UFlareSimulatedSpacecraftDamageSystem;
 struct FFlareSpacecraftSave;
 struct FFlareSpacecraftDescription;
 
 
+/** Bounding sphere hierarchy, for sphere overlap queries on many spheres */
+struct FFlareSphereTree
+{
+public:
+
+	/** Build the hierarchy from scratch */
+	void Build(const TArray<FVector>& Centers, const TArray<float>& Radii);
+
+	/** Move or resize a sphere. Refit must be called before the next query */
+	void SetSphere(int32 Item, FVector Center, float Radius);
+
+	/** Update the node bounds after spheres changed, keeping the hierarchy */
+	void Refit();
+
+	/** Get the spheres that intersect a query sphere */
+	void Overlap(FVector Center, float Radius, TArray<int32>& Items) const;
+
+	/** Get the sphere that encloses two spheres */
+	static void MergeSpheres(FVector CenterA, float RadiusA, FVector CenterB, float RadiusB, FVector& Center, float& Radius);
+
+	/** Check if a sphere intersects a query sphere, the same way the tree does */
+	static bool IntersectSpheres(FVector CenterA, float RadiusA, FVector CenterB, float RadiusB)
+	{
+		return RadiusA + RadiusB - (CenterA - CenterB).Size() > 0;
+	}
+
+	inline int32 Num() const
+	{
+		return Centers.Num();
+	}
+
+	inline FVector GetCenter(int32 Item) const
+	{
+		return Centers[Item];
+	}
+
+	inline float GetRadius(int32 Item) const
+	{
+		return Radii[Item];
+	}
+
+protected:
+
+	/** Create the node of Items[First, First + Count) and its children, and return its index */
+	int32 BuildNode(TArray<int32>& Items, int32 First, int32 Count);
+
+	/** Node, a leaf if Item is not INDEX_NONE */
+	struct FNode
+	{
+		FVector Center;
+		float Radius;
+		int32 Left;
+		int32 Right;
+		int32 Item;
+	};
+
+	// Spheres
+	TArray<FVector>                                 Centers;
+	TArray<float>                                   Radii;
+
+	// Hierarchy, children after their parent
+	TArray<FNode>                                   Nodes;
+	TArray<int32>                                   ItemNodes;
+};
+
+/** Component touched by area damage */
+struct FFlareComponentHit
+{
+	UFlareSpacecraftComponent* Component;
+
+	/** Fraction of the damage energy the component receives */
+	float Efficiency;
+};
+
+
 /** Spacecraft damage system class */
 UCLASS()
 class HELIUMRAIN_API UFlareSpacecraftDamageSystem : public UObject
@@ -58,6 +134,9 @@ public:
 
 	virtual void ApplyDamage(float Energy, float Radius, FVector Location, EFlareDamage::Type DamageType, UFlareSimulatedSpacecraft* DamageSource);
 
+	/** Get the components a damage sphere touches, with their share of the damage. Radius is in meters */
+	void GetDamagedComponents(float Radius, FVector Location, TArray<FFlareComponentHit>& Hits) const;
+
 
 
 protected:
@@ -71,6 +150,9 @@ protected:
 
 	virtual void CheckRecovery();
 
+	/** Store the bounding spheres of the fixed components in spacecraft space, rebuilding the tree if the components changed */
+	void UpdateComponentTree();
+
 
 
 	/*----------------------------------------------------
@@ -85,6 +167,16 @@ protected:
 	UFlareSimulatedSpacecraftDamageSystem*          Parent;
 	TArray<UActorComponent*>                        Components;
 
+	// Fixed component bounding spheres in spacecraft space, and the tree item of each component or INDEX_NONE
+	FFlareSphereTree                                ComponentTree;
+	TArray<UActorComponent*>                        ComponentTreeComponents;
+	TArray<int32>                                   ComponentTreeItems;
+	TArray<int32>                                   ComponentTreeIndexes;
+
+	// Turret and barrel components move with their aim, and are tested one by one
+	TArray<int32>                                   MovingComponentIndexes;
+	int32                                           StationCockpitIndex;
+
 	bool                                            WasControllable; // True if was controllable at the last tick
 	bool                                            WasAlive;
 	float											TimeSinceLastExternalDamage;
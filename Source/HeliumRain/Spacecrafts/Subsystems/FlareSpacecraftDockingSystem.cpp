@@ -4,6 +4,8 @@
 #include "FlareSpacecraftDockingSystem.h"
 #include "../FlareStationDock.h"
 #include "../FlareSpacecraft.h"
+#include "../../Game/FlareGame.h"
+#include "../../Player/FlarePlayerController.h"
 
 DECLARE_CYCLE_STAT(TEXT("FlareDockingSystem Tick"), STAT_FlareDockingSystem_Tick, STATGROUP_Flare);
 
@@ -28,6 +30,11 @@ UFlareSpacecraftDockingSystem::UFlareSpacecraftDockingSystem(const class FObject
 
 void UFlareSpacecraftDockingSystem::TickSystem(float DeltaSeconds)
 {
+	if (DockingSlots.Num())
+	{
+		Traffic.Tick(DeltaSeconds);
+		UpdateDockingSlots();
+	}
 }
 
 void UFlareSpacecraftDockingSystem::Initialize(AFlareSpacecraft* OwnerSpacecraft, FFlareSpacecraftSave* OwnerData)
@@ -73,142 +80,677 @@ void UFlareSpacecraftDockingSystem::Start()
 			Count++;
 		}
 	}
+
+	// Setup traffic control
+	TArray<int32> Lanes;
+	ComputeLanes(Lanes);
+	Traffic.Reset();
+	for (int32 i = 0; i < DockingSlots.Num(); i++)
+	{
+		Traffic.AddSlot(DockingSlots[i].DockSize, Lanes[i]);
+	}
+
+	// Ships waiting when the game was saved
+	if (DockingSlots.Num())
+	{
+		Traffic.LoadQueue(Data->DockingQueue);
+		UpdateDockingSlots();
+	}
+}
+
+void UFlareSpacecraftDockingSystem::Save()
+{
+	Data->DockingQueue = Traffic.SaveQueue();
 }
 
 bool UFlareSpacecraftDockingSystem::HasCompatibleDock(AFlareSpacecraft* Ship) const
 {
+	return Traffic.HasSlot(Ship->GetSize());
+}
+
+FFlareDockingInfo UFlareSpacecraftDockingSystem::RequestDock(AFlareSpacecraft* Ship, FVector PreferredLocation)
+{
+	// Default values
+	FFlareDockingInfo Info;
+	Info.Granted = false;
+	Info.Station = Spacecraft;
+
+	// Already there
+	if (IsDockedShip(Ship))
+	{
+		FLOG("UFlareSpacecraftDockingSystem::RequestDock : already docked");
+		return Info;
+	}
+
+	// Prefer the nearest docks
+	TArray<float> DockDistances;
+	FTransform AirframeTransform = Spacecraft->Airframe->GetComponentToWorld();
 	for (int32 i = 0; i < DockingSlots.Num(); i++)
 	{
-		if (DockingSlots[i].DockSize == Ship->GetSize())
+		DockDistances.Add((AirframeTransform.TransformPosition(DockingSlots[i].LocalLocation) - PreferredLocation).Size());
+	}
+
+	// Time to reach the station at full speed, velocity is in m/s
+	float MaxVelocity = FMath::Max(Ship->GetNavigationSystem()->GetLinearMaxVelocity(), 1.f);
+	float ApproachDuration = (Spacecraft->GetActorLocation() - Ship->GetActorLocation()).Size() / (100 * MaxVelocity);
+
+	int32 DockId = Traffic.Request(Ship->GetImmatriculation(), Ship->GetSize(), GetDockingPriority(Ship), ApproachDuration, DockDistances);
+
+	if (DockId >= 0)
+	{
+		FLOGV("UFlareSpacecraftDockingSystem::RequestDock : found valid dock %d", DockId);
+		DockingSlots[DockId].Ship = Ship;
+		UpdateDockingSlots();
+		return DockingSlots[DockId];
+	}
+
+	return Info;
+}
+
+void UFlareSpacecraftDockingSystem::CancelDockRequest(AFlareSpacecraft* Ship)
+{
+	Traffic.Cancel(Ship->GetImmatriculation());
+	UpdateDockingSlots();
+}
+
+void UFlareSpacecraftDockingSystem::ReleaseDock(AFlareSpacecraft* Ship, int32 DockId)
+{
+	FLOGV("UFlareSpacecraftDockingSystem::ReleaseDock %d ('%s')", DockId, *Ship->GetParent()->GetImmatriculation().ToString());
+	Traffic.Release(Ship->GetImmatriculation(), DockId);
+	UpdateDockingSlots();
+}
+
+void UFlareSpacecraftDockingSystem::Dock(AFlareSpacecraft* Ship, int32 DockId)
+{
+	FLOGV("UFlareSpacecraftDockingSystem::Dock %d ('%s')", DockId, *Ship->GetParent()->GetImmatriculation().ToString());
+	if (DockingSlots.IsValidIndex(DockId))
+	{
+		Traffic.Dock(Ship->GetImmatriculation(), DockId);
+		DockingSlots[DockId].Ship = Ship;
+		UpdateDockingSlots();
+	}
+}
+
+const TArray<AFlareSpacecraft*>& UFlareSpacecraftDockingSystem::GetDockedShips()
+{
+	return DockedShips;
+}
+
+bool UFlareSpacecraftDockingSystem::HasAvailableDock(AFlareSpacecraft* Ship) const
+{
+	return Traffic.HasFreeSlot(Ship->GetSize());
+}
+
+int UFlareSpacecraftDockingSystem::GetDockCount() const
+{
+	return DockingSlots.Num();
+}
+
+FFlareDockingInfo UFlareSpacecraftDockingSystem::GetDockInfo(int32 DockId)
+{
+	return DockingSlots[DockId];
+}
+
+bool UFlareSpacecraftDockingSystem::IsGrantedShip(AFlareSpacecraft* ShipCanditate) const
+{
+	return Traffic.GetShipState(ShipCanditate->GetImmatriculation()) >= EFlareDockState::Granted;
+}
+
+bool UFlareSpacecraftDockingSystem::IsDockedShip(AFlareSpacecraft* ShipCanditate) const
+{
+	return Traffic.GetShipState(ShipCanditate->GetImmatriculation()) == EFlareDockState::Occupied;
+}
+
+bool UFlareSpacecraftDockingSystem::IsQueuedShip(AFlareSpacecraft* ShipCanditate) const
+{
+	FName Immatriculation = ShipCanditate->GetImmatriculation();
+	return Traffic.IsQueued(Immatriculation) || Traffic.GetShipState(Immatriculation) == EFlareDockState::Reserved;
+}
+
+int32 UFlareSpacecraftDockingSystem::GetQueuePosition(AFlareSpacecraft* ShipCanditate) const
+{
+	return Traffic.GetQueuePosition(ShipCanditate->GetImmatriculation());
+}
+
+float UFlareSpacecraftDockingSystem::GetEstimatedWait(AFlareSpacecraft* ShipCanditate) const
+{
+	return Traffic.GetEstimatedWait(ShipCanditate->GetImmatriculation());
+}
+
+
+/*----------------------------------------------------
+	Internals
+----------------------------------------------------*/
+
+void UFlareSpacecraftDockingSystem::ComputeLanes(TArray<int32>& Lanes) const
+{
+	int32 LaneCount = 0;
+	Lanes.Init(-1, DockingSlots.Num());
+
+	for (int32 i = 0; i < DockingSlots.Num(); i++)
+	{
+		// Docks facing the same way, close to the same axis, are approached through the same corridor
+		for (int32 j = 0; j < i; j++)
 		{
-			return true;
+			FVector Axis = DockingSlots[j].LocalAxis.GetSafeNormal();
+			FVector Delta = DockingSlots[i].LocalLocation - DockingSlots[j].LocalLocation;
+			float LateralDistance = (Delta - (Delta | Axis) * Axis).Size();
+
+			if ((DockingSlots[i].LocalAxis.GetSafeNormal() | Axis) > 0.99f && LateralDistance < DOCK_LANE_RADIUS)
+			{
+				Lanes[i] = Lanes[j];
+				break;
+			}
+		}
+
+		if (Lanes[i] < 0)
+		{
+			Lanes[i] = LaneCount++;
 		}
 	}
-	return false;
 }
 
-FFlareDockingInfo UFlareSpacecraftDockingSystem::RequestDock(AFlareSpacecraft* Ship, FVector PreferredLocation)
+void UFlareSpacecraftDockingSystem::UpdateDockingSlots()
 {
-	FLOGV("UFlareSpacecraftDockingSystem::RequestDock ('%s')", *Ship->GetImmatriculation().ToString());
-
-	int32 BestIndex = -1;
-	float BestDistance = 0;
+	const TArray<FFlareDockingSlotState>& Slots = Traffic.GetSlots();
+	DockedShips.Reset();
 
-	// Looking for nearest available slot
 	for (int32 i = 0; i < DockingSlots.Num(); i++)
 	{
-		if (!DockingSlots[i].Granted && DockingSlots[i].DockSize == Ship->GetSize())
+		FFlareDockingInfo& Info = DockingSlots[i];
+		Info.Granted = (Slots[i].State != EFlareDockState::Free);
+		Info.Occupied = (Slots[i].State == EFlareDockState::Occupied);
+
+		// Reserved docks are locked, but the ship will only be known when it asks again
+		if (Slots[i].State == EFlareDockState::Free || Slots[i].State == EFlareDockState::Reserved)
+		{
+			Info.Ship = NULL;
+		}
+		else if (Info.Occupied && Info.Ship)
+		{
+			DockedShips.AddUnique(Info.Ship);
+		}
+	}
+}
+
+int32 UFlareSpacecraftDockingSystem::GetDockingPriority(AFlareSpacecraft* Ship) const
+{
+	if (Ship->GetParent() == Ship->GetGame()->GetPC()->GetPlayerShip())
+	{
+		return EFlareDockingPriority::Player;
+	}
+	else if (Ship->GetCompany() == Spacecraft->GetCompany())
+	{
+		return EFlareDockingPriority::Company;
+	}
+	else
+	{
+		return EFlareDockingPriority::Normal;
+	}
+}
+
+
+/*----------------------------------------------------
+	Traffic control
+----------------------------------------------------*/
+
+FFlareDockingTraffic::FFlareDockingTraffic()
+{
+	Reset();
+}
+
+void FFlareDockingTraffic::Reset()
+{
+	Slots.Empty();
+	ShipSlots.Empty();
+	LaneFreeTimes.Empty();
+	Queue.Empty();
+	QueuedShips.Empty();
+
+	for (int32 Size = 0; Size < EFlarePartSize::Num; Size++)
+	{
+		SlotCounts[Size] = 0;
+		FreeCounts[Size] = 0;
+	}
+
+	NextSequence = 0;
+	Time = 0;
+	AverageOccupancy = DOCK_DEFAULT_OCCUPANCY;
+}
+
+int32 FFlareDockingTraffic::AddSlot(EFlarePartSize::Type Size, int32 Lane)
+{
+	FFlareDockingSlotState Slot;
+	Slot.Ship = NAME_None;
+	Slot.Size = Size;
+	Slot.Lane = Lane;
+	Slot.State = EFlareDockState::Free;
+	Slot.Priority = EFlareDockingPriority::Normal;
+	Slot.StateTime = Time;
+	Slot.ApproachTime = 0;
+
+	while (LaneFreeTimes.Num() <= Lane)
+	{
+		LaneFreeTimes.Add(0);
+	}
+
+	SlotCounts[Size]++;
+	FreeCounts[Size]++;
+	return Slots.Add(Slot);
+}
+
+void FFlareDockingTraffic::Tick(float DeltaSeconds)
+{
+	Time += DeltaSeconds;
+
+	// Forget the ships that stopped asking
+	for (int32 Index = Queue.Num() - 1; Index >= 0; Index--)
+	{
+		if (Time - Queue[Index].LastRequestTime > DOCK_REQUEST_TIMEOUT)
+		{
+			FLOGV("FFlareDockingTraffic::Tick : request from '%s' timed out", *Queue[Index].Ship.ToString());
+			QueuedShips.Remove(Queue[Index].Ship);
+			Queue.RemoveAt(Index);
+		}
+	}
+
+	// Give back the docks nobody claimed
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); SlotIndex++)
+	{
+		if (Slots[SlotIndex].State == EFlareDockState::Reserved && Time - Slots[SlotIndex].StateTime > DOCK_RESERVATION_TIMEOUT)
 		{
-			float DockDistance = (Spacecraft->Airframe->GetComponentToWorld().TransformPosition(DockingSlots[i].LocalLocation) - PreferredLocation).Size();
-			if (BestIndex < 0 || DockDistance < BestDistance)
+			FLOGV("FFlareDockingTraffic::Tick : dock %d reserved for '%s' timed out", SlotIndex, *Slots[SlotIndex].Ship.ToString());
+			SetSlotState(SlotIndex, NAME_None, EFlareDockState::Free);
+			ServeQueue(Slots[SlotIndex].Size);
+		}
+	}
+}
+
+int32 FFlareDockingTraffic::Request(FName Ship, EFlarePartSize::Type Size, int32 Priority, float ApproachDuration, const TArray<float>& SlotCosts)
+{
+	// Already has a dock, claim it if it was waiting
+	const int32* ShipSlot = ShipSlots.Find(Ship);
+	if (ShipSlot)
+	{
+		int32 SlotIndex = *ShipSlot;
+		if (Slots[SlotIndex].State == EFlareDockState::Reserved)
+		{
+			SetSlotState(SlotIndex, Ship, EFlareDockState::Granted);
+			Slots[SlotIndex].ApproachTime = ReserveLane(Slots[SlotIndex].Lane, Time + ApproachDuration);
+		}
+		return SlotIndex;
+	}
+
+	// Already waiting
+	if (QueuedShips.Contains(Ship))
+	{
+		for (int32 Index = 0; Index < Queue.Num(); Index++)
+		{
+			if (Queue[Index].Ship == Ship)
 			{
-				BestDistance = DockDistance;
-				BestIndex = i;
+				Queue[Index].LastRequestTime = Time;
+				break;
 			}
 		}
+		return -1;
 	}
 
-	if (BestIndex >=0)
+	// Free docks are only left when nobody of this size is waiting
+	int32 SlotIndex = FindFreeSlot(Size, ApproachDuration, SlotCosts);
+	if (SlotIndex >= 0)
 	{
-		FLOGV("UFlareSpacecraftDockingSystem::RequestDock : found valid dock %d", BestIndex);
-		DockingSlots[BestIndex].Granted = true;
-		DockingSlots[BestIndex].Ship = Ship;
-		return DockingSlots[BestIndex];
+		SetSlotState(SlotIndex, Ship, EFlareDockState::Granted);
+		Slots[SlotIndex].Priority = Priority;
+		Slots[SlotIndex].ApproachTime = ReserveLane(Slots[SlotIndex].Lane, Time + ApproachDuration);
+		return SlotIndex;
 	}
 
-	// Default values
-	FFlareDockingInfo Info;
-	Info.Granted = false;
-	Info.Station = Spacecraft;
-	return Info;
+	// Wait for a dock
+	FFlareDockingRequest Request;
+	Request.Ship = Ship;
+	Request.Size = Size;
+	Request.Priority = Priority;
+	Request.Sequence = NextSequence++;
+	Request.RequestTime = Time;
+	Request.LastRequestTime = Time;
+	Enqueue(Request);
+
+	return -1;
 }
 
-void UFlareSpacecraftDockingSystem::ReleaseDock(AFlareSpacecraft* Ship, int32 DockId)
+void FFlareDockingTraffic::Release(FName Ship, int32 SlotIndex)
 {
-	FLOGV("UFlareSpacecraftDockingSystem::ReleaseDock %d ('%s')", DockId, *Ship->GetParent()->GetImmatriculation().ToString());
-	DockingSlots[DockId].Granted = false;
-	DockingSlots[DockId].Occupied = false;
-	DockingSlots[DockId].Ship = NULL;
+	// Never free the dock of another ship
+	if (!Slots.IsValidIndex(SlotIndex) || Slots[SlotIndex].State == EFlareDockState::Free || Slots[SlotIndex].Ship != Ship)
+	{
+		FLOGV("FFlareDockingTraffic::Release : dock %d is not held by '%s'", SlotIndex, *Ship.ToString());
+		return;
+	}
+
+	if (Slots[SlotIndex].State == EFlareDockState::Occupied)
+	{
+		AverageOccupancy = FMath::Lerp(AverageOccupancy, Time - Slots[SlotIndex].StateTime, 0.2f);
+	}
+
+	SetSlotState(SlotIndex, NAME_None, EFlareDockState::Free);
+	ServeQueue(Slots[SlotIndex].Size);
 }
 
-void UFlareSpacecraftDockingSystem::Dock(AFlareSpacecraft* Ship, int32 DockId)
+void FFlareDockingTraffic::Dock(FName Ship, int32 SlotIndex)
 {
-	FLOGV("UFlareSpacecraftDockingSystem::Dock %d ('%s')", DockId, *Ship->GetParent()->GetImmatriculation().ToString());
-	DockingSlots[DockId].Granted = true;
-	DockingSlots[DockId].Occupied = true;
-	DockingSlots[DockId].Ship = Ship;
+	if (!Slots.IsValidIndex(SlotIndex))
+	{
+		return;
+	}
+
+	// Another ship held this dock : a reserved ship goes back to the head of the queue
+	FFlareDockingSlotState& Slot = Slots[SlotIndex];
+	if (Slot.State != EFlareDockState::Free && Slot.Ship != Ship)
+	{
+		FLOGV("FFlareDockingTraffic::Dock : '%s' took dock %d from '%s'", *Ship.ToString(), SlotIndex, *Slot.Ship.ToString());
+
+		if (Slot.State == EFlareDockState::Reserved)
+		{
+			FFlareDockingRequest Request;
+			Request.Ship = Slot.Ship;
+			Request.Size = Slot.Size;
+			Request.Priority = Slot.Priority;
+			Request.Sequence = NextSequence++;
+			Request.RequestTime = Slot.StateTime;
+			Request.LastRequestTime = Time;
+			Queue.Insert(Request, 0);
+			QueuedShips.Add(Request.Ship);
+		}
+
+		SetSlotState(SlotIndex, NAME_None, EFlareDockState::Free);
+	}
+
+	// Leave the queue and the previous dock
+	RemoveRequest(Ship);
+	int32 PreviousSlotIndex = GetShipSlot(Ship);
+	if (PreviousSlotIndex >= 0 && PreviousSlotIndex != SlotIndex)
+	{
+		SetSlotState(PreviousSlotIndex, NAME_None, EFlareDockState::Free);
+	}
+
+	SetSlotState(SlotIndex, Ship, EFlareDockState::Occupied);
+
+	if (PreviousSlotIndex >= 0 && PreviousSlotIndex != SlotIndex)
+	{
+		ServeQueue(Slots[PreviousSlotIndex].Size);
+	}
+	ServeQueue(Slot.Size);
 }
 
-TArray<AFlareSpacecraft*> UFlareSpacecraftDockingSystem::GetDockedShips()
+void FFlareDockingTraffic::Cancel(FName Ship)
 {
-	TArray<AFlareSpacecraft*> Result;
+	RemoveRequest(Ship);
 
-	for (int32 i = 0; i < DockingSlots.Num(); i++)
+	// Give the reserved dock to the next ship
+	int32 SlotIndex = GetShipSlot(Ship);
+	if (SlotIndex >= 0 && Slots[SlotIndex].State == EFlareDockState::Reserved)
+	{
+		SetSlotState(SlotIndex, NAME_None, EFlareDockState::Free);
+		ServeQueue(Slots[SlotIndex].Size);
+	}
+}
+
+TArray<FFlareDockingRequestSave> FFlareDockingTraffic::SaveQueue() const
+{
+	TArray<FFlareDockingRequestSave> Requests;
+
+	// Reserved docks are lost, their ships are served first after loading
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); SlotIndex++)
 	{
-		if (DockingSlots[i].Granted && DockingSlots[i].Occupied)
+		if (Slots[SlotIndex].State == EFlareDockState::Reserved)
 		{
-			FLOGV("UFlareSpacecraftDockingSystem::GetDockedShips : found valid dock %d", i);
-			Result.AddUnique(DockingSlots[i].Ship);
+			FFlareDockingRequestSave Request;
+			Request.ShipImmatriculation = Slots[SlotIndex].Ship;
+			Request.Size = Slots[SlotIndex].Size;
+			Request.Priority = Slots[SlotIndex].Priority;
+			Request.WaitTime = 0;
+			Requests.Add(Request);
 		}
 	}
 
-	return Result;
+	for (int32 Index = 0; Index < Queue.Num(); Index++)
+	{
+		FFlareDockingRequestSave Request;
+		Request.ShipImmatriculation = Queue[Index].Ship;
+		Request.Size = Queue[Index].Size;
+		Request.Priority = Queue[Index].Priority;
+		Request.WaitTime = Time - Queue[Index].RequestTime;
+		Requests.Add(Request);
+	}
+
+	return Requests;
 }
 
-bool UFlareSpacecraftDockingSystem::HasAvailableDock(AFlareSpacecraft* Ship) const
+void FFlareDockingTraffic::LoadQueue(const TArray<FFlareDockingRequestSave>& Requests)
 {
-	// Looking for slot
-	for (int32 i = 0; i < DockingSlots.Num(); i++)
+	// Keep the saved order, which already follows the priorities
+	for (int32 Index = 0; Index < Requests.Num(); Index++)
 	{
-		if (DockingSlots[i].DockSize != Ship->GetSize())
+		const FFlareDockingRequestSave& Saved = Requests[Index];
+		if (ShipSlots.Contains(Saved.ShipImmatriculation) || QueuedShips.Contains(Saved.ShipImmatriculation))
 		{
 			continue;
 		}
 
-		if (!DockingSlots[i].Granted)
+		FFlareDockingRequest Request;
+		Request.Ship = Saved.ShipImmatriculation;
+		Request.Size = Saved.Size;
+		Request.Priority = Saved.Priority;
+		Request.Sequence = NextSequence++;
+		Request.RequestTime = Time - Saved.WaitTime;
+		Request.LastRequestTime = Time;
+		Queue.Add(Request);
+		QueuedShips.Add(Request.Ship);
+	}
+
+	for (int32 Size = 0; Size < EFlarePartSize::Num; Size++)
+	{
+		ServeQueue((EFlarePartSize::Type) Size);
+	}
+}
+
+float FFlareDockingTraffic::GetEstimatedWait(FName Ship) const
+{
+	const int32* ShipSlot = ShipSlots.Find(Ship);
+	if (ShipSlot)
+	{
+		const FFlareDockingSlotState& Slot = Slots[*ShipSlot];
+		return (Slot.State == EFlareDockState::Granted) ? FMath::Max(Slot.ApproachTime - Time, 0.f) : 0.f;
+	}
+
+	int32 Position = GetQueuePosition(Ship);
+	if (Position < 0)
+	{
+		return -1;
+	}
+
+	// One dock of this size frees up every AverageOccupancy / SlotCount seconds
+	EFlarePartSize::Type Size = EFlarePartSize::S;
+	for (int32 Index = 0; Index < Queue.Num(); Index++)
+	{
+		if (Queue[Index].Ship == Ship)
 		{
-			return true;
+			Size = Queue[Index].Size;
+			break;
 		}
 	}
-
-	return false;
+	return (Position + 1) * AverageOccupancy / FMath::Max(SlotCounts[Size], 1);
 }
 
-int UFlareSpacecraftDockingSystem::GetDockCount() const
+int32 FFlareDockingTraffic::GetQueuePosition(FName Ship) const
 {
-	return DockingSlots.Num();
+	if (!QueuedShips.Contains(Ship))
+	{
+		return -1;
+	}
+
+	int32 Positions[EFlarePartSize::Num] = { 0 };
+	for (int32 Index = 0; Index < Queue.Num(); Index++)
+	{
+		if (Queue[Index].Ship == Ship)
+		{
+			return Positions[Queue[Index].Size];
+		}
+		Positions[Queue[Index].Size]++;
+	}
+
+	return -1;
 }
 
-FFlareDockingInfo UFlareSpacecraftDockingSystem::GetDockInfo(int32 DockId)
+bool FFlareDockingTraffic::IsConsistent() const
 {
-	return DockingSlots[DockId];
+	int32 UsedCount = 0;
+	int32 Frees[EFlarePartSize::Num] = { 0 };
+
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); SlotIndex++)
+	{
+		const FFlareDockingSlotState& Slot = Slots[SlotIndex];
+		if (Slot.State == EFlareDockState::Free)
+		{
+			Frees[Slot.Size]++;
+			if (Slot.Ship != NAME_None)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			// One dock per ship, and no ship both docked and waiting
+			const int32* ShipSlot = ShipSlots.Find(Slot.Ship);
+			if (!ShipSlot || *ShipSlot != SlotIndex || QueuedShips.Contains(Slot.Ship))
+			{
+				return false;
+			}
+			UsedCount++;
+		}
+	}
+
+	for (int32 Size = 0; Size < EFlarePartSize::Num; Size++)
+	{
+		if (Frees[Size] != FreeCounts[Size])
+		{
+			return false;
+		}
+	}
+
+	return UsedCount == ShipSlots.Num() && Queue.Num() == QueuedShips.Num();
 }
 
-bool UFlareSpacecraftDockingSystem::IsGrantedShip(AFlareSpacecraft* ShipCanditate) const
+void FFlareDockingTraffic::ServeQueue(EFlarePartSize::Type Size)
 {
-	for (int32 i = 0; i < DockingSlots.Num(); i++)
+	TArray<float> NoCosts;
+
+	for (int32 Index = 0; Index < Queue.Num() && FreeCounts[Size] > 0;)
 	{
-		if (DockingSlots[i].Granted && DockingSlots[i].Ship == ShipCanditate)
+		if (Queue[Index].Size != Size)
 		{
-			return true;
+			Index++;
+			continue;
 		}
+
+		int32 SlotIndex = FindFreeSlot(Size, 0, NoCosts);
+		FLOGV("FFlareDockingTraffic::ServeQueue : dock %d reserved for '%s'", SlotIndex, *Queue[Index].Ship.ToString());
+
+		SetSlotState(SlotIndex, Queue[Index].Ship, EFlareDockState::Reserved);
+		Slots[SlotIndex].Priority = Queue[Index].Priority;
+		QueuedShips.Remove(Queue[Index].Ship);
+		Queue.RemoveAt(Index);
 	}
+}
 
-	return false;
+void FFlareDockingTraffic::RemoveRequest(FName Ship)
+{
+	if (QueuedShips.Contains(Ship))
+	{
+		QueuedShips.Remove(Ship);
+		for (int32 Index = 0; Index < Queue.Num(); Index++)
+		{
+			if (Queue[Index].Ship == Ship)
+			{
+				Queue.RemoveAt(Index);
+				break;
+			}
+		}
+	}
 }
 
+void FFlareDockingTraffic::Enqueue(const FFlareDockingRequest& Request)
+{
+	int32 Index = 0;
+	while (Index < Queue.Num() && Queue[Index].Priority >= Request.Priority)
+	{
+		Index++;
+	}
 
-bool UFlareSpacecraftDockingSystem::IsDockedShip(AFlareSpacecraft* ShipCanditate) const
+	Queue.Insert(Request, Index);
+	QueuedShips.Add(Request.Ship);
+}
+
+int32 FFlareDockingTraffic::FindFreeSlot(EFlarePartSize::Type Size, float ApproachDuration, const TArray<float>& SlotCosts) const
 {
-	for (int32 i = 0; i < DockingSlots.Num(); i++)
+	int32 BestIndex = -1;
+	bool BestLaneFree = false;
+	float BestCost = 0;
+
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); SlotIndex++)
 	{
-		if (DockingSlots[i].Occupied && DockingSlots[i].Ship == ShipCanditate)
+		if (Slots[SlotIndex].State != EFlareDockState::Free || Slots[SlotIndex].Size != Size)
+		{
+			continue;
+		}
+
+		// Prefer docks whose lane will be clear when we arrive, then the nearest
+		bool LaneFree = LaneFreeTimes[Slots[SlotIndex].Lane] <= Time + ApproachDuration;
+		float Cost = SlotCosts.IsValidIndex(SlotIndex) ? SlotCosts[SlotIndex] : 0;
+
+		if (BestIndex < 0 || (LaneFree && !BestLaneFree) || (LaneFree == BestLaneFree && Cost < BestCost))
 		{
-			return true;
+			BestIndex = SlotIndex;
+			BestLaneFree = LaneFree;
+			BestCost = Cost;
 		}
 	}
 
-	return false;
+	return BestIndex;
+}
+
+void FFlareDockingTraffic::SetSlotState(int32 SlotIndex, FName Ship, EFlareDockState::Type State)
+{
+	FFlareDockingSlotState& Slot = Slots[SlotIndex];
+
+	if (Slot.State == EFlareDockState::Free && State != EFlareDockState::Free)
+	{
+		FreeCounts[Slot.Size]--;
+	}
+	else if (Slot.State != EFlareDockState::Free && State == EFlareDockState::Free)
+	{
+		FreeCounts[Slot.Size]++;
+	}
+
+	if (Slot.State != EFlareDockState::Free)
+	{
+		ShipSlots.Remove(Slot.Ship);
+	}
+	if (State != EFlareDockState::Free)
+	{
+		ShipSlots.Add(Ship, SlotIndex);
+	}
+
+	Slot.Ship = (State != EFlareDockState::Free) ? Ship : NAME_None;
+	Slot.State = State;
+	Slot.StateTime = Time;
+}
+
+float FFlareDockingTraffic::ReserveLane(int32 Lane, float ArrivalTime)
+{
+	float ApproachTime = FMath::Max(ArrivalTime, LaneFreeTimes[Lane]);
+	LaneFreeTimes[Lane] = ApproachTime + DOCK_LANE_SEPARATION;
+	return ApproachTime;
 }
 
 
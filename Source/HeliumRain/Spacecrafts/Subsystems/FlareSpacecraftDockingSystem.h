@@ -5,6 +5,22 @@
 class AFlareSpacecraft;
 
 
+/** Ships waiting for a dock are forgotten if they stop asking, in seconds */
+#define DOCK_REQUEST_TIMEOUT 30.0f
+
+/** Docks reserved for a queued ship are given back if it doesn't claim them, in seconds */
+#define DOCK_RESERVATION_TIMEOUT 30.0f
+
+/** Time between two ships entering the same approach lane, in seconds */
+#define DOCK_LANE_SEPARATION 20.0f
+
+/** Docks whose axes are within this lateral distance share an approach lane, in cm */
+#define DOCK_LANE_RADIUS 5000.0f
+
+/** Docking duration assumed before any ship has left, in seconds */
+#define DOCK_DEFAULT_OCCUPANCY 120.0f
+
+
 /** Docking data */
 struct FFlareDockingInfo
 {
@@ -24,9 +40,180 @@ struct FFlareDockingInfo
 		, Occupied(false)
 		, DockId(-1)
 		, Station(NULL)
+		, Ship(NULL)
 	{}
 };
 
+/** Docking request priorities */
+namespace EFlareDockingPriority
+{
+	enum Type
+	{
+		Normal,
+		Company,
+		Player
+	};
+}
+
+/** Dock states, in lifecycle order */
+namespace EFlareDockState
+{
+	enum Type
+	{
+		Free,
+		Reserved,    // Given to the head of the queue, waiting for the ship to ask again
+		Granted,     // Ship approaching
+		Occupied
+	};
+}
+
+/** Traffic control state of a dock */
+struct FFlareDockingSlotState
+{
+	FName                     Ship;
+	EFlarePartSize::Type      Size;
+	int32                     Lane;
+	EFlareDockState::Type     State;
+	int32                     Priority;
+
+	/** Time of the last state change */
+	float                     StateTime;
+
+	/** Time the ship is expected to enter the approach lane */
+	float                     ApproachTime;
+};
+
+/** Queued docking request */
+struct FFlareDockingRequest
+{
+	FName                     Ship;
+	EFlarePartSize::Type      Size;
+	int32                     Priority;
+	uint32                    Sequence;
+	float                     RequestTime;
+	float                     LastRequestTime;
+};
+
+/** Station docking traffic control : dock table, request queue and approach lanes. Ships are identified by immatriculation. */
+struct FFlareDockingTraffic
+{
+	FFlareDockingTraffic();
+
+	/** Remove all docks and requests */
+	void Reset();
+
+	/** Add a dock, return its index */
+	int32 AddSlot(EFlarePartSize::Type Size, int32 Lane);
+
+	/** Advance the clock and expire the requests and reservations nobody claimed */
+	void Tick(float DeltaSeconds);
+
+	/** Ask for a dock and return it, or queue the ship and return -1. SlotCosts orders the free docks, lowest first, and can be empty. */
+	int32 Request(FName Ship, EFlarePartSize::Type Size, int32 Priority, float ApproachDuration, const TArray<float>& SlotCosts);
+
+	/** Give a dock back, and serve the queue */
+	void Release(FName Ship, int32 SlotIndex);
+
+	/** Mark a dock as occupied by a ship, even if it wasn't granted */
+	void Dock(FName Ship, int32 SlotIndex);
+
+	/** Leave the queue */
+	void Cancel(FName Ship);
+
+	/** Get the queue in service order, reserved ships first */
+	TArray<FFlareDockingRequestSave> SaveQueue() const;
+
+	/** Restore a saved queue */
+	void LoadQueue(const TArray<FFlareDockingRequestSave>& Requests);
+
+	/** Get the estimated time before the ship enters its approach lane, or -1 if it has no request */
+	float GetEstimatedWait(FName Ship) const;
+
+	/** Get the position of a ship among the queued requests of its size, or -1 */
+	int32 GetQueuePosition(FName Ship) const;
+
+	/** Check that the dock table and the ship index agree */
+	bool IsConsistent() const;
+
+	inline int32 GetShipSlot(FName Ship) const
+	{
+		const int32* SlotIndex = ShipSlots.Find(Ship);
+		return SlotIndex ? *SlotIndex : -1;
+	}
+
+	inline EFlareDockState::Type GetShipState(FName Ship) const
+	{
+		const int32* SlotIndex = ShipSlots.Find(Ship);
+		return SlotIndex ? Slots[*SlotIndex].State : EFlareDockState::Free;
+	}
+
+	inline bool IsQueued(FName Ship) const
+	{
+		return QueuedShips.Contains(Ship);
+	}
+
+	inline bool HasFreeSlot(EFlarePartSize::Type Size) const
+	{
+		return FreeCounts[Size] > 0;
+	}
+
+	inline bool HasSlot(EFlarePartSize::Type Size) const
+	{
+		return SlotCounts[Size] > 0;
+	}
+
+	inline const TArray<FFlareDockingSlotState>& GetSlots() const
+	{
+		return Slots;
+	}
+
+	inline const TArray<FFlareDockingRequest>& GetQueue() const
+	{
+		return Queue;
+	}
+
+	inline float GetTime() const
+	{
+		return Time;
+	}
+
+protected:
+
+	/** Give free docks to the queued requests of a size */
+	void ServeQueue(EFlarePartSize::Type Size);
+
+	/** Remove the queued request of a ship */
+	void RemoveRequest(FName Ship);
+
+	/** Insert a request behind the requests of the same or higher priority */
+	void Enqueue(const FFlareDockingRequest& Request);
+
+	/** Find the best free dock of a size, or -1 */
+	int32 FindFreeSlot(EFlarePartSize::Type Size, float ApproachDuration, const TArray<float>& SlotCosts) const;
+
+	/** Change the state of a dock and keep the index and counts up to date */
+	void SetSlotState(int32 SlotIndex, FName Ship, EFlareDockState::Type State);
+
+	/** Book the next time slot of a lane, from an arrival time */
+	float ReserveLane(int32 Lane, float ArrivalTime);
+
+	// Docks
+	TArray<FFlareDockingSlotState>   Slots;
+	TMap<FName, int32>               ShipSlots;
+	int32                            SlotCounts[EFlarePartSize::Num];
+	int32                            FreeCounts[EFlarePartSize::Num];
+	TArray<float>                    LaneFreeTimes;
+
+	// Queue
+	TArray<FFlareDockingRequest>     Queue;
+	TSet<FName>                      QueuedShips;
+	uint32                           NextSequence;
+
+	// Clock and statistics
+	float                            Time;
+	float                            AverageOccupancy;
+};
+
 /** Spacecraft docking system class */
 UCLASS()
 class HELIUMRAIN_API UFlareSpacecraftDockingSystem : public UObject
@@ -49,6 +236,9 @@ public:
 
 	virtual void Start();
 
+	/** Save the docking queue */
+	virtual void Save();
+
 public:
 
 	/*----------------------------------------------------
@@ -56,11 +246,14 @@ public:
 	----------------------------------------------------*/
 
 	/** Get the list of docked ships */
-	virtual TArray<AFlareSpacecraft*> GetDockedShips();
+	virtual const TArray<AFlareSpacecraft*>& GetDockedShips();
 
-	/** Request a docking point */
+	/** Request a docking point, or queue the ship if none is free */
 	virtual FFlareDockingInfo RequestDock(AFlareSpacecraft* Ship, FVector PreferredLocation);
 
+	/** Leave the docking queue */
+	virtual void CancelDockRequest(AFlareSpacecraft* Ship);
+
 	/** Cancel docking */
 	virtual void ReleaseDock(AFlareSpacecraft* Ship, int32 DockId);
 
@@ -80,8 +273,35 @@ public:
 
 	virtual bool IsDockedShip(AFlareSpacecraft* ShipCanditate) const;
 
+	/** Is this ship waiting for a dock */
+	virtual bool IsQueuedShip(AFlareSpacecraft* ShipCanditate) const;
+
+	/** Get the position of a ship in the docking queue, or -1 */
+	virtual int32 GetQueuePosition(AFlareSpacecraft* ShipCanditate) const;
+
+	/** Get the estimated time before the ship can approach, or -1 */
+	virtual float GetEstimatedWait(AFlareSpacecraft* ShipCanditate) const;
+
+	const FFlareDockingTraffic& GetTraffic() const
+	{
+		return Traffic;
+	}
+
 protected:
 
+	/*----------------------------------------------------
+		Internals
+	----------------------------------------------------*/
+
+	/** Group the docks sharing an approach corridor */
+	void ComputeLanes(TArray<int32>& Lanes) const;
+
+	/** Copy the traffic control state to the docking infos */
+	void UpdateDockingSlots();
+
+	/** Get the request priority of a ship */
+	int32 GetDockingPriority(AFlareSpacecraft* Ship) const;
+
 	/*----------------------------------------------------
 		Protected data
 	----------------------------------------------------*/
@@ -94,5 +314,7 @@ protected:
 
 	// Dock data
 	TArray <FFlareDockingInfo>       DockingSlots;
+	FFlareDockingTraffic             Traffic;
+	TArray<AFlareSpacecraft*>        DockedShips;
 
 };
@@ -40,6 +40,7 @@ UFlareSpacecraftNavigationSystem::UFlareSpacecraftNavigationSystem(const class F
 {
 	AnticollisionAngle = FMath::FRandRange(0, 360);
 	DockConstraint = NULL;
+	DockingQueueStation = NULL;
 }
 
 
@@ -53,6 +54,12 @@ void UFlareSpacecraftNavigationSystem::TickSystem(float DeltaSeconds)
 
 	UpdateCOM();
 
+	// Waiting for a dock
+	if (DockingQueueStation)
+	{
+		UpdateDockingQueue();
+	}
+
 	// Manual pilot
 	if (IsManualPilot() && Spacecraft->GetParent()->GetDamageSystem()->IsAlive())
 	{
@@ -194,15 +201,19 @@ void UFlareSpacecraftNavigationSystem::SetAngularAccelerationRate(float Accelera
 
 bool UFlareSpacecraftNavigationSystem::DockAt(AFlareSpacecraft* TargetStation)
 {
-	FLOGV("UFlareSpacecraftNavigationSystem::DockAt : '%s' docking at '%s'",
-		*Spacecraft->GetParent()->GetImmatriculation().ToString(),
-		*TargetStation->GetParent()->GetImmatriculation().ToString());
+	// Leave the queue of another station
+	if (DockingQueueStation && DockingQueueStation != TargetStation)
+	{
+		CancelDockRequest();
+	}
 
 	FFlareDockingInfo DockingInfo = TargetStation->GetDockingSystem()->RequestDock(Spacecraft, Spacecraft->GetActorLocation());
 
 	// Docking granted
 	if (DockingInfo.Granted)
 	{
+		DockingQueueStation = NULL;
+
 		if (IsDocked())
 		{
 			FLOG("UFlareSpacecraftNavigationSystem::DockAt : leaving current dock");
@@ -214,14 +225,57 @@ bool UFlareSpacecraftNavigationSystem::DockAt(AFlareSpacecraft* TargetStation)
 		return true;
 	}
 
+	// Waiting for a free dock
+	else if (TargetStation->GetDockingSystem()->IsQueuedShip(Spacecraft))
+	{
+		DockingQueueStation = TargetStation;
+		return false;
+	}
+
 	// Failed
 	else
 	{
 		FLOG("UFlareSpacecraftNavigationSystem::DockAt : docking denied");
+		DockingQueueStation = NULL;
 		return false;
 	}
 }
 
+void UFlareSpacecraftNavigationSystem::CancelDockRequest()
+{
+	if (DockingQueueStation)
+	{
+		if (!DockingQueueStation->IsPendingKill())
+		{
+			DockingQueueStation->GetDockingSystem()->CancelDockRequest(Spacecraft);
+		}
+		DockingQueueStation = NULL;
+	}
+}
+
+void UFlareSpacecraftNavigationSystem::UpdateDockingQueue()
+{
+	if (DockingQueueStation->IsPendingKill() || !DockingQueueStation->GetParent()->GetDamageSystem()->IsAlive() || IsDocked())
+	{
+		CancelDockRequest();
+		return;
+	}
+
+	// Asking again keeps the request alive, and claims the dock reserved for this ship
+	FFlareDockingInfo DockingInfo = DockingQueueStation->GetDockingSystem()->RequestDock(Spacecraft, Spacecraft->GetActorLocation());
+	if (DockingInfo.Granted)
+	{
+		FLOGV("UFlareSpacecraftNavigationSystem::UpdateDockingQueue : '%s' claimed dock %d",
+			*Spacecraft->GetParent()->GetImmatriculation().ToString(), DockingInfo.DockId);
+		DockingQueueStation = NULL;
+		PushCommandDock(DockingInfo);
+	}
+	else if (!DockingQueueStation->GetDockingSystem()->IsQueuedShip(Spacecraft))
+	{
+		DockingQueueStation = NULL;
+	}
+}
+
 void UFlareSpacecraftNavigationSystem::BreakDock()
 {
 	// Detach from station
@@ -237,6 +291,7 @@ bool UFlareSpacecraftNavigationSystem::Undock()
 {
 
 	// Try undocking
+	CancelDockRequest();
 	if (IsDocked())
 	{
 		if(Spacecraft->GetParent()->IsTrading())
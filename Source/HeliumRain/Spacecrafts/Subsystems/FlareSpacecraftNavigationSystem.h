@@ -155,8 +155,18 @@ public:
 		Docking
 	----------------------------------------------------*/
 
+	/** Dock at a station, or wait in its queue and dock when a dock is free */
 	virtual bool DockAt(AFlareSpacecraft* TargetStation);
 
+	/** Leave the docking queue this ship waits in */
+	virtual void CancelDockRequest();
+
+	/** Get the station this ship waits a dock from, or NULL */
+	inline AFlareSpacecraft* GetDockingQueueStation() const
+	{
+		return DockingQueueStation;
+	}
+
 	FFlareDockingParameters GetDockingParameters(FFlareDockingInfo StationDockInfo, FVector CameraLocation);
 
 	/** Continue docking sequence has completed until effectif docking */
@@ -174,6 +184,13 @@ public:
 
 	virtual AFlareSpacecraft* GetDockStation();
 
+protected:
+
+	/** Keep the place in the docking queue, and claim the dock once it is reserved */
+	void UpdateDockingQueue();
+
+public:
+
 	/*----------------------------------------------------
 		Navigation commands and helpers
 	----------------------------------------------------*/
@@ -259,6 +276,9 @@ protected:
 	UPROPERTY()
 	UPhysicsConstraintComponent*                    DockConstraint;
 
+	UPROPERTY()
+	AFlareSpacecraft*                               DockingQueueStation;
+
 	FFlareSpacecraftSave*                           Data;
 	FFlareSpacecraftDescription*                    Description;
 	TArray<UActorComponent*>                        Components;
@@ -1,6 +1,7 @@
 
 #include "../../Flare.h"
 #include "FlareCompanyInfo.h"
+#include "FlareHistoryChart.h"
 #include "../../Game/FlareCompany.h"
 #include "../../Player/FlarePlayerController.h"
 
@@ -84,6 +85,17 @@ void SFlareCompanyInfo::Construct(const FArguments& InArgs)
 				.Text(this, &SFlareCompanyInfo::GetCompanyInfo)
 				.TextStyle(&Theme.TextFont)
 			]
+
+			// Value history
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(Theme.SmallContentPadding)
+			[
+				SAssignNew(ValueChart, SFlareHistoryChart)
+				.Width(0.4 * Theme.ContentWidth)
+				.Height(50)
+				.Color(Theme.NeutralColor)
+			]
 		]
 
 		// Details
@@ -173,6 +185,8 @@ void SFlareCompanyInfo::Construct(const FArguments& InArgs)
 			]
 		]
 	];
+
+	UpdateValueChart();
 }
 
 
@@ -183,6 +197,22 @@ void SFlareCompanyInfo::Construct(const FArguments& InArgs)
 void SFlareCompanyInfo::SetCompany(UFlareCompany* NewCompany)
 {
 	Company = NewCompany;
+	UpdateValueChart();
+}
+
+void SFlareCompanyInfo::UpdateValueChart()
+{
+	TArray<float> Values;
+
+	if (Company)
+	{
+		for (int32 Age = Company->GetCompanyValueHistoryLength() - 1; Age >= 0; Age--)
+		{
+			Values.Add(Company->GetCompanyValueHistory(Age));
+		}
+	}
+
+	ValueChart->SetValues(Values);
 }
 
 
@@ -222,9 +252,27 @@ FText SFlareCompanyInfo::GetCompanyInfo() const
 		FText ShipText = FText::Format(LOCTEXT("ShipInfoFormat", "{0} {1}"),
 			FText::AsNumber(CompanyShipCount), CompanyShipCount == 1 ? LOCTEXT("Ship", "ship") : LOCTEXT("Ships", "ships"));
 		
+		// Value trend over the last month
+		int64 TotalValue = Company->GetCompanyValue().TotalValue;
+		int32 TrendDays = FMath::Min(30, Company->GetCompanyValueHistoryLength());
+		FText TrendText;
+		if (TrendDays > 0)
+		{
+			int64 PastCompanyValue = Company->GetCompanyValueHistory(TrendDays - 1);
+			if (PastCompanyValue > 0)
+			{
+				int32 Trend = FMath::RoundToInt(100 * (TotalValue - PastCompanyValue) / (float) PastCompanyValue);
+				TrendText = FText::Format(LOCTEXT("CompanyTrendFormat", " ({0}{1}% in {2} days)"),
+					FText::FromString(Trend >= 0 ? TEXT("+") : TEXT("")),
+					FText::AsNumber(Trend),
+					FText::AsNumber(TrendDays));
+			}
+		}
+
 		// Full string
-		return FText::Format(LOCTEXT("CompanyInfoFormat", "Valued at {0} credits\n{1} credits in bank\n{2} owned\n{3} owned"),
-			FText::AsNumber(UFlareGameTools::DisplayMoney(Company->GetCompanyValue().TotalValue)),
+		return FText::Format(LOCTEXT("CompanyInfoFormat", "Valued at {0} credits{1}\n{2} credits in bank\n{3} owned\n{4} owned"),
+			FText::AsNumber(UFlareGameTools::DisplayMoney(TotalValue)),
+			TrendText,
 			FText::AsNumber(UFlareGameTools::DisplayMoney(Company->GetMoney())),
 			StationText,
 			ShipText);
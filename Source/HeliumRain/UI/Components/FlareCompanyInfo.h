@@ -5,6 +5,7 @@
 
 class UFlareCompany;
 class AFlarePlayerController;
+class SFlareHistoryChart;
 
 
 class SFlareCompanyInfo : public SCompoundWidget
@@ -43,6 +44,9 @@ public:
 	/** Set the company to display */
 	void SetCompany(UFlareCompany* NewCompany);
 
+	/** Draw the daily value history of the company */
+	void UpdateValueChart();
+
 
 protected:
 
@@ -100,5 +104,8 @@ protected:
 	AFlarePlayerController*                    Player;
 	UFlareCompany*                             Company;
 
+	// Slate data
+	TSharedPtr<SFlareHistoryChart>             ValueChart;
+
 
 };
@@ -0,0 +1,69 @@
+
+#include "../../Flare.h"
+#include "FlareHistoryChart.h"
+
+
+/*----------------------------------------------------
+	Construct
+----------------------------------------------------*/
+
+void SFlareHistoryChart::Construct(const FArguments& InArgs)
+{
+	Width = InArgs._Width;
+	Height = InArgs._Height;
+	Color = InArgs._Color;
+}
+
+
+/*----------------------------------------------------
+	Interaction
+----------------------------------------------------*/
+
+void SFlareHistoryChart::SetValues(const TArray<float>& NewValues)
+{
+	Values = NewValues;
+}
+
+
+/*----------------------------------------------------
+	Callbacks
+----------------------------------------------------*/
+
+int32 SFlareHistoryChart::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyClippingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	if (Values.Num() < 2)
+	{
+		return LayerId;
+	}
+
+	// Scale the values to the widget, a flat history is drawn in the middle
+	float MinValue = FMath::Min(Values);
+	float MaxValue = FMath::Max(Values);
+	float Range = MaxValue - MinValue;
+	FVector2D Size = AllottedGeometry.GetLocalSize();
+
+	TArray<FVector2D> Points;
+	Points.Reserve(Values.Num());
+	for (int32 Index = 0; Index < Values.Num(); Index++)
+	{
+		float Ratio = (Range > 0) ? (Values[Index] - MinValue) / Range : 0.5f;
+		Points.Add(FVector2D(Size.X * Index / (Values.Num() - 1), Size.Y * (1 - Ratio)));
+	}
+
+	FSlateDrawElement::MakeLines(
+		OutDrawElements,
+		LayerId,
+		AllottedGeometry.ToPaintGeometry(),
+		Points,
+		MyClippingRect,
+		ESlateDrawEffect::None,
+		Color * InWidgetStyle.GetColorAndOpacityTint(),
+		true);
+
+	return LayerId;
+}
+
+FVector2D SFlareHistoryChart::ComputeDesiredSize(float) const
+{
+	return FVector2D(Width, Height);
+}
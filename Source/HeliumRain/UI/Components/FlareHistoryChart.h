@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../../Flare.h"
+
+
+/** Line chart of a daily history, from the oldest value to the newest */
+class SFlareHistoryChart : public SLeafWidget
+{
+	/*----------------------------------------------------
+		Slate arguments
+	----------------------------------------------------*/
+
+	SLATE_BEGIN_ARGS(SFlareHistoryChart)
+		: _Width(200)
+		, _Height(50)
+		, _Color(FLinearColor::White)
+	{}
+
+	SLATE_ARGUMENT(float, Width)
+	SLATE_ARGUMENT(float, Height)
+	SLATE_ARGUMENT(FLinearColor, Color)
+	
+	SLATE_END_ARGS()
+
+
+public:
+
+	/*----------------------------------------------------
+		Public methods
+	----------------------------------------------------*/
+
+	/** Create the widget */
+	void Construct(const FArguments& InArgs);
+
+	/** Set the values to draw, oldest first */
+	void SetValues(const TArray<float>& NewValues);
+
+
+protected:
+
+	/*----------------------------------------------------
+		Callbacks
+	----------------------------------------------------*/
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyClippingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+	virtual FVector2D ComputeDesiredSize(float) const override;
+
+
+protected:
+
+	/*----------------------------------------------------
+		Protected data
+	----------------------------------------------------*/
+
+	float                                      Width;
+	float                                      Height;
+	FLinearColor                               Color;
+	TArray<float>                              Values;
+
+};
@@ -23,20 +23,9 @@ void SFlareNotification::Construct(const FArguments& InArgs)
 	FLinearColor ShadowColor = FLinearColor::Black;
 	ShadowColor.A = 0;
 
-	// Args and state
-	Lifetime = 0;
-	ForcedLife = false;
-	LastHeight = 0;
-	CurrentAlpha = 0;
-	CurrentMargin = 0;
-	Text = InArgs._Text;
+	// Args
 	MenuManager = InArgs._MenuManager;
 	Notifier = InArgs._Notifier;
-	TargetMenu = InArgs._TargetMenu;
-	TargetInfo = InArgs._TargetInfo;
-	Tag = InArgs._Tag;
-	NotificationTimeout = InArgs._Pinned ? 0 : 7.0f;
-	FLOGV("SFlareNotification::Construct : notifying '%s'", *InArgs._Text.ToString());
 
 	// Create the layout
 	ChildSlot
@@ -66,7 +55,7 @@ void SFlareNotification::Construct(const FArguments& InArgs)
 						[
 							SNew(SImage)
 							.Image(&Theme.InvertedBrush)
-							.ColorAndOpacity(this, &SFlareNotification::GetNotificationColor, InArgs._Type)
+							.ColorAndOpacity(this, &SFlareNotification::GetNotificationColor)
 						]
 					]
 
@@ -96,7 +85,7 @@ void SFlareNotification::Construct(const FArguments& InArgs)
 									.Padding(Theme.SmallContentPadding)
 									[
 										SNew(STextBlock)
-										.Text(InArgs._Text)
+										.Text(this, &SFlareNotification::GetText)
 										.WrapTextAt(NotificationTextWidth)
 										.TextStyle(&Theme.NameFont)
 										.ColorAndOpacity(this, &SFlareNotification::GetNotificationTextColor)
@@ -124,7 +113,7 @@ void SFlareNotification::Construct(const FArguments& InArgs)
 								.Padding(Theme.SmallContentPadding)
 								[
 									SNew(STextBlock)
-									.Text(InArgs._Info)
+									.Text(this, &SFlareNotification::GetInfo)
 									.WrapTextAt(NotificationTextWidth)
 									.TextStyle(&Theme.TextFont)
 									.ColorAndOpacity(this, &SFlareNotification::GetNotificationTextColor)
@@ -177,6 +166,29 @@ void SFlareNotification::Construct(const FArguments& InArgs)
 	];
 
 	SetVisibility(EVisibility::Visible);
+	Setup(InArgs._Text, InArgs._Info, InArgs._Tag, InArgs._Type, InArgs._Pinned, InArgs._TargetMenu, InArgs._TargetInfo);
+}
+
+void SFlareNotification::Setup(FText NewText, FText NewInfo, FName NewTag, EFlareNotification::Type NewType, bool NewPinned, EFlareMenu::Type NewTargetMenu, FFlareMenuParameterData NewTargetInfo)
+{
+	// State
+	Lifetime = 0;
+	ForcedLife = false;
+	LastHeight = 0;
+	CurrentAlpha = 0;
+	CurrentMargin = 0;
+	Button->SetVisibility(EVisibility::Visible);
+
+	// Args
+	Text = NewText;
+	Info = NewInfo;
+	Tag = NewTag;
+	Type = NewType;
+	Pinned = NewPinned;
+	TargetMenu = NewTargetMenu;
+	TargetInfo = NewTargetInfo;
+	NotificationTimeout = Pinned ? 0 : 7.0f;
+	FLOGV("SFlareNotification::Setup : notifying '%s'", *Text.ToString());
 }
 
 
@@ -215,6 +227,11 @@ void SFlareNotification::Finish(bool Now)
 	ForcedLife = true;
 }
 
+bool SFlareNotification::IsPinned() const
+{
+	return Pinned;
+}
+
 
 /*----------------------------------------------------
 	Callbacks
@@ -251,7 +268,17 @@ void SFlareNotification::Tick(const FGeometry& AllottedGeometry, const double In
 	}
 }
 
-FSlateColor SFlareNotification::GetNotificationColor(EFlareNotification::Type Type) const
+FText SFlareNotification::GetText() const
+{
+	return Text;
+}
+
+FText SFlareNotification::GetInfo() const
+{
+	return Info;
+}
+
+FSlateColor SFlareNotification::GetNotificationColor() const
 {
 	// Get color
 	FLinearColor Result;
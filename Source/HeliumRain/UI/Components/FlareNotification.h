@@ -56,6 +56,9 @@ public:
 	/** Create the widget */
 	void Construct(const FArguments& InArgs);
 
+	/** Start showing a notification, from a new or recycled widget */
+	void Setup(FText NewText, FText NewInfo, FName NewTag, EFlareNotification::Type NewType, bool NewPinned, EFlareMenu::Type NewTargetMenu, FFlareMenuParameterData NewTargetInfo);
+
 	/** Can we safely delete this ? */
 	bool IsFinished() const;
 
@@ -65,6 +68,9 @@ public:
 	/** Complete this notification */
 	void Finish(bool Now = true);
 
+	/** Does this notification stay until dismissed ? */
+	bool IsPinned() const;
+
 	
 	/*----------------------------------------------------
 		Callbacks
@@ -72,8 +78,14 @@ public:
 	
 	void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
 	
+	/** Get the title */
+	FText GetText() const;
+
+	/** Get the details */
+	FText GetInfo() const;
+
 	/** Get the current color */
-	FSlateColor GetNotificationColor(EFlareNotification::Type Type) const;
+	FSlateColor GetNotificationColor() const;
 
 	/** Get the current text color */
 	FSlateColor GetNotificationTextColor() const;
@@ -126,7 +138,10 @@ protected:
 	TEnumAsByte<EFlareMenu::Type>        TargetMenu;
 	FFlareMenuParameterData              TargetInfo;
 	FText                                Text;
+	FText                                Info;
 	FName                                Tag;
+	EFlareNotification::Type             Type;
+	bool                                 Pinned;
 	
 	// Fade data
 	TSharedPtr<SButton>                  Button;
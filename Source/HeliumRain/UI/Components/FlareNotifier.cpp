@@ -3,6 +3,7 @@
 #include "FlareNotifier.h"
 #include "../Components/FlareObjectiveInfo.h"
 #include "../../Player/FlareMenuManager.h"
+#include "../../Player/FlarePlayerController.h"
 
 #define LOCTEXT_NAMESPACE "FlareNotifier"
 
@@ -67,12 +68,36 @@ void SFlareNotifier::Notify(FText Text, FText Info, FName Identifier, EFlareNoti
 		}
 	}
 
-	// Add notification
+	// Make room by recycling the oldest notification
 	TSharedPtr<SFlareNotification> NotificationEntry;
-	NotificationContainer->AddSlot()
-		.AutoHeight()
-		[
-			SAssignNew(NotificationEntry, SFlareNotification)
+	if (NotificationData.Num() >= NOTIFIER_MAX_COUNT)
+	{
+		for (int Index = 0; Index < NotificationData.Num(); Index++)
+		{
+			if (!NotificationData[Index]->IsPinned())
+			{
+				NotificationEntry = NotificationData[Index];
+				NotificationContainer->RemoveSlot(NotificationEntry.ToSharedRef());
+				NotificationData.RemoveAt(Index);
+				break;
+			}
+		}
+	}
+
+	// Reuse a finished notification
+	if (!NotificationEntry.IsValid() && NotificationPool.Num() > 0)
+	{
+		NotificationEntry = NotificationPool.Pop();
+	}
+
+	// Add notification
+	if (NotificationEntry.IsValid())
+	{
+		NotificationEntry->Setup(Text, Info, Identifier, Type, Pinned, TargetMenu, TargetInfo);
+	}
+	else
+	{
+		SAssignNew(NotificationEntry, SFlareNotification)
 			.MenuManager(MenuManager.Get())
 			.Notifier(this)
 			.Text(Text)
@@ -81,7 +106,13 @@ void SFlareNotifier::Notify(FText Text, FText Info, FName Identifier, EFlareNoti
 			.Tag(Identifier)
 			.Pinned(Pinned)
 			.TargetMenu(TargetMenu)
-			.TargetInfo(TargetInfo)
+			.TargetInfo(TargetInfo);
+	}
+
+	NotificationContainer->AddSlot()
+		.AutoHeight()
+		[
+			NotificationEntry.ToSharedRef()
 		];
 
 	// Store a reference to it
@@ -90,6 +121,9 @@ void SFlareNotifier::Notify(FText Text, FText Info, FName Identifier, EFlareNoti
 
 void SFlareNotifier::FlushNotifications()
 {
+	// Drop the summaries still waiting, they would refer to the previous game
+	MenuManager->GetPC()->GetNotificationService().Flush();
+
 	for (auto& NotificationEntry : NotificationData)
 	{
 		NotificationEntry->Finish();
@@ -103,8 +137,6 @@ void SFlareNotifier::FlushNotifications()
 
 void SFlareNotifier::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
 {
-	int32 NotificationCount = 0;
-
 	// Don't show notifications in story menu
 	if (MenuManager->GetCurrentMenu() == EFlareMenu::MENU_Story
 		|| MenuManager->GetNextMenu() == EFlareMenu::MENU_Story)
@@ -119,23 +151,20 @@ void SFlareNotifier::Tick(const FGeometry& AllottedGeometry, const double InCurr
 	// Tick parent
 	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
 
-	// Destroy notifications when they're done with the animation
-	for (auto& NotificationEntry : NotificationData)
+	// Remove notifications when they're done with the animation, and keep a few for reuse
+	for (int Index = NotificationData.Num() - 1; Index >= 0; Index--)
 	{
+		TSharedPtr<SFlareNotification> NotificationEntry = NotificationData[Index];
 		if (NotificationEntry->IsFinished())
 		{
 			NotificationContainer->RemoveSlot(NotificationEntry.ToSharedRef());
-		}
-		else
-		{
-			NotificationCount++;
-		}
-	}
+			NotificationData.RemoveAt(Index);
 
-	// Clean up the list when no notification is active
-	if (NotificationCount == 0)
-	{
-		NotificationData.Empty();
+			if (NotificationPool.Num() < NOTIFIER_POOL_SIZE)
+			{
+				NotificationPool.Add(NotificationEntry);
+			}
+		}
 	}
 }
 
@@ -7,6 +7,12 @@
 class AFlareMenuManager;
 class SFlareButton;
 
+/** Maximum number of notifications on screen */
+#define NOTIFIER_MAX_COUNT 8
+
+/** Number of finished notification widgets kept for reuse */
+#define NOTIFIER_POOL_SIZE 8
+
 
 class SFlareNotifier : public SCompoundWidget
 {
@@ -65,6 +71,7 @@ protected:
 	
 	// Slate data
 	TArray< TSharedPtr<SFlareNotification> >        NotificationData;
+	TArray< TSharedPtr<SFlareNotification> >        NotificationPool;
 	TSharedPtr<SVerticalBox>                        NotificationContainer;
 
 
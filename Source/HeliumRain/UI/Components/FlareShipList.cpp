@@ -3,6 +3,12 @@
 #include "FlareShipList.h"
 
 #include "../../Game/FlareGame.h"
+#include "../../Game/FlareWorld.h"
+#include "../../Game/FlareTravel.h"
+#include "../../Game/FlareSimulatedSector.h"
+#include "../../Economy/FlareCargoBay.h"
+#include "../../Spacecrafts/Subsystems/FlareSimulatedSpacecraftDamageSystem.h"
+#include "../../Spacecrafts/Subsystems/FlareSimulatedSpacecraftWeaponsSystem.h"
 #include "../../Player/FlareMenuManager.h"
 #include "../../Player/FlarePlayerController.h"
 
@@ -21,6 +27,8 @@ void SFlareShipList::Construct(const FArguments& InArgs)
 	const FFlareStyleCatalog& Theme = FFlareStyleSet::GetDefaultTheme();
 	AFlarePlayerController* PC = MenuManager->GetPC();
 	OnItemSelected = InArgs._OnItemSelected;
+	SortOrder = EFlareShipListSort::Size;
+	NextSerial = 0;
 	
 	// Build structure
 	ChildSlot
@@ -35,12 +43,31 @@ void SFlareShipList::Construct(const FArguments& InArgs)
 			// Section title
 			+ SVerticalBox::Slot()
 			.AutoHeight()
-			.Padding(Theme.TitlePadding)
-			.HAlign(HAlign_Left)
 			[
-				SNew(STextBlock)
-				.Text(InArgs._Title)
-				.TextStyle(&FFlareStyleSet::GetDefaultTheme().SubTitleFont)
+				SNew(SHorizontalBox)
+
+				+ SHorizontalBox::Slot()
+				.Padding(Theme.TitlePadding)
+				.HAlign(HAlign_Left)
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(InArgs._Title)
+					.TextStyle(&FFlareStyleSet::GetDefaultTheme().SubTitleFont)
+				]
+
+				// Sort order
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.HAlign(HAlign_Right)
+				.VAlign(VAlign_Center)
+				[
+					SNew(SFlareButton)
+					.Width(4)
+					.Text(this, &SFlareShipList::GetSortText)
+					.HelpText(LOCTEXT("SortInfo", "Change the order of this list"))
+					.OnClicked(this, &SFlareShipList::OnSortClicked)
+				]
 			]
 
 			// Section title
@@ -55,17 +82,21 @@ void SFlareShipList::Construct(const FArguments& InArgs)
 				.Visibility(this, &SFlareShipList::GetNoObjectsVisibility)
 			]
 
-			// Box
+			// Box, with an optional maximum height so that only visible rows are generated outside of scroll boxes
 			+ SVerticalBox::Slot()
 			.AutoHeight()
 			.Padding(Theme.ContentPadding)
 			.HAlign(HAlign_Fill)
 			[
-				SAssignNew(TargetList, SListView< TSharedPtr<FInterfaceContainer> >)
-				.ListItemsSource(&TargetListData)
-				.SelectionMode(ESelectionMode::Single)
-				.OnGenerateRow(this, &SFlareShipList::GenerateTargetInfo)
-				.OnSelectionChanged(this, &SFlareShipList::OnTargetSelected)
+				SNew(SBox)
+				.MaxDesiredHeight(InArgs._MaxHeight > 0 ? FOptionalSize(InArgs._MaxHeight) : FOptionalSize())
+				[
+					SAssignNew(TargetList, SListView< TSharedPtr<FInterfaceContainer> >)
+					.ListItemsSource(&TargetListData)
+					.SelectionMode(ESelectionMode::Single)
+					.OnGenerateRow(this, &SFlareShipList::GenerateTargetInfo)
+					.OnSelectionChanged(this, &SFlareShipList::OnTargetSelected)
+				]
 			]
 		]
 	];
@@ -78,84 +109,71 @@ void SFlareShipList::Construct(const FArguments& InArgs)
 
 void SFlareShipList::AddFleet(UFlareFleet* Fleet)
 {
-	TargetListData.AddUnique(FInterfaceContainer::New(Fleet));
+	TargetListData.Add(FInterfaceContainer::New(Fleet));
+	TargetListKeys.Add({0, NextSerial++});
 }
 
 void SFlareShipList::AddShip(UFlareSimulatedSpacecraft* Ship)
 {
-	TargetListData.AddUnique(FInterfaceContainer::New(Ship));
+	TargetListData.Add(FInterfaceContainer::New(Ship));
+	TargetListKeys.Add({0, NextSerial++});
 }
 
-void SFlareShipList::RefreshList()
+void SFlareShipList::InsertFleet(UFlareFleet* Fleet)
+{
+	InsertItem(FInterfaceContainer::New(Fleet));
+}
+
+void SFlareShipList::InsertShip(UFlareSimulatedSpacecraft* Ship)
 {
-	struct FSortBySize
+	InsertItem(FInterfaceContainer::New(Ship));
+}
+
+void SFlareShipList::RemoveFleet(UFlareFleet* Fleet)
+{
+	for (int32 Index = 0; Index < TargetListData.Num(); Index++)
 	{
-		FORCEINLINE bool operator()(const TSharedPtr<FInterfaceContainer> PtrA, const TSharedPtr<FInterfaceContainer> PtrB) const
+		if (TargetListData[Index]->FleetPtr == Fleet)
 		{
-			FCHECK(PtrA.IsValid());
-			FCHECK(PtrB.IsValid());
-			UFlareSimulatedSpacecraft* A = PtrA->ShipInterfacePtr;
-			UFlareSimulatedSpacecraft* B = PtrB->ShipInterfacePtr;
-
-			if (PtrA->FleetPtr)
-			{
-				if (PtrB->FleetPtr)
-				{
-					return (PtrA->FleetPtr->GetShips().Num() > PtrB->FleetPtr->GetShips().Num());
-				}
-				else
-				{
-					return true;
-				}
-			}
-			else if (PtrB->FleetPtr)
-			{
-				return false;
-			}
+			RemoveItem(Index);
+			return;
+		}
+	}
+}
 
-			if (A->IsStation())
-			{
-					return true;
-			}
-			else if (B->IsStation())
-			{
-				return false;
-			}
-			else
-			{
-				if (A->GetSize() > B->GetSize())
-				{
-					return true;
-				}
-				else if (A->GetSize() < B->GetSize())
-				{
-					return false;
-				}
-				else if (A->IsMilitary())
-				{
-					if (!B->IsMilitary())
-					{
-						return true;
-					}
-					else
-					{
-						return A->GetWeaponsSystem()->GetWeaponGroupCount() > B->GetWeaponsSystem()->GetWeaponGroupCount();
-					}
-				}
-				else
-				{
-					return false;
-				}
-			}
-			return false;
+void SFlareShipList::RemoveShip(UFlareSimulatedSpacecraft* Ship)
+{
+	for (int32 Index = 0; Index < TargetListData.Num(); Index++)
+	{
+		if (TargetListData[Index]->ShipInterfacePtr == Ship)
+		{
+			RemoveItem(Index);
+			return;
 		}
-	};
+	}
+}
+
+void SFlareShipList::RefreshList()
+{
+	// Keys only read the entries once, instead of on every comparison
+	UpdateSectorRanks();
+	for (int32 Index = 0; Index < TargetListData.Num(); Index++)
+	{
+		TargetListKeys[Index].Key = ComputeSortKey(TargetListData[Index].Get(), SortOrder, SectorRanks);
+	}
 
 	ClearSelection();
-	TargetListData.Sort(FSortBySize());
+	SortByKeys(TargetListKeys, TargetListData);
 	TargetList->RequestListRefresh();
+}
 
-	SlatePrepass(FSlateApplicationBase::Get().GetApplicationScale());
+void SFlareShipList::SetSortOrder(EFlareShipListSort::Type NewSortOrder)
+{
+	if (NewSortOrder != SortOrder)
+	{
+		SortOrder = NewSortOrder;
+		RefreshList();
+	}
 }
 
 void SFlareShipList::ClearSelection()
@@ -173,12 +191,153 @@ void SFlareShipList::ClearSelection()
 void SFlareShipList::Reset()
 {
 	TargetListData.Empty();
+	TargetListKeys.Empty();
 	TargetList->ClearSelection();
 	TargetList->RequestListRefresh();
 	SelectedItem.Reset();
 }
 
 
+/*----------------------------------------------------
+	Sorting
+----------------------------------------------------*/
+
+uint64 FFlareShipListKey::Encode(uint8 Group, uint64 Value, bool Descending)
+{
+	const uint64 ValueMask = (1ull << 62) - 1;
+	Value = FMath::Min(Value, ValueMask);
+	return ((uint64) Group << 62) | (Descending ? ValueMask - Value : Value);
+}
+
+/** Sector whose prices value a spacecraft, the destination if travelling */
+static UFlareSimulatedSector* GetSortSector(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	if (Spacecraft->GetCurrentSector())
+	{
+		return Spacecraft->GetCurrentSector();
+	}
+	else if (Spacecraft->GetCurrentFleet() && Spacecraft->GetCurrentFleet()->GetCurrentTravel())
+	{
+		return Spacecraft->GetCurrentFleet()->GetCurrentTravel()->GetDestinationSector();
+	}
+	return NULL;
+}
+
+/** Sort value of a single spacecraft */
+static uint64 ComputeSpacecraftSortValue(UFlareSimulatedSpacecraft* Spacecraft, EFlareShipListSort::Type SortOrder, const TMap<UFlareSimulatedSector*, int32>& SectorRanks)
+{
+	switch (SortOrder)
+	{
+		case EFlareShipListSort::Value:
+		{
+			UFlareSimulatedSector* Sector = GetSortSector(Spacecraft);
+			return Sector ? FMath::Max(Sector->GetSpacecraftPrice(Spacecraft->GetDescription(), true), (int64) 0) : 0;
+		}
+
+		case EFlareShipListSort::Cargo:
+			return Spacecraft->GetCargoBay()->GetUsedCargoSpace();
+
+		case EFlareShipListSort::Health:
+			return FMath::RoundToInt(FMath::Clamp(Spacecraft->GetDamageSystem()->GetGlobalHealth(), 0.f, 1.f) * 1000000);
+
+		case EFlareShipListSort::Sector:
+		{
+			const int32* Rank = SectorRanks.Find(Spacecraft->GetCurrentSector());
+			return Rank ? *Rank : SectorRanks.Num();
+		}
+
+		case EFlareShipListSort::Size:
+		default:
+		{
+			bool Military = Spacecraft->IsMilitary();
+			uint64 WeaponGroupCount = Military ? FMath::Min(Spacecraft->GetWeaponsSystem()->GetWeaponGroupCount(), 0x7FFF) : 0;
+			return ((uint64) Spacecraft->GetSize() << 16) | ((uint64) Military << 15) | WeaponGroupCount;
+		}
+	}
+}
+
+uint64 SFlareShipList::ComputeSortKey(const FInterfaceContainer* Item, EFlareShipListSort::Type SortOrder, const TMap<UFlareSimulatedSector*, int32>& SectorRanks)
+{
+	bool Descending = (SortOrder != EFlareShipListSort::Health && SortOrder != EFlareShipListSort::Sector);
+
+	// Fleets first, by their ship count or the sum of their ships
+	if (Item->FleetPtr)
+	{
+		TArray<UFlareSimulatedSpacecraft*>& Ships = Item->FleetPtr->GetShips();
+		uint64 Value = 0;
+
+		switch (SortOrder)
+		{
+			case EFlareShipListSort::Value:
+			case EFlareShipListSort::Cargo:
+				for (int32 ShipIndex = 0; ShipIndex < Ships.Num(); ShipIndex++)
+				{
+					Value += ComputeSpacecraftSortValue(Ships[ShipIndex], SortOrder, SectorRanks);
+				}
+				break;
+
+			case EFlareShipListSort::Health:
+				Value = 1000000;
+				for (int32 ShipIndex = 0; ShipIndex < Ships.Num(); ShipIndex++)
+				{
+					Value = FMath::Min(Value, ComputeSpacecraftSortValue(Ships[ShipIndex], SortOrder, SectorRanks));
+				}
+				break;
+
+			case EFlareShipListSort::Sector:
+			{
+				const int32* Rank = SectorRanks.Find(Item->FleetPtr->GetCurrentSector());
+				Value = Rank ? *Rank : SectorRanks.Num();
+				break;
+			}
+
+			case EFlareShipListSort::Size:
+			default:
+				Value = Ships.Num();
+				break;
+		}
+
+		return FFlareShipListKey::Encode(0, Value, Descending);
+	}
+
+	// Then stations, and ships
+	else if (Item->ShipInterfacePtr)
+	{
+		uint8 Group = Item->ShipInterfacePtr->IsStation() ? 1 : 2;
+		uint64 Value = 0;
+		if (Group == 2 || SortOrder != EFlareShipListSort::Size)
+		{
+			Value = ComputeSpacecraftSortValue(Item->ShipInterfacePtr, SortOrder, SectorRanks);
+		}
+		return FFlareShipListKey::Encode(Group, Value, Descending);
+	}
+
+	return FFlareShipListKey::Encode(3, 0, false);
+}
+
+int32 SFlareShipList::FindSortedIndex(const TArray<FFlareShipListKey>& Keys, const FFlareShipListKey& Key)
+{
+	int32 First = 0;
+	int32 Count = Keys.Num();
+
+	while (Count > 0)
+	{
+		int32 Half = Count / 2;
+		if (Keys[First + Half] < Key)
+		{
+			First += Half + 1;
+			Count -= Half + 1;
+		}
+		else
+		{
+			Count = Half;
+		}
+	}
+
+	return First;
+}
+
+
 /*----------------------------------------------------
 	Callbacks
 ----------------------------------------------------*/
@@ -188,6 +347,24 @@ EVisibility SFlareShipList::GetNoObjectsVisibility() const
 	return (TargetListData.Num() > 0 ? EVisibility::Collapsed : EVisibility::Visible);
 }
 
+FText SFlareShipList::GetSortText() const
+{
+	switch (SortOrder)
+	{
+		case EFlareShipListSort::Value:   return LOCTEXT("SortValue", "By value");
+		case EFlareShipListSort::Cargo:   return LOCTEXT("SortCargo", "By cargo");
+		case EFlareShipListSort::Health:  return LOCTEXT("SortHealth", "By damage");
+		case EFlareShipListSort::Sector:  return LOCTEXT("SortSector", "By sector");
+		case EFlareShipListSort::Size:
+		default:                          return LOCTEXT("SortSize", "By size");
+	}
+}
+
+void SFlareShipList::OnSortClicked()
+{
+	SetSortOrder((EFlareShipListSort::Type) ((SortOrder + 1) % EFlareShipListSort::Num));
+}
+
 TSharedRef<ITableRow> SFlareShipList::GenerateTargetInfo(TSharedPtr<FInterfaceContainer> Item, const TSharedRef<STableViewBase>& OwnerTable)
 {
 	AFlarePlayerController* PC = MenuManager->GetPC();
@@ -322,5 +499,63 @@ void SFlareShipList::OnTargetSelected(TSharedPtr<FInterfaceContainer> Item, ESel
 }
 
 
+
+/*----------------------------------------------------
+	Internals
+----------------------------------------------------*/
+
+void SFlareShipList::InsertItem(TSharedPtr<FInterfaceContainer> Item)
+{
+	if (SectorRanks.Num() == 0)
+	{
+		UpdateSectorRanks();
+	}
+
+	FFlareShipListKey Key;
+	Key.Key = ComputeSortKey(Item.Get(), SortOrder, SectorRanks);
+	Key.Serial = NextSerial++;
+
+	int32 Index = FindSortedIndex(TargetListKeys, Key);
+	TargetListKeys.Insert(Key, Index);
+	TargetListData.Insert(Item, Index);
+	TargetList->RequestListRefresh();
+}
+
+void SFlareShipList::RemoveItem(int32 Index)
+{
+	if (SelectedItem == TargetListData[Index])
+	{
+		ClearSelection();
+		SelectedItem.Reset();
+	}
+
+	TargetListKeys.RemoveAt(Index);
+	TargetListData.RemoveAt(Index);
+	TargetList->RequestListRefresh();
+}
+
+void SFlareShipList::UpdateSectorRanks()
+{
+	SectorRanks.Empty();
+
+	UFlareWorld* GameWorld = MenuManager.IsValid() ? MenuManager->GetGame()->GetGameWorld() : NULL;
+	if (!GameWorld)
+	{
+		return;
+	}
+
+	TArray<UFlareSimulatedSector*> Sectors = GameWorld->GetSectors();
+	Sectors.Sort([](UFlareSimulatedSector& A, UFlareSimulatedSector& B)
+	{
+		return A.GetSectorName().ToString() < B.GetSectorName().ToString();
+	});
+
+	for (int32 Index = 0; Index < Sectors.Num(); Index++)
+	{
+		SectorRanks.Add(Sectors[Index], Index);
+	}
+}
+
+
 #undef LOCTEXT_NAMESPACE
 
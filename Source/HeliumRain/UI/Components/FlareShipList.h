@@ -7,6 +7,39 @@
 DECLARE_DELEGATE_OneParam(FFlareListItemSelected, TSharedPtr<FInterfaceContainer>)
 
 
+/** Ship list sort orders. Fleets come first, then stations, then ships */
+namespace EFlareShipListSort
+{
+	enum Type
+	{
+		Size, /** Larger, then armed first */
+		Value, /** Most valuable first */
+		Cargo, /** Most loaded first */
+		Health, /** Most damaged first */
+		Sector, /** Sector name, travelling last */
+		Num
+	};
+}
+
+/** Precomputed sort key of a list entry, ordered ascending */
+struct FFlareShipListKey
+{
+	/** Group in the two upper bits, sort value below */
+	uint64 Key;
+
+	/** Insertion order, for a stable order between equal keys */
+	uint32 Serial;
+
+	/** Build a key that sorts by ascending group, then ascending or descending value */
+	static uint64 Encode(uint8 Group, uint64 Value, bool Descending);
+
+	inline bool operator<(const FFlareShipListKey& Other) const
+	{
+		return Key < Other.Key || (Key == Other.Key && Serial < Other.Serial);
+	}
+};
+
+
 class SFlareShipList : public SCompoundWidget
 {
 	/*----------------------------------------------------
@@ -15,9 +48,11 @@ class SFlareShipList : public SCompoundWidget
 
 	SLATE_BEGIN_ARGS(SFlareShipList)
 	 : _UseCompactDisplay(false)
+	 , _MaxHeight(0)
 	{}
 
 	SLATE_ARGUMENT(bool, UseCompactDisplay)
+	SLATE_ARGUMENT(float, MaxHeight)
 	SLATE_ARGUMENT(TWeakObjectPtr<class AFlareMenuManager>, MenuManager)
 	SLATE_EVENT(FFlareListItemSelected, OnItemSelected)
 	SLATE_ARGUMENT(FText, Title)
@@ -40,15 +75,72 @@ public:
 	/** Add a new ship to the list */
 	void AddShip(UFlareSimulatedSpacecraft* Ship);
 
-	/** Update the list display from content */
+	/** Add a new fleet at its sorted position */
+	void InsertFleet(UFlareFleet* Fleet);
+
+	/** Add a new ship at its sorted position */
+	void InsertShip(UFlareSimulatedSpacecraft* Ship);
+
+	/** Remove a fleet, keeping the order */
+	void RemoveFleet(UFlareFleet* Fleet);
+
+	/** Remove a ship, keeping the order */
+	void RemoveShip(UFlareSimulatedSpacecraft* Ship);
+
+	/** Update the sort keys, sort, and update the list display from content */
 	void RefreshList();
 
+	/** Change the sort order and sort again */
+	void SetSortOrder(EFlareShipListSort::Type NewSortOrder);
+
 	/** Clear the current selection */
 	void ClearSelection();
 
 	/** Remove all entries from the list */
 	void Reset();
-	
+
+
+	/*----------------------------------------------------
+		Sorting
+	----------------------------------------------------*/
+
+	/** Compute the sort key of an entry */
+	static uint64 ComputeSortKey(const FInterfaceContainer* Item, EFlareShipListSort::Type SortOrder, const TMap<UFlareSimulatedSector*, int32>& SectorRanks);
+
+	/** Get the index where a key should be inserted in sorted keys */
+	static int32 FindSortedIndex(const TArray<FFlareShipListKey>& Keys, const FFlareShipListKey& Key);
+
+	/** Sort keys, and items in the same order */
+	template<typename ItemType>
+	static void SortByKeys(TArray<FFlareShipListKey>& Keys, TArray<ItemType>& Items)
+	{
+		TArray<int32> Order;
+		Order.SetNumUninitialized(Keys.Num());
+		for (int32 Index = 0; Index < Keys.Num(); Index++)
+		{
+			Order[Index] = Index;
+		}
+
+		const TArray<FFlareShipListKey>& SortKeys = Keys;
+		Order.Sort([&SortKeys](const int32& A, const int32& B)
+		{
+			return SortKeys[A] < SortKeys[B];
+		});
+
+		TArray<FFlareShipListKey> SortedKeys;
+		TArray<ItemType> SortedItems;
+		SortedKeys.Reserve(Keys.Num());
+		SortedItems.Reserve(Items.Num());
+		for (int32 Index = 0; Index < Order.Num(); Index++)
+		{
+			SortedKeys.Add(Keys[Order[Index]]);
+			SortedItems.Add(Items[Order[Index]]);
+		}
+
+		Keys = SortedKeys;
+		Items = SortedItems;
+	}
+
 
 protected:
 
@@ -59,11 +151,31 @@ protected:
 	/** Show a "no objects" text when the data is empty */
 	EVisibility GetNoObjectsVisibility() const;
 
+	/** Get the sort order name */
+	FText GetSortText() const;
+
+	/** Use the next sort order */
+	void OnSortClicked();
+
 	/** Target item generator */
 	TSharedRef<ITableRow> GenerateTargetInfo(TSharedPtr<FInterfaceContainer> Item, const TSharedRef<STableViewBase>& OwnerTable);
 
 	/** Target item selected */
 	void OnTargetSelected(TSharedPtr<FInterfaceContainer> Item, ESelectInfo::Type SelectInfo);
+
+
+	/*----------------------------------------------------
+		Internals
+	----------------------------------------------------*/
+
+	/** Add an entry at its sorted position */
+	void InsertItem(TSharedPtr<FInterfaceContainer> Item);
+
+	/** Remove the entry at an index */
+	void RemoveItem(int32 Index);
+
+	/** Rank the sectors by name for the sector order */
+	void UpdateSectorRanks();
 	
 
 protected:
@@ -82,6 +194,12 @@ protected:
 	TArray< TSharedPtr<FInterfaceContainer> >                    TargetListData;
 	TSharedPtr<FInterfaceContainer>                              SelectedItem;
 
+	// Sort data, with keys in the order of TargetListData
+	TArray<FFlareShipListKey>                                    TargetListKeys;
+	TMap<UFlareSimulatedSector*, int32>                          SectorRanks;
+	EFlareShipListSort::Type                                     SortOrder;
+	uint32                                                       NextSerial;
+
 	// State data
 	FFlareListItemSelected                                       OnItemSelected;
 	bool                                                         UseCompactDisplay;
@@ -432,10 +432,22 @@ void SFlareFleetMenu::OnAddToFleet()
 	FCHECK(FleetToAdd);
 
 	FLOGV("SFlareFleetMenu::OnAddToFleet : adding '%s'", *FleetToAdd->GetFleetName().ToString());
+	TArray<UFlareSimulatedSpacecraft*> Ships = FleetToAdd->GetShips();
 	SelectedFleet->Merge(FleetToAdd);
 
-	UpdateShipList();
-	UpdateFleetList();
+	// Move the merged ships between the lists
+	for (int32 ShipIndex = 0; ShipIndex < Ships.Num(); ShipIndex++)
+	{
+		if (Ships[ShipIndex]->GetCurrentFleet() == SelectedFleet && Ships[ShipIndex]->GetDamageSystem()->IsAlive())
+		{
+			ShipList->InsertShip(Ships[ShipIndex]);
+		}
+	}
+	if (FleetToAdd->GetShips().Num() == 0)
+	{
+		FleetList->RemoveFleet(FleetToAdd);
+	}
+
 	FleetToAdd = NULL;
 	ShipToRemove = NULL;
 }
@@ -448,8 +460,14 @@ void SFlareFleetMenu::OnRemoveFromFleet()
 	FLOGV("SFlareFleetMenu::OnRemoveFromFleet : removing '%s'", *ShipToRemove->GetImmatriculation().ToString());
 	SelectedFleet->RemoveShip(ShipToRemove);
 
-	UpdateShipList();
-	UpdateFleetList();
+	// The ship now has its own fleet
+	UFlareFleet* NewFleet = ShipToRemove->GetCurrentFleet();
+	if (NewFleet && NewFleet != SelectedFleet)
+	{
+		ShipList->RemoveShip(ShipToRemove);
+		FleetList->InsertFleet(NewFleet);
+	}
+
 	FleetToAdd = NULL;
 	ShipToRemove = NULL;
 }
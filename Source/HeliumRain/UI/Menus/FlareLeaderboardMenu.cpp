@@ -80,24 +80,34 @@ void SFlareLeaderboardMenu::Enter()
 	SetVisibility(EVisibility::Visible);
 	const TArray<UFlareCompany*>& Companies = Game->GetGameWorld()->GetCompanies();
 	
-	// Add companies
-	CompanyListData.Empty();
+	// Value each company once
+	struct FCompanyEntry
+	{
+		UFlareCompany* Company;
+		int64 TotalValue;
+	};
+	TArray<FCompanyEntry> Entries;
 	for (int32 Index = 0; Index < Companies.Num(); Index++)
 	{
-		CompanyListData.AddUnique(FInterfaceContainer::New(Companies[Index]));
+		Entries.Add({ Companies[Index], Companies[Index]->GetCompanyValue().TotalValue });
 	}
 
 	// Sorting rules
 	struct FSortByValue
 	{
-		FORCEINLINE bool operator()(const TSharedPtr<FInterfaceContainer> PtrA, const TSharedPtr<FInterfaceContainer> PtrB) const
+		FORCEINLINE bool operator()(const FCompanyEntry& A, const FCompanyEntry& B) const
 		{
-			return (PtrA->CompanyPtr->GetCompanyValue().TotalValue > PtrB->CompanyPtr->GetCompanyValue().TotalValue);
+			return (A.TotalValue > B.TotalValue);
 		}
 	};
 
-	// Sort
-	CompanyListData.Sort(FSortByValue());
+	// Sort and add companies
+	Entries.Sort(FSortByValue());
+	CompanyListData.Empty();
+	for (int32 Index = 0; Index < Entries.Num(); Index++)
+	{
+		CompanyListData.AddUnique(FInterfaceContainer::New(Entries[Index].Company));
+	}
 	CompanyList->RequestListRefresh();
 }
 
@@ -1,6 +1,7 @@
 
 #include "../../Flare.h"
 #include "FlareResourcePricesMenu.h"
+#include "../Components/FlareHistoryChart.h"
 #include "FlareWorldEconomyMenu.h"
 #include "../../Game/FlareGame.h"
 #include "../../Economy/FlareResource.h"
@@ -100,7 +101,22 @@ void SFlareResourcePricesMenu::Construct(const FArguments& InArgs)
 							[
 								SNew(STextBlock)
 								.TextStyle(&Theme.NameFont)
-								.Text(LOCTEXT("ResourcePriceVariation", "40-day variation"))
+								.Text(this, &SFlareResourcePricesMenu::GetPriceVariationTitle)
+							]
+						]
+
+						// History
+						+ SHorizontalBox::Slot()
+						.AutoWidth()
+						.Padding(Theme.ContentPadding)
+						[
+							SNew(SBox)
+							.WidthOverride(0.3 * Theme.ContentWidth)
+							.HAlign(HAlign_Left)
+							[
+								SNew(STextBlock)
+								.TextStyle(&Theme.NameFont)
+								.Text(LOCTEXT("ResourcePriceHistory", "Price history"))
 							]
 						]
 
@@ -172,6 +188,15 @@ void SFlareResourcePricesMenu::Enter(UFlareSimulatedSector* Sector)
 	for (int32 ResourceIndex = 0; ResourceIndex < ResourceList.Num(); ResourceIndex++)
 	{
 		FFlareResourceDescription& Resource = ResourceList[ResourceIndex]->Data;
+
+		// Daily prices from the sector price table, oldest first
+		TArray<float> PriceHistory;
+		for (int32 Age = TargetSector->GetPriceHistoryLength() - 1; Age >= 0; Age--)
+		{
+			PriceHistory.Add(TargetSector->GetPreciseResourcePrice(&Resource, Age));
+		}
+
+		TSharedPtr<SFlareHistoryChart> PriceChart;
 		ResourcePriceList->AddSlot()
 		.Padding(FMargin(1))
 		[
@@ -251,6 +276,18 @@ void SFlareResourcePricesMenu::Enter(UFlareSimulatedSector* Sector)
 					]
 				]
 
+				// Price history
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.VAlign(VAlign_Center)
+				.Padding(Theme.ContentPadding)
+				[
+					SAssignNew(PriceChart, SFlareHistoryChart)
+					.Width(0.3 * Theme.ContentWidth)
+					.Height(0.5 * Theme.ResourceHeight)
+					.Color(Theme.NeutralColor)
+				]
+
 				// Transport fee
 				+ SHorizontalBox::Slot()
 				.AutoWidth()
@@ -283,6 +320,8 @@ void SFlareResourcePricesMenu::Enter(UFlareSimulatedSector* Sector)
 				]
 			]
 		];
+
+		PriceChart->SetValues(PriceHistory);
 	}
 }
 
@@ -368,11 +407,11 @@ FText SFlareResourcePricesMenu::GetResourcePriceVariationInfo(FFlareResourceDesc
 		FNumberFormattingOptions MoneyFormat;
 		MoneyFormat.MaximumFractionalDigits = 2;
 
-		int32 MeanDuration = 40;
+		int32 MeanDuration = GetPriceVariationDuration();
 		int64 ResourcePrice = TargetSector->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
 		int64 LastResourcePrice = TargetSector->GetResourcePrice(Resource, EFlareResourcePriceContext::Default, MeanDuration);
 
-		if(ResourcePrice != LastResourcePrice)
+		if(MeanDuration > 0 && ResourcePrice != LastResourcePrice)
 		{
 			float Variation = (((float) ResourcePrice) / ((float) LastResourcePrice) - 1);
 
@@ -392,6 +431,22 @@ FText SFlareResourcePricesMenu::GetResourcePriceVariationInfo(FFlareResourceDesc
 	return FText();
 }
 
+int32 SFlareResourcePricesMenu::GetPriceVariationDuration() const
+{
+	// Up to 40 days, as far as the sector price table goes
+	if (TargetSector)
+	{
+		return FMath::Clamp(TargetSector->GetPriceHistoryLength() - 1, 0, 40);
+	}
+
+	return 0;
+}
+
+FText SFlareResourcePricesMenu::GetPriceVariationTitle() const
+{
+	return FText::Format(LOCTEXT("ResourcePriceVariationFormat", "{0}-day variation"), FText::AsNumber(FMath::Max(GetPriceVariationDuration(), 1)));
+}
+
 FText SFlareResourcePricesMenu::GetResourceTransportFeeInfo(FFlareResourceDescription* Resource) const
 {
 	if (TargetSector)
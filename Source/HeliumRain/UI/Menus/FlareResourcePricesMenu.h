@@ -58,6 +58,12 @@ protected:
 	/** Get the resource price variation info */
 	FText GetResourcePriceVariationInfo(FFlareResourceDescription* Resource) const;
 
+	/** Get the number of days the variation is computed on */
+	int32 GetPriceVariationDuration() const;
+
+	/** Get the variation column title */
+	FText GetPriceVariationTitle() const;
+
 	/** Get the resource transport fee info */
 	FText GetResourceTransportFeeInfo(FFlareResourceDescription* Resource) const;
 
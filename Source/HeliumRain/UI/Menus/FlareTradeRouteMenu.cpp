@@ -81,6 +81,17 @@ void SFlareTradeRouteMenu::Construct(const FArguments& InArgs)
 						.TextStyle(&Theme.TextFont)
 					]
 
+					// Projected throughput
+					+ SVerticalBox::Slot()
+					.AutoHeight()
+					.Padding(Theme.ContentPadding)
+					.HAlign(HAlign_Center)
+					[
+						SNew(STextBlock)
+						.Text(this, &SFlareTradeRouteMenu::GetThroughputInfo)
+						.TextStyle(&Theme.TextFont)
+					]
+
 					// Map
 					+ SVerticalBox::Slot()
 					.AutoHeight()
@@ -793,6 +804,19 @@ FText SFlareTradeRouteMenu::GetFleetInfo() const
 	return LOCTEXT("NoFleetSelected", "No assigned fleet !");
 }
 
+FText SFlareTradeRouteMenu::GetThroughputInfo() const
+{
+	if (TargetTradeRoute && TargetTradeRoute->GetProjectionDays() > 0)
+	{
+		return FText::Format(LOCTEXT("ThroughputInfoFormat", "Projected throughput : {0} units / day - {1} credits / day (last {2} days)"),
+			FText::AsNumber(FMath::RoundToInt(TargetTradeRoute->GetProjectedQuantityPerDay())),
+			FText::AsNumber(UFlareGameTools::DisplayMoney((int64) TargetTradeRoute->GetProjectedRevenuePerDay())),
+			FText::AsNumber(TargetTradeRoute->GetProjectionDays()));
+	}
+
+	return LOCTEXT("NoThroughputInfo", "No trade statistics yet");
+}
+
 FText SFlareTradeRouteMenu::GetSelectedStepInfo() const
 {
 	if (SelectedOperation)
@@ -56,6 +56,9 @@ protected:
 
 	/** Get info for the current fleet */
 	FText GetFleetInfo() const;
+
+	/** Get the projected cargo and money flow of the route */
+	FText GetThroughputInfo() const;
 	
 	/** Get info for the selected trade route step */
 	FText GetSelectedStepInfo() const;
@@ -5,6 +5,7 @@
 #include "SlateExtras.h"
 #include "MoviePlayer.h"
 #include "SThrobber.h"
+#include "SProgressBar.h"
 
 #define LOCTEXT_NAMESPACE "FlareLoadingScreen"
 
@@ -41,10 +42,13 @@ class SFlareLoadingScreen : public SCompoundWidget
 public:
 
 	SLATE_BEGIN_ARGS(SFlareLoadingScreen){}
+	SLATE_ARGUMENT(IFlareLoadingScreenModule*, Module)
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments& InArgs)
 	{
+		Module = InArgs._Module;
+
 		// Get brush data
 		static const FName LoadingScreenName(TEXT("/Engine/EngineResources/Black.Black"));
 		static const FName ThrobberImageName(TEXT("/Game/Slate/Images/TX_Image_LargeButtonInvertedBackground.TX_Image_LargeButtonInvertedBackground"));
@@ -95,11 +99,36 @@ public:
 					.PieceImage(ThrobberBrush.Get())
 					.NumPieces(5)
 				]
+
+				// Progress
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.VAlign(VAlign_Top)
+				.HAlign(HAlign_Center)
+				.Padding(FMargin(10.0f))
+				[
+					SNew(SBox)
+					.WidthOverride(400)
+					[
+						SNew(SProgressBar)
+						.Percent(this, &SFlareLoadingScreen::GetProgress)
+					]
+				]
 			]
 		];
 	}
 
+protected:
+
+	TOptional<float> GetProgress() const
+	{
+		return Module ? Module->GetLoadingProgress() : 0.f;
+	}
+
 private:
+
+	// Owner
+	IFlareLoadingScreenModule* Module;
 	
 	// Slate data
 	TSharedPtr<FSlateDynamicImageBrush> ThrobberBrush;
@@ -138,14 +167,30 @@ public:
 		GetMoviePlayer()->PlayMovie();
 	}
 
+	virtual void SetLoadingProgress(float Progress) override
+	{
+		LoadingProgress = FMath::Clamp(Progress, 0.f, 1.f);
+	}
+
+	virtual float GetLoadingProgress() const override
+	{
+		return LoadingProgress;
+	}
+
 	virtual void CreateScreen()
 	{
+		LoadingProgress = 0;
+
 		FLoadingScreenAttributes LoadingScreen;
 		LoadingScreen.bAutoCompleteWhenLoadingCompletes = true;
-		LoadingScreen.WidgetLoadingScreen = SNew(SFlareLoadingScreen);
+		LoadingScreen.WidgetLoadingScreen = SNew(SFlareLoadingScreen).Module(this);
 		GetMoviePlayer()->SetupLoadingScreen(LoadingScreen);
 	}
 
+protected:
+
+	float LoadingProgress;
+
 };
 
 #undef LOCTEXT_NAMESPACE
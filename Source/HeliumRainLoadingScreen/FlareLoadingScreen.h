@@ -14,4 +14,9 @@ public:
 
 	virtual void StartInGameLoadingScreen() = 0;
 
+	/** Set the progress of the current load, from 0 to 1 */
+	virtual void SetLoadingProgress(float Progress) = 0;
+
+	virtual float GetLoadingProgress() const = 0;
+
 };
@@ -73,7 +73,7 @@ class Ship:
 		# Radiation in KJ = surface * 5.670373e-8 * FMath::Pow(Temperature, 4) / 1000
 		# Production in KJ = power
 		# Equilibrium when production equals radiation
-		return math.pow(1000 * power / (surface * 5.60373e-8), 1/4)
+		return math.pow(1000 * power / (surface * 5.670373e-8), 1/4)
 
 
 